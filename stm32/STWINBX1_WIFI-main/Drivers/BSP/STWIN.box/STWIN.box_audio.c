@@ -1133,6 +1133,26 @@ __weak void BSP_AUDIO_IN_Error_CallBack(uint32_t Instance)
   error occurs. */
 }
 
+/**
+* @brief  Audio IN DMA interrupt handler, to be called from the GPDMA1 channel IRQ.
+* @param  Instance  AUDIO IN Instance.
+* @param  Device    ONBOARD_DIGITAL_MIC_MASK (GPDMA1_Channel1) or ONBOARD_ANALOG_MIC_MASK (GPDMA1_Channel2)
+* @retval None
+*/
+void BSP_AUDIO_IN_IRQHandler(uint32_t Instance, uint32_t Device)
+{
+  UNUSED(Instance);
+  
+  if ((Device & ONBOARD_ANALOG_MIC_MASK) != 0U)
+  {
+    HAL_DMA_IRQHandler(&AMic_OnBoard_DmaHandle);
+  }
+  if ((Device & ONBOARD_DIGITAL_MIC_MASK) != 0U)
+  {
+    HAL_DMA_IRQHandler(&DMic_OnBoard_DmaHandle);
+  }
+}
+
 
 /******* TO BE CHECKED: return void ? *****/
 /**
@@ -349,6 +349,9 @@ void BSP_AUDIO_IN_HalfTransfer_CallBack(uint32_t Instance);
    error occurs. */
 void BSP_AUDIO_IN_Error_CallBack(uint32_t Instance);
 
+/* DMA interrupt: call from GPDMA1_Channel1 (digital mic) / GPDMA1_Channel2 (analog mic) IRQ handlers */
+void BSP_AUDIO_IN_IRQHandler(uint32_t Instance, uint32_t Device);
+
 
 /**
   * @}
@@ -74,6 +74,20 @@ TX_EVENT_FLAGS_GROUP    nx_bsd_events;
 
 NX_BSD_SOCKET           nx_bsd_socket_array[NX_BSD_MAX_SOCKETS];
 
+#ifdef NX_BSD_ENABLE_BATCH
+/* Define the per socket receive queue locks. The socket structures are cleared on
+   socket() and soc_close(), so the locks live beside the array. The IP instance
+   mutex is always obtained before a receive lock, never while holding one.  */
+
+static TX_MUTEX         nx_bsd_receive_lock[NX_BSD_MAX_SOCKETS];
+
+#define NX_BSD_RECEIVE_LOCK(s)      tx_mutex_get(&nx_bsd_receive_lock[(s) - nx_bsd_socket_array], TX_WAIT_FOREVER)
+#define NX_BSD_RECEIVE_UNLOCK(s)    tx_mutex_put(&nx_bsd_receive_lock[(s) - nx_bsd_socket_array])
+#else
+#define NX_BSD_RECEIVE_LOCK(s)
+#define NX_BSD_RECEIVE_UNLOCK(s)
+#endif /* NX_BSD_ENABLE_BATCH */
+
 /* Define the raw socket protocol hash table. */
 
 NX_BSD_SOCKET           *nx_bsd_socket_raw_protocol_table[NX_BSD_SOCKET_RAW_PROTOCOL_TABLE_SIZE];
@@ -149,6 +163,13 @@ static VOID  nx_bsd_tcp_establish_notify(NX_TCP_SOCKET *socket_ptr);
 static VOID  nx_bsd_select_wakeup(UINT sock_id, UINT fdsets);
 static VOID  nx_bsd_set_error_code(NX_BSD_SOCKET *bsd_socket_ptr, UINT status_code);
 static VOID  nx_bsd_udp_packet_received(INT sockID, NX_PACKET *packet_ptr);
+static INT   nx_bsd_udp_socket_auto_bind(NX_BSD_SOCKET *bsd_socket_ptr);
+static VOID  nx_bsd_send_error_set(NX_BSD_SOCKET *bsd_socket_ptr, INT flags, UINT status);
+#ifdef NX_BSD_ENABLE_BATCH
+static INT   nx_bsd_receive_datagram(NX_BSD_SOCKET *bsd_socket_ptr, VOID *rcvBuffer, INT bufferLength, INT flags, UINT wait_option);
+static INT   nx_bsd_receive_batch(INT sockID, NX_PACKET **packet_array, UINT vlen, INT flags, struct timespec *timeout);
+static VOID  nx_bsd_msg_name_set(NX_BSD_SOCKET *bsd_socket_ptr, NX_PACKET *packet_ptr, struct msghdr *msg_ptr);
+#endif /* NX_BSD_ENABLE_BATCH */
 static UINT  nx_bsd_tcp_syn_received_notify(NX_TCP_SOCKET *socket_ptr, NX_PACKET *packet_ptr);
 static INT   nx_bsd_tcp_create_listen_socket(INT master_sockid, INT backlog);
 static VOID  nx_bsd_tcp_pending_connection(UINT local_port, NX_TCP_SOCKET *socket_ptr);
@@ -354,6 +375,42 @@ ULONG       info;
         memset((VOID*) &nx_bsd_socket_array[i], 0, sizeof(NX_BSD_SOCKET));
     }
 
+#ifdef NX_BSD_ENABLE_BATCH
+    /* Create the socket receive queue locks. Like the IP instance mutex they do
+       not inherit priority: they are held for a few pointer updates only, and
+       the inheriting release path costs more than the hold itself.  */
+    for (i = 0; i < NX_BSD_MAX_SOCKETS; i++)
+    {
+
+        status = tx_mutex_create(&nx_bsd_receive_lock[i], "NetX BSD Receive Lock", TX_NO_INHERIT);
+
+        if (status != TX_SUCCESS)
+        {
+
+            /* Delete the locks already created.  */
+            while (i > 0)
+            {
+                i--;
+                tx_mutex_delete(&nx_bsd_receive_lock[i]);
+            }
+
+            /* Delete the event flag group.  */
+            tx_event_flags_delete(&nx_bsd_events);
+
+            /* Delete the block pool.  */
+            tx_block_pool_delete(&nx_bsd_socket_block_pool);
+            tx_block_pool_delete(&nx_bsd_addrinfo_block_pool);
+#if defined(NX_BSD_ENABLE_DNS) && defined (NX_DNS_ENABLE_EXTENDED_RR_TYPES)
+            tx_block_pool_delete(&nx_bsd_cname_block_pool);
+#endif
+
+            /* Error present, return error code.  */
+            NX_BSD_ERROR(NX_BSD_MUTEX_ERROR, __LINE__);
+            return(NX_BSD_MUTEX_ERROR);
+        }
+    }
+#endif /* NX_BSD_ENABLE_BATCH */
+
     /* Save the IP instance and NX_PACKET_POOL for BSD Socket API.  */
     nx_bsd_default_ip =           default_ip;
     nx_bsd_default_packet_pool =  default_pool;
@@ -2184,7 +2241,7 @@ INT                 address_conflict;
 
 
                                     /* Calculate the hash index in the TCP port array of the associated IP instance.  */
-                                    UINT index =  (UINT) ((local_port + (local_port >> 8)) & NX_TCP_PORT_TABLE_MASK); 
+                                    UINT index =  NX_TCP_PORT_HASH(local_port); 
 
                                     /* This non server socket needs to share a port with the other client socket. */
                                     socket_ptr -> nx_tcp_socket_port = (UINT)local_port;
@@ -3106,6 +3163,8 @@ struct sockaddr_in6 peer6_address;
 /*    tx_mutex_get                          Get Mutex protction           */
 /*    tx_mutex_put                          Release Mutex protection      */
 /*    nx_packet_release                     Release the packet on error   */
+/*    nx_bsd_send_error_set                 Sets the errno of a failed    */
+/*                                            send                        */
 /*    nx_udp_socket_send                    UDP packet send               */
 /*    nx_udp_socket_interface_send          UDP packet send via a         */
 /*                                            specific interface          */
@@ -3454,45 +3513,7 @@ ULONG               data_sent = (ULONG)msgLength;
         nx_packet_release(packet_ptr);
 
         /* Set the socket error.  */
-
-        /* Set the socket error according to the NetX error status returned.  */
-        switch (status)
-        {
-
-            case NX_IP_ADDRESS_ERROR:
-                set_errno(EDESTADDRREQ);
-                break;
-
-            case NX_NOT_ENABLED:
-                set_errno(EPROTONOSUPPORT);
-                break;
-
-            case NX_NOT_CONNECTED:
-                set_errno(ENOTCONN);
-                break;
-
-            case NX_NO_PACKET:
-            case NX_UNDERFLOW:
-                set_errno(ENOBUFS);
-                break;
-
-            case NX_WINDOW_OVERFLOW:
-            case NX_WAIT_ABORTED:
-            case NX_TX_QUEUE_DEPTH:
-                if ((bsd_socket_ptr -> nx_bsd_socket_option_flags & NX_BSD_SOCKET_ENABLE_OPTION_NON_BLOCKING) ||
-                    (flags & MSG_DONTWAIT))
-                    set_errno( EWOULDBLOCK);
-                else
-                    set_errno(ETIMEDOUT);
-                break;
-
-            default:
-                /* NX_NOT_BOUND */
-                /* NX_PTR_ERROR */
-                /* NX_INVALID_PACKET */
-                set_errno(EINVAL);  
-                break;
-        }
+        nx_bsd_send_error_set(bsd_socket_ptr, flags, status);
 
         /* Return an error status. */
         NX_BSD_ERROR(status, __LINE__);
@@ -3509,6 +3530,157 @@ ULONG               data_sent = (ULONG)msgLength;
     return((INT)data_sent);
 }
 
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    nx_bsd_send_error_set                               PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Wind Turbine Team                                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets the BSD errno for a failed NetX send.            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    bsd_socket_ptr                        Pointer to the BSD socket     */
+/*    flags                                 Control flags of the send     */
+/*    status                                NetX send status              */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    set_errno                             Sets the BSD errno            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    nx_bsd_send_internal                                                */
+/*    sendmmsg                                                            */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-18-2026     Wind Turbine Team        Initial Version 6.1           */
+/*                                                                        */
+/**************************************************************************/
+static VOID nx_bsd_send_error_set(NX_BSD_SOCKET *bsd_socket_ptr, INT flags, UINT status)
+{
+
+    /* Set the socket error according to the NetX error status returned.  */
+    switch (status)
+    {
+
+        case NX_IP_ADDRESS_ERROR:
+            set_errno(EDESTADDRREQ);
+            break;
+
+        case NX_NOT_ENABLED:
+            set_errno(EPROTONOSUPPORT);
+            break;
+
+        case NX_NOT_CONNECTED:
+            set_errno(ENOTCONN);
+            break;
+
+        case NX_NO_PACKET:
+        case NX_UNDERFLOW:
+            set_errno(ENOBUFS);
+            break;
+
+        case NX_WINDOW_OVERFLOW:
+        case NX_WAIT_ABORTED:
+        case NX_TX_QUEUE_DEPTH:
+            if ((bsd_socket_ptr -> nx_bsd_socket_option_flags & NX_BSD_SOCKET_ENABLE_OPTION_NON_BLOCKING) ||
+                (flags & MSG_DONTWAIT))
+                set_errno( EWOULDBLOCK);
+            else
+                set_errno(ETIMEDOUT);
+            break;
+
+        default:
+            /* NX_NOT_BOUND */
+            /* NX_PTR_ERROR */
+            /* NX_INVALID_PACKET */
+            set_errno(EINVAL);  
+            break;
+    }
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    nx_bsd_udp_socket_auto_bind                         PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Wind Turbine Team                                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function binds a UDP socket that is not bound yet to a free    */
+/*    port on any interface, as a first send does.                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    bsd_socket_ptr                        Pointer to the BSD socket     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    NX_SOC_OK (0)                         On success                    */
+/*    NX_SOC_ERROR (-1)                     On failure                    */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    nx_udp_socket_bind                    Bind the UDP socket           */
+/*    set_errno                             Sets the BSD errno            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    sendto                                                              */
+/*    sendmmsg                                                            */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-18-2026     Wind Turbine Team        Initial Version 6.1           */
+/*                                                                        */
+/**************************************************************************/
+static INT nx_bsd_udp_socket_auto_bind(NX_BSD_SOCKET *bsd_socket_ptr)
+{
+
+UINT    status;
+
+    if(!(bsd_socket_ptr -> nx_bsd_socket_status_flags & NX_BSD_SOCKET_BOUND))
+    {
+        status = nx_udp_socket_bind(bsd_socket_ptr -> nx_bsd_socket_udp_socket, NX_ANY_PORT, NX_NO_WAIT);
+        if((status != NX_SUCCESS) && (status != NX_ALREADY_BOUND))
+        {
+            set_errno(EINVAL);
+
+            NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
+
+            return(NX_SOC_ERROR);
+        }
+
+        bsd_socket_ptr -> nx_bsd_socket_local_bind_interface = NX_BSD_LOCAL_IF_INADDR_ANY;
+        bsd_socket_ptr -> nx_bsd_socket_local_bind_interface_index = NX_BSD_LOCAL_IF_INADDR_ANY;
+        bsd_socket_ptr -> nx_bsd_socket_local_port = (USHORT)(bsd_socket_ptr -> nx_bsd_socket_udp_socket -> nx_udp_socket_port);
+        bsd_socket_ptr -> nx_bsd_socket_status_flags |= NX_BSD_SOCKET_BOUND;
+    }
+
+    return(NX_SOC_OK);
+}
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -3836,22 +4008,9 @@ USHORT               peer_port = 0;
         /* For UDP socket, make sure the socket is bound. */
         if(bsd_socket_ptr -> nx_bsd_socket_protocol == NX_PROTOCOL_UDP)
         {
-            if(!(bsd_socket_ptr -> nx_bsd_socket_status_flags & NX_BSD_SOCKET_BOUND))
+            if(nx_bsd_udp_socket_auto_bind(bsd_socket_ptr) != NX_SOC_OK)
             {
-                status = nx_udp_socket_bind(bsd_socket_ptr -> nx_bsd_socket_udp_socket, NX_ANY_PORT, NX_NO_WAIT);
-                if((status != NX_SUCCESS) && (status != NX_ALREADY_BOUND))
-                {
-                    set_errno(EINVAL);
-
-                    NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
-
-                    return(NX_SOC_ERROR);
-                }
-
-                bsd_socket_ptr -> nx_bsd_socket_local_bind_interface = NX_BSD_LOCAL_IF_INADDR_ANY;
-                bsd_socket_ptr -> nx_bsd_socket_local_bind_interface_index = NX_BSD_LOCAL_IF_INADDR_ANY;
-                bsd_socket_ptr -> nx_bsd_socket_local_port = (USHORT)(bsd_socket_ptr -> nx_bsd_socket_udp_socket -> nx_udp_socket_port);
-                bsd_socket_ptr -> nx_bsd_socket_status_flags |= NX_BSD_SOCKET_BOUND;
+                return(NX_SOC_ERROR);
             }
 
         }
@@ -4027,6 +4186,16 @@ ULONG               start_time = nx_bsd_system_clock;
         wait_option = bsd_socket_ptr -> nx_bsd_option_receive_timeout; 
     }
 
+#ifdef NX_BSD_ENABLE_BATCH
+    /* UDP datagrams are queued under the socket receive lock, so take them
+       without the protection mutex. A pending socket error is reported below.  */
+    if ((bsd_socket_ptr -> nx_bsd_socket_udp_socket) &&
+        !(bsd_socket_ptr -> nx_bsd_socket_status_flags & NX_BSD_SOCKET_ERROR))
+    {
+        return(nx_bsd_receive_datagram(bsd_socket_ptr, rcvBuffer, bufferLength, flags, wait_option));
+    }
+#endif /* NX_BSD_ENABLE_BATCH */
+
     /* Get the protection mutex.  */
     status =  tx_mutex_get(nx_bsd_protection_ptr, NX_BSD_TIMEOUT);
 
@@ -4071,6 +4240,19 @@ ULONG               start_time = nx_bsd_system_clock;
         return(NX_SOC_ERROR);                                                 
     }                                                                            
 
+#ifdef NX_BSD_ENABLE_BATCH
+    /* Another caller took the error first. The UDP queue is held by the socket
+       receive lock, not by this mutex.  */
+    if (bsd_socket_ptr -> nx_bsd_socket_udp_socket)
+    {
+
+        /* Release the protection mutex.  */
+        tx_mutex_put(nx_bsd_protection_ptr);
+
+        return(nx_bsd_receive_datagram(bsd_socket_ptr, rcvBuffer, bufferLength, flags, wait_option));
+    }
+#endif /* NX_BSD_ENABLE_BATCH */
+
     /* Set pointers to the BSD NetX Duo sockets.  */
     tcp_socket_ptr =  bsd_socket_ptr -> nx_bsd_socket_tcp_socket;
 
@@ -4429,100 +4611,1294 @@ ULONG               start_time = nx_bsd_system_clock;
                )
         {
 
-            /* For UDP or raw socket, We extracted as much as can fit in the caller's buffer. 
-               We will discard the remaining bytes. */
-            bsd_socket_ptr -> nx_bsd_socket_received_packet =  packet_ptr -> nx_packet_queue_next;
+            /* For UDP or raw socket, We extracted as much as can fit in the caller's buffer. 
+               We will discard the remaining bytes. */
+            bsd_socket_ptr -> nx_bsd_socket_received_packet =  packet_ptr -> nx_packet_queue_next;
+
+            bytes_received = packet_ptr -> nx_packet_length;
+
+            /* No need to retain the packet.  */
+            nx_packet_release(packet_ptr);
+
+            /* Clear the offset.  */
+            bsd_socket_ptr -> nx_bsd_socket_received_packet_offset =  0;
+        }
+        else
+        {
+        
+            /* For TCP, the remaining data is saved for the next recv call. 
+               Just update the offset.  */
+            bsd_socket_ptr -> nx_bsd_socket_received_packet_offset =  offset;
+        }
+        bsd_socket_ptr -> nx_bsd_socket_received_byte_count -= bytes_received;
+        bsd_socket_ptr -> nx_bsd_socket_received_packet_count--;
+    }
+
+    /* Release the protection mutex.  */
+    tx_mutex_put(nx_bsd_protection_ptr);
+
+    /* Successful received a packet. Return the number of bytes copied to buffer.  */
+    return((INT)bytes_received + (INT)header_size);
+}
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    recvfrom                                            PORTABLE C      */ 
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */
+/*    This function copies up to a specified number of bytes, received on */
+/*    the socket into a specified location. To use recvfrom() on a TCP    */
+/*    socket requires the socket to be in the connected state.            */
+/*                                                                        */
+/*    This function is identical to recv() except for returning the sender*/
+/*    address and length if non null arguments are supplied.              */  
+/*                                                                        */
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    sockID                                Socket(must be connected)     */
+/*    buffer                                Pointer to hold data received */
+/*    bufferSize                            Maximum number of bytes       */ 
+/*    flags                                 Control flags, support        */
+/*                                            MSG_PEEK and MSG_DONTWAIT   */
+/*    fromAddr                              Address data of sender        */
+/*    fromAddrLen                           Length of address structure   */
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    number of bytes received              If no error occurs            */
+/*    NX_SOC_ERROR (-1)                     In case of any error          */
+/*                                                                        */
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    memset                                Clear memory                  */
+/*    nx_packet_allocate                    Allocate a packet             */
+/*    nx_packet_data_extract_offset         Extract packet data           */
+/*    nx_packet_release                     Free the packet used          */
+/*    tx_mutex_get                          Get protection                */
+/*    tx_mutex_put                          Release protection            */
+/*    tx_event_flags_get                    Wait for data to arrive       */
+/*                                                                        */
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    Application Code                                                    */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s), and      */
+/*                                            verified memcpy use cases,  */
+/*                                            resulting in version 6.1    */
+/*                                                                        */
+/**************************************************************************/
+INT  recvfrom(INT sockID, CHAR *rcvBuffer, INT bufferLength, INT flags, struct sockaddr *fromAddr, INT *fromAddrLen)
+{
+
+INT                  bytes_received;
+NX_BSD_SOCKET       *bsd_socket_ptr;
+#ifndef NX_DISABLE_IPV4
+struct sockaddr_in  peer4_address;
+#endif /* NX_DISABLE_IPV4 */
+#ifdef FEATURE_NX_IPV6
+struct sockaddr_in6 peer6_address;
+#endif
+
+    /* Check for a valid socket ID. */
+    if ((sockID < NX_BSD_SOCKFD_START) || (sockID >= (NX_BSD_SOCKFD_START + NX_BSD_MAX_SOCKETS)))
+    {
+
+        /* Set the socket error if extended options enabled. */
+        set_errno(EBADF);
+        /* Return an error.  */
+        NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
+        return(NX_SOC_ERROR);
+    }
+
+    /* Set up a pointer to the socket.  */
+    bsd_socket_ptr =  &nx_bsd_socket_array[sockID - NX_BSD_SOCKFD_START];
+
+    /* Socket error checking is done inside recv() call. */
+
+    /* Call the equivalent recv() function. */
+    bytes_received = recv(sockID, rcvBuffer, bufferLength, flags);
+
+    /* Check for error. */
+    if (bytes_received < 0)
+    {
+
+        /* Return an error status. */
+        return NX_SOC_ERROR;
+    }
+    /* If no bytes are received do not handle as an error. */
+    else if (bytes_received == 0)
+    {
+        return NX_SOC_OK;
+    }
+
+    /* At this point we did receive a packet. */
+    /* Supply the sender address if valid pointer is supplied. */
+    if(fromAddr && (*fromAddrLen != 0))
+    {
+
+#ifndef NX_DISABLE_IPV4
+        /* Handle the IPv4 socket type. */
+        if(bsd_socket_ptr -> nx_bsd_socket_family == AF_INET)
+        {
+            /* Update the Client address with socket family, remote host IPv4 address and port.  */
+            peer4_address.sin_family =      AF_INET;
+            if(bsd_socket_ptr -> nx_bsd_socket_tcp_socket)
+            {
+                peer4_address.sin_addr.s_addr = htonl(bsd_socket_ptr -> nx_bsd_socket_peer_ip.nxd_ip_address.v4);
+                peer4_address.sin_port = htons(bsd_socket_ptr -> nx_bsd_socket_peer_port);
+            }
+            else
+            {
+                peer4_address.sin_addr.s_addr = ntohl(bsd_socket_ptr -> nx_bsd_socket_source_ip_address.nxd_ip_address.v4);
+
+#ifdef NX_ENABLE_IP_RAW_PACKET_FILTER
+                if(!(bsd_socket_ptr -> nx_bsd_socket_option_flags & NX_BSD_SOCKET_ENABLE_RAW_SOCKET))
+#endif /* NX_ENABLE_IP_RAW_PACKET_FILTER */
+                    peer4_address.sin_port =    ntohs((USHORT)bsd_socket_ptr -> nx_bsd_socket_source_port);
+            }
+            /* Copy the peer address/port info to the ClientAddress.  Truncate if
+               addressLength is smaller than the size of struct sockaddr_in */
+            if(*fromAddrLen > (INT)sizeof(struct sockaddr_in))
+            {
+                *fromAddrLen = sizeof(struct sockaddr_in);
+            }
+            memcpy(fromAddr, &peer4_address, (UINT)(*fromAddrLen)); /* Use case of memcpy is verified. */
+        }
+        else
+#endif /* NX_DISABLE_IPV4 */
+
+#ifdef FEATURE_NX_IPV6 
+        if(bsd_socket_ptr -> nx_bsd_socket_family == AF_INET6) 
+        {
+            /* Update the Client address with socket family, remote host IPv6 address and port.  */
+            peer6_address.sin6_family = AF_INET6;
+            
+            if(bsd_socket_ptr -> nx_bsd_socket_tcp_socket)
+            {
+                peer6_address.sin6_addr._S6_un._S6_u32[0] = ntohl(bsd_socket_ptr -> nx_bsd_socket_peer_ip.nxd_ip_address.v6[0]);
+                peer6_address.sin6_addr._S6_un._S6_u32[1] = ntohl(bsd_socket_ptr -> nx_bsd_socket_peer_ip.nxd_ip_address.v6[1]);
+                peer6_address.sin6_addr._S6_un._S6_u32[2] = ntohl(bsd_socket_ptr -> nx_bsd_socket_peer_ip.nxd_ip_address.v6[2]);
+                peer6_address.sin6_addr._S6_un._S6_u32[3] = ntohl(bsd_socket_ptr -> nx_bsd_socket_peer_ip.nxd_ip_address.v6[3]);
+                peer6_address.sin6_port = ntohs(bsd_socket_ptr -> nx_bsd_socket_peer_port);
+            }
+            else
+            {
+                peer6_address.sin6_addr._S6_un._S6_u32[0] = ntohl(bsd_socket_ptr -> nx_bsd_socket_source_ip_address.nxd_ip_address.v6[0]);
+                peer6_address.sin6_addr._S6_un._S6_u32[1] = ntohl(bsd_socket_ptr -> nx_bsd_socket_source_ip_address.nxd_ip_address.v6[1]);
+                peer6_address.sin6_addr._S6_un._S6_u32[2] = ntohl(bsd_socket_ptr -> nx_bsd_socket_source_ip_address.nxd_ip_address.v6[2]);
+                peer6_address.sin6_addr._S6_un._S6_u32[3] = ntohl(bsd_socket_ptr -> nx_bsd_socket_source_ip_address.nxd_ip_address.v6[3]);
+            
+            /* Skip the port data for raw sockets. They do not use them. */
+#ifdef NX_ENABLE_IP_RAW_PACKET_FILTER
+                if(!(bsd_socket_ptr -> nx_bsd_socket_option_flags & NX_BSD_SOCKET_ENABLE_RAW_SOCKET))
+#endif /* NX_ENABLE_IP_RAW_PACKET_FILTER */
+                    peer6_address.sin6_port = ntohs((USHORT)bsd_socket_ptr -> nx_bsd_socket_source_port);
+            }
+            
+            if((*fromAddrLen) > (INT)sizeof(peer6_address))
+            {
+                *fromAddrLen = sizeof(peer6_address);
+            }
+            memcpy(fromAddr, &peer6_address, (UINT)(*fromAddrLen)); /* Use case of memcpy is verified. */
+            
+        }
+        else
+#endif /* !FEATURE_NX_IPV6 */
+#if defined(NX_BSD_RAW_PPPOE_SUPPORT) || defined(NX_BSD_RAW_SUPPORT)
+        if(bsd_socket_ptr -> nx_bsd_socket_family == AF_PACKET)
+        {
+            if(*fromAddrLen >= (INT)sizeof(struct sockaddr_ll))
+            {
+                struct sockaddr_ll *sockaddr = (struct sockaddr_ll*)fromAddr;
+                INT i;
+                sockaddr -> sll_family = AF_PACKET;
+                sockaddr -> sll_protocol = bsd_socket_ptr -> nx_bsd_socket_sll_protocol;
+                sockaddr -> sll_ifindex = bsd_socket_ptr -> nx_bsd_socket_sll_ifindex;
+                sockaddr -> sll_hatype = 0;
+                sockaddr -> sll_pkttype = 0;
+                sockaddr -> sll_halen = 6;
+                for(i = 0; i < 6; i++)
+                    sockaddr -> sll_addr[i] = bsd_socket_ptr -> nx_bsd_socket_sll_addr[i];
+                *fromAddrLen = sizeof(struct sockaddr_ll);
+            }
+
+        }
+        else
+#endif
+        {
+            
+            /* Release the protection mutex.  */
+            tx_mutex_put(nx_bsd_protection_ptr);
+            
+            /* Set the socket error if extended socket options enabled. */
+            set_errno(EINVAL);  
+            
+            /* Error, IPv6 support is not enabled.  */
+            NX_BSD_ERROR(ERROR, __LINE__);
+            return(ERROR);
+        }
+    }
+
+    /* Successfully received a packet. Return bytes received. */
+    return (INT)(bytes_received);
+}
+
+
+#ifdef NX_BSD_ENABLE_BATCH
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    sendmmsg                                            PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Wind Turbine Team                                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sends up to vlen datagrams on a UDP socket in one     */
+/*    call. Each message is gathered from its msg_iov into a packet, and   */
+/*    sent to msg_name, or to the connected peer when msg_name is NULL.   */
+/*                                                                        */
+/*    All packets are built before the protection mutex is obtained, and  */
+/*    the mutex is then held once for the whole batch instead of once per */
+/*    datagram. msg_len is set to the bytes of each message.              */
+/*                                                                        */
+/*    If a message cannot be built or sent, the messages before it are    */
+/*    still sent and their count is returned; the error is only reported  */
+/*    when no message was sent.                                           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    sockID                                BSD socket ID (UDP)           */
+/*    msgvec                                Messages to send              */
+/*    vlen                                  Number of messages, at most   */
+/*                                            NX_BSD_BATCH_MAX are sent   */
+/*    flags                                 Control flags, support        */
+/*                                            MSG_DONTWAIT                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    Number of messages sent               If success                    */
+/*    NX_SOC_ERROR (-1)                     If failure                    */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    nx_bsd_udp_socket_auto_bind           Bind to a free port           */
+/*    nx_packet_allocate                    Allocate a packet             */
+/*    nx_packet_data_append                 Append data to the packet     */
+/*    nx_packet_release                     Release unsent packets        */
+/*    nxd_udp_socket_send                   UDP packet send               */
+/*    nxd_udp_socket_interface_send         UDP packet send via a         */
+/*                                            specific interface          */
+/*    nx_bsd_send_error_set                 Sets the errno of a failed    */
+/*                                            send                        */
+/*    tx_mutex_get                          Get protection                */
+/*    tx_mutex_put                          Release protection            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-18-2026     Wind Turbine Team        Initial Version 6.1           */
+/*                                                                        */
+/**************************************************************************/
+INT  sendmmsg(INT sockID, struct mmsghdr *msgvec, UINT vlen, INT flags)
+{
+
+UINT                status = NX_SUCCESS;
+NX_BSD_SOCKET       *bsd_socket_ptr;
+NX_PACKET           *packet_ptr;
+NX_PACKET           *head_packet_ptr = NX_NULL;
+NX_PACKET           *tail_packet_ptr = NX_NULL;
+struct msghdr       *msg_ptr;
+struct sockaddr     *dest_addr;
+NXD_ADDRESS         peer_ip_address;
+USHORT              peer_port = 0;
+UINT                packet_type;
+UINT                wait_option;
+UINT                count;
+UINT                sent = 0;
+INT                 i;
+
+    /* Check for a valid socket ID.  */
+    if ((sockID < NX_BSD_SOCKFD_START) || (sockID >= (NX_BSD_SOCKFD_START + NX_BSD_MAX_SOCKETS)))
+    {
+
+        /* Set the socket error if extended options enabled. */
+        set_errno(EBADF);
+
+        /* Return an error status. */
+        NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
+        return(NX_SOC_ERROR);
+    }
+
+    /* Set up a socket pointer to the BSD socket.  */
+    bsd_socket_ptr =  &nx_bsd_socket_array[sockID - NX_BSD_SOCKFD_START];
+
+    /* If the socket has an error */
+    if(bsd_socket_ptr -> nx_bsd_socket_status_flags & NX_BSD_SOCKET_ERROR) 
+    {                                                                        
+        INT errcode = bsd_socket_ptr -> nx_bsd_socket_error_code;    
+
+        /* Now clear the error code. */
+        bsd_socket_ptr -> nx_bsd_socket_error_code = 0;
+        
+        /* Clear the error flag.  The application is expected to close the socket at this point.*/  
+        bsd_socket_ptr -> nx_bsd_socket_status_flags = 
+            bsd_socket_ptr -> nx_bsd_socket_status_flags & (ULONG)(~NX_BSD_SOCKET_ERROR); 
+                                                                             
+        set_errno(errcode);                                                  
+                                                                             
+        /* Return an error.  */                                               
+        NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);                                 
+        return(NX_SOC_ERROR);                                                 
+    } 
+
+    /* Is the socket in use?  */
+    if (!(bsd_socket_ptr -> nx_bsd_socket_status_flags & NX_BSD_SOCKET_IN_USE))
+    {
+
+        /* Set the socket error if extended options enabled. */
+        set_errno(EBADF);
+
+        /* Return an error status. */
+        NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
+        return(NX_SOC_ERROR);
+    }
+
+    /* Only UDP sockets carry whole datagrams.  */
+    if (bsd_socket_ptr -> nx_bsd_socket_protocol != NX_PROTOCOL_UDP)
+    {
+
+        /* Set the socket error if extended options enabled. */
+        set_errno(EOPNOTSUPP);
+
+        /* Return an error status. */
+        NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
+        return(NX_SOC_ERROR);
+    }
+
+    /* Check for an invalid message vector.  */
+    if (msgvec == NX_NULL)
+    {
+
+        /* Set the socket error if extended options enabled. */
+        set_errno(EINVAL);
+
+        /* Return an error status. */
+        NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
+        return(NX_SOC_ERROR);
+    }
+
+    /* Cut the batch.  */
+    if (vlen > NX_BSD_BATCH_MAX)
+    {
+        vlen = NX_BSD_BATCH_MAX;
+    }
+
+    if (vlen == 0)
+    {
+        return(0);
+    }
+
+    /* Make sure the socket is bound.  */
+    if (nx_bsd_udp_socket_auto_bind(bsd_socket_ptr) != NX_SOC_OK)
+    {
+        return(NX_SOC_ERROR);
+    }
+
+#ifndef NX_DISABLE_IPV4
+    if (bsd_socket_ptr -> nx_bsd_socket_family == AF_INET)
+        packet_type = NX_IPv4_UDP_PACKET;
+    else
+#endif /* NX_DISABLE_IPV4 */
+        packet_type = NX_IPv6_UDP_PACKET;
+
+    /* Is this a non blocking socket? */
+    if ((bsd_socket_ptr -> nx_bsd_socket_option_flags & NX_BSD_SOCKET_ENABLE_OPTION_NON_BLOCKING) ||
+        (flags & MSG_DONTWAIT))
+    {
+
+        /* Yes, set to wait to zero on the NetX call. */
+        wait_option = 0 ; 
+    }
+    /* Does this socket have a send timeout option set? */
+    else if (bsd_socket_ptr -> nx_bsd_option_send_timeout)
+    {
+         
+        /* Yes, this is our wait option. */
+        wait_option = bsd_socket_ptr -> nx_bsd_option_send_timeout; 
+    }
+    else
+        wait_option = TX_WAIT_FOREVER;
+
+    /* Build the datagrams without protection, chained through the queue pointer.  */
+    for (count = 0; count < vlen; count++)
+    {
+
+        msg_ptr =  &msgvec[count].msg_hdr;
+        dest_addr =  (struct sockaddr *)msg_ptr -> msg_name;
+
+        /* A message without a destination goes to the connected peer.  */
+        if (dest_addr == NX_NULL)
+        {
+            if (!(bsd_socket_ptr -> nx_bsd_socket_status_flags & NX_BSD_SOCKET_CONNECTED))
+            {
+                set_errno(EDESTADDRREQ);
+                status =  NX_IP_ADDRESS_ERROR;
+                break;
+            }
+        }
+        else if (dest_addr -> sa_family != bsd_socket_ptr -> nx_bsd_socket_family)
+        {
+            set_errno(EAFNOSUPPORT);
+            status =  NX_IP_ADDRESS_ERROR;
+            break;
+        }
+
+        status =  nx_packet_allocate(nx_bsd_default_packet_pool, &packet_ptr, packet_type, wait_option);
+        if (status != NX_SUCCESS)
+        {
+            set_errno(ENOBUFS);
+            break;
+        }
+
+        /* Gather the message.  */
+        for (i = 0; i < msg_ptr -> msg_iovlen; i++)
+        {
+            if (msg_ptr -> msg_iov[i].iov_len == 0)
+            {
+                continue;
+            }
+
+            status =  nx_packet_data_append(packet_ptr, msg_ptr -> msg_iov[i].iov_base, msg_ptr -> msg_iov[i].iov_len,
+                                            nx_bsd_default_packet_pool, wait_option);
+            if (status != NX_SUCCESS)
+            {
+                break;
+            }
+        }
+
+        if (status != NX_SUCCESS)
+        {
+            nx_packet_release(packet_ptr);
+            set_errno(ENOBUFS);
+            break;
+        }
+
+        msgvec[count].msg_len =  (UINT)packet_ptr -> nx_packet_length;
+
+        /* Append the packet to the batch.  */
+        packet_ptr -> nx_packet_queue_next =  NX_NULL;
+        if (tail_packet_ptr)
+            tail_packet_ptr -> nx_packet_queue_next =  packet_ptr;
+        else
+            head_packet_ptr =  packet_ptr;
+        tail_packet_ptr =  packet_ptr;
+    }
+
+    /* Was any datagram built?  */
+    if (head_packet_ptr == NX_NULL)
+    {
+
+        /* No, the socket error is set already.  */
+        NX_BSD_ERROR(status, __LINE__);
+        return(NX_SOC_ERROR);
+    }
+
+    /* Get the protection mutex once for the batch.  */
+    status =  tx_mutex_get(nx_bsd_protection_ptr, NX_BSD_TIMEOUT);
+
+    if (status != NX_SUCCESS)
+    {
+
+        /* Set the socket error if extended socket options enabled. */
+        set_errno(EACCES);  
+        NX_BSD_ERROR(NX_BSD_MUTEX_ERROR, __LINE__);
+    }
+    else if (!(bsd_socket_ptr -> nx_bsd_socket_status_flags & NX_BSD_SOCKET_IN_USE))
+    {
+
+        /* The socket was closed meanwhile.  */
+        set_errno(EBADF);
+        NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
+        tx_mutex_put(nx_bsd_protection_ptr);
+        status =  NX_NOT_SUCCESSFUL;
+    }
+    else
+    {
+
+        /* Send the datagrams in order, stop at the first failure.  */
+        while (head_packet_ptr)
+        {
+
+            packet_ptr =  head_packet_ptr;
+            head_packet_ptr =  packet_ptr -> nx_packet_queue_next;
+            packet_ptr -> nx_packet_queue_next =  NX_NULL;
+
+            dest_addr =  (struct sockaddr *)msgvec[sent].msg_hdr.msg_name;
+
+            if (dest_addr == NX_NULL)
+            {
+                peer_ip_address =  bsd_socket_ptr -> nx_bsd_socket_peer_ip;
+                peer_port =  bsd_socket_ptr -> nx_bsd_socket_peer_port;
+            }
+#ifndef NX_DISABLE_IPV4
+            else if (bsd_socket_ptr -> nx_bsd_socket_family == AF_INET)
+            {
+                peer_ip_address.nxd_ip_version = NX_IP_VERSION_V4; 
+                peer_ip_address.nxd_ip_address.v4 = htonl(((struct sockaddr_in *) dest_addr) -> sin_addr.s_addr);
+                peer_port = htons(((struct sockaddr_in *) dest_addr) -> sin_port);
+            }
+#endif /* NX_DISABLE_IPV4 */
+#ifdef FEATURE_NX_IPV6
+            else
+            {
+                peer_ip_address.nxd_ip_version = NX_IP_VERSION_V6;
+                peer_ip_address.nxd_ip_address.v6[0] = ntohl(((struct sockaddr_in6*)dest_addr) -> sin6_addr._S6_un._S6_u32[0]);
+                peer_ip_address.nxd_ip_address.v6[1] = ntohl(((struct sockaddr_in6*)dest_addr) -> sin6_addr._S6_un._S6_u32[1]);
+                peer_ip_address.nxd_ip_address.v6[2] = ntohl(((struct sockaddr_in6*)dest_addr) -> sin6_addr._S6_un._S6_u32[2]);
+                peer_ip_address.nxd_ip_address.v6[3] = ntohl(((struct sockaddr_in6*)dest_addr) -> sin6_addr._S6_un._S6_u32[3]);
+                peer_port = htons(((struct sockaddr_in6 *) dest_addr) -> sin6_port);
+            }
+#endif /* FEATURE_NX_IPV6 */
+
+            if (bsd_socket_ptr -> nx_bsd_socket_local_bind_interface_index == NX_BSD_LOCAL_IF_INADDR_ANY)
+                status =  nxd_udp_socket_send(bsd_socket_ptr -> nx_bsd_socket_udp_socket, packet_ptr, &peer_ip_address, peer_port);
+            else
+                status =  nxd_udp_socket_interface_send(bsd_socket_ptr -> nx_bsd_socket_udp_socket, packet_ptr, &peer_ip_address, peer_port,
+                                                        bsd_socket_ptr -> nx_bsd_socket_local_bind_interface_index);
+
+            if (status != NX_SUCCESS)
+            {
+
+                /* Report the error only if nothing was sent.  */
+                nx_packet_release(packet_ptr);
+                if (sent == 0)
+                {
+                    nx_bsd_send_error_set(bsd_socket_ptr, flags, status);
+                    NX_BSD_ERROR(status, __LINE__);
+                }
+                break;
+            }
+
+            sent++;
+        }
+
+        /* Release the protection mutex.  */
+        tx_mutex_put(nx_bsd_protection_ptr);
+    }
+
+    /* Release the datagrams not sent.  */
+    while (head_packet_ptr)
+    {
+        packet_ptr =  head_packet_ptr;
+        head_packet_ptr =  packet_ptr -> nx_packet_queue_next;
+        packet_ptr -> nx_packet_queue_next =  NX_NULL;
+        nx_packet_release(packet_ptr);
+    }
+
+    if (sent == 0)
+    {
+        return(NX_SOC_ERROR);
+    }
+
+    return((INT)sent);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    recvmmsg                                            PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Wind Turbine Team                                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function receives up to vlen datagrams on a UDP socket in one  */
+/*    call. Each datagram is scattered into the msg_iov of its message;   */
+/*    msg_len is set to the bytes copied, and MSG_TRUNC is set in         */
+/*    msg_flags when the datagram did not fit. The sender address is      */
+/*    written to msg_name when it is supplied.                            */
+/*                                                                        */
+/*    The datagrams are taken off the socket queue under the socket       */
+/*    receive lock only; the protection mutex is not obtained.            */
+/*                                                                        */
+/*    The call waits until vlen datagrams are received or the timeout     */
+/*    expires; with MSG_WAITFORONE it returns once one is received. A     */
+/*    NULL timeout waits as recv() does.                                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    sockID                                BSD socket ID (UDP)           */
+/*    msgvec                                Messages to receive into      */
+/*    vlen                                  Number of messages, at most   */
+/*                                            NX_BSD_BATCH_MAX are filled */
+/*    flags                                 Control flags, support        */
+/*                                            MSG_DONTWAIT and            */
+/*                                            MSG_WAITFORONE              */
+/*    timeout                               Wait for the batch            */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    Number of messages received           If success                    */
+/*    NX_SOC_ERROR (-1)                     If failure                    */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    nx_bsd_receive_batch                  Take datagrams off the queue  */
+/*    nx_packet_data_extract_offset         Retrieve packet data          */
+/*    nx_bsd_msg_name_set                   Write the sender address      */
+/*    nx_packet_release                     Free the packet after use     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-18-2026     Wind Turbine Team        Initial Version 6.1           */
+/*                                                                        */
+/**************************************************************************/
+INT  recvmmsg(INT sockID, struct mmsghdr *msgvec, UINT vlen, INT flags, struct timespec *timeout)
+{
+
+NX_PACKET           *packet_array[NX_BSD_BATCH_MAX];
+NX_PACKET           *packet_ptr;
+NX_BSD_SOCKET       *bsd_socket_ptr;
+struct msghdr       *msg_ptr;
+ULONG               offset;
+ULONG               bytes_copied;
+INT                 count;
+INT                 i;
+INT                 j;
+
+    /* Check for an invalid message vector.  */
+    if ((msgvec == NX_NULL) || (flags & MSG_PEEK))
+    {
+
+        /* Set the socket error if extended options enabled. */
+        set_errno(EINVAL);
+
+        /* Return an error status. */
+        NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
+        return(NX_SOC_ERROR);
+    }
+
+    /* Take the datagrams off the socket queue.  */
+    count =  nx_bsd_receive_batch(sockID, packet_array, vlen, flags, timeout);
+
+    if (count <= 0)
+    {
+        return(count);
+    }
+
+    bsd_socket_ptr =  &nx_bsd_socket_array[sockID - NX_BSD_SOCKFD_START];
+
+    for (i = 0; i < count; i++)
+    {
+
+        msg_ptr =  &msgvec[i].msg_hdr;
+        packet_ptr =  packet_array[i];
+
+        /* Scatter the datagram into the message buffers.  */
+        offset = 0;
+        for (j = 0; (j < msg_ptr -> msg_iovlen) && (offset < packet_ptr -> nx_packet_length); j++)
+        {
+            if (msg_ptr -> msg_iov[j].iov_len == 0)
+            {
+                continue;
+            }
+
+            nx_packet_data_extract_offset(packet_ptr, offset, msg_ptr -> msg_iov[j].iov_base,
+                                          msg_ptr -> msg_iov[j].iov_len, &bytes_copied);
+            offset += bytes_copied;
+        }
+
+        msgvec[i].msg_len =  (UINT)offset;
+        msg_ptr -> msg_controllen =  0;
+        msg_ptr -> msg_flags =  (offset < packet_ptr -> nx_packet_length) ? MSG_TRUNC : 0;
+
+        /* Supply the sender address if a buffer is given.  */
+        if (msg_ptr -> msg_name && (msg_ptr -> msg_namelen > 0))
+        {
+            nx_bsd_msg_name_set(bsd_socket_ptr, packet_ptr, msg_ptr);
+        }
+
+        nx_packet_release(packet_ptr);
+    }
+
+    return(count);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    nx_bsd_recvmmsg_packets                             PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Wind Turbine Team                                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is the zero copy form of recvmmsg. It takes up to     */
+/*    vlen datagrams off a UDP socket and returns the NetX packets        */
+/*    themselves, with the prepend pointer at the UDP payload.            */
+/*                                                                        */
+/*    The caller owns the packets: the sender is read with                */
+/*    nxd_udp_source_extract, and each packet must be returned with       */
+/*    nx_packet_release.                                                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    sockID                                BSD socket ID (UDP)           */
+/*    packet_array                          Packets received              */
+/*    vlen                                  Size of the array, at most    */
+/*                                            NX_BSD_BATCH_MAX are taken  */
+/*    flags                                 Control flags, support        */
+/*                                            MSG_DONTWAIT and            */
+/*                                            MSG_WAITFORONE              */
+/*    timeout                               Wait for the batch            */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    Number of packets received            If success                    */
+/*    NX_SOC_ERROR (-1)                     If failure                    */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    nx_bsd_receive_batch                  Take datagrams off the queue  */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-18-2026     Wind Turbine Team        Initial Version 6.1           */
+/*                                                                        */
+/**************************************************************************/
+INT  nx_bsd_recvmmsg_packets(INT sockID, NX_PACKET **packet_array, UINT vlen, INT flags, struct timespec *timeout)
+{
+
+    /* Check for an invalid packet array.  */
+    if ((packet_array == NX_NULL) || (flags & MSG_PEEK))
+    {
+
+        /* Set the socket error if extended options enabled. */
+        set_errno(EINVAL);
+
+        /* Return an error status. */
+        NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
+        return(NX_SOC_ERROR);
+    }
+
+    return(nx_bsd_receive_batch(sockID, packet_array, vlen, flags, timeout));
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    nx_bsd_receive_datagram                             PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Wind Turbine Team                                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is the recv() path of a UDP socket. The datagram is   */
+/*    taken off the receive queue with the socket receive lock only, as   */
+/*    nx_bsd_receive_batch does, so recv() and recvfrom() take a single   */
+/*    mutex per datagram. The data is copied after the lock is released, */
+/*    except for MSG_PEEK where the datagram stays on the queue.          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    bsd_socket_ptr                        Pointer to the BSD socket     */
+/*    rcvBuffer                             Pointer to hold data received */
+/*    bufferLength                          Maximum number of bytes       */
+/*    flags                                 Control flags                 */
+/*    wait_option                           Wait for a datagram           */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    number of bytes received              If success                    */
+/*    NX_SOC_ERROR (-1)                     If failure                    */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    nxd_udp_source_extract                Get the sender address        */
+/*    nx_packet_data_extract_offset         Extract packet data           */
+/*    nx_packet_release                     Free the packet used          */
+/*    tx_mutex_get                          Get the socket receive lock   */
+/*    tx_mutex_put                          Release the receive lock      */
+/*    tx_event_flags_get                    Wait for data to arrive       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    recv                                                                */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-18-2026     Wind Turbine Team        Initial Version 6.1           */
+/*                                                                        */
+/**************************************************************************/
+static INT nx_bsd_receive_datagram(NX_BSD_SOCKET *bsd_socket_ptr, VOID *rcvBuffer, INT bufferLength, INT flags, UINT wait_option)
+{
+
+UINT                status;
+NX_PACKET           *packet_ptr;
+ULONG               requested_events;
+ULONG               bytes_received;
+UINT                remaining_wait_option;
+ULONG               start_time = nx_bsd_system_clock;
+
+    while (1)
+    {
+
+        /* Hold the socket receive queue.  */
+        NX_BSD_RECEIVE_LOCK(bsd_socket_ptr);
+
+        if (!(bsd_socket_ptr -> nx_bsd_socket_status_flags & NX_BSD_SOCKET_IN_USE))
+        {
+
+            /* The socket was closed meanwhile.  */
+            NX_BSD_RECEIVE_UNLOCK(bsd_socket_ptr);
+
+            set_errno(EBADF);
+            NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
+            return(NX_SOC_ERROR);
+        }
+
+        packet_ptr =  bsd_socket_ptr -> nx_bsd_socket_received_packet;
+
+        if (packet_ptr)
+        {
+
+            /* Get the sender and port for recvfrom.  */
+            nxd_udp_source_extract(packet_ptr, &bsd_socket_ptr -> nx_bsd_socket_source_ip_address, (UINT *)&bsd_socket_ptr -> nx_bsd_socket_source_port);
+
+            if (flags & MSG_PEEK)
+            {
+
+                /* The datagram stays queued, so copy it under the lock.  */
+                status =  nx_packet_data_extract_offset(packet_ptr, 0, rcvBuffer, (ULONG)bufferLength, &bytes_received);
+
+                /* Release the socket receive queue.  */
+                NX_BSD_RECEIVE_UNLOCK(bsd_socket_ptr);
+
+                if (status)
+                {
+
+                    /* Set the socket error if extended socket options enabled. */
+                    set_errno(EINVAL);
+                    NX_BSD_ERROR(status, __LINE__);
+                    return(NX_SOC_ERROR);
+                }
+
+                return((INT)bytes_received);
+            }
+
+            /* Take the datagram off the queue.  */
+            bsd_socket_ptr -> nx_bsd_socket_received_packet =  packet_ptr -> nx_packet_queue_next;
+            if (bsd_socket_ptr -> nx_bsd_socket_received_packet == NX_NULL)
+            {
+                bsd_socket_ptr -> nx_bsd_socket_received_packet_tail =  NX_NULL;
+            }
+            bsd_socket_ptr -> nx_bsd_socket_received_packet_offset =  0;
+            bsd_socket_ptr -> nx_bsd_socket_received_byte_count -= packet_ptr -> nx_packet_length;
+            bsd_socket_ptr -> nx_bsd_socket_received_packet_count--;
+            packet_ptr -> nx_packet_queue_next =  NX_NULL;
+
+            /* Release the socket receive queue.  */
+            NX_BSD_RECEIVE_UNLOCK(bsd_socket_ptr);
+
+            /* Copy what fits in the caller's buffer. The rest of the datagram is discarded.  */
+            status =  nx_packet_data_extract_offset(packet_ptr, 0, rcvBuffer, (ULONG)bufferLength, &bytes_received);
+            bytes_received =  packet_ptr -> nx_packet_length;
+
+            /* Release the packet.  */
+            nx_packet_release(packet_ptr);
+
+            if (status)
+            {
+
+                /* Set the socket error if extended socket options enabled. */
+                set_errno(EINVAL);
+                NX_BSD_ERROR(status, __LINE__);
+                return(NX_SOC_ERROR);
+            }
+
+            return((INT)bytes_received);
+        }
+
+        /* Release the socket receive queue.  */
+        NX_BSD_RECEIVE_UNLOCK(bsd_socket_ptr);
+
+        /* Calculate remaining wait option. */
+        remaining_wait_option = (UINT)(wait_option - (nx_bsd_system_clock - start_time));
+        if (remaining_wait_option > wait_option)
+        {
+
+            /* Wait option expired. */
+            status = TX_NO_EVENTS;
+        }
+        else
+        {
+
+            /* Suspend this socket on a RECEIVE event (incoming packet) for the specified wait time.  */
+            status =  tx_event_flags_get(&nx_bsd_events, NX_BSD_RECEIVE_EVENT, TX_OR_CLEAR, &requested_events, remaining_wait_option);
+        }
+
+        if (status == TX_NO_EVENTS)
+        {
+
+            /* Set the socket error depending if this is a non blocking socket. */
+            if ((bsd_socket_ptr -> nx_bsd_socket_option_flags & NX_BSD_SOCKET_ENABLE_OPTION_NON_BLOCKING) || 
+                (wait_option == NX_WAIT_FOREVER) ||
+                (flags & MSG_DONTWAIT))
+                set_errno(EWOULDBLOCK);  
+            else
+                set_errno(EAGAIN);  
+
+            /* Return an error.  */
+            NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
+            return(NX_SOC_ERROR);
+        }
+        else if (status != TX_SUCCESS)
+        {
+
+            /* Set the socket error if extended socket options enabled. */
+            set_errno(EINVAL);  
+
+            /* Return an error.  */
+            NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
+            return(NX_SOC_ERROR); 
+        }
+    }
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    nx_bsd_receive_batch                                PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Wind Turbine Team                                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function takes up to vlen datagrams off the receive queue of a */
+/*    UDP socket, waiting for them as recvmmsg describes. The queue is    */
+/*    held with the socket receive lock only, so a batch receive does not */
+/*    contend with other sockets or with senders for the protection mutex.*/
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    sockID                                BSD socket ID (UDP)           */
+/*    packet_array                          Packets taken off the queue   */
+/*    vlen                                  Size of the array             */
+/*    flags                                 Control flags                 */
+/*    timeout                               Wait for the batch            */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    Number of packets received            If success                    */
+/*    NX_SOC_ERROR (-1)                     If failure                    */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    tx_mutex_get                          Get the socket receive lock   */
+/*    tx_mutex_put                          Release the receive lock      */
+/*    tx_event_flags_get                    Wait for data to arrive       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    recvmmsg                                                            */
+/*    nx_bsd_recvmmsg_packets                                             */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-18-2026     Wind Turbine Team        Initial Version 6.1           */
+/*                                                                        */
+/**************************************************************************/
+static INT nx_bsd_receive_batch(INT sockID, NX_PACKET **packet_array, UINT vlen, INT flags, struct timespec *timeout)
+{
+
+UINT                status;
+NX_PACKET           *packet_ptr;
+NX_BSD_SOCKET       *bsd_socket_ptr;
+ULONG               requested_events;
+UINT                wait_option;
+UINT                remaining_wait_option;
+UINT                count = 0;
+ULONG               start_time = nx_bsd_system_clock;
+
+    /* Check for a valid socket ID.  */
+    if ((sockID < NX_BSD_SOCKFD_START) || (sockID >= (NX_BSD_SOCKFD_START + NX_BSD_MAX_SOCKETS)))
+    {
+
+        /* Set the socket error if extended options enabled. */
+        set_errno(EBADF);
+
+        /* Return an error.  */
+        NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
+        return(NX_SOC_ERROR);
+    }
+
+    /* Set up a pointer to the socket.  */
+    bsd_socket_ptr =  &nx_bsd_socket_array[sockID - NX_BSD_SOCKFD_START];
+
+    /* If the socket has an error */
+    if(bsd_socket_ptr -> nx_bsd_socket_status_flags & NX_BSD_SOCKET_ERROR) 
+    {                                                                        
+        INT errcode = bsd_socket_ptr -> nx_bsd_socket_error_code;    
+
+        /* Now clear the error code. */
+        bsd_socket_ptr -> nx_bsd_socket_error_code = 0;
+        
+        /* Clear the error flag.  The application is expected to close the socket at this point.*/  
+        bsd_socket_ptr -> nx_bsd_socket_status_flags = 
+            bsd_socket_ptr -> nx_bsd_socket_status_flags & (ULONG)(~NX_BSD_SOCKET_ERROR); 
+                                                                             
+        set_errno(errcode);                                                  
+                                                                             
+        /* Return an error.  */                                               
+        NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);                                 
+        return(NX_SOC_ERROR);                                                 
+    } 
+
+    /* Is the socket in use?  */
+    if (!(bsd_socket_ptr -> nx_bsd_socket_status_flags & NX_BSD_SOCKET_IN_USE))
+    {
+
+        /* Set the socket error if extended options enabled. */
+        set_errno(EBADF);
+
+        /* Return an error status. */
+        NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
+        return(NX_SOC_ERROR);
+    }
+
+    /* Only UDP sockets queue whole datagrams.  */
+    if (bsd_socket_ptr -> nx_bsd_socket_protocol != NX_PROTOCOL_UDP)
+    {
+
+        /* Set the socket error if extended options enabled. */
+        set_errno(EOPNOTSUPP);
+
+        /* Return an error.  */
+        NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
+        return(NX_SOC_ERROR);
+    }
+
+    /* Cut the batch.  */
+    if (vlen > NX_BSD_BATCH_MAX)
+    {
+        vlen = NX_BSD_BATCH_MAX;
+    }
+
+    if (vlen == 0)
+    {
+        return(0);
+    }
+
+    /* Is this a nonblocking socket?:  */
+    if ((bsd_socket_ptr -> nx_bsd_socket_option_flags & NX_BSD_SOCKET_ENABLE_OPTION_NON_BLOCKING) || 
+        (flags & MSG_DONTWAIT))
+    {
+
+        /* Yes, set to receive wait option to no wait (zero). */
+        wait_option = 0; 
+    }
+    /* Is a timeout given for the batch?  */
+    else if (timeout)
+    {
+        wait_option = (UINT)((ULONG)timeout -> tv_nsec / (NX_MICROSECOND_PER_CPU_TICK * 1000) + 
+                             (ULONG)timeout -> tv_sec * NX_IP_PERIODIC_RATE);
+    }
+    /* Does this socket have a receive timeout option set? */
+    else if (bsd_socket_ptr -> nx_bsd_option_receive_timeout)
+    {
+         
+        /* Yes, this is our wait option. */
+        wait_option = bsd_socket_ptr -> nx_bsd_option_receive_timeout; 
+    }
+    else
+        wait_option = NX_WAIT_FOREVER;
+
+    while (1)
+    {
+
+        /* Take what is queued.  */
+        NX_BSD_RECEIVE_LOCK(bsd_socket_ptr);
+
+        if (!(bsd_socket_ptr -> nx_bsd_socket_status_flags & NX_BSD_SOCKET_IN_USE))
+        {
+
+            /* The socket was closed meanwhile.  */
+            NX_BSD_RECEIVE_UNLOCK(bsd_socket_ptr);
+
+            if (count)
+            {
+                return((INT)count);
+            }
+
+            set_errno(EBADF);
+            NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
+            return(NX_SOC_ERROR);
+        }
+
+        while ((count < vlen) && (bsd_socket_ptr -> nx_bsd_socket_received_packet))
+        {
+            packet_ptr =  bsd_socket_ptr -> nx_bsd_socket_received_packet;
+            bsd_socket_ptr -> nx_bsd_socket_received_packet =  packet_ptr -> nx_packet_queue_next;
+            bsd_socket_ptr -> nx_bsd_socket_received_byte_count -= packet_ptr -> nx_packet_length;
+            bsd_socket_ptr -> nx_bsd_socket_received_packet_count--;
+            packet_ptr -> nx_packet_queue_next =  NX_NULL;
+            packet_array[count++] =  packet_ptr;
+        }
+
+        if (bsd_socket_ptr -> nx_bsd_socket_received_packet == NX_NULL)
+        {
+            bsd_socket_ptr -> nx_bsd_socket_received_packet_tail =  NX_NULL;
+        }
+
+        /* Release the socket receive queue.  */
+        NX_BSD_RECEIVE_UNLOCK(bsd_socket_ptr);
 
-            bytes_received = packet_ptr -> nx_packet_length;
+        /* Is the batch complete?  */
+        if ((count == vlen) || (count && (flags & MSG_WAITFORONE)))
+        {
+            return((INT)count);
+        }
 
-            /* No need to retain the packet.  */
-            nx_packet_release(packet_ptr);
+        /* Calculate remaining wait option. */
+        remaining_wait_option = (UINT)(wait_option - (nx_bsd_system_clock - start_time));
+        if (remaining_wait_option > wait_option)
+        {
 
-            /* Clear the offset.  */
-            bsd_socket_ptr -> nx_bsd_socket_received_packet_offset =  0;
+            /* Wait option expired. */
+            status = TX_NO_EVENTS;
         }
         else
         {
-        
-            /* For TCP, the remaining data is saved for the next recv call. 
-               Just update the offset.  */
-            bsd_socket_ptr -> nx_bsd_socket_received_packet_offset =  offset;
+
+            /* Suspend this socket on a RECEIVE event (incoming packet) for the specified wait time.  */
+            status =  tx_event_flags_get(&nx_bsd_events, NX_BSD_RECEIVE_EVENT, TX_OR_CLEAR, &requested_events, remaining_wait_option);
         }
-        bsd_socket_ptr -> nx_bsd_socket_received_byte_count -= bytes_received;
-        bsd_socket_ptr -> nx_bsd_socket_received_packet_count--;
-    }
 
-    /* Release the protection mutex.  */
-    tx_mutex_put(nx_bsd_protection_ptr);
+        if (status != TX_SUCCESS)
+        {
 
-    /* Successful received a packet. Return the number of bytes copied to buffer.  */
-    return((INT)bytes_received + (INT)header_size);
+            /* Return what was received before the wait ended.  */
+            if (count)
+            {
+                return((INT)count);
+            }
+
+            if (status != TX_NO_EVENTS)
+                set_errno(EINVAL);
+            else if ((bsd_socket_ptr -> nx_bsd_socket_option_flags & NX_BSD_SOCKET_ENABLE_OPTION_NON_BLOCKING) || 
+                     (wait_option == NX_WAIT_FOREVER) ||
+                     (flags & MSG_DONTWAIT))
+                set_errno(EWOULDBLOCK);  
+            else
+                set_errno(EAGAIN);  
+
+            /* Return an error.  */
+            NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
+            return(NX_SOC_ERROR);
+        }
+    }
 }
 
 
-/**************************************************************************/ 
-/*                                                                        */ 
-/*  FUNCTION                                               RELEASE        */ 
-/*                                                                        */ 
-/*    recvfrom                                            PORTABLE C      */ 
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    nx_bsd_msg_name_set                                 PORTABLE C      */
 /*                                                           6.1          */
 /*  AUTHOR                                                                */
 /*                                                                        */
-/*    Yuxin Zhou, Microsoft Corporation                                   */
+/*    Wind Turbine Team                                                   */
 /*                                                                        */
-/*  DESCRIPTION                                                           */ 
+/*  DESCRIPTION                                                           */
 /*                                                                        */
-/*    This function copies up to a specified number of bytes, received on */
-/*    the socket into a specified location. To use recvfrom() on a TCP    */
-/*    socket requires the socket to be in the connected state.            */
+/*    This function writes the sender of a UDP datagram to the msg_name  */
+/*    of a message, truncated to msg_namelen as recvfrom does.            */
 /*                                                                        */
-/*    This function is identical to recv() except for returning the sender*/
-/*    address and length if non null arguments are supplied.              */  
+/*  INPUT                                                                 */
 /*                                                                        */
-/*  INPUT                                                                 */ 
-/*                                                                        */ 
-/*    sockID                                Socket(must be connected)     */
-/*    buffer                                Pointer to hold data received */
-/*    bufferSize                            Maximum number of bytes       */ 
-/*    flags                                 Control flags, support        */
-/*                                            MSG_PEEK and MSG_DONTWAIT   */
-/*    fromAddr                              Address data of sender        */
-/*    fromAddrLen                           Length of address structure   */
-/*                                                                        */ 
-/*  OUTPUT                                                                */ 
-/*                                                                        */ 
-/*    number of bytes received              If no error occurs            */
-/*    NX_SOC_ERROR (-1)                     In case of any error          */
+/*    bsd_socket_ptr                        Pointer to the BSD socket     */
+/*    packet_ptr                            Datagram received             */
+/*    msg_ptr                               Message to fill               */
 /*                                                                        */
-/*  CALLS                                                                 */ 
-/*                                                                        */ 
-/*    memset                                Clear memory                  */
-/*    nx_packet_allocate                    Allocate a packet             */
-/*    nx_packet_data_extract_offset         Extract packet data           */
-/*    nx_packet_release                     Free the packet used          */
-/*    tx_mutex_get                          Get protection                */
-/*    tx_mutex_put                          Release protection            */
-/*    tx_event_flags_get                    Wait for data to arrive       */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    nxd_udp_source_extract                Get the sender address        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    recvmmsg                                                            */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
 /*                                                                        */
-/*  CALLED BY                                                             */ 
-/*                                                                        */ 
-/*    Application Code                                                    */ 
-/*                                                                        */ 
-/*  RELEASE HISTORY                                                       */ 
-/*                                                                        */ 
 /*    DATE              NAME                      DESCRIPTION             */
 /*                                                                        */
-/*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
-/*  09-30-2020     Yuxin Zhou               Modified comment(s), and      */
-/*                                            verified memcpy use cases,  */
-/*                                            resulting in version 6.1    */
+/*  10-18-2026     Wind Turbine Team        Initial Version 6.1           */
 /*                                                                        */
 /**************************************************************************/
-INT  recvfrom(INT sockID, CHAR *rcvBuffer, INT bufferLength, INT flags, struct sockaddr *fromAddr, INT *fromAddrLen)
+static VOID nx_bsd_msg_name_set(NX_BSD_SOCKET *bsd_socket_ptr, NX_PACKET *packet_ptr, struct msghdr *msg_ptr)
 {
 
-INT                  bytes_received;
-NX_BSD_SOCKET       *bsd_socket_ptr;
+NXD_ADDRESS         source_ip_address;
+UINT                source_port;
 #ifndef NX_DISABLE_IPV4
 struct sockaddr_in  peer4_address;
 #endif /* NX_DISABLE_IPV4 */
@@ -4530,149 +5906,53 @@ struct sockaddr_in  peer4_address;
 struct sockaddr_in6 peer6_address;
 #endif
 
-    /* Check for a valid socket ID. */
-    if ((sockID < NX_BSD_SOCKFD_START) || (sockID >= (NX_BSD_SOCKFD_START + NX_BSD_MAX_SOCKETS)))
-    {
-
-        /* Set the socket error if extended options enabled. */
-        set_errno(EBADF);
-        /* Return an error.  */
-        NX_BSD_ERROR(NX_SOC_ERROR, __LINE__);
-        return(NX_SOC_ERROR);
-    }
-
-    /* Set up a pointer to the socket.  */
-    bsd_socket_ptr =  &nx_bsd_socket_array[sockID - NX_BSD_SOCKFD_START];
-
-    /* Socket error checking is done inside recv() call. */
-
-    /* Call the equivalent recv() function. */
-    bytes_received = recv(sockID, rcvBuffer, bufferLength, flags);
-
-    /* Check for error. */
-    if (bytes_received < 0)
-    {
-
-        /* Return an error status. */
-        return NX_SOC_ERROR;
-    }
-    /* If no bytes are received do not handle as an error. */
-    else if (bytes_received == 0)
+    if (nxd_udp_source_extract(packet_ptr, &source_ip_address, &source_port) != NX_SUCCESS)
     {
-        return NX_SOC_OK;
+        msg_ptr -> msg_namelen =  0;
+        return;
     }
 
-    /* At this point we did receive a packet. */
-    /* Supply the sender address if valid pointer is supplied. */
-    if(fromAddr && (*fromAddrLen != 0))
+#ifndef NX_DISABLE_IPV4
+    if (bsd_socket_ptr -> nx_bsd_socket_family == AF_INET)
     {
+        memset(&peer4_address, 0, sizeof(peer4_address));
+        peer4_address.sin_family =  AF_INET;
+        peer4_address.sin_addr.s_addr =  ntohl(source_ip_address.nxd_ip_address.v4);
+        peer4_address.sin_port =  ntohs((USHORT)source_port);
 
-#ifndef NX_DISABLE_IPV4
-        /* Handle the IPv4 socket type. */
-        if(bsd_socket_ptr -> nx_bsd_socket_family == AF_INET)
+        /* Truncate if msg_namelen is smaller than the size of struct sockaddr_in.  */
+        if (msg_ptr -> msg_namelen > (INT)sizeof(struct sockaddr_in))
         {
-            /* Update the Client address with socket family, remote host IPv4 address and port.  */
-            peer4_address.sin_family =      AF_INET;
-            if(bsd_socket_ptr -> nx_bsd_socket_tcp_socket)
-            {
-                peer4_address.sin_addr.s_addr = htonl(bsd_socket_ptr -> nx_bsd_socket_peer_ip.nxd_ip_address.v4);
-                peer4_address.sin_port = htons(bsd_socket_ptr -> nx_bsd_socket_peer_port);
-            }
-            else
-            {
-                peer4_address.sin_addr.s_addr = ntohl(bsd_socket_ptr -> nx_bsd_socket_source_ip_address.nxd_ip_address.v4);
-
-#ifdef NX_ENABLE_IP_RAW_PACKET_FILTER
-                if(!(bsd_socket_ptr -> nx_bsd_socket_option_flags & NX_BSD_SOCKET_ENABLE_RAW_SOCKET))
-#endif /* NX_ENABLE_IP_RAW_PACKET_FILTER */
-                    peer4_address.sin_port =    ntohs((USHORT)bsd_socket_ptr -> nx_bsd_socket_source_port);
-            }
-            /* Copy the peer address/port info to the ClientAddress.  Truncate if
-               addressLength is smaller than the size of struct sockaddr_in */
-            if(*fromAddrLen > (INT)sizeof(struct sockaddr_in))
-            {
-                *fromAddrLen = sizeof(struct sockaddr_in);
-            }
-            memcpy(fromAddr, &peer4_address, (UINT)(*fromAddrLen)); /* Use case of memcpy is verified. */
+            msg_ptr -> msg_namelen =  sizeof(struct sockaddr_in);
         }
-        else
+        memcpy(msg_ptr -> msg_name, &peer4_address, (UINT)(msg_ptr -> msg_namelen)); /* Use case of memcpy is verified. */
+        return;
+    }
 #endif /* NX_DISABLE_IPV4 */
 
-#ifdef FEATURE_NX_IPV6 
-        if(bsd_socket_ptr -> nx_bsd_socket_family == AF_INET6) 
-        {
-            /* Update the Client address with socket family, remote host IPv6 address and port.  */
-            peer6_address.sin6_family = AF_INET6;
-            
-            if(bsd_socket_ptr -> nx_bsd_socket_tcp_socket)
-            {
-                peer6_address.sin6_addr._S6_un._S6_u32[0] = ntohl(bsd_socket_ptr -> nx_bsd_socket_peer_ip.nxd_ip_address.v6[0]);
-                peer6_address.sin6_addr._S6_un._S6_u32[1] = ntohl(bsd_socket_ptr -> nx_bsd_socket_peer_ip.nxd_ip_address.v6[1]);
-                peer6_address.sin6_addr._S6_un._S6_u32[2] = ntohl(bsd_socket_ptr -> nx_bsd_socket_peer_ip.nxd_ip_address.v6[2]);
-                peer6_address.sin6_addr._S6_un._S6_u32[3] = ntohl(bsd_socket_ptr -> nx_bsd_socket_peer_ip.nxd_ip_address.v6[3]);
-                peer6_address.sin6_port = ntohs(bsd_socket_ptr -> nx_bsd_socket_peer_port);
-            }
-            else
-            {
-                peer6_address.sin6_addr._S6_un._S6_u32[0] = ntohl(bsd_socket_ptr -> nx_bsd_socket_source_ip_address.nxd_ip_address.v6[0]);
-                peer6_address.sin6_addr._S6_un._S6_u32[1] = ntohl(bsd_socket_ptr -> nx_bsd_socket_source_ip_address.nxd_ip_address.v6[1]);
-                peer6_address.sin6_addr._S6_un._S6_u32[2] = ntohl(bsd_socket_ptr -> nx_bsd_socket_source_ip_address.nxd_ip_address.v6[2]);
-                peer6_address.sin6_addr._S6_un._S6_u32[3] = ntohl(bsd_socket_ptr -> nx_bsd_socket_source_ip_address.nxd_ip_address.v6[3]);
-            
-            /* Skip the port data for raw sockets. They do not use them. */
-#ifdef NX_ENABLE_IP_RAW_PACKET_FILTER
-                if(!(bsd_socket_ptr -> nx_bsd_socket_option_flags & NX_BSD_SOCKET_ENABLE_RAW_SOCKET))
-#endif /* NX_ENABLE_IP_RAW_PACKET_FILTER */
-                    peer6_address.sin6_port = ntohs((USHORT)bsd_socket_ptr -> nx_bsd_socket_source_port);
-            }
-            
-            if((*fromAddrLen) > (INT)sizeof(peer6_address))
-            {
-                *fromAddrLen = sizeof(peer6_address);
-            }
-            memcpy(fromAddr, &peer6_address, (UINT)(*fromAddrLen)); /* Use case of memcpy is verified. */
-            
-        }
-        else
-#endif /* !FEATURE_NX_IPV6 */
-#if defined(NX_BSD_RAW_PPPOE_SUPPORT) || defined(NX_BSD_RAW_SUPPORT)
-        if(bsd_socket_ptr -> nx_bsd_socket_family == AF_PACKET)
-        {
-            if(*fromAddrLen >= (INT)sizeof(struct sockaddr_ll))
-            {
-                struct sockaddr_ll *sockaddr = (struct sockaddr_ll*)fromAddr;
-                INT i;
-                sockaddr -> sll_family = AF_PACKET;
-                sockaddr -> sll_protocol = bsd_socket_ptr -> nx_bsd_socket_sll_protocol;
-                sockaddr -> sll_ifindex = bsd_socket_ptr -> nx_bsd_socket_sll_ifindex;
-                sockaddr -> sll_hatype = 0;
-                sockaddr -> sll_pkttype = 0;
-                sockaddr -> sll_halen = 6;
-                for(i = 0; i < 6; i++)
-                    sockaddr -> sll_addr[i] = bsd_socket_ptr -> nx_bsd_socket_sll_addr[i];
-                *fromAddrLen = sizeof(struct sockaddr_ll);
-            }
+#ifdef FEATURE_NX_IPV6
+    if (bsd_socket_ptr -> nx_bsd_socket_family == AF_INET6)
+    {
+        memset(&peer6_address, 0, sizeof(peer6_address));
+        peer6_address.sin6_family =  AF_INET6;
+        peer6_address.sin6_addr._S6_un._S6_u32[0] =  ntohl(source_ip_address.nxd_ip_address.v6[0]);
+        peer6_address.sin6_addr._S6_un._S6_u32[1] =  ntohl(source_ip_address.nxd_ip_address.v6[1]);
+        peer6_address.sin6_addr._S6_un._S6_u32[2] =  ntohl(source_ip_address.nxd_ip_address.v6[2]);
+        peer6_address.sin6_addr._S6_un._S6_u32[3] =  ntohl(source_ip_address.nxd_ip_address.v6[3]);
+        peer6_address.sin6_port =  ntohs((USHORT)source_port);
 
-        }
-        else
-#endif
+        if (msg_ptr -> msg_namelen > (INT)sizeof(peer6_address))
         {
-            
-            /* Release the protection mutex.  */
-            tx_mutex_put(nx_bsd_protection_ptr);
-            
-            /* Set the socket error if extended socket options enabled. */
-            set_errno(EINVAL);  
-            
-            /* Error, IPv6 support is not enabled.  */
-            NX_BSD_ERROR(ERROR, __LINE__);
-            return(ERROR);
+            msg_ptr -> msg_namelen =  sizeof(peer6_address);
         }
+        memcpy(msg_ptr -> msg_name, &peer6_address, (UINT)(msg_ptr -> msg_namelen)); /* Use case of memcpy is verified. */
+        return;
     }
+#endif /* FEATURE_NX_IPV6 */
 
-    /* Successfully received a packet. Return bytes received. */
-    return (INT)(bytes_received);
+    msg_ptr -> msg_namelen =  0;
 }
+#endif /* NX_BSD_ENABLE_BATCH */
 
 
 /**************************************************************************/
@@ -4808,6 +6088,9 @@ UINT                 index;
     tcp_socket_ptr =  bsd_socket_ptr -> nx_bsd_socket_tcp_socket;
     udp_socket_ptr =  bsd_socket_ptr -> nx_bsd_socket_udp_socket;
 
+    /* Hold the socket receive queue while it is flushed.  */
+    NX_BSD_RECEIVE_LOCK(bsd_socket_ptr);
+
     /* There is. Flush the queue of all packets. */
     packet_ptr = bsd_socket_ptr -> nx_bsd_socket_received_packet;
     /* Setup packet pointer to the beginning of the queue.  */
@@ -4830,6 +6113,9 @@ UINT                 index;
     bsd_socket_ptr -> nx_bsd_socket_received_packet_count = 0;
     bsd_socket_ptr -> nx_bsd_socket_received_packet_count_max = 0;
 
+    /* Release the socket receive queue.  */
+    NX_BSD_RECEIVE_UNLOCK(bsd_socket_ptr);
+
     /* Now delete the underlying TCP or UDP socket. */
 
     /* Is this a TCP socket? */
@@ -10241,6 +11527,10 @@ NX_INTERFACE   *interface_ptr;
         
         return;
     }
+
+    /* Hold the socket receive queue while the packet is appended.  */
+    NX_BSD_RECEIVE_LOCK(bsd_ptr);
+
     if(bsd_ptr -> nx_bsd_socket_received_packet)
     {
         bsd_ptr -> nx_bsd_socket_received_packet_tail -> nx_packet_queue_next = packet_ptr;
@@ -10255,6 +11545,9 @@ NX_INTERFACE   *interface_ptr;
     bsd_ptr -> nx_bsd_socket_received_packet_tail = packet_ptr;
     bsd_ptr -> nx_bsd_socket_received_byte_count += packet_ptr -> nx_packet_length;
     bsd_ptr -> nx_bsd_socket_received_packet_count++;
+
+    /* Release the socket receive queue.  */
+    NX_BSD_RECEIVE_UNLOCK(bsd_ptr);
         
     nx_bsd_select_wakeup((UINT)(bsd_ptr -> nx_bsd_socket_id), FDSET_READ);
 
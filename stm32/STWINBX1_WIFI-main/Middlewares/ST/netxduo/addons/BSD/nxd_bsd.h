@@ -103,6 +103,15 @@ extern   "C" {
 #define NX_BSD_ENABLE_DNS
 */
 
+/* Define NX_BSD_ENABLE_BATCH to add the batched datagram services sendmmsg() and recvmmsg(),
+   and nx_bsd_recvmmsg_packets() that hands the received NX_PACKETs to the caller instead of
+   copying them.  The receive queue of each socket then gets its own mutex, so these services
+   take datagrams off the queue without the IP instance mutex that the rest of the BSD layer
+   holds.  A receive batch only finds what the socket queued, so raise NX_BSD_SOCKET_QUEUE_MAX
+   with it.  By default NX_BSD_ENABLE_BATCH is NOT defined.
+#define NX_BSD_ENABLE_BATCH
+*/
+
 
 /* 
    Define the BSD socket timeout process to execute in the timer context. 
@@ -128,6 +137,10 @@ extern   "C" {
                       
 /* Define configuration constants for the BSD compatibility layer.  Note that these can be overridden via -D or a #define somewhere else.  */
 
+#ifndef NX_BSD_BATCH_MAX
+#define NX_BSD_BATCH_MAX                    32                      /* Messages taken per sendmmsg() or recvmmsg() call, a larger vlen is cut */
+#endif
+
 #ifndef NX_BSD_TCP_WINDOW
 #define NX_BSD_TCP_WINDOW                   65535                   /* 64k is typical window size for 100Mb ethernet.                       */
 #endif 
@@ -207,6 +220,8 @@ extern   "C" {
 /* Define supported flags for 'send' and 'recv'. */
 #define MSG_PEEK                            0x02                    /* Peek incoming message */
 #define MSG_DONTWAIT                        0x40                    /* Nonblocking IO        */
+#define MSG_TRUNC                           0x20                    /* Datagram was cut to the buffers (msg_flags of recvmmsg) */
+#define MSG_WAITFORONE                      0x10000                 /* recvmmsg returns once one datagram is received */
 
 /* Address families.  */
 
@@ -597,6 +612,32 @@ typedef struct NX_BSD_SOCKET_SUSPEND_STRUCT
 } NX_BSD_SOCKET_SUSPEND;
 
 
+#ifdef NX_BSD_ENABLE_BATCH
+/* Scatter/gather buffer and message headers for the batched datagram services.  */
+struct iovec
+{
+    VOID                *iov_base;          /* Start of the buffer.                                                                         */
+    ULONG               iov_len;            /* Size of the buffer.                                                                          */
+};
+
+struct msghdr
+{
+    VOID                *msg_name;          /* Peer address (sockaddr_in or sockaddr_in6), may be NULL.                                     */
+    INT                 msg_namelen;        /* Size of the peer address, updated on receive.                                                */
+    struct iovec        *msg_iov;           /* Buffers.                                                                                     */
+    INT                 msg_iovlen;         /* Number of buffers.                                                                           */
+    VOID                *msg_control;       /* Ancillary data, not supported.                                                               */
+    INT                 msg_controllen;     /* Set to 0 on receive.                                                                         */
+    INT                 msg_flags;          /* Set on receive: MSG_TRUNC.                                                                   */
+};
+
+struct mmsghdr
+{
+    struct msghdr       msg_hdr;            /* Message.                                                                                     */
+    UINT                msg_len;            /* Bytes sent or received.                                                                      */
+};
+#endif /* NX_BSD_ENABLE_BATCH */
+
 struct ip_mreq 
 {
     struct in_addr imr_multiaddr;     /* The IPv4 multicast address to join. */
@@ -838,6 +879,11 @@ INT  sendto(INT sockID, CHAR *msg, INT msgLength, INT flags, struct sockaddr *de
 INT  send(INT sockID, const CHAR *msg, INT msgLength, INT flags);
 INT  select(INT nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struct timeval *timeout);
 INT  soc_close( INT sockID);
+#ifdef NX_BSD_ENABLE_BATCH
+INT  sendmmsg(INT sockID, struct mmsghdr *msgvec, UINT vlen, INT flags);
+INT  recvmmsg(INT sockID, struct mmsghdr *msgvec, UINT vlen, INT flags, struct timespec *timeout);
+INT  nx_bsd_recvmmsg_packets(INT sockID, NX_PACKET **packet_array, UINT vlen, INT flags, struct timespec *timeout);
+#endif /* NX_BSD_ENABLE_BATCH */
 INT  socket(INT protocolFamily, INT type, INT protocol);
 INT  fcntl(INT sock_ID, UINT flag_type, UINT f_options);
 INT  getsockopt(INT sockID, INT option_level, INT option_name, VOID *option_value, INT *option_length);
@@ -4323,7 +4323,7 @@ NX_UDP_SOCKET       *udp_end_ptr;
     {       
 
         /* Calculate the hash index in the TCP port array of the associated IP instance.  */
-        index =  (UINT) ((port + (port >> 8)) & NX_TCP_PORT_TABLE_MASK); 
+        index =  NX_TCP_PORT_HASH(port); 
 
         /* Pickup the head of the TCP ports bound list.  */
         tcp_search_ptr =  ip_ptr -> nx_ip_tcp_port_table[index];
@@ -4356,7 +4356,7 @@ NX_UDP_SOCKET       *udp_end_ptr;
     {
 
         /* Calculate the hash index in the UDP port array of the associated IP instance.  */
-        index =  (UINT) ((port + (port >> 8)) & NX_UDP_PORT_TABLE_MASK); 
+        index =  NX_UDP_PORT_HASH(port); 
 
         /* Pickup the head of the UDP ports bound list.  */
         udp_search_ptr =  ip_ptr -> nx_ip_udp_port_table[index];
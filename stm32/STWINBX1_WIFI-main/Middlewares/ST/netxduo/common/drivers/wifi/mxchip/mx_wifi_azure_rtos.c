@@ -81,6 +81,7 @@ NX_PACKET *mx_net_buffer_alloc(uint32_t n)
                               NX_NO_WAIT);
   if (status != NX_SUCCESS)
   {
+    nx_driver_emw3080_rx_drops++;
     MX_STAT_LOG();
     return NULL;
   }
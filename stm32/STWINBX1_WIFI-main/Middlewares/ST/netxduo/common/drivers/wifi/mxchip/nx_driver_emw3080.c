@@ -36,15 +36,40 @@
 /* The station mode is the default. */
 uint8_t WifiMode = MC_STATION;
 
+ULONG nx_driver_emw3080_rx_drops = 0;
+ULONG nx_driver_emw3080_tx_gathers = 0;
+ULONG nx_driver_emw3080_rx_frames = 0;
+ULONG nx_driver_emw3080_io_wakeups = 0;
+ULONG nx_driver_emw3080_io_polls = 0;
+ULONG nx_driver_emw3080_io_batch_max = 0;
+
+/* The bare-OS transport has no locking of its own: every call into mx_wifi
+   after the link is up is made with this mutex held, by the I/O thread or by
+   a transmitting thread. Both may deliver received frames. */
+static TX_THREAD nx_driver_io_thread;
+static TX_SEMAPHORE nx_driver_io_wakeup;
+static TX_MUTEX nx_driver_io_mutex;
+static ULONG nx_driver_io_stack[NX_DRIVER_EMW3080_IO_STACK_SIZE / sizeof(ULONG)];
+
+/* Chained frames are copied here. Transmits are serialized by the IP
+   mutex, so one frame is enough. With MX_WIFI_TX_BUFFER_NO_COPY the bypass
+   output writes its IPC header into the MX_WIFI_MIN_TX_HEADER_SIZE bytes in
+   front of the frame. The 2-byte pad after them puts the 14-byte Ethernet
+   header at an offset of 2 mod 4, so the IP header is word aligned, as in
+   a pool packet. */
+#define NX_DRIVER_GATHER_HEADROOM   (MX_WIFI_MIN_TX_HEADER_SIZE + 2)
+static ULONG nx_driver_gather_frame[(NX_DRIVER_GATHER_HEADROOM + NX_DRIVER_MTU + 3) / 4];
+
 static void _nx_netlink_input_callback(mx_buf_t *pbuf, void *user_args);
 static void _nx_mx_wifi_status_changed(uint8_t cate, uint8_t status, void *arg);
+static void _nx_mx_wifi_link_status_event(void);
+static VOID _nx_driver_emw3080_io_thread_entry(ULONG thread_input);
 
 static UINT _nx_driver_emw3080_initialize(NX_IP_DRIVER *driver_req_ptr);
 static UINT _nx_driver_emw3080_enable(NX_IP_DRIVER *driver_req_ptr);
 static UINT _nx_driver_emw3080_disable(NX_IP_DRIVER *driver_req_ptr);
 static UINT _nx_driver_emw3080_packet_send(NX_PACKET *packet_ptr);
 static UINT _nx_driver_emw3080_interface_status(NX_IP_DRIVER *driver_req_ptr);
-static VOID _nx_driver_emw3080_packet_received(VOID);
 
 #if defined(NX_DEBUG)
 static const char *nx_driver_mx_wifi_status_to_string(uint8_t status);
@@ -64,7 +89,6 @@ void nx_driver_emw3080_entry(NX_IP_DRIVER *driver_req_ptr)
     nx_driver_hardware_disable            = _nx_driver_emw3080_disable;
     nx_driver_hardware_packet_send        = _nx_driver_emw3080_packet_send;
     nx_driver_hardware_get_status         = _nx_driver_emw3080_interface_status;
-    nx_driver_hardware_packet_received    = _nx_driver_emw3080_packet_received;
 
     started = true;
   }
@@ -74,22 +98,14 @@ void nx_driver_emw3080_entry(NX_IP_DRIVER *driver_req_ptr)
 
 void nx_driver_emw3080_interrupt(void)
 {
-  ULONG deffered_events;
-
   if ((!nx_driver_interface_up) || (!nx_driver_ip_acquired))
   {
     return; /* not yet running */
   }
 
-  deffered_events = nx_driver_information.nx_driver_information_deferred_events;
-
-  nx_driver_information.nx_driver_information_deferred_events |= NX_DRIVER_DEFERRED_PACKET_RECEIVED;
-
-  if (!deffered_events)
-  {
-    /* Call NetX deferred driver processing.  */
-    _nx_ip_driver_deferred_processing(nx_driver_information.nx_driver_information_ip_ptr);
-  }
+  /* Wake the I/O thread, at most one batch of polls ahead; the IP thread
+     only sees the frames it queues. */
+  tx_semaphore_ceiling_put(&nx_driver_io_wakeup, NX_DRIVER_EMW3080_IO_BATCH);
 }
 
 static UINT _nx_driver_emw3080_initialize(NX_IP_DRIVER *driver_req_ptr)
@@ -124,6 +140,16 @@ static UINT _nx_driver_emw3080_initialize(NX_IP_DRIVER *driver_req_ptr)
     return NX_DRIVER_ERROR;
   }
 
+  if ((tx_semaphore_create(&nx_driver_io_wakeup, "Wi-Fi I/O wakeup", 0) != TX_SUCCESS) ||
+      (tx_mutex_create(&nx_driver_io_mutex, "Wi-Fi I/O", TX_INHERIT) != TX_SUCCESS) ||
+      (tx_thread_create(&nx_driver_io_thread, "Wi-Fi I/O", _nx_driver_emw3080_io_thread_entry, 0,
+                        nx_driver_io_stack, sizeof(nx_driver_io_stack),
+                        NX_DRIVER_EMW3080_IO_PRIORITY, NX_DRIVER_EMW3080_IO_PRIORITY,
+                        TX_NO_TIME_SLICE, TX_AUTO_START) != TX_SUCCESS))
+  {
+    return NX_DRIVER_ERROR;
+  }
+
   return NX_SUCCESS;
 }
 
@@ -203,36 +229,50 @@ UINT _nx_driver_emw3080_enable(NX_IP_DRIVER *driver_req_ptr)
 
 UINT _nx_driver_emw3080_disable(NX_IP_DRIVER *driver_req_ptr)
 {
+  UINT status = NX_SUCCESS;
+
+  tx_mutex_get(&nx_driver_io_mutex, TX_WAIT_FOREVER);
+
   MX_WIFI_Network_bypass_mode_set(wifi_obj_get(), 0 /* disable */, NULL, NULL);
 
   if (MX_WIFI_Disconnect(wifi_obj_get()))
   {
-    return NX_DRIVER_ERROR;
+    status = NX_DRIVER_ERROR;
   }
-
-  if (MX_WIFI_DeInit(wifi_obj_get()))
+  else if (MX_WIFI_DeInit(wifi_obj_get()))
   {
-    return NX_DRIVER_ERROR;
+    status = NX_DRIVER_ERROR;
   }
 
-  return NX_SUCCESS;
+  tx_mutex_put(&nx_driver_io_mutex);
+
+  return status;
 }
 
 
 UINT _nx_driver_emw3080_packet_send(NX_PACKET *packet_ptr)
 {
   static int errors = 0;
+  UCHAR *frame_ptr = packet_ptr->nx_packet_prepend_ptr;
 
-  /* Verify that the length matches the size between the pointers. */
-  if (packet_ptr->nx_packet_length != (packet_ptr->nx_packet_append_ptr - packet_ptr->nx_packet_prepend_ptr))
+  if (packet_ptr->nx_packet_next)
   {
-    return NX_DRIVER_ERROR;
+    /* Zero-copy TCP segments (app_tcp_zerocopy.h): the IPC takes one
+       contiguous frame, so gather the chain. On error the caller removes
+       the header and releases the packet. */
+    ULONG bytes_copied = 0;
+
+    frame_ptr = (UCHAR *)nx_driver_gather_frame + NX_DRIVER_GATHER_HEADROOM;
+    if ((nx_packet_data_extract_offset(packet_ptr, 0, frame_ptr, NX_DRIVER_MTU, &bytes_copied) != NX_SUCCESS) ||
+        (bytes_copied != packet_ptr->nx_packet_length))
+    {
+      return NX_DRIVER_ERROR;
+    }
+    nx_driver_emw3080_tx_gathers++;
   }
-
-  if (packet_ptr->nx_packet_next)
+  /* Verify that the length matches the size between the pointers. */
+  else if (packet_ptr->nx_packet_length != (packet_ptr->nx_packet_append_ptr - packet_ptr->nx_packet_prepend_ptr))
   {
-    NX_DRIVER_PHYSICAL_HEADER_REMOVE(packet_ptr);
-    nx_packet_transmit_release(packet_ptr);
     return NX_DRIVER_ERROR;
   }
 
@@ -247,12 +287,14 @@ UINT _nx_driver_emw3080_packet_send(NX_PACKET *packet_ptr)
   {
     int32_t interface = (WifiMode == MC_STATION) ? STATION_IDX : SOFTAP_IDX;
 
+    tx_mutex_get(&nx_driver_io_mutex, TX_WAIT_FOREVER);
     if (MX_WIFI_Network_bypass_netlink_output(wifi_obj_get(),
-                                              packet_ptr->nx_packet_prepend_ptr, packet_ptr->nx_packet_length,
+                                              frame_ptr, packet_ptr->nx_packet_length,
                                               interface))
     {
       errors++;
     }
+    tx_mutex_put(&nx_driver_io_mutex);
   }
 
   NX_DRIVER_PHYSICAL_HEADER_REMOVE(packet_ptr);
@@ -269,18 +311,60 @@ static void _nx_netlink_input_callback(mx_buf_t *buffer, void *user_args)
   /* Avoid starving. */
   if (packet_ptr -> nx_packet_pool_owner -> nx_packet_pool_available == 0)
   {
+    nx_driver_emw3080_rx_drops++;
     nx_packet_release(packet_ptr);
     return;
   }
 
   /* Everything is OK, transfer the packet to NetX. */
+  nx_driver_emw3080_rx_frames++;
   nx_driver_transfer_to_netx(nx_driver_information.nx_driver_information_ip_ptr, packet_ptr);
 }
 
 
-static VOID _nx_driver_emw3080_packet_received(VOID)
+static VOID _nx_driver_emw3080_io_thread_entry(ULONG thread_input)
 {
-  MX_WIFI_IO_YIELD(wifi_obj_get(), 100 /* timeout */);
+  (void)thread_input;
+
+  for (;;)
+  {
+    ULONG polls = 0;
+    ULONG start;
+    ULONG spent;
+
+    tx_semaphore_get(&nx_driver_io_wakeup, TX_WAIT_FOREVER);
+    nx_driver_emw3080_io_wakeups++;
+
+    /* One poll per notification; those raised meanwhile are served under the
+       same lock, up to the batch and the spin budget, so the frames reach the
+       IP thread together. A poll never waits past what is left of the budget. */
+    tx_mutex_get(&nx_driver_io_mutex, TX_WAIT_FOREVER);
+    start = tx_time_get();
+    spent = 0;
+    do
+    {
+      ULONG timeout = NX_DRIVER_EMW3080_IO_BUDGET_MS - spent;
+
+      if (timeout > NX_DRIVER_EMW3080_IO_TIMEOUT_MS)
+      {
+        timeout = NX_DRIVER_EMW3080_IO_TIMEOUT_MS;
+      }
+      MX_WIFI_IO_YIELD(wifi_obj_get(), timeout);
+      polls++;
+      spent = (tx_time_get() - start) * 1000U / TX_TIMER_TICKS_PER_SECOND;
+    } while ((polls < NX_DRIVER_EMW3080_IO_BATCH) && (spent < NX_DRIVER_EMW3080_IO_BUDGET_MS) &&
+             (tx_semaphore_get(&nx_driver_io_wakeup, TX_NO_WAIT) == TX_SUCCESS));
+    tx_mutex_put(&nx_driver_io_mutex);
+
+    nx_driver_emw3080_io_polls += polls;
+    if (polls > nx_driver_emw3080_io_batch_max)
+    {
+      nx_driver_emw3080_io_batch_max = polls;
+    }
+
+    /* Ready threads of the same level run before the next wakeup. */
+    tx_thread_relinquish();
+  }
 }
 
 
@@ -311,10 +395,12 @@ static void _nx_mx_wifi_status_changed(uint8_t cate, uint8_t status, void *arg)
     {
       case MWIFI_EVENT_STA_DOWN:
         nx_driver_interface_up = false;
+        _nx_mx_wifi_link_status_event();
         break;
 
       case MWIFI_EVENT_STA_UP:
         nx_driver_interface_up = true;
+        _nx_mx_wifi_link_status_event();
         break;
 
       case MWIFI_EVENT_STA_GOT_IP:
@@ -331,10 +417,12 @@ static void _nx_mx_wifi_status_changed(uint8_t cate, uint8_t status, void *arg)
     {
       case MWIFI_EVENT_AP_DOWN:
         nx_driver_interface_up = false;
+        _nx_mx_wifi_link_status_event();
         break;
 
       case MWIFI_EVENT_AP_UP:
         nx_driver_interface_up = true;
+        _nx_mx_wifi_link_status_event();
         break;
 
       default:
@@ -348,6 +436,20 @@ static void _nx_mx_wifi_status_changed(uint8_t cate, uint8_t status, void *arg)
 }
 
 
+/* Have the IP thread query NX_LINK_GET_STATUS and run the link status change notify. */
+static void _nx_mx_wifi_link_status_event(void)
+{
+  NX_IP *ip_ptr = nx_driver_information.nx_driver_information_ip_ptr;
+  NX_INTERFACE *interface_ptr = nx_driver_information.nx_driver_information_interface;
+
+  /* Events before the driver is attached to an IP instance are picked up by NX_LINK_ENABLE. */
+  if ((ip_ptr != NX_NULL) && (interface_ptr != NX_NULL))
+  {
+    _nx_ip_driver_link_status_event(ip_ptr, interface_ptr -> nx_interface_index);
+  }
+}
+
+
 #if defined(NX_DEBUG)
 #define CASE(x) case x: return #x
 #define DEFAULT default: return "UNKNOWN"
@@ -39,6 +39,49 @@ void nx_driver_emw3080_interrupt(void);
 
 extern uint8_t WifiMode;
 
+/* Received frames dropped for lack of a packet (pool empty or last packet). */
+extern ULONG nx_driver_emw3080_rx_drops;
+
+/* Chained frames copied into one contiguous frame for the IPC. */
+extern ULONG nx_driver_emw3080_tx_gathers;
+
+/* The Wi-Fi I/O thread polls the SPI link when the module raises its notify or
+   flow line, and queues the received frames for the IP thread. It runs above
+   the IP thread so that a burst reaches the IP thread as one batch. The level
+   is shared with the 128 ms pipeline threads (rt_sched.h); the thread yields
+   to them after each wakeup, so they wait for one wakeup at most. */
+#ifndef NX_DRIVER_EMW3080_IO_PRIORITY
+#define NX_DRIVER_EMW3080_IO_PRIORITY     4
+#endif /* NX_DRIVER_EMW3080_IO_PRIORITY */
+
+#ifndef NX_DRIVER_EMW3080_IO_STACK_SIZE
+#define NX_DRIVER_EMW3080_IO_STACK_SIZE   2048
+#endif /* NX_DRIVER_EMW3080_IO_STACK_SIZE */
+
+/* Longest wait for the module in one poll (ms). The bare-OS transport spins
+   while it waits, so this bounds how long the thread keeps lower priorities out
+   after a spurious wakeup. */
+#ifndef NX_DRIVER_EMW3080_IO_TIMEOUT_MS
+#define NX_DRIVER_EMW3080_IO_TIMEOUT_MS   10
+#endif /* NX_DRIVER_EMW3080_IO_TIMEOUT_MS */
+
+/* Most polls per wakeup before the link is handed back to transmitters. */
+#ifndef NX_DRIVER_EMW3080_IO_BATCH
+#define NX_DRIVER_EMW3080_IO_BATCH        8
+#endif /* NX_DRIVER_EMW3080_IO_BATCH */
+
+/* Longest the thread spins in one wakeup, all polls together (ms, to the tick).
+   Notifications left over are served after the threads of the same level. */
+#ifndef NX_DRIVER_EMW3080_IO_BUDGET_MS
+#define NX_DRIVER_EMW3080_IO_BUDGET_MS    10
+#endif /* NX_DRIVER_EMW3080_IO_BUDGET_MS */
+
+/* Frames received, I/O thread wakeups and polls, and the most polls in one wakeup. */
+extern ULONG nx_driver_emw3080_rx_frames;
+extern ULONG nx_driver_emw3080_io_wakeups;
+extern ULONG nx_driver_emw3080_io_polls;
+extern ULONG nx_driver_emw3080_io_batch_max;
+
 #ifdef   __cplusplus
 }
 #endif /* __cplusplus */
@@ -1184,16 +1184,79 @@ typedef struct NX_IPV6_DEFAULT_ROUTER_ENTRY_STRUCT
 /* Define the constants that determine how big the hash table is for UDP ports.  The
    value must be a power of two, so subtracting one gives us the mask.  */
 
+#ifndef NX_UDP_PORT_TABLE_SIZE
 #define NX_UDP_PORT_TABLE_SIZE                     32
+#endif /* NX_UDP_PORT_TABLE_SIZE */
 #define NX_UDP_PORT_TABLE_MASK                     (NX_UDP_PORT_TABLE_SIZE - 1)
 
+#if (NX_UDP_PORT_TABLE_SIZE & NX_UDP_PORT_TABLE_MASK) != 0
+#error "NX_UDP_PORT_TABLE_SIZE must be a power of two."
+#endif
+
 
 /* Define the constants that determine how big the hash table is for TCP ports.  The
    value must be a power of two, so subtracting one gives us the mask.  */
 
+#ifndef NX_TCP_PORT_TABLE_SIZE
 #define NX_TCP_PORT_TABLE_SIZE                     32
+#endif /* NX_TCP_PORT_TABLE_SIZE */
 #define NX_TCP_PORT_TABLE_MASK                     (NX_TCP_PORT_TABLE_SIZE - 1)
 
+#if (NX_TCP_PORT_TABLE_SIZE & NX_TCP_PORT_TABLE_MASK) != 0
+#error "NX_TCP_PORT_TABLE_SIZE must be a power of two."
+#endif
+
+
+/* Define the hash of a port into its table index.  The multiplicative hash takes
+   the index from the middle bits of the product, so ports that differ only by a
+   multiple of the table size (8000, 8032, ...) no longer share a bucket.  */
+
+#define NX_PORT_HASH_MULTIPLIER                    ((ULONG)0x9E3779B1)
+#define NX_UDP_PORT_HASH(p)                        ((UINT)(((ULONG)(p) * NX_PORT_HASH_MULTIPLIER) >> NX_SHIFT_BY_16) & NX_UDP_PORT_TABLE_MASK)
+#define NX_TCP_PORT_HASH(p)                        ((UINT)(((ULONG)(p) * NX_PORT_HASH_MULTIPLIER) >> NX_SHIFT_BY_16) & NX_TCP_PORT_TABLE_MASK)
+
+
+/* Define the size of the TCP connection cache.  Connected sockets share the port
+   table bucket of their local port (all HTTP sessions hash to port 80), so the last
+   socket hit for each hashed 4-tuple is remembered and checked before the bucket
+   is searched.  The value must be a power of two; 0 disables the cache.  */
+
+#ifndef NX_TCP_CONNECTION_CACHE_SIZE
+#define NX_TCP_CONNECTION_CACHE_SIZE               16
+#endif /* NX_TCP_CONNECTION_CACHE_SIZE */
+
+#if NX_TCP_CONNECTION_CACHE_SIZE > 0
+#define NX_TCP_CONNECTION_CACHE_MASK               (NX_TCP_CONNECTION_CACHE_SIZE - 1)
+
+#if (NX_TCP_CONNECTION_CACHE_SIZE & NX_TCP_CONNECTION_CACHE_MASK) != 0
+#error "NX_TCP_CONNECTION_CACHE_SIZE must be a power of two."
+#endif
+
+/* The source address word is the IPv4 address, or the last word of the IPv6 address.  */
+#define NX_TCP_CONNECTION_HASH(source_word, source_port, port) \
+    ((UINT)((((ULONG)(source_word) ^ (((ULONG)(source_port) << NX_SHIFT_BY_16) | (ULONG)(port))) * NX_PORT_HASH_MULTIPLIER) >> NX_SHIFT_BY_16) & NX_TCP_CONNECTION_CACHE_MASK)
+#endif /* NX_TCP_CONNECTION_CACHE_SIZE > 0 */
+
+
+/* Define the deferred receive batch.  The IP thread takes at most this many packets
+   off the deferred receive queue per pass of its event loop, so a burst does not
+   hold up the timer and TCP events behind it; the rest are taken on the next pass.
+   0 empties the queue in one pass.  Defining NX_IP_RECEIVE_BATCH_CYCLES also ends
+   a batch once that many cycles of NX_IP_CYCLE_COUNT_GET() have passed.  */
+
+#ifndef NX_IP_RECEIVE_BATCH_MAX
+#define NX_IP_RECEIVE_BATCH_MAX                    0
+#endif /* NX_IP_RECEIVE_BATCH_MAX */
+
+#if defined(NX_IP_RECEIVE_BATCH_CYCLES) && !defined(NX_IP_CYCLE_COUNT_GET)
+#error "NX_IP_RECEIVE_BATCH_CYCLES requires NX_IP_CYCLE_COUNT_GET."
+#endif
+
+/* Define the number of batch size buckets kept with NX_ENABLE_IP_THREAD_INFO:
+   1, 2-3, 4-7, 8-15, 16-31 and 32 or more packets.  */
+
+#define NX_IP_RECEIVE_BATCH_BUCKETS                6
+
 
 /* Define the maximum number of multicast groups the system can support.  This might
    be further limited by the underlying physical hardware.  */
@@ -1487,8 +1550,27 @@ struct NX_PACKET_POOL_STRUCT;
         else                            \
             (p) -> nx_packet_debug_thread = "ISR";                            \
                                 }
+
+/* Define the return address taken as the allocation site.  */
+#ifndef NX_PACKET_DEBUG_CALLER
+#ifdef __GNUC__
+#define NX_PACKET_DEBUG_CALLER()    __builtin_return_address(0)
+#else
+#define NX_PACKET_DEBUG_CALLER()    NX_NULL
+#endif /* __GNUC__ */
+#endif /* NX_PACKET_DEBUG_CALLER */
+
+/* Define macro to record the owner, site and tick of a packet allocation, after
+   NX_PACKET_DEBUG has recorded the allocating thread. Allocations outside any
+   thread share one owner string, so an owner is identified by its address.  */
+#define NX_PACKET_DEBUG_ALLOCATE(p, s)  {\
+        (p) -> nx_packet_debug_alloc_thread = tx_thread_identify() ? (p) -> nx_packet_debug_thread : _nx_packet_debug_isr_owner;\
+        (p) -> nx_packet_debug_alloc_site = (s);\
+        (p) -> nx_packet_debug_alloc_time = tx_time_get();\
+                                }
 #else
 #define NX_PACKET_DEBUG(f, l, p)
+#define NX_PACKET_DEBUG_ALLOCATE(p, s)
 #endif /* NX_ENABLE_PACKET_DEBUG_INFO */
 
 typedef  struct NX_PACKET_STRUCT
@@ -1642,6 +1724,12 @@ typedef  struct NX_PACKET_STRUCT
 
     /* Indicate the current function that is processing the packet. */
     ULONG       nx_packet_debug_line;
+
+    /* Indicate the thread that allocated the packet, the code that called the
+       allocate service and the tick of the allocation.  */
+    CHAR       *nx_packet_debug_alloc_thread;
+    VOID       *nx_packet_debug_alloc_site;
+    ULONG       nx_packet_debug_alloc_time;
 #endif /* NX_ENABLE_PACKET_DEBUG_INFO */
 
 #ifdef NX_PACKET_HEADER_PAD
@@ -2021,6 +2109,27 @@ typedef struct NX_TCP_SOCKET_STRUCT
     ULONG       nx_tcp_socket_timeout_max_retries;
     ULONG       nx_tcp_socket_timeout_shift;
 
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+    /* Define the round trip time estimation (RFC 6298). One data segment at a time
+       is timed, from its first transmission to the ACK that covers it; a
+       retransmission cancels the measurement (Karn's algorithm). The smoothed RTT
+       is kept scaled by 8 and the variation by 4, both in timer ticks. The
+       timeout rate above is the RTO derived from them, and is restored to the
+       initial value when the connection is cleaned up.  */
+    ULONG       nx_tcp_socket_rtt_timing;
+    ULONG       nx_tcp_socket_rtt_sequence;
+    ULONG       nx_tcp_socket_rtt_time;
+    ULONG       nx_tcp_socket_rtt_srtt;
+    ULONG       nx_tcp_socket_rtt_rttvar;
+    ULONG       nx_tcp_socket_rtt_samples;
+    ULONG       nx_tcp_socket_timeout_initial;
+
+    /* Define the retransmission counters, kept with NX_DISABLE_TCP_INFO too.  */
+    ULONG       nx_tcp_socket_retransmit_timeouts;
+    ULONG       nx_tcp_socket_retransmit_fast;
+    ULONG       nx_tcp_socket_retransmit_partial;
+#endif /* NX_TCP_ENABLE_RTT_ESTIMATION */
+
 #ifdef NX_ENABLE_TCP_WINDOW_SCALING
     /* Local receive window size, when user creates the TCP socket. */
     ULONG       nx_tcp_socket_rx_window_maximum;
@@ -2614,6 +2723,20 @@ typedef struct NX_IP_STRUCT
     NX_PACKET   *nx_ip_deferred_received_packet_head,
                 *nx_ip_deferred_received_packet_tail;
 
+#ifdef NX_ENABLE_IP_THREAD_INFO
+    /* Define the deferred receive batch statistics: batches by size bucket, the
+       largest batch, and batches ended by the limit or the cycle budget with
+       packets still queued.  */
+    ULONG       nx_ip_receive_batch_count[NX_IP_RECEIVE_BATCH_BUCKETS];
+    ULONG       nx_ip_receive_batch_max;
+    ULONG       nx_ip_receive_batch_cut;
+
+    /* Define the cycles the IP thread has spent processing events, as a 64-bit
+       count split in two words.  Only kept with NX_IP_CYCLE_COUNT_GET.  */
+    ULONG       nx_ip_thread_busy_cycles;
+    ULONG       nx_ip_thread_busy_cycles_upper;
+#endif /* NX_ENABLE_IP_THREAD_INFO */
+
     /* Define the raw IP function pointer that also indicates whether or
        not raw IP packet sending and receiving is enabled.  */
     UINT        (*nx_ip_raw_ip_processing)(struct NX_IP_STRUCT *, ULONG, NX_PACKET *);
@@ -2804,6 +2927,12 @@ typedef struct NX_IP_STRUCT
     struct NX_TCP_SOCKET_STRUCT
                 *nx_ip_tcp_port_table[NX_TCP_PORT_TABLE_SIZE];
 
+#if NX_TCP_CONNECTION_CACHE_SIZE > 0
+    /* Define the last socket hit for each hashed connection 4-tuple.  */
+    struct NX_TCP_SOCKET_STRUCT
+                *nx_ip_tcp_connection_cache[NX_TCP_CONNECTION_CACHE_SIZE];
+#endif /* NX_TCP_CONNECTION_CACHE_SIZE > 0 */
+
     /* Define the head pointer of the created TCP socket list.  */
     struct NX_TCP_SOCKET_STRUCT
                 *nx_ip_tcp_created_sockets_ptr;
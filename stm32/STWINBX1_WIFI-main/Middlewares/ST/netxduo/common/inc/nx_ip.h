@@ -110,6 +110,9 @@
 UINT   _nx_ip_auxiliary_packet_pool_set(NX_IP *ip_ptr, NX_PACKET_POOL *auxiliary_pool);
 USHORT _nx_ip_checksum_compute(NX_PACKET *packet_ptr, ULONG protocol, UINT data_length,
                                ULONG *_src_ip_addr, ULONG *_dest_ip_addr);
+ULONG  _nx_ip_checksum_partial(const UCHAR *data, UINT length, ULONG checksum);
+ULONG  _nx_ip_checksum_copy_partial(UCHAR *destination, const UCHAR *source,
+                                    UINT length, ULONG checksum);
 UINT   _nx_ip_interface_address_mapping_configure(NX_IP *ip_ptr, UINT interface_index, UINT mapping_needed);
 UINT   _nx_ip_interface_capability_get(NX_IP *ip_ptr, UINT interface_index, ULONG *interface_capability_flag);
 UINT   _nx_ip_interface_capability_set(NX_IP *ip_ptr, UINT interface_index, ULONG interface_capability_flag);
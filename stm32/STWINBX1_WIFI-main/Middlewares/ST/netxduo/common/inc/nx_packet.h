@@ -165,5 +165,19 @@ PACKET_POOL_DECLARE  NX_PACKET_POOL     *_nx_packet_pool_created_ptr;
 PACKET_POOL_DECLARE  ULONG _nx_packet_pool_created_count;
 
 
+#ifdef NX_ENABLE_PACKET_DEBUG_INFO
+/* Define the routine called with each packet going back to its pool, before the
+   packet is reused, so the time it was held can be measured.  It is called from
+   threads and ISRs alike.  */
+
+PACKET_POOL_DECLARE  VOID (*_nx_packet_debug_release_notify)(NX_PACKET *packet_ptr);
+
+
+/* Define the owner recorded for packets allocated outside any thread.  */
+
+PACKET_POOL_DECLARE  CHAR *_nx_packet_debug_isr_owner;
+#endif /* NX_ENABLE_PACKET_DEBUG_INFO */
+
+
 #endif
 
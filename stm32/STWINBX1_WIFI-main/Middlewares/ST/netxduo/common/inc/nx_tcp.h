@@ -132,6 +132,39 @@
                                                     /*   of 1 causes each successive */
                                                     /*   be multiplied by two, etc.  */
 
+/* Define the bounds of the retransmission timeout measured from the round
+   trip time (RFC 6298), in timer ticks. Only used when the TCP source is
+   compiled with NX_TCP_ENABLE_RTT_ESTIMATION defined. The lower bound is
+   below the 1 second of RFC 6298, as most stacks on fast links use, and
+   still above the 100ms fast timer granularity.  */
+
+#ifndef NX_TCP_RTO_MIN
+#define NX_TCP_RTO_MIN                  (NX_IP_PERIODIC_RATE / 5)
+#endif
+
+#ifndef NX_TCP_RTO_MAX
+#define NX_TCP_RTO_MAX                  (NX_IP_PERIODIC_RATE * 8)
+#endif
+
+/* Define the timeout of the next retry: the timeout rate shifted once per
+   retry, capped at NX_TCP_RTO_MAX with RTT estimation.  */
+
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+#define NX_TCP_RETRY_TIMEOUT(s)                                                                             \
+    ((((s) -> nx_tcp_socket_timeout_rate << ((s) -> nx_tcp_socket_timeout_retries * (s) -> nx_tcp_socket_timeout_shift)) > NX_TCP_RTO_MAX) ? \
+     (ULONG)NX_TCP_RTO_MAX : ((s) -> nx_tcp_socket_timeout_rate << ((s) -> nx_tcp_socket_timeout_retries * (s) -> nx_tcp_socket_timeout_shift)))
+#else
+#define NX_TCP_RETRY_TIMEOUT(s)                                                                             \
+    ((s) -> nx_tcp_socket_timeout_rate << ((s) -> nx_tcp_socket_timeout_retries * (s) -> nx_tcp_socket_timeout_shift))
+#endif
+
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+/* Define the _nx_tcp_socket_retransmit mode for a partial ACK: the next unacknowledged
+   segment is resent at once, without another window reduction or timeout back off.  */
+
+#define NX_TCP_RETRANSMIT_PARTIAL       2
+#endif /* NX_TCP_ENABLE_RTT_ESTIMATION */
+
 #ifndef NX_TCP_MAXIMUM_SEGMENT_LIFETIME
 #define NX_TCP_MAXIMUM_SEGMENT_LIFETIME 120         /* Number of seconds for maximum */
 #endif                                              /* segment lifetime, the         */
@@ -301,6 +334,9 @@ VOID _nx_tcp_client_bind_cleanup(TX_THREAD *thread_ptr NX_CLEANUP_PARAMETER);
 VOID _nx_tcp_deferred_cleanup_check(NX_IP *ip_ptr);
 VOID _nx_tcp_fast_periodic_processing(NX_IP *ip_ptr);
 VOID _nx_tcp_socket_retransmit(NX_IP *ip_ptr, NX_TCP_SOCKET *socket_ptr, UINT need_fast_retransmit);
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+VOID _nx_tcp_socket_rtt_update(NX_TCP_SOCKET *socket_ptr, ULONG rtt);
+#endif /* NX_TCP_ENABLE_RTT_ESTIMATION */
 VOID _nx_tcp_connect_cleanup(TX_THREAD *thread_ptr NX_CLEANUP_PARAMETER);
 VOID _nx_tcp_disconnect_cleanup(TX_THREAD *thread_ptr NX_CLEANUP_PARAMETER);
 VOID _nx_tcp_initialize(VOID);
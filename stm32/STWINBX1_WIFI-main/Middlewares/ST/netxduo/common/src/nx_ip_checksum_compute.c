@@ -62,7 +62,7 @@
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    None                                                                */
+/*    _nx_ip_checksum_partial               Sum of the payload words      */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -75,6 +75,8 @@
 /*  05-19-2020     Yuxin Zhou               Initial Version 6.0           */
 /*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
 /*                                            resulting in version 6.1    */
+/*  10-18-2026     Wind Turbine Team        Unrolled 64-bit word sum,     */
+/*                                            _nx_ip_checksum_partial     */
 /*                                                                        */
 /**************************************************************************/
 USHORT  _nx_ip_checksum_compute(NX_PACKET *packet_ptr, ULONG protocol,
@@ -91,6 +93,7 @@ ULONG      packet_size;
 #endif /* NX_DISABLE_PACKET_CHAIN */
 NX_PACKET *current_packet;
 ALIGN_TYPE end_ptr;
+UINT       words;
 #ifdef FEATURE_NX_IPV6
 UINT       i;
 #endif
@@ -200,14 +203,12 @@ UINT       i;
             /*lint -e{923} suppress cast of pointer to ULONG.  */
             data_length -= (UINT)(((end_ptr + 3) & (ALIGN_TYPE)(~3llu)) - (ALIGN_TYPE)long_ptr);
 
-            /* Loop to calculate the packet's checksum.  */
-            /*lint -e{946} suppress pointer subtraction, since it is necessary. */
-            while ((ALIGN_TYPE)long_ptr < end_ptr)
-            {
-                checksum += (*long_ptr & NX_LOWER_16_MASK);
-                checksum += (*long_ptr >> NX_SHIFT_BY_16);
-                long_ptr++;
-            }
+            /* Sum the whole words up to end_ptr, eight at a time.  */
+            /*lint -e{923} suppress cast of pointer to ULONG.  */
+            words = (UINT)((end_ptr - (ALIGN_TYPE)long_ptr + 3) >> 2);
+            /*lint -e{927} -e{826} suppress cast of pointer to pointer, since it is necessary  */
+            checksum += _nx_ip_checksum_partial((UCHAR *)long_ptr, words << 2, 0);
+            long_ptr += words;
         }
 #ifndef NX_DISABLE_PACKET_CHAIN
 
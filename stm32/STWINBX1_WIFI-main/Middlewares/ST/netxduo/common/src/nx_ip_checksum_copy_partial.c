@@ -0,0 +1,129 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Internet Protocol Checksum Computation                              */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_ip.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_ip_checksum_copy_partial                      PORTABLE C        */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Wind Turbine Team                                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function copies a buffer and adds it to a running one's        */
+/*    complement sum in the same pass, so a payload copied into a packet  */
+/*    does not have to be read a second time for its checksum. The sum   */
+/*    is the one _nx_ip_checksum_partial returns for the copied data.     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    destination                           Copy target, any alignment    */
+/*    source                                Copy source, any alignment    */
+/*    length                                Bytes to copy                 */
+/*    checksum                              Running sum, 0 to start       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    running sum folded to 16 bits, not complemented, host word order    */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    memcpy                                Unaligned word access         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-18-2026     Wind Turbine Team        Initial Version 6.1           */
+/*                                                                        */
+/**************************************************************************/
+ULONG  _nx_ip_checksum_copy_partial(UCHAR *destination, const UCHAR *source,
+                                    UINT length, ULONG checksum)
+{
+
+ULONG64 sum = checksum;
+ULONG   word[8];
+ULONG   tail = 0;
+
+    /* Eight words per iteration. memcpy of a constant size compiles to plain
+       loads and stores on cores with unaligned access.  */
+    while (length >= 32)
+    {
+        memcpy(word, source, 32); /* Use case of memcpy is verified. */
+        memcpy(destination, word, 32); /* Use case of memcpy is verified. */
+        sum += word[0];
+        sum += word[1];
+        sum += word[2];
+        sum += word[3];
+        sum += word[4];
+        sum += word[5];
+        sum += word[6];
+        sum += word[7];
+        source += 32;
+        destination += 32;
+        length -= 32;
+    }
+
+    /* Remaining whole words.  */
+    while (length >= 4)
+    {
+        memcpy(word, source, 4); /* Use case of memcpy is verified. */
+        memcpy(destination, word, 4); /* Use case of memcpy is verified. */
+        sum += word[0];
+        source += 4;
+        destination += 4;
+        length -= 4;
+    }
+
+    /* The last 1 to 3 bytes, zero padded in memory order.  */
+    if (length)
+    {
+        memcpy(&tail, source, length); /* Use case of memcpy is verified. */
+        memcpy(destination, source, length); /* Use case of memcpy is verified. */
+        sum += tail;
+    }
+
+    /* Fold the carries back: 64 to 32 bits, then 32 to 16 bits.  */
+    sum = (sum & 0xFFFFFFFFULL) + (sum >> 32);
+    sum = (sum & 0xFFFFFFFFULL) + (sum >> 32);
+    sum = (sum & NX_LOWER_16_MASK) + (sum >> NX_SHIFT_BY_16);
+    sum = (sum & NX_LOWER_16_MASK) + (sum >> NX_SHIFT_BY_16);
+
+    return((ULONG)sum);
+}
+
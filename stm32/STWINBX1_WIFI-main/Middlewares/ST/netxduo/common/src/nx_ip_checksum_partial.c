@@ -0,0 +1,130 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Internet Protocol Checksum Computation                              */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_ip.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_ip_checksum_partial                           PORTABLE C        */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Wind Turbine Team                                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function adds a buffer to a running one's complement sum. The  */
+/*    buffer is read as 16-bit words in memory order, as the packet       */
+/*    checksum is, so it must start at an even offset of the checksummed  */
+/*    data. An odd last byte is padded with zero.                         */
+/*                                                                        */
+/*    Eight 32-bit words are summed per iteration into a 64-bit           */
+/*    accumulator. The upper half collects the carries, so the sum needs  */
+/*    no masking per word; on 32-bit cores the compiler turns the adds    */
+/*    into an add-with-carry chain.                                       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    data                                  Pointer to the buffer, any    */
+/*                                            alignment                   */
+/*    length                                Size of the buffer            */
+/*    checksum                              Running sum, 0 to start       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    running sum folded to 16 bits, not complemented, host word order    */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    memcpy                                Load words at any alignment   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_ip_checksum_compute               Packet checksum               */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-18-2026     Wind Turbine Team        Initial Version 6.1           */
+/*                                                                        */
+/**************************************************************************/
+ULONG  _nx_ip_checksum_partial(const UCHAR *data, UINT length, ULONG checksum)
+{
+
+ULONG64 sum = checksum;
+ULONG   word[8];
+ULONG   tail = 0;
+
+    /* Eight words per iteration. The words are loaded through memcpy, since
+       packet data can start at any offset; memcpy of a constant size compiles
+       to plain loads on cores with unaligned access.  */
+    while (length >= 32)
+    {
+        memcpy(word, data, 32); /* Use case of memcpy is verified. */
+        sum += word[0];
+        sum += word[1];
+        sum += word[2];
+        sum += word[3];
+        sum += word[4];
+        sum += word[5];
+        sum += word[6];
+        sum += word[7];
+        data += 32;
+        length -= 32;
+    }
+
+    /* Remaining whole words.  */
+    while (length >= 4)
+    {
+        memcpy(word, data, 4); /* Use case of memcpy is verified. */
+        sum += word[0];
+        data += 4;
+        length -= 4;
+    }
+
+    /* The last 1 to 3 bytes, zero padded in memory order.  */
+    if (length)
+    {
+        memcpy(&tail, data, length); /* Use case of memcpy is verified. */
+        sum += tail;
+    }
+
+    /* Fold the carries back: 64 to 32 bits, then 32 to 16 bits.  */
+    sum = (sum & 0xFFFFFFFFULL) + (sum >> 32);
+    sum = (sum & 0xFFFFFFFFULL) + (sum >> 32);
+    sum = (sum & NX_LOWER_16_MASK) + (sum >> NX_SHIFT_BY_16);
+    sum = (sum & NX_LOWER_16_MASK) + (sum >> NX_SHIFT_BY_16);
+
+    return((ULONG)sum);
+}
+
@@ -131,6 +131,14 @@ NX_PACKET        *packet_ptr;
 UINT              i;
 UINT              index;
 ULONG             foo;
+UINT              batch_count;
+#ifdef NX_IP_RECEIVE_BATCH_CYCLES
+ULONG             batch_start;
+#endif /* NX_IP_RECEIVE_BATCH_CYCLES */
+#if defined(NX_ENABLE_IP_THREAD_INFO) && defined(NX_IP_CYCLE_COUNT_GET)
+ULONG             busy_start;
+ULONG             busy_cycles;
+#endif /* NX_ENABLE_IP_THREAD_INFO && NX_IP_CYCLE_COUNT_GET */
 #ifdef FEATURE_NX_IPV6
 NXD_IPV6_ADDRESS *interface_ipv6_address;
 #endif /* FEATURE_NX_IPV6 */
@@ -236,10 +244,25 @@ NXD_IPV6_ADDRESS *interface_ipv6_address;
         }
     }
 
+#if defined(NX_ENABLE_IP_THREAD_INFO) && defined(NX_IP_CYCLE_COUNT_GET)
+    /* Busy time starts with the event loop, not with the driver bring-up.  */
+    busy_start =  NX_IP_CYCLE_COUNT_GET();
+#endif /* NX_ENABLE_IP_THREAD_INFO && NX_IP_CYCLE_COUNT_GET */
+
     /* Loop to process events for this IP instance.  */
     for (;;)
     {
 
+#if defined(NX_ENABLE_IP_THREAD_INFO) && defined(NX_IP_CYCLE_COUNT_GET)
+        /* Add the cycles since the events were picked up, preemption included.  */
+        busy_cycles =  NX_IP_CYCLE_COUNT_GET() - busy_start;
+        ip_ptr -> nx_ip_thread_busy_cycles += busy_cycles;
+        if (ip_ptr -> nx_ip_thread_busy_cycles < busy_cycles)
+        {
+            ip_ptr -> nx_ip_thread_busy_cycles_upper++;
+        }
+#endif /* NX_ENABLE_IP_THREAD_INFO && NX_IP_CYCLE_COUNT_GET */
+
         /* Release the IP internal mutex.  */
         tx_mutex_put(&(ip_ptr -> nx_ip_protection));
 
@@ -249,6 +272,10 @@ NXD_IPV6_ADDRESS *interface_ipv6_address;
         /* Obtain the IP internal mutex before processing the IP event.  */
         tx_mutex_get(&(ip_ptr -> nx_ip_protection), TX_WAIT_FOREVER);
 
+#if defined(NX_ENABLE_IP_THREAD_INFO) && defined(NX_IP_CYCLE_COUNT_GET)
+        busy_start =  NX_IP_CYCLE_COUNT_GET();
+#endif /* NX_ENABLE_IP_THREAD_INFO && NX_IP_CYCLE_COUNT_GET */
+
 #ifdef NX_DRIVER_DEFERRED_PROCESSING
         /* Check for any packets deferred by the Driver.  */
         /*lint -e{644} suppress variable might not be initialized, since "ip_events" was initialized in tx_event_flags_get. */
@@ -305,7 +332,13 @@ NXD_IPV6_ADDRESS *interface_ipv6_address;
         if (ip_events & NX_IP_RECEIVE_EVENT)
         {
 
-            /* Loop to process all deferred packet requests.  */
+            /* Start a new batch.  */
+            batch_count =  0;
+#ifdef NX_IP_RECEIVE_BATCH_CYCLES
+            batch_start =  NX_IP_CYCLE_COUNT_GET();
+#endif /* NX_IP_RECEIVE_BATCH_CYCLES */
+
+            /* Loop to process the deferred packet requests of this batch.  */
             while (ip_ptr -> nx_ip_deferred_received_packet_head)
             {
 
@@ -333,7 +366,45 @@ NXD_IPV6_ADDRESS *interface_ipv6_address;
 
                 /* Call the actual IP packet receive function.  */
                 _nx_ip_packet_receive(ip_ptr, packet_ptr);
+                batch_count++;
+
+                /* Determine if the batch is over.  */
+                if (((NX_IP_RECEIVE_BATCH_MAX > 0) && (batch_count >= (UINT)NX_IP_RECEIVE_BATCH_MAX))
+#ifdef NX_IP_RECEIVE_BATCH_CYCLES
+                    || ((ULONG)(NX_IP_CYCLE_COUNT_GET() - batch_start) >= (ULONG)(NX_IP_RECEIVE_BATCH_CYCLES))
+#endif /* NX_IP_RECEIVE_BATCH_CYCLES */
+                   )
+                {
+
+                    /* Yes, leave any remaining packets for the next pass, after the other events.  */
+                    if (ip_ptr -> nx_ip_deferred_received_packet_head)
+                    {
+                        tx_event_flags_set(&(ip_ptr -> nx_ip_events), NX_IP_RECEIVE_EVENT, TX_OR);
+#ifdef NX_ENABLE_IP_THREAD_INFO
+                        ip_ptr -> nx_ip_receive_batch_cut++;
+#endif /* NX_ENABLE_IP_THREAD_INFO */
+                    }
+                    break;
+                }
+            }
+
+#ifdef NX_ENABLE_IP_THREAD_INFO
+            /* Count the batch in its size bucket.  */
+            if (batch_count)
+            {
+                index =  0;
+                while ((index < (NX_IP_RECEIVE_BATCH_BUCKETS - 1)) && ((batch_count >> (index + 1)) != 0))
+                {
+                    index++;
+                }
+                ip_ptr -> nx_ip_receive_batch_count[index]++;
+
+                if (batch_count > ip_ptr -> nx_ip_receive_batch_max)
+                {
+                    ip_ptr -> nx_ip_receive_batch_max =  batch_count;
+                }
             }
+#endif /* NX_ENABLE_IP_THREAD_INFO */
 
             /* Determine if there is anything else to do in the loop.  */
             ip_events =  ip_events & ~(NX_IP_RECEIVE_EVENT);
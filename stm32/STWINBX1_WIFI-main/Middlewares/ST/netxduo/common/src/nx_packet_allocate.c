@@ -168,6 +168,7 @@ ULONG                  trace_timestamp;
 
         /* Add debug information. */
         NX_PACKET_DEBUG(__FILE__, __LINE__, work_ptr);
+        NX_PACKET_DEBUG_ALLOCATE(work_ptr, NX_PACKET_DEBUG_CALLER());
     }
     else
     {
@@ -258,6 +259,7 @@ ULONG                  trace_timestamp;
 
                 /* Add debug information. */
                 NX_PACKET_DEBUG(__FILE__, __LINE__, *packet_ptr);
+                NX_PACKET_DEBUG_ALLOCATE(*packet_ptr, NX_PACKET_DEBUG_CALLER());
             }
 #endif /* NX_ENABLE_PACKET_DEBUG_INFO */
 
@@ -80,5 +80,13 @@ VOID    _nx_packet_pool_initialize(VOID)
        number of packet pools created.  */
     _nx_packet_pool_created_ptr =        NX_NULL;
     _nx_packet_pool_created_count =      0;
+
+#ifdef NX_ENABLE_PACKET_DEBUG_INFO
+    /* No packet lifetime tracking until a routine is installed.  */
+    _nx_packet_debug_release_notify =    NX_NULL;
+
+    /* Interrupt allocations all share this owner string.  */
+    _nx_packet_debug_isr_owner =         "ISR";
+#endif /* NX_ENABLE_PACKET_DEBUG_INFO */
 }
 
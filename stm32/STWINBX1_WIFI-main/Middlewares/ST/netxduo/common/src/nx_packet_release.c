@@ -123,6 +123,14 @@ NX_PACKET      *next_packet;    /* Working block pointer   */
         /* Add debug information. */
         NX_PACKET_DEBUG(__FILE__, __LINE__, packet_ptr);
 
+#ifdef NX_ENABLE_PACKET_DEBUG_INFO
+        /* Report the end of the hold while the allocation record is intact.  */
+        if (_nx_packet_debug_release_notify)
+        {
+            (_nx_packet_debug_release_notify)(packet_ptr);
+        }
+#endif /* NX_ENABLE_PACKET_DEBUG_INFO */
+
         /* Disable interrupts to put this packet back in the packet pool.  */
         TX_DISABLE
 
@@ -159,7 +159,7 @@ NX_TCP_SOCKET *end_ptr;
     socket_ptr -> nx_tcp_socket_port =  port;
 
     /* Calculate the hash index in the TCP port array of the associated IP instance.  */
-    index =  (UINT)((port + (port >> 8)) & NX_TCP_PORT_TABLE_MASK);
+    index =  NX_TCP_PORT_HASH(port);
 
     /* Pickup the head of the TCP ports bound list.  */
     search_ptr =  ip_ptr -> nx_ip_tcp_port_table[index];
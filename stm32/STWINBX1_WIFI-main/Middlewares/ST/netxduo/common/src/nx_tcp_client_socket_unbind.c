@@ -81,6 +81,9 @@ TX_INTERRUPT_SAVE_AREA
 
 UINT           index;
 UINT           port;
+#if NX_TCP_CONNECTION_CACHE_SIZE > 0
+UINT           i;
+#endif /* NX_TCP_CONNECTION_CACHE_SIZE > 0 */
 NX_IP         *ip_ptr;
 NX_TCP_SOCKET *new_socket_ptr;
 
@@ -151,7 +154,7 @@ NX_TCP_SOCKET *new_socket_ptr;
     port =  socket_ptr -> nx_tcp_socket_port;
 
     /* Calculate the hash index in the TCP port array of the associated IP instance.  */
-    index =  (UINT)((port + (port >> 8)) & NX_TCP_PORT_TABLE_MASK);
+    index =  NX_TCP_PORT_HASH(port);
 
     /* Disable interrupts while we unlink the current socket.  */
     TX_DISABLE
@@ -202,6 +205,17 @@ NX_TCP_SOCKET *new_socket_ptr;
     /* Restore interrupts.  */
     TX_RESTORE
 
+#if NX_TCP_CONNECTION_CACHE_SIZE > 0
+    /* Remove the socket from the connection cache.  */
+    for (i = 0; i < NX_TCP_CONNECTION_CACHE_SIZE; i++)
+    {
+        if (ip_ptr -> nx_ip_tcp_connection_cache[i] == socket_ptr)
+        {
+            ip_ptr -> nx_ip_tcp_connection_cache[i] =  NX_NULL;
+        }
+    }
+#endif /* NX_TCP_CONNECTION_CACHE_SIZE > 0 */
+
     /* Determine if there are any threads suspended on trying to bind to the
        same port.  */
     if (socket_ptr -> nx_tcp_socket_bind_suspension_list)
@@ -157,8 +157,7 @@ ULONG          timer_rate;
                 socket_ptr -> nx_tcp_socket_timeout_retries++;
 
                 /* Setup the next timeout.  */
-                socket_ptr -> nx_tcp_socket_timeout = socket_ptr -> nx_tcp_socket_timeout_rate <<
-                    (socket_ptr -> nx_tcp_socket_timeout_retries * socket_ptr -> nx_tcp_socket_timeout_shift);
+                socket_ptr -> nx_tcp_socket_timeout = NX_TCP_RETRY_TIMEOUT(socket_ptr);
 
                 /* Send the initial SYN message again.  Adjust the sequence number before and
                    after to ensure the same sequence as the initial SYN.  */
@@ -192,8 +191,7 @@ ULONG          timer_rate;
                 socket_ptr -> nx_tcp_socket_timeout_retries++;
 
                 /* Setup the next timeout.  */
-                socket_ptr -> nx_tcp_socket_timeout = socket_ptr -> nx_tcp_socket_timeout_rate <<
-                    (socket_ptr -> nx_tcp_socket_timeout_retries * socket_ptr -> nx_tcp_socket_timeout_shift);
+                socket_ptr -> nx_tcp_socket_timeout = NX_TCP_RETRY_TIMEOUT(socket_ptr);
 
                 /* Send another FIN packet.  */
                 _nx_tcp_packet_send_fin(socket_ptr, (socket_ptr -> nx_tcp_socket_tx_sequence - 1));
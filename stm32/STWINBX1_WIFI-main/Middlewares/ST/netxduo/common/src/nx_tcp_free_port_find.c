@@ -99,7 +99,7 @@ ULONG                  trace_timestamp;
     {
 
         /* Calculate the hash index in the TCP port array of the associated IP instance.  */
-        index =  (UINT)((port + (port >> 8)) & NX_TCP_PORT_TABLE_MASK);
+        index =  NX_TCP_PORT_HASH(port);
 
         /* Obtain the IP mutex so we can figure out whether or not the port has already
            been bound to.  */
@@ -39,6 +39,92 @@
 #endif /* NX_IPSEC_ENABLE */
 
 
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_packet_connection_match                     PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Wind Turbine Team                                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function checks whether a bound socket is the connection an   */
+/*    incoming TCP packet belongs to: same local port, peer port, IP      */
+/*    version and peer address.                                           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to bound socket       */
+/*    packet_ptr                            Pointer to incoming packet    */
+/*    port                                  Destination port              */
+/*    source_ip                             Source IP address             */
+/*    source_port                           Source port                   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    NX_TRUE                               Socket matches                */
+/*    NX_FALSE                              Socket does not match         */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_packet_process                Process TCP packet            */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-18-2026     Wind Turbine Team        Initial Version 6.1           */
+/*                                                                        */
+/**************************************************************************/
+static UINT _nx_tcp_packet_connection_match(NX_TCP_SOCKET *socket_ptr, NX_PACKET *packet_ptr, UINT port,
+                                            ULONG *source_ip, UINT source_port)
+{
+
+    /* Determine if the ports match.  */
+    if ((socket_ptr -> nx_tcp_socket_port != port) ||
+        (socket_ptr -> nx_tcp_socket_connect_port != source_port))
+    {
+        return(NX_FALSE);
+    }
+
+    /* Make sure they are the same IP protocol */
+    if (socket_ptr -> nx_tcp_socket_connect_ip.nxd_ip_version != packet_ptr -> nx_packet_ip_version)
+    {
+        return(NX_FALSE);
+    }
+
+#ifndef NX_DISABLE_IPV4
+    if (packet_ptr -> nx_packet_ip_version == NX_IP_VERSION_V4)
+    {
+
+        if (socket_ptr -> nx_tcp_socket_connect_ip.nxd_ip_address.v4 == *source_ip)
+        {
+            return(NX_TRUE);
+        }
+    }
+#endif /* !NX_DISABLE_IPV4  */
+
+#ifdef FEATURE_NX_IPV6
+    if (packet_ptr -> nx_packet_ip_version == NX_IP_VERSION_V6)
+    {
+        if (CHECK_IPV6_ADDRESSES_SAME(socket_ptr -> nx_tcp_socket_connect_ip.nxd_ip_address.v6, source_ip))
+        {
+            return(NX_TRUE);
+        }
+    }
+#endif /* FEATURE_NX_IPV6 */
+
+    return(NX_FALSE);
+}
+
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -75,6 +161,7 @@
 /*    _nx_tcp_mss_option_get                Get peer MSS option           */
 /*    _nx_tcp_no_connection_reset           Reset on no connection        */
 /*    _nx_tcp_packet_send_syn               Send SYN message              */
+/*    _nx_tcp_packet_connection_match       Match socket to connection    */
 /*    _nx_tcp_socket_packet_process         Socket specific packet        */
 /*                                            processing routine          */
 /*    (nx_tcp_listen_callback)              Application listen callback   */
@@ -103,6 +190,7 @@ ULONG                       *source_ip = NX_NULL;
 ULONG                       *dest_ip = NX_NULL;
 UINT                         source_port;
 NX_TCP_SOCKET               *socket_ptr;
+NX_TCP_SOCKET               *search_ptr;
 NX_TCP_HEADER               *tcp_header_ptr;
 struct NX_TCP_LISTEN_STRUCT *listen_ptr;
 VOID                         (*listen_callback)(NX_TCP_SOCKET *socket_ptr, UINT port);
@@ -121,6 +209,9 @@ UINT                         queued_source_port;
 UINT                         is_a_RST_request;
 UINT                         is_valid_option_flag = NX_TRUE;
 UINT                         status;
+#if NX_TCP_CONNECTION_CACHE_SIZE > 0
+UINT                         cache_index;
+#endif /* NX_TCP_CONNECTION_CACHE_SIZE > 0 */
 #ifdef NX_ENABLE_TCP_WINDOW_SCALING
 ULONG                        rwin_scale = 0xFF;
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
@@ -303,109 +394,111 @@ ULONG                        rwin_scale = 0xFF;
     /* Pickup the source TCP port.  */
     source_port =  (UINT)(tcp_header_ptr -> nx_tcp_header_word_0 >> NX_SHIFT_BY_16);
 
-    /* Calculate the hash index in the TCP port array of the associated IP instance.  */
-    index =  (UINT)((port + (port >> 8)) & NX_TCP_PORT_TABLE_MASK);
+#if NX_TCP_CONNECTION_CACHE_SIZE > 0
+    /* Calculate the index in the connection cache from the 4-tuple.  */
+#ifdef FEATURE_NX_IPV6
+    if (packet_ptr -> nx_packet_ip_version == NX_IP_VERSION_V6)
+    {
+        cache_index =  NX_TCP_CONNECTION_HASH(source_ip[3], source_port, port);
+    }
+    else
+#endif /* FEATURE_NX_IPV6 */
+    {
+        cache_index =  NX_TCP_CONNECTION_HASH(*source_ip, source_port, port);
+    }
 
-    /* Search the bound sockets in this index for the particular port.  */
-    socket_ptr =  ip_ptr -> nx_ip_tcp_port_table[index];
+    /* Check the socket last hit for this 4-tuple first.  */
+    socket_ptr =  ip_ptr -> nx_ip_tcp_connection_cache[cache_index];
 
-    /* Determine if there are any sockets bound on this port index.  */
-    if (socket_ptr)
+    if ((socket_ptr) &&
+        (_nx_tcp_packet_connection_match(socket_ptr, packet_ptr, port, source_ip, source_port) == NX_FALSE))
     {
+        socket_ptr =  NX_NULL;
+    }
+#else
+    socket_ptr =  NX_NULL;
+#endif /* NX_TCP_CONNECTION_CACHE_SIZE > 0 */
 
-    INT find_a_match;
+    if (socket_ptr == NX_NULL)
+    {
 
-        /*  Yes, loop to examine the list of bound ports on this index.  */
-        do
-        {
+        /* Calculate the hash index in the TCP port array of the associated IP instance.  */
+        index =  NX_TCP_PORT_HASH(port);
 
-            find_a_match = 0;
+        /* Search the bound sockets in this index for the particular port.  */
+        search_ptr =  ip_ptr -> nx_ip_tcp_port_table[index];
 
-            /* Determine if the port has been found.  */
-            if ((socket_ptr -> nx_tcp_socket_port == port) &&
-                (socket_ptr -> nx_tcp_socket_connect_port == source_port))
+        /* Determine if there are any sockets bound on this port index.  */
+        if (search_ptr)
+        {
+
+            /*  Yes, loop to examine the list of bound ports on this index.  */
+            do
             {
 
-                /* Make sure they are the same IP protocol */
-                if (socket_ptr -> nx_tcp_socket_connect_ip.nxd_ip_version == packet_ptr -> nx_packet_ip_version)
+                /* Determine if the connection has been found.  */
+                if (_nx_tcp_packet_connection_match(search_ptr, packet_ptr, port, source_ip, source_port))
                 {
 
-#ifndef NX_DISABLE_IPV4
-                    if (packet_ptr -> nx_packet_ip_version == NX_IP_VERSION_V4)
-                    {
+                    /* Yes, we have a match!  */
+                    socket_ptr =  search_ptr;
 
-                        if (socket_ptr -> nx_tcp_socket_connect_ip.nxd_ip_address.v4 == *source_ip)
-                        {
-                            find_a_match = 1;
-                        }
-                    }
-#endif /* !NX_DISABLE_IPV4  */
+                    /* Move the port head pointer to this socket.  */
+                    ip_ptr -> nx_ip_tcp_port_table[index] = socket_ptr;
 
-#ifdef FEATURE_NX_IPV6
-                    if (packet_ptr -> nx_packet_ip_version == NX_IP_VERSION_V6)
-                    {
-                        if (CHECK_IPV6_ADDRESSES_SAME(socket_ptr -> nx_tcp_socket_connect_ip.nxd_ip_address.v6, source_ip))
-                        {
-                            find_a_match = 1;
-                        }
-                    }
-#endif /* FEATURE_NX_IPV6 */
+#if NX_TCP_CONNECTION_CACHE_SIZE > 0
+                    /* Remember the socket for the next packet of this connection.  */
+                    ip_ptr -> nx_ip_tcp_connection_cache[cache_index] =  socket_ptr;
+#endif /* NX_TCP_CONNECTION_CACHE_SIZE > 0 */
+                    break;
                 }
 
-                if (find_a_match)
-                {
-
-                    /* Yes, we have a match!  */
-
-                    /* Determine if we need to update the tcp port head pointer.  This should
-                       only be done if the found socket pointer is not the head pointer and
-                       the mutex for this IP instance is available.  */
+                /* Move to the next entry in the bound index.  */
+                search_ptr =  search_ptr -> nx_tcp_socket_bound_next;
+            } while (search_ptr != ip_ptr -> nx_ip_tcp_port_table[index]);
+        }
+    }
 
-                    /* Move the port head pointer to this socket.  */
-                    ip_ptr -> nx_ip_tcp_port_table[index] = socket_ptr;
+    /* Determine if the packet belongs to an existing TCP connection.  */
+    if (socket_ptr)
+    {
 
-                    /* If this packet contains SYN */
-                    if (tcp_header_ptr -> nx_tcp_header_word_3 & NX_TCP_SYN_BIT)
-                    {
+        /* If this packet contains SYN */
+        if (tcp_header_ptr -> nx_tcp_header_word_3 & NX_TCP_SYN_BIT)
+        {
 
-                        /* Record the MSS value if it is present and the   Otherwise use 536, as
-                           outlined in RFC 1122 section 4.2.2.6. */
-                        socket_ptr -> nx_tcp_socket_peer_mss = mss;
+            /* Record the MSS value if it is present and the   Otherwise use 536, as
+               outlined in RFC 1122 section 4.2.2.6. */
+            socket_ptr -> nx_tcp_socket_peer_mss = mss;
 
-                        if ((mss > socket_ptr -> nx_tcp_socket_mss) && socket_ptr -> nx_tcp_socket_mss)
-                        {
-                            socket_ptr -> nx_tcp_socket_connect_mss  = socket_ptr -> nx_tcp_socket_mss;
-                        }
-                        else if ((socket_ptr -> nx_tcp_socket_state != NX_TCP_SYN_SENT) ||
-                                 (socket_ptr -> nx_tcp_socket_connect_mss > mss))
-                        {
-                            socket_ptr -> nx_tcp_socket_connect_mss  = mss;
-                        }
+            if ((mss > socket_ptr -> nx_tcp_socket_mss) && socket_ptr -> nx_tcp_socket_mss)
+            {
+                socket_ptr -> nx_tcp_socket_connect_mss  = socket_ptr -> nx_tcp_socket_mss;
+            }
+            else if ((socket_ptr -> nx_tcp_socket_state != NX_TCP_SYN_SENT) ||
+                     (socket_ptr -> nx_tcp_socket_connect_mss > mss))
+            {
+                socket_ptr -> nx_tcp_socket_connect_mss  = mss;
+            }
 
-                        /* Compute the SMSS * SMSS value, so later TCP module doesn't need to redo the multiplication. */
-                        socket_ptr -> nx_tcp_socket_connect_mss2 =
-                            socket_ptr -> nx_tcp_socket_connect_mss * socket_ptr -> nx_tcp_socket_connect_mss;
+            /* Compute the SMSS * SMSS value, so later TCP module doesn't need to redo the multiplication. */
+            socket_ptr -> nx_tcp_socket_connect_mss2 =
+                socket_ptr -> nx_tcp_socket_connect_mss * socket_ptr -> nx_tcp_socket_connect_mss;
 #ifdef NX_ENABLE_TCP_WINDOW_SCALING
-                        /*
-                           Simply record the peer's window scale value. When we move to the
-                           ESTABLISHED state, we will set the peer window scale to 0 if the
-                           peer does not support this feature.
-                         */
-                        socket_ptr -> nx_tcp_snd_win_scale_value = rwin_scale;
+            /*
+               Simply record the peer's window scale value. When we move to the
+               ESTABLISHED state, we will set the peer window scale to 0 if the
+               peer does not support this feature.
+             */
+            socket_ptr -> nx_tcp_snd_win_scale_value = rwin_scale;
 #endif /* NX_ENABLE_TCP_WINDOW_SCALING */
-                    }
+        }
 
-                    /* Process the packet within an existing TCP connection.  */
-                    _nx_tcp_socket_packet_process(socket_ptr, packet_ptr);
+        /* Process the packet within an existing TCP connection.  */
+        _nx_tcp_socket_packet_process(socket_ptr, packet_ptr);
 
-                    /* Get out of the search loop and this function!  */
-                    return;
-                }
-            }
-
-            /* Move to the next entry in the bound index.  */
-            socket_ptr =  socket_ptr -> nx_tcp_socket_bound_next;
-        } while (socket_ptr != ip_ptr -> nx_ip_tcp_port_table[index]);
+        /* Get out of this function!  */
+        return;
     }
 
     /* At this point, we know there is not an existing TCP connection.  */
@@ -696,7 +789,7 @@ ULONG                        rwin_scale = 0xFF;
                     socket_ptr -> nx_tcp_socket_tx_outstanding_bytes = 0;
 
                     /* Calculate the hash index in the TCP port array of the associated IP instance.  */
-                    index = (UINT)((port + (port >> 8)) & NX_TCP_PORT_TABLE_MASK);
+                    index = NX_TCP_PORT_HASH(port);
 
                     /* Determine if the list is NULL.  */
                     if (ip_ptr -> nx_ip_tcp_port_table[index])
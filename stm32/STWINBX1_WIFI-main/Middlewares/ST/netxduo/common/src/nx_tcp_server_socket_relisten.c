@@ -361,7 +361,7 @@ VOID                         (*listen_callback)(NX_TCP_SOCKET *socket_ptr, UINT
                     socket_ptr -> nx_tcp_socket_port =  port;
 
                     /* Calculate the hash index in the TCP port array of the associated IP instance.  */
-                    index =  (UINT)((port + (port >> 8)) & NX_TCP_PORT_TABLE_MASK);
+                    index =  NX_TCP_PORT_HASH(port);
 
                     /* Determine if the list is NULL.  */
                     if (ip_ptr -> nx_ip_tcp_port_table[index])
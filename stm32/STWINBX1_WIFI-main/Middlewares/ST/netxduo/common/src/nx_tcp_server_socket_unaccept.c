@@ -79,6 +79,9 @@ struct NX_TCP_LISTEN_STRUCT *listen_ptr;
 NX_IP                       *ip_ptr;
 UINT                         index;
 UINT                         port;
+#if NX_TCP_CONNECTION_CACHE_SIZE > 0
+UINT                         i;
+#endif /* NX_TCP_CONNECTION_CACHE_SIZE > 0 */
 
 
     /* Pickup the associated IP structure.  */
@@ -138,7 +141,7 @@ UINT                         port;
     port =  socket_ptr -> nx_tcp_socket_port;
 
     /* Calculate the hash index in the TCP port array of the associated IP instance.  */
-    index =  (UINT)((port + (port >> 8)) & NX_TCP_PORT_TABLE_MASK);
+    index =  NX_TCP_PORT_HASH(port);
 
     /* Determine if this is the only socket bound on this port list.  */
     if (socket_ptr -> nx_tcp_socket_bound_next == socket_ptr)
@@ -200,6 +203,17 @@ UINT                         port;
         }
     }
 
+#if NX_TCP_CONNECTION_CACHE_SIZE > 0
+    /* Remove the socket from the connection cache.  */
+    for (i = 0; i < NX_TCP_CONNECTION_CACHE_SIZE; i++)
+    {
+        if (ip_ptr -> nx_ip_tcp_connection_cache[i] == socket_ptr)
+        {
+            ip_ptr -> nx_ip_tcp_connection_cache[i] =  NX_NULL;
+        }
+    }
+#endif /* NX_TCP_CONNECTION_CACHE_SIZE > 0 */
+
     /* If trace is enabled, insert this event into the trace buffer.  */
     NX_TRACE_IN_LINE_INSERT(NX_TRACE_INTERNAL_TCP_STATE_CHANGE, ip_ptr, socket_ptr, socket_ptr -> nx_tcp_socket_state, NX_TCP_CLOSED, NX_TRACE_INTERNAL_EVENTS, 0, 0);
 
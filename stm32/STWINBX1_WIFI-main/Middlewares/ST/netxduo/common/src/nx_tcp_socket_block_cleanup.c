@@ -106,6 +106,14 @@ VOID  _nx_tcp_socket_block_cleanup(NX_TCP_SOCKET *socket_ptr)
     /* Reset fast recovery stage. */
     socket_ptr -> nx_tcp_socket_fast_recovery = NX_FALSE;
 
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+    /* Forget the round trip time, the next connection may be to another peer.  */
+    socket_ptr -> nx_tcp_socket_rtt_timing =  NX_FALSE;
+    socket_ptr -> nx_tcp_socket_rtt_srtt =    0;
+    socket_ptr -> nx_tcp_socket_rtt_rttvar =  0;
+    socket_ptr -> nx_tcp_socket_timeout_rate = socket_ptr -> nx_tcp_socket_timeout_initial;
+#endif /* NX_TCP_ENABLE_RTT_ESTIMATION */
+
     /* Connection needs to be closed down immediately.  */
     if (socket_ptr -> nx_tcp_socket_client_type)
     {
@@ -185,7 +185,7 @@ struct NX_TCP_LISTEN_STRUCT *listen_ptr;
         }
 
         /* Calculate the hash index in the TCP port array of the associated IP instance.  */
-        index = (UINT)((port + (port >> 8)) & NX_TCP_PORT_TABLE_MASK);
+        index = NX_TCP_PORT_HASH(port);
 
         /* Determine if the list is NULL.  */
         if (ip_ptr -> nx_ip_tcp_port_table[index])
@@ -138,8 +138,7 @@ ULONG      window_size;
         socket_ptr -> nx_tcp_socket_zero_window_probe_failure++;
 
         /* Setup the next timeout.  */
-        socket_ptr -> nx_tcp_socket_timeout = socket_ptr -> nx_tcp_socket_timeout_rate <<
-            (socket_ptr -> nx_tcp_socket_timeout_retries * socket_ptr -> nx_tcp_socket_timeout_shift);
+        socket_ptr -> nx_tcp_socket_timeout = NX_TCP_RETRY_TIMEOUT(socket_ptr);
 
         /* Send the zero window probe.  */
         _nx_tcp_packet_send_probe(socket_ptr, socket_ptr -> nx_tcp_socket_zero_window_probe_sequence,
@@ -154,11 +153,40 @@ ULONG      window_size;
         socket_ptr -> nx_tcp_socket_zero_window_probe_has_data = NX_FALSE;
     }
 
-    /* Increment the retry counter only if the receiver window is open. */
-    /* Increment the retry counter.  */
-    socket_ptr -> nx_tcp_socket_timeout_retries++;
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+    /* An ACK may now be for either transmission, so stop timing (Karn's algorithm).  */
+    socket_ptr -> nx_tcp_socket_rtt_timing = NX_FALSE;
 
-    if ((need_fast_retransmit == NX_TRUE) || (socket_ptr -> nx_tcp_socket_fast_recovery == NX_FALSE))
+    /* Count the retransmission by its trigger.  */
+    if (need_fast_retransmit == NX_TRUE)
+    {
+        socket_ptr -> nx_tcp_socket_retransmit_fast++;
+    }
+    else if (need_fast_retransmit == NX_TCP_RETRANSMIT_PARTIAL)
+    {
+        socket_ptr -> nx_tcp_socket_retransmit_partial++;
+    }
+    else
+    {
+        socket_ptr -> nx_tcp_socket_retransmit_timeouts++;
+    }
+
+    /* A partial ACK is progress, not a failed retry: the timer restarts at the RTO.
+       RFC6582, Section 3.2, Page 6.  */
+    if (need_fast_retransmit != NX_TCP_RETRANSMIT_PARTIAL)
+#endif /* NX_TCP_ENABLE_RTT_ESTIMATION */
+    {
+
+        /* Increment the retry counter only if the receiver window is open. */
+        /* Increment the retry counter.  */
+        socket_ptr -> nx_tcp_socket_timeout_retries++;
+    }
+
+    if ((need_fast_retransmit == NX_TRUE) || ((socket_ptr -> nx_tcp_socket_fast_recovery == NX_FALSE)
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+                                              && (need_fast_retransmit != NX_TCP_RETRANSMIT_PARTIAL)
+#endif /* NX_TCP_ENABLE_RTT_ESTIMATION */
+                                             ))
     {
 
         /* Timed out on an outgoing packet.  Enter slow start mode. */
@@ -193,8 +221,7 @@ ULONG      window_size;
     }
 
     /* Setup the next timeout.  */
-    socket_ptr -> nx_tcp_socket_timeout = socket_ptr -> nx_tcp_socket_timeout_rate <<
-        (socket_ptr -> nx_tcp_socket_timeout_retries * socket_ptr -> nx_tcp_socket_timeout_shift);
+    socket_ptr -> nx_tcp_socket_timeout = NX_TCP_RETRY_TIMEOUT(socket_ptr);
 
     /* Get available size of packet that can be sent. */
     available = socket_ptr -> nx_tcp_socket_tx_window_congestion;
@@ -408,7 +435,11 @@ ULONG      window_size;
         /* Move to next packet. */
         /* During fast recovery, only one packet is retransmitted at once. */
         /* After a timeout, the sending data can be at most one SMSS. */
+        /* On a partial ACK, only the next hole: later packets may be in flight already. */
         if ((next_ptr == (NX_PACKET *)NX_PACKET_ENQUEUED) ||
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+            (need_fast_retransmit == NX_TCP_RETRANSMIT_PARTIAL) ||
+#endif /* NX_TCP_ENABLE_RTT_ESTIMATION */
             (socket_ptr -> nx_tcp_socket_fast_recovery == NX_TRUE))
         {
             break;
@@ -0,0 +1,149 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** NetX Component                                                        */
+/**                                                                       */
+/**   Transmission Control Protocol (TCP)                                 */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define NX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "nx_api.h"
+#include "nx_tcp.h"
+
+
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _nx_tcp_socket_rtt_update                           PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Wind Turbine Team                                                   */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function adds a round trip time sample to the smoothed RTT     */
+/*    and RTT variation of the socket and derives the retransmission      */
+/*    timeout from them, RFC 6298 Section 2:                              */
+/*                                                                        */
+/*      RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R|                              */
+/*      SRTT   = 7/8 SRTT + 1/8 R                                         */
+/*      RTO    = SRTT + max(G, 4 RTTVAR)                                  */
+/*                                                                        */
+/*    G is the fast timer period, which drives the retransmission timer.  */
+/*    The RTO is kept within NX_TCP_RTO_MIN and NX_TCP_RTO_MAX and        */
+/*    becomes the timeout rate that retries back off from.                */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    socket_ptr                            Pointer to owning socket      */
+/*    rtt                                   Round trip time in ticks      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _nx_tcp_socket_state_ack_check        Process received ACK          */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-18-2026     Wind Turbine Team        Initial Version 6.1           */
+/*                                                                        */
+/**************************************************************************/
+VOID  _nx_tcp_socket_rtt_update(NX_TCP_SOCKET *socket_ptr, ULONG rtt)
+{
+
+ULONG srtt;
+ULONG delta;
+ULONG rto;
+
+
+    /* A sample shorter than a tick still takes one.  */
+    if (rtt == 0)
+    {
+        rtt = 1;
+    }
+
+    /* Determine if this is the first sample of the connection.  */
+    if (socket_ptr -> nx_tcp_socket_rtt_srtt == 0)
+    {
+
+        /* Yes, SRTT = R and RTTVAR = R / 2, in their scaled forms.  */
+        socket_ptr -> nx_tcp_socket_rtt_srtt =    rtt << 3;
+        socket_ptr -> nx_tcp_socket_rtt_rttvar =  rtt << 1;
+    }
+    else
+    {
+
+        /* Compute |SRTT - R| from the old SRTT.  */
+        srtt = socket_ptr -> nx_tcp_socket_rtt_srtt >> 3;
+        if (rtt > srtt)
+        {
+            delta = rtt - srtt;
+        }
+        else
+        {
+            delta = srtt - rtt;
+        }
+
+        /* RTTVAR is scaled by 4, so 1/4 |SRTT - R| adds |SRTT - R|.  */
+        socket_ptr -> nx_tcp_socket_rtt_rttvar = socket_ptr -> nx_tcp_socket_rtt_rttvar -
+            (socket_ptr -> nx_tcp_socket_rtt_rttvar >> 2) + delta;
+
+        /* SRTT is scaled by 8, so 1/8 R adds R.  */
+        socket_ptr -> nx_tcp_socket_rtt_srtt = socket_ptr -> nx_tcp_socket_rtt_srtt -
+            (socket_ptr -> nx_tcp_socket_rtt_srtt >> 3) + rtt;
+    }
+
+    /* 4 RTTVAR is the scaled RTTVAR itself.  */
+    rto = socket_ptr -> nx_tcp_socket_rtt_rttvar;
+    if (rto < _nx_tcp_fast_timer_rate)
+    {
+        rto = _nx_tcp_fast_timer_rate;
+    }
+    rto += socket_ptr -> nx_tcp_socket_rtt_srtt >> 3;
+
+    /* Keep the RTO within its bounds.  */
+    if (rto < (ULONG)NX_TCP_RTO_MIN)
+    {
+        rto = (ULONG)NX_TCP_RTO_MIN;
+    }
+    else if (rto > (ULONG)NX_TCP_RTO_MAX)
+    {
+        rto = (ULONG)NX_TCP_RTO_MAX;
+    }
+
+    /* Retries back off from the new RTO.  */
+    socket_ptr -> nx_tcp_socket_timeout_rate = rto;
+    socket_ptr -> nx_tcp_socket_rtt_samples++;
+}
+#endif /* NX_TCP_ENABLE_RTT_ESTIMATION */
+
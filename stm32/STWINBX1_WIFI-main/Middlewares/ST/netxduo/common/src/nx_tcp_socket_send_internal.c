@@ -908,6 +908,16 @@ UINT            compute_checksum = 1;
             /* Increase the transmit outstanding byte count. */
             socket_ptr -> nx_tcp_socket_tx_outstanding_bytes +=
                 (send_packet -> nx_packet_length - (ULONG)sizeof(NX_TCP_HEADER));
+
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+            /* Time this segment unless another one is being timed.  */
+            if (socket_ptr -> nx_tcp_socket_rtt_timing == NX_FALSE)
+            {
+                socket_ptr -> nx_tcp_socket_rtt_timing =    NX_TRUE;
+                socket_ptr -> nx_tcp_socket_rtt_sequence =  socket_ptr -> nx_tcp_socket_tx_sequence;
+                socket_ptr -> nx_tcp_socket_rtt_time =      tx_time_get();
+            }
+#endif /* NX_TCP_ENABLE_RTT_ESTIMATION */
 #ifndef NX_DISABLE_TCP_INFO
             /* Increment the TCP packet sent count and bytes sent count.  */
             ip_ptr -> nx_ip_tcp_packets_sent++;
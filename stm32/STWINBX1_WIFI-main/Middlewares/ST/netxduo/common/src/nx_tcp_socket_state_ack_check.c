@@ -114,6 +114,7 @@ ULONG          ending_rx_sequence;
 ULONG          acked_bytes;
 ULONG          tcp_payload_length;
 UINT           wrapped_flag = NX_FALSE;
+UINT           duplicated_ack_threshold = 3;
 
 
     /* Determine if the header has an ACK bit set.  This is an
@@ -249,7 +250,20 @@ UINT           wrapped_flag = NX_FALSE;
                     /* Handle duplicated ACK packet.  */
                     socket_ptr -> nx_tcp_socket_duplicated_ack_received++;
 
-                    if (socket_ptr -> nx_tcp_socket_duplicated_ack_received == 3)
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+                    /* Early retransmit: with fewer than four segments outstanding three
+                       duplicate ACKs cannot arrive, so one less than the number of segments
+                       outstanding is enough. The sender blocks instead of queuing unsent
+                       data, so the outstanding segments are all there is.
+                       RFC5827, Section 2.1, Page 4-5. */
+                    if ((socket_ptr -> nx_tcp_socket_transmit_sent_count > 1) &&
+                        (socket_ptr -> nx_tcp_socket_transmit_sent_count < 4))
+                    {
+                        duplicated_ack_threshold = (UINT)(socket_ptr -> nx_tcp_socket_transmit_sent_count - 1);
+                    }
+#endif /* NX_TCP_ENABLE_RTT_ESTIMATION */
+
+                    if (socket_ptr -> nx_tcp_socket_duplicated_ack_received == duplicated_ack_threshold)
                     {
                         if ((INT)((tcp_header_ptr -> nx_tcp_acknowledgment_number - 1) -
                                   socket_ptr -> nx_tcp_socket_tx_sequence_recover) > 0)
@@ -272,7 +286,7 @@ UINT           wrapped_flag = NX_FALSE;
                             _nx_tcp_socket_retransmit(socket_ptr -> nx_tcp_socket_ip_ptr, socket_ptr, NX_TRUE);
                         }
                     }
-                    else if ((socket_ptr -> nx_tcp_socket_duplicated_ack_received > 3) &&
+                    else if ((socket_ptr -> nx_tcp_socket_duplicated_ack_received > duplicated_ack_threshold) &&
                              (socket_ptr -> nx_tcp_socket_fast_recovery == NX_TRUE))
                     {
 
@@ -460,6 +474,16 @@ UINT           wrapped_flag = NX_FALSE;
         else
         {
 
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+            /* Take a round trip time sample if this ACK covers the timed segment.  */
+            if ((socket_ptr -> nx_tcp_socket_rtt_timing) &&
+                ((INT)(tcp_header_ptr -> nx_tcp_acknowledgment_number - socket_ptr -> nx_tcp_socket_rtt_sequence) >= 0))
+            {
+                socket_ptr -> nx_tcp_socket_rtt_timing = NX_FALSE;
+                _nx_tcp_socket_rtt_update(socket_ptr, tx_time_get() - socket_ptr -> nx_tcp_socket_rtt_time);
+            }
+#endif /* NX_TCP_ENABLE_RTT_ESTIMATION */
+
             /* Congestion window adjustment during slow start and congestion avoidance is executed
                on every incoming ACK that acknowledges new data. RFC5681, Section3.1, Page4-8.  */
 
@@ -735,8 +759,26 @@ UINT           wrapped_flag = NX_FALSE;
         {
 
             /* Only partial data are ACKed. Retransmit packet immediately. */
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+            _nx_tcp_socket_retransmit(socket_ptr -> nx_tcp_socket_ip_ptr, socket_ptr, NX_TCP_RETRANSMIT_PARTIAL);
+#else
             _nx_tcp_socket_retransmit(socket_ptr -> nx_tcp_socket_ip_ptr, socket_ptr, NX_FALSE);
+#endif /* NX_TCP_ENABLE_RTT_ESTIMATION */
+        }
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+        else if ((socket_ptr -> nx_tcp_socket_transmit_sent_head) &&
+                 ((INT)(tcp_header_ptr -> nx_tcp_acknowledgment_number -
+                        (socket_ptr -> nx_tcp_socket_tx_sequence_recover + 1)) < 0))
+        {
+
+            /* A timeout set the recover point at the highest sequence sent, and this ACK
+               falls short of it: the segments after the retransmitted one were most
+               likely lost with it (the peer keeps few out of order). Resend the next
+               one now, as NewReno does, instead of waiting for its timeout.
+               RFC6582, Section 3.2, Page 6.  */
+            _nx_tcp_socket_retransmit(socket_ptr -> nx_tcp_socket_ip_ptr, socket_ptr, NX_TCP_RETRANSMIT_PARTIAL);
         }
+#endif /* NX_TCP_ENABLE_RTT_ESTIMATION */
 
         return(NX_TRUE);
     }
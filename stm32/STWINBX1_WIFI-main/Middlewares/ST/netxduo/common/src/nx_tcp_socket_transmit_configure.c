@@ -100,6 +100,9 @@ NX_IP *ip_ptr;
     socket_ptr -> nx_tcp_socket_timeout_rate =                    timeout;
     socket_ptr -> nx_tcp_socket_timeout_max_retries =             max_retries;
     socket_ptr -> nx_tcp_socket_timeout_shift =                   timeout_shift;
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+    socket_ptr -> nx_tcp_socket_timeout_initial =                 timeout;
+#endif /* NX_TCP_ENABLE_RTT_ESTIMATION */
     socket_ptr -> nx_tcp_socket_transmit_queue_maximum_default =  max_queue_depth;
     socket_ptr -> nx_tcp_socket_transmit_queue_maximum =          max_queue_depth;
 
@@ -162,7 +162,7 @@ NX_UDP_HEADER *udp_header_ptr;
     port =  (UINT)(udp_header_ptr -> nx_udp_header_word_0 & NX_LOWER_16_MASK);
 
     /* Calculate the hash index in the UDP port array of the associated IP instance.  */
-    index =  (UINT)((port + (port >> 8)) & NX_UDP_PORT_TABLE_MASK);
+    index =  NX_UDP_PORT_HASH(port);
 
     /* Determine if the caller is a thread. If so, we should use the protection mutex
        to avoid having the port list examined while we are traversing it. If this routine
@@ -271,7 +271,7 @@ UINT           status = NX_SUCCESS;
     socket_ptr -> nx_udp_socket_port =  port;
 
     /* Calculate the hash index in the UDP port array of the associated IP instance.  */
-    index =  (UINT)((port + (port >> 8)) & NX_UDP_PORT_TABLE_MASK);
+    index =  NX_UDP_PORT_HASH(port);
 
     /* Pickup the head of the UDP ports bound list.  */
     search_ptr =  ip_ptr -> nx_ip_udp_port_table[index];
@@ -225,7 +225,7 @@ NX_PACKET     *next_packet_ptr;
     port =  socket_ptr -> nx_udp_socket_port;
 
     /* Calculate the hash index in the UDP port array of the associated IP instance.  */
-    index =  (UINT)((port + (port >> 8)) & NX_UDP_PORT_TABLE_MASK);
+    index =  NX_UDP_PORT_HASH(port);
 
 #ifdef NX_ENABLE_TCPIP_OFFLOAD
     _nx_udp_socket_driver_unbind(socket_ptr);
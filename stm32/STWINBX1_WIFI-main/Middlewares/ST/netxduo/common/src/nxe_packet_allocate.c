@@ -104,6 +104,14 @@ UINT status;
     /* Call actual packet allocate function.  */
     status =  _nx_packet_allocate(pool_ptr,  packet_ptr, packet_type, wait_option);
 
+#ifdef NX_ENABLE_PACKET_DEBUG_INFO
+    /* The allocation site is the application, not this service.  */
+    if (status == NX_SUCCESS)
+    {
+        (*packet_ptr) -> nx_packet_debug_alloc_site =  NX_PACKET_DEBUG_CALLER();
+    }
+#endif /* NX_ENABLE_PACKET_DEBUG_INFO */
+
     /* Return completion status.  */
     return(status);
 }
@@ -43,7 +43,7 @@ extern "C" {
 
 #define USE_MEMORY_POOL_ALLOCATION               1
 
-#define TX_APP_MEM_POOL_SIZE                     1024
+#define TX_APP_MEM_POOL_SIZE                     (20 * 1024)
 
 #define FX_APP_MEM_POOL_SIZE                     2048
 
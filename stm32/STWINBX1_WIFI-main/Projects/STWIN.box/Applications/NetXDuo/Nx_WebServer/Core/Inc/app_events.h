@@ -0,0 +1,100 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    app_events.h
+  * @author  Wind Turbine Team
+  * @brief   Event flags that wake the pipeline worker threads
+  ******************************************************************************
+  * Each worker (audio acquisition, feature extraction, telemetry) owns one
+  * event flags group and blocks on it with TX_WAIT_FOREVER instead of polling
+  * with timeouts and sleeps. Its input ring sets APP_EVENT_DATA_READY on the
+  * empty -> non-empty edge (SpscRing_SetWakeup); link, configuration and
+  * shutdown events are broadcast to every registered worker.
+  *
+  * Link changes come from the emw3080 driver (station up/down) through
+  * nx_ip_link_status_change_notify_set() and from DHCP through the IP
+  * address change notify, both in app_netxduo.c. APP_EVENT_LINK only says
+  * that something changed; read the current state with AppEvents_IsLinkUp().
+  */
+/* USER CODE END Header */
+
+#ifndef __APP_EVENTS_H
+#define __APP_EVENTS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define APP_EVENT_DATA_READY            0x01U   /* Input ring became non-empty / frame complete */
+#define APP_EVENT_LINK                  0x02U   /* Wi-Fi link or IPv4 address changed */
+#define APP_EVENT_CONFIG                0x04U   /* Settings changed, re-read them */
+#define APP_EVENT_SHUTDOWN              0x08U   /* Stop and park until restarted */
+#define APP_EVENT_ALL                   (APP_EVENT_DATA_READY | APP_EVENT_LINK | \
+                                         APP_EVENT_CONFIG | APP_EVENT_SHUTDOWN)
+
+#define APP_EVENTS_MAX_WORKERS          4
+
+typedef struct
+{
+    TX_EVENT_FLAGS_GROUP   flags;
+    uint32_t               wakeups;                    /* Waits that returned events */
+} AppEvents_Worker_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Create a worker's event group and add it to the broadcast list
+ * @param worker: worker events, usually inside the module context
+ * @param name: event flags name
+ * @retval TX_SUCCESS, TX_NO_INSTANCE if the list is full, or create error
+ */
+UINT AppEvents_Register(AppEvents_Worker_t *worker, CHAR *name);
+
+/**
+ * @brief Wait for any APP_EVENT_* and clear what was returned
+ * @param worker: worker events
+ * @param wait_option: TX_NO_WAIT, ticks or TX_WAIT_FOREVER
+ * @retval Events, 0 on timeout
+ */
+ULONG AppEvents_Wait(AppEvents_Worker_t *worker, ULONG wait_option);
+
+/**
+ * @brief Post events to one worker (thread or ISR)
+ * @param worker: worker events
+ * @param events: APP_EVENT_* mask
+ * @retval None
+ */
+void AppEvents_Post(AppEvents_Worker_t *worker, ULONG events);
+
+/**
+ * @brief Post events to every registered worker (thread or ISR)
+ * @param events: APP_EVENT_* mask
+ * @retval None
+ */
+void AppEvents_Broadcast(ULONG events);
+
+/**
+ * @brief Record the link state and broadcast APP_EVENT_LINK if it changed
+ * @param link_up: 1 when the station is associated and has an address
+ * @retval None
+ */
+void AppEvents_SetLinkUp(uint8_t link_up);
+
+/**
+ * @brief Current link state
+ * @retval 1 if up, 0 if down
+ */
+uint8_t AppEvents_IsLinkUp(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_EVENTS_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,45 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    app_util.h
+  * @author  Wind Turbine Team
+  * @brief   Text helpers shared by the CSV report formatters
+  ******************************************************************************
+  * Every /Get... endpoint builds its body with a Format(buf, size) function
+  * that appends one CSV line after the other. App_Append() is the one clamp
+  * they share: a line that does not fit is cut, and the buffer stays NUL
+  * terminated, so a report longer than its slab block is truncated rather
+  * than overrun.
+  */
+/* USER CODE END Header */
+
+#ifndef __APP_UTIL_H
+#define __APP_UTIL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief snprintf into buf at len, clamped to size
+ * @param buf: report buffer
+ * @param size: buffer size in bytes
+ * @param len: bytes already in buf
+ * @param fmt: printf format
+ * @retval New length, at most size - 1
+ */
+uint32_t App_Append(char *buf, uint32_t size, uint32_t len, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_UTIL_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
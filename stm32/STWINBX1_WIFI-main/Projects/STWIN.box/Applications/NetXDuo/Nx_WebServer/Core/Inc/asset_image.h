@@ -0,0 +1,129 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    asset_image.h
+  * @author  Wind Turbine Team
+  * @brief   Read-only asset image (web files + DSP tables) in memory-mapped OSPI NOR
+  ******************************************************************************
+  * The asset image is produced on the host by Tools/mkassetimg.py and flashed
+  * to the OctoSPI NOR. At runtime the NOR is switched to memory-mapped mode so
+  * the HTTP server and the DSP code read the content in place (no FileX, no copy).
+  *
+  * Image layout (all fields little-endian):
+  *   AssetImage_Header_t               (32 bytes)
+  *   AssetImage_Entry_t[entry_count]   (64 bytes each, sorted by name)
+  *   payloads                          (each aligned on ASSET_IMAGE_ALIGN)
+  */
+/* USER CODE END Header */
+
+#ifndef __ASSET_IMAGE_H
+#define __ASSET_IMAGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+
+/**
+ * @brief Set to 1 when the OSPI NOR BSP driver is part of the build
+ */
+#ifndef ASSET_IMAGE_ENABLE
+#define ASSET_IMAGE_ENABLE           0
+#endif
+
+/**
+ * @brief Image placement in the OctoSPI NOR (last 1 MB of the 64 MB device)
+ */
+#ifndef ASSET_IMAGE_FLASH_OFFSET
+#define ASSET_IMAGE_FLASH_OFFSET     0x03F00000U
+#endif
+#ifndef ASSET_IMAGE_MAX_SIZE
+#define ASSET_IMAGE_MAX_SIZE         0x00100000U
+#endif
+#define ASSET_IMAGE_BASE_ADDR        (OCTOSPI1_BASE + ASSET_IMAGE_FLASH_OFFSET)
+
+/**
+ * @brief Format constants (keep in sync with Tools/mkassetimg.py)
+ */
+#define ASSET_IMAGE_MAGIC            0x49415457U  /* "WTAI" */
+#define ASSET_IMAGE_VERSION          1
+#define ASSET_IMAGE_NAME_MAX         48           /* Including terminating NUL */
+#define ASSET_IMAGE_ALIGN            32           /* Payload alignment (cache line) */
+
+/**
+ * @brief Entry types
+ */
+#define ASSET_TYPE_WEB               1            /* HTTP resource, name = URL path */
+#define ASSET_TYPE_TABLE_F32         2            /* float32 lookup table */
+#define ASSET_TYPE_TABLE_U16         3            /* uint16 lookup table */
+
+/**
+ * @brief Well-known DSP table names
+ */
+#define ASSET_NAME_GOERTZEL_TABLE    "dsp/goertzel_f32"  /* {2cos(w), cos(w), sin(w)} per bin */
+#define ASSET_NAME_BAND_MAP          "dsp/band_map_u16"  /* FFT_BANDS + 1 bin edges */
+
+typedef struct
+{
+    uint32_t magic;                /* ASSET_IMAGE_MAGIC */
+    uint16_t version;              /* ASSET_IMAGE_VERSION */
+    uint16_t entry_count;          /* Number of index entries */
+    uint32_t image_size;           /* Total image size in bytes */
+    uint32_t index_crc32;          /* CRC-32 of the entry table */
+    uint32_t reserved[4];
+} AssetImage_Header_t;
+
+typedef struct
+{
+    char     name[ASSET_IMAGE_NAME_MAX];  /* NUL-terminated, sorted ascending */
+    uint32_t offset;                      /* Payload offset from image start */
+    uint32_t size;                        /* Payload size in bytes */
+    uint16_t type;                        /* ASSET_TYPE_xxx */
+    uint16_t flags;                       /* Reserved */
+    uint32_t reserved;
+} AssetImage_Entry_t;
+
+_Static_assert(sizeof(AssetImage_Header_t) == 32, "AssetImage_Header_t must be 32 bytes");
+_Static_assert(sizeof(AssetImage_Entry_t) == 64, "AssetImage_Entry_t must be 64 bytes");
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Enable OSPI memory-mapped mode and validate the image index
+ * @retval TX_SUCCESS if a valid image is mapped, error code otherwise
+ */
+UINT AssetImage_Init(void);
+
+/**
+ * @brief Check whether a valid image is mapped
+ * @retval 1 if ready, 0 otherwise
+ */
+uint8_t AssetImage_IsReady(void);
+
+/**
+ * @brief Look up an entry by name and type
+ * @param name: entry name (URL path for web entries)
+ * @param type: ASSET_TYPE_xxx
+ * @param size: optional output for payload size in bytes
+ * @retval Pointer to the payload in mapped memory, NULL if not found
+ */
+const void* AssetImage_Find(const char *name, uint16_t type, uint32_t *size);
+
+/**
+ * @brief Get number of entries in the mapped image
+ * @retval Entry count (0 if no image)
+ */
+uint32_t AssetImage_GetEntryCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ASSET_IMAGE_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -19,15 +19,19 @@ extern "C" {
 #include <stdint.h>
 #include "tx_api.h"
 #include "audio_features.h"
+#include "spsc_ring.h"
+#include "rt_sched.h"
 
 /* Defines -------------------------------------------------------------------*/
 
 /**
- * @brief Thread configuration
+ * @brief Thread configuration (period and budget set the priority, see rt_sched.h)
  */
-#define AUDIO_ACQ_THREAD_PRIORITY    8           /* Medium priority (higher = more urgent) */
+#define AUDIO_ACQ_PERIOD_MS          ((AUDIO_FRAME_SIZE * 1000U) / AUDIO_SAMPLE_RATE)  /* One frame: 32 ms */
+#define AUDIO_ACQ_BUDGET_US          2000        /* Copy and clipping scan of one frame */
+#define AUDIO_ACQ_THREAD_PRIORITY    RT_SCHED_PRIORITY(AUDIO_ACQ_PERIOD_MS)
 #define AUDIO_ACQ_THREAD_STACK_SIZE  (2 * 1024)  /* 2 KB stack */
-#define AUDIO_ACQ_QUEUE_DEPTH        4           /* Allow 4 pending frames */
+#define AUDIO_ACQ_QUEUE_DEPTH        4           /* Allow 4 pending frames (power of two) */
 
 /**
  * @brief Queue message structure
@@ -62,10 +66,10 @@ UINT AudioAcquisition_Init(TX_BYTE_POOL *byte_pool);
 UINT AudioAcquisition_Start(void);
 
 /**
- * @brief Get queue for audio frame messages
- * @retval Pointer to TX_QUEUE control block
+ * @brief Get ring for audio frame messages
+ * @retval Pointer to the frame ring (AudioFrame_t slots)
  */
-TX_QUEUE* AudioAcquisition_GetQueue(void);
+SpscRing_t* AudioAcquisition_GetQueue(void);
 
 /**
  * @brief Get current frame number (for synchronization)
@@ -85,6 +89,12 @@ uint8_t AudioAcquisition_IsActive(void);
  */
 uint32_t AudioAcquisition_GetErrorCount(void);
 
+/**
+ * @brief Microphone DMA interrupt handler (GPDMA1_Channel1)
+ * @retval None
+ */
+void AudioAcquisition_DMA_IRQHandler(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -97,6 +97,12 @@ _Static_assert(sizeof(AudioTelemetryPacket_t) == 64, "AudioTelemetryPacket_t mus
  */
 uint32_t AudioFeatures_Init(void);
 
+/**
+ * @brief Check whether the FFT bands use precomputed asset tables
+ * @retval 1 if tables from the OSPI asset image are bound, 0 otherwise
+ */
+uint8_t AudioFeatures_UsingAssetTables(void);
+
 /**
  * @brief Calculate RMS from PCM samples
  * @param samples: pointer to int16_t PCM samples
@@ -105,6 +111,22 @@ uint32_t AudioFeatures_Init(void);
  */
 uint16_t AudioFeatures_CalculateRMS(const int16_t *samples, uint32_t count);
 
+/**
+ * @brief Sum of squared samples (RMS numerator, can be summed across frames)
+ * @param samples: pointer to int16_t PCM samples
+ * @param count: number of samples
+ * @retval Sum of x[n]^2
+ */
+uint64_t AudioFeatures_SumSquares(const int16_t *samples, uint32_t count);
+
+/**
+ * @brief RMS from a sum of squares
+ * @param sum_squares: AudioFeatures_SumSquares() total
+ * @param count: number of samples in the total
+ * @retval RMS value in Q15 format (0-32767)
+ */
+uint16_t AudioFeatures_RMSFromSumSquares(uint64_t sum_squares, uint32_t count);
+
 /**
  * @brief Calculate Zero Crossing Rate
  * @param samples: pointer to int16_t PCM samples
@@ -113,6 +135,22 @@ uint16_t AudioFeatures_CalculateRMS(const int16_t *samples, uint32_t count);
  */
 uint16_t AudioFeatures_CalculateZCR(const int16_t *samples, uint32_t count);
 
+/**
+ * @brief Count sign changes between consecutive samples
+ * @param samples: pointer to int16_t PCM samples
+ * @param count: number of samples
+ * @retval Zero crossings
+ */
+uint32_t AudioFeatures_CountZeroCrossings(const int16_t *samples, uint32_t count);
+
+/**
+ * @brief ZCR from a zero crossing count
+ * @param zero_crossings: AudioFeatures_CountZeroCrossings() total
+ * @param count: number of samples in the total
+ * @retval ZCR as percentage of Nyquist rate (0-100)
+ */
+uint16_t AudioFeatures_ZCRFromCrossings(uint32_t zero_crossings, uint32_t count);
+
 /**
  * @brief Calculate SPL (Sound Pressure Level)
  * @param rms: RMS value in Q15 format
@@ -129,6 +167,14 @@ uint16_t AudioFeatures_CalculateSPL(uint16_t rms, float ref_pressure);
  */
 int AudioFeatures_ComputeFFTBands(const int16_t *samples, uint32_t *bands);
 
+/**
+ * @brief Compute one FFT magnitude band
+ * @param samples: pointer to int16_t PCM samples (FFT_SIZE required)
+ * @param band: 0 .. FFT_BANDS-1
+ * @retval Band magnitude (0-1000000)
+ */
+uint32_t AudioFeatures_ComputeFFTBand(const int16_t *samples, uint32_t band);
+
 /**
  * @brief Find peak amplitude in sample buffer
  * @param samples: pointer to int16_t PCM samples
@@ -0,0 +1,148 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    cpu_load.h
+  * @author  Wind Turbine Team
+  * @brief   Per-thread and per-ISR CPU load from the ThreadX execution profile
+  ******************************************************************************
+  * With TX_EXECUTION_PROFILE_ENABLE (tx_user.h) the scheduler and the ISR
+  * entry/exit code charge DWT cycle counts to the running thread, to "ISR"
+  * or to idle. A ThreadX timer samples those totals every
+  * CPU_LOAD_SAMPLE_MS and keeps the last window as a load table. Thread
+  * totals only ever grow, so rt_sched.c can take per-job differences.
+  *
+  * Only SysTick calls the kit's ISR entry/exit from assembly, so the C
+  * handlers in stm32u5xx_it.c are wrapped with CPU_LOAD_ISR_ENTER/EXIT. The
+  * wrappers tell the kit an interrupt is running (so its time is not charged
+  * to the preempted thread) and also count cycles per source, since the kit
+  * only keeps one total for all interrupts. Per-source times are gross: a
+  * nested higher-priority interrupt is also charged to the one it preempted.
+  * With TX_ENABLE_EVENT_TRACE the same wrappers log ISR enter/exit events,
+  * using the CpuLoad_Isr_t number as ISR id (see event_trace.h), and pass
+ * their entry/exit stamps to the latency capture (irq_latency.h). The entry
+ * stamp is taken before anything else so it is as close to the hardware
+ * entry as C allows.
+  *
+  * The CYCCNT counter stops while the core sleeps (tickless idle), so the
+  * window length is taken from the ThreadX clock and idle is whatever the
+  * threads and interrupts did not use.
+  */
+/* USER CODE END Header */
+
+#ifndef __CPU_LOAD_H
+#define __CPU_LOAD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+#include "stm32u5xx.h"
+#include "irq_latency.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define CPU_LOAD_SAMPLE_MS              1000    /* Load window */
+#define CPU_LOAD_MAX_THREADS            20      /* Threads kept per window */
+#define CPU_LOAD_REPORT_SIZE            1536    /* Report text, taken from the slab allocator */
+
+/**
+ * @brief Interrupt sources measured by the stm32u5xx_it.c wrappers
+ */
+typedef enum
+{
+    CPU_LOAD_ISR_WIFI_NOTIFY = 0,      /* EXTI7: mx_wifi notify line */
+    CPU_LOAD_ISR_EXTI15,               /* EXTI15 */
+    CPU_LOAD_ISR_HAL_TICK,             /* TIM6: HAL time base */
+    CPU_LOAD_ISR_SD,                   /* SDMMC1 */
+    CPU_LOAD_ISR_WIFI_FLOW,            /* LPTIM1: mx_wifi flow capture */
+    CPU_LOAD_ISR_LOW_POWER,            /* LPTIM3: tickless idle wakeup */
+    CPU_LOAD_ISR_WIFI_DMA,             /* GPDMA1 channels 4/5: mx_wifi SPI DMA */
+    CPU_LOAD_ISR_WIFI_SPI,             /* SPI1 */
+    CPU_LOAD_ISR_THREAD_METRIC,        /* TIM7: Thread-Metric interrupt tests */
+    CPU_LOAD_ISR_AUDIO_DMA,            /* GPDMA1 channel 1: microphone MDF DMA */
+    CPU_LOAD_ISR_COUNT
+} CpuLoad_Isr_t;
+
+#ifdef TX_ENABLE_EVENT_TRACE
+#define CPU_LOAD_TRACE_ISR_ENTER(isr)   _tx_trace_isr_enter_insert((ULONG)(isr))
+#define CPU_LOAD_TRACE_ISR_EXIT(isr)    _tx_trace_isr_exit_insert((ULONG)(isr))
+#else
+#define CPU_LOAD_TRACE_ISR_ENTER(isr)
+#define CPU_LOAD_TRACE_ISR_EXIT(isr)
+#endif
+
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+#define CPU_LOAD_ISR_ENTER(isr)         uint32_t cpu_load_isr_start = DWT->CYCCNT;                      \
+                                        _tx_execution_isr_enter();                                      \
+                                        IrqLatency_Enter((isr), cpu_load_isr_start);                    \
+                                        CPU_LOAD_TRACE_ISR_ENTER(isr)
+#define CPU_LOAD_ISR_EXIT(isr)          do {                                                            \
+                                            uint32_t cpu_load_isr_end = DWT->CYCCNT;                    \
+                                            CpuLoad_IsrAccount((isr), cpu_load_isr_end - cpu_load_isr_start); \
+                                            IrqLatency_Exit((isr), cpu_load_isr_start, cpu_load_isr_end); \
+                                            CPU_LOAD_TRACE_ISR_EXIT(isr);                               \
+                                            _tx_execution_isr_exit();                                   \
+                                        } while (0)
+#else
+#define CPU_LOAD_ISR_ENTER(isr)         CPU_LOAD_TRACE_ISR_ENTER(isr)
+#define CPU_LOAD_ISR_EXIT(isr)          CPU_LOAD_TRACE_ISR_EXIT(isr)
+#endif
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Start the DWT cycle counter and the sampling timer
+ * @retval TX_SUCCESS on success, error code otherwise
+ */
+UINT CpuLoad_Init(void);
+
+/**
+ * @brief Charge cycles to an interrupt source (called from the ISR wrappers)
+ * @param isr: CpuLoad_Isr_t
+ * @param cycles: DWT cycles spent in the handler
+ * @retval None
+ */
+void CpuLoad_IsrAccount(CpuLoad_Isr_t isr, uint32_t cycles);
+
+/**
+ * @brief Format the last window as CSV lines
+ * @param buf: output buffer
+ * @param size: buffer size
+ * @retval Number of characters written (excluding terminator)
+ *
+ * Loads are in permille of the window.
+ * Line formats:
+ *   window,<ms>,<core_hz>
+ *   thread,<name>,<permille>,<cycles>
+ *   isr,<name>,<permille>,<cycles>,<count>
+ *   idle,<permille>
+ * "isr,other" is the profile kit's interrupt total minus the named sources,
+ * i.e. SysTick and any nesting overlap.
+ */
+uint32_t CpuLoad_Format(char *buf, uint32_t size);
+
+/**
+ * @brief Cycles used by threads and interrupts so far
+ * @retval Cycles, 0 without TX_EXECUTION_PROFILE_ENABLE
+ *
+ * The difference over an interval is the CPU time used in it, less what
+ * threads deleted in between had used. Idle is not counted.
+ */
+uint64_t CpuLoad_GetBusyCycles(void);
+
+/**
+ * @brief Report name of an interrupt source
+ * @param isr: CpuLoad_Isr_t
+ * @retval Name, "?" if out of range
+ */
+const char *CpuLoad_IsrName(CpuLoad_Isr_t isr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CPU_LOAD_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,102 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    dsp_pool.h
+  * @author  Wind Turbine Team
+  * @brief   Work-stealing fork/join pool for independent DSP jobs
+  ******************************************************************************
+  * DspPool_Run() spreads a batch of jobs round-robin over one deque per
+  * participant, wakes the worker threads and works on the batch itself until
+  * every job has finished. A participant takes jobs from the bottom of its
+  * own deque and, once that is empty, steals from the top of the others', so
+  * a core that drew the slow jobs is helped by the ones that finished early.
+  *
+  * Workers exist only on an SMP ThreadX build (TX_THREAD_SMP_MAX_CORES),
+  * one per extra core, each pinned with tx_thread_smp_core_exclude(). On the
+  * single-core STM32U585 DSP_POOL_WORKERS is 0 and the calling thread runs
+  * the whole batch in order with no extra stacks or context switches.
+  *
+  * One batch at a time, submitted by one thread.
+  */
+/* USER CODE END Header */
+
+#ifndef __DSP_POOL_H
+#define __DSP_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define DSP_POOL_MAX_JOBS               32      /* Per batch */
+#define DSP_POOL_STACK_SIZE             (2 * 1024)
+#define DSP_POOL_CACHE_LINE             32      /* Keeps each deque word on its own line */
+
+#ifdef TX_THREAD_SMP_MAX_CORES
+#define DSP_POOL_WORKERS                (TX_THREAD_SMP_MAX_CORES - 1)
+#else
+#define DSP_POOL_WORKERS                0       /* Single core: the caller runs every job */
+#endif
+
+typedef void (*DspPool_JobFn_t)(void *arg);
+
+typedef struct
+{
+    DspPool_JobFn_t        fn;
+    void                  *arg;
+} DspPool_Job_t;
+
+typedef struct
+{
+    uint32_t workers;                  /* Active helper threads */
+    uint32_t batches;                  /* DspPool_Run() calls */
+    uint32_t jobs;                     /* Jobs run */
+    uint32_t steals;                   /* Jobs taken from another participant's deque */
+    uint32_t waits;                    /* Times the caller slept on unfinished jobs */
+} DspPool_Stats_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Create the worker threads (none when workers is 0)
+ * @param byte_pool: ThreadX byte pool for the worker stacks
+ * @param workers: helper threads, usually DSP_POOL_WORKERS
+ * @param priority: worker priority, usually the caller's
+ * @retval TX_SUCCESS, TX_SIZE_ERROR if workers > DSP_POOL_WORKERS, or create error
+ */
+UINT DspPool_Init(TX_BYTE_POOL *byte_pool, UINT workers, UINT priority);
+
+/**
+ * @brief Run a batch of jobs and return when all of them have finished
+ * @param jobs: jobs, copied before the call returns
+ * @param count: 1 .. DSP_POOL_MAX_JOBS
+ * @retval TX_SUCCESS, TX_SIZE_ERROR or TX_PTR_ERROR
+ * @note  Jobs must not depend on each other or on the order they run in.
+ */
+UINT DspPool_Run(const DspPool_Job_t *jobs, uint32_t count);
+
+/**
+ * @brief Use fewer of the created workers (between batches only)
+ * @param workers: 0 .. the count given to DspPool_Init()
+ * @retval TX_SUCCESS or TX_SIZE_ERROR
+ */
+UINT DspPool_SetActiveWorkers(UINT workers);
+
+/**
+ * @brief Get counters
+ * @param stats: output
+ * @retval None
+ */
+void DspPool_GetStats(DspPool_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_POOL_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
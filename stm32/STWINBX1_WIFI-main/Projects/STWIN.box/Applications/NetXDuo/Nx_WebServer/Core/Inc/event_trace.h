@@ -0,0 +1,111 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    event_trace.h
+  * @author  Wind Turbine Team
+  * @brief   ThreadX event trace capture into a RAM ring buffer
+  ******************************************************************************
+  * With TX_ENABLE_EVENT_TRACE (tx_user.h) the kernel logs thread
+  * resume/suspend, queue, semaphore and other service calls into the buffer
+  * given to tx_trace_enable(). The buffer wraps, so it always holds the most
+  * recent events. The interrupt wrappers in stm32u5xx_it.c add ISR
+  * enter/exit events with the CpuLoad_Isr_t number as ISR id.
+  *
+  * Capture is controlled over HTTP: start free running, or arm it to freeze
+  * on the next dropped audio frame so the buffer ends with whatever delayed
+  * the acquisition thread. GET /GetTrace returns the raw TraceX image;
+  * Tools/txtrace2json.py turns it into a Chrome trace / Perfetto timeline.
+  *
+  * Time stamps are DWT cycles, which stop while the core sleeps: select
+  * /IdleMode/Off while tracing to keep the timeline linear.
+  */
+/* USER CODE END Header */
+
+#ifndef __EVENT_TRACE_H
+#define __EVENT_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+#ifndef EVENT_TRACE_BUFFER_SIZE
+#define EVENT_TRACE_BUFFER_SIZE         (32U * 1024U)   /* ~950 events after header and registry */
+#endif
+#define EVENT_TRACE_REGISTRY_ENTRIES    40              /* Threads, queues, timers, pools, ... */
+
+/**
+ * @brief User events (TraceX numbering), info field 1 carries the argument
+ */
+#define EVENT_TRACE_EVENT_FRAME_DROP    (TX_TRACE_USER_EVENT_START + 0)     /* I1 = frame number */
+#define EVENT_TRACE_EVENT_FROZEN        (TX_TRACE_USER_EVENT_START + 1)     /* I1 = EventTrace_State_t before */
+
+typedef enum
+{
+    EVENT_TRACE_STATE_OFF = 0,         /* Never started, buffer empty */
+    EVENT_TRACE_STATE_RUNNING,         /* Recording, buffer wraps */
+    EVENT_TRACE_STATE_ARMED,           /* Recording, freezes on the next frame drop */
+    EVENT_TRACE_STATE_FROZEN           /* Stopped, buffer holds the last capture */
+} EventTrace_State_t;
+
+typedef struct
+{
+    uint32_t state;                    /* EventTrace_State_t */
+    uint32_t buffer_size;              /* Bytes returned by GET /GetTrace */
+    uint32_t frame_drops;              /* Frame drops seen while recording */
+    uint32_t captures;                 /* Captures started since boot */
+} EventTrace_Stats_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Start the DWT cycle counter used as trace time stamp
+ * @retval TX_SUCCESS, TX_FEATURE_NOT_ENABLED without TX_ENABLE_EVENT_TRACE
+ */
+UINT EventTrace_Init(void);
+
+/**
+ * @brief Start a new capture (previous buffer contents are lost)
+ * @param freeze_on_drop: TX_TRUE to freeze on the next frame drop
+ * @retval tx_trace_enable() status
+ */
+UINT EventTrace_Start(UINT freeze_on_drop);
+
+/**
+ * @brief Stop recording and keep the buffer for download
+ * @retval TX_SUCCESS
+ */
+UINT EventTrace_Stop(void);
+
+/**
+ * @brief Record a dropped audio frame; freezes an armed capture
+ * @param frame_number: frame that was dropped
+ * @retval None
+ */
+void EventTrace_FrameDrop(uint32_t frame_number);
+
+/**
+ * @brief Freeze the capture and return the TraceX image
+ * @param size: receives the image size (0 if nothing was captured)
+ * @retval Trace buffer, valid until the next EventTrace_Start()
+ */
+const UCHAR *EventTrace_GetBuffer(ULONG *size);
+
+/**
+ * @brief Get capture state and counters
+ * @param stats: output
+ * @retval None
+ */
+void EventTrace_GetStats(EventTrace_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EVENT_TRACE_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -24,10 +24,13 @@ extern "C" {
 /* Defines -------------------------------------------------------------------*/
 
 /**
- * @brief Thread configuration
+ * @brief Thread configuration (period and budget set the priority, see rt_sched.h)
  */
-#define FEATURE_EXTRACT_THREAD_PRIORITY   7           /* Medium-high priority */
+#define FEATURE_EXTRACT_PERIOD_MS         (AUDIO_ACQ_PERIOD_MS * AUDIO_FRAMES_PER_PACKET)  /* One packet: 128 ms */
+#define FEATURE_EXTRACT_BUDGET_US         30000       /* Features of one packet */
+#define FEATURE_EXTRACT_THREAD_PRIORITY   RT_SCHED_PRIORITY(FEATURE_EXTRACT_PERIOD_MS)
 #define FEATURE_EXTRACT_THREAD_STACK_SIZE (4 * 1024)  /* 4 KB stack for DSP */
+#define FEATURE_EXTRACT_QUEUE_DEPTH       2           /* 2 completed packets can wait (power of two) */
 
 /**
  * @brief Feature packet buffer for aggregation
@@ -52,16 +55,16 @@ UINT FeatureExtraction_Init(TX_BYTE_POOL *byte_pool);
 
 /**
  * @brief Start feature extraction processing
- * @param input_queue: Queue pointer from audio acquisition
+ * @param input_ring: Frame ring from audio acquisition
  * @retval TX_SUCCESS on success
  */
-UINT FeatureExtraction_Start(TX_QUEUE *input_queue);
+UINT FeatureExtraction_Start(SpscRing_t *input_ring);
 
 /**
- * @brief Get queue that outputs completed feature packets
- * @retval Pointer to TX_QUEUE control block (outputs AudioTelemetryPacket_t)
+ * @brief Get ring that outputs completed feature packets
+ * @retval Pointer to the packet ring (AudioTelemetryPacket_t slots)
  */
-TX_QUEUE* FeatureExtraction_GetOutputQueue(void);
+SpscRing_t* FeatureExtraction_GetOutputQueue(void);
 
 /**
  * @brief Get packet count generated since start
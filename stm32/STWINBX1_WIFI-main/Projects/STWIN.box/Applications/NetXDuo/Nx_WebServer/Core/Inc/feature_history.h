@@ -0,0 +1,148 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    feature_history.h
+  * @author  Wind Turbine Team
+  * @brief   Columnar compressed block format for AudioTelemetryPacket_t history
+  ******************************************************************************
+  * A block holds up to FEATURE_HISTORY_BLOCK_RECORDS packets of one node.
+  *
+  * Block layout (little-endian):
+  *   FeatureHistory_BlockHeader_t   (32 bytes, min/max for skip-scanning)
+  *   payload                        (payload_len bytes, MSB-first bitstream)
+  *
+  * The payload stores one column after the other:
+  *   timestamp_ms, seq_number, uptime_sec  -> delta-of-delta, variable buckets
+  *   rms_raw, zcr_count, zcr_rate, spl_db,
+  *   peak_amplitude, fft_band[0..7],
+  *   status_flags, error_count             -> XOR with previous value (Gorilla)
+  *
+  * version and node_id are constant per block and kept in the header. Reserved
+  * packet fields are not stored and decode as 0. If a block would not shrink,
+  * the records are stored raw and FEATURE_HISTORY_FLAG_RAW is set.
+  *
+  * This file has no RTOS dependency: the same code is built into the host
+  * decoder (Tools/fhdump.c).
+  */
+/* USER CODE END Header */
+
+#ifndef __FEATURE_HISTORY_H
+#define __FEATURE_HISTORY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "audio_features.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define FEATURE_HISTORY_MAGIC          0x4846     /* "FH" */
+#define FEATURE_HISTORY_VERSION        1
+
+/* Records per block (one block ~ 4 s of telemetry at 128 ms per packet) */
+#define FEATURE_HISTORY_BLOCK_RECORDS  32
+
+/* Worst-case block size (raw fallback) */
+#define FEATURE_HISTORY_BLOCK_MAX_SIZE (sizeof(FeatureHistory_BlockHeader_t) + \
+                                        FEATURE_HISTORY_BLOCK_RECORDS * sizeof(AudioTelemetryPacket_t))
+
+/* Header flags */
+#define FEATURE_HISTORY_FLAG_RAW       0x01       /* Payload is packed AudioTelemetryPacket_t[] */
+
+typedef struct __attribute__((packed))
+{
+    uint16_t magic;                /* FEATURE_HISTORY_MAGIC */
+    uint8_t  version;              /* FEATURE_HISTORY_VERSION */
+    uint8_t  count;                /* Records in block */
+    uint16_t payload_len;          /* Bytes following the header */
+    uint8_t  node_id;              /* Node identifier of all records */
+    uint8_t  flags;                /* FEATURE_HISTORY_FLAG_xxx */
+
+    uint32_t first_ts;             /* timestamp_ms of first record */
+    uint32_t last_ts;              /* timestamp_ms of last record */
+
+    uint8_t  packet_version;       /* AudioTelemetryPacket_t.version */
+    uint8_t  status_or;            /* OR of all status_flags */
+    uint16_t spl_min;              /* Min/max for skip-scanning */
+    uint16_t spl_max;
+    uint16_t rms_min;
+    uint16_t rms_max;
+    uint16_t peak_max;
+    uint32_t band_max;             /* Max over all FFT bands */
+} FeatureHistory_BlockHeader_t;
+
+_Static_assert(sizeof(FeatureHistory_BlockHeader_t) == 32, "FeatureHistory_BlockHeader_t must be 32 bytes");
+
+/**
+ * @brief Encoder state: records are staged, columns are written on flush
+ */
+typedef struct
+{
+    AudioTelemetryPacket_t records[FEATURE_HISTORY_BLOCK_RECORDS];
+    uint32_t               count;
+} FeatureHistory_Encoder_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Reset encoder (drops staged records)
+ * @param enc: encoder state
+ */
+void FeatureHistory_EncoderReset(FeatureHistory_Encoder_t *enc);
+
+/**
+ * @brief Stage one packet
+ * @param enc: encoder state
+ * @param pkt: packet to add
+ * @retval 1 if the block is full and must be flushed, 0 otherwise
+ */
+uint8_t FeatureHistory_EncoderAdd(FeatureHistory_Encoder_t *enc, const AudioTelemetryPacket_t *pkt);
+
+/**
+ * @brief Encode staged packets into one block and reset the encoder
+ * @param enc: encoder state
+ * @param out: output buffer (FEATURE_HISTORY_BLOCK_MAX_SIZE is always enough)
+ * @param out_size: output buffer size
+ * @retval Block size in bytes, 0 if nothing staged or buffer too small
+ */
+uint32_t FeatureHistory_EncoderFlush(FeatureHistory_Encoder_t *enc, uint8_t *out, uint32_t out_size);
+
+/**
+ * @brief Validate a block header and return the total block size
+ * @param block: start of block
+ * @param len: available bytes
+ * @retval Block size in bytes, 0 if invalid or truncated
+ */
+uint32_t FeatureHistory_BlockSize(const uint8_t *block, uint32_t len);
+
+/**
+ * @brief Decode a block
+ * @param block: start of block
+ * @param len: available bytes
+ * @param out: output records
+ * @param max_out: capacity of out
+ * @retval Number of records decoded, -1 on error
+ */
+int FeatureHistory_DecodeBlock(const uint8_t *block, uint32_t len,
+                               AudioTelemetryPacket_t *out, uint32_t max_out);
+
+/**
+ * @brief Check from the header alone whether a block can hold matching records
+ * @param hdr: block header
+ * @param from_ms: start of time window (inclusive)
+ * @param to_ms: end of time window (inclusive)
+ * @param spl_min: minimum SPL of interest (0 = any)
+ * @retval 1 if the block must be decoded, 0 if it can be skipped
+ */
+uint8_t FeatureHistory_BlockMayMatch(const FeatureHistory_BlockHeader_t *hdr,
+                                     uint32_t from_ms, uint32_t to_ms, uint16_t spl_min);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FEATURE_HISTORY_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
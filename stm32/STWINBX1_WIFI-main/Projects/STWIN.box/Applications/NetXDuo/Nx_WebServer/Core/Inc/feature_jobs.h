@@ -0,0 +1,56 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    feature_jobs.h
+  * @author  Wind Turbine Team
+  * @brief   Packet features split into independent DSP pool jobs
+  ******************************************************************************
+  * One packet of samples becomes FFT_BANDS band jobs (Goertzel over the
+  * first FFT_SIZE samples, one band each) and one statistics job per frame
+  * (sum of squares, zero crossings, peak). The frame partials are combined
+  * afterwards, so the result matches the single-pass AudioFeatures_*()
+  * calls exactly. Shared by the firmware and the gateway build.
+  */
+/* USER CODE END Header */
+
+#ifndef __FEATURE_JOBS_H
+#define __FEATURE_JOBS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "audio_features.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define FEATURE_JOBS_COUNT              (FFT_BANDS + AUDIO_FRAMES_PER_PACKET)
+
+typedef struct
+{
+    uint16_t rms_raw;                  /* Q15 */
+    uint16_t zcr_rate;                 /* Percent */
+    uint16_t peak_amplitude;
+    uint32_t fft_band[FFT_BANDS];
+} FeatureJobs_Result_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Compute the packet features on the DSP pool
+ * @param samples: PCM samples, at least FFT_SIZE
+ * @param count: FFT_SIZE .. AUDIO_SAMPLES_PER_PACKET
+ * @param result: output
+ * @retval 0 on success, -1 on a bad argument or pool error
+ * @note  Not reentrant: one caller (the feature extraction thread).
+ */
+int FeatureJobs_Compute(const int16_t *samples, uint32_t count, FeatureJobs_Result_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FEATURE_JOBS_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
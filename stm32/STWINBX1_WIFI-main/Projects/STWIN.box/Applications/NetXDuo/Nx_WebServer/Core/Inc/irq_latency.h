@@ -0,0 +1,116 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    irq_latency.h
+  * @author  Wind Turbine Team
+  * @brief   Interrupt latency and jitter capture for the stm32u5xx_it.c handlers
+  ******************************************************************************
+  * The CPU_LOAD_ISR_ENTER/EXIT wrappers (cpu_load.h) pass their DWT entry and
+  * exit stamps here. While a capture is armed every source gets a service
+  * time histogram (entry to exit), and the periodic ones (audio DMA half /
+  * full transfer, HAL tick) also get:
+  *
+  *   jitter    interval between two entries minus the period
+  *   lateness  entry time against the least delayed entry of its block of
+  *             IRQ_LATENCY_BLOCK periods, with the period measured over the
+  *             whole capture so a sample clock that is not exactly 16 kHz
+  *             does not read as lateness
+  *   headroom  period - (worst lateness + worst service time): how much
+  *             later the handler could finish before the DMA overwrites the
+  *             half it is reading
+  *
+  * Lateness is the variable part of the latency. The fixed hardware entry
+  * time (12 cycles plus the wrapper) and a delay that lasts a whole block
+  * are not in it. For the worst lateness of each source the capture keeps
+  * what the execution profile kit saw at entry: nesting depth, time the
+  * core had already been in interrupt context, the interrupted thread and
+  * the last handler to exit before this one (the usual blocker).
+  *
+  * CYCCNT stops while the core sleeps, so a capture switches the tickless
+  * idle off and restores the previous mode when it ends.
+  */
+/* USER CODE END Header */
+
+#ifndef __IRQ_LATENCY_H
+#define __IRQ_LATENCY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define IRQ_LATENCY_BLOCK               32      /* Periods per lateness baseline */
+#define IRQ_LATENCY_BINS                12      /* Histograms: <1 us, <2 us, <4 us ... <1024 us, more */
+#define IRQ_LATENCY_DEFAULT_SECONDS     30
+#define IRQ_LATENCY_MAX_SECONDS         600
+#define IRQ_LATENCY_REPORT_SIZE         2048    /* Report text, taken from the slab allocator */
+
+typedef enum
+{
+    IRQ_LATENCY_STATE_IDLE = 0,        /* Never armed */
+    IRQ_LATENCY_STATE_RUNNING,
+    IRQ_LATENCY_STATE_DONE
+} IrqLatency_State_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Create the capture timer and set the known periods
+ * @retval TX_SUCCESS, TX_FEATURE_NOT_ENABLED without TX_EXECUTION_PROFILE_ENABLE
+ */
+UINT IrqLatency_Init(void);
+
+/**
+ * @brief Declare a source periodic (enables jitter, lateness and headroom)
+ * @param isr: CpuLoad_Isr_t
+ * @param period_us: interrupt period, 0 for aperiodic
+ * @retval TX_SUCCESS or TX_SIZE_ERROR
+ */
+UINT IrqLatency_SetPeriod(uint32_t isr, uint32_t period_us);
+
+/**
+ * @brief Clear the statistics and capture for a number of seconds
+ * @param seconds: clamped to 1..IRQ_LATENCY_MAX_SECONDS
+ * @retval TX_SUCCESS, TX_NOT_AVAILABLE if a capture is running
+ */
+UINT IrqLatency_Start(ULONG seconds);
+
+/**
+ * @brief End the capture early
+ * @retval None
+ */
+void IrqLatency_Stop(void);
+
+/**
+ * @brief Format the last capture as CSV lines
+ * @param buf: output buffer
+ * @param size: buffer size
+ * @retval Number of characters written (excluding terminator)
+ *
+ * Times are DWT cycles; histograms have IRQ_LATENCY_BINS counts.
+ * Line formats:
+ *   capture,<state>,<ms>,<core_hz>
+ *   service,<name>,<count>,<max>,<bins...>
+ *   late,<name>,<period>,<max>,<jitter_min>,<jitter_max>,<misses>,<headroom>,<bins...>
+ *   worst,<name>,<late>,<nest>,<isr_busy>,<thread>,<last_exit_name>,<last_exit_gap>
+ * "late" and "worst" lines only appear for periodic sources that fired
+ * twice; misses counts skipped periods and entries later than one period.
+ * The last partial block of a capture has no lateness.
+ */
+uint32_t IrqLatency_Format(char *buf, uint32_t size);
+
+/* Called from the ISR wrappers in cpu_load.h only */
+void IrqLatency_Enter(uint32_t isr, uint32_t entry);
+void IrqLatency_Exit(uint32_t isr, uint32_t entry, uint32_t exit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __IRQ_LATENCY_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,144 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    low_power.h
+  * @author  Wind Turbine Team
+  * @brief   Tickless idle: ThreadX low-power hooks on an LPTIM3 wakeup timer
+  ******************************************************************************
+  * With TX_LOW_POWER (tx_user.h) the scheduler idle loop calls
+  * tx_low_power_enter()/exit(), which call the hooks below. While idle,
+  * SysTick and the HAL TIM6 tick are stopped and LPTIM3 (LSE, free running)
+  * is programmed to wake the core at the next ThreadX timer expiration. On
+  * wakeup the elapsed LPTIM3 time is added back to both tick counts.
+  *
+  * Any enabled interrupt ends the sleep early, in particular the audio DMA
+  * half/full transfer, the mx_wifi flow (LPTIM1 capture) and notify (EXTI)
+  * lines. Stop 2 is only used when no GPDMA channel and no SD transfer is
+  * active; otherwise the core uses Sleep mode and the peripherals keep
+  * running.
+  *
+  * The module also keeps run/sleep/stop time and wakeup counts for an
+  * energy-per-packet estimate (GET /GetEnergy).
+  */
+/* USER CODE END Header */
+
+#ifndef __LOW_POWER_H
+#define __LOW_POWER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+
+/**
+ * @brief Wakeup timer
+ *
+ * LPTIM3 counts LSE / 8 = 4096 Hz (LSI if the LSE does not start) and wraps
+ * after 16 s, so a single sleep is limited to LOW_POWER_MAX_SLEEP_TICKS.
+ */
+#define LOW_POWER_LPTIM_HZ              4096U
+#define LOW_POWER_MAX_SLEEP_TICKS       (15U * TX_TIMER_TICKS_PER_SECOND)
+#define LOW_POWER_MIN_SLEEP_TICKS       2U      /* Shorter: keep SysTick running */
+#define LOW_POWER_IRQ_PRIORITY          5
+
+#ifndef LOW_POWER_DEFAULT_MODE
+#define LOW_POWER_DEFAULT_MODE          LOW_POWER_MODE_SLEEP
+#endif
+
+/**
+ * @brief Supply model for the energy estimate (MCU rail only)
+ *
+ * Datasheet-order figures for the STM32U585 at 160 MHz on the LDO. The
+ * mx_wifi module and the sensors are not included: calibrate these against
+ * a power analyzer on the board before comparing absolute numbers.
+ */
+#define LOW_POWER_SUPPLY_MV             3300U
+#define LOW_POWER_RUN_UA                8000U
+#define LOW_POWER_SLEEP_UA              2500U
+#define LOW_POWER_STOP_UA               10U
+
+typedef enum
+{
+    LOW_POWER_MODE_OFF = 0,            /* Idle loop spins, ticks keep running (previous behaviour) */
+    LOW_POWER_MODE_SLEEP,              /* Tickless Sleep, peripherals and DMA keep running */
+    LOW_POWER_MODE_STOP                /* Tickless Stop 2 when no DMA/SD transfer is active */
+} LowPower_Mode_t;
+
+typedef struct
+{
+    uint32_t mode;                     /* LowPower_Mode_t */
+    uint32_t window_ms;                /* Measurement window length */
+    uint32_t run_ms;                   /* Core running */
+    uint32_t sleep_ms;                 /* In Sleep mode */
+    uint32_t stop_ms;                  /* In Stop 2 */
+    uint32_t wakeups;                  /* Idle exits */
+    uint32_t timer_wakeups;            /* Of which ended by the LPTIM3 deadline */
+    uint32_t packets;                  /* Telemetry packets sent */
+    uint32_t energy_uj;                /* Estimated MCU energy over the window */
+    uint32_t energy_per_packet_uj;     /* energy_uj / packets (0 without packets) */
+} LowPower_Stats_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Start the LSE and LPTIM3 (call before the kernel starts)
+ * @retval TX_SUCCESS, TX_NOT_AVAILABLE if no low-speed clock (mode stays OFF)
+ */
+UINT LowPower_Init(void);
+
+/**
+ * @brief Select the idle mode and restart the measurement window
+ * @param mode: LowPower_Mode_t
+ * @retval TX_SUCCESS, TX_NOT_AVAILABLE if LowPower_Init() failed
+ */
+UINT LowPower_SetMode(LowPower_Mode_t mode);
+
+/**
+ * @brief Current idle mode
+ * @retval LowPower_Mode_t
+ */
+LowPower_Mode_t LowPower_GetMode(void);
+
+/**
+ * @brief Count one telemetry packet for the energy-per-packet figure
+ * @retval None
+ */
+void LowPower_NotePacket(void);
+
+/**
+ * @brief Get the measurement window statistics
+ * @param stats: output
+ * @retval None
+ */
+void LowPower_GetStats(LowPower_Stats_t *stats);
+
+/**
+ * @brief Restart the measurement window
+ * @retval None
+ */
+void LowPower_ResetStats(void);
+
+/**
+ * @brief LPTIM3 interrupt (deadline reached)
+ * @retval None
+ */
+void LowPower_TimerIRQHandler(void);
+
+/* ThreadX low-power hooks (tx_user.h), called with interrupts disabled */
+void LowPower_TimerSetup(ULONG ticks);
+void LowPower_Enter(void);
+void LowPower_Exit(void);
+ULONG LowPower_TimerAdjust(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LOW_POWER_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -59,6 +59,7 @@ void Error_Handler(void);
 
 /* USER CODE BEGIN EFP */
 void Success_Handler(void);
+void SystemClock_Config(void);
 /* USER CODE END EFP */
 
 /* Private defines -----------------------------------------------------------*/
@@ -0,0 +1,108 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    mem_budget.h
+  * @author  Wind Turbine Team
+  * @brief   Memory budget: byte-pool carving, stacks and packet pools
+  ******************************************************************************
+  * Every module allocates from the ThreadX byte pools through
+  * MemBudget_Allocate(), which records owner and purpose. Large static buffers
+  * are declared with MemBudget_RegisterStatic() so the report covers both.
+  *
+  * At runtime the report adds:
+  *   - stack high-water marks (scan of the 0xEF stack fill pattern)
+  *   - byte-pool fragmentation (free blocks, largest free block)
+  *   - packet-pool low watermarks (sampled by a ThreadX timer)
+  *
+  * The build-time view of .data/.bss comes from Tools/ramreport.py.
+  */
+/* USER CODE END Header */
+
+#ifndef __MEM_BUDGET_H
+#define __MEM_BUDGET_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define MEM_BUDGET_MAX_ENTRIES          32      /* Allocations + static buffers */
+#define MEM_BUDGET_MAX_PACKET_POOLS     4
+#ifdef TX_LOW_POWER
+#define MEM_BUDGET_SAMPLE_MS            100     /* Packet-pool sampling period (wakes tickless idle) */
+#else
+#define MEM_BUDGET_SAMPLE_MS            10      /* Packet-pool sampling period */
+#endif
+#define MEM_BUDGET_REPORT_SIZE          2048    /* Report text, taken from the slab allocator */
+
+/**
+ * @brief Byte-pool cost of one allocation: block header plus rounding
+ *
+ * Use MEM_BUDGET_POOL_COST() when sizing a pool from the sum of its users.
+ */
+#define MEM_BUDGET_BLOCK_OVERHEAD       (sizeof(UCHAR *) + sizeof(ALIGN_TYPE))
+#define MEM_BUDGET_ALIGN(size)          ((((size) + sizeof(ALIGN_TYPE) - 1) / sizeof(ALIGN_TYPE)) * sizeof(ALIGN_TYPE))
+#define MEM_BUDGET_POOL_COST(size)      (MEM_BUDGET_ALIGN(size) + MEM_BUDGET_BLOCK_OVERHEAD)
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Start packet-pool sampling and stack overflow reporting
+ * @retval TX_SUCCESS on success, error code otherwise
+ */
+UINT MemBudget_Init(void);
+
+/**
+ * @brief Allocate from a byte pool (TX_NO_WAIT) and record the allocation
+ * @param pool: ThreadX byte pool
+ * @param ptr: receives the allocated memory
+ * @param size: requested size in bytes
+ * @param owner: module name (string literal)
+ * @param purpose: what the memory is for (string literal)
+ * @retval tx_byte_allocate() status
+ */
+UINT MemBudget_Allocate(TX_BYTE_POOL *pool, VOID **ptr, ULONG size,
+                        const CHAR *owner, const CHAR *purpose);
+
+/**
+ * @brief Record a statically allocated buffer
+ * @param owner: module name (string literal)
+ * @param purpose: what the memory is for (string literal)
+ * @param size: buffer size in bytes
+ * @retval None
+ */
+void MemBudget_RegisterStatic(const CHAR *owner, const CHAR *purpose, ULONG size);
+
+/**
+ * @brief Format the full report as CSV lines
+ * @param buf: output buffer
+ * @param size: buffer size
+ * @retval Number of characters written (excluding terminator)
+ *
+ * Line formats:
+ *   alloc,<pool|static>,<owner>,<purpose>,<bytes>
+ *   stack,<thread>,<size>,<used>
+ *   bytepool,<name>,<size>,<available>,<fragments>,<largest_free>
+ *   packetpool,<name>,<total>,<available>,<low_watermark>,<empty_requests>
+ *   slab,<block_size>,<blocks>,<in_use>,<in_use_max>,<allocs>,<spills>,<failures>
+ *   overflow,<thread>,<count>
+ */
+uint32_t MemBudget_Format(char *buf, uint32_t size);
+
+/**
+ * @brief Print the report on the console
+ * @retval None
+ */
+void MemBudget_Print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MEM_BUDGET_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,163 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    rt_sched.h
+  * @author  Wind Turbine Team
+  * @brief   Rate-monotonic priorities and deadline monitoring for the pipeline
+  ******************************************************************************
+  * Each periodic pipeline thread declares a period and a CPU budget in its
+  * own header and takes its priority from RT_SCHED_PRIORITY(period): the
+  * shorter the period, the higher the priority, one level per doubling of
+  * the period from RT_SCHED_BASE_PERIOD_MS. The levels are fixed at compile
+  * time, so the order does not depend on which module registers first.
+  * Aperiodic threads (web server, staging log, LED, iperf) stay below
+  * RT_SCHED_PRIORITY_LOWEST; the Wi-Fi driver and IP threads keep their
+  * levels inside the band because telemetry goes through them.
+  *
+  *   audio acquisition   32 ms (one frame)    priority 2
+  *   Wi-Fi I/O           aperiodic            priority 4, at most 10 ms per wakeup
+  *   feature extraction  128 ms (one packet)  priority 4
+  *   telemetry           128 ms (one packet)  priority 4
+  *   IP thread           aperiodic            priority 5
+  *
+  * The Wi-Fi I/O thread (nx_driver_emw3080.h) spins on the SPI link for up
+  * to NX_DRIVER_EMW3080_IO_BUDGET_MS per wakeup, over all the polls of the
+  * wakeup, and relinquishes after each. Threads of one level do not preempt
+  * each other, so a feature or telemetry job waits for one wakeup at most:
+  * 10 ms of blocking against a 128 ms deadline, to add to the budgets of
+  * the threads above it when checking the schedule. Audio preempts it.
+  *
+  * A job is released by whoever hands the thread its input (the DMA callback
+  * for audio, the previous stage for the others) and completed by the
+  * thread when it is done with it; the deadline is the period. Misses are
+  * counted when a job completes late, when it is skipped, and by a watchdog
+  * timer for jobs still open past their deadline, so a thread that is
+  * starved and never runs is caught as well. The budget is checked against
+  * the CPU time the thread used for the job (execution profile kit).
+  *
+  * Times are ThreadX ticks (1 ms) for releases and responses, since CYCCNT
+  * stops while the tickless idle sleeps.
+  */
+/* USER CODE END Header */
+
+#ifndef __RT_SCHED_H
+#define __RT_SCHED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define RT_SCHED_PRIORITY_HIGHEST       2       /* Below the timer thread and the Wi-Fi SPI thread */
+#define RT_SCHED_PRIORITY_LOWEST        5
+#define RT_SCHED_BASE_PERIOD_MS         32      /* Periods up to this get the highest level */
+#define RT_SCHED_MAX_BACKLOG            8       /* Released, not yet completed jobs tracked per task */
+#define RT_SCHED_WATCHDOG_MS            100     /* Check for jobs past their deadline */
+#define RT_SCHED_REPORT_SIZE            512     /* Report text, taken from the slab allocator */
+
+/**
+ * @brief Rate-monotonic priority for a period in milliseconds
+ */
+#define RT_SCHED_PRIORITY(period_ms)    ((period_ms) <= RT_SCHED_BASE_PERIOD_MS       ? RT_SCHED_PRIORITY_HIGHEST     : \
+                                         (period_ms) <= 2U * RT_SCHED_BASE_PERIOD_MS  ? RT_SCHED_PRIORITY_HIGHEST + 1 : \
+                                         (period_ms) <= 4U * RT_SCHED_BASE_PERIOD_MS  ? RT_SCHED_PRIORITY_HIGHEST + 2 : \
+                                                                                        RT_SCHED_PRIORITY_LOWEST)
+
+/**
+ * @brief Periodic threads
+ */
+typedef enum
+{
+    RT_SCHED_TASK_AUDIO_ACQ = 0,
+    RT_SCHED_TASK_FEATURE,
+    RT_SCHED_TASK_TELEMETRY,
+    RT_SCHED_TASK_COUNT
+} RtSched_Task_t;
+
+typedef struct
+{
+    uint32_t jobs;                     /* Completed jobs */
+    uint32_t misses;                   /* Completed late, skipped or found late by the watchdog */
+    uint32_t overruns;                 /* Jobs over their CPU budget */
+    uint32_t skipped;                  /* Released jobs the thread never got to (subset of misses) */
+    uint32_t response_max_ms;          /* Release to completion */
+    uint32_t cpu_max_us;               /* CPU time of one job */
+    uint32_t backlog_max;              /* Most jobs open at once */
+} RtSched_Stats_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Create the watchdog timer
+ * @retval TX_SUCCESS on success, error code otherwise
+ */
+UINT RtSched_Init(void);
+
+/**
+ * @brief Attach a thread to a task (call once after tx_thread_create)
+ * @param task: RtSched_Task_t
+ * @param thread: thread that completes the task's jobs
+ * @param period_ms: period, also the relative deadline
+ * @param budget_us: CPU time allowed per job
+ * @retval TX_SUCCESS, TX_SIZE_ERROR or TX_PTR_ERROR
+ */
+UINT RtSched_Register(RtSched_Task_t task, TX_THREAD *thread, ULONG period_ms, ULONG budget_us);
+
+/**
+ * @brief A job of the task became ready (thread or interrupt context)
+ * @param task: RtSched_Task_t
+ * @retval None
+ */
+void RtSched_Release(RtSched_Task_t task);
+
+/**
+ * @brief The oldest open job is done (task thread)
+ * @param task: RtSched_Task_t
+ * @retval None
+ */
+void RtSched_Complete(RtSched_Task_t task);
+
+/**
+ * @brief The oldest open job was dropped without being run (task thread)
+ * @param task: RtSched_Task_t
+ * @retval None
+ */
+void RtSched_Skip(RtSched_Task_t task);
+
+/**
+ * @brief Counters of one task
+ * @param task: RtSched_Task_t
+ * @param stats: output
+ * @retval None
+ */
+void RtSched_GetStats(RtSched_Task_t task, RtSched_Stats_t *stats);
+
+/**
+ * @brief Clear the counters of every task (open jobs are kept)
+ * @retval None
+ */
+void RtSched_ResetStats(void);
+
+/**
+ * @brief Format the counters as CSV lines
+ * @param buf: output buffer
+ * @param size: buffer size
+ * @retval Number of characters written (excluding terminator)
+ *
+ * Line format, one per registered task:
+ *   task,<name>,<priority>,<period_ms>,<budget_us>,<jobs>,<misses>,<overruns>,
+ *        <skipped>,<response_max_ms>,<cpu_max_us>,<backlog_max>
+ */
+uint32_t RtSched_Format(char *buf, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RT_SCHED_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,111 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    slab_alloc.h
+  * @author  Wind Turbine Team
+  * @brief   Fixed size-class allocator for hot-path buffers
+  ******************************************************************************
+  * Each size class is a ThreadX block pool over static storage, so both
+  * allocation and release are O(1) and cannot fragment. A request goes to the
+  * smallest class that fits. If that class is empty, it spills over to the
+  * next larger one.
+  *
+  * Long-lived memory (thread stacks, queues) stays in the byte pools. This
+  * allocator is for short-lived buffers that are allocated and released at
+  * high rate:
+  *   - mx_wifi IPC command/response buffers (MX_WIFI_MALLOC)
+  *   - telemetry history block encoding
+  *   - HTTP response scratch
+  */
+/* USER CODE END Header */
+
+#ifndef __SLAB_ALLOC_H
+#define __SLAB_ALLOC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stddef.h>
+#include "tx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+
+/**
+ * @brief Size-class table: X(block_size, block_count), ascending block sizes
+ *
+ * Block sizes must be multiples of sizeof(ALIGN_TYPE).
+ */
+#define SLAB_CLASS_TABLE(X)                                                 \
+    X(64,   16)     /* mx_wifi small command/response params */             \
+    X(256,  8)      /* mx_wifi scan results, TLS/DHCP control */            \
+    X(1600, 3)      /* mx_wifi full IPC frame (MX_WIFI_BUFFER_SIZE) */      \
+    X(2176, 2)      /* history block encode, HTTP report scratch */
+
+#define SLAB_BLOCK_OVERHEAD     (sizeof(UCHAR *))   /* Owning pool pointer in front of each block */
+
+#define SLAB_COUNT_CLASS(size, count)           + 1
+#define SLAB_CLASS_COUNT        (0 SLAB_CLASS_TABLE(SLAB_COUNT_CLASS))
+
+#define SLAB_STORAGE_CLASS(size, count)         + ((size) + SLAB_BLOCK_OVERHEAD) * (count)
+#define SLAB_STORAGE_SIZE       (0 SLAB_CLASS_TABLE(SLAB_STORAGE_CLASS))
+
+#define SLAB_MAX_BLOCK_SIZE     2176                /* Largest class, checked in slab_alloc.c */
+
+typedef struct
+{
+    uint32_t block_size;               /* Usable bytes per block */
+    uint32_t blocks;                   /* Blocks in class */
+    uint32_t in_use;                   /* Currently allocated */
+    uint32_t in_use_max;               /* High-water mark */
+    uint32_t allocs;                   /* Successful allocations served by this class */
+    uint32_t spills;                   /* Requests that fitted here but were served by a larger class */
+    uint32_t failures;                 /* Requests that fitted here but found every class empty */
+} Slab_ClassStats_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Create one block pool per size class
+ * @retval TX_SUCCESS on success, error code otherwise
+ */
+UINT Slab_Init(void);
+
+/**
+ * @brief Allocate a buffer (never blocks, callable from any thread)
+ * @param size: bytes needed
+ * @retval Pointer, or NULL if too large or every fitting class is empty
+ */
+void *Slab_Alloc(size_t size);
+
+/**
+ * @brief Release a buffer returned by Slab_Alloc()
+ * @param ptr: buffer
+ * @retval TX_SUCCESS, TX_PTR_ERROR if ptr is NULL or not an allocated slab block
+ *         (callers with a fallback allocator release it there instead)
+ */
+UINT Slab_Free(void *ptr);
+
+/**
+ * @brief Number of size classes
+ * @retval SLAB_CLASS_COUNT
+ */
+uint32_t Slab_GetClassCount(void);
+
+/**
+ * @brief Get statistics of one class
+ * @param index: class index (0 .. Slab_GetClassCount() - 1)
+ * @param stats: output
+ * @retval TX_SUCCESS, TX_PTR_ERROR on bad index
+ */
+UINT Slab_GetClassStats(uint32_t index, Slab_ClassStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SLAB_ALLOC_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,140 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    spsc_ring.h
+  * @author  Wind Turbine Team
+  * @brief   Lock-free single-producer/single-consumer ring for thread handoff
+  ******************************************************************************
+  * Replaces tx_queue for the pipeline stages (acquisition -> features ->
+  * telemetry). A tx_queue send/receive enters the kernel twice per message,
+  * disables interrupts and copies the message word by word, and cannot carry
+  * more than 16 words at all. The ring hands out slots instead:
+  *
+  *   producer: slot = SpscRing_Reserve(); fill slot; SpscRing_Commit();
+  *   consumer: slot = SpscRing_Peek(wait); use slot;  SpscRing_Release();
+  *
+  * Head and tail are free-running counters written by one side each and kept
+  * on separate cache lines. The kernel is only entered when the consumer has
+  * to sleep: the producer sets an event flag when a commit makes the ring
+  * non-empty, so a consumer that keeps up with a burst is woken once for it.
+  *
+  * Exactly one producer and one consumer context per ring. Either may be an
+  * ISR, except that SpscRing_Peek() with a wait option must be called from a
+  * thread.
+  */
+/* USER CODE END Header */
+
+#ifndef __SPSC_RING_H
+#define __SPSC_RING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define SPSC_RING_CACHE_LINE            32      /* DCACHE1 line; keeps head and tail apart */
+
+/* Storage for depth slots of slot_size bytes, for MemBudget_Allocate() or a static array */
+#define SPSC_RING_STORAGE_SIZE(slot_size, depth)    ((ULONG)(SPSC_RING_SLOT_SIZE(slot_size) * (depth)))
+#define SPSC_RING_SLOT_SIZE(slot_size)              (((ULONG)(slot_size) + 3U) & ~3UL)
+
+typedef struct
+{
+    /* Producer side */
+    volatile uint32_t      head __attribute__((aligned(SPSC_RING_CACHE_LINE)));
+    uint32_t               full_count;                 /* Reserve() found no free slot */
+
+    /* Consumer side */
+    volatile uint32_t      tail __attribute__((aligned(SPSC_RING_CACHE_LINE)));
+    uint32_t               wakeups;                    /* Times Peek() had to sleep */
+
+    /* Read-only after create */
+    uint8_t               *slots __attribute__((aligned(SPSC_RING_CACHE_LINE)));
+    uint32_t               slot_size;
+    uint32_t               mask;                       /* depth - 1 */
+    TX_EVENT_FLAGS_GROUP  *wake_group;                 /* data_ready or the consumer's own group */
+    ULONG                  wake_flag;
+    TX_EVENT_FLAGS_GROUP   data_ready;
+} SpscRing_t;
+
+typedef struct
+{
+    uint32_t depth;                    /* Slots */
+    uint32_t used;                     /* Committed, not yet released */
+    uint32_t full_count;               /* Reserve() failures (producer drops) */
+    uint32_t wakeups;                  /* Consumer sleeps that ended with data */
+} SpscRing_Stats_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Create a ring
+ * @param ring: ring control block
+ * @param name: event flags name
+ * @param storage: SPSC_RING_STORAGE_SIZE(slot_size, depth) bytes, word aligned
+ * @param slot_size: message size in bytes
+ * @param depth: number of slots, a power of two
+ * @retval TX_SUCCESS, TX_SIZE_ERROR for a bad depth, TX_PTR_ERROR
+ */
+UINT SpscRing_Create(SpscRing_t *ring, CHAR *name, VOID *storage, ULONG slot_size, ULONG depth);
+
+/**
+ * @brief Set the consumer's flag instead of the ring's own on the empty -> non-empty edge
+ * @param ring: ring
+ * @param group: consumer's event flags group
+ * @param flag: flag to set
+ * @retval None
+ * @note  Lets a consumer wait for the ring and other events at once; it must
+ *        then drain with SpscRing_Peek(ring, TX_NO_WAIT) until NULL before
+ *        waiting again. Call before the producer starts.
+ */
+void SpscRing_SetWakeup(SpscRing_t *ring, TX_EVENT_FLAGS_GROUP *group, ULONG flag);
+
+/**
+ * @brief Get the next free slot (producer)
+ * @param ring: ring
+ * @retval Slot to fill, or NULL if the ring is full
+ */
+VOID *SpscRing_Reserve(SpscRing_t *ring);
+
+/**
+ * @brief Publish the slot returned by SpscRing_Reserve() (producer)
+ * @param ring: ring
+ * @retval None
+ */
+void SpscRing_Commit(SpscRing_t *ring);
+
+/**
+ * @brief Get the oldest committed slot (consumer)
+ * @param ring: ring
+ * @param wait_option: TX_NO_WAIT, ticks or TX_WAIT_FOREVER
+ * @retval Slot, or NULL on timeout; valid until SpscRing_Release()
+ */
+VOID *SpscRing_Peek(SpscRing_t *ring, ULONG wait_option);
+
+/**
+ * @brief Hand the slot returned by SpscRing_Peek() back to the producer (consumer)
+ * @param ring: ring
+ * @retval None
+ */
+void SpscRing_Release(SpscRing_t *ring);
+
+/**
+ * @brief Get fill level and counters
+ * @param ring: ring
+ * @param stats: output
+ * @retval None
+ */
+void SpscRing_GetStats(const SpscRing_t *ring, SpscRing_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SPSC_RING_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,124 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    staging_log.h
+  * @author  Wind Turbine Team
+  * @brief   Log-structured staging buffer in front of SD card writes
+  ******************************************************************************
+  * Producers append records without locks and never block. A low-priority
+  * flusher thread drains the ring to a file on the SD card in large
+  * sector-aligned writes, so SD latency spikes (card-internal erase/GC) only
+  * raise the fill level instead of stalling the producers.
+  *
+  * Producers should check StagingLog_GetLevel() and decimate their own data
+  * when the card falls behind; a full ring drops the record and counts it.
+  */
+/* USER CODE END Header */
+
+#ifndef __STAGING_LOG_H
+#define __STAGING_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+#include "fx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+
+/**
+ * @brief Ring backing store
+ *
+ * With STAGING_LOG_USE_PSRAM the ring lives in the APS6408 PSRAM (OCTOSPI2,
+ * memory-mapped through the BSP_OSPI_RAM driver). Otherwise a smaller ring in
+ * internal SRAM is used. Both sizes must be powers of two.
+ */
+#ifndef STAGING_LOG_USE_PSRAM
+#define STAGING_LOG_USE_PSRAM           0
+#endif
+#define STAGING_LOG_PSRAM_BASE          OCTOSPI2_BASE
+#define STAGING_LOG_PSRAM_SIZE          (1024 * 1024)   /* 1 MB of the 8 MB device */
+#define STAGING_LOG_SRAM_SIZE           (16 * 1024)
+
+/**
+ * @brief Flusher configuration
+ */
+#define STAGING_LOG_THREAD_PRIORITY     14              /* Below all workers, above LED */
+#define STAGING_LOG_THREAD_STACK_SIZE   (2 * 1024)
+#define STAGING_LOG_CHUNK_SIZE          (8 * 1024)      /* SD write size, multiple of 512 */
+#define STAGING_LOG_POLL_MS             50              /* Ring poll period */
+#define STAGING_LOG_IDLE_FLUSH_MS       2000            /* Write partial chunk after this idle time */
+#define STAGING_LOG_FILE_NAME           "HISTORY.FHB"
+
+/**
+ * @brief Watermarks (percent of ring capacity)
+ */
+#define STAGING_LOG_HIGH_PERCENT        50
+#define STAGING_LOG_CRITICAL_PERCENT    85
+
+typedef enum
+{
+    STAGING_LOG_LEVEL_NORMAL = 0,      /* Keep full rate */
+    STAGING_LOG_LEVEL_HIGH,            /* Card falling behind, decimate */
+    STAGING_LOG_LEVEL_CRITICAL         /* Near full, keep only essential records */
+} StagingLog_Level_t;
+
+typedef struct
+{
+    uint32_t capacity;                 /* Ring size in bytes */
+    uint32_t fill;                     /* Bytes waiting to be written */
+    uint32_t fill_max;                 /* High-water mark since boot */
+    uint32_t appended_bytes;           /* Payload bytes accepted */
+    uint32_t dropped_records;          /* Records rejected because the ring was full */
+    uint32_t flushed_bytes;            /* Bytes written to the card */
+    uint32_t write_errors;             /* FileX write/flush failures */
+    uint32_t write_max_ms;             /* Slowest single SD write */
+} StagingLog_Stats_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Set up the ring and create the flusher thread (suspended)
+ * @param byte_pool: ThreadX byte pool for the thread stack
+ * @retval TX_SUCCESS on success, error code otherwise
+ */
+UINT StagingLog_Init(TX_BYTE_POOL *byte_pool);
+
+/**
+ * @brief Start draining to the SD card
+ * @param media: FileX media; the flusher waits until it is opened
+ * @retval TX_SUCCESS on success
+ */
+UINT StagingLog_Start(FX_MEDIA *media);
+
+/**
+ * @brief Append one record (lock-free, never blocks, callable from any thread)
+ * @param data: record payload
+ * @param len: payload length in bytes
+ * @retval TX_SUCCESS, TX_NO_MEMORY if the ring is full, TX_SIZE_ERROR if too large
+ */
+UINT StagingLog_Append(const void *data, uint32_t len);
+
+/**
+ * @brief Get current watermark level
+ * @retval StagingLog_Level_t
+ */
+StagingLog_Level_t StagingLog_GetLevel(void);
+
+/**
+ * @brief Get statistics snapshot
+ * @param stats: output
+ * @retval None
+ */
+void StagingLog_GetStats(StagingLog_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STAGING_LOG_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
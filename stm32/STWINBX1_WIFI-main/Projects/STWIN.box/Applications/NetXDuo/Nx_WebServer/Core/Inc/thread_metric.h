@@ -0,0 +1,139 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    thread_metric.h
+  * @author  Wind Turbine Team
+  * @brief   Thread-Metric RTOS benchmark runner
+  ******************************************************************************
+  * Runs the eight Thread-Metric tests from threadx/utility/benchmarks one
+  * after the other on the running system and keeps the score of each. The
+  * tests come unchanged from the middleware; tm_porting_layer.c maps the tm_*
+  * API onto ThreadX objects and deletes them between tests.
+  *
+  * A score is the number of test iterations completed in the measurement
+  * window (the "Time Period Total" of the original report threads), also
+  * given per second so runs of different length compare. Only relative
+  * changes mean something: compare a run against a baseline taken on the
+  * same platform (Tools/tmcompare.py), with one kernel option changed.
+  *
+  * The interrupt tests need a real interrupt: on the board TIM7 raises an
+  * update event and its handler calls ThreadMetric_IrqHandler(). The
+  * ThreadX Linux port emulates it with a pthread, like its timer interrupt
+  * (Tools/tm_porting_layer_linux.c).
+  *
+  * The test threads run at priorities 2..10 and the cooperative test keeps
+  * priority 3 busy, so the web server does not answer while that test runs.
+  * Each score is also printed on the UART when its test completes.
+  */
+/* USER CODE END Header */
+
+#ifndef __THREAD_METRIC_H
+#define __THREAD_METRIC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define THREAD_METRIC_DEFAULT_SECONDS   10      /* Measurement window per test */
+#define THREAD_METRIC_MAX_SECONDS       60
+#define THREAD_METRIC_WARMUP_SECONDS    1       /* Run before the window opens */
+#define THREAD_METRIC_PRIORITY          1       /* Above every test thread (2..10) */
+#define THREAD_METRIC_STACK_SIZE        2048
+#define THREAD_METRIC_REPORT_SIZE       1024    /* Report text, taken from the slab allocator */
+#define THREAD_METRIC_IRQ_PRIORITY      5       /* TIM7, within the ThreadX-managed range */
+
+#define TM_PORT_MAX_THREADS             6       /* Tests use thread ids 0..5 */
+#define TM_PORT_THREAD_STACK_SIZE       1024
+
+#ifdef THREAD_METRIC_HOST
+#define THREAD_METRIC_PLATFORM          "linux"
+#else
+#define THREAD_METRIC_PLATFORM          "stwin.box"
+#endif
+
+typedef enum
+{
+    THREAD_METRIC_STATE_IDLE = 0,      /* Never run */
+    THREAD_METRIC_STATE_RUNNING,       /* Scores fill in as tests complete */
+    THREAD_METRIC_STATE_DONE
+} ThreadMetric_State_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Create the runner thread and the benchmark interrupt
+ * @retval TX_SUCCESS on success, error code otherwise
+ */
+UINT ThreadMetric_Init(void);
+
+/**
+ * @brief Run all tests in the runner thread
+ * @param seconds: measurement window per test, clamped to 1..THREAD_METRIC_MAX_SECONDS
+ * @retval TX_SUCCESS, TX_NOT_AVAILABLE if a run is in progress
+ */
+UINT ThreadMetric_Start(ULONG seconds);
+
+/**
+ * @brief Get the runner state
+ * @retval ThreadMetric_State_t
+ */
+ThreadMetric_State_t ThreadMetric_GetState(void);
+
+/**
+ * @brief Format the last run as CSV lines
+ * @param buf: output buffer
+ * @param size: buffer size
+ * @retval Number of characters written (excluding terminator)
+ *
+ * Line formats:
+ *   run,<platform>,<idle|running|done>,<seconds>,<core_hz>
+ *   config,<kernel options, space separated, or "default">
+ *   test,<name>,<count>,<per_second>
+ * Tests not run yet are left out.
+ */
+uint32_t ThreadMetric_Format(char *buf, uint32_t size);
+
+/**
+ * @brief Benchmark interrupt body, called from the TIM7 handler / Linux ISR thread
+ * @retval None
+ */
+void ThreadMetric_IrqHandler(void);
+
+/* Porting layer (tm_porting_layer.c, Tools/tm_porting_layer_linux.c) --------*/
+
+/**
+ * @brief Set up the interrupt source used by the interrupt tests
+ * @retval TX_SUCCESS on success, error code otherwise
+ */
+UINT ThreadMetric_PortIrqInit(void);
+
+/**
+ * @brief Raise the benchmark interrupt
+ * @retval None
+ */
+void ThreadMetric_PortIrqRaise(void);
+
+/**
+ * @brief Acknowledge TIM7 and run the benchmark interrupt (board only)
+ * @retval None
+ */
+void ThreadMetric_TimerIRQHandler(void);
+
+/**
+ * @brief Delete every thread, queue, semaphore and pool a test created
+ * @retval None
+ */
+void ThreadMetric_PortReset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __THREAD_METRIC_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,191 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    timer_wheel.h
+  * @author  Wind Turbine Team
+  * @brief   Hierarchical timer wheel with slack-based coalescing
+  ******************************************************************************
+  * Every ThreadX timer that expires on a tick wakes the timer thread on that
+  * tick. Periodic application timers with unrelated phases therefore wake it
+  * on many different ticks. The wheel keeps its timers in four levels of 32
+  * slots (1, 32, 1024 and 32768 ticks per slot) and runs them from a single
+  * one-shot ThreadX timer, armed for the earliest expiry only. All timers due
+  * on that tick run in one batch.
+  *
+  * A timer may also give a slack: it fires somewhere in [deadline, deadline
+  * + slack], on the tick in that window that is a multiple of the largest
+  * power of two. Timers with overlapping windows then land on the same tick
+  * without knowing about each other, and periodic timers keep their nominal
+  * deadline, so the slack does not accumulate as drift.
+  *
+  * Callbacks run in the ThreadX timer thread, with the same restrictions as
+  * tx_timer callbacks. Timers may be started and stopped from threads,
+  * timer callbacks and interrupts.
+  */
+/* USER CODE END Header */
+
+#ifndef __TIMER_WHEEL_H
+#define __TIMER_WHEEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define TIMER_WHEEL_LEVEL_BITS          5
+#define TIMER_WHEEL_SLOTS               (1U << TIMER_WHEEL_LEVEL_BITS)
+#define TIMER_WHEEL_LEVELS              4       /* 2^20 ticks, longer timers are re-cascaded */
+#define TIMER_WHEEL_MAX_SLEEP           (TIMER_WHEEL_SLOTS * TIMER_WHEEL_SLOTS)  /* Ticks between driver wakeups at most */
+#define TIMER_WHEEL_REPORT_SIZE         512     /* Report text, taken from the slab allocator */
+
+#define TIMER_WHEEL_BENCH_MAX           160     /* Timers per benchmark phase */
+#define TIMER_WHEEL_BENCH_DEFAULT       128
+#define TIMER_WHEEL_BENCH_DEFAULT_SECONDS 5     /* Per phase, the benchmark runs two */
+#define TIMER_WHEEL_BENCH_MAX_SECONDS   30
+#define TIMER_WHEEL_BENCH_PRIORITY      12      /* Aperiodic, below RT_SCHED_PRIORITY_LOWEST */
+#define TIMER_WHEEL_BENCH_STACK_SIZE    1024
+
+/**
+ * @brief Default slack for a periodic timer: an eighth of the period
+ */
+#define TIMER_WHEEL_SLACK(period_ticks) ((period_ticks) / 8U)
+
+typedef void (*TimerWheel_Callback_t)(ULONG input);
+
+typedef enum
+{
+    TIMER_WHEEL_BENCH_IDLE = 0,        /* Never run */
+    TIMER_WHEEL_BENCH_RUNNING,         /* Phase lines fill in as phases complete */
+    TIMER_WHEEL_BENCH_DONE
+} TimerWheel_BenchState_t;
+
+/**
+ * @brief One timer; the fields are private to timer_wheel.c
+ */
+typedef struct TimerWheel_Timer_s
+{
+    struct TimerWheel_Timer_s *next;
+    struct TimerWheel_Timer_s *prev;
+    ULONG                  expires;            /* Tick it fires on, slack applied */
+    ULONG                  nominal;            /* Deadline without slack; periods count from here */
+    ULONG                  period;             /* 0 for one-shot */
+    ULONG                  slack;
+    TimerWheel_Callback_t  callback;
+    ULONG                  input;
+    const CHAR            *name;
+    uint16_t               slot;               /* List the timer is on, TIMER_WHEEL_NO_SLOT if stopped */
+} TimerWheel_Timer_t;
+
+typedef struct
+{
+    uint32_t active;                           /* Started timers */
+    uint32_t wakeups;                          /* Driver timer expirations */
+    uint32_t fired;                            /* Callbacks run */
+    uint32_t batch_max;                        /* Most callbacks in one wakeup */
+    uint32_t cascades;                         /* Timers moved down a level */
+    uint32_t late;                             /* Periodic timers that missed a whole period */
+} TimerWheel_Stats_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Create the driver timer (before any TimerWheel_Start)
+ * @retval TX_SUCCESS on success, error code otherwise
+ *
+ * Timers started during initialization are armed on the first tick.
+ */
+UINT TimerWheel_Init(void);
+
+/**
+ * @brief Set up a timer, stopped
+ * @param timer: timer storage, owned by the caller
+ * @param name: name shown in diagnostics
+ * @param callback: run in the timer thread
+ * @param input: passed to the callback
+ * @retval TX_SUCCESS or TX_PTR_ERROR
+ */
+UINT TimerWheel_Create(TimerWheel_Timer_t *timer, const CHAR *name,
+                       TimerWheel_Callback_t callback, ULONG input);
+
+/**
+ * @brief Start or restart a timer
+ * @param timer: created timer
+ * @param initial_ticks: ticks to the first deadline, at least 1
+ * @param period_ticks: ticks between deadlines, 0 for one-shot
+ * @param slack_ticks: how late the callback may run to share a wakeup
+ * @retval TX_SUCCESS, TX_PTR_ERROR, TX_TICK_ERROR or TX_NOT_AVAILABLE before TimerWheel_Init
+ */
+UINT TimerWheel_Start(TimerWheel_Timer_t *timer, ULONG initial_ticks,
+                      ULONG period_ticks, ULONG slack_ticks);
+
+/**
+ * @brief Stop a timer; its callback does not run after this returns
+ *        unless it is already running
+ * @param timer: created timer
+ * @retval None
+ */
+void TimerWheel_Stop(TimerWheel_Timer_t *timer);
+
+/**
+ * @brief Wheel counters
+ * @param stats: output
+ * @retval None
+ */
+void TimerWheel_GetStats(TimerWheel_Stats_t *stats);
+
+/**
+ * @brief Format the wheel counters as a CSV line
+ * @param buf: output buffer
+ * @param size: buffer size
+ * @retval Number of characters written (excluding terminator)
+ *
+ * Line format:
+ *   wheel,<active>,<wakeups>,<fired>,<batch_max>,<cascades>,<late>
+ */
+uint32_t TimerWheel_Format(char *buf, uint32_t size);
+
+/**
+ * @brief Create the benchmark runner thread (after MemBudget_Init)
+ * @retval TX_SUCCESS on success, error code otherwise
+ */
+UINT TimerWheel_BenchInit(void);
+
+/**
+ * @brief Run the same periodic timer set as tx_timers, then on the wheel,
+ *        in the runner thread
+ * @param count: timers per phase, clamped to 1..TIMER_WHEEL_BENCH_MAX
+ * @param seconds: phase length, clamped to 1..TIMER_WHEEL_BENCH_MAX_SECONDS
+ * @retval TX_SUCCESS, TX_NOT_AVAILABLE if a benchmark is in progress
+ */
+UINT TimerWheel_BenchStart(ULONG count, ULONG seconds);
+
+/**
+ * @brief Format the wheel counters and the last benchmark as CSV lines
+ * @param buf: output buffer
+ * @param size: buffer size
+ * @retval Number of characters written (excluding terminator)
+ *
+ * Line formats:
+ *   wheel,<active>,<wakeups>,<fired>,<batch_max>,<cascades>,<late>
+ *   run,<idle|running|done>,<timers>,<seconds>
+ *   bench,<tx_timer|wheel>,<timers>,<seconds>,<fired>,<wakeups>,
+ *         <fired_per_wakeup_x100>,<timer_thread_us>
+ * One bench line per completed phase.
+ *
+ * wakeups counts the ticks on which at least one benchmark timer fired;
+ * timer_thread_us is the timer thread CPU time over the phase (execution
+ * profile kit), including every other timer of the system.
+ */
+uint32_t TimerWheel_BenchFormat(char *buf, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIMER_WHEEL_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
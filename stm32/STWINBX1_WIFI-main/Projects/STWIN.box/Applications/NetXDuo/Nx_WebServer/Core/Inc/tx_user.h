@@ -112,6 +112,13 @@
 
 /*#define TX_DISABLE_STACK_FILLING*/
 
+/* Determine whether or not stack checking is enabled. By default, ThreadX stack checking is
+   disabled. When the following is defined, ThreadX thread stack checking is enabled and
+   tx_thread_stack_error_notify() reports overflows. The memory budget (mem_budget.c) relies
+   on it for the stack high-water marks.  */
+
+#define TX_ENABLE_STACK_CHECKING
+
 /* Determine if preemption-threshold should be disabled. By default, preemption-threshold is
    enabled. If the application does not use preemption-threshold, it may be disabled to reduce
    code size and improve performance.  */
@@ -145,7 +152,11 @@
    code size and overhead, but provides the ability to generate system trace information which
    is available for viewing in TraceX.  */
 
-/*#define TX_ENABLE_EVENT_TRACE*/
+/* Enabled for Core/Src/event_trace.c: captures start and stop over HTTP (GET /TraceStart),
+   so the only cost while idle is the enable test in each service call. Time stamps come from
+   the DWT cycle counter (TX_TRACE_TIME_SOURCE in tx_port.h). */
+
+#define TX_ENABLE_EVENT_TRACE
 
 /* Determine if block pool performance gathering is required by the application. When the following is
    defined, ThreadX gathers various block pool performance information. */
@@ -191,6 +202,16 @@
 
 /*#define TX_ENABLE_EXECUTION_CHANGE_NOTIFY*/
 
+/* Define per-thread execution profiling (threadx/utility/execution_profile_kit). The kit charges
+   DWT cycle counts to threads, ISRs and idle from the scheduler and the ISR entry/exit code.
+   Add tx_execution_profile.c and its directory to the build; the port .S files do not include
+   this file, so the port must also be assembled with -DTX_EXECUTION_PROFILE_ENABLE.
+   TX_CORTEX_M_EPK makes the kit track interrupt nesting itself, as Cortex-M has no context save.
+   The load table is built in Core/Src/cpu_load.c. */
+
+#define TX_EXECUTION_PROFILE_ENABLE
+#define TX_CORTEX_M_EPK
+
 /* Define the get system state macro. */
 
 /*#define TX_THREAD_GET_SYSTEM_STATE() _tx_thread_system_state */
@@ -205,6 +226,25 @@
 #define TX_TIMER_TICKS_PER_SECOND                1000
 #define TX_SYSTEM_CLOCK_HZ                       160000000
 
+/* Define low power idle. tx_low_power_enter/exit (threadx/utility/low_power/tx_low_power.c)
+   are called from the scheduler idle loop, which tests TX_LOW_POWER itself: tx_thread_schedule.S
+   does not include this file, so the port must also be assembled with -DTX_LOW_POWER.
+   TX_LOW_POWER_TICKLESS is left undefined so the ThreadX clock stays exact while idle.
+   The hooks are in Core/Src/low_power.c. */
+
+#define TX_LOW_POWER
+#define TX_LOW_POWER_TIMER_SETUP(ticks)          LowPower_TimerSetup(ticks)
+#define TX_LOW_POWER_USER_ENTER                  LowPower_Enter()
+#define TX_LOW_POWER_USER_EXIT                   LowPower_Exit()
+#define TX_LOW_POWER_USER_TIMER_ADJUST           LowPower_TimerAdjust()
+
+#ifndef __ASSEMBLER__
+void LowPower_TimerSetup(unsigned long ticks);
+void LowPower_Enter(void);
+void LowPower_Exit(void);
+unsigned long LowPower_TimerAdjust(void);
+#endif
+
 /* Determinate if the basic alignment type is defined. */
 
 /*#define ALIGN_TYPE_DEFINED*/
@@ -0,0 +1,193 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    asset_image.c
+  * @author  Wind Turbine Team
+  * @brief   Memory-mapped OSPI asset image (web files + DSP lookup tables)
+  ******************************************************************************
+  * The image is read in place through the OCTOSPI1 memory-mapped window.
+  * Once AssetImage_Init() succeeds the content is immutable, so lookups need
+  * no locking and can be done from any thread.
+  *
+  * OSPI access follows the same BSP_OSPI_NOR API as the LevelX glue. The board
+  * BSP for STWIN.box does not ship that driver, so it is compiled in only when
+  * ASSET_IMAGE_ENABLE is set; otherwise AssetImage_Init() reports
+  * TX_NOT_AVAILABLE and callers keep using the SD card and runtime trig.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "asset_image.h"
+#include "main.h"
+#include <string.h>
+
+#if (ASSET_IMAGE_ENABLE != 0)
+#include "b_u585i_iot02a_ospi.h"
+#endif
+
+/* Private defines -----------------------------------------------------------*/
+#define ASSET_IMAGE_OSPI_INSTANCE   0
+
+/* Private variables ---------------------------------------------------------*/
+static const AssetImage_Header_t *g_image_header = NULL;
+static const AssetImage_Entry_t  *g_image_index  = NULL;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t AssetImage_Crc32(const uint8_t *data, uint32_t length);
+static UINT AssetImage_Validate(const uint8_t *base);
+
+/**
+  * @brief  Enable OSPI memory-mapped mode and validate the image index
+  * @retval TX_SUCCESS on success, error code otherwise
+  */
+UINT AssetImage_Init(void)
+{
+#if (ASSET_IMAGE_ENABLE != 0)
+    BSP_OSPI_NOR_Init_t flash;
+    UINT status;
+
+    if (g_image_header)
+        return TX_SUCCESS;
+
+    flash.InterfaceMode = BSP_OSPI_NOR_OPI_MODE;
+    flash.TransferRate  = BSP_OSPI_NOR_DTR_TRANSFER;
+
+    if (BSP_OSPI_NOR_Init(ASSET_IMAGE_OSPI_INSTANCE, &flash) != BSP_ERROR_NONE)
+        return TX_NOT_AVAILABLE;
+
+    if (BSP_OSPI_NOR_EnableMemoryMappedMode(ASSET_IMAGE_OSPI_INSTANCE) != BSP_ERROR_NONE)
+        return TX_NOT_AVAILABLE;
+
+    status = AssetImage_Validate((const uint8_t *)ASSET_IMAGE_BASE_ADDR);
+    if (status != TX_SUCCESS)
+        return status;
+
+    return TX_SUCCESS;
+#else
+    return TX_NOT_AVAILABLE;
+#endif
+}
+
+/**
+  * @brief  Check whether a valid image is mapped
+  * @retval 1 if ready, 0 otherwise
+  */
+uint8_t AssetImage_IsReady(void)
+{
+    return (g_image_header != NULL) ? 1 : 0;
+}
+
+/**
+  * @brief  Look up an entry by name and type (binary search on sorted index)
+  * @param  name: entry name
+  * @param  type: ASSET_TYPE_xxx
+  * @param  size: optional output for payload size
+  * @retval Pointer to payload in mapped memory, NULL if not found
+  */
+const void* AssetImage_Find(const char *name, uint16_t type, uint32_t *size)
+{
+    int32_t low;
+    int32_t high;
+
+    if (!g_image_header || !name)
+        return NULL;
+
+    low = 0;
+    high = (int32_t)g_image_header->entry_count - 1;
+
+    while (low <= high)
+    {
+        int32_t mid = (low + high) / 2;
+        const AssetImage_Entry_t *entry = &g_image_index[mid];
+        int cmp = strncmp(name, entry->name, ASSET_IMAGE_NAME_MAX);
+
+        if (cmp == 0)
+        {
+            if (entry->type != type)
+                return NULL;
+
+            if (size)
+                *size = entry->size;
+
+            return (const uint8_t *)g_image_header + entry->offset;
+        }
+
+        if (cmp < 0)
+            high = mid - 1;
+        else
+            low = mid + 1;
+    }
+
+    return NULL;
+}
+
+/**
+  * @brief  Get number of entries in the mapped image
+  * @retval Entry count
+  */
+uint32_t AssetImage_GetEntryCount(void)
+{
+    return g_image_header ? g_image_header->entry_count : 0;
+}
+
+/**
+  * @brief  Validate header, index CRC and entry bounds of a mapped image
+  * @param  base: start of the mapped image
+  * @retval TX_SUCCESS if the image is usable
+  */
+static UINT AssetImage_Validate(const uint8_t *base)
+{
+    const AssetImage_Header_t *header = (const AssetImage_Header_t *)base;
+    const AssetImage_Entry_t *index = (const AssetImage_Entry_t *)(base + sizeof(AssetImage_Header_t));
+    uint32_t index_size;
+
+    if (header->magic != ASSET_IMAGE_MAGIC || header->version != ASSET_IMAGE_VERSION)
+        return TX_NOT_AVAILABLE;
+
+    if (header->image_size > ASSET_IMAGE_MAX_SIZE)
+        return TX_SIZE_ERROR;
+
+    index_size = (uint32_t)header->entry_count * sizeof(AssetImage_Entry_t);
+    if (sizeof(AssetImage_Header_t) + index_size > header->image_size)
+        return TX_SIZE_ERROR;
+
+    if (AssetImage_Crc32((const uint8_t *)index, index_size) != header->index_crc32)
+        return TX_NOT_AVAILABLE;
+
+    for (uint32_t i = 0; i < header->entry_count; i++)
+    {
+        if (index[i].name[ASSET_IMAGE_NAME_MAX - 1] != '\0')
+            return TX_NOT_AVAILABLE;
+
+        if (index[i].offset > header->image_size ||
+            index[i].size > header->image_size - index[i].offset)
+            return TX_SIZE_ERROR;
+    }
+
+    g_image_index  = index;
+    g_image_header = header;
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Bitwise CRC-32 (IEEE 802.3), only run once at init on the index
+  * @param  data: input buffer
+  * @param  length: number of bytes
+  * @retval CRC-32 value
+  */
+static uint32_t AssetImage_Crc32(const uint8_t *data, uint32_t length)
+{
+    uint32_t crc = 0xFFFFFFFFU;
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+    }
+
+    return ~crc;
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
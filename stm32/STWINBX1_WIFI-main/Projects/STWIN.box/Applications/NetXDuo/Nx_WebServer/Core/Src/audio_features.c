@@ -10,6 +10,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "audio_features.h"
+#include "asset_image.h"
 #include <math.h>
 #include <string.h>
 
@@ -20,16 +21,48 @@
 /* Reference pressure for SPL calculation (20 microPascals = 0 dB) */
 #define SPL_REF_PRESSURE  20e-6f
 
+/* Goertzel table: {2*cos(w), cos(w), sin(w)} for each bin below Nyquist */
+#define GOERTZEL_TABLE_STRIDE  3
+#define GOERTZEL_TABLE_BINS    (FFT_SIZE / 2)
+
+/* Precomputed tables from the OSPI asset image (NULL = compute at runtime) */
+static const float    *g_goertzel_table = NULL;
+static const uint16_t *g_band_map       = NULL;
+
 /**
   * @brief  Initialize audio feature extraction engine
   * @retval HAL status (0 = success)
+  *
+  * Binds the Goertzel coefficient table and band map from the memory-mapped
+  * asset image when available. Call after AssetImage_Init().
   */
 uint32_t AudioFeatures_Init(void)
 {
-    /* Feature extraction is purely software-based, no hardware init needed */
+    uint32_t size = 0;
+    const float *table;
+    const uint16_t *band_map;
+
+    table = (const float *)AssetImage_Find(ASSET_NAME_GOERTZEL_TABLE, ASSET_TYPE_TABLE_F32, &size);
+    if (table && size == GOERTZEL_TABLE_BINS * GOERTZEL_TABLE_STRIDE * sizeof(float))
+        g_goertzel_table = table;
+
+    band_map = (const uint16_t *)AssetImage_Find(ASSET_NAME_BAND_MAP, ASSET_TYPE_TABLE_U16, &size);
+    if (band_map && size == (FFT_BANDS + 1) * sizeof(uint16_t) &&
+        band_map[FFT_BANDS] <= GOERTZEL_TABLE_BINS)
+        g_band_map = band_map;
+
     return 0;
 }
 
+/**
+  * @brief  Check whether the FFT bands use precomputed tables
+  * @retval 1 if asset tables are bound, 0 otherwise
+  */
+uint8_t AudioFeatures_UsingAssetTables(void)
+{
+    return (g_goertzel_table != NULL) ? 1 : 0;
+}
+
 /**
   * @brief  Calculate RMS energy from PCM samples
   * @param  samples: pointer to int16_t PCM samples
@@ -44,16 +77,43 @@ uint16_t AudioFeatures_CalculateRMS(const int16_t *samples, uint32_t count)
     if (!samples || count == 0)
         return 0;
     
-    /* Use double accumulator to avoid overflow */
-    double sum = 0.0;
+    return AudioFeatures_RMSFromSumSquares(AudioFeatures_SumSquares(samples, count), count);
+}
+
+/**
+  * @brief  Sum of squared samples, the part of RMS that can be split by frame
+  * @param  samples: pointer to int16_t PCM samples
+  * @param  count: number of samples
+  * @retval Sum of x[n]^2 (exact: 2^30 per sample, fits for any packet size)
+  */
+uint64_t AudioFeatures_SumSquares(const int16_t *samples, uint32_t count)
+{
+    uint64_t sum = 0;
+    
+    if (!samples)
+        return 0;
     
     for (uint32_t i = 0; i < count; i++)
     {
         int32_t s = (int32_t)samples[i];
-        sum += (double)s * s;
+        sum += (uint64_t)(s * s);
     }
     
-    double rms = sqrt(sum / (double)count);
+    return sum;
+}
+
+/**
+  * @brief  RMS from a sum of squares
+  * @param  sum_squares: AudioFeatures_SumSquares() total over count samples
+  * @param  count: number of samples
+  * @retval RMS value in Q15 format (0-32767)
+  */
+uint16_t AudioFeatures_RMSFromSumSquares(uint64_t sum_squares, uint32_t count)
+{
+    if (count == 0)
+        return 0;
+    
+    double rms = sqrt((double)sum_squares / (double)count);
     
     /* Normalize to Q15: divide by max sample value (32768) */
     double normalized_rms = rms / 32768.0;
@@ -80,8 +140,47 @@ uint16_t AudioFeatures_CalculateZCR(const int16_t *samples, uint32_t count)
     if (!samples || count < 2)
         return 0;
     
+    return AudioFeatures_ZCRFromCrossings(AudioFeatures_CountZeroCrossings(samples, count), count);
+}
+
+/**
+  * @brief  ZCR from a zero crossing count
+  * @param  zero_crossings: AudioFeatures_CountZeroCrossings() total over count samples
+  * @param  count: number of samples
+  * @retval ZCR as percentage of Nyquist rate (0-100)
+  */
+uint16_t AudioFeatures_ZCRFromCrossings(uint32_t zero_crossings, uint32_t count)
+{
+    if (count < 2)
+        return 0;
+    
+    /* Normalize: max ZCR is ~0.5 for white noise (one crossing per 2 samples) */
+    /* Express as percentage of Nyquist (100 = sample rate / 2) */
+    uint16_t zcr_percent = (uint16_t)((zero_crossings * 100) / count);
+    
+    /* Clamp to 100% */
+    if (zcr_percent > 100)
+        zcr_percent = 100;
+    
+    return zcr_percent;
+}
+
+/**
+  * @brief  Count sign changes between consecutive samples
+  * @param  samples: pointer to int16_t PCM samples
+  * @param  count: number of samples
+  * @retval Zero crossings
+  *
+  * To split a buffer, start each piece one sample early so the crossing
+  * at the boundary is counted exactly once.
+  */
+uint32_t AudioFeatures_CountZeroCrossings(const int16_t *samples, uint32_t count)
+{
     uint32_t zero_crossings = 0;
     
+    if (!samples)
+        return 0;
+    
     for (uint32_t i = 1; i < count; i++)
     {
         /* Check for sign change between consecutive samples */
@@ -92,15 +191,7 @@ uint16_t AudioFeatures_CalculateZCR(const int16_t *samples, uint32_t count)
         }
     }
     
-    /* Normalize: max ZCR is ~0.5 for white noise (one crossing per 2 samples) */
-    /* Express as percentage of Nyquist (100 = sample rate / 2) */
-    uint16_t zcr_percent = (uint16_t)((zero_crossings * 100) / count);
-    
-    /* Clamp to 100% */
-    if (zcr_percent > 100)
-        zcr_percent = 100;
-    
-    return zcr_percent;
+    return zero_crossings;
 }
 
 /**
@@ -176,8 +267,23 @@ int AudioFeatures_ComputeFFTBands(const int16_t *samples, uint32_t *bands)
     if (!samples || !bands)
         return -1;
     
-    /* Initialize band magnitudes to zero */
-    memset(bands, 0, FFT_BANDS * sizeof(uint32_t));
+    /* Goertzel algorithm: compute magnitude for each band */
+    for (uint32_t band = 0; band < FFT_BANDS; band++)
+        bands[band] = AudioFeatures_ComputeFFTBand(samples, band);
+    
+    return 0;
+}
+
+/**
+  * @brief  Magnitude of one band; bands are independent of each other
+  * @param  samples: pointer to int16_t PCM samples (FFT_SIZE required)
+  * @param  band: 0 .. FFT_BANDS-1
+  * @retval Band magnitude (0-1000000), 0 for a bad argument
+  */
+uint32_t AudioFeatures_ComputeFFTBand(const int16_t *samples, uint32_t band)
+{
+    if (!samples || band >= FFT_BANDS)
+        return 0;
     
     /* 
      * Simplified band allocation (for 512 FFT @ 16kHz):
@@ -193,49 +299,64 @@ int AudioFeatures_ComputeFFTBands(const int16_t *samples, uint32_t *bands)
     const uint32_t BAND_WIDTH = 1000;  /* 1 kHz per band */
     const uint32_t bins_per_band = BAND_WIDTH / bin_width;  /* ~32 bins per band */
     
-    /* Goertzel algorithm: compute magnitude for each band */
-    for (int band = 0; band < FFT_BANDS; band++)
+    uint32_t magnitude = 0;
+    uint32_t bin_start = band * bins_per_band;
+    uint32_t bin_end = (band + 1) * bins_per_band;
+    
+    if (g_band_map)
     {
-        uint32_t magnitude = 0;
-    uint32_t bin_start = (uint32_t)band * bins_per_band;
-    uint32_t bin_end = (uint32_t)(band + 1) * bins_per_band;
-        
-        if (bin_end > FFT_SIZE / 2)
-            bin_end = FFT_SIZE / 2;  /* Nyquist limit */
+        bin_start = g_band_map[band];
+        bin_end = g_band_map[band + 1];
+    }
+    
+    if (bin_end > FFT_SIZE / 2)
+        bin_end = FFT_SIZE / 2;  /* Nyquist limit */
+    
+    /* Simplified: sum energy in frequency bin range */
+    double band_energy = 0.0;
+    for (uint32_t k = bin_start; k < bin_end && k < FFT_SIZE / 2; k++)
+    {
+        double coeff, cos_w, sin_w;
         
-        /* Simplified: sum energy in frequency bin range */
-        double band_energy = 0.0;
-        for (uint32_t k = bin_start; k < bin_end && k < FFT_SIZE / 2; k++)
+        if (g_goertzel_table)
+        {
+            /* Coefficients read in place from memory-mapped OSPI */
+            const float *entry = &g_goertzel_table[k * GOERTZEL_TABLE_STRIDE];
+            coeff = entry[0];
+            cos_w = entry[1];
+            sin_w = entry[2];
+        }
+        else
         {
             /* Simplified Goertzel coefficient (real implementation uses complex math) */
             double freq = (double)k * (double)bin_width;
             double omega = 2.0 * M_PI * freq / SAMPLE_RATE;
-            
-            double s_prev = 0.0, s_curr = 0.0, s_next = 0.0;
-            double coeff = 2.0 * cos(omega);
-            
-            for (uint32_t n = 0; n < FFT_SIZE; n++)
-            {
-                s_next = (double)samples[n] + coeff * s_curr - s_prev;
-                s_prev = s_curr;
-                s_curr = s_next;
-            }
-            
-            /* Magnitude squared */
-            double real = s_curr - s_prev * cos(omega);
-            double imag = s_prev * sin(omega);
-            band_energy += (real * real + imag * imag);
+            cos_w = cos(omega);
+            sin_w = sin(omega);
+            coeff = 2.0 * cos_w;
         }
         
-        /* Normalize and scale (0-1000000 range) */
-        magnitude = (uint32_t)(sqrt(band_energy) / 1000.0);
-        if (magnitude > 1000000)
-            magnitude = 1000000;
+        double s_prev = 0.0, s_curr = 0.0, s_next = 0.0;
         
-        bands[band] = magnitude;
+        for (uint32_t n = 0; n < FFT_SIZE; n++)
+        {
+            s_next = (double)samples[n] + coeff * s_curr - s_prev;
+            s_prev = s_curr;
+            s_curr = s_next;
+        }
+        
+        /* Magnitude squared */
+        double real = s_curr - s_prev * cos_w;
+        double imag = s_prev * sin_w;
+        band_energy += (real * real + imag * imag);
     }
     
-    return 0;
+    /* Normalize and scale (0-1000000 range) */
+    magnitude = (uint32_t)(sqrt(band_energy) / 1000.0);
+    if (magnitude > 1000000)
+        magnitude = 1000000;
+    
+    return magnitude;
 }
 
 /************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
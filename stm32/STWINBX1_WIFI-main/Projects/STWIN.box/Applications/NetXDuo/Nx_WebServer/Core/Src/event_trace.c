@@ -0,0 +1,173 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    event_trace.c
+  * @author  Wind Turbine Team
+  * @brief   ThreadX event trace capture into a RAM ring buffer
+  ******************************************************************************
+  * tx_trace_enable() registers every object that already exists, so a
+  * capture started long after boot still has the thread and queue names.
+  * tx_trace_disable() only stops the inserts; the header keeps the position
+  * of the oldest entry, which is what the host converter needs to unwrap the
+  * ring.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "event_trace.h"
+#include "mem_budget.h"
+#include "stm32u5xx.h"
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    EventTrace_State_t     state;
+    uint32_t               frame_drops;
+    uint32_t               captures;
+} EventTrace_Context_t;
+
+/* Private variables ---------------------------------------------------------*/
+static EventTrace_Context_t trace_ctx = {0};
+
+/* TraceX image: control header, object registry, event ring */
+static ULONG trace_buffer[EVENT_TRACE_BUFFER_SIZE / sizeof(ULONG)];
+
+/* Private function prototypes -----------------------------------------------*/
+static void EventTrace_Freeze(void);
+
+/**
+  * @brief  Start the DWT cycle counter used as trace time stamp
+  * @retval TX_SUCCESS or TX_FEATURE_NOT_ENABLED
+  */
+UINT EventTrace_Init(void)
+{
+#ifdef TX_ENABLE_EVENT_TRACE
+    MemBudget_RegisterStatic("event_trace", "trace buffer", sizeof(trace_buffer));
+
+    /* TX_TRACE_TIME_SOURCE reads CYCCNT (tx_port.h), which is off until enabled */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    return TX_SUCCESS;
+#else
+    return TX_FEATURE_NOT_ENABLED;
+#endif
+}
+
+/**
+  * @brief  Start a new capture
+  * @param  freeze_on_drop: TX_TRUE to freeze on the next frame drop
+  * @retval tx_trace_enable() status
+  */
+UINT EventTrace_Start(UINT freeze_on_drop)
+{
+#ifdef TX_ENABLE_EVENT_TRACE
+    UINT status;
+
+    /* tx_trace_enable() refuses to restart a running capture */
+    (void)tx_trace_disable();
+
+    status = tx_trace_enable(trace_buffer, sizeof(trace_buffer), EVENT_TRACE_REGISTRY_ENTRIES);
+    if (status != TX_SUCCESS)
+    {
+        trace_ctx.state = EVENT_TRACE_STATE_OFF;
+        return status;
+    }
+
+    trace_ctx.frame_drops = 0;
+    trace_ctx.captures++;
+    trace_ctx.state = freeze_on_drop ? EVENT_TRACE_STATE_ARMED : EVENT_TRACE_STATE_RUNNING;
+
+    return TX_SUCCESS;
+#else
+    (void)freeze_on_drop;
+    return TX_FEATURE_NOT_ENABLED;
+#endif
+}
+
+/**
+  * @brief  Stop recording and keep the buffer for download
+  * @retval TX_SUCCESS
+  */
+UINT EventTrace_Stop(void)
+{
+    EventTrace_Freeze();
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Record a dropped audio frame; freezes an armed capture
+  * @param  frame_number: frame that was dropped
+  * @retval None
+  */
+void EventTrace_FrameDrop(uint32_t frame_number)
+{
+#ifdef TX_ENABLE_EVENT_TRACE
+    if (trace_ctx.state != EVENT_TRACE_STATE_RUNNING && trace_ctx.state != EVENT_TRACE_STATE_ARMED)
+        return;
+
+    trace_ctx.frame_drops++;
+    (void)tx_trace_user_event_insert(EVENT_TRACE_EVENT_FRAME_DROP, frame_number, 0, 0, 0);
+
+    if (trace_ctx.state == EVENT_TRACE_STATE_ARMED)
+        EventTrace_Freeze();
+#else
+    (void)frame_number;
+#endif
+}
+
+/**
+  * @brief  Freeze the capture and return the TraceX image
+  * @param  size: receives the image size
+  * @retval Trace buffer
+  */
+const UCHAR *EventTrace_GetBuffer(ULONG *size)
+{
+    EventTrace_Freeze();
+
+    *size = (trace_ctx.state == EVENT_TRACE_STATE_FROZEN) ? sizeof(trace_buffer) : 0U;
+    return (const UCHAR *)trace_buffer;
+}
+
+/**
+  * @brief  Get capture state and counters
+  * @param  stats: output
+  * @retval None
+  */
+void EventTrace_GetStats(EventTrace_Stats_t *stats)
+{
+    if (!stats)
+        return;
+
+    stats->state = (uint32_t)trace_ctx.state;
+    stats->buffer_size = sizeof(trace_buffer);
+    stats->frame_drops = trace_ctx.frame_drops;
+    stats->captures = trace_ctx.captures;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Stop a running or armed capture
+  * @retval None
+  */
+static void EventTrace_Freeze(void)
+{
+#ifdef TX_ENABLE_EVENT_TRACE
+    EventTrace_State_t previous;
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    previous = trace_ctx.state;
+    if (previous == EVENT_TRACE_STATE_RUNNING || previous == EVENT_TRACE_STATE_ARMED)
+    {
+        (void)tx_trace_user_event_insert(EVENT_TRACE_EVENT_FROZEN, (ULONG)previous, 0, 0, 0);
+        (void)tx_trace_disable();
+        trace_ctx.state = EVENT_TRACE_STATE_FROZEN;
+    }
+    TX_RESTORE
+#endif
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,560 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    feature_history.c
+  * @author  Wind Turbine Team
+  * @brief   Columnar compressed block codec for AudioTelemetryPacket_t history
+  ******************************************************************************
+  * Encoding per column (see feature_history.h for the column order):
+  *
+  * Delta-of-delta columns, first value stored raw, then per record:
+  *   '0'                      dod == 0
+  *   '10'   + 7 bits          dod in [-63, 64]
+  *   '110'  + 9 bits          dod in [-255, 256]
+  *   '1110' + 12 bits         dod in [-2047, 2048]
+  *   '1111' + 32 bits         anything else
+  *
+  * XOR columns, previous value starts at 0, per record:
+  *   '0'                      same as previous value
+  *   '10' + meaningful bits   XOR fits in the previous leading/trailing window
+  *   '11' + 5 bits leading zeros + 5 bits (length - 1) + meaningful bits
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "feature_history.h"
+#include <stddef.h>
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define FH_COLUMN_DOD      0
+#define FH_COLUMN_XOR      1
+
+#define FH_NO_WINDOW       0xFF
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    uint8_t  offset;               /* Offset in AudioTelemetryPacket_t */
+    uint8_t  width;                /* Field width in bytes (1, 2 or 4) */
+    uint8_t  kind;                 /* FH_COLUMN_xxx */
+} FH_Column_t;
+
+typedef struct
+{
+    uint8_t  *buf;
+    uint32_t  size;                /* Buffer size in bytes */
+    uint32_t  bit_pos;
+    uint8_t   overflow;
+} FH_BitWriter_t;
+
+typedef struct
+{
+    const uint8_t *buf;
+    uint32_t       size;           /* Buffer size in bytes */
+    uint32_t       bit_pos;
+    uint8_t        error;
+} FH_BitReader_t;
+
+/* Private variables ---------------------------------------------------------*/
+
+#define FH_FIELD(field)    offsetof(AudioTelemetryPacket_t, field)
+#define FH_BAND(n)         (FH_FIELD(fft_band) + (n) * sizeof(uint32_t))
+
+static const FH_Column_t fh_columns[] =
+{
+    { FH_FIELD(timestamp_ms),   4, FH_COLUMN_DOD },
+    { FH_FIELD(seq_number),     2, FH_COLUMN_DOD },
+    { FH_FIELD(uptime_sec),     4, FH_COLUMN_DOD },
+    { FH_FIELD(rms_raw),        2, FH_COLUMN_XOR },
+    { FH_FIELD(zcr_count),      2, FH_COLUMN_XOR },
+    { FH_FIELD(zcr_rate),       2, FH_COLUMN_XOR },
+    { FH_FIELD(spl_db),         2, FH_COLUMN_XOR },
+    { FH_FIELD(peak_amplitude), 2, FH_COLUMN_XOR },
+    { FH_BAND(0),               4, FH_COLUMN_XOR },
+    { FH_BAND(1),               4, FH_COLUMN_XOR },
+    { FH_BAND(2),               4, FH_COLUMN_XOR },
+    { FH_BAND(3),               4, FH_COLUMN_XOR },
+    { FH_BAND(4),               4, FH_COLUMN_XOR },
+    { FH_BAND(5),               4, FH_COLUMN_XOR },
+    { FH_BAND(6),               4, FH_COLUMN_XOR },
+    { FH_BAND(7),               4, FH_COLUMN_XOR },
+    { FH_FIELD(status_flags),   1, FH_COLUMN_XOR },
+    { FH_FIELD(error_count),    2, FH_COLUMN_XOR },
+};
+
+#define FH_COLUMN_COUNT    (sizeof(fh_columns) / sizeof(fh_columns[0]))
+
+/* Private function prototypes -----------------------------------------------*/
+static void     FH_PutBits(FH_BitWriter_t *w, uint32_t value, uint8_t nbits);
+static uint32_t FH_GetBits(FH_BitReader_t *r, uint8_t nbits);
+static uint32_t FH_ReadField(const AudioTelemetryPacket_t *pkt, const FH_Column_t *col);
+static void     FH_WriteField(AudioTelemetryPacket_t *pkt, const FH_Column_t *col, uint32_t value);
+static void     FH_EncodeDod(FH_BitWriter_t *w, int32_t dod);
+static int32_t  FH_DecodeDod(FH_BitReader_t *r);
+static uint8_t  FH_Clz32(uint32_t v);
+static uint8_t  FH_Ctz32(uint32_t v);
+
+/**
+  * @brief  Reset encoder
+  * @param  enc: encoder state
+  */
+void FeatureHistory_EncoderReset(FeatureHistory_Encoder_t *enc)
+{
+    if (enc)
+        enc->count = 0;
+}
+
+/**
+  * @brief  Stage one packet
+  * @param  enc: encoder state
+  * @param  pkt: packet to add
+  * @retval 1 if the block is full and must be flushed
+  */
+uint8_t FeatureHistory_EncoderAdd(FeatureHistory_Encoder_t *enc, const AudioTelemetryPacket_t *pkt)
+{
+    if (!enc || !pkt)
+        return 0;
+
+    if (enc->count < FEATURE_HISTORY_BLOCK_RECORDS)
+        memcpy(&enc->records[enc->count++], pkt, sizeof(*pkt));
+
+    return (enc->count >= FEATURE_HISTORY_BLOCK_RECORDS) ? 1 : 0;
+}
+
+/**
+  * @brief  Encode staged packets into one block
+  * @param  enc: encoder state
+  * @param  out: output buffer
+  * @param  out_size: output buffer size
+  * @retval Block size in bytes, 0 on error
+  */
+uint32_t FeatureHistory_EncoderFlush(FeatureHistory_Encoder_t *enc, uint8_t *out, uint32_t out_size)
+{
+    FeatureHistory_BlockHeader_t hdr;
+    FH_BitWriter_t w;
+    uint32_t raw_len;
+    uint32_t payload_len;
+
+    if (!enc || !out || enc->count == 0)
+        return 0;
+
+    if (out_size < sizeof(hdr))
+        return 0;
+
+    /* Header: constants and min/max summary */
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = FEATURE_HISTORY_MAGIC;
+    hdr.version = FEATURE_HISTORY_VERSION;
+    hdr.count = (uint8_t)enc->count;
+    hdr.node_id = enc->records[0].node_id;
+    hdr.packet_version = enc->records[0].version;
+    hdr.first_ts = enc->records[0].timestamp_ms;
+    hdr.last_ts = enc->records[enc->count - 1].timestamp_ms;
+    hdr.spl_min = 0xFFFF;
+    hdr.rms_min = 0xFFFF;
+
+    for (uint32_t i = 0; i < enc->count; i++)
+    {
+        const AudioTelemetryPacket_t *p = &enc->records[i];
+
+        hdr.status_or |= p->status_flags;
+        if (p->spl_db < hdr.spl_min)         hdr.spl_min = p->spl_db;
+        if (p->spl_db > hdr.spl_max)         hdr.spl_max = p->spl_db;
+        if (p->rms_raw < hdr.rms_min)        hdr.rms_min = p->rms_raw;
+        if (p->rms_raw > hdr.rms_max)        hdr.rms_max = p->rms_raw;
+        if (p->peak_amplitude > hdr.peak_max) hdr.peak_max = p->peak_amplitude;
+
+        for (int b = 0; b < FFT_BANDS; b++)
+        {
+            if (p->fft_band[b] > hdr.band_max)
+                hdr.band_max = p->fft_band[b];
+        }
+    }
+
+    /* Payload: one column after the other */
+    w.buf = out + sizeof(hdr);
+    w.size = out_size - sizeof(hdr);
+    w.bit_pos = 0;
+    w.overflow = 0;
+
+    for (uint32_t c = 0; c < FH_COLUMN_COUNT && !w.overflow; c++)
+    {
+        const FH_Column_t *col = &fh_columns[c];
+        uint32_t mask = (col->width == 4) ? 0xFFFFFFFFU : ((1U << (col->width * 8)) - 1U);
+        uint32_t prev = FH_ReadField(&enc->records[0], col);
+
+        if (col->kind == FH_COLUMN_DOD)
+        {
+            int32_t prev_delta = 0;
+            uint8_t shift = (uint8_t)(32 - col->width * 8);
+
+            FH_PutBits(&w, prev, (uint8_t)(col->width * 8));
+
+            for (uint32_t i = 1; i < enc->count; i++)
+            {
+                uint32_t cur = FH_ReadField(&enc->records[i], col);
+                /* Modular delta, sign-extended from the field width */
+                int32_t delta = (int32_t)(((cur - prev) & mask) << shift) >> shift;
+
+                FH_EncodeDod(&w, delta - prev_delta);
+                prev_delta = delta;
+                prev = cur;
+            }
+        }
+        else
+        {
+            uint8_t win_lead = FH_NO_WINDOW;
+            uint8_t win_trail = 0;
+
+            prev = 0;
+            for (uint32_t i = 0; i < enc->count; i++)
+            {
+                uint32_t cur = FH_ReadField(&enc->records[i], col);
+                uint32_t x = cur ^ prev;
+
+                if (x == 0)
+                {
+                    FH_PutBits(&w, 0, 1);
+                }
+                else
+                {
+                    uint8_t lead = FH_Clz32(x);
+                    uint8_t trail = FH_Ctz32(x);
+
+                    if (lead > 31)
+                        lead = 31;
+
+                    if (win_lead != FH_NO_WINDOW && lead >= win_lead && trail >= win_trail)
+                    {
+                        FH_PutBits(&w, 0x2, 2);
+                        FH_PutBits(&w, x >> win_trail, (uint8_t)(32 - win_lead - win_trail));
+                    }
+                    else
+                    {
+                        uint8_t len = (uint8_t)(32 - lead - trail);
+
+                        FH_PutBits(&w, 0x3, 2);
+                        FH_PutBits(&w, lead, 5);
+                        FH_PutBits(&w, (uint32_t)(len - 1), 5);
+                        FH_PutBits(&w, x >> trail, len);
+                        win_lead = lead;
+                        win_trail = trail;
+                    }
+                }
+                prev = cur;
+            }
+        }
+    }
+
+    payload_len = (w.bit_pos + 7) / 8;
+    raw_len = enc->count * sizeof(AudioTelemetryPacket_t);
+
+    /* Fall back to raw records if compression does not pay off */
+    if (w.overflow || payload_len >= raw_len)
+    {
+        if (out_size < sizeof(hdr) + raw_len)
+        {
+            enc->count = 0;
+            return 0;
+        }
+        memcpy(out + sizeof(hdr), enc->records, raw_len);
+        hdr.flags |= FEATURE_HISTORY_FLAG_RAW;
+        payload_len = raw_len;
+    }
+
+    hdr.payload_len = (uint16_t)payload_len;
+    memcpy(out, &hdr, sizeof(hdr));
+
+    enc->count = 0;
+    return sizeof(hdr) + payload_len;
+}
+
+/**
+  * @brief  Validate a block header and return the total block size
+  * @param  block: start of block
+  * @param  len: available bytes
+  * @retval Block size in bytes, 0 if invalid
+  */
+uint32_t FeatureHistory_BlockSize(const uint8_t *block, uint32_t len)
+{
+    FeatureHistory_BlockHeader_t hdr;
+
+    if (!block || len < sizeof(hdr))
+        return 0;
+
+    memcpy(&hdr, block, sizeof(hdr));
+
+    if (hdr.magic != FEATURE_HISTORY_MAGIC || hdr.version != FEATURE_HISTORY_VERSION)
+        return 0;
+
+    if (hdr.count == 0 || hdr.count > FEATURE_HISTORY_BLOCK_RECORDS)
+        return 0;
+
+    if (sizeof(hdr) + hdr.payload_len > len)
+        return 0;
+
+    return sizeof(hdr) + hdr.payload_len;
+}
+
+/**
+  * @brief  Decode a block
+  * @param  block: start of block
+  * @param  len: available bytes
+  * @param  out: output records
+  * @param  max_out: capacity of out
+  * @retval Number of records decoded, -1 on error
+  */
+int FeatureHistory_DecodeBlock(const uint8_t *block, uint32_t len,
+                               AudioTelemetryPacket_t *out, uint32_t max_out)
+{
+    FeatureHistory_BlockHeader_t hdr;
+    FH_BitReader_t r;
+
+    if (!out || FeatureHistory_BlockSize(block, len) == 0)
+        return -1;
+
+    memcpy(&hdr, block, sizeof(hdr));
+
+    if (hdr.count > max_out)
+        return -1;
+
+    if (hdr.flags & FEATURE_HISTORY_FLAG_RAW)
+    {
+        if (hdr.payload_len != hdr.count * sizeof(AudioTelemetryPacket_t))
+            return -1;
+        memcpy(out, block + sizeof(hdr), hdr.payload_len);
+        return hdr.count;
+    }
+
+    memset(out, 0, hdr.count * sizeof(AudioTelemetryPacket_t));
+    for (uint32_t i = 0; i < hdr.count; i++)
+    {
+        out[i].version = hdr.packet_version;
+        out[i].node_id = hdr.node_id;
+    }
+
+    r.buf = block + sizeof(hdr);
+    r.size = hdr.payload_len;
+    r.bit_pos = 0;
+    r.error = 0;
+
+    for (uint32_t c = 0; c < FH_COLUMN_COUNT && !r.error; c++)
+    {
+        const FH_Column_t *col = &fh_columns[c];
+        uint32_t mask = (col->width == 4) ? 0xFFFFFFFFU : ((1U << (col->width * 8)) - 1U);
+
+        if (col->kind == FH_COLUMN_DOD)
+        {
+            int32_t delta = 0;
+            uint32_t prev = FH_GetBits(&r, (uint8_t)(col->width * 8));
+
+            FH_WriteField(&out[0], col, prev);
+
+            for (uint32_t i = 1; i < hdr.count; i++)
+            {
+                delta += FH_DecodeDod(&r);
+                prev = (prev + (uint32_t)delta) & mask;
+                FH_WriteField(&out[i], col, prev);
+            }
+        }
+        else
+        {
+            uint8_t win_lead = FH_NO_WINDOW;
+            uint8_t win_trail = 0;
+            uint32_t prev = 0;
+
+            for (uint32_t i = 0; i < hdr.count; i++)
+            {
+                if (FH_GetBits(&r, 1) != 0)
+                {
+                    if (FH_GetBits(&r, 1) == 0)
+                    {
+                        if (win_lead == FH_NO_WINDOW)
+                            return -1;
+                        prev ^= FH_GetBits(&r, (uint8_t)(32 - win_lead - win_trail)) << win_trail;
+                    }
+                    else
+                    {
+                        uint8_t lead = (uint8_t)FH_GetBits(&r, 5);
+                        uint8_t mlen = (uint8_t)(FH_GetBits(&r, 5) + 1);
+
+                        if (lead + mlen > 32)
+                            return -1;
+                        win_lead = lead;
+                        win_trail = (uint8_t)(32 - lead - mlen);
+                        prev ^= FH_GetBits(&r, mlen) << win_trail;
+                    }
+                }
+                FH_WriteField(&out[i], col, prev & mask);
+            }
+        }
+    }
+
+    return r.error ? -1 : (int)hdr.count;
+}
+
+/**
+  * @brief  Check from the header whether a block can hold matching records
+  * @retval 1 if the block must be decoded, 0 if it can be skipped
+  */
+uint8_t FeatureHistory_BlockMayMatch(const FeatureHistory_BlockHeader_t *hdr,
+                                     uint32_t from_ms, uint32_t to_ms, uint16_t spl_min)
+{
+    if (!hdr)
+        return 0;
+
+    if (hdr->last_ts < from_ms || hdr->first_ts > to_ms)
+        return 0;
+
+    if (spl_min != 0 && hdr->spl_max < spl_min)
+        return 0;
+
+    return 1;
+}
+
+/**
+  * @brief  Append nbits (<= 32) of value, MSB first
+  */
+static void FH_PutBits(FH_BitWriter_t *w, uint32_t value, uint8_t nbits)
+{
+    while (nbits > 0)
+    {
+        uint32_t byte = w->bit_pos >> 3;
+        uint8_t  free_bits = (uint8_t)(8 - (w->bit_pos & 7));
+        uint8_t  take = (nbits < free_bits) ? nbits : free_bits;
+        uint8_t  chunk = (uint8_t)((value >> (nbits - take)) & ((1U << take) - 1U));
+
+        if (byte >= w->size)
+        {
+            w->overflow = 1;
+            return;
+        }
+
+        if (free_bits == 8)
+            w->buf[byte] = 0;
+
+        w->buf[byte] |= (uint8_t)(chunk << (free_bits - take));
+        w->bit_pos += take;
+        nbits -= take;
+    }
+}
+
+/**
+  * @brief  Read nbits (<= 32), MSB first
+  */
+static uint32_t FH_GetBits(FH_BitReader_t *r, uint8_t nbits)
+{
+    uint32_t value = 0;
+
+    while (nbits > 0)
+    {
+        uint32_t byte = r->bit_pos >> 3;
+        uint8_t  avail = (uint8_t)(8 - (r->bit_pos & 7));
+        uint8_t  take = (nbits < avail) ? nbits : avail;
+
+        if (byte >= r->size)
+        {
+            r->error = 1;
+            return 0;
+        }
+
+        value = (value << take) | ((uint32_t)(r->buf[byte] >> (avail - take)) & ((1U << take) - 1U));
+        r->bit_pos += take;
+        nbits -= take;
+    }
+
+    return value;
+}
+
+static void FH_EncodeDod(FH_BitWriter_t *w, int32_t dod)
+{
+    if (dod == 0)
+    {
+        FH_PutBits(w, 0x0, 1);
+    }
+    else if (dod >= -63 && dod <= 64)
+    {
+        FH_PutBits(w, 0x2, 2);
+        FH_PutBits(w, (uint32_t)(dod + 63), 7);
+    }
+    else if (dod >= -255 && dod <= 256)
+    {
+        FH_PutBits(w, 0x6, 3);
+        FH_PutBits(w, (uint32_t)(dod + 255), 9);
+    }
+    else if (dod >= -2047 && dod <= 2048)
+    {
+        FH_PutBits(w, 0xE, 4);
+        FH_PutBits(w, (uint32_t)(dod + 2047), 12);
+    }
+    else
+    {
+        FH_PutBits(w, 0xF, 4);
+        FH_PutBits(w, (uint32_t)dod, 32);
+    }
+}
+
+static int32_t FH_DecodeDod(FH_BitReader_t *r)
+{
+    if (FH_GetBits(r, 1) == 0)
+        return 0;
+    if (FH_GetBits(r, 1) == 0)
+        return (int32_t)FH_GetBits(r, 7) - 63;
+    if (FH_GetBits(r, 1) == 0)
+        return (int32_t)FH_GetBits(r, 9) - 255;
+    if (FH_GetBits(r, 1) == 0)
+        return (int32_t)FH_GetBits(r, 12) - 2047;
+    return (int32_t)FH_GetBits(r, 32);
+}
+
+static uint32_t FH_ReadField(const AudioTelemetryPacket_t *pkt, const FH_Column_t *col)
+{
+    const uint8_t *src = (const uint8_t *)pkt + col->offset;
+
+    if (col->width == 1)
+        return src[0];
+    if (col->width == 2)
+        return (uint32_t)src[0] | ((uint32_t)src[1] << 8);
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) |
+           ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+static void FH_WriteField(AudioTelemetryPacket_t *pkt, const FH_Column_t *col, uint32_t value)
+{
+    uint8_t *dst = (uint8_t *)pkt + col->offset;
+
+    for (uint8_t i = 0; i < col->width; i++)
+        dst[i] = (uint8_t)(value >> (8 * i));
+}
+
+static uint8_t FH_Clz32(uint32_t v)
+{
+    uint8_t n = 0;
+
+    if (v == 0)
+        return 32;
+    while (!(v & 0x80000000U))
+    {
+        v <<= 1;
+        n++;
+    }
+    return n;
+}
+
+static uint8_t FH_Ctz32(uint32_t v)
+{
+    uint8_t n = 0;
+
+    if (v == 0)
+        return 32;
+    while (!(v & 1U))
+    {
+        v >>= 1;
+        n++;
+    }
+    return n;
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,537 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    irq_latency.c
+  * @author  Wind Turbine Team
+  * @brief   Interrupt latency and jitter capture for the stm32u5xx_it.c handlers
+  ******************************************************************************
+  * Enter() only stores the arrival in the current block; the histograms are
+  * updated in Exit(), after the wrapper has taken its exit stamp, so the
+  * bookkeeping of one handler is never charged to its own service time.
+  * A source does not preempt itself, so each source's state has a single
+  * writer. The "last exit" pair is shared and may tear when a nested handler
+  * exits in between; it is only a hint for the worst case.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "irq_latency.h"
+#include "app_util.h"
+#include "cpu_load.h"
+#include "low_power.h"
+#include "slab_alloc.h"
+#include "stm32u5xx_hal.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define IRQ_LATENCY_MAX_PERIODIC        4       /* Sources with a known period */
+#define IRQ_LATENCY_NO_ISR              0xFFU
+
+_Static_assert(IRQ_LATENCY_REPORT_SIZE <= SLAB_MAX_BLOCK_SIZE, "report does not fit the largest slab class");
+_Static_assert(CPU_LOAD_ISR_COUNT < IRQ_LATENCY_NO_ISR, "ISR numbers must fit a byte");
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    uint32_t               entry;                      /* DWT at entry */
+    uint32_t               periods;                    /* Periods since the first arrival of the block */
+    const CHAR            *thread;                     /* Interrupted thread, NULL for idle/scheduler */
+    uint32_t               isr_busy;                   /* Cycles already in interrupt context when nested */
+    uint32_t               last_exit_gap;              /* Cycles since the last handler exit */
+    uint8_t                nest;                       /* Profile kit nesting depth, 1 = not nested */
+    uint8_t                last_exit_isr;
+} IrqLatency_Arrival_t;
+
+typedef struct
+{
+    uint8_t                isr;
+    uint32_t               period_cycles;              /* Nominal */
+    uint32_t               arrivals;
+    uint32_t               last_entry;
+    uint64_t               span;                       /* Cycles from the first to the last arrival */
+    uint32_t               span_periods;
+    int32_t                jitter_min;
+    int32_t                jitter_max;
+    uint32_t               late_max;
+    uint32_t               late_hist[IRQ_LATENCY_BINS];
+    uint32_t               misses;
+    uint32_t               block_fill;
+    IrqLatency_Arrival_t   block[IRQ_LATENCY_BLOCK];
+    IrqLatency_Arrival_t   worst;
+} IrqLatency_Periodic_t;
+
+typedef struct
+{
+    uint32_t               count;
+    uint32_t               service_max;
+    uint32_t               service_hist[IRQ_LATENCY_BINS];
+    uint8_t                periodic;                   /* Index in periodic[], IRQ_LATENCY_NO_ISR if none */
+    uint8_t                in_flight;                  /* Enter() seen while armed */
+} IrqLatency_Source_t;
+
+typedef struct
+{
+    volatile uint8_t       armed;
+    uint8_t                state;                      /* IrqLatency_State_t */
+    uint8_t                periodic_count;
+    uint8_t                saved_mode;                 /* LowPower_Mode_t before the capture */
+    uint32_t               cycles_per_us;
+    volatile uint8_t       last_exit_isr;
+    volatile uint32_t      last_exit;
+    ULONG                  start_tick;
+    ULONG                  stop_tick;
+
+    IrqLatency_Source_t    sources[CPU_LOAD_ISR_COUNT];
+    IrqLatency_Periodic_t  periodic[IRQ_LATENCY_MAX_PERIODIC];
+
+    TX_TIMER               stop_timer;
+    UINT                   is_ready;
+} IrqLatency_Context_t;
+
+/* Private variables ---------------------------------------------------------*/
+static IrqLatency_Context_t irq_ctx;
+
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+extern ULONG _tx_execution_isr_nest_counter;
+extern EXECUTION_TIME_SOURCE_TYPE _tx_execution_isr_time_last_start;
+extern TX_THREAD *_tx_thread_current_ptr;
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+static void IrqLatency_Reset(void);
+static void IrqLatency_StopTimer(ULONG input);
+static uint32_t IrqLatency_Bin(uint32_t cycles);
+static uint32_t IrqLatency_Period(const IrqLatency_Periodic_t *p);
+static void IrqLatency_CloseBlock(IrqLatency_Periodic_t *p);
+static uint32_t IrqLatency_AppendBins(char *buf, uint32_t size, uint32_t len, const uint32_t *bins);
+
+/**
+  * @brief  Create the capture timer and set the known periods
+  * @retval TX_SUCCESS or error code
+  */
+UINT IrqLatency_Init(void)
+{
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+    UINT status;
+
+    memset(&irq_ctx, 0, sizeof(irq_ctx));
+    for (uint32_t i = 0; i < CPU_LOAD_ISR_COUNT; i++)
+        irq_ctx.sources[i].periodic = IRQ_LATENCY_NO_ISR;
+
+    status = tx_timer_create(&irq_ctx.stop_timer,
+                             "IRQ Latency Stop",
+                             IrqLatency_StopTimer,
+                             0,
+                             IRQ_LATENCY_DEFAULT_SECONDS * TX_TIMER_TICKS_PER_SECOND,
+                             0,
+                             TX_NO_ACTIVATE);
+    if (status != TX_SUCCESS)
+        return status;
+
+    irq_ctx.is_ready = 1;
+
+    /* TIM6 time base; the audio DMA period is set by AudioAcquisition_Start() */
+    return IrqLatency_SetPeriod(CPU_LOAD_ISR_HAL_TICK, (uint32_t)HAL_GetTickFreq() * 1000U);
+#else
+    return TX_FEATURE_NOT_ENABLED;
+#endif
+}
+
+/**
+  * @brief  Declare a source periodic
+  * @param  isr: CpuLoad_Isr_t
+  * @param  period_us: interrupt period, 0 for aperiodic
+  * @retval TX_SUCCESS, TX_SIZE_ERROR or TX_NOT_AVAILABLE during a capture
+  */
+UINT IrqLatency_SetPeriod(uint32_t isr, uint32_t period_us)
+{
+    IrqLatency_Source_t *s;
+    uint8_t slot;
+
+    if (isr >= CPU_LOAD_ISR_COUNT)
+        return TX_SIZE_ERROR;
+    if (!irq_ctx.is_ready || irq_ctx.state == IRQ_LATENCY_STATE_RUNNING)
+        return TX_NOT_AVAILABLE;
+
+    s = &irq_ctx.sources[isr];
+    slot = s->periodic;
+
+    if (period_us == 0U)
+    {
+        /* The slot stays allocated; only the source forgets it */
+        s->periodic = IRQ_LATENCY_NO_ISR;
+        return TX_SUCCESS;
+    }
+
+    if (slot == IRQ_LATENCY_NO_ISR)
+    {
+        for (slot = 0; slot < irq_ctx.periodic_count; slot++)
+        {
+            if (irq_ctx.periodic[slot].isr == isr)
+                break;
+        }
+        if (slot == irq_ctx.periodic_count)
+        {
+            if (irq_ctx.periodic_count >= IRQ_LATENCY_MAX_PERIODIC)
+                return TX_SIZE_ERROR;
+            irq_ctx.periodic_count++;
+        }
+    }
+
+    irq_ctx.periodic[slot].isr = (uint8_t)isr;
+    irq_ctx.periodic[slot].period_cycles = period_us * (SystemCoreClock / 1000000U);
+    s->periodic = slot;
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Clear the statistics and capture for a number of seconds
+  * @param  seconds: clamped to 1..IRQ_LATENCY_MAX_SECONDS
+  * @retval TX_SUCCESS or error code
+  */
+UINT IrqLatency_Start(ULONG seconds)
+{
+    UINT status;
+
+    if (!irq_ctx.is_ready)
+        return TX_NOT_AVAILABLE;
+    if (irq_ctx.state == IRQ_LATENCY_STATE_RUNNING)
+        return TX_NOT_AVAILABLE;
+
+    if (seconds == 0U)
+        seconds = 1U;
+    if (seconds > IRQ_LATENCY_MAX_SECONDS)
+        seconds = IRQ_LATENCY_MAX_SECONDS;
+
+    status = tx_timer_change(&irq_ctx.stop_timer, seconds * TX_TIMER_TICKS_PER_SECOND, 0);
+    if (status != TX_SUCCESS)
+        return status;
+
+    /* CYCCNT stops in Sleep/Stop, which would shorten every interval that spans one */
+    irq_ctx.saved_mode = (uint8_t)LowPower_GetMode();
+    LowPower_SetMode(LOW_POWER_MODE_OFF);
+
+    IrqLatency_Reset();
+    irq_ctx.start_tick = tx_time_get();
+    irq_ctx.state = IRQ_LATENCY_STATE_RUNNING;
+    irq_ctx.armed = 1;
+
+    return tx_timer_activate(&irq_ctx.stop_timer);
+}
+
+/**
+  * @brief  End the capture early
+  * @retval None
+  */
+void IrqLatency_Stop(void)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    if (irq_ctx.state != IRQ_LATENCY_STATE_RUNNING)
+    {
+        TX_RESTORE
+        return;
+    }
+    irq_ctx.armed = 0;
+    irq_ctx.state = IRQ_LATENCY_STATE_DONE;
+    TX_RESTORE
+
+    tx_timer_deactivate(&irq_ctx.stop_timer);
+    irq_ctx.stop_tick = tx_time_get();
+    LowPower_SetMode((LowPower_Mode_t)irq_ctx.saved_mode);
+}
+
+/**
+  * @brief  Record an interrupt entry (ISR wrapper)
+  * @param  isr: CpuLoad_Isr_t
+  * @param  entry: DWT stamp taken first thing in the handler
+  * @retval None
+  */
+void IrqLatency_Enter(uint32_t isr, uint32_t entry)
+{
+    IrqLatency_Source_t *s;
+    IrqLatency_Periodic_t *p;
+    IrqLatency_Arrival_t *a;
+    uint32_t periods = 0;
+
+    if (!irq_ctx.armed || isr >= CPU_LOAD_ISR_COUNT)
+        return;
+
+    s = &irq_ctx.sources[isr];
+    s->in_flight = 1;
+    if (s->periodic == IRQ_LATENCY_NO_ISR)
+        return;
+
+    p = &irq_ctx.periodic[s->periodic];
+    if (p->arrivals > 0U)
+    {
+        uint32_t interval = entry - p->last_entry;
+        uint32_t period = IrqLatency_Period(p);
+        int32_t jitter;
+
+        /* An interval of several periods is missed arrivals, not jitter */
+        periods = (interval + period / 2U) / period;
+        if (periods == 0U)
+            periods = 1U;
+        p->misses += periods - 1U;
+        jitter = (int32_t)(interval - periods * period);
+        if (p->arrivals == 1U || jitter < p->jitter_min)
+            p->jitter_min = jitter;
+        if (p->arrivals == 1U || jitter > p->jitter_max)
+            p->jitter_max = jitter;
+
+        p->span += interval;
+        p->span_periods += periods;
+        if (p->block_fill > 0U)
+            periods += p->block[p->block_fill - 1U].periods;
+        else
+            periods = 0U;
+    }
+    p->arrivals++;
+    p->last_entry = entry;
+
+    a = &p->block[p->block_fill];
+    a->entry = entry;
+    a->periods = periods;
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+    a->thread = _tx_thread_current_ptr ? _tx_thread_current_ptr->tx_thread_name : NULL;
+    a->nest = (uint8_t)_tx_execution_isr_nest_counter;
+    a->isr_busy = (_tx_execution_isr_nest_counter > 1U) ? entry - (uint32_t)_tx_execution_isr_time_last_start : 0U;
+#endif
+    a->last_exit_isr = irq_ctx.last_exit_isr;
+    a->last_exit_gap = entry - irq_ctx.last_exit;
+}
+
+/**
+  * @brief  Record an interrupt exit (ISR wrapper)
+  * @param  isr: CpuLoad_Isr_t
+  * @param  entry: stamp passed to IrqLatency_Enter()
+  * @param  exit: DWT stamp taken after the handler
+  * @retval None
+  */
+void IrqLatency_Exit(uint32_t isr, uint32_t entry, uint32_t exit)
+{
+    IrqLatency_Source_t *s;
+    uint32_t service = exit - entry;
+
+    if (!irq_ctx.armed || isr >= CPU_LOAD_ISR_COUNT)
+        return;
+
+    s = &irq_ctx.sources[isr];
+    if (!s->in_flight)
+        return;
+    s->in_flight = 0;
+
+    s->count++;
+    s->service_hist[IrqLatency_Bin(service)]++;
+    if (service > s->service_max)
+        s->service_max = service;
+
+    if (s->periodic != IRQ_LATENCY_NO_ISR)
+    {
+        IrqLatency_Periodic_t *p = &irq_ctx.periodic[s->periodic];
+
+        if (++p->block_fill == IRQ_LATENCY_BLOCK)
+            IrqLatency_CloseBlock(p);
+    }
+
+    irq_ctx.last_exit_isr = (uint8_t)isr;
+    irq_ctx.last_exit = exit;
+}
+
+/**
+  * @brief  Format the last capture as CSV lines
+  * @param  buf: output buffer
+  * @param  size: buffer size
+  * @retval Number of characters written (excluding terminator)
+  */
+uint32_t IrqLatency_Format(char *buf, uint32_t size)
+{
+    static const char *const state_names[] = { "idle", "running", "done" };
+    uint32_t len = 0;
+    ULONG ticks;
+
+    if (!buf || size == 0U)
+        return 0;
+    buf[0] = '\0';
+
+    ticks = (irq_ctx.state == IRQ_LATENCY_STATE_RUNNING ? tx_time_get() : irq_ctx.stop_tick) - irq_ctx.start_tick;
+    len = App_Append(buf, size, len, "capture,%s,%lu,%lu\n",
+                     state_names[irq_ctx.state],
+                     (unsigned long)(ticks * 1000U / TX_TIMER_TICKS_PER_SECOND),
+                     (unsigned long)SystemCoreClock);
+
+    for (uint32_t i = 0; i < CPU_LOAD_ISR_COUNT; i++)
+    {
+        const IrqLatency_Source_t *s = &irq_ctx.sources[i];
+
+        if (s->count == 0U)
+            continue;
+        len = App_Append(buf, size, len, "service,%s,%lu,%lu",
+                         CpuLoad_IsrName((CpuLoad_Isr_t)i),
+                         (unsigned long)s->count, (unsigned long)s->service_max);
+        len = IrqLatency_AppendBins(buf, size, len, s->service_hist);
+    }
+
+    for (uint32_t i = 0; i < irq_ctx.periodic_count; i++)
+    {
+        const IrqLatency_Periodic_t *p = &irq_ctx.periodic[i];
+        const IrqLatency_Source_t *s = &irq_ctx.sources[p->isr];
+        uint32_t period = IrqLatency_Period(p);
+
+        if (s->periodic != i || p->arrivals < 2U)
+            continue;
+        len = App_Append(buf, size, len, "late,%s,%lu,%lu,%ld,%ld,%lu,%ld",
+                         CpuLoad_IsrName((CpuLoad_Isr_t)p->isr),
+                         (unsigned long)period, (unsigned long)p->late_max,
+                         (long)p->jitter_min, (long)p->jitter_max, (unsigned long)p->misses,
+                         (long)period - (long)p->late_max - (long)s->service_max);
+        len = IrqLatency_AppendBins(buf, size, len, p->late_hist);
+        len = App_Append(buf, size, len, "worst,%s,%lu,%u,%lu,%s,%s,%lu\n",
+                         CpuLoad_IsrName((CpuLoad_Isr_t)p->isr),
+                         (unsigned long)p->late_max, (unsigned)p->worst.nest,
+                         (unsigned long)p->worst.isr_busy,
+                         p->worst.thread ? p->worst.thread : "-",
+                         (p->worst.last_exit_isr < CPU_LOAD_ISR_COUNT) ?
+                             CpuLoad_IsrName((CpuLoad_Isr_t)p->worst.last_exit_isr) : "-",
+                         (unsigned long)p->worst.last_exit_gap);
+    }
+
+    return len;
+}
+
+/**
+  * @brief  Clear every statistic (periods and slots are kept)
+  * @retval None
+  */
+static void IrqLatency_Reset(void)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    irq_ctx.armed = 0;
+    for (uint32_t i = 0; i < CPU_LOAD_ISR_COUNT; i++)
+    {
+        IrqLatency_Source_t *s = &irq_ctx.sources[i];
+
+        s->count = 0;
+        s->service_max = 0;
+        s->in_flight = 0;
+        memset(s->service_hist, 0, sizeof(s->service_hist));
+    }
+    for (uint32_t i = 0; i < irq_ctx.periodic_count; i++)
+    {
+        IrqLatency_Periodic_t *p = &irq_ctx.periodic[i];
+        uint8_t isr = p->isr;
+        uint32_t period_cycles = p->period_cycles;
+
+        memset(p, 0, sizeof(*p));
+        p->isr = isr;
+        p->period_cycles = period_cycles;
+        p->worst.last_exit_isr = IRQ_LATENCY_NO_ISR;
+    }
+    irq_ctx.last_exit_isr = IRQ_LATENCY_NO_ISR;
+    irq_ctx.last_exit = DWT->CYCCNT;
+    irq_ctx.cycles_per_us = SystemCoreClock / 1000000U;
+    TX_RESTORE
+}
+
+/**
+  * @brief  One-shot timer: the capture time is over
+  * @param  input: unused
+  * @retval None
+  */
+static void IrqLatency_StopTimer(ULONG input)
+{
+    (void)input;
+    IrqLatency_Stop();
+}
+
+/**
+  * @brief  Histogram bin: <1 us, then one bin per power of two microseconds
+  * @param  cycles: DWT cycles
+  * @retval Bin index
+  */
+static uint32_t IrqLatency_Bin(uint32_t cycles)
+{
+    uint32_t us = irq_ctx.cycles_per_us ? cycles / irq_ctx.cycles_per_us : cycles;
+    uint32_t bin;
+
+    if (us == 0U)
+        return 0;
+    bin = 32U - (uint32_t)__builtin_clz(us);
+
+    return (bin < IRQ_LATENCY_BINS) ? bin : IRQ_LATENCY_BINS - 1U;
+}
+
+/**
+  * @brief  Period measured over the capture, nominal until a block is seen
+  * @param  p: periodic source
+  * @retval Cycles
+  */
+static uint32_t IrqLatency_Period(const IrqLatency_Periodic_t *p)
+{
+    if (p->span_periods < IRQ_LATENCY_BLOCK)
+        return p->period_cycles ? p->period_cycles : 1U;
+
+    return (uint32_t)((p->span + p->span_periods / 2U) / p->span_periods);
+}
+
+/**
+  * @brief  Lateness of every arrival in a full block
+  * @param  p: periodic source
+  * @retval None
+  *
+  * Each arrival's offset from its ideal slot is entry - periods * period;
+  * the least delayed arrival of the block is the zero point.
+  */
+static void IrqLatency_CloseBlock(IrqLatency_Periodic_t *p)
+{
+    uint64_t period_q8 = ((uint64_t)IrqLatency_Period(p) << 8);
+    uint32_t base = p->block[0].entry;
+    int32_t offsets[IRQ_LATENCY_BLOCK];
+    int32_t min_offset = INT32_MAX;
+
+    if (p->span_periods >= IRQ_LATENCY_BLOCK)
+        period_q8 = ((p->span << 8) + p->span_periods / 2U) / p->span_periods;
+
+    for (uint32_t i = 0; i < IRQ_LATENCY_BLOCK; i++)
+    {
+        offsets[i] = (int32_t)(p->block[i].entry - base) - (int32_t)((p->block[i].periods * period_q8) >> 8);
+        if (offsets[i] < min_offset)
+            min_offset = offsets[i];
+    }
+
+    for (uint32_t i = 0; i < IRQ_LATENCY_BLOCK; i++)
+    {
+        uint32_t late = (uint32_t)(offsets[i] - min_offset);
+
+        p->late_hist[IrqLatency_Bin(late)]++;
+        if (late >= p->period_cycles)
+            p->misses++;
+        if (late > p->late_max)
+        {
+            p->late_max = late;
+            p->worst = p->block[i];
+        }
+    }
+
+    p->block_fill = 0;
+}
+
+/**
+  * @brief  Append histogram counts and end the line
+  * @retval New length
+  */
+static uint32_t IrqLatency_AppendBins(char *buf, uint32_t size, uint32_t len, const uint32_t *bins)
+{
+    for (uint32_t b = 0; b < IRQ_LATENCY_BINS; b++)
+        len = App_Append(buf, size, len, ",%lu", (unsigned long)bins[b]);
+
+    return App_Append(buf, size, len, "\n");
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
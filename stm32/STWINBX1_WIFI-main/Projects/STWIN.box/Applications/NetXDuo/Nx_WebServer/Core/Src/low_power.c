@@ -0,0 +1,400 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    low_power.c
+  * @author  Wind Turbine Team
+  * @brief   Tickless idle: ThreadX low-power hooks on an LPTIM3 wakeup timer
+  ******************************************************************************
+  * LPTIM3 runs continuously; entering idle only writes CCR1 with the
+  * deadline. Reading the counter on wakeup gives the time spent idle, whether
+  * the deadline or another interrupt ended it. The fractional tick left over
+  * is carried to the next wakeup so the ThreadX clock does not drift.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "low_power.h"
+#include "main.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define LOW_POWER_LPTIM_MASK            0xFFFFU
+#define LOW_POWER_GPDMA_CHANNELS        16U
+#define LOW_POWER_GPDMA_CHANNEL_STRIDE  (GPDMA1_Channel1_BASE - GPDMA1_Channel0_BASE)
+#define LOW_POWER_SYNC_SPIN             10000U  /* LPTIM register write sync, >> 3 LSE cycles */
+
+_Static_assert(LOW_POWER_MAX_SLEEP_TICKS * (uint64_t)LOW_POWER_LPTIM_HZ / TX_TIMER_TICKS_PER_SECOND
+               < LOW_POWER_LPTIM_MASK, "sleep limit exceeds LPTIM3 wrap");
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    uint8_t     is_ready;              /* LPTIM3 running */
+    uint8_t     mode;                  /* LowPower_Mode_t */
+    uint8_t     idle;                  /* Between Enter and Exit */
+    uint8_t     tickless;              /* SysTick/HAL tick stopped for this idle period */
+    uint8_t     stopped;               /* Stop 2 entered for this idle period */
+    uint8_t     compare_pending;       /* CCR1 write not yet synchronised */
+    uint16_t    idle_start;            /* LPTIM3 count at idle entry */
+    uint32_t    tick_remainder;        /* Carried fraction of a tick, in LPTIM counts * ticks/s */
+
+    /* Measurement window */
+    ULONG       window_start;          /* tx_time_get() at window start */
+    uint64_t    sleep_counts;
+    uint64_t    stop_counts;
+    uint32_t    wakeups;
+    uint32_t    timer_wakeups;
+    uint32_t    packets;
+} LowPower_Context_t;
+
+/* Private variables ---------------------------------------------------------*/
+static LowPower_Context_t lp_ctx = {0};
+LPTIM_HandleTypeDef hlptim3;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint16_t LowPower_ReadCounter(void);
+static uint8_t LowPower_StopAllowed(void);
+static uint32_t LowPower_CountsToMs(uint64_t counts);
+
+/**
+  * @brief  Start the LSE and LPTIM3
+  * @retval TX_SUCCESS or TX_NOT_AVAILABLE
+  */
+UINT LowPower_Init(void)
+{
+    RCC_OscInitTypeDef osc = {0};
+    RCC_PeriphCLKInitTypeDef clk = {0};
+    uint32_t spin;
+
+    memset(&lp_ctx, 0, sizeof(lp_ctx));
+
+    /* LSE for accuracy; LSI (+/- few %) if the crystal does not start */
+    __HAL_RCC_PWR_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+    osc.OscillatorType = RCC_OSCILLATORTYPE_LSE;
+    osc.LSEState = RCC_LSE_ON;
+    osc.PLL.PLLState = RCC_PLL_NONE;
+    clk.PeriphClockSelection = RCC_PERIPHCLK_LPTIM34;
+    clk.Lptim34ClockSelection = RCC_LPTIM34CLKSOURCE_LSE;
+    if (HAL_RCC_OscConfig(&osc) != HAL_OK)
+    {
+        osc.OscillatorType = RCC_OSCILLATORTYPE_LSI;
+        osc.LSEState = RCC_LSE_OFF;
+        osc.LSIState = RCC_LSI_ON;
+        osc.LSIDiv = RCC_LSI_DIV1;
+        clk.Lptim34ClockSelection = RCC_LPTIM34CLKSOURCE_LSI;
+        if (HAL_RCC_OscConfig(&osc) != HAL_OK)
+            return TX_NOT_AVAILABLE;
+        printf("LowPower: LSE not running, wakeup timer on LSI\n");
+    }
+    if (HAL_RCCEx_PeriphCLKConfig(&clk) != HAL_OK)
+        return TX_NOT_AVAILABLE;
+
+    /* LPTIM3 keeps counting in Stop 2; LPTIM1 (mx_wifi flow) needs HSI there */
+    __HAL_RCC_LPTIM3_CLK_ENABLE();
+    __HAL_RCC_LPTIM3_CLKAM_ENABLE();
+    __HAL_RCC_LPTIM1_CLKAM_ENABLE();
+    __HAL_RCC_HSISTOP_ENABLE();
+    __HAL_RCC_WAKEUPSTOP_CLK_CONFIG(RCC_STOP_WAKEUPCLOCK_HSI);
+
+    hlptim3.Instance = LPTIM3;
+    hlptim3.Init.Clock.Source = LPTIM_CLOCKSOURCE_APBCLOCK_LPOSC;
+    hlptim3.Init.Clock.Prescaler = LPTIM_PRESCALER_DIV8;
+    hlptim3.Init.Trigger.Source = LPTIM_TRIGSOURCE_SOFTWARE;
+    hlptim3.Init.Period = LOW_POWER_LPTIM_MASK;
+    hlptim3.Init.UpdateMode = LPTIM_UPDATE_IMMEDIATE;
+    hlptim3.Init.CounterSource = LPTIM_COUNTERSOURCE_INTERNAL;
+    hlptim3.Init.Input1Source = LPTIM_INPUT1SOURCE_GPIO;
+    hlptim3.Init.Input2Source = LPTIM_INPUT2SOURCE_GPIO;
+    hlptim3.Init.RepetitionCounter = 0;
+    if (HAL_LPTIM_Init(&hlptim3) != HAL_OK)
+        return TX_NOT_AVAILABLE;
+
+    /* Compare interrupt stays enabled: DIER writes need a sync wait, CCR1 writes do not block */
+    __HAL_LPTIM_ENABLE(&hlptim3);
+    __HAL_LPTIM_CLEAR_FLAG(&hlptim3, LPTIM_FLAG_DIEROK);
+    __HAL_LPTIM_ENABLE_IT(&hlptim3, LPTIM_IT_CC1);
+    for (spin = 0; spin < LOW_POWER_SYNC_SPIN; spin++)
+    {
+        if (__HAL_LPTIM_GET_FLAG(&hlptim3, LPTIM_FLAG_DIEROK))
+            break;
+    }
+    if (spin == LOW_POWER_SYNC_SPIN)
+        return TX_NOT_AVAILABLE;
+    __HAL_LPTIM_START_CONTINUOUS(&hlptim3);
+
+    HAL_NVIC_SetPriority(LPTIM3_IRQn, LOW_POWER_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(LPTIM3_IRQn);
+
+    lp_ctx.mode = LOW_POWER_DEFAULT_MODE;
+    lp_ctx.is_ready = 1;
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Select the idle mode and restart the measurement window
+  * @param  mode: LowPower_Mode_t
+  * @retval TX_SUCCESS or TX_NOT_AVAILABLE
+  */
+UINT LowPower_SetMode(LowPower_Mode_t mode)
+{
+    if (!lp_ctx.is_ready || mode > LOW_POWER_MODE_STOP)
+        return TX_NOT_AVAILABLE;
+
+    lp_ctx.mode = (uint8_t)mode;
+    LowPower_ResetStats();
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Current idle mode
+  * @retval LowPower_Mode_t
+  */
+LowPower_Mode_t LowPower_GetMode(void)
+{
+    return (LowPower_Mode_t)lp_ctx.mode;
+}
+
+/**
+  * @brief  Count one telemetry packet
+  * @retval None
+  */
+void LowPower_NotePacket(void)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    lp_ctx.packets++;
+    TX_RESTORE
+}
+
+/**
+  * @brief  Get the measurement window statistics
+  * @param  stats: output
+  * @retval None
+  */
+void LowPower_GetStats(LowPower_Stats_t *stats)
+{
+    TX_INTERRUPT_SAVE_AREA
+    uint64_t sleep_counts;
+    uint64_t stop_counts;
+    uint64_t energy_pj;
+    ULONG now;
+
+    TX_DISABLE
+    now = tx_time_get();
+    sleep_counts = lp_ctx.sleep_counts;
+    stop_counts = lp_ctx.stop_counts;
+    stats->mode = lp_ctx.mode;
+    stats->window_ms = (uint32_t)((uint64_t)(now - lp_ctx.window_start) * 1000U / TX_TIMER_TICKS_PER_SECOND);
+    stats->wakeups = lp_ctx.wakeups;
+    stats->timer_wakeups = lp_ctx.timer_wakeups;
+    stats->packets = lp_ctx.packets;
+    TX_RESTORE
+
+    stats->sleep_ms = LowPower_CountsToMs(sleep_counts);
+    stats->stop_ms = LowPower_CountsToMs(stop_counts);
+    if (stats->sleep_ms + stats->stop_ms > stats->window_ms)
+        stats->window_ms = stats->sleep_ms + stats->stop_ms;
+    stats->run_ms = stats->window_ms - stats->sleep_ms - stats->stop_ms;
+
+    /* mV * uA * ms = pJ */
+    energy_pj = (uint64_t)LOW_POWER_SUPPLY_MV *
+                ((uint64_t)LOW_POWER_RUN_UA * stats->run_ms +
+                 (uint64_t)LOW_POWER_SLEEP_UA * stats->sleep_ms +
+                 (uint64_t)LOW_POWER_STOP_UA * stats->stop_ms);
+    stats->energy_uj = (uint32_t)(energy_pj / 1000000U);
+    stats->energy_per_packet_uj = stats->packets ? stats->energy_uj / stats->packets : 0;
+}
+
+/**
+  * @brief  Restart the measurement window
+  * @retval None
+  */
+void LowPower_ResetStats(void)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    lp_ctx.window_start = tx_time_get();
+    lp_ctx.sleep_counts = 0;
+    lp_ctx.stop_counts = 0;
+    lp_ctx.wakeups = 0;
+    lp_ctx.timer_wakeups = 0;
+    lp_ctx.packets = 0;
+    TX_RESTORE
+}
+
+/**
+  * @brief  LPTIM3 compare: the wakeup itself is all that is needed
+  * @retval None
+  */
+void LowPower_TimerIRQHandler(void)
+{
+    __HAL_LPTIM_CLEAR_FLAG(&hlptim3, LPTIM_FLAG_CC1);
+}
+
+/**
+  * @brief  TX_LOW_POWER_TIMER_SETUP: program the deadline and stop the ticks
+  * @param  ticks: ThreadX ticks until the next timer expiration
+  * @retval None
+  */
+void LowPower_TimerSetup(ULONG ticks)
+{
+    uint32_t counts;
+
+    lp_ctx.tickless = 0;
+    if (!lp_ctx.is_ready || lp_ctx.mode == LOW_POWER_MODE_OFF || ticks < LOW_POWER_MIN_SLEEP_TICKS)
+        return;
+
+    if (ticks > LOW_POWER_MAX_SLEEP_TICKS)
+        ticks = LOW_POWER_MAX_SLEEP_TICKS;
+    counts = (uint32_t)((uint64_t)ticks * LOW_POWER_LPTIM_HZ / TX_TIMER_TICKS_PER_SECOND);
+
+    /* The previous CCR1 write must have reached the LPTIM clock domain */
+    if (lp_ctx.compare_pending)
+    {
+        for (uint32_t spin = 0; spin < LOW_POWER_SYNC_SPIN; spin++)
+        {
+            if (__HAL_LPTIM_GET_FLAG(&hlptim3, LPTIM_FLAG_CMP1OK))
+                break;
+        }
+    }
+    __HAL_LPTIM_CLEAR_FLAG(&hlptim3, LPTIM_FLAG_CMP1OK | LPTIM_FLAG_CC1);
+    __HAL_LPTIM_COMPARE_SET(&hlptim3, LPTIM_CHANNEL_1,
+                            (LowPower_ReadCounter() + counts) & LOW_POWER_LPTIM_MASK);
+    lp_ctx.compare_pending = 1;
+
+    SysTick->CTRL &= ~(SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk);
+    HAL_SuspendTick();
+    lp_ctx.tickless = 1;
+}
+
+/**
+  * @brief  TX_LOW_POWER_USER_ENTER: sleep until the deadline or any interrupt
+  * @retval None
+  */
+void LowPower_Enter(void)
+{
+    if (!lp_ctx.is_ready || lp_ctx.mode == LOW_POWER_MODE_OFF)
+        return;
+
+    lp_ctx.stopped = (lp_ctx.mode == LOW_POWER_MODE_STOP) && lp_ctx.tickless && LowPower_StopAllowed();
+    lp_ctx.idle_start = LowPower_ReadCounter();
+    lp_ctx.idle = 1;
+
+    /* PRIMASK is set: the wakeup interrupt is taken after tx_low_power_exit() */
+    if (lp_ctx.stopped)
+    {
+        __HAL_RCC_PWR_CLK_ENABLE();
+        HAL_PWREx_EnterSTOP2Mode(PWR_STOPENTRY_WFI);
+    }
+    else
+    {
+        HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);
+    }
+}
+
+/**
+  * @brief  TX_LOW_POWER_USER_EXIT: restore the clocks after Stop 2
+  * @retval None
+  */
+void LowPower_Exit(void)
+{
+    if (lp_ctx.stopped)
+        SystemClock_Config();
+}
+
+/**
+  * @brief  TX_LOW_POWER_USER_TIMER_ADJUST: account idle time, restart the ticks
+  * @retval ThreadX ticks spent idle with SysTick stopped
+  */
+ULONG LowPower_TimerAdjust(void)
+{
+    uint32_t elapsed;
+    uint32_t scaled;
+    ULONG ticks = 0;
+
+    if (!lp_ctx.idle)
+        return 0;
+    lp_ctx.idle = 0;
+
+    elapsed = (uint32_t)(LowPower_ReadCounter() - lp_ctx.idle_start) & LOW_POWER_LPTIM_MASK;
+    if (lp_ctx.stopped)
+        lp_ctx.stop_counts += elapsed;
+    else
+        lp_ctx.sleep_counts += elapsed;
+    lp_ctx.wakeups++;
+
+    if (!lp_ctx.tickless)
+        return 0;
+
+    if (__HAL_LPTIM_GET_FLAG(&hlptim3, LPTIM_FLAG_CC1))
+        lp_ctx.timer_wakeups++;
+
+    scaled = elapsed * TX_TIMER_TICKS_PER_SECOND + lp_ctx.tick_remainder;
+    ticks = scaled / LOW_POWER_LPTIM_HZ;
+    lp_ctx.tick_remainder = scaled % LOW_POWER_LPTIM_HZ;
+
+    uwTick += (uint32_t)(ticks * 1000U / TX_TIMER_TICKS_PER_SECOND);
+    HAL_ResumeTick();
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+    lp_ctx.tickless = 0;
+
+    return ticks;
+}
+
+/**
+  * @brief  Read LPTIM3 CNT (asynchronous clock: two equal reads)
+  * @retval Counter value
+  */
+static uint16_t LowPower_ReadCounter(void)
+{
+    uint32_t a;
+    uint32_t b = LPTIM3->CNT;
+
+    do
+    {
+        a = b;
+        b = LPTIM3->CNT;
+    } while (a != b);
+
+    return (uint16_t)a;
+}
+
+/**
+  * @brief  Stop 2 halts GPDMA and SDMMC: only allowed when both are idle
+  * @retval 1 if Stop 2 is safe
+  */
+static uint8_t LowPower_StopAllowed(void)
+{
+    for (uint32_t i = 0; i < LOW_POWER_GPDMA_CHANNELS; i++)
+    {
+        DMA_Channel_TypeDef *ch = (DMA_Channel_TypeDef *)(GPDMA1_Channel0_BASE + i * LOW_POWER_GPDMA_CHANNEL_STRIDE);
+
+        if (ch->CCR & DMA_CCR_EN)
+            return 0;
+    }
+
+    if (SDMMC1->STA & (SDMMC_STA_CPSMACT | SDMMC_STA_DPSMACT))
+        return 0;
+
+    return 1;
+}
+
+/**
+  * @brief  LPTIM3 counts to milliseconds
+  * @param  counts: LPTIM3 counts
+  * @retval Milliseconds
+  */
+static uint32_t LowPower_CountsToMs(uint64_t counts)
+{
+    return (uint32_t)(counts * 1000U / LOW_POWER_LPTIM_HZ);
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
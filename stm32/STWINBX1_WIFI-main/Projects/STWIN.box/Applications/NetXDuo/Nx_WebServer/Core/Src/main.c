@@ -26,7 +26,7 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-
+#include "low_power.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -158,7 +158,11 @@ int main(void)
   }
 
   /* USER CODE BEGIN 2 */
-
+  /* Tickless idle wakeup timer; needs HAL_GetTick(), so before the kernel starts */
+  if (LowPower_Init() != TX_SUCCESS)
+  {
+    printf("LowPower: init failed, idle without sleep\n");
+  }
   /* USER CODE END 2 */
 
   MX_ThreadX_Init();
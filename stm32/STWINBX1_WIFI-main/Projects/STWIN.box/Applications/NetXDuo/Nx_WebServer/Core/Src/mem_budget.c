@@ -0,0 +1,392 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    mem_budget.c
+  * @author  Wind Turbine Team
+  * @brief   Memory budget: byte-pool carving, stacks and packet pools
+  ******************************************************************************
+  * Stack usage is measured from the ThreadX stack fill pattern: the deepest
+  * byte that no longer holds TX_STACK_FILL is the high-water mark. With
+  * TX_ENABLE_STACK_CHECKING the kernel also reports overflows through
+  * tx_thread_stack_error_notify(), which are counted here.
+  *
+  * Byte-pool fragmentation is read by walking the pool's block list with
+  * interrupts disabled, the same way tx_byte_allocate() searches it.
+  *
+  * NetX keeps no low watermark for packet pools, so every pool is sampled
+  * every MEM_BUDGET_SAMPLE_MS. Short dips between two samples are missed.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "mem_budget.h"
+#include "app_util.h"
+#include "slab_alloc.h"
+#include "timer_wheel.h"
+#include "tx_thread.h"
+#include "tx_byte_pool.h"
+#include "nx_api.h"
+#include "nx_packet.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define MEM_BUDGET_MAX_THREADS      24
+#define MEM_BUDGET_STACK_FILL_BYTE  ((UCHAR)(TX_STACK_FILL & 0xFFU))
+
+_Static_assert(MEM_BUDGET_REPORT_SIZE <= SLAB_MAX_BLOCK_SIZE, "report does not fit the largest slab class");
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    TX_BYTE_POOL          *pool;                       /* NULL for static buffers */
+    const CHAR            *owner;
+    const CHAR            *purpose;
+    ULONG                  size;
+} MemBudget_Entry_t;
+
+typedef struct
+{
+    NX_PACKET_POOL        *pool;
+    ULONG                  low_watermark;
+} MemBudget_PacketPool_t;
+
+typedef struct
+{
+    MemBudget_Entry_t      entries[MEM_BUDGET_MAX_ENTRIES];
+    uint32_t               entry_count;
+    uint32_t               entries_dropped;            /* Table full */
+
+    MemBudget_PacketPool_t packet_pools[MEM_BUDGET_MAX_PACKET_POOLS];
+    uint32_t               packet_pool_count;
+    TimerWheel_Timer_t     sample_timer;
+
+    TX_THREAD             *overflow_thread;            /* Last thread that overflowed */
+    uint32_t               overflow_count;
+} MemBudget_Context_t;
+
+/* Private variables ---------------------------------------------------------*/
+static MemBudget_Context_t budget_ctx = {0};
+
+/* Private function prototypes -----------------------------------------------*/
+static void MemBudget_Record(TX_BYTE_POOL *pool, const CHAR *owner, const CHAR *purpose, ULONG size);
+static void MemBudget_SampleTimer(ULONG input);
+static void MemBudget_StackError(TX_THREAD *thread_ptr);
+static ULONG MemBudget_StackUsed(TX_THREAD *thread_ptr);
+static ULONG MemBudget_LargestFree(TX_BYTE_POOL *pool);
+
+/**
+  * @brief  Start packet-pool sampling and stack overflow reporting
+  * @retval TX_SUCCESS or error code
+  */
+UINT MemBudget_Init(void)
+{
+    UINT status;
+
+    /* Not available without TX_ENABLE_STACK_CHECKING, the fill scan still works */
+    (void)tx_thread_stack_error_notify(MemBudget_StackError);
+
+    TimerWheel_Create(&budget_ctx.sample_timer, "Mem Budget Sample", MemBudget_SampleTimer, 0);
+    status = TimerWheel_Start(&budget_ctx.sample_timer,
+                              MEM_BUDGET_SAMPLE_MS,
+                              MEM_BUDGET_SAMPLE_MS,
+                              TIMER_WHEEL_SLACK(MEM_BUDGET_SAMPLE_MS));
+
+    return status;
+}
+
+/**
+  * @brief  Allocate from a byte pool and record the allocation
+  * @param  pool: ThreadX byte pool
+  * @param  ptr: receives the allocated memory
+  * @param  size: requested size
+  * @param  owner: module name
+  * @param  purpose: what the memory is for
+  * @retval tx_byte_allocate() status
+  */
+UINT MemBudget_Allocate(TX_BYTE_POOL *pool, VOID **ptr, ULONG size,
+                        const CHAR *owner, const CHAR *purpose)
+{
+    UINT status;
+
+    status = tx_byte_allocate(pool, ptr, size, TX_NO_WAIT);
+    if (status != TX_SUCCESS)
+    {
+        printf("MemBudget: %s/%s: %lu bytes from \"%s\" failed (0x%02X, %lu available)\n",
+               owner, purpose, (unsigned long)size,
+               pool ? pool->tx_byte_pool_name : "?", status,
+               pool ? (unsigned long)pool->tx_byte_pool_available : 0UL);
+        return status;
+    }
+
+    MemBudget_Record(pool, owner, purpose, size);
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Record a statically allocated buffer
+  * @param  owner: module name
+  * @param  purpose: what the memory is for
+  * @param  size: buffer size
+  * @retval None
+  */
+void MemBudget_RegisterStatic(const CHAR *owner, const CHAR *purpose, ULONG size)
+{
+    MemBudget_Record(TX_NULL, owner, purpose, size);
+}
+
+/**
+  * @brief  Format the report as CSV lines
+  * @param  buf: output buffer
+  * @param  size: buffer size
+  * @retval Characters written
+  */
+uint32_t MemBudget_Format(char *buf, uint32_t size)
+{
+    TX_INTERRUPT_SAVE_AREA
+    TX_THREAD *threads[MEM_BUDGET_MAX_THREADS];
+    uint32_t thread_count = 0;
+    uint32_t len = 0;
+    TX_THREAD *thread_ptr;
+    TX_BYTE_POOL *byte_pool;
+    ULONG count;
+
+    if (!buf || size == 0)
+        return 0;
+    buf[0] = '\0';
+
+    /* Allocations */
+    for (uint32_t i = 0; i < budget_ctx.entry_count; i++)
+    {
+        const MemBudget_Entry_t *e = &budget_ctx.entries[i];
+
+        len = App_Append(buf, size, len, "alloc,%s,%s,%s,%lu\n",
+                         e->pool ? e->pool->tx_byte_pool_name : "static",
+                         e->owner, e->purpose, (unsigned long)e->size);
+    }
+
+    /* Thread stacks: take the list under lock, scan the stacks without it */
+    TX_DISABLE
+    thread_ptr = _tx_thread_created_ptr;
+    count = _tx_thread_created_count;
+    while (count-- > 0 && thread_count < MEM_BUDGET_MAX_THREADS)
+    {
+        threads[thread_count++] = thread_ptr;
+        thread_ptr = thread_ptr->tx_thread_created_next;
+    }
+    TX_RESTORE
+
+    for (uint32_t i = 0; i < thread_count; i++)
+    {
+        len = App_Append(buf, size, len, "stack,%s,%lu,%lu\n",
+                         threads[i]->tx_thread_name,
+                         (unsigned long)threads[i]->tx_thread_stack_size,
+                         (unsigned long)MemBudget_StackUsed(threads[i]));
+    }
+
+    /* Byte pools */
+    byte_pool = _tx_byte_pool_created_ptr;
+    count = _tx_byte_pool_created_count;
+    while (count-- > 0)
+    {
+        ULONG available = 0;
+        ULONG fragments = 0;
+
+        tx_byte_pool_info_get(byte_pool, TX_NULL, &available, &fragments,
+                              TX_NULL, TX_NULL, TX_NULL);
+
+        len = App_Append(buf, size, len, "bytepool,%s,%lu,%lu,%lu,%lu\n",
+                         byte_pool->tx_byte_pool_name,
+                         (unsigned long)byte_pool->tx_byte_pool_size,
+                         (unsigned long)available,
+                         (unsigned long)fragments,
+                         (unsigned long)MemBudget_LargestFree(byte_pool));
+        byte_pool = byte_pool->tx_byte_pool_created_next;
+    }
+
+    /* Packet pools */
+    for (uint32_t i = 0; i < budget_ctx.packet_pool_count; i++)
+    {
+        NX_PACKET_POOL *pool = budget_ctx.packet_pools[i].pool;
+
+        len = App_Append(buf, size, len, "packetpool,%s,%lu,%lu,%lu,%lu\n",
+                         pool->nx_packet_pool_name,
+                         (unsigned long)pool->nx_packet_pool_total,
+                         (unsigned long)pool->nx_packet_pool_available,
+                         (unsigned long)budget_ctx.packet_pools[i].low_watermark,
+                         (unsigned long)pool->nx_packet_pool_empty_requests);
+    }
+
+    /* Slab size classes */
+    for (uint32_t i = 0; i < Slab_GetClassCount(); i++)
+    {
+        Slab_ClassStats_t slab;
+
+        if (Slab_GetClassStats(i, &slab) != TX_SUCCESS)
+            continue;
+        len = App_Append(buf, size, len, "slab,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+                         (unsigned long)slab.block_size, (unsigned long)slab.blocks,
+                         (unsigned long)slab.in_use, (unsigned long)slab.in_use_max,
+                         (unsigned long)slab.allocs, (unsigned long)slab.spills,
+                         (unsigned long)slab.failures);
+    }
+
+    if (budget_ctx.overflow_count)
+        len = App_Append(buf, size, len, "overflow,%s,%lu\n",
+                         budget_ctx.overflow_thread->tx_thread_name,
+                         (unsigned long)budget_ctx.overflow_count);
+
+    if (budget_ctx.entries_dropped)
+        len = App_Append(buf, size, len, "alloc,untracked,,,%lu\n",
+                         (unsigned long)budget_ctx.entries_dropped);
+
+    return len;
+}
+
+/**
+  * @brief  Print the report on the console
+  * @retval None
+  */
+void MemBudget_Print(void)
+{
+    char *report = (char *)Slab_Alloc(MEM_BUDGET_REPORT_SIZE);
+
+    if (!report)
+        return;
+
+    MemBudget_Format(report, MEM_BUDGET_REPORT_SIZE);
+    printf("---- memory budget ----\n%s-----------------------\n", report);
+    Slab_Free(report);
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Add one entry to the table
+  */
+static void MemBudget_Record(TX_BYTE_POOL *pool, const CHAR *owner, const CHAR *purpose, ULONG size)
+{
+    TX_INTERRUPT_SAVE_AREA
+    MemBudget_Entry_t *e = TX_NULL;
+
+    TX_DISABLE
+    if (budget_ctx.entry_count < MEM_BUDGET_MAX_ENTRIES)
+        e = &budget_ctx.entries[budget_ctx.entry_count++];
+    else
+        budget_ctx.entries_dropped++;
+    TX_RESTORE
+
+    if (!e)
+        return;
+
+    e->pool = pool;
+    e->owner = owner;
+    e->purpose = purpose;
+    e->size = size;
+}
+
+/**
+  * @brief  Timer callback: track the lowest free count of every packet pool
+  * @param  input: unused
+  */
+static void MemBudget_SampleTimer(ULONG input)
+{
+    NX_PACKET_POOL *pool = _nx_packet_pool_created_ptr;
+    ULONG count = _nx_packet_pool_created_count;
+
+    (void)input;
+
+    while (count-- > 0 && pool)
+    {
+        ULONG available = pool->nx_packet_pool_available;
+        uint32_t i;
+
+        for (i = 0; i < budget_ctx.packet_pool_count; i++)
+        {
+            if (budget_ctx.packet_pools[i].pool == pool)
+                break;
+        }
+
+        if (i == budget_ctx.packet_pool_count)
+        {
+            /* Pools are created after this timer starts: adopt new ones */
+            if (i == MEM_BUDGET_MAX_PACKET_POOLS)
+                return;
+            budget_ctx.packet_pools[i].pool = pool;
+            budget_ctx.packet_pools[i].low_watermark = available;
+            budget_ctx.packet_pool_count++;
+        }
+        else if (available < budget_ctx.packet_pools[i].low_watermark)
+        {
+            budget_ctx.packet_pools[i].low_watermark = available;
+        }
+
+        pool = pool->nx_packet_pool_created_next;
+    }
+}
+
+/**
+  * @brief  Stack overflow notification (TX_ENABLE_STACK_CHECKING)
+  * @param  thread_ptr: offending thread
+  */
+static void MemBudget_StackError(TX_THREAD *thread_ptr)
+{
+    budget_ctx.overflow_thread = thread_ptr;
+    budget_ctx.overflow_count++;
+}
+
+/**
+  * @brief  Deepest stack use since thread creation
+  * @param  thread_ptr: thread
+  * @retval Bytes used
+  */
+static ULONG MemBudget_StackUsed(TX_THREAD *thread_ptr)
+{
+    const UCHAR *start = (const UCHAR *)thread_ptr->tx_thread_stack_start;
+    const UCHAR *end = (const UCHAR *)thread_ptr->tx_thread_stack_end;
+    const UCHAR *p = start;
+
+    /* Stacks grow down: untouched fill bytes remain at the low end */
+    while (p < end && *p == MEM_BUDGET_STACK_FILL_BYTE)
+        p++;
+
+    return (ULONG)(end - p) + 1U;
+}
+
+/**
+  * @brief  Largest free block of a byte pool
+  * @param  pool: byte pool
+  * @retval Largest single allocation that would currently succeed
+  */
+static ULONG MemBudget_LargestFree(TX_BYTE_POOL *pool)
+{
+    TX_INTERRUPT_SAVE_AREA
+    UCHAR *block;
+    ULONG fragments;
+    ULONG largest = 0;
+
+    TX_DISABLE
+    block = pool->tx_byte_pool_list;
+    fragments = pool->tx_byte_pool_fragments;
+
+    while (fragments-- > 0)
+    {
+        UCHAR *next = *((UCHAR **)block);
+        ALIGN_TYPE marker = *((ALIGN_TYPE *)(block + sizeof(UCHAR *)));
+
+        if (marker == TX_BYTE_BLOCK_FREE && next > block)
+        {
+            ULONG free_size = (ULONG)(next - block) - MEM_BUDGET_BLOCK_OVERHEAD;
+
+            if (free_size > largest)
+                largest = free_size;
+        }
+        block = next;
+    }
+    TX_RESTORE
+
+    return largest;
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
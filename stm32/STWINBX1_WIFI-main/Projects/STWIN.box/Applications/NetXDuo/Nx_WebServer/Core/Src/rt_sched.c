@@ -0,0 +1,388 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    rt_sched.c
+  * @author  Wind Turbine Team
+  * @brief   Rate-monotonic priorities and deadline monitoring for the pipeline
+  ******************************************************************************
+  * Open jobs are a FIFO of release ticks per task: Release() pushes, and
+  * Complete()/Skip() pop the oldest, which matches the ring order of the
+  * pipeline. late_flagged counts the open jobs (from the oldest) that the
+  * watchdog already charged as misses, so a late job is counted once
+  * whether the watchdog or the thread sees it first. A release that finds
+  * the FIFO full drops the oldest job as skipped.
+  *
+  * Job CPU time is the thread's execution profile total since its previous
+  * completion, so the wait/wake path and any work between two jobs are
+  * charged to the next job.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "rt_sched.h"
+#include "app_util.h"
+#include "slab_alloc.h"
+#include "timer_wheel.h"
+#include "stm32u5xx.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+_Static_assert(RT_SCHED_REPORT_SIZE <= SLAB_MAX_BLOCK_SIZE, "report does not fit the largest slab class");
+_Static_assert(RT_SCHED_PRIORITY_LOWEST >= RT_SCHED_PRIORITY_HIGHEST + 3, "priority band too narrow for RT_SCHED_PRIORITY()");
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    TX_THREAD             *thread;                     /* NULL until registered */
+    ULONG                  period_ms;
+    ULONG                  budget_us;
+
+    ULONG                  release[RT_SCHED_MAX_BACKLOG];  /* tx_time_get() of the open jobs */
+    uint32_t               head;                       /* Oldest open job */
+    uint32_t               count;
+    uint32_t               late_flagged;               /* Open jobs already counted late by the watchdog */
+    uint8_t                overrun_flagged;            /* Oldest job already counted over budget */
+    uint64_t               cpu_mark;                   /* Thread cycles at the previous completion */
+
+    RtSched_Stats_t        stats;
+} RtSched_TaskState_t;
+
+typedef struct
+{
+    RtSched_TaskState_t    tasks[RT_SCHED_TASK_COUNT];
+    TimerWheel_Timer_t     watchdog;
+    UINT                   is_ready;
+} RtSched_Context_t;
+
+/* Private variables ---------------------------------------------------------*/
+static RtSched_Context_t rt_ctx;
+
+static const char *const rt_sched_task_names[RT_SCHED_TASK_COUNT] =
+{
+    "audio acq",
+    "feature",
+    "telemetry",
+};
+
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+extern TX_THREAD *_tx_thread_current_ptr;
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+static void RtSched_WatchdogTimer(ULONG input);
+static uint64_t RtSched_ThreadCycles(TX_THREAD *thread);
+static ULONG RtSched_Pop(RtSched_TaskState_t *t, uint8_t *was_late);
+
+/**
+  * @brief  Create the watchdog timer
+  * @retval TX_SUCCESS or error code
+  */
+UINT RtSched_Init(void)
+{
+    UINT status;
+
+    memset(&rt_ctx, 0, sizeof(rt_ctx));
+
+    TimerWheel_Create(&rt_ctx.watchdog, "RT Sched Watchdog", RtSched_WatchdogTimer, 0);
+    status = TimerWheel_Start(&rt_ctx.watchdog,
+                              RT_SCHED_WATCHDOG_MS * TX_TIMER_TICKS_PER_SECOND / 1000U,
+                              RT_SCHED_WATCHDOG_MS * TX_TIMER_TICKS_PER_SECOND / 1000U,
+                              TIMER_WHEEL_SLACK(RT_SCHED_WATCHDOG_MS * TX_TIMER_TICKS_PER_SECOND / 1000U));
+    if (status != TX_SUCCESS)
+        return status;
+
+    rt_ctx.is_ready = 1;
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Attach a thread to a task
+  * @param  task: RtSched_Task_t
+  * @param  thread: thread that completes the task's jobs
+  * @param  period_ms: period and relative deadline
+  * @param  budget_us: CPU time allowed per job
+  * @retval TX_SUCCESS or error code
+  */
+UINT RtSched_Register(RtSched_Task_t task, TX_THREAD *thread, ULONG period_ms, ULONG budget_us)
+{
+    RtSched_TaskState_t *t;
+
+    if ((uint32_t)task >= RT_SCHED_TASK_COUNT || period_ms == 0U)
+        return TX_SIZE_ERROR;
+    if (!thread)
+        return TX_PTR_ERROR;
+
+    t = &rt_ctx.tasks[task];
+    t->period_ms = period_ms;
+    t->budget_us = budget_us;
+    t->cpu_mark = RtSched_ThreadCycles(thread);
+    t->thread = thread;
+
+    /* A priority that is not the rate-monotonic one is a configuration error worth a line */
+    if (thread->tx_thread_user_priority != RT_SCHED_PRIORITY(period_ms))
+        printf("RtSched: %s runs at %u, rate-monotonic is %u\n", rt_sched_task_names[task],
+               (unsigned)thread->tx_thread_user_priority, (unsigned)RT_SCHED_PRIORITY(period_ms));
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  A job of the task became ready
+  * @param  task: RtSched_Task_t
+  * @retval None
+  */
+void RtSched_Release(RtSched_Task_t task)
+{
+    TX_INTERRUPT_SAVE_AREA
+    RtSched_TaskState_t *t;
+    uint8_t was_late;
+
+    if ((uint32_t)task >= RT_SCHED_TASK_COUNT || !rt_ctx.tasks[task].thread)
+        return;
+    t = &rt_ctx.tasks[task];
+
+    TX_DISABLE
+    if (t->count == RT_SCHED_MAX_BACKLOG)
+    {
+        RtSched_Pop(t, &was_late);
+        if (!was_late)
+            t->stats.misses++;
+        t->stats.skipped++;
+    }
+    t->release[(t->head + t->count) % RT_SCHED_MAX_BACKLOG] = tx_time_get();
+    t->count++;
+    if (t->count > t->stats.backlog_max)
+        t->stats.backlog_max = t->count;
+    TX_RESTORE
+}
+
+/**
+  * @brief  The oldest open job is done
+  * @param  task: RtSched_Task_t
+  * @retval None
+  */
+void RtSched_Complete(RtSched_Task_t task)
+{
+    TX_INTERRUPT_SAVE_AREA
+    RtSched_TaskState_t *t;
+    uint64_t cycles;
+    uint32_t cpu_us;
+    ULONG response;
+    ULONG release;
+    uint8_t was_late;
+    uint8_t was_over;
+
+    if ((uint32_t)task >= RT_SCHED_TASK_COUNT || !rt_ctx.tasks[task].thread)
+        return;
+    t = &rt_ctx.tasks[task];
+
+    cycles = RtSched_ThreadCycles(t->thread);
+
+    TX_DISABLE
+    if (t->count == 0U)
+    {
+        TX_RESTORE
+        return;
+    }
+    release = RtSched_Pop(t, &was_late);
+    was_over = t->overrun_flagged;
+    t->overrun_flagged = 0;
+    cpu_us = (uint32_t)((cycles - t->cpu_mark) / (SystemCoreClock / 1000000U));
+    t->cpu_mark = cycles;
+    response = (tx_time_get() - release) * 1000U / TX_TIMER_TICKS_PER_SECOND;
+
+    /* The watchdog and Release() count misses too */
+    t->stats.jobs++;
+    if (response > t->stats.response_max_ms)
+        t->stats.response_max_ms = response;
+    if (cpu_us > t->stats.cpu_max_us)
+        t->stats.cpu_max_us = cpu_us;
+    if (response > t->period_ms && !was_late)
+        t->stats.misses++;
+    if (cpu_us > t->budget_us && !was_over)
+        t->stats.overruns++;
+    TX_RESTORE
+}
+
+/**
+  * @brief  The oldest open job was dropped without being run
+  * @param  task: RtSched_Task_t
+  * @retval None
+  */
+void RtSched_Skip(RtSched_Task_t task)
+{
+    TX_INTERRUPT_SAVE_AREA
+    RtSched_TaskState_t *t;
+    uint8_t was_late;
+
+    if ((uint32_t)task >= RT_SCHED_TASK_COUNT || !rt_ctx.tasks[task].thread)
+        return;
+    t = &rt_ctx.tasks[task];
+
+    TX_DISABLE
+    if (t->count > 0U)
+    {
+        RtSched_Pop(t, &was_late);
+        if (!was_late)
+            t->stats.misses++;
+        t->stats.skipped++;
+    }
+    TX_RESTORE
+}
+
+/**
+  * @brief  Counters of one task
+  * @param  task: RtSched_Task_t
+  * @param  stats: output
+  * @retval None
+  */
+void RtSched_GetStats(RtSched_Task_t task, RtSched_Stats_t *stats)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if ((uint32_t)task >= RT_SCHED_TASK_COUNT || !stats)
+        return;
+
+    TX_DISABLE
+    *stats = rt_ctx.tasks[task].stats;
+    TX_RESTORE
+}
+
+/**
+  * @brief  Clear the counters of every task
+  * @retval None
+  */
+void RtSched_ResetStats(void)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    for (uint32_t i = 0; i < RT_SCHED_TASK_COUNT; i++)
+        memset(&rt_ctx.tasks[i].stats, 0, sizeof(rt_ctx.tasks[i].stats));
+    TX_RESTORE
+}
+
+/**
+  * @brief  Format the counters as CSV lines
+  * @param  buf: output buffer
+  * @param  size: buffer size
+  * @retval Number of characters written (excluding terminator)
+  */
+uint32_t RtSched_Format(char *buf, uint32_t size)
+{
+    uint32_t len = 0;
+
+    if (!buf || size == 0U)
+        return 0;
+    buf[0] = '\0';
+
+    for (uint32_t i = 0; i < RT_SCHED_TASK_COUNT; i++)
+    {
+        const RtSched_TaskState_t *t = &rt_ctx.tasks[i];
+        RtSched_Stats_t stats;
+
+        if (!t->thread)
+            continue;
+        RtSched_GetStats((RtSched_Task_t)i, &stats);
+        len = App_Append(buf, size, len, "task,%s,%u,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+                         rt_sched_task_names[i], (unsigned)t->thread->tx_thread_user_priority,
+                         (unsigned long)t->period_ms, (unsigned long)t->budget_us,
+                         (unsigned long)stats.jobs, (unsigned long)stats.misses,
+                         (unsigned long)stats.overruns, (unsigned long)stats.skipped,
+                         (unsigned long)stats.response_max_ms, (unsigned long)stats.cpu_max_us,
+                         (unsigned long)stats.backlog_max);
+    }
+
+    return len;
+}
+
+/**
+  * @brief  Watchdog: charge open jobs past their deadline or budget
+  * @param  input: unused
+  * @retval None
+  *
+  * Runs in the timer thread, above every pipeline thread, so it sees a
+  * starved job even though its thread never gets to complete it.
+  */
+static void RtSched_WatchdogTimer(ULONG input)
+{
+    TX_INTERRUPT_SAVE_AREA
+    ULONG now = tx_time_get();
+    (void)input;
+
+    for (uint32_t i = 0; i < RT_SCHED_TASK_COUNT; i++)
+    {
+        RtSched_TaskState_t *t = &rt_ctx.tasks[i];
+        ULONG deadline_ticks;
+        uint64_t budget_cycles;
+
+        if (!t->thread)
+            continue;
+        deadline_ticks = t->period_ms * TX_TIMER_TICKS_PER_SECOND / 1000U;
+        budget_cycles = (uint64_t)t->budget_us * (SystemCoreClock / 1000000U);
+
+        TX_DISABLE
+        /* Releases are in order, so stop at the first job still within its deadline */
+        while (t->late_flagged < t->count &&
+               now - t->release[(t->head + t->late_flagged) % RT_SCHED_MAX_BACKLOG] > deadline_ticks)
+        {
+            t->late_flagged++;
+            t->stats.misses++;
+        }
+
+        if (t->count > 0U && !t->overrun_flagged && RtSched_ThreadCycles(t->thread) - t->cpu_mark > budget_cycles)
+        {
+            t->overrun_flagged = 1;
+            t->stats.overruns++;
+        }
+        TX_RESTORE
+    }
+}
+
+/**
+  * @brief  Execution profile cycles of a thread, including the slice in progress
+  * @param  thread: thread
+  * @retval Cycles, 0 without TX_EXECUTION_PROFILE_ENABLE
+  */
+static uint64_t RtSched_ThreadCycles(TX_THREAD *thread)
+{
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+    TX_INTERRUPT_SAVE_AREA
+    uint64_t cycles;
+
+    TX_DISABLE
+    cycles = thread->tx_thread_execution_time_total;
+    if (thread == _tx_thread_current_ptr && thread->tx_thread_execution_time_last_start)
+        cycles += (uint32_t)(DWT->CYCCNT - thread->tx_thread_execution_time_last_start);
+    TX_RESTORE
+
+    return cycles;
+#else
+    (void)thread;
+    return 0;
+#endif
+}
+
+/**
+  * @brief  Remove the oldest open job (interrupts disabled)
+  * @param  t: task state with count > 0
+  * @param  was_late: set if the watchdog already counted it
+  * @retval Release tick
+  */
+static ULONG RtSched_Pop(RtSched_TaskState_t *t, uint8_t *was_late)
+{
+    ULONG release = t->release[t->head];
+
+    *was_late = (t->late_flagged > 0U) ? 1U : 0U;
+    if (t->late_flagged > 0U)
+        t->late_flagged--;
+    t->head = (t->head + 1U) % RT_SCHED_MAX_BACKLOG;
+    t->count--;
+
+    return release;
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
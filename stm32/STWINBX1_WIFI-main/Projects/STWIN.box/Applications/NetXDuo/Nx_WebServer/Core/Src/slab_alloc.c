@@ -0,0 +1,184 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    slab_alloc.c
+  * @author  Wind Turbine Team
+  * @brief   Fixed size-class allocator for hot-path buffers
+  ******************************************************************************
+  * tx_block_allocate() pops the head of the pool's free list. While a block
+  * is allocated, ThreadX keeps the owning pool pointer in the word in front
+  * of it. Slab_Free() uses that word to find the class without a search,
+  * then tx_block_release() pushes the block back.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "slab_alloc.h"
+#include "mem_budget.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define SLAB_CLASS_SIZE(size, count)            (size),
+#define SLAB_CLASS_BLOCKS(size, count)          (count),
+#define SLAB_CHECK_CLASS(size, count)                                               \
+    _Static_assert(((size) % sizeof(ALIGN_TYPE)) == 0, "slab block size must be ALIGN_TYPE aligned"); \
+    _Static_assert((size) <= SLAB_MAX_BLOCK_SIZE, "SLAB_MAX_BLOCK_SIZE is not the largest class");
+
+SLAB_CLASS_TABLE(SLAB_CHECK_CLASS)
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    TX_BLOCK_POOL          pools[SLAB_CLASS_COUNT];
+    Slab_ClassStats_t      stats[SLAB_CLASS_COUNT];
+    uint8_t                is_ready;
+} Slab_Context_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const uint32_t slab_class_size[SLAB_CLASS_COUNT] = { SLAB_CLASS_TABLE(SLAB_CLASS_SIZE) };
+static const uint32_t slab_class_blocks[SLAB_CLASS_COUNT] = { SLAB_CLASS_TABLE(SLAB_CLASS_BLOCKS) };
+
+static Slab_Context_t slab_ctx = {0};
+static ULONG slab_storage[SLAB_STORAGE_SIZE / sizeof(ULONG)];
+
+/**
+  * @brief  Create one block pool per size class
+  * @retval TX_SUCCESS or error code
+  */
+UINT Slab_Init(void)
+{
+    UCHAR *storage = (UCHAR *)slab_storage;
+    UINT status;
+
+    memset(&slab_ctx, 0, sizeof(slab_ctx));
+
+    for (uint32_t i = 0; i < SLAB_CLASS_COUNT; i++)
+    {
+        ULONG pool_size = (slab_class_size[i] + SLAB_BLOCK_OVERHEAD) * slab_class_blocks[i];
+
+        /* Alloc picks the first class that fits */
+        if (i > 0 && slab_class_size[i] <= slab_class_size[i - 1])
+            return TX_SIZE_ERROR;
+
+        status = tx_block_pool_create(&slab_ctx.pools[i], "Slab", slab_class_size[i],
+                                      storage, pool_size);
+        if (status != TX_SUCCESS)
+            return status;
+
+        slab_ctx.stats[i].block_size = slab_class_size[i];
+        slab_ctx.stats[i].blocks = (uint32_t)slab_ctx.pools[i].tx_block_pool_total;
+        storage += pool_size;
+    }
+
+    MemBudget_RegisterStatic("slab", "size-class storage", sizeof(slab_storage));
+    slab_ctx.is_ready = 1;
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Allocate a buffer from the smallest class with a free block
+  * @param  size: bytes needed
+  * @retval Pointer or NULL
+  */
+void *Slab_Alloc(size_t size)
+{
+    TX_INTERRUPT_SAVE_AREA
+    uint32_t fit;
+    VOID *ptr;
+
+    if (!slab_ctx.is_ready || size == 0 || size > SLAB_MAX_BLOCK_SIZE)
+        return NULL;
+
+    for (fit = 0; fit < SLAB_CLASS_COUNT; fit++)
+    {
+        if (size <= slab_class_size[fit])
+            break;
+    }
+
+    for (uint32_t i = fit; i < SLAB_CLASS_COUNT; i++)
+    {
+        if (tx_block_allocate(&slab_ctx.pools[i], &ptr, TX_NO_WAIT) != TX_SUCCESS)
+            continue;
+
+        TX_DISABLE
+        Slab_ClassStats_t *s = &slab_ctx.stats[i];
+        s->allocs++;
+        if (++s->in_use > s->in_use_max)
+            s->in_use_max = s->in_use;
+        if (i != fit)
+            slab_ctx.stats[fit].spills++;
+        TX_RESTORE
+
+        return ptr;
+    }
+
+    TX_DISABLE
+    slab_ctx.stats[fit].failures++;
+    TX_RESTORE
+
+    return NULL;
+}
+
+/**
+  * @brief  Release a buffer
+  * @param  ptr: buffer from Slab_Alloc()
+  * @retval TX_SUCCESS, TX_PTR_ERROR if ptr is not an allocated slab block
+  */
+UINT Slab_Free(void *ptr)
+{
+    TX_INTERRUPT_SAVE_AREA
+    TX_BLOCK_POOL *pool;
+    uint32_t index;
+
+    if (!ptr)
+        return TX_PTR_ERROR;
+
+    /* A released block holds the free-list link there instead: double frees are caught too */
+    pool = *((TX_BLOCK_POOL **)((UCHAR *)ptr - SLAB_BLOCK_OVERHEAD));
+    if ((uintptr_t)pool < (uintptr_t)&slab_ctx.pools[0] ||
+        (uintptr_t)pool > (uintptr_t)&slab_ctx.pools[SLAB_CLASS_COUNT - 1])
+        return TX_PTR_ERROR;
+    index = (uint32_t)(pool - slab_ctx.pools);
+
+    if (tx_block_release(ptr) != TX_SUCCESS)
+        return TX_PTR_ERROR;
+
+    TX_DISABLE
+    slab_ctx.stats[index].in_use--;
+    TX_RESTORE
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Number of size classes
+  * @retval SLAB_CLASS_COUNT
+  */
+uint32_t Slab_GetClassCount(void)
+{
+    return SLAB_CLASS_COUNT;
+}
+
+/**
+  * @brief  Get statistics of one class
+  * @param  index: class index
+  * @param  stats: output
+  * @retval TX_SUCCESS or TX_PTR_ERROR
+  */
+UINT Slab_GetClassStats(uint32_t index, Slab_ClassStats_t *stats)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if (!stats || index >= SLAB_CLASS_COUNT)
+        return TX_PTR_ERROR;
+
+    TX_DISABLE
+    *stats = slab_ctx.stats[index];
+    TX_RESTORE
+
+    return TX_SUCCESS;
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,409 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    staging_log.c
+  * @author  Wind Turbine Team
+  * @brief   Log-structured staging buffer in front of SD card writes
+  ******************************************************************************
+  * Ring protocol (multi-producer, single consumer):
+  *
+  * - reserve_pos / read_pos are free-running byte counters, the ring index is
+  *   counter & (capacity - 1).
+  * - A producer reserves space with a CAS on reserve_pos, copies its payload,
+  *   then publishes the 4-byte record header with the READY bit (release).
+  * - If a record would straddle the end of the ring, the producer reserves the
+  *   tail as a PAD record and places the record at the start.
+  * - The flusher consumes READY records in order, stops at the first one that
+  *   is still being written, zeroes the consumed bytes (so stale data can never
+  *   look like a READY header) and then advances read_pos (release).
+  *
+  * No producer ever waits on another one, so a preempted low-priority producer
+  * only delays the flusher, never a higher-priority producer.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "staging_log.h"
+#include "main.h"
+#include "mem_budget.h"
+#include <string.h>
+#include <stdio.h>
+
+#if (STAGING_LOG_USE_PSRAM != 0)
+#include "b_u585i_iot02a_ospi.h"
+#endif
+
+/* Private defines -----------------------------------------------------------*/
+#define STAGING_REC_READY       0x80000000U
+#define STAGING_REC_PAD         0x40000000U
+#define STAGING_REC_LEN_MASK    0x00FFFFFFU
+#define STAGING_REC_HDR_SIZE    4U
+
+#define STAGING_ALIGN4(x)       (((x) + 3U) & ~3U)
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    uint8_t               *ring;                       /* Backing store */
+    uint32_t               capacity;                   /* Power of two */
+    uint32_t               reserve_pos;                /* Producers (CAS) */
+    uint32_t               read_pos;                   /* Flusher only writes */
+
+    TX_THREAD              thread;                     /* Flusher thread */
+    uint8_t               *thread_stack;
+    FX_MEDIA              *media;                      /* SD card media */
+    FX_FILE                file;
+    uint8_t                file_open;
+
+    uint32_t               chunk_len;                  /* Bytes staged in chunk */
+    ULONG                  last_data_tick;             /* Last time data was consumed */
+
+    StagingLog_Stats_t     stats;
+} StagingLog_Context_t;
+
+/* Private variables ---------------------------------------------------------*/
+static StagingLog_Context_t staging_ctx = {0};
+
+/* SD write buffer: whole sectors, cache-line aligned for the SDMMC DMA */
+ALIGN_32BYTES (static uint8_t staging_chunk[STAGING_LOG_CHUNK_SIZE]);
+
+#if (STAGING_LOG_USE_PSRAM == 0)
+static uint32_t staging_sram_ring[STAGING_LOG_SRAM_SIZE / sizeof(uint32_t)];
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+static void StagingLog_ThreadEntry(ULONG thread_input);
+static uint32_t StagingLog_Drain(void);
+static UINT StagingLog_OpenFile(void);
+static UINT StagingLog_WriteChunk(void);
+
+/**
+  * @brief  Set up the ring and create the flusher thread
+  * @param  byte_pool: ThreadX byte pool
+  * @retval TX_SUCCESS or error code
+  */
+UINT StagingLog_Init(TX_BYTE_POOL *byte_pool)
+{
+    UINT status;
+
+    if (!byte_pool)
+        return TX_PTR_ERROR;
+
+    memset(&staging_ctx, 0, sizeof(staging_ctx));
+
+#if (STAGING_LOG_USE_PSRAM != 0)
+    BSP_OSPI_RAM_Init_t psram;
+
+    psram.LatencyType = BSP_OSPI_RAM_FIXED_LATENCY;
+    psram.BurstType   = BSP_OSPI_RAM_LINEAR_BURST;
+    psram.BurstLength = BSP_OSPI_RAM_BURST_32_BYTES;
+
+    if (BSP_OSPI_RAM_Init(0, &psram) != BSP_ERROR_NONE)
+        return TX_NOT_AVAILABLE;
+
+    if (BSP_OSPI_RAM_EnableMemoryMappedMode(0) != BSP_ERROR_NONE)
+        return TX_NOT_AVAILABLE;
+
+    staging_ctx.ring = (uint8_t *)STAGING_LOG_PSRAM_BASE;
+    staging_ctx.capacity = STAGING_LOG_PSRAM_SIZE;
+#else
+    staging_ctx.ring = (uint8_t *)staging_sram_ring;
+    staging_ctx.capacity = STAGING_LOG_SRAM_SIZE;
+    MemBudget_RegisterStatic("staging_log", "ring", sizeof(staging_sram_ring));
+#endif
+    MemBudget_RegisterStatic("staging_log", "SD write chunk", sizeof(staging_chunk));
+
+    /* Headers are detected by their READY bit, start from a clean ring */
+    memset(staging_ctx.ring, 0, staging_ctx.capacity);
+    staging_ctx.stats.capacity = staging_ctx.capacity;
+
+    status = MemBudget_Allocate(byte_pool,
+                                (VOID **)&staging_ctx.thread_stack,
+                                STAGING_LOG_THREAD_STACK_SIZE,
+                                "staging_log", "flusher stack");
+    if (status != TX_SUCCESS)
+        return status;
+
+    status = tx_thread_create(&staging_ctx.thread,
+                              "Staging Log Flush",
+                              StagingLog_ThreadEntry,
+                              0,
+                              staging_ctx.thread_stack,
+                              STAGING_LOG_THREAD_STACK_SIZE,
+                              STAGING_LOG_THREAD_PRIORITY,
+                              STAGING_LOG_THREAD_PRIORITY,
+                              TX_NO_TIME_SLICE,
+                              TX_DONT_START);
+
+    return status;
+}
+
+/**
+  * @brief  Start draining to the SD card
+  * @param  media: FileX media
+  * @retval TX_SUCCESS on success
+  */
+UINT StagingLog_Start(FX_MEDIA *media)
+{
+    if (!media)
+        return TX_PTR_ERROR;
+
+    staging_ctx.media = media;
+
+    return tx_thread_resume(&staging_ctx.thread);
+}
+
+/**
+  * @brief  Append one record (lock-free, non-blocking)
+  * @param  data: payload
+  * @param  len: payload length
+  * @retval TX_SUCCESS, TX_NO_MEMORY (ring full) or TX_SIZE_ERROR
+  */
+UINT StagingLog_Append(const void *data, uint32_t len)
+{
+    uint32_t total;
+    uint32_t start;
+    uint32_t offset;
+    uint32_t pad;
+    uint32_t *hdr;
+
+    if (!data || len == 0)
+        return TX_PTR_ERROR;
+
+    if (staging_ctx.capacity == 0)
+        return TX_NOT_AVAILABLE;
+
+    total = STAGING_REC_HDR_SIZE + STAGING_ALIGN4(len);
+    if (len > STAGING_REC_LEN_MASK || total > staging_ctx.capacity / 2)
+        return TX_SIZE_ERROR;
+
+    /* Reserve [start, start + pad + total) */
+    start = __atomic_load_n(&staging_ctx.reserve_pos, __ATOMIC_RELAXED);
+    do
+    {
+        uint32_t read_pos = __atomic_load_n(&staging_ctx.read_pos, __ATOMIC_ACQUIRE);
+
+        offset = start & (staging_ctx.capacity - 1U);
+        pad = (offset + total > staging_ctx.capacity) ? (staging_ctx.capacity - offset) : 0U;
+
+        if ((start + pad + total) - read_pos > staging_ctx.capacity)
+        {
+            __atomic_fetch_add(&staging_ctx.stats.dropped_records, 1U, __ATOMIC_RELAXED);
+            return TX_NO_MEMORY;
+        }
+    } while (!__atomic_compare_exchange_n(&staging_ctx.reserve_pos, &start, start + pad + total,
+                                          1, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    if (pad)
+    {
+        hdr = (uint32_t *)&staging_ctx.ring[offset];
+        __atomic_store_n(hdr, STAGING_REC_READY | STAGING_REC_PAD | (pad - STAGING_REC_HDR_SIZE),
+                         __ATOMIC_RELEASE);
+        offset = 0;
+    }
+
+    memcpy(&staging_ctx.ring[offset + STAGING_REC_HDR_SIZE], data, len);
+
+    /* Publish: the flusher may consume the record from here on */
+    hdr = (uint32_t *)&staging_ctx.ring[offset];
+    __atomic_store_n(hdr, STAGING_REC_READY | len, __ATOMIC_RELEASE);
+
+    __atomic_fetch_add(&staging_ctx.stats.appended_bytes, len, __ATOMIC_RELAXED);
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Get current watermark level
+  * @retval StagingLog_Level_t
+  */
+StagingLog_Level_t StagingLog_GetLevel(void)
+{
+    uint32_t fill;
+
+    if (staging_ctx.capacity == 0)
+        return STAGING_LOG_LEVEL_NORMAL;
+
+    fill = __atomic_load_n(&staging_ctx.reserve_pos, __ATOMIC_RELAXED) -
+           __atomic_load_n(&staging_ctx.read_pos, __ATOMIC_RELAXED);
+
+    if (fill >= (staging_ctx.capacity / 100U) * STAGING_LOG_CRITICAL_PERCENT)
+        return STAGING_LOG_LEVEL_CRITICAL;
+
+    if (fill >= (staging_ctx.capacity / 100U) * STAGING_LOG_HIGH_PERCENT)
+        return STAGING_LOG_LEVEL_HIGH;
+
+    return STAGING_LOG_LEVEL_NORMAL;
+}
+
+/**
+  * @brief  Get statistics snapshot
+  * @param  stats: output
+  * @retval None
+  */
+void StagingLog_GetStats(StagingLog_Stats_t *stats)
+{
+    if (!stats)
+        return;
+
+    memcpy(stats, &staging_ctx.stats, sizeof(*stats));
+    stats->fill = staging_ctx.reserve_pos - staging_ctx.read_pos;
+}
+
+/**
+  * @brief  Flusher thread entry
+  * @param  thread_input: unused
+  * @retval None
+  *
+  * Drains the ring into staging_chunk and writes it to the card whenever a
+  * full chunk is ready, or after STAGING_LOG_IDLE_FLUSH_MS without new data.
+  */
+static void StagingLog_ThreadEntry(ULONG thread_input)
+{
+    (void)thread_input;
+
+    /* The web server thread opens the SD media */
+    while (staging_ctx.media->fx_media_id != FX_MEDIA_ID)
+        tx_thread_sleep(500);
+
+    if (StagingLog_OpenFile() != FX_SUCCESS)
+    {
+        printf("Staging log: cannot open %s, flusher stopped\n", STAGING_LOG_FILE_NAME);
+        tx_thread_suspend(&staging_ctx.thread);
+    }
+
+    staging_ctx.last_data_tick = tx_time_get();
+
+    while (1)
+    {
+        if (StagingLog_Drain() > 0)
+            staging_ctx.last_data_tick = tx_time_get();
+
+        if (staging_ctx.chunk_len > 0 &&
+            (tx_time_get() - staging_ctx.last_data_tick) >= STAGING_LOG_IDLE_FLUSH_MS)
+        {
+            StagingLog_WriteChunk();
+            if (fx_media_flush(staging_ctx.media) != FX_SUCCESS)
+                staging_ctx.stats.write_errors++;
+        }
+
+        tx_thread_sleep(STAGING_LOG_POLL_MS);
+    }
+}
+
+/**
+  * @brief  Move all published records from the ring to the SD card
+  * @retval Number of payload bytes consumed
+  */
+static uint32_t StagingLog_Drain(void)
+{
+    uint32_t consumed = 0;
+    uint32_t fill;
+
+    while (staging_ctx.read_pos != __atomic_load_n(&staging_ctx.reserve_pos, __ATOMIC_ACQUIRE))
+    {
+        uint32_t offset = staging_ctx.read_pos & (staging_ctx.capacity - 1U);
+        uint32_t *hdr_ptr = (uint32_t *)&staging_ctx.ring[offset];
+        uint32_t hdr = __atomic_load_n(hdr_ptr, __ATOMIC_ACQUIRE);
+        uint32_t len;
+        uint32_t total;
+
+        /* Track the high-water mark before consuming */
+        fill = staging_ctx.reserve_pos - staging_ctx.read_pos;
+        if (fill > staging_ctx.stats.fill_max)
+            staging_ctx.stats.fill_max = fill;
+
+        if (!(hdr & STAGING_REC_READY))
+            break;  /* Producer still copying, retry next poll */
+
+        len = hdr & STAGING_REC_LEN_MASK;
+        total = STAGING_REC_HDR_SIZE + STAGING_ALIGN4(len);
+
+        if (!(hdr & STAGING_REC_PAD))
+        {
+            const uint8_t *src = &staging_ctx.ring[offset + STAGING_REC_HDR_SIZE];
+            uint32_t left = len;
+
+            while (left > 0)
+            {
+                uint32_t room = STAGING_LOG_CHUNK_SIZE - staging_ctx.chunk_len;
+                uint32_t n = (left < room) ? left : room;
+
+                memcpy(&staging_chunk[staging_ctx.chunk_len], src, n);
+                staging_ctx.chunk_len += n;
+                src += n;
+                left -= n;
+
+                if (staging_ctx.chunk_len == STAGING_LOG_CHUNK_SIZE)
+                    StagingLog_WriteChunk();
+            }
+            consumed += len;
+        }
+
+        /* Clear before release so no stale word can look like a READY header */
+        memset(&staging_ctx.ring[offset], 0, total);
+        __atomic_store_n(&staging_ctx.read_pos, staging_ctx.read_pos + total, __ATOMIC_RELEASE);
+    }
+
+    return consumed;
+}
+
+/**
+  * @brief  Open (or create) the log file and seek to its end
+  * @retval FX_SUCCESS on success
+  */
+static UINT StagingLog_OpenFile(void)
+{
+    UINT status;
+
+    status = fx_file_create(staging_ctx.media, STAGING_LOG_FILE_NAME);
+    if (status != FX_SUCCESS && status != FX_ALREADY_CREATED)
+        return status;
+
+    status = fx_file_open(staging_ctx.media, &staging_ctx.file, STAGING_LOG_FILE_NAME, FX_OPEN_FOR_WRITE);
+    if (status != FX_SUCCESS)
+        return status;
+
+    status = fx_file_relative_seek(&staging_ctx.file, 0, FX_SEEK_END);
+    if (status != FX_SUCCESS)
+    {
+        fx_file_close(&staging_ctx.file);
+        return status;
+    }
+
+    staging_ctx.file_open = 1;
+    return FX_SUCCESS;
+}
+
+/**
+  * @brief  Write the staged chunk to the card
+  * @retval FX_SUCCESS on success
+  */
+static UINT StagingLog_WriteChunk(void)
+{
+    UINT status;
+    ULONG start;
+    ULONG elapsed;
+
+    if (!staging_ctx.file_open || staging_ctx.chunk_len == 0)
+        return FX_SUCCESS;
+
+    start = tx_time_get();
+    status = fx_file_write(&staging_ctx.file, staging_chunk, staging_ctx.chunk_len);
+    elapsed = (tx_time_get() - start) * 1000U / TX_TIMER_TICKS_PER_SECOND;
+
+    if (elapsed > staging_ctx.stats.write_max_ms)
+        staging_ctx.stats.write_max_ms = elapsed;
+
+    if (status == FX_SUCCESS)
+        staging_ctx.stats.flushed_bytes += staging_ctx.chunk_len;
+    else
+        staging_ctx.stats.write_errors++;
+
+    /* On error the chunk is dropped, the ring keeps draining */
+    staging_ctx.chunk_len = 0;
+    return status;
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,816 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    timer_wheel.c
+  * @author  Wind Turbine Team
+  * @brief   Hierarchical timer wheel with slack-based coalescing
+  ******************************************************************************
+  * Classic cascading wheel: a timer goes to the lowest level whose range
+  * covers its distance from the wheel time, and when level 0 starts a new
+  * round the next slot of level 1 is redistributed (level 2 when level 1
+  * starts a new round, and so on). Each level keeps a bitmap of its
+  * non-empty slots, so finding the next expiry and skipping empty ticks
+  * cost one bit scan per level rather than a walk of the slots.
+  *
+  * The driver timer is re-armed after every batch for the earliest expiry,
+  * at most TIMER_WHEEL_MAX_SLEEP ticks ahead; this bounds the ticks one
+  * wakeup has to advance over. Wheel state is only touched with interrupts
+  * disabled; the callbacks run with interrupts enabled, one timer taken off
+  * the expired list at a time so a stop from a callback or an interrupt
+  * still finds it.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "timer_wheel.h"
+#include "app_util.h"
+#include "mem_budget.h"
+#include "slab_alloc.h"
+#include "stm32u5xx.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define TIMER_WHEEL_MASK            (TIMER_WHEEL_SLOTS - 1U)
+#define TIMER_WHEEL_SHIFT(level)    ((level) * TIMER_WHEEL_LEVEL_BITS)
+#define TIMER_WHEEL_RANGE           (1UL << TIMER_WHEEL_SHIFT(TIMER_WHEEL_LEVELS))
+#define TIMER_WHEEL_WHEEL_SLOTS     (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS)
+#define TIMER_WHEEL_EXPIRED_SLOT    TIMER_WHEEL_WHEEL_SLOTS     /* Batch being run */
+#define TIMER_WHEEL_NO_SLOT         0xFFFFU
+#define TIMER_WHEEL_BENCH_SEED      0x2545F491U
+
+_Static_assert(TIMER_WHEEL_SLOTS == 32U, "slot bitmaps are one uint32_t per level");
+_Static_assert(TIMER_WHEEL_REPORT_SIZE <= SLAB_MAX_BLOCK_SIZE, "report does not fit the largest slab class");
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    TimerWheel_Timer_t    *lists[TIMER_WHEEL_WHEEL_SLOTS + 1];  /* Wheel slots, then the expired batch */
+    uint32_t               occupied[TIMER_WHEEL_LEVELS];        /* Non-empty slots, one bit each */
+    ULONG                  now;                                 /* Next tick to process */
+
+    TX_TIMER               driver;
+    ULONG                  armed_at;                            /* Tick the driver expires on */
+    uint8_t                armed;
+    uint8_t                started;                             /* Driver ran once, the kernel is up */
+    uint8_t                processing;                          /* Driver callback running, it re-arms at the end */
+    UINT                   is_ready;
+
+    TimerWheel_Stats_t     stats;
+} TimerWheel_Context_t;
+
+typedef struct
+{
+    uint32_t               timers;
+    uint32_t               fired;
+    uint32_t               wakeups;
+    uint32_t               timer_thread_us;
+    UCHAR                  is_done;
+} TimerWheel_BenchResult_t;
+
+typedef struct
+{
+    union
+    {
+        TX_TIMER           native[TIMER_WHEEL_BENCH_MAX];
+        TimerWheel_Timer_t wheel[TIMER_WHEEL_BENCH_MAX];
+    } timers;
+    volatile TimerWheel_BenchState_t state;
+    ULONG                  count;
+    ULONG                  seconds;
+    TimerWheel_BenchResult_t results[2];       /* tx_timer, then wheel */
+    uint32_t               fired;
+    uint32_t               wakeups;
+    ULONG                  last_tick;
+
+    TX_THREAD              thread;
+    TX_SEMAPHORE           start;
+} TimerWheel_Bench_t;
+
+/* Private variables ---------------------------------------------------------*/
+static TimerWheel_Context_t wheel_ctx;
+static TimerWheel_Bench_t wheel_bench;
+static ULONG wheel_bench_stack[TIMER_WHEEL_BENCH_STACK_SIZE / sizeof(ULONG)];
+static const char *const wheel_bench_modes[2] = { "tx_timer", "wheel" };
+
+/* Periods of the benchmark timers in ticks, like the NetX and application timers */
+static const ULONG wheel_bench_periods[] = { 10, 20, 25, 50, 100, 200, 250, 500, 1000 };
+
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+extern TX_THREAD _tx_timer_thread;
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+static void TimerWheel_DriverTimer(ULONG input);
+static void TimerWheel_Link(TimerWheel_Timer_t *timer, uint32_t slot);
+static void TimerWheel_Unlink(TimerWheel_Timer_t *timer);
+static void TimerWheel_Insert(TimerWheel_Timer_t *timer);
+static void TimerWheel_Cascade(uint32_t level);
+static void TimerWheel_Advance(ULONG target);
+static ULONG TimerWheel_NextExpiry(void);
+static void TimerWheel_Arm(void);
+static ULONG TimerWheel_Align(ULONG deadline, ULONG slack);
+static uint32_t TimerWheel_FirstFrom(uint32_t bits, uint32_t from);
+static VOID TimerWheel_BenchThreadEntry(ULONG input);
+static void TimerWheel_BenchCallback(ULONG input);
+static uint64_t TimerWheel_TimerThreadCycles(void);
+
+/**
+  * @brief  Create the driver timer
+  * @retval TX_SUCCESS or error code
+  */
+UINT TimerWheel_Init(void)
+{
+    UINT status;
+
+    memset(&wheel_ctx, 0, sizeof(wheel_ctx));
+    wheel_ctx.now = tx_time_get();
+
+    /* tx_timer_change() is refused during initialization: run once on the
+       first tick and arm for real from there */
+    status = tx_timer_create(&wheel_ctx.driver,
+                             "Timer Wheel",
+                             TimerWheel_DriverTimer,
+                             0,
+                             1,
+                             0,
+                             TX_AUTO_ACTIVATE);
+    if (status != TX_SUCCESS)
+        return status;
+
+    wheel_ctx.is_ready = 1;
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Set up a stopped timer
+  * @param  timer: timer storage
+  * @param  name: diagnostic name
+  * @param  callback: run in the timer thread
+  * @param  input: callback argument
+  * @retval TX_SUCCESS or TX_PTR_ERROR
+  */
+UINT TimerWheel_Create(TimerWheel_Timer_t *timer, const CHAR *name,
+                       TimerWheel_Callback_t callback, ULONG input)
+{
+    if (!timer || !callback)
+        return TX_PTR_ERROR;
+
+    memset(timer, 0, sizeof(*timer));
+    timer->name = name;
+    timer->callback = callback;
+    timer->input = input;
+    timer->slot = TIMER_WHEEL_NO_SLOT;
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Start or restart a timer
+  * @param  timer: created timer
+  * @param  initial_ticks: ticks to the first deadline
+  * @param  period_ticks: ticks between deadlines, 0 for one-shot
+  * @param  slack_ticks: allowed lateness
+  * @retval TX_SUCCESS or error code
+  */
+UINT TimerWheel_Start(TimerWheel_Timer_t *timer, ULONG initial_ticks,
+                      ULONG period_ticks, ULONG slack_ticks)
+{
+    TX_INTERRUPT_SAVE_AREA
+    ULONG current;
+
+    if (!timer || !timer->callback)
+        return TX_PTR_ERROR;
+    if (initial_ticks == 0U)
+        return TX_TICK_ERROR;
+    if (!wheel_ctx.is_ready)
+        return TX_NOT_AVAILABLE;
+
+    if (slack_ticks >= TIMER_WHEEL_RANGE)
+        slack_ticks = TIMER_WHEEL_RANGE - 1U;
+
+    TX_DISABLE
+    current = tx_time_get();
+    if (timer->slot != TIMER_WHEEL_NO_SLOT)
+    {
+        TimerWheel_Unlink(timer);
+    }
+    else
+    {
+        /* An empty wheel is not advanced by the driver, catch up first */
+        if (wheel_ctx.stats.active == 0U && (LONG)(current - wheel_ctx.now) > 0)
+            wheel_ctx.now = current;
+        wheel_ctx.stats.active++;
+    }
+
+    timer->period = period_ticks;
+    timer->slack = slack_ticks;
+    timer->nominal = current + initial_ticks;
+    timer->expires = TimerWheel_Align(timer->nominal, slack_ticks);
+    TimerWheel_Insert(timer);
+    TimerWheel_Arm();
+    TX_RESTORE
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Stop a timer
+  * @param  timer: created timer
+  * @retval None
+  */
+void TimerWheel_Stop(TimerWheel_Timer_t *timer)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if (!timer)
+        return;
+
+    /* The driver may stay armed for it; that wakeup just finds nothing due */
+    TX_DISABLE
+    if (timer->slot != TIMER_WHEEL_NO_SLOT)
+    {
+        TimerWheel_Unlink(timer);
+        wheel_ctx.stats.active--;
+    }
+    TX_RESTORE
+}
+
+/**
+  * @brief  Wheel counters
+  * @param  stats: output
+  * @retval None
+  */
+void TimerWheel_GetStats(TimerWheel_Stats_t *stats)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if (!stats)
+        return;
+
+    TX_DISABLE
+    *stats = wheel_ctx.stats;
+    TX_RESTORE
+}
+
+/**
+  * @brief  Format the wheel counters
+  * @param  buf: output buffer
+  * @param  size: buffer size
+  * @retval Number of characters written
+  */
+uint32_t TimerWheel_Format(char *buf, uint32_t size)
+{
+    TimerWheel_Stats_t stats;
+
+    if (!buf || size == 0U)
+        return 0;
+
+    buf[0] = '\0';
+    TimerWheel_GetStats(&stats);
+
+    return App_Append(buf, size, 0, "wheel,%lu,%lu,%lu,%lu,%lu,%lu\n",
+                      (unsigned long)stats.active, (unsigned long)stats.wakeups,
+                      (unsigned long)stats.fired, (unsigned long)stats.batch_max,
+                      (unsigned long)stats.cascades, (unsigned long)stats.late);
+}
+
+/**
+  * @brief  Create the benchmark runner thread
+  * @retval TX_SUCCESS or error code
+  */
+UINT TimerWheel_BenchInit(void)
+{
+    UINT status;
+
+    status = tx_semaphore_create(&wheel_bench.start, "Timer Wheel Bench Start", 0);
+    if (status != TX_SUCCESS)
+        return status;
+
+    MemBudget_RegisterStatic("timer_wheel", "bench runner stack", sizeof(wheel_bench_stack));
+
+    return tx_thread_create(&wheel_bench.thread,
+                            "Timer Wheel Bench",
+                            TimerWheel_BenchThreadEntry,
+                            0,
+                            wheel_bench_stack,
+                            sizeof(wheel_bench_stack),
+                            TIMER_WHEEL_BENCH_PRIORITY,
+                            TIMER_WHEEL_BENCH_PRIORITY,
+                            TX_NO_TIME_SLICE,
+                            TX_AUTO_START);
+}
+
+/**
+  * @brief  Start the benchmark in the runner thread
+  * @param  count: timers per phase
+  * @param  seconds: phase length
+  * @retval TX_SUCCESS or TX_NOT_AVAILABLE
+  */
+UINT TimerWheel_BenchStart(ULONG count, ULONG seconds)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if (count == 0U)
+        count = 1U;
+    if (count > TIMER_WHEEL_BENCH_MAX)
+        count = TIMER_WHEEL_BENCH_MAX;
+    if (seconds == 0U)
+        seconds = 1U;
+    if (seconds > TIMER_WHEEL_BENCH_MAX_SECONDS)
+        seconds = TIMER_WHEEL_BENCH_MAX_SECONDS;
+
+    TX_DISABLE
+    if (wheel_bench.state == TIMER_WHEEL_BENCH_RUNNING)
+    {
+        TX_RESTORE
+        return TX_NOT_AVAILABLE;
+    }
+    wheel_bench.state = TIMER_WHEEL_BENCH_RUNNING;
+    TX_RESTORE
+
+    wheel_bench.count = count;
+    wheel_bench.seconds = seconds;
+    memset(wheel_bench.results, 0, sizeof(wheel_bench.results));
+
+    return tx_semaphore_put(&wheel_bench.start);
+}
+
+/**
+  * @brief  Format the wheel counters and the last benchmark as CSV lines
+  * @param  buf: output buffer
+  * @param  size: buffer size
+  * @retval Number of characters written (excluding terminator)
+  */
+uint32_t TimerWheel_BenchFormat(char *buf, uint32_t size)
+{
+    static const char *const state_names[] = { "idle", "running", "done" };
+    uint32_t len;
+
+    len = TimerWheel_Format(buf, size);
+    if (len == 0U)
+        return 0;
+
+    len = App_Append(buf, size, len, "run,%s,%lu,%lu\n", state_names[wheel_bench.state],
+                     (unsigned long)wheel_bench.count, (unsigned long)wheel_bench.seconds);
+
+    for (uint32_t mode = 0; mode < 2U; mode++)
+    {
+        const TimerWheel_BenchResult_t *result = &wheel_bench.results[mode];
+
+        if (!result->is_done)
+            continue;
+        len = App_Append(buf, size, len, "bench,%s,%lu,%lu,%lu,%lu,%lu,%lu\n",
+                         wheel_bench_modes[mode], (unsigned long)result->timers,
+                         (unsigned long)wheel_bench.seconds,
+                         (unsigned long)result->fired, (unsigned long)result->wakeups,
+                         (unsigned long)(result->wakeups ? (uint64_t)result->fired * 100U / result->wakeups : 0U),
+                         (unsigned long)result->timer_thread_us);
+    }
+
+    return len;
+}
+
+/**
+  * @brief  Driver timer: run everything due up to the current tick
+  * @param  input: unused
+  * @retval None
+  */
+static void TimerWheel_DriverTimer(ULONG input)
+{
+    TX_INTERRUPT_SAVE_AREA
+    TimerWheel_Timer_t *timer;
+    TimerWheel_Callback_t callback;
+    ULONG callback_input;
+    ULONG current;
+    uint32_t batch = 0;
+
+    (void)input;
+
+    TX_DISABLE
+    wheel_ctx.started = 1;
+    wheel_ctx.armed = 0;
+    wheel_ctx.processing = 1;
+    wheel_ctx.stats.wakeups++;
+    current = tx_time_get();
+    TimerWheel_Advance(current);
+    TX_RESTORE
+
+    for (;;)
+    {
+        TX_DISABLE
+        timer = wheel_ctx.lists[TIMER_WHEEL_EXPIRED_SLOT];
+        if (!timer)
+        {
+            TX_RESTORE
+            break;
+        }
+
+        TimerWheel_Unlink(timer);
+        callback = timer->callback;
+        callback_input = timer->input;
+
+        if (timer->period)
+        {
+            timer->nominal += timer->period;
+            if ((LONG)(timer->nominal - current) <= 0)
+            {
+                /* Missed whole periods: resume from now instead of firing a burst */
+                timer->nominal += ((current - timer->nominal) / timer->period + 1U) * timer->period;
+                wheel_ctx.stats.late++;
+            }
+            timer->expires = TimerWheel_Align(timer->nominal, timer->slack);
+            TimerWheel_Insert(timer);
+        }
+        else
+        {
+            wheel_ctx.stats.active--;
+        }
+        wheel_ctx.stats.fired++;
+        TX_RESTORE
+
+        batch++;
+        callback(callback_input);
+    }
+
+    TX_DISABLE
+    if (batch > wheel_ctx.stats.batch_max)
+        wheel_ctx.stats.batch_max = batch;
+    wheel_ctx.processing = 0;
+    TimerWheel_Arm();
+    TX_RESTORE
+}
+
+/**
+  * @brief  Put a timer on a list (interrupts disabled)
+  * @param  timer: timer on no list
+  * @param  slot: wheel slot or TIMER_WHEEL_EXPIRED_SLOT
+  * @retval None
+  */
+static void TimerWheel_Link(TimerWheel_Timer_t *timer, uint32_t slot)
+{
+    timer->slot = (uint16_t)slot;
+    timer->prev = NULL;
+    timer->next = wheel_ctx.lists[slot];
+    if (timer->next)
+        timer->next->prev = timer;
+    wheel_ctx.lists[slot] = timer;
+
+    if (slot < TIMER_WHEEL_WHEEL_SLOTS)
+        wheel_ctx.occupied[slot / TIMER_WHEEL_SLOTS] |= 1UL << (slot & TIMER_WHEEL_MASK);
+}
+
+/**
+  * @brief  Take a timer off its list (interrupts disabled)
+  * @param  timer: timer
+  * @retval None
+  */
+static void TimerWheel_Unlink(TimerWheel_Timer_t *timer)
+{
+    uint32_t slot = timer->slot;
+
+    if (slot == TIMER_WHEEL_NO_SLOT)
+        return;
+
+    if (timer->prev)
+        timer->prev->next = timer->next;
+    else
+        wheel_ctx.lists[slot] = timer->next;
+    if (timer->next)
+        timer->next->prev = timer->prev;
+
+    if (slot < TIMER_WHEEL_WHEEL_SLOTS && !wheel_ctx.lists[slot])
+        wheel_ctx.occupied[slot / TIMER_WHEEL_SLOTS] &= ~(1UL << (slot & TIMER_WHEEL_MASK));
+
+    timer->next = NULL;
+    timer->prev = NULL;
+    timer->slot = TIMER_WHEEL_NO_SLOT;
+}
+
+/**
+  * @brief  File a timer by its distance from the wheel time (interrupts disabled)
+  * @param  timer: timer on no list, expires set
+  * @retval None
+  */
+static void TimerWheel_Insert(TimerWheel_Timer_t *timer)
+{
+    ULONG delta = timer->expires - wheel_ctx.now;
+    ULONG tick = timer->expires;
+    uint32_t level;
+
+    if ((LONG)delta < 0)
+    {
+        /* Already due: the slot processed next */
+        delta = 0;
+        tick = wheel_ctx.now;
+    }
+    else if (delta >= TIMER_WHEEL_RANGE)
+    {
+        /* Beyond the top level: park in its last slot, filed again on cascade */
+        delta = TIMER_WHEEL_RANGE - 1U;
+        tick = wheel_ctx.now + delta;
+    }
+
+    for (level = 0; level < TIMER_WHEEL_LEVELS - 1U; level++)
+    {
+        if (delta < (1UL << TIMER_WHEEL_SHIFT(level + 1U)))
+            break;
+    }
+
+    TimerWheel_Link(timer, level * TIMER_WHEEL_SLOTS + ((tick >> TIMER_WHEEL_SHIFT(level)) & TIMER_WHEEL_MASK));
+}
+
+/**
+  * @brief  Redistribute the slot of a level that starts at the wheel time (interrupts disabled)
+  * @param  level: 1..TIMER_WHEEL_LEVELS-1
+  * @retval None
+  */
+static void TimerWheel_Cascade(uint32_t level)
+{
+    uint32_t slot = level * TIMER_WHEEL_SLOTS + ((wheel_ctx.now >> TIMER_WHEEL_SHIFT(level)) & TIMER_WHEEL_MASK);
+    TimerWheel_Timer_t *timer = wheel_ctx.lists[slot];
+
+    wheel_ctx.lists[slot] = NULL;
+    wheel_ctx.occupied[level] &= ~(1UL << (slot & TIMER_WHEEL_MASK));
+
+    while (timer)
+    {
+        TimerWheel_Timer_t *next = timer->next;
+
+        timer->slot = TIMER_WHEEL_NO_SLOT;
+        TimerWheel_Insert(timer);
+        wheel_ctx.stats.cascades++;
+        timer = next;
+    }
+}
+
+/**
+  * @brief  Move every timer due up to a tick onto the expired list (interrupts disabled)
+  * @param  target: last tick to process
+  * @retval None
+  *
+  * Only ticks with an occupied level 0 slot and round starts are visited.
+  */
+static void TimerWheel_Advance(ULONG target)
+{
+    while ((LONG)(target - wheel_ctx.now) >= 0)
+    {
+        uint32_t index = wheel_ctx.now & TIMER_WHEEL_MASK;
+        uint32_t later;
+        ULONG next;
+
+        /* A level starting a new round takes down its next slot, lower levels first */
+        for (uint32_t level = 1; level < TIMER_WHEEL_LEVELS; level++)
+        {
+            if ((wheel_ctx.now & ((1UL << TIMER_WHEEL_SHIFT(level)) - 1U)) != 0U)
+                break;
+            TimerWheel_Cascade(level);
+        }
+
+        while (wheel_ctx.lists[index])
+        {
+            TimerWheel_Timer_t *timer = wheel_ctx.lists[index];
+
+            TimerWheel_Unlink(timer);
+            TimerWheel_Link(timer, TIMER_WHEEL_EXPIRED_SLOT);
+        }
+
+        /* Next occupied level 0 slot in this round, else the start of the next round */
+        later = wheel_ctx.occupied[0] & ~((2UL << index) - 1U);
+        next = wheel_ctx.now - index + (later ? (ULONG)__builtin_ctz(later) : TIMER_WHEEL_SLOTS);
+        if ((LONG)(next - target) > 0)
+            next = target + 1U;
+        wheel_ctx.now = next;
+    }
+}
+
+/**
+  * @brief  Earliest tick with a timer due (interrupts disabled)
+  * @retval Tick, at most TIMER_WHEEL_MAX_SLEEP after the wheel time
+  */
+static ULONG TimerWheel_NextExpiry(void)
+{
+    ULONG best = wheel_ctx.now + TIMER_WHEEL_MAX_SLEEP;
+    uint32_t distance;
+
+    distance = TimerWheel_FirstFrom(wheel_ctx.occupied[0], wheel_ctx.now & TIMER_WHEEL_MASK);
+    if (distance < TIMER_WHEEL_SLOTS)
+        best = wheel_ctx.now + distance;
+
+    /* Slots of a level are in time order from its next cascade, so the first
+       non-empty one holds the earliest timers of that level */
+    for (uint32_t level = 1; level < TIMER_WHEEL_LEVELS; level++)
+    {
+        ULONG unit = 1UL << TIMER_WHEEL_SHIFT(level);
+        ULONG cascade = (wheel_ctx.now + unit - 1U) & ~(unit - 1U);
+        uint32_t index = (cascade >> TIMER_WHEEL_SHIFT(level)) & TIMER_WHEEL_MASK;
+        TimerWheel_Timer_t *timer;
+
+        distance = TimerWheel_FirstFrom(wheel_ctx.occupied[level], index);
+        if (distance >= TIMER_WHEEL_SLOTS)
+            continue;
+
+        cascade += distance * unit;
+        if ((LONG)(cascade - best) >= 0)
+            continue;
+
+        timer = wheel_ctx.lists[level * TIMER_WHEEL_SLOTS + ((index + distance) & TIMER_WHEEL_MASK)];
+        for (; timer; timer = timer->next)
+        {
+            ULONG due = ((LONG)(timer->expires - cascade) > 0) ? timer->expires : cascade;
+
+            if ((LONG)(due - best) < 0)
+                best = due;
+        }
+    }
+
+    return best;
+}
+
+/**
+  * @brief  Arm the driver for the next expiry (interrupts disabled)
+  * @retval None
+  */
+static void TimerWheel_Arm(void)
+{
+    ULONG next;
+    ULONG delay;
+
+    if (!wheel_ctx.started || wheel_ctx.processing)
+        return;
+
+    if (wheel_ctx.stats.active == 0U)
+    {
+        if (wheel_ctx.armed)
+        {
+            tx_timer_deactivate(&wheel_ctx.driver);
+            wheel_ctx.armed = 0;
+        }
+        return;
+    }
+
+    next = TimerWheel_NextExpiry();
+    if (wheel_ctx.armed && wheel_ctx.armed_at == next)
+        return;
+
+    delay = next - tx_time_get();
+    if ((LONG)delay < 1)
+        delay = 1;
+
+    tx_timer_deactivate(&wheel_ctx.driver);
+    tx_timer_change(&wheel_ctx.driver, delay, 0);
+    tx_timer_activate(&wheel_ctx.driver);
+    wheel_ctx.armed = 1;
+    wheel_ctx.armed_at = next;
+}
+
+/**
+  * @brief  Tick in [deadline, deadline + slack] that is a multiple of the largest power of two
+  * @param  deadline: nominal tick
+  * @param  slack: allowed lateness
+  * @retval Tick to fire on
+  */
+static ULONG TimerWheel_Align(ULONG deadline, ULONG slack)
+{
+    ULONG step = 1U;
+
+    /* A window of slack + 1 ticks always holds a multiple of the largest
+       power of two not above its length */
+    while (step <= (slack + 1U) / 2U)
+        step <<= 1;
+
+    return (deadline + slack) & ~(step - 1U);
+}
+
+/**
+  * @brief  Distance from a slot to the next set bit, wrapping around
+  * @param  bits: slot bitmap
+  * @param  from: slot to start at (distance 0)
+  * @retval 0..TIMER_WHEEL_SLOTS-1, TIMER_WHEEL_SLOTS if empty
+  */
+static uint32_t TimerWheel_FirstFrom(uint32_t bits, uint32_t from)
+{
+    uint32_t rotated = from ? ((bits >> from) | (bits << (TIMER_WHEEL_SLOTS - from))) : bits;
+
+    return rotated ? (uint32_t)__builtin_ctz(rotated) : TIMER_WHEEL_SLOTS;
+}
+
+/**
+  * @brief  Runner thread: the benchmark timer set on tx_timers, then on
+  *         the wheel, once per TimerWheel_BenchStart()
+  * @param  input: unused
+  * @retval None
+  */
+static VOID TimerWheel_BenchThreadEntry(ULONG input)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    (void)input;
+
+    while (1)
+    {
+        if (tx_semaphore_get(&wheel_bench.start, TX_WAIT_FOREVER) != TX_SUCCESS)
+            continue;
+
+        for (uint32_t mode = 0; mode < 2U; mode++)
+        {
+            TimerWheel_BenchResult_t *result = &wheel_bench.results[mode];
+            uint32_t seed = TIMER_WHEEL_BENCH_SEED;
+            uint32_t created = 0;
+            uint64_t cycles;
+
+            /* Same periods and phases in both modes */
+            for (uint32_t i = 0; i < wheel_bench.count; i++)
+            {
+                ULONG period;
+                ULONG phase;
+                UINT status;
+
+                seed = seed * 1664525U + 1013904223U;
+                period = wheel_bench_periods[(seed >> 16) % (sizeof(wheel_bench_periods) / sizeof(wheel_bench_periods[0]))];
+                phase = 1U + (seed >> 4) % period;
+
+                if (mode == 0U)
+                {
+                    status = tx_timer_create(&wheel_bench.timers.native[i], "TW Bench",
+                                             TimerWheel_BenchCallback, i,
+                                             phase, period, TX_AUTO_ACTIVATE);
+                }
+                else
+                {
+                    TimerWheel_Create(&wheel_bench.timers.wheel[i], "TW Bench",
+                                      TimerWheel_BenchCallback, i);
+                    status = TimerWheel_Start(&wheel_bench.timers.wheel[i], phase, period,
+                                              TIMER_WHEEL_SLACK(period));
+                }
+                if (status != TX_SUCCESS)
+                    break;
+                created++;
+            }
+
+            TX_DISABLE
+            wheel_bench.fired = 0;
+            wheel_bench.wakeups = 0;
+            wheel_bench.last_tick = tx_time_get();
+            TX_RESTORE
+            cycles = TimerWheel_TimerThreadCycles();
+
+            tx_thread_sleep(wheel_bench.seconds * TX_TIMER_TICKS_PER_SECOND);
+
+            TX_DISABLE
+            result->fired = wheel_bench.fired;
+            result->wakeups = wheel_bench.wakeups;
+            TX_RESTORE
+            cycles = TimerWheel_TimerThreadCycles() - cycles;
+
+            for (uint32_t i = 0; i < created; i++)
+            {
+                if (mode == 0U)
+                    tx_timer_delete(&wheel_bench.timers.native[i]);
+                else
+                    TimerWheel_Stop(&wheel_bench.timers.wheel[i]);
+            }
+
+            result->timers = created;
+            result->timer_thread_us = (uint32_t)(cycles / (SystemCoreClock / 1000000U));
+            result->is_done = 1;
+        }
+
+        wheel_bench.state = TIMER_WHEEL_BENCH_DONE;
+    }
+}
+
+/**
+  * @brief  Benchmark timer callback: count callbacks and distinct ticks
+  * @param  input: timer index
+  * @retval None
+  */
+static void TimerWheel_BenchCallback(ULONG input)
+{
+    ULONG tick = tx_time_get();
+
+    (void)input;
+
+    wheel_bench.fired++;
+    if (tick != wheel_bench.last_tick)
+    {
+        wheel_bench.wakeups++;
+        wheel_bench.last_tick = tick;
+    }
+}
+
+/**
+  * @brief  Execution profile cycles of the ThreadX timer thread
+  * @retval Cycles, 0 without TX_EXECUTION_PROFILE_ENABLE
+  */
+static uint64_t TimerWheel_TimerThreadCycles(void)
+{
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+    return _tx_timer_thread.tx_thread_execution_time_total;
+#else
+    return 0;
+#endif
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,345 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    tm_porting_layer.c
+  * @author  Wind Turbine Team
+  * @brief   Thread-Metric porting layer: ThreadX objects and the TIM7 interrupt
+  ******************************************************************************
+  * Same mapping as threadx_example/tm_porting_layer_threadx.c, with two
+  * changes for running the tests back to back inside the application:
+  * every object is remembered so ThreadMetric_PortReset() can delete it,
+  * and the stacks are sized for the six threads the tests actually use.
+  *
+  * The object part is plain ThreadX and is shared with the Linux build
+  * (THREAD_METRIC_HOST); the interrupt source below it is the STM32U5 part.
+  * TIM7 is otherwise unused: setting UG raises an update interrupt without
+  * the counter running, so each TM_CAUSE_INTERRUPT is one real NVIC entry
+  * through the same path as the application's interrupts.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "tm_api.h"
+#include "thread_metric.h"
+#include "mem_budget.h"
+#ifndef THREAD_METRIC_HOST
+#include "stm32u5xx_hal.h"
+#endif
+
+/* Private defines -----------------------------------------------------------*/
+#define TM_PORT_MAX_QUEUES              1
+#define TM_PORT_MAX_SEMAPHORES          1
+#define TM_PORT_MAX_MEMORY_POOLS        1
+#define TM_PORT_QUEUE_SIZE              200     /* 12 messages of 16 bytes */
+/* Tests pass unsigned long[4]: 16 bytes here, 32 on a 64-bit host where ULONG is 32-bit */
+#define TM_PORT_MESSAGE_WORDS           ((UINT)(4U * sizeof(unsigned long) / sizeof(ULONG)))
+#define TM_PORT_MEMORY_POOL_SIZE        2048
+#define TM_PORT_BLOCK_SIZE              128
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    TX_THREAD              threads[TM_PORT_MAX_THREADS];
+    TX_QUEUE               queues[TM_PORT_MAX_QUEUES];
+    TX_SEMAPHORE           semaphores[TM_PORT_MAX_SEMAPHORES];
+    TX_BLOCK_POOL          pools[TM_PORT_MAX_MEMORY_POOLS];
+    void                 (*entries[TM_PORT_MAX_THREADS])(void);
+
+    /* Created and not yet deleted */
+    UCHAR                  thread_live[TM_PORT_MAX_THREADS];
+    UCHAR                  queue_live[TM_PORT_MAX_QUEUES];
+    UCHAR                  semaphore_live[TM_PORT_MAX_SEMAPHORES];
+    UCHAR                  pool_live[TM_PORT_MAX_MEMORY_POOLS];
+    UCHAR                  is_registered;
+} TmPort_Context_t;
+
+/* Private variables ---------------------------------------------------------*/
+static TmPort_Context_t tm_ctx = {0};
+
+static ULONG tm_thread_stacks[TM_PORT_MAX_THREADS][TM_PORT_THREAD_STACK_SIZE / sizeof(ULONG)];
+static ULONG tm_queue_area[TM_PORT_MAX_QUEUES][TM_PORT_QUEUE_SIZE / sizeof(ULONG)];
+static ULONG tm_pool_area[TM_PORT_MAX_MEMORY_POOLS][TM_PORT_MEMORY_POOL_SIZE / sizeof(ULONG)];
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID tm_thread_entry(ULONG thread_input);
+
+/**
+  * @brief  Run the test initialization (the runner thread is already up)
+  * @param  test_initialization_function: test setup
+  * @retval None
+  */
+void tm_initialize(void (*test_initialization_function)(void))
+{
+    if (!tm_ctx.is_registered)
+    {
+        MemBudget_RegisterStatic("thread_metric", "test stacks", sizeof(tm_thread_stacks));
+        MemBudget_RegisterStatic("thread_metric", "test queue/pool", sizeof(tm_queue_area) + sizeof(tm_pool_area));
+        tm_ctx.is_registered = 1;
+    }
+
+    test_initialization_function();
+}
+
+/**
+  * @brief  Create a test thread, not started
+  * @param  thread_id: 0..TM_PORT_MAX_THREADS-1
+  * @param  priority: 1 (highest) .. 31
+  * @param  entry_function: test thread body
+  * @retval TM_SUCCESS or TM_ERROR
+  */
+int tm_thread_create(int thread_id, int priority, void (*entry_function)(void))
+{
+    if (thread_id < 0 || thread_id >= TM_PORT_MAX_THREADS || tm_ctx.thread_live[thread_id])
+        return TM_ERROR;
+
+    tm_ctx.entries[thread_id] = entry_function;
+    if (tx_thread_create(&tm_ctx.threads[thread_id], "Thread-Metric test", tm_thread_entry, (ULONG)thread_id,
+                         tm_thread_stacks[thread_id], sizeof(tm_thread_stacks[thread_id]),
+                         (UINT)priority, (UINT)priority, TX_NO_TIME_SLICE, TX_DONT_START) != TX_SUCCESS)
+        return TM_ERROR;
+
+    tm_ctx.thread_live[thread_id] = 1;
+    return TM_SUCCESS;
+}
+
+/**
+  * @brief  Resume a test thread
+  * @retval TM_SUCCESS or TM_ERROR
+  */
+int tm_thread_resume(int thread_id)
+{
+    return (tx_thread_resume(&tm_ctx.threads[thread_id]) == TX_SUCCESS) ? TM_SUCCESS : TM_ERROR;
+}
+
+/**
+  * @brief  Suspend a test thread
+  * @retval TM_SUCCESS or TM_ERROR
+  */
+int tm_thread_suspend(int thread_id)
+{
+    return (tx_thread_suspend(&tm_ctx.threads[thread_id]) == TX_SUCCESS) ? TM_SUCCESS : TM_ERROR;
+}
+
+/**
+  * @brief  Let other ready threads at the same priority run
+  * @retval None
+  */
+void tm_thread_relinquish(void)
+{
+    tx_thread_relinquish();
+}
+
+/**
+  * @brief  Sleep the calling thread
+  * @param  seconds: sleep time
+  * @retval None
+  */
+void tm_thread_sleep(int seconds)
+{
+    tx_thread_sleep((ULONG)seconds * TX_TIMER_TICKS_PER_SECOND);
+}
+
+/**
+  * @brief  Create a queue of 16-byte messages (four unsigned long)
+  * @retval TM_SUCCESS or TM_ERROR
+  */
+int tm_queue_create(int queue_id)
+{
+    if (queue_id < 0 || queue_id >= TM_PORT_MAX_QUEUES || tm_ctx.queue_live[queue_id])
+        return TM_ERROR;
+
+    if (tx_queue_create(&tm_ctx.queues[queue_id], "Thread-Metric test", TM_PORT_MESSAGE_WORDS,
+                        tm_queue_area[queue_id], sizeof(tm_queue_area[queue_id])) != TX_SUCCESS)
+        return TM_ERROR;
+
+    tm_ctx.queue_live[queue_id] = 1;
+    return TM_SUCCESS;
+}
+
+/**
+  * @brief  Send a 16-byte message, no wait
+  * @retval TM_SUCCESS or TM_ERROR
+  */
+int tm_queue_send(int queue_id, unsigned long *message_ptr)
+{
+    return (tx_queue_send(&tm_ctx.queues[queue_id], message_ptr, TX_NO_WAIT) == TX_SUCCESS) ? TM_SUCCESS : TM_ERROR;
+}
+
+/**
+  * @brief  Receive a 16-byte message, no wait
+  * @retval TM_SUCCESS or TM_ERROR
+  */
+int tm_queue_receive(int queue_id, unsigned long *message_ptr)
+{
+    return (tx_queue_receive(&tm_ctx.queues[queue_id], message_ptr, TX_NO_WAIT) == TX_SUCCESS) ? TM_SUCCESS : TM_ERROR;
+}
+
+/**
+  * @brief  Create a semaphore with a count of 1
+  * @retval TM_SUCCESS or TM_ERROR
+  */
+int tm_semaphore_create(int semaphore_id)
+{
+    if (semaphore_id < 0 || semaphore_id >= TM_PORT_MAX_SEMAPHORES || tm_ctx.semaphore_live[semaphore_id])
+        return TM_ERROR;
+
+    if (tx_semaphore_create(&tm_ctx.semaphores[semaphore_id], "Thread-Metric test", 1) != TX_SUCCESS)
+        return TM_ERROR;
+
+    tm_ctx.semaphore_live[semaphore_id] = 1;
+    return TM_SUCCESS;
+}
+
+/**
+  * @brief  Get a semaphore, no wait
+  * @retval TM_SUCCESS or TM_ERROR
+  */
+int tm_semaphore_get(int semaphore_id)
+{
+    return (tx_semaphore_get(&tm_ctx.semaphores[semaphore_id], TX_NO_WAIT) == TX_SUCCESS) ? TM_SUCCESS : TM_ERROR;
+}
+
+/**
+  * @brief  Put a semaphore
+  * @retval TM_SUCCESS or TM_ERROR
+  */
+int tm_semaphore_put(int semaphore_id)
+{
+    return (tx_semaphore_put(&tm_ctx.semaphores[semaphore_id]) == TX_SUCCESS) ? TM_SUCCESS : TM_ERROR;
+}
+
+/**
+  * @brief  Create a pool of 128-byte blocks
+  * @retval TM_SUCCESS or TM_ERROR
+  */
+int tm_memory_pool_create(int pool_id)
+{
+    if (pool_id < 0 || pool_id >= TM_PORT_MAX_MEMORY_POOLS || tm_ctx.pool_live[pool_id])
+        return TM_ERROR;
+
+    if (tx_block_pool_create(&tm_ctx.pools[pool_id], "Thread-Metric test", TM_PORT_BLOCK_SIZE,
+                             tm_pool_area[pool_id], sizeof(tm_pool_area[pool_id])) != TX_SUCCESS)
+        return TM_ERROR;
+
+    tm_ctx.pool_live[pool_id] = 1;
+    return TM_SUCCESS;
+}
+
+/**
+  * @brief  Allocate a 128-byte block, no wait
+  * @retval TM_SUCCESS or TM_ERROR
+  */
+int tm_memory_pool_allocate(int pool_id, unsigned char **memory_ptr)
+{
+    return (tx_block_allocate(&tm_ctx.pools[pool_id], (VOID **)memory_ptr, TX_NO_WAIT) == TX_SUCCESS) ? TM_SUCCESS : TM_ERROR;
+}
+
+/**
+  * @brief  Release a block
+  * @retval TM_SUCCESS or TM_ERROR
+  */
+int tm_memory_pool_deallocate(int pool_id, unsigned char *memory_ptr)
+{
+    (void)pool_id;
+    return (tx_block_release((VOID *)memory_ptr) == TX_SUCCESS) ? TM_SUCCESS : TM_ERROR;
+}
+
+/**
+  * @brief  Delete every object the last test created
+  * @retval None
+  *
+  * Called from the runner thread, which outranks all test threads, so none
+  * of them can run between terminate and delete.
+  */
+void ThreadMetric_PortReset(void)
+{
+    for (int i = 0; i < TM_PORT_MAX_THREADS; i++)
+    {
+        if (!tm_ctx.thread_live[i])
+            continue;
+        (void)tx_thread_terminate(&tm_ctx.threads[i]);
+        (void)tx_thread_delete(&tm_ctx.threads[i]);
+        tm_ctx.thread_live[i] = 0;
+    }
+
+    for (int i = 0; i < TM_PORT_MAX_QUEUES; i++)
+    {
+        if (tm_ctx.queue_live[i])
+            (void)tx_queue_delete(&tm_ctx.queues[i]);
+        tm_ctx.queue_live[i] = 0;
+    }
+
+    for (int i = 0; i < TM_PORT_MAX_SEMAPHORES; i++)
+    {
+        if (tm_ctx.semaphore_live[i])
+            (void)tx_semaphore_delete(&tm_ctx.semaphores[i]);
+        tm_ctx.semaphore_live[i] = 0;
+    }
+
+    for (int i = 0; i < TM_PORT_MAX_MEMORY_POOLS; i++)
+    {
+        if (tm_ctx.pool_live[i])
+            (void)tx_block_pool_delete(&tm_ctx.pools[i]);
+        tm_ctx.pool_live[i] = 0;
+    }
+}
+
+#ifndef THREAD_METRIC_HOST
+/**
+  * @brief  Enable the TIM7 update interrupt, counter left stopped
+  * @retval TX_SUCCESS
+  */
+UINT ThreadMetric_PortIrqInit(void)
+{
+    __HAL_RCC_TIM7_CLK_ENABLE();
+
+    /* URS = 0: a software UG sets UIF like a counter overflow would */
+    TIM7->CR1 = 0;
+    TIM7->SR = 0;
+    TIM7->DIER = TIM_DIER_UIE;
+
+    HAL_NVIC_SetPriority(TIM7_IRQn, THREAD_METRIC_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(TIM7_IRQn);
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Raise the TIM7 update interrupt
+  * @retval None
+  */
+void ThreadMetric_PortIrqRaise(void)
+{
+    TIM7->EGR = TIM_EGR_UG;
+
+    /* The read completes after the APB write, so UIF is set before the barrier */
+    (void)TIM7->SR;
+    __DSB();
+    __ISB();
+}
+
+/**
+  * @brief  TIM7 interrupt body: acknowledge, then run the benchmark handler
+  * @retval None
+  */
+void ThreadMetric_TimerIRQHandler(void)
+{
+    TIM7->SR = ~TIM_SR_UIF;
+    ThreadMetric_IrqHandler();
+}
+#endif /* THREAD_METRIC_HOST */
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  ThreadX entry shim for the void(void) test entries
+  * @param  thread_input: test thread id
+  * @retval None
+  */
+static VOID tm_thread_entry(ULONG thread_input)
+{
+    tm_ctx.entries[thread_input]();
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,285 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    app_iperf.c
+  * @author  Wind Turbine Team
+  * @brief   iperf2 UDP client used as network stress load
+  ******************************************************************************
+  * The rate is kept by comparing the bytes sent with the bytes due at the
+  * current tick: the thread sends while it is behind and sleeps one tick
+  * when it is ahead. Packets are of the bulk class, which only gets what
+  * the rx pool can spare above its reserve, without waiting (see
+  * app_packet_pools.h); a failed allocation is counted and the thread
+  * yields for a tick.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_iperf.h"
+#include "mem_budget.h"
+#include "app_packet_pools.h"
+#include <string.h>
+#include <stdio.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define IPERF_HEADER_SIZE             12          /* id, tv_sec, tv_usec */
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    TX_THREAD              thread;
+    TX_SEMAPHORE           start;
+    NX_IP                 *ip_instance;
+    NX_UDP_SOCKET          udp_socket;
+    UINT                   is_ready;
+
+    ULONG                  server_ip;
+    ULONG                  kbps;
+    ULONG                  seconds;
+    volatile uint32_t      stop;
+
+    Iperf_Stats_t          stats;
+
+    uint8_t               *thread_stack;
+} Iperf_Context_t;
+
+/* Private variables ---------------------------------------------------------*/
+static Iperf_Context_t iperf_ctx = {0};
+
+/* Private function prototypes -----------------------------------------------*/
+static void Iperf_ThreadEntry(ULONG thread_input);
+static UINT Iperf_SendDatagram(int32_t id, ULONG ticks);
+
+/**
+  * @brief  Create the client thread
+  * @param  byte_pool: ThreadX byte pool
+  * @param  ip_instance: NX_IP with an address
+  * @retval TX_SUCCESS or error code
+  */
+UINT Iperf_Init(TX_BYTE_POOL *byte_pool, NX_IP *ip_instance)
+{
+    UINT status;
+
+    if (!byte_pool || !ip_instance)
+        return TX_PTR_ERROR;
+
+    memset(&iperf_ctx, 0, sizeof(iperf_ctx));
+    iperf_ctx.ip_instance = ip_instance;
+
+    status = tx_semaphore_create(&iperf_ctx.start, "Iperf Start", 0);
+    if (status != TX_SUCCESS)
+        return status;
+
+    status = nx_udp_socket_create(ip_instance,
+                                  &iperf_ctx.udp_socket,
+                                  "Iperf Socket",
+                                  NX_IP_NORMAL,
+                                  NX_DONT_FRAGMENT,
+                                  NX_IP_TIME_TO_LIVE,
+                                  2048);
+    if (status != NX_SUCCESS)
+        return status;
+
+    status = nx_udp_socket_bind(&iperf_ctx.udp_socket, NX_ANY_PORT, TX_WAIT_FOREVER);
+    if (status != NX_SUCCESS)
+        return status;
+
+    status = MemBudget_Allocate(byte_pool,
+                                (VOID **)&iperf_ctx.thread_stack,
+                                IPERF_THREAD_STACK_SIZE,
+                                "iperf", "thread stack");
+    if (status != TX_SUCCESS)
+        return status;
+
+    status = tx_thread_create(&iperf_ctx.thread,
+                              "Iperf Client",
+                              Iperf_ThreadEntry,
+                              0,
+                              iperf_ctx.thread_stack,
+                              IPERF_THREAD_STACK_SIZE,
+                              IPERF_THREAD_PRIORITY,
+                              IPERF_THREAD_PRIORITY,
+                              TX_NO_TIME_SLICE,
+                              TX_AUTO_START);
+    if (status != TX_SUCCESS)
+        return status;
+
+    iperf_ctx.is_ready = 1;
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Send to a server for a number of seconds
+  * @param  server_ip: iperf server address (host byte order)
+  * @param  kbps: target rate
+  * @param  seconds: run time
+  * @retval TX_SUCCESS or TX_NOT_AVAILABLE
+  */
+UINT Iperf_Start(ULONG server_ip, ULONG kbps, ULONG seconds)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if (!iperf_ctx.is_ready || server_ip == 0U)
+        return TX_NOT_AVAILABLE;
+
+    if (kbps == 0U)
+        kbps = 1U;
+    if (kbps > IPERF_MAX_KBPS)
+        kbps = IPERF_MAX_KBPS;
+    if (seconds == 0U)
+        seconds = 1U;
+
+    TX_DISABLE
+    if (iperf_ctx.stats.running)
+    {
+        TX_RESTORE
+        return TX_NOT_AVAILABLE;
+    }
+    iperf_ctx.stats.running = 1;
+    TX_RESTORE
+
+    iperf_ctx.server_ip = server_ip;
+    iperf_ctx.kbps = kbps;
+    iperf_ctx.seconds = seconds;
+    iperf_ctx.stop = 0;
+    iperf_ctx.stats.datagrams = 0;
+    iperf_ctx.stats.bytes = 0;
+    iperf_ctx.stats.alloc_fails = 0;
+    iperf_ctx.stats.send_errors = 0;
+
+    return tx_semaphore_put(&iperf_ctx.start);
+}
+
+/**
+  * @brief  End a run early
+  * @retval None
+  */
+void Iperf_Stop(void)
+{
+    iperf_ctx.stop = 1;
+}
+
+/**
+  * @brief  Counters of the current or last run
+  * @param  stats: output
+  * @retval None
+  */
+void Iperf_GetStats(Iperf_Stats_t *stats)
+{
+    if (stats)
+        *stats = iperf_ctx.stats;
+}
+
+/**
+  * @brief  Client thread: one run per Iperf_Start()
+  * @param  thread_input: unused
+  * @retval None
+  */
+static void Iperf_ThreadEntry(ULONG thread_input)
+{
+    (void)thread_input;
+
+    while (1)
+    {
+        ULONG start;
+        ULONG elapsed;
+        uint64_t bytes_sent = 0;
+        uint64_t bytes_per_second;
+        int32_t id = 0;
+
+        if (tx_semaphore_get(&iperf_ctx.start, TX_WAIT_FOREVER) != TX_SUCCESS)
+            continue;
+
+        printf("iperf: %lu kbit/s for %lu s\n", (unsigned long)iperf_ctx.kbps, (unsigned long)iperf_ctx.seconds);
+
+        bytes_per_second = (uint64_t)iperf_ctx.kbps * 1000U / 8U;
+        start = tx_time_get();
+        while (!iperf_ctx.stop)
+        {
+            elapsed = tx_time_get() - start;
+            if (elapsed >= iperf_ctx.seconds * TX_TIMER_TICKS_PER_SECOND)
+                break;
+
+            /* Ahead of the rate: wait for the next tick */
+            if (bytes_sent >= (bytes_per_second * elapsed) / TX_TIMER_TICKS_PER_SECOND)
+            {
+                tx_thread_sleep(1);
+                continue;
+            }
+
+            if (Iperf_SendDatagram(id, elapsed) == NX_NO_PACKET)
+            {
+                tx_thread_sleep(1);
+                continue;
+            }
+            id++;
+            bytes_sent += IPERF_DATAGRAM_SIZE;
+        }
+
+        /* A negative sequence number ends the test on the server */
+        elapsed = tx_time_get() - start;
+        for (uint32_t i = 0; i < IPERF_FIN_COUNT; i++)
+        {
+            Iperf_SendDatagram(-id, elapsed);
+            tx_thread_sleep(10);
+        }
+
+        printf("iperf: %lu datagrams, %lu alloc fails, %lu send errors\n",
+               (unsigned long)iperf_ctx.stats.datagrams, (unsigned long)iperf_ctx.stats.alloc_fails,
+               (unsigned long)iperf_ctx.stats.send_errors);
+        iperf_ctx.stats.running = 0;
+    }
+}
+
+/**
+  * @brief  Send one iperf2 datagram
+  * @param  id: sequence number (negative for the closing datagrams)
+  * @param  ticks: time since the start of the run
+  * @retval NX_SUCCESS, NX_NO_PACKET if the pool is empty, or send error
+  */
+static UINT Iperf_SendDatagram(int32_t id, ULONG ticks)
+{
+    NX_PACKET *packet_ptr;
+    ULONG header[IPERF_HEADER_SIZE / sizeof(ULONG)];
+    UINT status;
+
+    status = PacketPools_Allocate(PACKET_CLASS_BULK,
+                                  &packet_ptr,
+                                  NX_UDP_PACKET,
+                                  NX_NO_WAIT);
+    if (status != NX_SUCCESS)
+    {
+        iperf_ctx.stats.alloc_fails++;
+        return NX_NO_PACKET;
+    }
+
+    /* struct UDP_datagram of iperf2, big endian; the rest of the payload is zero */
+    header[0] = (ULONG)id;
+    header[1] = ticks / TX_TIMER_TICKS_PER_SECOND;
+    header[2] = (ticks % TX_TIMER_TICKS_PER_SECOND) * (1000000U / TX_TIMER_TICKS_PER_SECOND);
+    NX_CHANGE_ULONG_ENDIAN(header[0]);
+    NX_CHANGE_ULONG_ENDIAN(header[1]);
+    NX_CHANGE_ULONG_ENDIAN(header[2]);
+
+    memcpy(packet_ptr->nx_packet_prepend_ptr, header, sizeof(header));
+    memset(packet_ptr->nx_packet_prepend_ptr + sizeof(header), 0, IPERF_DATAGRAM_SIZE - sizeof(header));
+    packet_ptr->nx_packet_length = IPERF_DATAGRAM_SIZE;
+    packet_ptr->nx_packet_append_ptr = packet_ptr->nx_packet_prepend_ptr + IPERF_DATAGRAM_SIZE;
+
+    status = nx_udp_socket_send(&iperf_ctx.udp_socket, packet_ptr, iperf_ctx.server_ip, IPERF_UDP_PORT);
+    if (status != NX_SUCCESS)
+    {
+        iperf_ctx.stats.send_errors++;
+        nx_packet_release(packet_ptr);
+        return status;
+    }
+
+    iperf_ctx.stats.datagrams++;
+    iperf_ctx.stats.bytes += IPERF_DATAGRAM_SIZE;
+
+    return NX_SUCCESS;
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,88 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    app_iperf.h
+  * @author  Wind Turbine Team
+  * @brief   iperf2 UDP client used as network stress load
+  ******************************************************************************
+  * Sends iperf2-format UDP datagrams (sequence number and timestamp up front)
+  * at a fixed rate, so the Wi-Fi SPI/DMA interrupts and the IP thread run
+  * flat out while something else is measured. On the host:
+  *
+  *   iperf -s -u -i 1
+  *
+  * The server prints the received rate, loss and jitter per second. The
+  * closing datagrams carry a negative sequence number; the client does not
+  * wait for the server report.
+  */
+/* USER CODE END Header */
+
+#ifndef __APP_IPERF_H
+#define __APP_IPERF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+#include "nx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define IPERF_THREAD_PRIORITY         10          /* Below the pipeline and the web server */
+#define IPERF_THREAD_STACK_SIZE       (2 * 1024)
+#define IPERF_UDP_PORT                5001        /* iperf2 default */
+#define IPERF_DATAGRAM_SIZE           1470        /* iperf2 default UDP payload */
+#define IPERF_DEFAULT_KBPS            2000
+#define IPERF_MAX_KBPS                20000
+#define IPERF_FIN_COUNT               10          /* Closing datagrams (UDP, so sent more than once) */
+
+typedef struct
+{
+    uint32_t running;
+    uint32_t datagrams;
+    uint32_t bytes;
+    uint32_t alloc_fails;                         /* Packet pool empty, datagram skipped */
+    uint32_t send_errors;
+} Iperf_Stats_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Create the client thread (idle until Iperf_Start)
+ * @param byte_pool: ThreadX byte pool for the stack
+ * @param ip_instance: NX_IP with an address
+ * @retval TX_SUCCESS on success, error code otherwise
+ */
+UINT Iperf_Init(TX_BYTE_POOL *byte_pool, NX_IP *ip_instance);
+
+/**
+ * @brief Send to a server for a number of seconds
+ * @param server_ip: iperf server address (host byte order, as NetX uses)
+ * @param kbps: target rate, clamped to 1..IPERF_MAX_KBPS
+ * @param seconds: run time, at least 1
+ * @retval TX_SUCCESS, TX_NOT_AVAILABLE if not initialized or already running
+ */
+UINT Iperf_Start(ULONG server_ip, ULONG kbps, ULONG seconds);
+
+/**
+ * @brief End a run early (the closing datagrams are still sent)
+ * @retval None
+ */
+void Iperf_Stop(void);
+
+/**
+ * @brief Counters of the current or last run
+ * @param stats: output
+ * @retval None
+ */
+void Iperf_GetStats(Iperf_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_IPERF_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
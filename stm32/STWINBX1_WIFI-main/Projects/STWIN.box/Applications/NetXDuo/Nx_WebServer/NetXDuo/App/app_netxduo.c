@@ -25,6 +25,27 @@
 /* USER CODE BEGIN Includes */
 #include   "app_azure_rtos.h"
 #include   "app_telemetry.h"
+#include   "asset_image.h"
+#include   "staging_log.h"
+#include   "mem_budget.h"
+#include   "slab_alloc.h"
+#include   "low_power.h"
+#include   "cpu_load.h"
+#include   "event_trace.h"
+#include   "thread_metric.h"
+#include   "irq_latency.h"
+#include   "app_iperf.h"
+#include   "rt_sched.h"
+#include   "timer_wheel.h"
+#include   "app_packet_pools.h"
+#include   "app_udp_flow.h"
+#include   "app_tcp_zerocopy.h"
+#include   "app_tcp_tune.h"
+#include   "app_rx_batch.h"
+#include   "app_packet_track.h"
+#include   "app_events.h"
+#include   "app_util.h"
+#include   <stdlib.h>
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -40,6 +61,7 @@ TX_SEMAPHORE Semaphore;
 
 NX_PACKET_POOL AppPool;
 NX_PACKET_POOL WebServerPool;
+NX_PACKET_POOL TelemetryPool;
 
 NX_IP   IpInstance;
 NX_DHCP DHCPClient;
@@ -47,6 +69,9 @@ NX_DHCP DHCPClient;
 ULONG IpAddress;
 ULONG NetMask;
 
+/* The driver only enables the interface once the station is up */
+static UINT WifiLinkUp = NX_TRUE;
+
 /* App memory pointer. */
 UCHAR   *pointer;
 
@@ -72,6 +97,24 @@ FX_FILE         fx_file;
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+/* Everything carved from the Nx App byte pool, checked against NX_APP_MEM_POOL_SIZE */
+#define NX_APP_POOL_BUDGET  (MEM_BUDGET_POOL_COST(NX_PACKET_POOL_SIZE) +     \
+                             MEM_BUDGET_POOL_COST(SERVER_POOL_SIZE) +        \
+                             MEM_BUDGET_POOL_COST(TELEMETRY_POOL_SIZE) +     \
+                             MEM_BUDGET_POOL_COST(IP_THREAD_STACK_SIZE) +    \
+                             MEM_BUDGET_POOL_COST(ARP_MEMORY_SIZE) +         \
+                             MEM_BUDGET_POOL_COST(SERVER_STACK) +            \
+                             MEM_BUDGET_POOL_COST(MAIN_THREAD_STACK_SIZE) +  \
+                             MEM_BUDGET_POOL_COST(WEB_THREAD_STACK_SIZE) +   \
+                             MEM_BUDGET_POOL_COST(LED_THREAD_STACK_SIZE) +   \
+                             MEM_BUDGET_POOL_COST(TCP_ZC_HEADER_POOL_SIZE) + \
+                             MEM_BUDGET_POOL_COST(TCP_ZC_LOAN_POOL_SIZE) +   \
+                             MEM_BUDGET_POOL_COST(TCP_ZC_RECLAIM_STACK_SIZE) + \
+                             MEM_BUDGET_POOL_COST(TCP_TUNE_STACK_SIZE) +     \
+                             2 * MEM_BUDGET_BLOCK_OVERHEAD)
+
+_Static_assert(NX_APP_MEM_POOL_SIZE >= NX_APP_POOL_BUDGET, "NX_APP_MEM_POOL_SIZE too small for the NetX Duo allocations");
+_Static_assert(NX_WEB_HTTP_SERVER_PRIORITY > RT_SCHED_PRIORITY_LOWEST, "web server must stay below the pipeline threads");
 
 /* USER CODE END PD */
 
@@ -102,10 +145,61 @@ static void  nx_server_thread_entry(ULONG thread_input);
 /* DHCP state change notify callback */
 static VOID ip_address_change_notify_callback(NX_IP *ip_instance, VOID *ptr);
 
+/* Wi-Fi station up/down notify callback (from the emw3080 driver) */
+static VOID link_status_change_notify_callback(NX_IP *ip_ptr, UINT interface_index, UINT link_up);
+static VOID link_state_update(NX_IP *ip_ptr);
+
 /* Web Server callback when a new request from a web client is triggered */
 static UINT webserver_request_notify_callback(NX_WEB_HTTP_SERVER *server_ptr, UINT request_type, CHAR *resource, NX_PACKET *packet_ptr);
 
-static uint8_t nx_server_pool[SERVER_POOL_SIZE];
+/* Serve a static resource directly from the memory-mapped OSPI asset image */
+static UINT webserver_send_asset(NX_WEB_HTTP_SERVER *server_ptr, CHAR *resource);
+static UINT webserver_send_buffer(NX_WEB_HTTP_SERVER *server_ptr, CHAR *content_type, const UCHAR *data, ULONG length);
+static UINT webserver_send_report(NX_WEB_HTTP_SERVER *server_ptr, uint32_t (*format)(char *buf, uint32_t size), uint32_t size);
+static UINT webserver_send_header(NX_WEB_HTTP_SERVER *server_ptr, CHAR *content_type, ULONG length);
+static UINT webserver_send_body(NX_WEB_HTTP_SERVER *server_ptr, const UCHAR *data, ULONG length);
+static UINT webserver_send_lent(NX_WEB_HTTP_SERVER *server_ptr, CHAR *content_type, const UCHAR *data, ULONG length,
+                                TcpZeroCopy_Loan_t *loan, TcpZeroCopy_Release_t release, VOID *context);
+static UINT webserver_send_lent_body(NX_WEB_HTTP_SERVER *server_ptr, const UCHAR *data, ULONG length,
+                                     TcpZeroCopy_Loan_t *loan, TcpZeroCopy_Release_t release, VOID *context);
+static UINT webserver_download(NX_WEB_HTTP_SERVER *server_ptr, UINT zero_copy);
+static VOID download_loan_release(VOID *context);
+static VOID download_finish(VOID);
+static uint32_t download_format(char *buf, uint32_t size);
+static VOID history_loan_release(VOID *context);
+static UINT webserver_parse_ipv4(const CHAR *text, ULONG *ip_address, CHAR **end);
+
+/* Snapshot of the compressed feature history served by /GetHistory */
+static UCHAR history_snapshot[TELEMETRY_HISTORY_SIZE];
+/* Taken while a response still points into history_snapshot */
+static TX_SEMAPHORE history_loan_done;
+static TcpZeroCopy_Loan_t history_loan;
+
+/* Pattern block /GetDownload and /GetDownloadCopy send DOWNLOAD_BENCH_SIZE bytes of */
+static ULONG download_block[DOWNLOAD_BLOCK_SIZE / sizeof(ULONG)];
+_Static_assert(DOWNLOAD_BENCH_SIZE % DOWNLOAD_BLOCK_SIZE == 0U, "download is a whole number of blocks");
+/* Run in progress; the last block lent to TCP finishes it when it comes back */
+static struct
+{
+  TcpZeroCopy_Loan_t loans[DOWNLOAD_LOANS];
+  TX_SEMAPHORE       loans_free;
+  UINT               running;
+  UINT               sending;
+  UINT               zero_copy;
+  ULONG              lent;
+  ULONG              released;
+  ULONG              bytes;
+  ULONG              start;
+  uint64_t           busy_start;
+} download_ctx;
+/* Last /GetDownload or /GetDownloadCopy run, reported by /GetZeroCopy */
+static struct
+{
+  UINT  zero_copy;
+  ULONG bytes;
+  ULONG ms;
+  ULONG cpu_permille;
+} download_result;
 /* USER CODE END PFP */
 /**
   * @brief  Application NetXDuo Initialization.
@@ -118,7 +212,9 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
   TX_BYTE_POOL *byte_pool = (TX_BYTE_POOL*)memory_ptr;
 
    /* USER CODE BEGIN App_NetXDuo_MEM_POOL */
-
+  MemBudget_RegisterStatic("netxduo", "SD sector cache", sizeof(media_memory));
+  MemBudget_RegisterStatic("netxduo", "history snapshot", sizeof(history_snapshot));
+  MemBudget_RegisterStatic("netxduo", "download pattern", sizeof(download_block));
   /* USER CODE END App_NetXDuo_MEM_POOL */
 
   /* USER CODE BEGIN MX_NetXDuo_Init */
@@ -128,8 +224,20 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
   /* Initialize the NetX system. */
   nx_system_initialize();
 
+  /* Per-class pools; without the sampler only allocations update the high-water marks */
+  if (PacketPools_Init() != TX_SUCCESS)
+  {
+    printf("PacketPools_Init failed, rx high-water not sampled\n");
+  }
+
+  /* Before any pool is created, so every packet hold is timed */
+  if (PacketTrack_Init() != TX_SUCCESS)
+  {
+    printf("PacketTrack_Init failed, packet lifetimes not tracked\n");
+  }
+
   /* Allocate the memory for packet_pool.  */
-  if (tx_byte_allocate(byte_pool, (VOID **) &pointer,  NX_PACKET_POOL_SIZE, TX_NO_WAIT) != TX_SUCCESS)
+  if (MemBudget_Allocate(byte_pool, (VOID **) &pointer, NX_PACKET_POOL_SIZE, "netxduo", "main packet pool") != TX_SUCCESS)
   {
     return TX_POOL_ERROR;
   }  
@@ -143,7 +251,7 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
   }
   
   /* Allocate the server packet pool. */
-  ret = tx_byte_allocate(byte_pool, (VOID **) &pointer, SERVER_POOL_SIZE, TX_NO_WAIT);
+  ret = MemBudget_Allocate(byte_pool, (VOID **) &pointer, SERVER_POOL_SIZE, "netxduo", "HTTP packet pool");
   
   /* Check server packet pool memory allocation. */
   if (ret != NX_SUCCESS)
@@ -153,7 +261,7 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
   }
   
   /* Create the server packet pool. */
-  ret = nx_packet_pool_create(&WebServerPool, "HTTP Server Packet Pool", SERVER_PACKET_SIZE, nx_server_pool, SERVER_POOL_SIZE);
+  ret = nx_packet_pool_create(&WebServerPool, "HTTP Server Packet Pool", SERVER_PACKET_SIZE, pointer, SERVER_POOL_SIZE);
   
   /* Check for server pool creation status. */
   if (ret != NX_SUCCESS)
@@ -162,15 +270,33 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
     Error_Handler();
   }
   
+  /* Allocate the telemetry packet pool. */
+  if (MemBudget_Allocate(byte_pool, (VOID **) &pointer, TELEMETRY_POOL_SIZE, "netxduo", "telemetry packet pool") != TX_SUCCESS)
+  {
+    return TX_POOL_ERROR;
+  }
+  
+  /* Small packets reserved for the feature datagrams */
+  ret = nx_packet_pool_create(&TelemetryPool, "Telemetry Packet Pool", TELEMETRY_PACKET_PAYLOAD, pointer, TELEMETRY_POOL_SIZE);
+  
+  if (ret != NX_SUCCESS)
+  {
+    return NX_NOT_ENABLED;
+  }
+  
+  PacketPools_Register(PACKET_CLASS_RX, &AppPool);
+  PacketPools_Register(PACKET_CLASS_HTTP, &WebServerPool);
+  PacketPools_Register(PACKET_CLASS_TELEMETRY, &TelemetryPool);
+  
   /* Allocate the memory for Ip_Instance */
-  if (tx_byte_allocate(byte_pool, (VOID **) &pointer,   2 * DEFAULT_MEMORY_SIZE, TX_NO_WAIT) != TX_SUCCESS)
+  if (MemBudget_Allocate(byte_pool, (VOID **) &pointer, IP_THREAD_STACK_SIZE, "netxduo", "IP thread stack") != TX_SUCCESS)
   {
     return TX_POOL_ERROR;
   }
   
   /* Create the main NX_IP instance */
   ret = nx_ip_create(&IpInstance, "Main Ip instance", NULL_ADDRESS, NULL_ADDRESS, &AppPool, nx_driver_emw3080_entry,
-                     pointer, 2 * DEFAULT_MEMORY_SIZE, DEFAULT_PRIORITY);
+                     pointer, IP_THREAD_STACK_SIZE, DEFAULT_PRIORITY);
   
   if (ret != NX_SUCCESS)
   {
@@ -178,7 +304,7 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
   }
   
   /* Allocate the memory for ARP */
-  if (tx_byte_allocate(byte_pool, (VOID **) &pointer, ARP_MEMORY_SIZE, TX_NO_WAIT) != TX_SUCCESS)
+  if (MemBudget_Allocate(byte_pool, (VOID **) &pointer, ARP_MEMORY_SIZE, "netxduo", "ARP cache") != TX_SUCCESS)
   {
     return TX_POOL_ERROR;
   }
@@ -214,9 +340,30 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
   {
     return NX_NOT_ENABLED;
   }
+
+  /* Large in-memory responses are lent to TCP instead of copied into WebServerPool */
+  tx_semaphore_create(&history_loan_done, "History loan", 1);
+  tx_semaphore_create(&download_ctx.loans_free, "Download loans", DOWNLOAD_LOANS);
+  for (ULONG i = 0; i < DOWNLOAD_BLOCK_SIZE; i++)
+  {
+    ((UCHAR *)download_block)[i] = (UCHAR)i;
+  }
+  if (TcpZeroCopy_Init(byte_pool) != TX_SUCCESS)
+  {
+    printf("TcpZeroCopy_Init failed, responses are copied\n");
+  }
+
+  /* Receive windows follow rate x RTT, bounded by the free rx packets */
+  if (TcpTune_Init(byte_pool, &IpInstance, &AppPool) != TX_SUCCESS)
+  {
+    printf("TcpTune_Init failed, windows stay at their defaults\n");
+  }
+
+  /* Frames reach the IP thread in batches from the driver's Wi-Fi I/O thread */
+  RxBatch_Init(&IpInstance);
   
   /* Allocate the server stack. */
-  ret = tx_byte_allocate(byte_pool, (VOID **) &pointer, SERVER_STACK, TX_NO_WAIT);
+  ret = MemBudget_Allocate(byte_pool, (VOID **) &pointer, SERVER_STACK, "netxduo", "HTTP server stack");
   
   /* Check server stack memory allocation. */
   if (ret != NX_SUCCESS)
@@ -236,7 +383,7 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
   }
   
   /* Allocate the main thread. */
-  ret = tx_byte_allocate(byte_pool, (VOID **) &pointer, 2 * DEFAULT_MEMORY_SIZE, TX_NO_WAIT);
+  ret = MemBudget_Allocate(byte_pool, (VOID **) &pointer, MAIN_THREAD_STACK_SIZE, "netxduo", "main thread stack");
   
   /* Check main thread memory allocation. */
   if (ret != NX_SUCCESS)
@@ -246,7 +393,7 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
   }
   
   /* Create the main thread */
-  ret = tx_thread_create(&AppMainThread, "App Main thread", App_Main_Thread_Entry, 0, pointer, 2 * DEFAULT_MEMORY_SIZE,
+  ret = tx_thread_create(&AppMainThread, "App Main thread", App_Main_Thread_Entry, 0, pointer, MAIN_THREAD_STACK_SIZE,
                          DEFAULT_MAIN_PRIORITY, DEFAULT_MAIN_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
   
   if (ret != TX_SUCCESS)
@@ -255,7 +402,7 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
   }
   
   /* Allocate the Web Server Thread stack. */
-  ret = tx_byte_allocate(byte_pool, (VOID **) &pointer, 2 * DEFAULT_MEMORY_SIZE, TX_NO_WAIT);
+  ret = MemBudget_Allocate(byte_pool, (VOID **) &pointer, WEB_THREAD_STACK_SIZE, "netxduo", "web server thread stack");
   
   /* Check server thread memory allocation. */
   if (ret != NX_SUCCESS)
@@ -265,7 +412,7 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
   }
   
   /* create the Web Server Thread */
-  ret = tx_thread_create(&AppWebServerThread, "App Web Server Thread", nx_server_thread_entry, 0, pointer, 2 * DEFAULT_MEMORY_SIZE,
+  ret = tx_thread_create(&AppWebServerThread, "App Web Server Thread", nx_server_thread_entry, 0, pointer, WEB_THREAD_STACK_SIZE,
                          DEFAULT_PRIORITY, DEFAULT_PRIORITY, TX_NO_TIME_SLICE, TX_DONT_START);
   
   if (ret != TX_SUCCESS)
@@ -281,11 +428,14 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
     return NX_NOT_ENABLED;
   }
   
+  /* The DHCP client keeps its own pool, listed as the control class */
+  PacketPools_Register(PACKET_CLASS_CONTROL, DHCPClient.nx_dhcp_packet_pool_ptr);
+  
   /* set DHCP notification callback  */
   tx_semaphore_create(&Semaphore, "App Semaphore", 0);
   
     /* Allocate the LED thread stack. */
-  ret = tx_byte_allocate(byte_pool, (VOID **) &pointer, DEFAULT_MEMORY_SIZE, TX_NO_WAIT);
+  ret = MemBudget_Allocate(byte_pool, (VOID **) &pointer, LED_THREAD_STACK_SIZE, "netxduo", "LED thread stack");
 
   /* Check LED thread memory allocation. */
   if (ret != NX_SUCCESS)
@@ -295,8 +445,8 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
   }
 
   /* Create Led Thread.  */
-  if (tx_thread_create(&LedThread, "Led Thread", LedThread_Entry, 0, pointer, DEFAULT_MEMORY_SIZE,
-                       DEFAULT_PRIORITY, DEFAULT_PRIORITY, TX_NO_TIME_SLICE, TX_DONT_START) != TX_SUCCESS)
+  if (tx_thread_create(&LedThread, "Led Thread", LedThread_Entry, 0, pointer, LED_THREAD_STACK_SIZE,
+                       TOGGLE_LED_PRIORITY, TOGGLE_LED_PRIORITY, TX_NO_TIME_SLICE, TX_DONT_START) != TX_SUCCESS)
   {
     Error_Handler();
   }
@@ -316,10 +466,42 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
 */
 static VOID ip_address_change_notify_callback(NX_IP *ip_instance, VOID *ptr)
 {
+  /* wake the pipeline workers on DHCP bound / lease lost */
+  link_state_update(ip_instance);
+
   /* as soon as the IP address is ready, the semaphore is released to let the web server start */
   tx_semaphore_put(&Semaphore);
 }
 
+/**
+* @brief  link status change callback, runs in the IP thread
+* @param  ip_ptr : NX_IP instance
+* @param  interface_index : interface that changed
+* @param  link_up : NX_TRUE if the station is associated
+* @retval None
+*/
+static VOID link_status_change_notify_callback(NX_IP *ip_ptr, UINT interface_index, UINT link_up)
+{
+  (void)interface_index;
+
+  WifiLinkUp = link_up;
+  link_state_update(ip_ptr);
+}
+
+/**
+* @brief  publish "station up and IPv4 address bound" to the worker threads
+* @param  ip_ptr : NX_IP instance
+* @retval None
+*/
+static VOID link_state_update(NX_IP *ip_ptr)
+{
+  ULONG address = 0;
+  ULONG mask = 0;
+
+  nx_ip_address_get(ip_ptr, &address, &mask);
+  AppEvents_SetLinkUp((WifiLinkUp == NX_TRUE) && (address != 0));
+}
+
 
 static VOID App_Main_Thread_Entry(ULONG thread_input)
 {
@@ -330,6 +512,12 @@ static VOID App_Main_Thread_Entry(ULONG thread_input)
   {
     Error_Handler();
   }
+
+  ret = nx_ip_link_status_change_notify_set(&IpInstance, link_status_change_notify_callback);
+  if (ret != NX_SUCCESS)
+  {
+    Error_Handler();
+  }
   
   ret = nx_dhcp_start(&DHCPClient);
   if (ret != NX_SUCCESS)
@@ -441,6 +629,244 @@ UINT webserver_request_notify_callback(NX_WEB_HTTP_SERVER *server_ptr, UINT requ
       sprintf(data, "NA");
     }
   }
+  else if (strcmp(resource, "/GetHistory") == 0)
+  {
+    /* Binary feature_history.h blocks, decode with Tools/fhdump */
+    ULONG history_len;
+    /* The previous response may still be lent out of the snapshot */
+    if (tx_semaphore_get(&history_loan_done, HISTORY_LOAN_TIMEOUT) == TX_SUCCESS)
+    {
+      history_len = Telemetry_GetHistory(history_snapshot, sizeof(history_snapshot));
+      return webserver_send_lent(server_ptr, "application/octet-stream", history_snapshot, history_len,
+                                 &history_loan, history_loan_release, NX_NULL);
+    }
+    sprintf(data, "busy");
+  }
+  else if (strcmp(resource, "/GetHistoryInfo") == 0)
+  {
+    uint32_t blocks, bytes, raw_bytes, encoded_bytes;
+    Telemetry_GetHistoryStats(&blocks, &bytes, &raw_bytes, &encoded_bytes);
+    sprintf(data, "%lu,%lu,%lu,%lu", (unsigned long)blocks, (unsigned long)bytes,
+            (unsigned long)raw_bytes, (unsigned long)encoded_bytes);
+  }
+  else if (strcmp(resource, "/GetLogInfo") == 0)
+  {
+    StagingLog_Stats_t log_stats;
+    StagingLog_GetStats(&log_stats);
+    sprintf(data, "%lu,%lu,%lu,%u,%lu,%lu,%lu,%lu",
+            (unsigned long)log_stats.fill, (unsigned long)log_stats.fill_max,
+            (unsigned long)log_stats.capacity, (unsigned)StagingLog_GetLevel(),
+            (unsigned long)log_stats.flushed_bytes, (unsigned long)log_stats.dropped_records,
+            (unsigned long)log_stats.write_errors, (unsigned long)log_stats.write_max_ms);
+  }
+  else if (strcmp(resource, "/GetMemBudget") == 0)
+  {
+    /* CSV lines, format in mem_budget.h */
+    return webserver_send_report(server_ptr, MemBudget_Format, MEM_BUDGET_REPORT_SIZE);
+  }
+  else if (strcmp(resource, "/GetCpuLoad") == 0)
+  {
+    /* CSV lines, format in cpu_load.h */
+    return webserver_send_report(server_ptr, CpuLoad_Format, CPU_LOAD_REPORT_SIZE);
+  }
+  else if (strcmp(resource, "/TraceStart") == 0 || strcmp(resource, "/TraceArm") == 0)
+  {
+    /* /TraceArm freezes the capture on the next dropped audio frame */
+    if (EventTrace_Start(strcmp(resource, "/TraceArm") == 0 ? TX_TRUE : TX_FALSE) == TX_SUCCESS)
+      sprintf(data, "%s", resource + 6);
+    else
+      sprintf(data, "error");
+  }
+  else if (strcmp(resource, "/TraceStop") == 0)
+  {
+    EventTrace_Stop();
+    sprintf(data, "Stop");
+  }
+  else if (strcmp(resource, "/GetTrace") == 0)
+  {
+    /* Raw TraceX image (stops a running capture), convert with Tools/txtrace2json.py */
+    ULONG trace_len;
+    const UCHAR *trace = EventTrace_GetBuffer(&trace_len);
+    return webserver_send_buffer(server_ptr, "application/octet-stream", trace, trace_len);
+  }
+  else if (strcmp(resource, "/GetTraceInfo") == 0)
+  {
+    EventTrace_Stats_t trace_stats;
+    EventTrace_GetStats(&trace_stats);
+    sprintf(data, "%lu,%lu,%lu,%lu",
+            (unsigned long)trace_stats.state, (unsigned long)trace_stats.buffer_size,
+            (unsigned long)trace_stats.frame_drops, (unsigned long)trace_stats.captures);
+  }
+  else if (strcmp(resource, "/GetEnergy") == 0)
+  {
+    LowPower_Stats_t energy;
+    LowPower_GetStats(&energy);
+    sprintf(data, "%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu",
+            (unsigned long)energy.mode, (unsigned long)energy.window_ms,
+            (unsigned long)energy.run_ms, (unsigned long)energy.sleep_ms, (unsigned long)energy.stop_ms,
+            (unsigned long)energy.wakeups, (unsigned long)energy.timer_wakeups,
+            (unsigned long)energy.packets, (unsigned long)energy.energy_uj,
+            (unsigned long)energy.energy_per_packet_uj);
+  }
+  else if (strncmp(resource, "/IdleMode/", 10) == 0)
+  {
+    /* Select the idle mode and start a new /GetEnergy window */
+    static const char *const idle_modes[] = { "Off", "Sleep", "Stop" };
+    UINT mode;
+    for (mode = 0; mode < 3; mode++)
+    {
+      if (strcmp(resource + 10, idle_modes[mode]) == 0)
+        break;
+    }
+    if (mode < 3 && LowPower_SetMode((LowPower_Mode_t)mode) == TX_SUCCESS)
+      sprintf(data, "%s", idle_modes[mode]);
+    else
+      sprintf(data, "error");
+  }
+  else if (strcmp(resource, "/ThreadMetricStart") == 0 || strncmp(resource, "/ThreadMetricStart/", 19) == 0)
+  {
+    /* Optional window per test in seconds: /ThreadMetricStart/30 */
+    ULONG seconds = (resource[18] == '/') ? strtoul(resource + 19, NULL, 10) : THREAD_METRIC_DEFAULT_SECONDS;
+    if (ThreadMetric_Start(seconds) == TX_SUCCESS)
+      sprintf(data, "Start");
+    else
+      sprintf(data, "busy");
+  }
+  else if (strcmp(resource, "/GetThreadMetric") == 0)
+  {
+    /* CSV lines, format in thread_metric.h */
+    return webserver_send_report(server_ptr, ThreadMetric_Format, THREAD_METRIC_REPORT_SIZE);
+  }
+  else if (strcmp(resource, "/IrqLatencyStart") == 0 || strncmp(resource, "/IrqLatencyStart/", 17) == 0)
+  {
+    /* Optional capture time in seconds: /IrqLatencyStart/60 */
+    ULONG seconds = (resource[16] == '/') ? strtoul(resource + 17, NULL, 10) : IRQ_LATENCY_DEFAULT_SECONDS;
+    if (IrqLatency_Start(seconds) == TX_SUCCESS)
+      sprintf(data, "Start");
+    else
+      sprintf(data, "busy");
+  }
+  else if (strncmp(resource, "/IrqLatencyStress/", 18) == 0)
+  {
+    /* Capture while an iperf UDP stream runs: /IrqLatencyStress/192.168.1.10[/kbps] */
+    ULONG server_ip;
+    ULONG kbps = IPERF_DEFAULT_KBPS;
+    CHAR *end;
+    if (webserver_parse_ipv4(resource + 18, &server_ip, &end) == NX_SUCCESS)
+    {
+      if (*end == '/')
+        kbps = strtoul(end + 1, NULL, 10);
+      if (Iperf_Start(server_ip, kbps, IRQ_LATENCY_DEFAULT_SECONDS) != TX_SUCCESS)
+        sprintf(data, "busy");
+      else if (IrqLatency_Start(IRQ_LATENCY_DEFAULT_SECONDS) != TX_SUCCESS)
+      {
+        Iperf_Stop();
+        sprintf(data, "busy");
+      }
+      else
+        sprintf(data, "Start");
+    }
+    else
+      sprintf(data, "error");
+  }
+  else if (strcmp(resource, "/IrqLatencyStop") == 0)
+  {
+    IrqLatency_Stop();
+    Iperf_Stop();
+    sprintf(data, "Stop");
+  }
+  else if (strcmp(resource, "/GetIrqLatency") == 0)
+  {
+    /* CSV lines, format in irq_latency.h */
+    return webserver_send_report(server_ptr, IrqLatency_Format, IRQ_LATENCY_REPORT_SIZE);
+  }
+  else if (strcmp(resource, "/GetRtSched") == 0)
+  {
+    /* CSV lines, format in rt_sched.h */
+    return webserver_send_report(server_ptr, RtSched_Format, RT_SCHED_REPORT_SIZE);
+  }
+  else if (strcmp(resource, "/RtSchedReset") == 0)
+  {
+    RtSched_ResetStats();
+    sprintf(data, "Reset");
+  }
+  else if (strcmp(resource, "/GetPacketPools") == 0)
+  {
+    /* CSV lines, format in app_packet_pools.h */
+    return webserver_send_report(server_ptr, PacketPools_Format, PACKET_POOLS_REPORT_SIZE);
+  }
+  else if (strcmp(resource, "/GetUdpFlow") == 0)
+  {
+    /* CSV line, format in app_udp_flow.h */
+    return webserver_send_report(server_ptr, Telemetry_FormatFlow, UDP_FLOW_REPORT_SIZE);
+  }
+  else if (strcmp(resource, "/GetMulticast") == 0)
+  {
+    /* CSV lines, format in app_telemetry.h */
+    return webserver_send_report(server_ptr, Telemetry_FormatMulticast, TELEMETRY_MCAST_REPORT_SIZE);
+  }
+  else if (strcmp(resource, "/GetZeroCopy") == 0)
+  {
+    /* CSV lines, format in NETWORK_SETUP.md */
+    return webserver_send_report(server_ptr, download_format, TCP_ZC_REPORT_SIZE);
+  }
+  else if (strcmp(resource, "/GetTcpStats") == 0)
+  {
+    /* CSV lines, format in NETWORK_SETUP.md */
+    return webserver_send_report(server_ptr, TcpTune_Format, TCP_TUNE_REPORT_SIZE);
+  }
+  else if (strcmp(resource, "/GetRxBatch") == 0)
+  {
+    /* CSV lines, format in app_rx_batch.h */
+    return webserver_send_report(server_ptr, RxBatch_Format, RX_BATCH_REPORT_SIZE);
+  }
+  else if (strcmp(resource, "/GetPacketTrack") == 0)
+  {
+    /* CSV lines, format in app_packet_track.h */
+    return webserver_send_report(server_ptr, PacketTrack_Format, PACKET_TRACK_REPORT_SIZE);
+  }
+  else if (strcmp(resource, "/GetPacketDump") == 0)
+  {
+    /* CSV lines, format in app_packet_track.h */
+    return webserver_send_report(server_ptr, PacketTrack_Dump, PACKET_TRACK_DUMP_SIZE);
+  }
+  else if (strcmp(resource, "/GetDownload") == 0)
+  {
+    /* DOWNLOAD_BENCH_SIZE bytes of the pattern block, lent to TCP */
+    return webserver_download(server_ptr, NX_TRUE);
+  }
+  else if (strcmp(resource, "/GetDownloadCopy") == 0)
+  {
+    /* The same bytes through the WebServerPool copy */
+    return webserver_download(server_ptr, NX_FALSE);
+  }
+  else if (strcmp(resource, "/GetTimerWheel") == 0)
+  {
+    /* CSV line, format in timer_wheel.h */
+    return webserver_send_report(server_ptr, TimerWheel_Format, TIMER_WHEEL_REPORT_SIZE);
+  }
+  else if (strcmp(resource, "/TimerWheelBench") == 0 || strncmp(resource, "/TimerWheelBench/", 17) == 0)
+  {
+    /* Optional timer count and phase length: /TimerWheelBench/150/10 */
+    ULONG count = TIMER_WHEEL_BENCH_DEFAULT;
+    ULONG seconds = TIMER_WHEEL_BENCH_DEFAULT_SECONDS;
+    CHAR *end;
+    if (resource[16] == '/')
+    {
+      count = strtoul(resource + 17, &end, 10);
+      if (*end == '/')
+        seconds = strtoul(end + 1, NULL, 10);
+    }
+    if (TimerWheel_BenchStart(count, seconds) == TX_SUCCESS)
+      sprintf(data, "Start");
+    else
+      sprintf(data, "busy");
+  }
+  else if (strcmp(resource, "/GetTimerWheelBench") == 0)
+  {
+    /* CSV lines, format in timer_wheel.h */
+    return webserver_send_report(server_ptr, TimerWheel_BenchFormat, TIMER_WHEEL_REPORT_SIZE);
+  }
   else if(strcmp(resource, "/GetNetInfo") == 0)
   {
     sprintf(data, "%lu.%lu.%lu.%lu,%d", (IpAddress >> 24) & 0xff, (IpAddress >> 16) & 0xff, (IpAddress >> 8) & 0xff, IpAddress & 0xff, CONNECTION_PORT);
@@ -474,6 +900,11 @@ UINT webserver_request_notify_callback(NX_WEB_HTTP_SERVER *server_ptr, UINT requ
   }
   else
   {
+    /* Static content: memory-mapped asset image first, SD card (FileX) otherwise */
+    if (request_type == NX_WEB_HTTP_SERVER_GET_REQUEST)
+    {
+      return webserver_send_asset(server_ptr, resource);
+    }
     return NX_SUCCESS;
   }
   /* Derive the client request type from the client request. */
@@ -498,6 +929,385 @@ UINT webserver_request_notify_callback(NX_WEB_HTTP_SERVER *server_ptr, UINT requ
   return(NX_WEB_HTTP_CALLBACK_COMPLETED);
 }
 
+/**
+* @brief  Send a static resource from the OSPI asset image
+* @param  server_ptr : HTTP server instance
+* @param  resource : requested URL path
+* @retval NX_WEB_HTTP_CALLBACK_COMPLETED if served, NX_SUCCESS to let FileX serve it
+*/
+static UINT webserver_send_asset(NX_WEB_HTTP_SERVER *server_ptr, CHAR *resource)
+{
+  CHAR temp_string[30] = {'\0'};
+  UINT string_length;
+  const UCHAR *asset;
+  uint32_t asset_size = 0;
+
+  asset = (const UCHAR *)AssetImage_Find(resource, ASSET_TYPE_WEB, &asset_size);
+  if (asset == NX_NULL)
+  {
+    return NX_SUCCESS;
+  }
+
+  nx_web_http_server_type_get(server_ptr, resource, temp_string, &string_length);
+  temp_string[string_length] = '\0';
+
+  /* Body is copied straight from the mapped NOR into TX packets, no FileX read buffer */
+  return webserver_send_buffer(server_ptr, temp_string, asset, asset_size);
+}
+
+/**
+* @brief  Send a complete response whose body is already in memory
+* @param  server_ptr : HTTP server instance
+* @param  content_type : MIME type
+* @param  data : response body
+* @param  length : body length in bytes
+* @retval NX_WEB_HTTP_CALLBACK_COMPLETED on success, error code otherwise
+*/
+static UINT webserver_send_buffer(NX_WEB_HTTP_SERVER *server_ptr, CHAR *content_type, const UCHAR *data, ULONG length)
+{
+  UINT status;
+
+  status = webserver_send_header(server_ptr, content_type, length);
+  if (status == NX_SUCCESS)
+  {
+    status = webserver_send_body(server_ptr, data, length);
+  }
+
+  return (status == NX_SUCCESS) ? NX_WEB_HTTP_CALLBACK_COMPLETED : status;
+}
+
+/**
+* @brief  Send a CSV report built into a slab block
+* @param  server_ptr : HTTP server instance
+* @param  format : report formatter, writes at most size - 1 bytes
+* @param  size : report size, at most SLAB_MAX_BLOCK_SIZE
+* @retval NX_WEB_HTTP_CALLBACK_COMPLETED on success, error code otherwise
+*
+* "busy" is sent instead when no slab block is free.
+*/
+static UINT webserver_send_report(NX_WEB_HTTP_SERVER *server_ptr, uint32_t (*format)(char *buf, uint32_t size), uint32_t size)
+{
+  CHAR *report = (CHAR *)Slab_Alloc(size);
+  ULONG report_len;
+  UINT status;
+
+  if (report == NULL)
+  {
+    return webserver_send_buffer(server_ptr, "text/plain", (const UCHAR *)"busy", 4);
+  }
+
+  report_len = format(report, size);
+  status = webserver_send_buffer(server_ptr, "text/plain", (const UCHAR *)report, report_len);
+  Slab_Free(report);
+
+  return status;
+}
+
+/**
+* @brief  Send the response header of a body sent separately
+* @param  server_ptr : HTTP server instance
+* @param  content_type : MIME type
+* @param  length : body length in bytes
+* @retval NX_SUCCESS or error code
+*/
+static UINT webserver_send_header(NX_WEB_HTTP_SERVER *server_ptr, CHAR *content_type, ULONG length)
+{
+  NX_PACKET *resp_packet_ptr;
+  UINT status;
+
+  status = nx_web_http_server_callback_generate_response_header(server_ptr, &resp_packet_ptr, NX_WEB_HTTP_STATUS_OK,
+                                                                length, content_type, NX_NULL);
+  if (status != NX_SUCCESS)
+  {
+    return status;
+  }
+
+  status = nx_web_http_server_callback_packet_send(server_ptr, resp_packet_ptr);
+  if (status != NX_SUCCESS)
+  {
+    nx_packet_release(resp_packet_ptr);
+  }
+
+  return status;
+}
+
+/**
+* @brief  Send a response body copied into server packets
+* @param  server_ptr : HTTP server instance
+* @param  data : response body
+* @param  length : body length in bytes
+* @retval NX_SUCCESS or error code
+*/
+static UINT webserver_send_body(NX_WEB_HTTP_SERVER *server_ptr, const UCHAR *data, ULONG length)
+{
+  ULONG offset;
+  ULONG chunk;
+  UINT status;
+
+  for (offset = 0; offset < length; offset += chunk)
+  {
+    chunk = length - offset;
+    if (chunk > HTTP_CHUNK_SIZE)
+    {
+      chunk = HTTP_CHUNK_SIZE;
+    }
+
+    status = nx_web_http_server_callback_data_send(server_ptr, (VOID *)(data + offset), chunk);
+    if (status != NX_SUCCESS)
+    {
+      return status;
+    }
+  }
+
+  return NX_SUCCESS;
+}
+
+/**
+* @brief  Send a complete response whose body is lent to TCP
+* @param  server_ptr : HTTP server instance
+* @param  content_type : MIME type
+* @param  data : response body, left untouched until release runs
+* @param  length : body length in bytes
+* @param  loan : loan record, valid until release runs
+* @param  release : called once the body is no longer referenced, may be NX_NULL
+* @param  context : release argument
+* @retval NX_WEB_HTTP_CALLBACK_COMPLETED on success, error code otherwise
+*
+* Unaligned bodies, HTTPS and a failed TcpZeroCopy_Init() take the copy
+* path; release then runs before this returns.
+*/
+static UINT webserver_send_lent(NX_WEB_HTTP_SERVER *server_ptr, CHAR *content_type, const UCHAR *data, ULONG length,
+                                TcpZeroCopy_Loan_t *loan, TcpZeroCopy_Release_t release, VOID *context)
+{
+  UINT status;
+
+  status = webserver_send_header(server_ptr, content_type, length);
+  if (status != NX_SUCCESS)
+  {
+    if (release)
+    {
+      release(context);
+    }
+    return status;
+  }
+
+  status = webserver_send_lent_body(server_ptr, data, length, loan, release, context);
+
+  return (status == NX_SUCCESS) ? NX_WEB_HTTP_CALLBACK_COMPLETED : status;
+}
+
+/**
+* @brief  Lend (part of) a response body to TCP, after its header
+* @param  server_ptr : HTTP server instance
+* @param  data : body bytes, left untouched until release runs
+* @param  length : bytes
+* @param  loan : loan record, valid until release runs
+* @param  release : called once the bytes are no longer referenced, may be NX_NULL
+* @param  context : release argument
+* @retval NX_SUCCESS or error code; release runs in every case
+*/
+static UINT webserver_send_lent_body(NX_WEB_HTTP_SERVER *server_ptr, const UCHAR *data, ULONG length,
+                                     TcpZeroCopy_Loan_t *loan, TcpZeroCopy_Release_t release, VOID *context)
+{
+  NX_TCP_SOCKET *socket_ptr = &server_ptr->nx_web_http_server_current_session_ptr->nx_tcp_session_socket;
+  UINT status;
+
+  status = NX_NOT_SUPPORTED;
+#ifdef NX_WEB_HTTPS_ENABLE
+  if (!server_ptr->nx_web_http_is_https_server)
+#endif
+  {
+    status = TcpZeroCopy_Send(socket_ptr, loan, data, length, release, context, NX_WEB_HTTP_SERVER_TIMEOUT_SEND);
+  }
+
+  if (status == NX_NOT_SUPPORTED || status == NX_NOT_ENABLED || status == NX_PTR_ERROR)
+  {
+    /* Nothing was lent */
+    status = webserver_send_body(server_ptr, data, length);
+    if (release)
+    {
+      release(context);
+    }
+  }
+
+  return status;
+}
+
+/**
+* @brief  Serve DOWNLOAD_BENCH_SIZE bytes of a pattern and time the transfer
+* @param  server_ptr : HTTP server instance
+* @param  zero_copy : lend the pattern block to TCP, or copy it into server packets
+* @retval NX_WEB_HTTP_CALLBACK_COMPLETED on success, error code otherwise
+*
+* The body is download_block over and over. Timed from the response header
+* to the acknowledgement of the last byte: TCP releases segments in
+* sequence order, so the last block lent coming back ends the run (in the
+* copy mode only that block is lent). The result is stored from the
+* release callback; the web server thread does not wait for it. The CPU
+* share comes from the busy cycles of cpu_load.c.
+*/
+static UINT webserver_download(NX_WEB_HTTP_SERVER *server_ptr, UINT zero_copy)
+{
+  TX_INTERRUPT_SAVE_AREA
+  const UCHAR *data = (const UCHAR *)download_block;
+  ULONG offset;
+  UINT finished;
+  UINT status;
+
+  TX_DISABLE
+  if (download_ctx.running)
+  {
+    TX_RESTORE
+    return webserver_send_buffer(server_ptr, "text/plain", (const UCHAR *)"busy", 4);
+  }
+  download_ctx.running = NX_TRUE;
+  download_ctx.sending = NX_TRUE;
+  download_ctx.lent = 0;
+  download_ctx.released = 0;
+  TX_RESTORE
+
+  download_ctx.zero_copy = zero_copy;
+  download_ctx.bytes = 0;
+  download_ctx.busy_start = CpuLoad_GetBusyCycles();
+  download_ctx.start = tx_time_get();
+
+  status = webserver_send_header(server_ptr, "application/octet-stream", DOWNLOAD_BENCH_SIZE);
+
+  for (offset = 0; status == NX_SUCCESS && offset < DOWNLOAD_BENCH_SIZE; offset += DOWNLOAD_BLOCK_SIZE)
+  {
+    if (!zero_copy && offset + DOWNLOAD_BLOCK_SIZE < DOWNLOAD_BENCH_SIZE)
+    {
+      status = webserver_send_body(server_ptr, data, DOWNLOAD_BLOCK_SIZE);
+    }
+    else if (tx_semaphore_get(&download_ctx.loans_free, NX_WEB_HTTP_SERVER_TIMEOUT_SEND) != TX_SUCCESS)
+    {
+      status = NX_WINDOW_OVERFLOW;
+    }
+    else
+    {
+      /* Records come back in the order they were lent */
+      TX_DISABLE
+      download_ctx.lent++;
+      TX_RESTORE
+      status = webserver_send_lent_body(server_ptr, data, DOWNLOAD_BLOCK_SIZE,
+                                        &download_ctx.loans[(download_ctx.lent - 1U) % DOWNLOAD_LOANS],
+                                        download_loan_release, NX_NULL);
+    }
+    if (status == NX_SUCCESS)
+    {
+      download_ctx.bytes += DOWNLOAD_BLOCK_SIZE;
+    }
+  }
+
+  TX_DISABLE
+  download_ctx.sending = NX_FALSE;
+  finished = (download_ctx.released == download_ctx.lent);
+  TX_RESTORE
+
+  if (finished)
+  {
+    download_finish();
+  }
+
+  return (status == NX_SUCCESS) ? NX_WEB_HTTP_CALLBACK_COMPLETED : status;
+}
+
+/**
+* @brief  A block of the running download is no longer referenced
+* @param  context : unused
+* @retval None
+*/
+static VOID download_loan_release(VOID *context)
+{
+  TX_INTERRUPT_SAVE_AREA
+  UINT finished;
+
+  NX_PARAMETER_NOT_USED(context);
+
+  TX_DISABLE
+  download_ctx.released++;
+  finished = (!download_ctx.sending && download_ctx.released == download_ctx.lent);
+  TX_RESTORE
+
+  tx_semaphore_put(&download_ctx.loans_free);
+
+  if (finished)
+  {
+    download_finish();
+  }
+}
+
+/**
+* @brief  Store the result of the download run that just completed
+* @retval None
+*/
+static VOID download_finish(VOID)
+{
+  ULONG elapsed = (tx_time_get() - download_ctx.start) * 1000U / TX_TIMER_TICKS_PER_SECOND;
+
+  download_result.zero_copy = download_ctx.zero_copy;
+  download_result.bytes = download_ctx.bytes;
+  download_result.ms = elapsed;
+  download_result.cpu_permille = elapsed ? (ULONG)((CpuLoad_GetBusyCycles() - download_ctx.busy_start) * 1000U /
+                                                   ((uint64_t)elapsed * (SystemCoreClock / 1000U))) : 0UL;
+  download_ctx.running = NX_FALSE;
+}
+
+/**
+* @brief  Format the /GetZeroCopy report: the loan counters and the last download run
+* @param  buf : report buffer
+* @param  size : buffer size
+* @retval Report length
+*/
+static uint32_t download_format(char *buf, uint32_t size)
+{
+  uint32_t len = TcpZeroCopy_Format(buf, size);
+
+  return App_Append(buf, size, len, "download,%s,%lu,%lu,%lu,%lu\n",
+                    download_result.zero_copy ? "zerocopy" : "copy", download_result.bytes, download_result.ms,
+                    download_result.ms ? download_result.bytes / download_result.ms : 0UL, download_result.cpu_permille);
+}
+
+/**
+* @brief  The /GetHistory response no longer references the snapshot
+* @param  context : unused
+* @retval None
+*/
+static VOID history_loan_release(VOID *context)
+{
+  NX_PARAMETER_NOT_USED(context);
+  tx_semaphore_put(&history_loan_done);
+}
+
+/**
+* @brief  Parse a dotted IPv4 address from a URL
+* @param  text : "a.b.c.d", may be followed by other characters
+* @param  ip_address : parsed address, host byte order as NetX uses it
+* @param  end : first character after the address
+* @retval NX_SUCCESS, NX_NOT_SUCCESSFUL if malformed
+*/
+static UINT webserver_parse_ipv4(const CHAR *text, ULONG *ip_address, CHAR **end)
+{
+  ULONG address = 0;
+  ULONG octet;
+  CHAR *next;
+
+  for (UINT i = 0; i < 4; i++)
+  {
+    octet = strtoul(text, &next, 10);
+    if (next == text || octet > 255 || (i < 3 && *next != '.'))
+    {
+      return NX_NOT_SUCCESSFUL;
+    }
+    address = (address << 8) | octet;
+    text = next + 1;
+  }
+
+  *ip_address = address;
+  *end = next;
+  return NX_SUCCESS;
+}
+
 /**
 * @brief  Application thread for HTTP web server
 * @param  thread_input : thread input
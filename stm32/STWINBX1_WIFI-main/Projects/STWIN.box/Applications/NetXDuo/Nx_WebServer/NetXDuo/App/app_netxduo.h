@@ -51,7 +51,11 @@
 #define DEFAULT_MAIN_PRIORITY       10
 #define TOGGLE_LED_PRIORITY         15   
 #define DEFAULT_PRIORITY            5  
-#define THREAD_MEMORY_SIZE          2 * DEFAULT_MEMORY_SIZE  
+#define THREAD_MEMORY_SIZE          (2 * DEFAULT_MEMORY_SIZE)
+#define IP_THREAD_STACK_SIZE        THREAD_MEMORY_SIZE
+#define MAIN_THREAD_STACK_SIZE      THREAD_MEMORY_SIZE
+#define WEB_THREAD_STACK_SIZE       THREAD_MEMORY_SIZE
+#define LED_THREAD_STACK_SIZE       DEFAULT_MEMORY_SIZE
 #define NULL_ADDRESS                0 
    
    /* HTTP connection port */
@@ -62,6 +66,16 @@
 #define SERVER_POOL_SIZE                 (SERVER_PACKET_SIZE * 4)
 /* Server stack */
 #define SERVER_STACK                     4096 
+/* Bytes per send for in-memory responses (one server packet) */
+#define HTTP_CHUNK_SIZE                  (SERVER_PACKET_SIZE - NX_TCP_PACKET)
+/* Ticks /GetHistory waits for the previous response to give the snapshot back */
+#define HISTORY_LOAN_TIMEOUT             (2 * NX_IP_PERIODIC_RATE)
+/* Bytes served by /GetDownload and /GetDownloadCopy, a pattern block repeated */
+#define DOWNLOAD_BENCH_SIZE              (1024U * 1024U)
+/* Pattern block size in RAM, a divisor of DOWNLOAD_BENCH_SIZE */
+#define DOWNLOAD_BLOCK_SIZE              4096U
+/* Blocks lent to TCP at once (three segments each at most, TCP_ZC_SEGMENTS in flight) */
+#define DOWNLOAD_LOANS                   8
 /* USER CODE END EC */
 
 /* Exported macro ------------------------------------------------------------*/
@@ -84,6 +98,9 @@ extern NX_IP   IpInstance;
 extern ULONG   IpAddress;
 extern ULONG   NetMask;
 
+/* SD card media (opened by the web server thread) */
+extern FX_MEDIA sdio_disk;
+
 /* USER CODE END EFP */
 
 /* Private defines -----------------------------------------------------------*/
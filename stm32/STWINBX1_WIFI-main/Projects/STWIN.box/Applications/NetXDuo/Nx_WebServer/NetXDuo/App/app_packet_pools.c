@@ -0,0 +1,292 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    app_packet_pools.c
+  * @author  Wind Turbine Team
+  * @brief   Packet pools partitioned per traffic class
+  ******************************************************************************
+  * The reserve check and the borrow from the rx pool happen with interrupts
+  * disabled, so two borrowers cannot both take the last packet above the
+  * reserve. nx_packet_allocate() with NX_NO_WAIT does not suspend, which
+  * makes that safe. Waiting is only ever done on the class pool itself.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_packet_pools.h"
+#include "app_util.h"
+#include "slab_alloc.h"
+#include "timer_wheel.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+_Static_assert(PACKET_POOLS_REPORT_SIZE <= SLAB_MAX_BLOCK_SIZE, "report does not fit the largest slab class");
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    NX_PACKET_POOL        *pool;
+    PacketPools_Stats_t    stats;
+} PacketPools_ClassState_t;
+
+typedef struct
+{
+    PacketPools_ClassState_t classes[PACKET_CLASS_COUNT];
+    TimerWheel_Timer_t     sample_timer;
+} PacketPools_Context_t;
+
+/* Private variables ---------------------------------------------------------*/
+static PacketPools_Context_t pools_ctx;
+
+static const char *const packet_class_names[PACKET_CLASS_COUNT] =
+{
+    "rx",
+    "telemetry",
+    "http",
+    "control",
+    "bulk",
+};
+
+/* Classes allowed to take from the rx pool above its reserve */
+static const uint8_t packet_class_can_borrow[PACKET_CLASS_COUNT] =
+{
+    0,      /* rx */
+    1,      /* telemetry */
+    0,      /* http: the web server allocates from its pool itself */
+    0,      /* control */
+    1,      /* bulk */
+};
+
+/* Counted by the Wi-Fi driver (nx_driver_emw3080.h) */
+extern ULONG nx_driver_emw3080_rx_drops;
+
+/* Private function prototypes -----------------------------------------------*/
+static void PacketPools_SampleTimer(ULONG input);
+static void PacketPools_Account(PacketPools_ClassState_t *c, uint32_t borrowed, uint32_t waited, ULONG wait_ticks);
+static void PacketPools_UpdateHighWater(PacketPools_ClassState_t *c);
+
+/**
+  * @brief  Start high-water sampling
+  * @retval TX_SUCCESS or error code
+  */
+UINT PacketPools_Init(void)
+{
+    memset(&pools_ctx, 0, sizeof(pools_ctx));
+
+    TimerWheel_Create(&pools_ctx.sample_timer, "Packet Pools Sample", PacketPools_SampleTimer, 0);
+    return TimerWheel_Start(&pools_ctx.sample_timer,
+                            PACKET_POOLS_SAMPLE_MS,
+                            PACKET_POOLS_SAMPLE_MS,
+                            TIMER_WHEEL_SLACK(PACKET_POOLS_SAMPLE_MS));
+}
+
+/**
+  * @brief  Assign a pool to a class
+  * @param  cls: PacketPools_Class_t
+  * @param  pool: NetX packet pool
+  * @retval TX_SUCCESS or error code
+  */
+UINT PacketPools_Register(PacketPools_Class_t cls, NX_PACKET_POOL *pool)
+{
+    if ((uint32_t)cls >= PACKET_CLASS_COUNT || cls == PACKET_CLASS_BULK)
+        return TX_SIZE_ERROR;
+    if (!pool)
+        return TX_PTR_ERROR;
+
+    pools_ctx.classes[cls].pool = pool;
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Pool of a class
+  * @param  cls: PacketPools_Class_t
+  * @retval Pool or NULL
+  */
+NX_PACKET_POOL *PacketPools_Get(PacketPools_Class_t cls)
+{
+    if ((uint32_t)cls >= PACKET_CLASS_COUNT)
+        return NULL;
+
+    return pools_ctx.classes[cls].pool;
+}
+
+/**
+  * @brief  Allocate for a class
+  * @param  cls: PacketPools_Class_t
+  * @param  packet_ptr: receives the packet
+  * @param  packet_type: NetX packet type (header space)
+  * @param  wait_option: ticks to wait on the class pool
+  * @retval NX_SUCCESS, NX_NO_PACKET or NX_PTR_ERROR
+  */
+UINT PacketPools_Allocate(PacketPools_Class_t cls, NX_PACKET **packet_ptr,
+                          ULONG packet_type, ULONG wait_option)
+{
+    TX_INTERRUPT_SAVE_AREA
+    PacketPools_ClassState_t *c;
+    NX_PACKET_POOL *rx;
+    ULONG start;
+    UINT status;
+
+    if ((uint32_t)cls >= PACKET_CLASS_COUNT || !packet_ptr)
+        return NX_PTR_ERROR;
+
+    c = &pools_ctx.classes[cls];
+
+    /* Own pool while it has packets */
+    if (c->pool && nx_packet_allocate(c->pool, packet_ptr, packet_type, NX_NO_WAIT) == NX_SUCCESS)
+    {
+        PacketPools_Account(c, 0, 0, 0);
+        return NX_SUCCESS;
+    }
+
+    /* rx pool, leaving its reserve for the driver */
+    rx = pools_ctx.classes[PACKET_CLASS_RX].pool;
+    if (packet_class_can_borrow[cls] && rx)
+    {
+        TX_DISABLE
+        if (rx->nx_packet_pool_available > PACKET_POOLS_RX_RESERVE)
+            status = nx_packet_allocate(rx, packet_ptr, packet_type, NX_NO_WAIT);
+        else
+            status = NX_NO_PACKET;
+        TX_RESTORE
+
+        if (status == NX_SUCCESS)
+        {
+            PacketPools_Account(c, 1, 0, 0);
+            return NX_SUCCESS;
+        }
+    }
+
+    /* Bounded wait for a packet of the own pool to come back */
+    if (c->pool && wait_option != NX_NO_WAIT)
+    {
+        start = tx_time_get();
+        if (nx_packet_allocate(c->pool, packet_ptr, packet_type, wait_option) == NX_SUCCESS)
+        {
+            PacketPools_Account(c, 0, 1, tx_time_get() - start);
+            return NX_SUCCESS;
+        }
+    }
+
+    TX_DISABLE
+    c->stats.failed++;
+    TX_RESTORE
+
+    return NX_NO_PACKET;
+}
+
+/**
+  * @brief  Counters of a class
+  * @param  cls: PacketPools_Class_t
+  * @param  stats: output
+  * @retval None
+  */
+void PacketPools_GetStats(PacketPools_Class_t cls, PacketPools_Stats_t *stats)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if ((uint32_t)cls >= PACKET_CLASS_COUNT || !stats)
+        return;
+
+    TX_DISABLE
+    *stats = pools_ctx.classes[cls].stats;
+    TX_RESTORE
+}
+
+/**
+  * @brief  Format the counters as CSV lines
+  * @param  buf: output buffer
+  * @param  size: buffer size
+  * @retval Number of characters written
+  */
+uint32_t PacketPools_Format(char *buf, uint32_t size)
+{
+    uint32_t len = 0;
+
+    if (!buf || size == 0U)
+        return 0;
+
+    buf[0] = '\0';
+
+    for (uint32_t i = 0; i < PACKET_CLASS_COUNT; i++)
+    {
+        NX_PACKET_POOL *pool = pools_ctx.classes[i].pool;
+        PacketPools_Stats_t stats;
+        ULONG total = pool ? pool->nx_packet_pool_total : 0U;
+        ULONG available = pool ? pool->nx_packet_pool_available : 0U;
+
+        PacketPools_GetStats((PacketPools_Class_t)i, &stats);
+        len = App_Append(buf, size, len, "class,%s,%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+                         packet_class_names[i],
+                         pool ? pool->nx_packet_pool_name : "-",
+                         (unsigned long)total, (unsigned long)(total - available),
+                         (unsigned long)stats.high_water, (unsigned long)stats.allocs,
+                         (unsigned long)stats.borrowed, (unsigned long)stats.waited,
+                         (unsigned long)stats.failed, (unsigned long)stats.wait_max_ms);
+    }
+
+    len = App_Append(buf, size, len, "rx_drops,%lu\n", (unsigned long)nx_driver_emw3080_rx_drops);
+
+    return len;
+}
+
+/**
+  * @brief  Sample the pool occupancy (timer wheel callback)
+  * @param  input: unused
+  * @retval None
+  */
+static void PacketPools_SampleTimer(ULONG input)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    (void)input;
+
+    TX_DISABLE
+    for (uint32_t i = 0; i < PACKET_CLASS_COUNT; i++)
+        PacketPools_UpdateHighWater(&pools_ctx.classes[i]);
+    TX_RESTORE
+}
+
+/**
+  * @brief  Count a successful allocation
+  * @param  c: class state
+  * @param  borrowed: taken from the rx pool
+  * @param  waited: waited on the class pool
+  * @param  wait_ticks: how long
+  * @retval None
+  */
+static void PacketPools_Account(PacketPools_ClassState_t *c, uint32_t borrowed, uint32_t waited, ULONG wait_ticks)
+{
+    TX_INTERRUPT_SAVE_AREA
+    uint32_t wait_ms = (uint32_t)(wait_ticks * 1000U / TX_TIMER_TICKS_PER_SECOND);
+
+    TX_DISABLE
+    c->stats.allocs++;
+    c->stats.borrowed += borrowed;
+    c->stats.waited += waited;
+    if (wait_ms > c->stats.wait_max_ms)
+        c->stats.wait_max_ms = wait_ms;
+    PacketPools_UpdateHighWater(c);
+    TX_RESTORE
+}
+
+/**
+  * @brief  Raise the high-water mark to the current occupancy (interrupts disabled)
+  * @param  c: class state
+  * @retval None
+  */
+static void PacketPools_UpdateHighWater(PacketPools_ClassState_t *c)
+{
+    uint32_t in_use;
+
+    if (!c->pool)
+        return;
+
+    in_use = (uint32_t)(c->pool->nx_packet_pool_total - c->pool->nx_packet_pool_available);
+    if (in_use > c->stats.high_water)
+        c->stats.high_water = in_use;
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,129 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    app_packet_pools.h
+  * @author  Wind Turbine Team
+  * @brief   Packet pools partitioned per traffic class
+  ******************************************************************************
+  * Each traffic class gets its own NetX packet pool, so one class running
+  * out cannot take packets another class needs:
+  *
+  *   rx         main pool, default pool of the IP instance: Wi-Fi receive and
+  *              the packets NetX sends by itself (ARP, ICMP, TCP control)
+  *   telemetry  small packets for the 64-byte audio feature datagrams
+  *   http       web server pool
+  *   control    DHCP client pool (created by the DHCP client)
+  *   bulk       no pool of its own (iperf stress load)
+  *
+  * PacketPools_Allocate() takes from the class pool first. A class that may
+  * borrow (telemetry, bulk) then takes from the rx pool, but only while
+  * more than PACKET_POOLS_RX_RESERVE packets are left there, so receive is
+  * never starved by a sender. Only after that does it wait on its own pool,
+  * for the bounded time the caller gives. Borrowed packets go back to the rx
+  * pool on release, as NetX releases to the owning pool.
+  *
+  * The Wi-Fi driver allocates receive packets directly, so the occupancy
+  * high-water marks are also sampled every PACKET_POOLS_SAMPLE_MS.
+  */
+/* USER CODE END Header */
+
+#ifndef __APP_PACKET_POOLS_H
+#define __APP_PACKET_POOLS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+#include "nx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define PACKET_POOLS_RX_RESERVE         4       /* rx packets never lent to other classes */
+#define PACKET_POOLS_SAMPLE_MS          100     /* High-water sampling, same period as the memory budget */
+#define PACKET_POOLS_REPORT_SIZE        768     /* Report text, taken from the slab allocator */
+
+typedef enum
+{
+    PACKET_CLASS_RX = 0,
+    PACKET_CLASS_TELEMETRY,
+    PACKET_CLASS_HTTP,
+    PACKET_CLASS_CONTROL,
+    PACKET_CLASS_BULK,
+    PACKET_CLASS_COUNT
+} PacketPools_Class_t;
+
+typedef struct
+{
+    uint32_t allocs;                   /* PacketPools_Allocate() successes */
+    uint32_t borrowed;                 /* Of those, taken from the rx pool */
+    uint32_t waited;                   /* Had to wait on the class pool */
+    uint32_t failed;                   /* Nothing within the wait */
+    uint32_t wait_max_ms;              /* Longest successful wait */
+    uint32_t high_water;               /* Most packets of the class pool in use */
+} PacketPools_Stats_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Start high-water sampling (before the first PacketPools_Register)
+ * @retval TX_SUCCESS on success, error code otherwise
+ */
+UINT PacketPools_Init(void);
+
+/**
+ * @brief Assign a created pool to a class
+ * @param cls: PacketPools_Class_t (not PACKET_CLASS_BULK)
+ * @param pool: NetX packet pool
+ * @retval TX_SUCCESS, TX_PTR_ERROR or TX_SIZE_ERROR
+ */
+UINT PacketPools_Register(PacketPools_Class_t cls, NX_PACKET_POOL *pool);
+
+/**
+ * @brief Pool of a class
+ * @param cls: PacketPools_Class_t
+ * @retval Pool, NULL if none is registered
+ */
+NX_PACKET_POOL *PacketPools_Get(PacketPools_Class_t cls);
+
+/**
+ * @brief Allocate for a class: own pool, then rx above its reserve, then
+ *        wait on the own pool
+ * @param cls: PacketPools_Class_t
+ * @param packet_ptr: receives the packet
+ * @param packet_type: NX_UDP_PACKET, NX_TCP_PACKET, ...
+ * @param wait_option: ticks to wait on the class pool, at most
+ * @retval NX_SUCCESS, NX_NO_PACKET or NX_PTR_ERROR
+ */
+UINT PacketPools_Allocate(PacketPools_Class_t cls, NX_PACKET **packet_ptr,
+                          ULONG packet_type, ULONG wait_option);
+
+/**
+ * @brief Counters of a class
+ * @param cls: PacketPools_Class_t
+ * @param stats: output
+ * @retval None
+ */
+void PacketPools_GetStats(PacketPools_Class_t cls, PacketPools_Stats_t *stats);
+
+/**
+ * @brief Format the counters as CSV lines
+ * @param buf: output buffer
+ * @param size: buffer size
+ * @retval Number of characters written (excluding terminator)
+ *
+ * Line format, one per class, then the driver receive drops:
+ *   class,<name>,<pool>,<total>,<in_use>,<high_water>,<allocs>,<borrowed>,
+ *         <waited>,<failed>,<wait_max_ms>
+ *   rx_drops,<frames>
+ */
+uint32_t PacketPools_Format(char *buf, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_PACKET_POOLS_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
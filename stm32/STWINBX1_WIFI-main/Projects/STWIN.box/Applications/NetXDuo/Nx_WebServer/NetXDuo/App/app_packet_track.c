@@ -0,0 +1,581 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    app_packet_track.c
+  * @author  Wind Turbine Team
+  * @brief   Packet lifetime tracker: hold times per owner and leak suspects
+  ******************************************************************************
+  * The release callback runs in whichever thread or ISR releases the packet,
+  * so the owner table is only touched with interrupts disabled and a new
+  * owner takes a free row there; rows are never removed. The scan runs in
+  * the timer wheel callback and copies each packet's record with interrupts
+  * disabled, a packet at a time, so a pool is not seen as one instant.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_packet_track.h"
+#include "app_util.h"
+#include "nx_packet.h"
+#include "slab_alloc.h"
+#include "timer_wheel.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+_Static_assert(PACKET_TRACK_REPORT_SIZE <= SLAB_MAX_BLOCK_SIZE, "report does not fit the largest slab class");
+_Static_assert(PACKET_TRACK_DUMP_SIZE <= SLAB_MAX_BLOCK_SIZE, "dump does not fit the largest slab class");
+
+#define PACKET_TRACK_TICKS_TO_MS(t)     ((ULONG)(((uint64_t)(t) * 1000U) / TX_TIMER_TICKS_PER_SECOND))
+#define PACKET_TRACK_OTHER              (PACKET_TRACK_OWNERS - 1U)
+
+#ifdef NX_ENABLE_PACKET_DEBUG_INFO
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    const CHAR            *name;               /* NULL while free */
+    uint32_t               in_use;             /* At the last scan */
+    uint32_t               suspects;
+    uint32_t               released;
+    uint32_t               hold[PACKET_TRACK_BUCKETS];
+    uint32_t               hold_max_ms;
+} PacketTrack_Owner_t;
+
+typedef struct
+{
+    PacketTrack_Owner_t    owners[PACKET_TRACK_OWNERS];
+    PacketTrack_Stats_t    stats;
+    NX_PACKET_POOL        *excluded[PACKET_TRACK_EXCLUDE_MAX];
+    uint32_t               excluded_count;
+    ULONG                  last_scan;          /* tx_time_get() of the last scan */
+    TimerWheel_Timer_t     scan_timer;
+    UINT                   is_ready;
+} PacketTrack_Context_t;
+
+/* One held packet, copied with interrupts disabled */
+typedef struct
+{
+    const CHAR            *pool;
+    UINT                   index;
+    ULONG                  age_ms;
+    const CHAR            *owner;
+    VOID                  *site;
+    ALIGN_TYPE             state;
+    const CHAR            *last_thread;
+    const CHAR            *last_file;
+    ULONG                  last_line;
+} PacketTrack_Held_t;
+
+typedef void (*PacketTrack_Visit_t)(const PacketTrack_Held_t *held, void *arg);
+
+/* Private variables ---------------------------------------------------------*/
+static PacketTrack_Context_t track_ctx;
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID PacketTrack_Release(NX_PACKET *packet_ptr);
+static void PacketTrack_ScanTimer(ULONG input);
+static void PacketTrack_ScanVisit(const PacketTrack_Held_t *held, void *arg);
+static void PacketTrack_DumpVisit(const PacketTrack_Held_t *held, void *arg);
+static uint32_t PacketTrack_Walk(PacketTrack_Visit_t visit, void *arg, uint32_t *pools);
+static uint32_t PacketTrack_OwnerIndex(const CHAR *name);
+static UINT PacketTrack_IsExcluded(const NX_PACKET_POOL *pool_ptr);
+static uint32_t PacketTrack_Bucket(ULONG ms);
+static const char *PacketTrack_State(ALIGN_TYPE state);
+static const char *PacketTrack_Basename(const char *path);
+
+/* Scan totals, per owner row */
+typedef struct
+{
+    uint32_t               in_use[PACKET_TRACK_OWNERS];
+    uint32_t               suspects[PACKET_TRACK_OWNERS];
+    uint32_t               leaks;
+    ULONG                  since_ms;           /* Since the previous scan */
+} PacketTrack_Scan_t;
+
+/* Oldest held packets, oldest first */
+typedef struct
+{
+    PacketTrack_Held_t     held[PACKET_TRACK_DUMP_MAX];
+    uint32_t               count;
+} PacketTrack_Oldest_t;
+
+/**
+  * @brief  Install the release callback and start the leak scan
+  * @retval TX_SUCCESS or error code
+  */
+UINT PacketTrack_Init(void)
+{
+    memset(&track_ctx, 0, sizeof(track_ctx));
+    track_ctx.owners[PACKET_TRACK_OTHER].name = "other";
+    track_ctx.last_scan = tx_time_get();
+
+    _nx_packet_debug_release_notify = PacketTrack_Release;
+    track_ctx.is_ready = 1;
+
+    TimerWheel_Create(&track_ctx.scan_timer, "Packet Track Scan", PacketTrack_ScanTimer, 0);
+    return TimerWheel_Start(&track_ctx.scan_timer,
+                            PACKET_TRACK_SCAN_MS,
+                            PACKET_TRACK_SCAN_MS,
+                            TIMER_WHEEL_SLACK(PACKET_TRACK_SCAN_MS));
+}
+
+/**
+  * @brief  Leave a pool out of the scan and the hold histograms
+  * @param  pool_ptr: pool whose packets are held by design
+  * @retval TX_SUCCESS, TX_PTR_ERROR or NX_OVERFLOW
+  */
+UINT PacketTrack_ExcludePool(NX_PACKET_POOL *pool_ptr)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    UINT status = TX_SUCCESS;
+
+    if (!pool_ptr)
+        return TX_PTR_ERROR;
+
+    TX_DISABLE
+    if (!PacketTrack_IsExcluded(pool_ptr))
+    {
+        if (track_ctx.excluded_count < PACKET_TRACK_EXCLUDE_MAX)
+            track_ctx.excluded[track_ctx.excluded_count++] = pool_ptr;
+        else
+            status = NX_OVERFLOW;
+    }
+    TX_RESTORE
+
+    return status;
+}
+
+/**
+  * @brief  Tracker counters as of the last scan
+  * @param  stats: output
+  * @retval None
+  */
+void PacketTrack_GetStats(PacketTrack_Stats_t *stats)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if (!stats)
+        return;
+
+    TX_DISABLE
+    *stats = track_ctx.stats;
+    TX_RESTORE
+}
+
+/**
+  * @brief  Format the counters and the owners as CSV
+  * @param  buf: output buffer
+  * @param  size: buffer size
+  * @retval Number of characters written (excluding terminator)
+  */
+uint32_t PacketTrack_Format(char *buf, uint32_t size)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    PacketTrack_Owner_t owners[PACKET_TRACK_OWNERS];
+    PacketTrack_Stats_t stats;
+    uint32_t len;
+
+    if (!buf || size == 0U)
+        return 0;
+
+    buf[0] = '\0';
+
+    if (!track_ctx.is_ready)
+        return 0;
+
+    TX_DISABLE
+    memcpy(owners, track_ctx.owners, sizeof(owners));
+    stats = track_ctx.stats;
+    TX_RESTORE
+
+    len = App_Append(buf, size, 0, "track,%lu,%lu,%lu,%lu,%lu,%lu\n",
+                     (unsigned long)stats.pools, (unsigned long)stats.packets,
+                     (unsigned long)stats.in_use, (unsigned long)stats.suspects,
+                     (unsigned long)stats.leaks, (unsigned long)PACKET_TRACK_LEAK_MS);
+
+    for (uint32_t i = 0; i < PACKET_TRACK_OWNERS; i++)
+    {
+        PacketTrack_Owner_t *o = &owners[i];
+
+        if (!o->name || (o->released == 0U && o->in_use == 0U))
+            continue;
+
+        len = App_Append(buf, size, len, "owner,%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+                         o->name, (unsigned long)o->in_use, (unsigned long)o->suspects,
+                         (unsigned long)o->released,
+                         (unsigned long)o->hold[0], (unsigned long)o->hold[1], (unsigned long)o->hold[2],
+                         (unsigned long)o->hold[3], (unsigned long)o->hold[4], (unsigned long)o->hold[5],
+                         (unsigned long)o->hold_max_ms);
+    }
+
+    return len;
+}
+
+/**
+  * @brief  List the packets held now, oldest first
+  * @param  buf: output buffer
+  * @param  size: buffer size
+  * @retval Number of characters written (excluding terminator)
+  */
+uint32_t PacketTrack_Dump(char *buf, uint32_t size)
+{
+    PacketTrack_Oldest_t *oldest;
+    uint32_t len = 0;
+
+    if (!buf || size == 0U)
+        return 0;
+
+    buf[0] = '\0';
+
+    if (!track_ctx.is_ready)
+        return 0;
+
+    /* Too large for the web server stack */
+    oldest = (PacketTrack_Oldest_t *)Slab_Alloc(sizeof(PacketTrack_Oldest_t));
+    if (!oldest)
+        return 0;
+
+    oldest->count = 0;
+    (void)PacketTrack_Walk(PacketTrack_DumpVisit, oldest, NULL);
+
+    for (uint32_t i = 0; i < oldest->count; i++)
+    {
+        PacketTrack_Held_t *h = &oldest->held[i];
+
+        len = App_Append(buf, size, len, "packet,%s,%u,%lu,%u,%s,0x%08lx,%s,%s,%s:%lu\n",
+                         h->pool ? h->pool : "-", h->index, (unsigned long)h->age_ms,
+                         (h->age_ms >= PACKET_TRACK_LEAK_MS) ? 1U : 0U,
+                         h->owner ? h->owner : "-", (unsigned long)(ALIGN_TYPE)h->site,
+                         PacketTrack_State(h->state),
+                         h->last_thread ? h->last_thread : "-",
+                         PacketTrack_Basename(h->last_file), (unsigned long)h->last_line);
+    }
+
+    Slab_Free(oldest);
+
+    return len;
+}
+
+/**
+  * @brief  NetX release callback: add the hold time to the owner's histogram
+  * @param  packet_ptr: packet going back to its pool
+  * @retval None
+  */
+static VOID PacketTrack_Release(NX_PACKET *packet_ptr)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    ULONG held_ms = PACKET_TRACK_TICKS_TO_MS(tx_time_get() - packet_ptr->nx_packet_debug_alloc_time);
+    PacketTrack_Owner_t *o;
+
+    if (PacketTrack_IsExcluded(packet_ptr->nx_packet_pool_owner))
+        return;
+
+    TX_DISABLE
+    o = &track_ctx.owners[PacketTrack_OwnerIndex(packet_ptr->nx_packet_debug_alloc_thread)];
+    o->released++;
+    o->hold[PacketTrack_Bucket(held_ms)]++;
+    if (held_ms > o->hold_max_ms)
+        o->hold_max_ms = held_ms;
+    TX_RESTORE
+}
+
+/**
+  * @brief  Count the held packets and the leak suspects (timer wheel callback)
+  * @param  input: unused
+  * @retval None
+  */
+static void PacketTrack_ScanTimer(ULONG input)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    PacketTrack_Scan_t scan;
+    uint32_t pools = 0;
+    uint32_t packets;
+    uint32_t in_use = 0;
+    uint32_t suspects = 0;
+    ULONG now = tx_time_get();
+
+    (void)input;
+
+    memset(&scan, 0, sizeof(scan));
+    scan.since_ms = PACKET_TRACK_TICKS_TO_MS(now - track_ctx.last_scan);
+    track_ctx.last_scan = now;
+
+    packets = PacketTrack_Walk(PacketTrack_ScanVisit, &scan, &pools);
+
+    TX_DISABLE
+    for (uint32_t i = 0; i < PACKET_TRACK_OWNERS; i++)
+    {
+        track_ctx.owners[i].in_use = scan.in_use[i];
+        track_ctx.owners[i].suspects = scan.suspects[i];
+        in_use += scan.in_use[i];
+        suspects += scan.suspects[i];
+    }
+    track_ctx.stats.pools = pools;
+    track_ctx.stats.packets = packets;
+    track_ctx.stats.in_use = in_use;
+    track_ctx.stats.suspects = suspects;
+    track_ctx.stats.leaks += scan.leaks;
+    track_ctx.stats.scans++;
+    TX_RESTORE
+}
+
+/**
+  * @brief  Scan visitor: count a held packet against its owner
+  * @param  held: packet record
+  * @param  arg: PacketTrack_Scan_t
+  * @retval None
+  */
+static void PacketTrack_ScanVisit(const PacketTrack_Held_t *held, void *arg)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    PacketTrack_Scan_t *scan = (PacketTrack_Scan_t *)arg;
+    uint32_t owner;
+
+    TX_DISABLE
+    owner = PacketTrack_OwnerIndex(held->owner);
+    TX_RESTORE
+
+    scan->in_use[owner]++;
+    if (held->age_ms >= PACKET_TRACK_LEAK_MS)
+    {
+        scan->suspects[owner]++;
+
+        /* Crossed the threshold since the previous scan */
+        if (held->age_ms - scan->since_ms < PACKET_TRACK_LEAK_MS)
+            scan->leaks++;
+    }
+}
+
+/**
+  * @brief  Dump visitor: keep the oldest packets, oldest first
+  * @param  held: packet record
+  * @param  arg: PacketTrack_Oldest_t
+  * @retval None
+  */
+static void PacketTrack_DumpVisit(const PacketTrack_Held_t *held, void *arg)
+{
+    PacketTrack_Oldest_t *oldest = (PacketTrack_Oldest_t *)arg;
+    uint32_t i = oldest->count;
+
+    if (i == PACKET_TRACK_DUMP_MAX)
+    {
+        if (held->age_ms <= oldest->held[i - 1U].age_ms)
+            return;
+        i--;
+    }
+    else
+    {
+        oldest->count++;
+    }
+
+    while (i > 0U && oldest->held[i - 1U].age_ms < held->age_ms)
+    {
+        oldest->held[i] = oldest->held[i - 1U];
+        i--;
+    }
+    oldest->held[i] = *held;
+}
+
+/**
+  * @brief  Visit every packet of every tracked pool that is not in its pool
+  * @param  visit: called per held packet
+  * @param  arg: passed to visit
+  * @param  pools: pools walked, excluded ones not counted (may be NULL)
+  * @retval Packets walked
+  */
+static uint32_t PacketTrack_Walk(PacketTrack_Visit_t visit, void *arg, uint32_t *pools)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    NX_PACKET_POOL *pool_ptr = _nx_packet_pool_created_ptr;
+    ULONG pool_count = _nx_packet_pool_created_count;
+    uint32_t walked = 0;
+    uint32_t packets = 0;
+    ULONG now = tx_time_get();
+
+    /* Pools are created at start-up and never deleted */
+    for (ULONG p = 0; p < pool_count && pool_ptr; p++, pool_ptr = pool_ptr->nx_packet_pool_created_next)
+    {
+        if (PacketTrack_IsExcluded(pool_ptr))
+            continue;
+
+        walked++;
+        for (UINT i = 0; i < pool_ptr->nx_packet_pool_total; i++)
+        {
+            NX_PACKET *packet_ptr;
+            PacketTrack_Held_t held;
+
+            (void)_nx_packet_debug_info_get(pool_ptr, i, &packet_ptr, NX_NULL, NX_NULL, NX_NULL, NX_NULL);
+
+            TX_DISABLE
+            held.state = (ALIGN_TYPE)packet_ptr->nx_packet_union_next.nx_packet_tcp_queue_next;
+            held.owner = packet_ptr->nx_packet_debug_alloc_thread;
+            held.site = packet_ptr->nx_packet_debug_alloc_site;
+            held.age_ms = PACKET_TRACK_TICKS_TO_MS(now - packet_ptr->nx_packet_debug_alloc_time);
+            held.last_thread = packet_ptr->nx_packet_debug_thread;
+            held.last_file = packet_ptr->nx_packet_debug_file;
+            held.last_line = packet_ptr->nx_packet_debug_line;
+            TX_RESTORE
+
+            packets++;
+            if (held.state == NX_PACKET_FREE)
+                continue;
+
+            held.pool = pool_ptr->nx_packet_pool_name;
+            held.index = i;
+            visit(&held, arg);
+        }
+    }
+
+    if (pools)
+        *pools = walked;
+
+    return packets;
+}
+
+/**
+  * @brief  Owner row of a thread name, taking a free row for a new name
+  *         (interrupts disabled)
+  * @param  name: allocating thread name, may be NULL
+  * @retval Row index
+  *
+  * Rows are matched by address only: a thread keeps its name pointer and
+  * NetX records one shared string for interrupt allocations, so the release
+  * path never compares strings.
+  */
+static uint32_t PacketTrack_OwnerIndex(const CHAR *name)
+{
+    uint32_t i;
+
+    if (!name)
+        return PACKET_TRACK_OTHER;
+
+    for (i = 0; i < PACKET_TRACK_OTHER; i++)
+    {
+        const CHAR *row = track_ctx.owners[i].name;
+
+        if (row == name)
+            return i;
+        if (!row)
+        {
+            track_ctx.owners[i].name = name;
+            return i;
+        }
+    }
+
+    return PACKET_TRACK_OTHER;
+}
+
+/**
+  * @brief  Whether a pool was left out of the tracking
+  * @param  pool_ptr: packet pool
+  * @retval 1 if excluded, 0 otherwise
+  *
+  * Pools are only added, each before its first packet is used, so the
+  * release path reads the list without disabling interrupts.
+  */
+static UINT PacketTrack_IsExcluded(const NX_PACKET_POOL *pool_ptr)
+{
+    for (uint32_t i = 0; i < track_ctx.excluded_count; i++)
+    {
+        if (track_ctx.excluded[i] == pool_ptr)
+            return 1;
+    }
+
+    return 0;
+}
+
+/**
+  * @brief  Histogram bucket of a hold time
+  * @param  ms: hold time
+  * @retval Bucket index
+  */
+static uint32_t PacketTrack_Bucket(ULONG ms)
+{
+    uint32_t bucket = 0;
+    ULONG limit = 1;
+
+    while (bucket < PACKET_TRACK_BUCKETS - 1U && ms >= limit)
+    {
+        bucket++;
+        limit *= 10U;
+    }
+
+    return bucket;
+}
+
+/**
+  * @brief  Name of a packet state
+  * @param  state: nx_packet_tcp_queue_next of a held packet
+  * @retval Name
+  */
+static const char *PacketTrack_State(ALIGN_TYPE state)
+{
+    if (state == NX_PACKET_ALLOCATED)
+        return "app";
+    if (state == NX_DRIVER_TX_DONE)
+        return "driver";
+    return "tcp";
+}
+
+/**
+  * @brief  File name without its directories
+  * @param  path: __FILE__ of the last handler, may be NULL
+  * @retval File name
+  */
+static const char *PacketTrack_Basename(const char *path)
+{
+    const char *name;
+
+    if (!path)
+        return "-";
+
+    name = strrchr(path, '/');
+    if (!name)
+        name = strrchr(path, '\\');
+
+    return name ? name + 1 : path;
+}
+
+#else /* NX_ENABLE_PACKET_DEBUG_INFO */
+
+UINT PacketTrack_Init(void)
+{
+    return TX_FEATURE_NOT_ENABLED;
+}
+
+UINT PacketTrack_ExcludePool(NX_PACKET_POOL *pool_ptr)
+{
+    (void)pool_ptr;
+    return TX_FEATURE_NOT_ENABLED;
+}
+
+void PacketTrack_GetStats(PacketTrack_Stats_t *stats)
+{
+    if (stats)
+        memset(stats, 0, sizeof(*stats));
+}
+
+uint32_t PacketTrack_Format(char *buf, uint32_t size)
+{
+    if (buf && size > 0U)
+        buf[0] = '\0';
+    return 0;
+}
+
+uint32_t PacketTrack_Dump(char *buf, uint32_t size)
+{
+    if (buf && size > 0U)
+        buf[0] = '\0';
+    return 0;
+}
+
+#endif /* NX_ENABLE_PACKET_DEBUG_INFO */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,122 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    app_packet_track.h
+  * @author  Wind Turbine Team
+  * @brief   Packet lifetime tracker: hold times per owner and leak suspects
+  ******************************************************************************
+  * With NX_ENABLE_PACKET_DEBUG_INFO every NetX packet records the thread
+  * that allocated it (the owner), the code that called the allocate service
+  * (the site, a return address for addr2line) and the allocation tick, next
+  * to the last thread, file and line that handled it.
+  *
+  * NetX calls PacketTrack back for each packet going back to its pool. The
+  * hold time, from allocation to release, is added to the owner's histogram.
+  * Every PACKET_TRACK_SCAN_MS the packets of all created pools are walked:
+  * a packet held longer than PACKET_TRACK_LEAK_MS is a leak suspect, and
+  * the scan that first sees it past the threshold counts it as a leak.
+  * Packets queued in a TCP socket on a silent connection are suspects too;
+  * the dump shows their state and last handler. A pool whose packets are
+  * held by design, such as descriptors taken once at start-up, is excluded
+  * from both the scan and the histograms.
+  *
+  * Owners are told apart by the address of the thread name, and interrupt
+  * allocations share one "ISR" owner. The first PACKET_TRACK_OWNERS - 1
+  * owners get their own row and later ones share the "other" row.
+  */
+/* USER CODE END Header */
+
+#ifndef __APP_PACKET_TRACK_H
+#define __APP_PACKET_TRACK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+#include "nx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define PACKET_TRACK_OWNERS             8       /* Owner rows, the last one is "other" */
+#define PACKET_TRACK_BUCKETS            6       /* Hold times <1 ms, <10 ms, <100 ms, <1 s, <10 s, longer */
+#define PACKET_TRACK_SCAN_MS            1000    /* Leak scan period */
+#define PACKET_TRACK_LEAK_MS            5000    /* Held longer: leak suspect */
+#define PACKET_TRACK_DUMP_MAX           20      /* Oldest packets listed by the dump */
+#define PACKET_TRACK_REPORT_SIZE        1024    /* Report text, taken from the slab allocator */
+#define PACKET_TRACK_DUMP_SIZE          2048    /* Dump text, taken from the slab allocator */
+#define PACKET_TRACK_EXCLUDE_MAX        4       /* Pools left out of the tracking */
+
+typedef struct
+{
+    uint32_t pools;                    /* Created pools walked by the last scan */
+    uint32_t packets;                  /* Their packets */
+    uint32_t in_use;                   /* Not in a pool at the last scan */
+    uint32_t suspects;                 /* Of those, held past PACKET_TRACK_LEAK_MS */
+    uint32_t leaks;                    /* Packets seen crossing the threshold */
+    uint32_t scans;
+} PacketTrack_Stats_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Install the release callback and start the leak scan
+ *        (after nx_system_initialize)
+ * @retval TX_SUCCESS, TX_FEATURE_NOT_ENABLED without
+ *         NX_ENABLE_PACKET_DEBUG_INFO, or error code
+ */
+UINT PacketTrack_Init(void);
+
+/**
+ * @brief Leave a pool out of the scan and the hold histograms
+ *        (after PacketTrack_Init, before the pool is used)
+ * @param pool_ptr: pool whose packets are held by design
+ * @retval TX_SUCCESS, TX_PTR_ERROR, NX_OVERFLOW when
+ *         PACKET_TRACK_EXCLUDE_MAX pools are already excluded, or
+ *         TX_FEATURE_NOT_ENABLED without NX_ENABLE_PACKET_DEBUG_INFO
+ */
+UINT PacketTrack_ExcludePool(NX_PACKET_POOL *pool_ptr);
+
+/**
+ * @brief Tracker counters as of the last scan
+ * @param stats: output
+ * @retval None
+ */
+void PacketTrack_GetStats(PacketTrack_Stats_t *stats);
+
+/**
+ * @brief Format the counters and one line per owner as CSV
+ * @param buf: output buffer
+ * @param size: buffer size
+ * @retval Number of characters written (excluding terminator)
+ *
+ * Line format:
+ *   track,<pools>,<packets>,<in_use>,<suspects>,<leaks>,<leak_ms>
+ *   owner,<thread>,<in_use>,<suspects>,<released>,<lt1ms>,<lt10ms>,
+ *       <lt100ms>,<lt1s>,<lt10s>,<ge10s>,<hold_max_ms>
+ * in_use and suspects are from the last scan.
+ */
+uint32_t PacketTrack_Format(char *buf, uint32_t size);
+
+/**
+ * @brief List the packets held now, oldest first, as CSV
+ * @param buf: output buffer
+ * @param size: buffer size
+ * @retval Number of characters written (excluding terminator)
+ *
+ * Line format, at most PACKET_TRACK_DUMP_MAX lines:
+ *   packet,<pool>,<index>,<age_ms>,<suspect>,<owner>,<site>,<state>,
+ *       <last_thread>,<last_file>:<last_line>
+ * site is the caller's return address in hex. state is app (allocated),
+ * tcp (queued in a TCP socket) or driver (transmit done, not yet freed).
+ */
+uint32_t PacketTrack_Dump(char *buf, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_PACKET_TRACK_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,122 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    app_rx_batch.c
+  * @author  Wind Turbine Team
+  * @brief   Wi-Fi receive path report: I/O thread and IP thread batches
+  ******************************************************************************
+  * The driver counters are plain ULONGs written by the I/O thread, and the
+  * IP counters are written by the IP thread; both are copied with interrupts
+  * disabled so the busy cycle words and the buckets are read as one.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_rx_batch.h"
+#include "app_util.h"
+#include "nx_driver_emw3080.h"
+#include "mem_budget.h"
+#include "slab_alloc.h"
+#include "stm32u5xx.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+_Static_assert(RX_BATCH_REPORT_SIZE <= SLAB_MAX_BLOCK_SIZE, "report does not fit the largest slab class");
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    NX_IP                 *ip;
+    uint64_t               last_busy;          /* Busy cycles at the previous report */
+    ULONG                  last_time;          /* tx_time_get() at the previous report */
+} RxBatch_Context_t;
+
+/* Private variables ---------------------------------------------------------*/
+static RxBatch_Context_t batch_ctx;
+
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+  * @brief  Select the IP instance reported and account the I/O thread stack
+  * @param  ip_instance: IP instance of the Wi-Fi interface
+  * @retval None
+  */
+void RxBatch_Init(NX_IP *ip_instance)
+{
+    batch_ctx.ip = ip_instance;
+    batch_ctx.last_busy = 0;
+    batch_ctx.last_time = tx_time_get();
+
+    /* The driver owns the stack (nx_driver_emw3080.c) */
+    MemBudget_RegisterStatic("nx_driver", "Wi-Fi I/O stack", NX_DRIVER_EMW3080_IO_STACK_SIZE);
+}
+
+/**
+  * @brief  Format the receive path counters as CSV
+  * @param  buf: output buffer
+  * @param  size: buffer size
+  * @retval Number of characters written (excluding terminator)
+  */
+uint32_t RxBatch_Format(char *buf, uint32_t size)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    ULONG io[5];
+    ULONG batches[NX_IP_RECEIVE_BATCH_BUCKETS] = {0};
+    ULONG batch_max = 0;
+    ULONG batch_cut = 0;
+    uint64_t busy = 0;
+    ULONG now;
+    uint64_t elapsed;
+    uint64_t busy_delta;
+    uint32_t permille = 0;
+    uint32_t len;
+
+    if (!buf || size == 0U)
+        return 0;
+
+    buf[0] = '\0';
+
+    if (!batch_ctx.ip)
+        return 0;
+
+    TX_DISABLE
+    io[0] = nx_driver_emw3080_io_wakeups;
+    io[1] = nx_driver_emw3080_io_polls;
+    io[2] = nx_driver_emw3080_io_batch_max;
+    io[3] = nx_driver_emw3080_rx_frames;
+    io[4] = nx_driver_emw3080_rx_drops;
+#ifdef NX_ENABLE_IP_THREAD_INFO
+    memcpy(batches, batch_ctx.ip->nx_ip_receive_batch_count, sizeof(batches));
+    batch_max = batch_ctx.ip->nx_ip_receive_batch_max;
+    batch_cut = batch_ctx.ip->nx_ip_receive_batch_cut;
+    busy = ((uint64_t)batch_ctx.ip->nx_ip_thread_busy_cycles_upper << 32) | batch_ctx.ip->nx_ip_thread_busy_cycles;
+#endif /* NX_ENABLE_IP_THREAD_INFO */
+    now = tx_time_get();
+    TX_RESTORE
+
+    /* Share of the time since the previous report */
+    elapsed = (uint64_t)(ULONG)(now - batch_ctx.last_time) * (SystemCoreClock / TX_TIMER_TICKS_PER_SECOND);
+    busy_delta = busy - batch_ctx.last_busy;
+    if (elapsed)
+        permille = (uint32_t)((busy_delta * 1000U) / elapsed);
+    if (permille > 1000U)
+        permille = 1000U;
+    batch_ctx.last_busy = busy;
+    batch_ctx.last_time = now;
+
+    len = App_Append(buf, size, 0, "wifiio,%lu,%lu,%lu,%lu,%lu\n",
+                     (unsigned long)io[0], (unsigned long)io[1], (unsigned long)io[2],
+                     (unsigned long)io[3], (unsigned long)io[4]);
+    len = App_Append(buf, size, len, "ipbatch,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+                     (unsigned long)batches[0], (unsigned long)batches[1], (unsigned long)batches[2],
+                     (unsigned long)batches[3], (unsigned long)batches[4], (unsigned long)batches[5],
+                     (unsigned long)batch_max, (unsigned long)batch_cut);
+    len = App_Append(buf, size, len, "ipbusy,%lu,%lu\n",
+                     (unsigned long)(busy / (SystemCoreClock / 1000U)), (unsigned long)permille);
+
+    return len;
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
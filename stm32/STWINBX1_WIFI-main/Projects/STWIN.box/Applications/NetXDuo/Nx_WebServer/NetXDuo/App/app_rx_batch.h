@@ -0,0 +1,70 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    app_rx_batch.h
+  * @author  Wind Turbine Team
+  * @brief   Wi-Fi receive path report: I/O thread and IP thread batches
+  ******************************************************************************
+  * Received frames take two hops. The Wi-Fi I/O thread of the emw3080 driver
+  * wakes on the module's notify/flow interrupt, polls the SPI link and
+  * queues the frames on the IP instance's deferred receive queue; it serves
+  * the notifications raised meanwhile in the same wakeup, up to
+  * NX_DRIVER_EMW3080_IO_BATCH polls. The IP thread then takes the queue in
+  * batches of at most NX_IP_RECEIVE_BATCH_MAX packets or
+  * NX_IP_RECEIVE_BATCH_CYCLES cycles, whichever ends first, and serves its
+  * timers and TCP events between batches (nx_user.h).
+  *
+  * This module only reads the counters both keep. The IP thread busy share
+  * is the cycles it spent processing events since the previous report, over
+  * the cycles elapsed; preemption by higher priorities is included.
+  */
+/* USER CODE END Header */
+
+#ifndef __APP_RX_BATCH_H
+#define __APP_RX_BATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+#include "nx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define RX_BATCH_REPORT_SIZE            256     /* Report text, taken from the slab allocator */
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Select the IP instance reported and account the I/O thread stack
+ * @param ip_instance: IP instance of the Wi-Fi interface
+ * @retval None
+ */
+void RxBatch_Init(NX_IP *ip_instance);
+
+/**
+ * @brief Format the receive path counters as CSV
+ * @param buf: output buffer
+ * @param size: buffer size
+ * @retval Number of characters written (excluding terminator)
+ *
+ * Line format:
+ *   wifiio,<wakeups>,<polls>,<polls_max>,<frames>,<drops>
+ *   ipbatch,<1>,<2-3>,<4-7>,<8-15>,<16-31>,<32+>,<max>,<cut>
+ *   ipbusy,<busy_ms>,<busy_permille>
+ * ipbatch counts batches by size in packets; cut is batches ended with
+ * packets still queued. ipbatch and ipbusy are 0 without
+ * NX_ENABLE_IP_THREAD_INFO, ipbusy also without NX_IP_CYCLE_COUNT_GET.
+ * busy_permille covers the time since the previous report.
+ */
+uint32_t RxBatch_Format(char *buf, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_RX_BATCH_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,488 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    app_tcp_tune.c
+  * @author  Wind Turbine Team
+  * @brief   TCP receive window sizing and per-connection statistics
+  ******************************************************************************
+  * The timer wheel callback runs in the timer thread and cannot take the IP
+  * mutex, so it only releases a semaphore; the tuner thread does the work.
+  *
+  * The receive rate is the advance of rx_sequence over one period
+  * (NX_DISABLE_TCP_INFO leaves the byte counters at zero). A larger window
+  * is applied by raising both the default and the current window, so the
+  * next ACK opens it. A smaller one only lowers the default: NetX never
+  * takes back window it has advertised, and the current window comes down
+  * to the new default as the application reads. The window a socket was
+  * created with is its ceiling, and it is put back once the connection is
+  * over so the next one (a listening HTTP socket is reused) starts there.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_tcp_tune.h"
+#include "app_util.h"
+#include "mem_budget.h"
+#include "rt_sched.h"
+#include "slab_alloc.h"
+#include "timer_wheel.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+_Static_assert(TCP_TUNE_REPORT_SIZE <= SLAB_MAX_BLOCK_SIZE, "report does not fit the largest slab class");
+_Static_assert(TCP_TUNE_PRIORITY > RT_SCHED_PRIORITY_LOWEST, "tuner thread must stay below the pipeline threads");
+
+#define TCP_TUNE_PERIOD_TICKS   ((TCP_TUNE_PERIOD_MS * TX_TIMER_TICKS_PER_SECOND) / 1000U)
+#define TCP_TUNE_TICKS_TO_MS(t) ((ULONG)(((uint64_t)(t) * 1000U) / TX_TIMER_TICKS_PER_SECOND))
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    NX_TCP_SOCKET         *socket;             /* NX_NULL while free */
+    ULONG                  ceiling;            /* Window the socket was created with */
+    ULONG                  last_rx_sequence;
+    UINT                   established;        /* last_rx_sequence is valid */
+    UINT                   seen;               /* Found in this run */
+} TcpTune_Entry_t;
+
+typedef struct
+{
+    NX_IP                 *ip;
+    NX_PACKET_POOL        *rx_pool;
+    TcpTune_Entry_t        entries[TCP_TUNE_SOCKETS];
+    TimerWheel_Timer_t     timer;
+    TX_SEMAPHORE           tick;
+    TX_THREAD              thread;
+    UCHAR                 *stack;
+    TcpTune_Stats_t        stats;
+    UINT                   is_ready;
+} TcpTune_Context_t;
+
+/* One socket, copied under the IP mutex for the report */
+typedef struct
+{
+    UINT                   local_port;
+    ULONG                  peer_ip;
+    UINT                   peer_port;
+    UINT                   state;
+    ULONG                  srtt;
+    ULONG                  rttvar;
+    ULONG                  rto;
+    ULONG                  samples;
+    ULONG                  cwnd;
+    ULONG                  ssthresh;
+    ULONG                  rx_window;
+    ULONG                  tx_window;
+    ULONG                  outstanding;
+    ULONG                  timeouts;
+    ULONG                  fast;
+    ULONG                  partial;
+} TcpTune_Snapshot_t;
+
+/* Private variables ---------------------------------------------------------*/
+static TcpTune_Context_t tune_ctx;
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID TcpTune_ThreadEntry(ULONG input);
+static void TcpTune_Timer(ULONG input);
+static void TcpTune_Run(void);
+static TcpTune_Entry_t *TcpTune_Lookup(NX_TCP_SOCKET *socket_ptr);
+static void TcpTune_SetWindow(TcpTune_Entry_t *e, ULONG window);
+static ULONG TcpTune_Target(TcpTune_Entry_t *e, ULONG pool_share, UINT *pool_limited);
+
+/**
+  * @brief  Create the tuner thread and start its period
+  * @param  byte_pool: ThreadX byte pool
+  * @param  ip_instance: IP instance
+  * @param  rx_pool: pool received segments are held in
+  * @retval TX_SUCCESS or error code
+  */
+UINT TcpTune_Init(TX_BYTE_POOL *byte_pool, NX_IP *ip_instance, NX_PACKET_POOL *rx_pool)
+{
+    UINT status;
+
+    if (!byte_pool || !ip_instance || !rx_pool)
+        return TX_PTR_ERROR;
+
+    memset(&tune_ctx, 0, sizeof(tune_ctx));
+    tune_ctx.ip = ip_instance;
+    tune_ctx.rx_pool = rx_pool;
+
+    status = tx_semaphore_create(&tune_ctx.tick, "TCP Tune Tick", 0);
+    if (status != TX_SUCCESS)
+        return status;
+
+    status = MemBudget_Allocate(byte_pool, (VOID **)&tune_ctx.stack, TCP_TUNE_STACK_SIZE,
+                                "tcp tune", "tuner thread stack");
+    if (status != TX_SUCCESS)
+        return status;
+
+    status = tx_thread_create(&tune_ctx.thread,
+                              "TCP Tune",
+                              TcpTune_ThreadEntry,
+                              0,
+                              tune_ctx.stack,
+                              TCP_TUNE_STACK_SIZE,
+                              TCP_TUNE_PRIORITY,
+                              TCP_TUNE_PRIORITY,
+                              TX_NO_TIME_SLICE,
+                              TX_AUTO_START);
+    if (status != TX_SUCCESS)
+        return status;
+
+    TimerWheel_Create(&tune_ctx.timer, "TCP Tune", TcpTune_Timer, 0);
+    status = TimerWheel_Start(&tune_ctx.timer,
+                              TCP_TUNE_PERIOD_TICKS,
+                              TCP_TUNE_PERIOD_TICKS,
+                              TIMER_WHEEL_SLACK(TCP_TUNE_PERIOD_TICKS));
+    if (status != TX_SUCCESS)
+        return status;
+
+    tune_ctx.is_ready = 1;
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Tuner counters
+  * @param  stats: output
+  * @retval None
+  */
+void TcpTune_GetStats(TcpTune_Stats_t *stats)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if (!stats)
+        return;
+
+    TX_DISABLE
+    *stats = tune_ctx.stats;
+    TX_RESTORE
+}
+
+/**
+  * @brief  Format the tuner counters and the TCP sockets as CSV
+  * @param  buf: output buffer
+  * @param  size: buffer size
+  * @retval Number of characters written (excluding terminator)
+  */
+uint32_t TcpTune_Format(char *buf, uint32_t size)
+{
+    TcpTune_Snapshot_t snap[TCP_TUNE_SOCKETS];
+    TcpTune_Stats_t stats;
+    NX_TCP_SOCKET *socket_ptr;
+    ULONG rx_free;
+    uint32_t count = 0;
+    uint32_t len;
+
+    if (!buf || size == 0U)
+        return 0;
+
+    buf[0] = '\0';
+
+    if (!tune_ctx.is_ready)
+        return 0;
+
+    tx_mutex_get(&tune_ctx.ip->nx_ip_protection, TX_WAIT_FOREVER);
+
+    socket_ptr = tune_ctx.ip->nx_ip_tcp_created_sockets_ptr;
+    for (ULONG i = 0; i < tune_ctx.ip->nx_ip_tcp_created_sockets_count && count < TCP_TUNE_SOCKETS; i++)
+    {
+        TcpTune_Snapshot_t *s = &snap[count++];
+
+        memset(s, 0, sizeof(*s));
+        s->local_port = socket_ptr->nx_tcp_socket_port;
+        s->peer_ip = socket_ptr->nx_tcp_socket_connect_ip.nxd_ip_address.v4;
+        s->peer_port = socket_ptr->nx_tcp_socket_connect_port;
+        s->state = socket_ptr->nx_tcp_socket_state;
+        s->rto = TCP_TUNE_TICKS_TO_MS(socket_ptr->nx_tcp_socket_timeout_rate);
+        s->cwnd = socket_ptr->nx_tcp_socket_tx_window_congestion;
+        s->ssthresh = socket_ptr->nx_tcp_socket_tx_slow_start_threshold;
+        s->rx_window = socket_ptr->nx_tcp_socket_rx_window_default;
+        s->tx_window = socket_ptr->nx_tcp_socket_tx_window_advertised;
+        s->outstanding = socket_ptr->nx_tcp_socket_tx_outstanding_bytes;
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+        s->srtt = TCP_TUNE_TICKS_TO_MS(socket_ptr->nx_tcp_socket_rtt_srtt >> 3);
+        s->rttvar = TCP_TUNE_TICKS_TO_MS(socket_ptr->nx_tcp_socket_rtt_rttvar >> 2);
+        s->samples = socket_ptr->nx_tcp_socket_rtt_samples;
+        s->timeouts = socket_ptr->nx_tcp_socket_retransmit_timeouts;
+        s->fast = socket_ptr->nx_tcp_socket_retransmit_fast;
+        s->partial = socket_ptr->nx_tcp_socket_retransmit_partial;
+#endif /* NX_TCP_ENABLE_RTT_ESTIMATION */
+
+        socket_ptr = socket_ptr->nx_tcp_socket_created_next;
+    }
+
+    rx_free = tune_ctx.rx_pool->nx_packet_pool_available;
+
+    tx_mutex_put(&tune_ctx.ip->nx_ip_protection);
+
+    TcpTune_GetStats(&stats);
+
+    len = App_Append(buf, size, 0, "tcptune,%lu,%lu,%lu,%lu,%lu,%lu\n",
+                     (unsigned long)stats.sockets, (unsigned long)stats.runs,
+                     (unsigned long)stats.grown, (unsigned long)stats.shrunk,
+                     (unsigned long)stats.pool_limited, (unsigned long)rx_free);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        TcpTune_Snapshot_t *s = &snap[i];
+
+        len = App_Append(buf, size, len,
+                         "tcp,%u,%lu.%lu.%lu.%lu,%u,%u,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+                         s->local_port,
+                         (unsigned long)((s->peer_ip >> 24) & 0xFFU), (unsigned long)((s->peer_ip >> 16) & 0xFFU),
+                         (unsigned long)((s->peer_ip >> 8) & 0xFFU), (unsigned long)(s->peer_ip & 0xFFU),
+                         s->peer_port, s->state,
+                         (unsigned long)s->srtt, (unsigned long)s->rttvar, (unsigned long)s->rto,
+                         (unsigned long)s->samples, (unsigned long)s->cwnd, (unsigned long)s->ssthresh,
+                         (unsigned long)s->rx_window, (unsigned long)s->tx_window,
+                         (unsigned long)s->outstanding, (unsigned long)s->timeouts,
+                         (unsigned long)s->fast, (unsigned long)s->partial);
+    }
+
+    return len;
+}
+
+/**
+  * @brief  Tuner thread: one run per period
+  * @param  input: unused
+  * @retval None
+  */
+static VOID TcpTune_ThreadEntry(ULONG input)
+{
+    (void)input;
+
+    for (;;)
+    {
+        if (tx_semaphore_get(&tune_ctx.tick, TX_WAIT_FOREVER) == TX_SUCCESS)
+            TcpTune_Run();
+    }
+}
+
+/**
+  * @brief  Period callback (timer thread): wake the tuner thread
+  * @param  input: unused
+  * @retval None
+  */
+static void TcpTune_Timer(ULONG input)
+{
+    (void)input;
+
+    /* At most one run pending: a late tuner skips periods instead of queueing them */
+    if (tune_ctx.tick.tx_semaphore_count == 0U)
+        tx_semaphore_put(&tune_ctx.tick);
+}
+
+/**
+  * @brief  Size the receive window of every tracked socket
+  * @retval None
+  */
+static void TcpTune_Run(void)
+{
+    TX_INTERRUPT_SAVE_AREA
+    NX_TCP_SOCKET *socket_ptr;
+    TcpTune_Entry_t *e;
+    ULONG active = 0;
+    ULONG pool_share;
+    uint32_t tracked = 0;
+    uint32_t grown = 0;
+    uint32_t shrunk = 0;
+    uint32_t pool_limited = 0;
+
+    tx_mutex_get(&tune_ctx.ip->nx_ip_protection, TX_WAIT_FOREVER);
+
+    for (uint32_t i = 0; i < TCP_TUNE_SOCKETS; i++)
+        tune_ctx.entries[i].seen = 0;
+
+    /* Pick up new sockets, count the established ones */
+    socket_ptr = tune_ctx.ip->nx_ip_tcp_created_sockets_ptr;
+    for (ULONG i = 0; i < tune_ctx.ip->nx_ip_tcp_created_sockets_count; i++)
+    {
+        e = TcpTune_Lookup(socket_ptr);
+        if (e)
+        {
+            e->seen = 1;
+            if (socket_ptr->nx_tcp_socket_state == NX_TCP_ESTABLISHED)
+                active++;
+        }
+
+        socket_ptr = socket_ptr->nx_tcp_socket_created_next;
+    }
+
+    /* Half of the free rx packets, shared among the established connections */
+    pool_share = (active > 0U) ? tune_ctx.rx_pool->nx_packet_pool_available / 2U / active : 0U;
+
+    for (uint32_t i = 0; i < TCP_TUNE_SOCKETS; i++)
+    {
+        ULONG window;
+        ULONG target;
+        UINT limited;
+
+        e = &tune_ctx.entries[i];
+        if (!e->socket)
+            continue;
+
+        /* Deleted sockets leave the created list */
+        if (!e->seen)
+        {
+            e->socket = NX_NULL;
+            continue;
+        }
+
+        tracked++;
+        socket_ptr = e->socket;
+        window = socket_ptr->nx_tcp_socket_rx_window_default;
+
+        if (socket_ptr->nx_tcp_socket_state != NX_TCP_ESTABLISHED)
+        {
+            e->established = 0;
+
+            /* Closed or listening again: the next connection starts at the ceiling */
+            if (socket_ptr->nx_tcp_socket_state <= NX_TCP_LISTEN_STATE && window != e->ceiling)
+            {
+                socket_ptr->nx_tcp_socket_rx_window_default = e->ceiling;
+                socket_ptr->nx_tcp_socket_rx_window_current = e->ceiling;
+            }
+            continue;
+        }
+
+        if (!e->established)
+        {
+            /* First period of the connection: no rate yet */
+            e->established = 1;
+            e->last_rx_sequence = socket_ptr->nx_tcp_socket_rx_sequence;
+            continue;
+        }
+
+        target = TcpTune_Target(e, pool_share, &limited);
+        pool_limited += limited;
+
+        if (target > window)
+        {
+            TcpTune_SetWindow(e, target);
+            grown++;
+        }
+        else if (target < window)
+        {
+            /* Halve at most: one quiet period does not close the window */
+            if (target < window / 2U)
+                target = window / 2U;
+            if (target < window)
+            {
+                TcpTune_SetWindow(e, target);
+                shrunk++;
+            }
+        }
+    }
+
+    tx_mutex_put(&tune_ctx.ip->nx_ip_protection);
+
+    TX_DISABLE
+    tune_ctx.stats.sockets = tracked;
+    tune_ctx.stats.runs++;
+    tune_ctx.stats.grown += grown;
+    tune_ctx.stats.shrunk += shrunk;
+    tune_ctx.stats.pool_limited += pool_limited;
+    TX_RESTORE
+}
+
+/**
+  * @brief  Table entry of a socket, added on first sight (IP mutex held)
+  * @param  socket_ptr: created socket
+  * @retval Entry, or NULL when the table is full
+  */
+static TcpTune_Entry_t *TcpTune_Lookup(NX_TCP_SOCKET *socket_ptr)
+{
+    TcpTune_Entry_t *free_entry = NULL;
+
+    for (uint32_t i = 0; i < TCP_TUNE_SOCKETS; i++)
+    {
+        TcpTune_Entry_t *e = &tune_ctx.entries[i];
+
+        if (e->socket == socket_ptr)
+            return e;
+        if (!e->socket && !free_entry)
+            free_entry = e;
+    }
+
+    if (free_entry)
+    {
+        memset(free_entry, 0, sizeof(*free_entry));
+        free_entry->socket = socket_ptr;
+        free_entry->ceiling = socket_ptr->nx_tcp_socket_rx_window_default;
+    }
+
+    return free_entry;
+}
+
+/**
+  * @brief  Window for the last period's rate (IP mutex held)
+  * @param  e: established entry; its rx sequence is advanced
+  * @param  pool_share: free rx packets this connection may fill
+  * @param  pool_limited: set when the pool share capped the window
+  * @retval Window in bytes
+  */
+static ULONG TcpTune_Target(TcpTune_Entry_t *e, ULONG pool_share, UINT *pool_limited)
+{
+    NX_TCP_SOCKET *socket_ptr = e->socket;
+    ULONG mss = socket_ptr->nx_tcp_socket_connect_mss;
+    ULONG received = socket_ptr->nx_tcp_socket_rx_sequence - e->last_rx_sequence;
+    ULONG rtt = (TCP_TUNE_RTT_DEFAULT_MS * TX_TIMER_TICKS_PER_SECOND) / 1000U;
+    ULONG floor = TCP_TUNE_WINDOW_MIN_SEGMENTS * mss;
+    ULONG cap = e->ceiling;
+    uint64_t target;
+
+    *pool_limited = 0;
+    e->last_rx_sequence = socket_ptr->nx_tcp_socket_rx_sequence;
+
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+    if (socket_ptr->nx_tcp_socket_rtt_samples > 0U)
+        rtt = socket_ptr->nx_tcp_socket_rtt_srtt >> 3;
+#endif /* NX_TCP_ENABLE_RTT_ESTIMATION */
+
+    /* Twice the bandwidth-delay product: room to grow past the current rate */
+    target = ((uint64_t)received * rtt * 2U) / TCP_TUNE_PERIOD_TICKS;
+
+    if (cap > pool_share * mss)
+    {
+        cap = pool_share * mss;
+        if (target > cap)
+            *pool_limited = 1;
+    }
+    if (target > cap)
+        target = cap;
+    if (target < floor)
+        target = floor;
+    if (target > e->ceiling)
+        target = e->ceiling;
+
+    return (ULONG)target;
+}
+
+/**
+  * @brief  Apply a new receive window (IP mutex held)
+  * @param  e: entry
+  * @param  window: bytes
+  * @retval None
+  */
+static void TcpTune_SetWindow(TcpTune_Entry_t *e, ULONG window)
+{
+    NX_TCP_SOCKET *socket_ptr = e->socket;
+    ULONG old = socket_ptr->nx_tcp_socket_rx_window_default;
+
+    socket_ptr->nx_tcp_socket_rx_window_default = window;
+
+    /* Open the difference now; the next ACK advertises it. After a shrink the
+       current window can still be above the old default, and without window
+       scaling anything past 65535 would be advertised modulo 2^16. */
+    if (window > old)
+    {
+        socket_ptr->nx_tcp_socket_rx_window_current += window - old;
+        if (socket_ptr->nx_tcp_socket_rx_window_current > window)
+            socket_ptr->nx_tcp_socket_rx_window_current = window;
+    }
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
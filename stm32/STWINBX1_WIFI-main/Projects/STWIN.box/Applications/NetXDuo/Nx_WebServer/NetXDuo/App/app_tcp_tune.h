@@ -0,0 +1,94 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    app_tcp_tune.h
+  * @author  Wind Turbine Team
+  * @brief   TCP receive window sizing and per-connection statistics
+  ******************************************************************************
+  * The retransmission timeout itself is adapted inside NetX Duo TCP (RTT
+  * estimation, NX_TCP_ENABLE_RTT_ESTIMATION in nx_user.h). This module sizes
+  * the receive window of each connection every TCP_TUNE_PERIOD_MS: twice the
+  * receive rate times the smoothed RTT, at least TCP_TUNE_WINDOW_MIN_SEGMENTS
+  * segments and at most the window the socket was created with. Every
+  * segment in a window may hold an rx pool packet until the application
+  * reads it, so the windows of all connections together are also kept under
+  * half of the free rx pool packets. A window grows at once and shrinks by
+  * at most half per period.
+  *
+  * The tuner thread holds the IP mutex while it walks the sockets, as NetX
+  * does. It only watches sockets it can track in its table of
+  * TCP_TUNE_SOCKETS entries.
+  */
+/* USER CODE END Header */
+
+#ifndef __APP_TCP_TUNE_H
+#define __APP_TCP_TUNE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+#include "nx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define TCP_TUNE_PERIOD_MS              250
+#define TCP_TUNE_SOCKETS                4       /* Sockets watched, HTTP sessions and spares */
+#define TCP_TUNE_WINDOW_MIN_SEGMENTS    2
+#define TCP_TUNE_RTT_DEFAULT_MS         100     /* Until the connection has an RTT sample */
+#define TCP_TUNE_STACK_SIZE             1024
+#define TCP_TUNE_PRIORITY               12      /* Below the web server */
+#define TCP_TUNE_REPORT_SIZE            768     /* Report text, taken from the slab allocator */
+
+typedef struct
+{
+    uint32_t sockets;                  /* Sockets in the table */
+    uint32_t runs;
+    uint32_t grown;                    /* Window changes up */
+    uint32_t shrunk;                   /* Window changes down */
+    uint32_t pool_limited;             /* Windows capped by the rx pool */
+} TcpTune_Stats_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Start the tuner thread
+ * @param byte_pool: ThreadX byte pool for the stack
+ * @param ip_instance: IP instance whose TCP sockets are tuned
+ * @param rx_pool: pool received segments are held in
+ * @retval TX_SUCCESS or error code
+ */
+UINT TcpTune_Init(TX_BYTE_POOL *byte_pool, NX_IP *ip_instance, NX_PACKET_POOL *rx_pool);
+
+/**
+ * @brief Tuner counters
+ * @param stats: output
+ * @retval None
+ */
+void TcpTune_GetStats(TcpTune_Stats_t *stats);
+
+/**
+ * @brief Format the tuner counters and one line per TCP socket as CSV
+ * @param buf: output buffer
+ * @param size: buffer size
+ * @retval Number of characters written (excluding terminator)
+ *
+ * Line format:
+ *   tcptune,<sockets>,<runs>,<grown>,<shrunk>,<pool_limited>,<rx_pool_free>
+ *   tcp,<local_port>,<peer_ip>,<peer_port>,<state>,<srtt_ms>,<rttvar_ms>,
+ *       <rto_ms>,<samples>,<cwnd>,<ssthresh>,<rx_window>,<tx_window>,
+ *       <outstanding>,<timeouts>,<fast_retransmits>,<partial_retransmits>
+ * RTT columns and the retransmit counts are 0 without
+ * NX_TCP_ENABLE_RTT_ESTIMATION; rttvar is reported as RTTVAR, not 4 RTTVAR.
+ */
+uint32_t TcpTune_Format(char *buf, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_TCP_TUNE_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
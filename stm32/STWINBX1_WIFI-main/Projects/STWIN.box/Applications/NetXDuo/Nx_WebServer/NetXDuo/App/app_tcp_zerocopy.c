@@ -0,0 +1,433 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    app_tcp_zerocopy.c
+  * @author  Wind Turbine Team
+  * @brief   Zero-copy TCP send: lent buffers as external-payload packets
+  ******************************************************************************
+  * The descriptors are allocated once at init and stay allocated from the
+  * pool's point of view while they are free here, so the reclaim thread is
+  * the only allocator of the loan pool and every packet it gets is one the
+  * stack has released. A descriptor on loan has its data pointers moved into
+  * the lent buffer; they are put back to its own payload area on reclaim.
+  *
+  * The header packets come from a separate, ordinary pool. TCP allocates
+  * from the pool of the first packet when it has to copy a segment, and
+  * that must never be the loan pool.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_tcp_zerocopy.h"
+#include "app_packet_track.h"
+#include "app_util.h"
+#include "mem_budget.h"
+#include "rt_sched.h"
+#include "slab_alloc.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+_Static_assert(TCP_ZC_REPORT_SIZE <= SLAB_MAX_BLOCK_SIZE, "report does not fit the largest slab class");
+_Static_assert(TCP_ZC_RECLAIM_PRIORITY > RT_SCHED_PRIORITY_LOWEST, "reclaim thread must stay below the pipeline threads");
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    NX_PACKET             *packet;
+    UCHAR                 *data_start;         /* Own payload area */
+    UCHAR                 *data_end;
+    TcpZeroCopy_Loan_t    *loan;               /* NX_NULL while free */
+} TcpZeroCopy_Descriptor_t;
+
+typedef struct
+{
+    NX_PACKET_POOL         header_pool;
+    NX_PACKET_POOL         loan_pool;
+    TcpZeroCopy_Descriptor_t descriptors[TCP_ZC_SEGMENTS];
+    uint32_t               descriptor_count;
+    TX_SEMAPHORE           free_descriptors;
+    TX_THREAD              reclaim_thread;
+    UCHAR                 *reclaim_stack;
+    TcpZeroCopy_Stats_t    stats;
+    UINT                   is_ready;
+} TcpZeroCopy_Context_t;
+
+/* Private variables ---------------------------------------------------------*/
+static TcpZeroCopy_Context_t zc_ctx;
+
+/* Counted by the Wi-Fi driver (nx_driver_emw3080.h) */
+extern ULONG nx_driver_emw3080_tx_gathers;
+
+/* Private function prototypes -----------------------------------------------*/
+static VOID TcpZeroCopy_ReclaimEntry(ULONG input);
+static void TcpZeroCopy_Reclaim(NX_PACKET *packet_ptr);
+static UINT TcpZeroCopy_SendSegment(NX_TCP_SOCKET *socket_ptr, TcpZeroCopy_Loan_t *loan,
+                                    const UCHAR *data, ULONG length, ULONG wait_option);
+static ULONG TcpZeroCopy_SegmentSize(const NX_TCP_SOCKET *socket_ptr, ULONG left);
+static void TcpZeroCopy_LoanPut(TcpZeroCopy_Loan_t *loan);
+
+/**
+  * @brief  Create the pools and the reclaim thread
+  * @param  byte_pool: ThreadX byte pool
+  * @retval TX_SUCCESS or error code
+  */
+UINT TcpZeroCopy_Init(TX_BYTE_POOL *byte_pool)
+{
+    VOID *memory;
+    NX_PACKET *packet_ptr;
+    UINT status;
+
+    if (!byte_pool)
+        return TX_PTR_ERROR;
+
+    memset(&zc_ctx, 0, sizeof(zc_ctx));
+
+    status = MemBudget_Allocate(byte_pool, &memory, TCP_ZC_HEADER_POOL_SIZE, "tcp zerocopy", "header pool");
+    if (status != TX_SUCCESS)
+        return status;
+
+    status = nx_packet_pool_create(&zc_ctx.header_pool, "TCP ZC Header Pool",
+                                   TCP_ZC_HEADER_PAYLOAD, memory, TCP_ZC_HEADER_POOL_SIZE);
+    if (status != NX_SUCCESS)
+        return status;
+
+    status = MemBudget_Allocate(byte_pool, &memory, TCP_ZC_LOAN_POOL_SIZE, "tcp zerocopy", "descriptor pool");
+    if (status != TX_SUCCESS)
+        return status;
+
+    status = nx_packet_pool_create(&zc_ctx.loan_pool, "TCP ZC Loan Pool",
+                                   TCP_ZC_LOAN_PAYLOAD, memory, TCP_ZC_LOAN_POOL_SIZE);
+    if (status != NX_SUCCESS)
+        return status;
+
+    /* The free descriptors are held here, not leaked */
+    (void)PacketTrack_ExcludePool(&zc_ctx.loan_pool);
+
+    /* Take every descriptor now: from here on only released ones reach the pool */
+    while (zc_ctx.descriptor_count < TCP_ZC_SEGMENTS &&
+           nx_packet_allocate(&zc_ctx.loan_pool, &packet_ptr, 0, NX_NO_WAIT) == NX_SUCCESS)
+    {
+        TcpZeroCopy_Descriptor_t *d = &zc_ctx.descriptors[zc_ctx.descriptor_count++];
+
+        d->packet = packet_ptr;
+        d->data_start = packet_ptr->nx_packet_data_start;
+        d->data_end = packet_ptr->nx_packet_data_end;
+    }
+
+    status = tx_semaphore_create(&zc_ctx.free_descriptors, "TCP ZC Descriptors", zc_ctx.descriptor_count);
+    if (status != TX_SUCCESS)
+        return status;
+
+    status = MemBudget_Allocate(byte_pool, (VOID **)&zc_ctx.reclaim_stack, TCP_ZC_RECLAIM_STACK_SIZE,
+                                "tcp zerocopy", "reclaim thread stack");
+    if (status != TX_SUCCESS)
+        return status;
+
+    status = tx_thread_create(&zc_ctx.reclaim_thread,
+                              "TCP ZC Reclaim",
+                              TcpZeroCopy_ReclaimEntry,
+                              0,
+                              zc_ctx.reclaim_stack,
+                              TCP_ZC_RECLAIM_STACK_SIZE,
+                              TCP_ZC_RECLAIM_PRIORITY,
+                              TCP_ZC_RECLAIM_PRIORITY,
+                              TX_NO_TIME_SLICE,
+                              TX_AUTO_START);
+    if (status != TX_SUCCESS)
+        return status;
+
+    zc_ctx.is_ready = 1;
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Queue a lent buffer on a connected socket
+  * @param  socket_ptr: connected TCP socket
+  * @param  loan: loan record
+  * @param  data: 4-byte aligned buffer
+  * @param  length: bytes
+  * @param  release: callback or NX_NULL
+  * @param  context: callback argument
+  * @param  wait_option: ticks per segment
+  * @retval NX_SUCCESS or error code
+  */
+UINT TcpZeroCopy_Send(NX_TCP_SOCKET *socket_ptr, TcpZeroCopy_Loan_t *loan,
+                      const VOID *data, ULONG length,
+                      TcpZeroCopy_Release_t release, VOID *context, ULONG wait_option)
+{
+    TX_INTERRUPT_SAVE_AREA
+    const UCHAR *next = (const UCHAR *)data;
+    ULONG left = length;
+    ULONG segment;
+    UINT status = NX_SUCCESS;
+
+    if (!socket_ptr || !loan || (!data && length))
+        return NX_PTR_ERROR;
+    if (!zc_ctx.is_ready)
+        return NX_NOT_ENABLED;
+
+    /* TCP copies a segment that does not start on a word */
+    if (((ALIGN_TYPE)data & 3U) != 0U)
+    {
+        TX_DISABLE
+        zc_ctx.stats.refused++;
+        TX_RESTORE
+        return NX_NOT_SUPPORTED;
+    }
+
+    /* The extra reference keeps release from running before the last segment is queued */
+    loan->release = release;
+    loan->context = context;
+    loan->outstanding = 1;
+
+    TX_DISABLE
+    zc_ctx.stats.loans++;
+    TX_RESTORE
+
+    while (left > 0U)
+    {
+        segment = TcpZeroCopy_SegmentSize(socket_ptr, left);
+        status = TcpZeroCopy_SendSegment(socket_ptr, loan, next, segment, wait_option);
+        if (status != NX_SUCCESS)
+            break;
+
+        next += segment;
+        left -= segment;
+    }
+
+    TcpZeroCopy_LoanPut(loan);
+
+    return status;
+}
+
+/**
+  * @brief  Counters
+  * @param  stats: output
+  * @retval None
+  */
+void TcpZeroCopy_GetStats(TcpZeroCopy_Stats_t *stats)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if (!stats)
+        return;
+
+    TX_DISABLE
+    *stats = zc_ctx.stats;
+    TX_RESTORE
+}
+
+/**
+  * @brief  Format the counters as a CSV line
+  * @param  buf: output buffer
+  * @param  size: buffer size
+  * @retval Number of characters written
+  */
+uint32_t TcpZeroCopy_Format(char *buf, uint32_t size)
+{
+    TcpZeroCopy_Stats_t stats;
+
+    if (!buf || size == 0U)
+        return 0;
+
+    buf[0] = '\0';
+
+    TcpZeroCopy_GetStats(&stats);
+
+    return App_Append(buf, size, 0, "zerocopy,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+                      (unsigned long)stats.loans, (unsigned long)stats.segments,
+                      (unsigned long)stats.bytes, (unsigned long)stats.refused,
+                      (unsigned long)stats.waits, (unsigned long)stats.in_flight,
+                      (unsigned long)stats.in_flight_max,
+                      (unsigned long)nx_driver_emw3080_tx_gathers);
+}
+
+/**
+  * @brief  Reclaim thread: wait for released descriptors
+  * @param  input: unused
+  * @retval None
+  */
+static VOID TcpZeroCopy_ReclaimEntry(ULONG input)
+{
+    NX_PACKET *packet_ptr;
+
+    (void)input;
+
+    for (;;)
+    {
+        /* nx_packet_release() hands a returned descriptor to the waiting thread */
+        if (nx_packet_allocate(&zc_ctx.loan_pool, &packet_ptr, 0, NX_WAIT_FOREVER) == NX_SUCCESS)
+            TcpZeroCopy_Reclaim(packet_ptr);
+    }
+}
+
+/**
+  * @brief  Restore a released descriptor and complete its loan
+  * @param  packet_ptr: descriptor from the loan pool
+  * @retval None
+  */
+static void TcpZeroCopy_Reclaim(NX_PACKET *packet_ptr)
+{
+    TX_INTERRUPT_SAVE_AREA
+    TcpZeroCopy_Descriptor_t *d = NX_NULL;
+    TcpZeroCopy_Loan_t *loan;
+
+    for (uint32_t i = 0; i < zc_ctx.descriptor_count; i++)
+    {
+        if (zc_ctx.descriptors[i].packet == packet_ptr)
+        {
+            d = &zc_ctx.descriptors[i];
+            break;
+        }
+    }
+
+    /* Only descriptors are ever allocated from this pool */
+    if (!d)
+        return;
+
+    packet_ptr->nx_packet_data_start = d->data_start;
+    packet_ptr->nx_packet_data_end = d->data_end;
+    packet_ptr->nx_packet_prepend_ptr = d->data_start;
+    packet_ptr->nx_packet_append_ptr = d->data_start;
+
+    TX_DISABLE
+    loan = d->loan;
+    d->loan = NX_NULL;
+    zc_ctx.stats.in_flight--;
+    TX_RESTORE
+
+    tx_semaphore_put(&zc_ctx.free_descriptors);
+
+    if (loan)
+        TcpZeroCopy_LoanPut(loan);
+}
+
+/**
+  * @brief  Chain one segment of the lent buffer behind a header packet and send it
+  * @param  socket_ptr: connected socket
+  * @param  loan: loan the segment belongs to
+  * @param  data: segment start, word aligned
+  * @param  length: segment bytes
+  * @param  wait_option: ticks
+  * @retval NX_SUCCESS or error code
+  */
+static UINT TcpZeroCopy_SendSegment(NX_TCP_SOCKET *socket_ptr, TcpZeroCopy_Loan_t *loan,
+                                    const UCHAR *data, ULONG length, ULONG wait_option)
+{
+    TX_INTERRUPT_SAVE_AREA
+    TcpZeroCopy_Descriptor_t *d = NX_NULL;
+    NX_PACKET *head;
+    NX_PACKET *body;
+    UINT status;
+
+    status = nx_packet_allocate(&zc_ctx.header_pool, &head, NX_TCP_PACKET, wait_option);
+    if (status != NX_SUCCESS)
+        return status;
+
+    if (tx_semaphore_get(&zc_ctx.free_descriptors, TX_NO_WAIT) != TX_SUCCESS)
+    {
+        TX_DISABLE
+        zc_ctx.stats.waits++;
+        TX_RESTORE
+
+        if (tx_semaphore_get(&zc_ctx.free_descriptors, wait_option) != TX_SUCCESS)
+        {
+            nx_packet_release(head);
+            return NX_NO_PACKET;
+        }
+    }
+
+    TX_DISABLE
+    for (uint32_t i = 0; i < zc_ctx.descriptor_count; i++)
+    {
+        if (!zc_ctx.descriptors[i].loan)
+        {
+            d = &zc_ctx.descriptors[i];
+            break;
+        }
+    }
+    /* The semaphore counts the free entries, so d is set */
+    d->loan = loan;
+    loan->outstanding++;
+    if (++zc_ctx.stats.in_flight > zc_ctx.stats.in_flight_max)
+        zc_ctx.stats.in_flight_max = zc_ctx.stats.in_flight;
+    TX_RESTORE
+
+    body = d->packet;
+    body->nx_packet_data_start = (UCHAR *)data;
+    body->nx_packet_data_end = (UCHAR *)data + length;
+    body->nx_packet_prepend_ptr = body->nx_packet_data_start;
+    body->nx_packet_append_ptr = body->nx_packet_data_end;
+    body->nx_packet_next = NX_NULL;
+
+    head->nx_packet_next = body;
+    head->nx_packet_last = body;
+    head->nx_packet_length = length;
+
+    status = nx_tcp_socket_send(socket_ptr, head, wait_option);
+    if (status != NX_SUCCESS)
+    {
+        /* Both go back to their pools; the descriptor through the reclaim thread */
+        nx_packet_release(head);
+        return status;
+    }
+
+    TX_DISABLE
+    zc_ctx.stats.segments++;
+    zc_ctx.stats.bytes += length;
+    TX_RESTORE
+
+    return NX_SUCCESS;
+}
+
+/**
+  * @brief  Next segment size: MSS and usable window, in whole words
+  * @param  socket_ptr: connected socket
+  * @param  left: bytes left in the buffer
+  * @retval Segment bytes
+  */
+static ULONG TcpZeroCopy_SegmentSize(const NX_TCP_SOCKET *socket_ptr, ULONG left)
+{
+    ULONG segment = socket_ptr->nx_tcp_socket_connect_mss;
+    ULONG window = socket_ptr->nx_tcp_socket_tx_window_advertised;
+
+    /* Read without the IP mutex: a stale value only costs the copy this avoids */
+    if (window > socket_ptr->nx_tcp_socket_tx_window_congestion)
+        window = socket_ptr->nx_tcp_socket_tx_window_congestion;
+    window = (window > socket_ptr->nx_tcp_socket_tx_outstanding_bytes)
+             ? window - socket_ptr->nx_tcp_socket_tx_outstanding_bytes : 0U;
+
+    /* With the window closed NetX waits for it; a partly open one would be split */
+    if (window >= 4U && window < segment)
+        segment = window;
+
+    segment &= ~3UL;
+    if (segment == 0U)
+        segment = 4U;
+    if (segment > left)
+        segment = left;
+
+    return segment;
+}
+
+/**
+  * @brief  Drop one reference; the last one runs the release callback
+  * @param  loan: loan record
+  * @retval None
+  */
+static void TcpZeroCopy_LoanPut(TcpZeroCopy_Loan_t *loan)
+{
+    TX_INTERRUPT_SAVE_AREA
+    ULONG outstanding;
+
+    TX_DISABLE
+    outstanding = --loan->outstanding;
+    TX_RESTORE
+
+    if (outstanding == 0U && loan->release)
+        loan->release(loan->context);
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,135 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    app_tcp_zerocopy.h
+  * @author  Wind Turbine Team
+  * @brief   Zero-copy TCP send: lent buffers as external-payload packets
+  ******************************************************************************
+  * nx_tcp_socket_send() wants the data in NX_PACKETs, so the web server
+  * copies every response byte into WebServerPool packets first, and those
+  * four packets are all the data it can have in flight. Here the caller
+  * lends a buffer instead (the history snapshot, a flash or OSPI region, a
+  * FileX sector buffer). Each segment is a small header packet from
+  * TCP_ZC_SEGMENTS header packets, chained to a descriptor packet whose data
+  * pointers point into the lent buffer. TCP queues the chain as it is, keeps
+  * it for retransmission and releases it when the peer has acknowledged it
+  * (or when the connection is torn down).
+  *
+  * NetX Duo has no release hook, so the descriptors live in a pool of their
+  * own that only the reclaim thread allocates from. The thread waits on that
+  * pool; nx_packet_release() hands each returned descriptor straight to it.
+  * Once every segment of a loan is back the release callback runs, on the
+  * reclaim thread, and the buffer belongs to the caller again.
+  *
+  * A segment is at most the MSS and the usable send window, rounded down to
+  * 4 bytes, so TCP neither splits nor re-aligns it (both copy). If the
+  * window shrinks between the check and the send, NetX still copies that one
+  * segment, into header pool packets. The Wi-Fi driver takes one contiguous
+  * frame, so it gathers chained frames (nx_driver_emw3080.c); the copy into
+  * the HTTP pool is gone, and what is in flight is bounded by the window
+  * and TCP_ZC_SEGMENTS instead of the HTTP pool.
+  */
+/* USER CODE END Header */
+
+#ifndef __APP_TCP_ZEROCOPY_H
+#define __APP_TCP_ZEROCOPY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+#include "nx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define TCP_ZC_SEGMENTS                 16      /* Segments in flight, all loans together */
+#define TCP_ZC_HEADER_PAYLOAD           NX_TCP_PACKET
+#define TCP_ZC_HEADER_POOL_SIZE         ((TCP_ZC_HEADER_PAYLOAD + sizeof(NX_PACKET)) * TCP_ZC_SEGMENTS + NX_PACKET_ALIGNMENT)
+#define TCP_ZC_LOAN_PAYLOAD             NX_PACKET_ALIGNMENT     /* Unused, the data pointers are set per segment */
+#define TCP_ZC_LOAN_POOL_SIZE           ((TCP_ZC_LOAN_PAYLOAD + sizeof(NX_PACKET)) * TCP_ZC_SEGMENTS + NX_PACKET_ALIGNMENT)
+#define TCP_ZC_RECLAIM_STACK_SIZE       1024
+#define TCP_ZC_RECLAIM_PRIORITY         10      /* Above the web server, below the pipeline */
+#define TCP_ZC_REPORT_SIZE              256     /* Report text, taken from the slab allocator */
+
+/**
+ * @brief Called once every segment of a loan has been released
+ */
+typedef VOID (*TcpZeroCopy_Release_t)(VOID *context);
+
+/**
+ * @brief One lent buffer; owned by the caller, valid until the release callback
+ */
+typedef struct
+{
+    TcpZeroCopy_Release_t  release;
+    VOID                  *context;
+    ULONG                  outstanding;        /* Segments not released, plus one while sending */
+} TcpZeroCopy_Loan_t;
+
+typedef struct
+{
+    uint32_t loans;                    /* Buffers lent */
+    uint32_t segments;                 /* Segments queued on the lent data */
+    uint32_t bytes;
+    uint32_t refused;                  /* Unaligned buffers left to the copy path */
+    uint32_t waits;                    /* Segments that waited for a free descriptor */
+    uint32_t in_flight;                /* Descriptors lent now */
+    uint32_t in_flight_max;
+} TcpZeroCopy_Stats_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Create the header and descriptor pools and the reclaim thread
+ * @param byte_pool: ThreadX byte pool
+ * @retval TX_SUCCESS or error code (TcpZeroCopy_Send() then returns NX_NOT_ENABLED)
+ */
+UINT TcpZeroCopy_Init(TX_BYTE_POOL *byte_pool);
+
+/**
+ * @brief Queue a lent buffer on a connected socket
+ * @param socket_ptr: connected TCP socket, one sending thread
+ * @param loan: loan record, owned by the caller until release runs
+ * @param data: buffer, 4-byte aligned; not written until release runs
+ * @param length: bytes
+ * @param release: callback, may be NX_NULL
+ * @param context: callback argument
+ * @param wait_option: ticks to wait for window and descriptors, per segment
+ * @retval NX_SUCCESS, or the first nx_tcp_socket_send() error. Either way
+ *         release runs once, after the segments queued so far are released,
+ *         possibly before this returns. NX_NOT_SUPPORTED (unaligned buffer),
+ *         NX_NOT_ENABLED and NX_PTR_ERROR are returned before anything is
+ *         sent and without calling release.
+ */
+UINT TcpZeroCopy_Send(NX_TCP_SOCKET *socket_ptr, TcpZeroCopy_Loan_t *loan,
+                      const VOID *data, ULONG length,
+                      TcpZeroCopy_Release_t release, VOID *context, ULONG wait_option);
+
+/**
+ * @brief Counters
+ * @param stats: output
+ * @retval None
+ */
+void TcpZeroCopy_GetStats(TcpZeroCopy_Stats_t *stats);
+
+/**
+ * @brief Format the counters as a CSV line
+ * @param buf: output buffer
+ * @param size: buffer size
+ * @retval Number of characters written (excluding terminator)
+ *
+ * Line format:
+ *   zerocopy,<loans>,<segments>,<bytes>,<refused>,<waits>,<in_flight>,<in_flight_max>,<gathers>
+ * gathers counts chained frames the Wi-Fi driver linearized.
+ */
+uint32_t TcpZeroCopy_Format(char *buf, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_TCP_ZEROCOPY_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -12,6 +12,15 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "app_telemetry.h"
+#include "app_util.h"
+#include "feature_history.h"
+#include "staging_log.h"
+#include "mem_budget.h"
+#include "slab_alloc.h"
+#include "low_power.h"
+#include "app_events.h"
+#include "app_packet_pools.h"
+#include "app_udp_flow.h"
 #include "main.h"
 #include <string.h>
 #include <stdio.h>
@@ -20,21 +29,57 @@
 
 /* Private types -------------------------------------------------------------*/
 
+typedef struct
+{
+    ULONG                  group;                      /* 0: slot unused */
+    UINT                   ttl;
+    uint32_t               packets;
+    uint32_t               bytes;
+    uint32_t               errors;
+} Telemetry_GroupStats_t;
+
 typedef struct
 {
     TX_THREAD              thread;                     /* Thread control block */
-    TX_QUEUE              *input_queue;                /* From feature extraction */
+    SpscRing_t            *input_ring;                 /* From feature extraction */
     NX_IP                 *ip_instance;                /* NetX IP instance */
     NX_UDP_SOCKET          udp_socket;                 /* UDP socket */
+    UdpFlow_t              flow;                       /* Cached route and headers to the receiver */
     UINT                   is_ready;                   /* Socket ready flag */
     UINT                   is_running;                 /* Thread active flag */
     
-    ULONG                  receiver_ip;                /* Destination IP */
+    ULONG                  receiver_ip;                /* Destination IP (unicast) */
     UINT                   receiver_port;              /* Destination port */
-    uint8_t                use_broadcast;              /* Broadcast vs unicast */
+    uint8_t                mode;                       /* Telemetry_Mode_t */
+    ULONG                  group_ip;                   /* Multicast group */
+    UINT                   group_ttl;                  /* Multicast hop limit */
+    
+    /* Written by the setters, applied by the thread on APP_EVENT_CONFIG */
+    ULONG                  pending_ip;
+    UINT                   pending_port;
+    uint8_t                pending_mode;
+    ULONG                  pending_group;
+    UINT                   pending_ttl;
+    
+    /* Per-group counters; group_current indexes the group being sent to */
+    Telemetry_GroupStats_t groups[TELEMETRY_MCAST_MAX_GROUPS];
+    uint32_t               group_current;
+    uint32_t               group_next;                 /* Slot replaced when all are used */
+    
+    AppEvents_Worker_t     events;                     /* Input data ready, link, config, shutdown */
     
     uint32_t               tx_count;                   /* Packets sent */
     uint32_t               error_count;                /* Transmission errors */
+    uint32_t               alloc_fail_count;           /* Datagrams dropped, no packet in time */
+    
+    /* Compressed history (encoded in this thread, read by the web server) */
+    FeatureHistory_Encoder_t history_enc;
+    TX_MUTEX               history_mutex;
+    uint32_t               history_len;                /* Bytes used in history_buf */
+    uint32_t               history_blocks;             /* Blocks in history_buf */
+    uint32_t               history_raw_bytes;          /* Raw bytes encoded since boot */
+    uint32_t               history_encoded_bytes;      /* Encoded bytes since boot */
+    uint32_t               history_decimate_count;     /* Packets seen while SD log is behind */
     
     /* Thread resources */
     uint8_t               *thread_stack;
@@ -47,10 +92,25 @@ static Telemetry_Context_t telemetry_ctx = {0};
 static AudioTelemetryPacket_t telemetry_last_pkt;
 static volatile uint8_t telemetry_last_pkt_valid = 0;
 
+/* Encoded history blocks, oldest first */
+static uint8_t telemetry_history_buf[TELEMETRY_HISTORY_SIZE];
+
+/* Blocks are encoded into a slab buffer */
+_Static_assert(FEATURE_HISTORY_BLOCK_MAX_SIZE <= SLAB_MAX_BLOCK_SIZE, "history block does not fit the largest slab class");
+_Static_assert(TELEMETRY_MCAST_REPORT_SIZE <= SLAB_MAX_BLOCK_SIZE, "report does not fit the largest slab class");
+
 /* Private function prototypes -----------------------------------------------*/
 static void Telemetry_ThreadEntry(ULONG thread_input);
 static UINT Telemetry_CreateSocket(void);
 static UINT Telemetry_TransmitPacket(const AudioTelemetryPacket_t *pkt);
+static void Telemetry_HistoryAppend(const AudioTelemetryPacket_t *pkt);
+static void Telemetry_ApplyConfig(void);
+static void Telemetry_OpenFlow(void);
+static ULONG Telemetry_Destination(void);
+static void Telemetry_SelectGroup(void);
+static void Telemetry_CountGroup(UINT status);
+
+static const char *const telemetry_mode_names[] = { "unicast", "broadcast", "multicast" };
 
 /**
   * @brief  Initialize telemetry transmission subsystem
@@ -70,13 +130,31 @@ UINT Telemetry_Init(TX_BYTE_POOL *byte_pool, NX_IP *ip_instance)
     telemetry_ctx.ip_instance = ip_instance;
     telemetry_ctx.receiver_ip = TELEMETRY_DEFAULT_IP_ADDR;
     telemetry_ctx.receiver_port = TELEMETRY_UDP_PORT_RX;
-    telemetry_ctx.use_broadcast = 1;  /* Default to broadcast */
+    telemetry_ctx.mode = TELEMETRY_DEFAULT_MODE;
+    telemetry_ctx.group_ip = TELEMETRY_MCAST_GROUP(TELEMETRY_FARM_SECTION);
+    telemetry_ctx.group_ttl = TELEMETRY_MCAST_TTL;
+    telemetry_ctx.pending_ip = telemetry_ctx.receiver_ip;
+    telemetry_ctx.pending_port = telemetry_ctx.receiver_port;
+    telemetry_ctx.pending_mode = telemetry_ctx.mode;
+    telemetry_ctx.pending_group = telemetry_ctx.group_ip;
+    telemetry_ctx.pending_ttl = telemetry_ctx.group_ttl;
+    Telemetry_SelectGroup();
+    
+    FeatureHistory_EncoderReset(&telemetry_ctx.history_enc);
+    MemBudget_RegisterStatic("telemetry", "history ring", sizeof(telemetry_history_buf));
+    status = tx_mutex_create(&telemetry_ctx.history_mutex, "Telemetry History", TX_NO_INHERIT);
+    if (status != TX_SUCCESS)
+        return status;
     
     /* Allocate thread stack */
-    status = tx_byte_allocate(byte_pool,
-                              (VOID **)&telemetry_ctx.thread_stack,
-                              TELEMETRY_THREAD_STACK_SIZE,
-                              TX_NO_WAIT);
+    status = MemBudget_Allocate(byte_pool,
+                                (VOID **)&telemetry_ctx.thread_stack,
+                                TELEMETRY_THREAD_STACK_SIZE,
+                                "telemetry", "thread stack");
+    if (status != TX_SUCCESS)
+        return status;
+    
+    status = AppEvents_Register(&telemetry_ctx.events, "Telemetry Events");
     if (status != TX_SUCCESS)
         return status;
     
@@ -95,35 +173,48 @@ UINT Telemetry_Init(TX_BYTE_POOL *byte_pool, NX_IP *ip_instance)
     if (status != TX_SUCCESS)
         return status;
     
+    status = RtSched_Register(RT_SCHED_TASK_TELEMETRY, &telemetry_ctx.thread,
+                              TELEMETRY_PERIOD_MS, TELEMETRY_BUDGET_US);
+    if (status != TX_SUCCESS)
+        return status;
+    
     telemetry_ctx.is_ready = 0;
     telemetry_ctx.is_running = 0;
     telemetry_ctx.tx_count = 0;
     telemetry_ctx.error_count = 0;
+    telemetry_ctx.alloc_fail_count = 0;
     
     return TX_SUCCESS;
 }
 
 /**
   * @brief  Start telemetry transmission
-  * @param  input_queue: Feature extraction output queue
-  * @param  receiver_ip: Destination IP (network byte order)
+  * @param  input_ring: Feature extraction output ring
+  * @param  receiver_ip: Unicast destination IP (network byte order), 0 for the default
   * @retval TX_SUCCESS on success
   */
-UINT Telemetry_Start(TX_QUEUE *input_queue, ULONG receiver_ip)
+UINT Telemetry_Start(SpscRing_t *input_ring, ULONG receiver_ip)
 {
     UINT status;
     
-    if (!input_queue)
+    if (!input_ring)
         return TX_PTR_ERROR;
     
-    telemetry_ctx.input_queue = input_queue;
+    telemetry_ctx.input_ring = input_ring;
+    SpscRing_SetWakeup(input_ring, &telemetry_ctx.events.flags, APP_EVENT_DATA_READY);
     if (receiver_ip != 0)
-        telemetry_ctx.receiver_ip = receiver_ip;
+        telemetry_ctx.receiver_ip = telemetry_ctx.pending_ip = receiver_ip;
     
-    /* Create and bind UDP socket */
-    status = Telemetry_CreateSocket();
-    if (status != NX_SUCCESS)
-        return status;
+    /* Create and bind UDP socket (kept across a shutdown/restart) */
+    if (!telemetry_ctx.is_ready)
+    {
+        status = Telemetry_CreateSocket();
+        if (status != NX_SUCCESS)
+            return status;
+        if (telemetry_ctx.mode == TELEMETRY_MODE_MULTICAST)
+            telemetry_ctx.udp_socket.nx_udp_socket_time_to_live = telemetry_ctx.group_ttl;
+        Telemetry_OpenFlow();
+    }
     
     telemetry_ctx.is_ready = 1;
     telemetry_ctx.is_running = 1;
@@ -145,8 +236,10 @@ UINT Telemetry_SetReceiver(ULONG ip_addr, UINT port)
     if (ip_addr == 0)
         return TX_PTR_ERROR;
     
-    telemetry_ctx.receiver_ip = ip_addr;
-    telemetry_ctx.receiver_port = port;
+    /* Taken over by the telemetry thread between two packets */
+    telemetry_ctx.pending_ip = ip_addr;
+    telemetry_ctx.pending_port = port;
+    AppEvents_Post(&telemetry_ctx.events, APP_EVENT_CONFIG);
     
     return TX_SUCCESS;
 }
@@ -158,7 +251,30 @@ UINT Telemetry_SetReceiver(ULONG ip_addr, UINT port)
   */
 UINT Telemetry_SetBroadcast(uint8_t enable)
 {
-    telemetry_ctx.use_broadcast = enable;
+    telemetry_ctx.pending_mode = enable ? TELEMETRY_MODE_BROADCAST : TELEMETRY_MODE_UNICAST;
+    AppEvents_Post(&telemetry_ctx.events, APP_EVENT_CONFIG);
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Send to a multicast group
+  * @param  group: class D address (host byte order)
+  * @param  ttl: hop limit, 1 to 255
+  * @retval TX_SUCCESS, NX_IP_ADDRESS_ERROR or NX_OPTION_ERROR
+  */
+UINT Telemetry_SetMulticast(ULONG group, UINT ttl)
+{
+    if ((group & NX_IP_CLASS_D_MASK) != NX_IP_CLASS_D_TYPE)
+        return NX_IP_ADDRESS_ERROR;
+    if (ttl == 0 || ttl > 255U)
+        return NX_OPTION_ERROR;
+    
+    /* Taken over by the telemetry thread between two packets */
+    telemetry_ctx.pending_group = group;
+    telemetry_ctx.pending_ttl = ttl;
+    telemetry_ctx.pending_mode = TELEMETRY_MODE_MULTICAST;
+    AppEvents_Post(&telemetry_ctx.events, APP_EVENT_CONFIG);
+    
     return TX_SUCCESS;
 }
 
@@ -180,6 +296,15 @@ uint32_t Telemetry_GetErrorCount(void)
     return telemetry_ctx.error_count;
 }
 
+/**
+  * @brief  Get allocation failure count
+  * @retval Datagrams dropped for lack of a packet
+  */
+uint32_t Telemetry_GetAllocFailCount(void)
+{
+    return telemetry_ctx.alloc_fail_count;
+}
+
 /**
   * @brief  Copy out the latest telemetry packet (for HTTP dashboard).
   * @param  out: destination buffer
@@ -195,6 +320,121 @@ uint8_t Telemetry_GetLastPacket(AudioTelemetryPacket_t *out)
     return 1;
 }
 
+/**
+  * @brief  Copy the most recent compressed history blocks
+  * @param  dst: destination buffer
+  * @param  max_len: capacity of dst
+  * @retval Number of bytes copied (whole blocks only)
+  */
+uint32_t Telemetry_GetHistory(uint8_t *dst, uint32_t max_len)
+{
+    uint32_t offset = 0;
+    uint32_t len;
+    
+    if (!dst || tx_mutex_get(&telemetry_ctx.history_mutex, TX_WAIT_FOREVER) != TX_SUCCESS)
+        return 0;
+    
+    /* Skip oldest blocks until the rest fits */
+    while (telemetry_ctx.history_len - offset > max_len)
+    {
+        uint32_t size = FeatureHistory_BlockSize(&telemetry_history_buf[offset],
+                                                 telemetry_ctx.history_len - offset);
+        if (size == 0)
+        {
+            offset = telemetry_ctx.history_len;
+            break;
+        }
+        offset += size;
+    }
+    
+    len = telemetry_ctx.history_len - offset;
+    memcpy(dst, &telemetry_history_buf[offset], len);
+    
+    tx_mutex_put(&telemetry_ctx.history_mutex);
+    return len;
+}
+
+/**
+  * @brief  Get history encoder statistics
+  * @retval None
+  */
+void Telemetry_GetHistoryStats(uint32_t *blocks, uint32_t *bytes,
+                               uint32_t *raw_bytes, uint32_t *encoded_bytes)
+{
+    if (blocks)
+        *blocks = telemetry_ctx.history_blocks;
+    if (bytes)
+        *bytes = telemetry_ctx.history_len;
+    if (raw_bytes)
+        *raw_bytes = telemetry_ctx.history_raw_bytes;
+    if (encoded_bytes)
+        *encoded_bytes = telemetry_ctx.history_encoded_bytes;
+}
+
+/**
+  * @brief  Format the delivery mode and the per-group counters
+  * @param  buf: output buffer
+  * @param  size: buffer size
+  * @retval Number of characters written
+  */
+uint32_t Telemetry_FormatMulticast(char *buf, uint32_t size)
+{
+    TX_INTERRUPT_SAVE_AREA
+    Telemetry_GroupStats_t groups[TELEMETRY_MCAST_MAX_GROUPS];
+    uint32_t current;
+    uint32_t mode;
+    ULONG dest;
+    uint32_t len;
+    
+    if (!buf || size == 0U)
+        return 0;
+    
+    buf[0] = '\0';
+    
+    TX_DISABLE
+    memcpy(groups, telemetry_ctx.groups, sizeof(groups));
+    current = telemetry_ctx.group_current;
+    mode = telemetry_ctx.mode;
+    dest = Telemetry_Destination();
+    TX_RESTORE
+    
+    len = App_Append(buf, size, 0, "mode,%s,%lu.%lu.%lu.%lu,%u,%u\n",
+                     telemetry_mode_names[mode],
+                     (unsigned long)(dest >> 24), (unsigned long)((dest >> 16) & 0xFFU),
+                     (unsigned long)((dest >> 8) & 0xFFU), (unsigned long)(dest & 0xFFU),
+                     telemetry_ctx.receiver_port,
+                     telemetry_ctx.udp_socket.nx_udp_socket_time_to_live);
+    
+    for (uint32_t i = 0; i < TELEMETRY_MCAST_MAX_GROUPS; i++)
+    {
+        if (!groups[i].group)
+            continue;
+        len = App_Append(buf, size, len, "group,%lu.%lu.%lu.%lu,%u,%u,%lu,%lu,%lu\n",
+                         (unsigned long)(groups[i].group >> 24), (unsigned long)((groups[i].group >> 16) & 0xFFU),
+                         (unsigned long)((groups[i].group >> 8) & 0xFFU), (unsigned long)(groups[i].group & 0xFFU),
+                         groups[i].ttl,
+                         (mode == TELEMETRY_MODE_MULTICAST && i == current) ? 1U : 0U,
+                         (unsigned long)groups[i].packets, (unsigned long)groups[i].bytes,
+                         (unsigned long)groups[i].errors);
+    }
+    
+    return len;
+}
+
+/**
+  * @brief  Format the UDP flow counters (see UdpFlow_Format)
+  * @param  buf: output buffer
+  * @param  size: buffer size
+  * @retval Number of characters written
+  */
+uint32_t Telemetry_FormatFlow(char *buf, uint32_t size)
+{
+    if (!telemetry_ctx.is_ready)
+        return 0;
+
+    return UdpFlow_Format(&telemetry_ctx.flow, buf, size);
+}
+
 /**
   * @brief  Check if socket is ready
   * @retval 1 if ready, 0 if not
@@ -210,16 +450,16 @@ uint8_t Telemetry_IsReady(void)
   * @retval None
   * 
   * This thread:
-  * 1. Waits for AudioTelemetryPacket_t from feature extraction queue
-  * 2. Transmits via UDP socket
-  * 3. Handles retries and error conditions
+  * 1. Waits for AudioTelemetryPacket_t from the feature extraction ring
+  * 2. Transmits via UDP socket while the link is up
+  * 3. Applies destination changes and link events between packets
   */
 static void Telemetry_ThreadEntry(ULONG thread_input)
 {
     (void)thread_input;
-    AudioTelemetryPacket_t pkt;
+    AudioTelemetryPacket_t *pkt;
     UINT status;
-    /* Reserved for future event-driven refactor (currently unused). */
+    ULONG events;
     
     while (1)
     {
@@ -229,41 +469,47 @@ static void Telemetry_ThreadEntry(ULONG thread_input)
             continue;
         }
         
-        if (!telemetry_ctx.is_ready)
-        {
-            /* Socket not ready, wait for IP connectivity */
-            tx_thread_sleep(500);  /* 500ms wait */
-            continue;
-        }
-        
-        /* Wait for telemetry packet from feature extraction (blocking, 100ms timeout) */
-        status = tx_queue_receive(telemetry_ctx.input_queue,
-                                  (VOID *)&pkt,
-                                  100);  /* 100ms timeout */
-        
-        if (status == TX_QUEUE_EMPTY)
+        /* Take the next packet; sleep on the worker events only once the ring is drained */
+        pkt = SpscRing_Peek(telemetry_ctx.input_ring, TX_NO_WAIT);
+        if (!pkt)
         {
-            /* No packet available, continue waiting */
-            continue;
-        }
-        else if (status != TX_SUCCESS)
-        {
-            telemetry_ctx.error_count++;
+            events = AppEvents_Wait(&telemetry_ctx.events, TX_WAIT_FOREVER);
+            if (events & APP_EVENT_SHUTDOWN)
+                telemetry_ctx.is_running = 0;
+            if (events & APP_EVENT_CONFIG)
+                Telemetry_ApplyConfig();
+            if (events & APP_EVENT_LINK)
+            {
+                /* Address or access point may have changed with the link */
+                UdpFlow_Invalidate(&telemetry_ctx.flow);
+                printf("Telemetry: link %s\n", AppEvents_IsLinkUp() ? "up" : "down");
+            }
             continue;
         }
         
-        /* Transmit the packet */
-        status = Telemetry_TransmitPacket(&pkt);
+        /* Transmit the packet straight from the ring slot; without a link it
+           only goes to the dashboard and the history */
+        status = AppEvents_IsLinkUp() ? Telemetry_TransmitPacket(pkt) : NX_NOT_CONNECTED;
+        Telemetry_CountGroup(status);
 
     /* Update cached packet for the dashboard (even if TX fails). */
-    memcpy(&telemetry_last_pkt, &pkt, sizeof(telemetry_last_pkt));
+    memcpy(&telemetry_last_pkt, pkt, sizeof(telemetry_last_pkt));
     telemetry_last_pkt_valid = 1;
         
+        Telemetry_HistoryAppend(pkt);
+        SpscRing_Release(telemetry_ctx.input_ring);
+        RtSched_Complete(RT_SCHED_TASK_TELEMETRY);
+        
         if (status == NX_SUCCESS)
         {
             telemetry_ctx.tx_count++;
+            LowPower_NotePacket();
         }
-        else
+        else if (status == NX_NO_PACKET)
+        {
+            /* Counted in alloc_fail_count, no console line per dropped frame */
+        }
+        else if (status != NX_NOT_CONNECTED)
         {
             telemetry_ctx.error_count++;
             printf("Telemetry TX error: 0x%02X\n", status);
@@ -271,6 +517,125 @@ static void Telemetry_ThreadEntry(ULONG thread_input)
     }
 }
 
+/**
+  * @brief  Take over the destination set by Telemetry_SetReceiver/SetBroadcast
+  * @retval None
+  */
+static void Telemetry_ApplyConfig(void)
+{
+    telemetry_ctx.receiver_ip = telemetry_ctx.pending_ip;
+    telemetry_ctx.receiver_port = telemetry_ctx.pending_port;
+    telemetry_ctx.mode = telemetry_ctx.pending_mode;
+    telemetry_ctx.group_ip = telemetry_ctx.pending_group;
+    telemetry_ctx.group_ttl = telemetry_ctx.pending_ttl;
+    Telemetry_SelectGroup();
+    
+    if (telemetry_ctx.is_ready)
+    {
+        /* No NetX setter after creation; this thread is the only sender */
+        telemetry_ctx.udp_socket.nx_udp_socket_time_to_live =
+            (telemetry_ctx.mode == TELEMETRY_MODE_MULTICAST) ? telemetry_ctx.group_ttl : NX_IP_TIME_TO_LIVE;
+        Telemetry_OpenFlow();
+    }
+    
+    printf("Telemetry: destination %s 0x%08lX:%u\n", telemetry_mode_names[telemetry_ctx.mode],
+           Telemetry_Destination(), telemetry_ctx.receiver_port);
+}
+
+/**
+  * @brief  Destination address of the current mode
+  * @retval IP address (host byte order)
+  */
+static ULONG Telemetry_Destination(void)
+{
+    switch (telemetry_ctx.mode)
+    {
+    case TELEMETRY_MODE_BROADCAST:
+        return 0xFFFFFFFF;
+    case TELEMETRY_MODE_MULTICAST:
+        return telemetry_ctx.group_ip;
+    default:
+        return telemetry_ctx.receiver_ip;
+    }
+}
+
+/**
+  * @brief  Point group_current at the counters of the configured group
+  * @retval None
+  * 
+  * A group seen before keeps its counters; a new one takes a free slot or
+  * replaces the oldest.
+  */
+static void Telemetry_SelectGroup(void)
+{
+    TX_INTERRUPT_SAVE_AREA
+    uint32_t slot = TELEMETRY_MCAST_MAX_GROUPS;
+    
+    for (uint32_t i = 0; i < TELEMETRY_MCAST_MAX_GROUPS; i++)
+    {
+        if (telemetry_ctx.groups[i].group == telemetry_ctx.group_ip)
+        {
+            slot = i;
+            break;
+        }
+        if (slot == TELEMETRY_MCAST_MAX_GROUPS && !telemetry_ctx.groups[i].group)
+            slot = i;
+    }
+    
+    TX_DISABLE
+    if (slot == TELEMETRY_MCAST_MAX_GROUPS)
+    {
+        slot = telemetry_ctx.group_next;
+        telemetry_ctx.group_next = (slot + 1U) % TELEMETRY_MCAST_MAX_GROUPS;
+    }
+    if (telemetry_ctx.groups[slot].group != telemetry_ctx.group_ip)
+    {
+        memset(&telemetry_ctx.groups[slot], 0, sizeof(telemetry_ctx.groups[slot]));
+        telemetry_ctx.groups[slot].group = telemetry_ctx.group_ip;
+    }
+    telemetry_ctx.groups[slot].ttl = telemetry_ctx.group_ttl;
+    telemetry_ctx.group_current = slot;
+    TX_RESTORE
+}
+
+/**
+  * @brief  Count a datagram against the current group (multicast mode only)
+  * @param  status: Telemetry_TransmitPacket result
+  * @retval None
+  */
+static void Telemetry_CountGroup(UINT status)
+{
+    TX_INTERRUPT_SAVE_AREA
+    Telemetry_GroupStats_t *g;
+    
+    if (telemetry_ctx.mode != TELEMETRY_MODE_MULTICAST || status == NX_NOT_CONNECTED)
+        return;
+    
+    g = &telemetry_ctx.groups[telemetry_ctx.group_current];
+    
+    TX_DISABLE
+    if (status == NX_SUCCESS)
+    {
+        g->packets++;
+        g->bytes += sizeof(AudioTelemetryPacket_t);
+    }
+    else
+    {
+        g->errors++;
+    }
+    TX_RESTORE
+}
+
+/**
+  * @brief  Point the UDP flow at the current destination
+  * @retval None
+  */
+static void Telemetry_OpenFlow(void)
+{
+    UdpFlow_Open(&telemetry_ctx.flow, &telemetry_ctx.udp_socket,
+                 Telemetry_Destination(), telemetry_ctx.receiver_port);
+}
+
 /**
   * @brief  Create and bind UDP socket
   * @retval NX_SUCCESS on success, error code otherwise
@@ -321,8 +686,10 @@ static UINT Telemetry_CreateSocket(void)
   * 
   * Packet format:
   * - UDP payload: exactly sizeof(AudioTelemetryPacket_t) = 64 bytes
-  * - Destination: telemetry_ctx.receiver_ip : telemetry_ctx.receiver_port
-  * - Mode: broadcast or unicast based on configuration
+  * - Destination: receiver IP, broadcast or multicast group (Telemetry_Destination)
+  *   : telemetry_ctx.receiver_port
+  * - Sent on the UDP flow: prebuilt headers while the next hop is unchanged,
+  *   nx_udp_socket_send() otherwise
   */
 static UINT Telemetry_TransmitPacket(const AudioTelemetryPacket_t *pkt)
 {
@@ -332,55 +699,123 @@ static UINT Telemetry_TransmitPacket(const AudioTelemetryPacket_t *pkt)
     if (!pkt || !telemetry_ctx.ip_instance)
         return NX_PTR_ERROR;
     
-    /* Allocate packet from IP instance's default packet pool */
-    /* Note: Must use pool that was created for this IP instance */
-    status = nx_packet_allocate(telemetry_ctx.ip_instance->nx_ip_default_packet_pool,
-                                &packet_ptr,
-                                NX_UDP_PACKET,
-                                TX_WAIT_FOREVER);
+    /* Own pool, rx above its reserve, then a bounded wait: HTTP and receive
+       traffic cannot hold the pipeline up, a lost datagram is counted */
+    status = PacketPools_Allocate(PACKET_CLASS_TELEMETRY,
+                                  &packet_ptr,
+                                  NX_UDP_PACKET,
+                                  TELEMETRY_ALLOC_WAIT_MS * TX_TIMER_TICKS_PER_SECOND / 1000U);
     
     if (status != NX_SUCCESS)
     {
-        telemetry_ctx.error_count++;
+        telemetry_ctx.alloc_fail_count++;
         return status;
     }
     
-    /* Copy telemetry packet data to payload */
-    memcpy(packet_ptr->nx_packet_prepend_ptr,
-           (const VOID *)pkt,
-           sizeof(AudioTelemetryPacket_t));
+    /* Copy the telemetry packet into the payload, summed on the way, and send */
+    status = UdpFlow_SendData(&telemetry_ctx.flow,
+                              packet_ptr,
+                              (const VOID *)pkt,
+                              sizeof(AudioTelemetryPacket_t));
     
-    packet_ptr->nx_packet_length = sizeof(AudioTelemetryPacket_t);
-    packet_ptr->nx_packet_append_ptr = packet_ptr->nx_packet_prepend_ptr + 
-                                        packet_ptr->nx_packet_length;
+    if (status != NX_SUCCESS)
+    {
+        printf("UDP send failed: 0x%02X (IP: 0x%08lX, Port: %u)\n", 
+               status, Telemetry_Destination(), telemetry_ctx.receiver_port);
+        nx_packet_release(packet_ptr);
+        return status;
+    }
+    
+    return NX_SUCCESS;
+}
+
+/**
+  * @brief  Add a packet to the compressed history
+  * @param  pkt: packet to record
+  * @retval None
+  * 
+  * Packets are staged in the encoder; every FEATURE_HISTORY_BLOCK_RECORDS
+  * packets one block is encoded and appended to the ring, dropping the
+  * oldest blocks when it is full. Each block is also queued to the SD card
+  * log; while the card falls behind only every 2nd (HIGH) or 4th (CRITICAL)
+  * packet is recorded.
+  */
+static void Telemetry_HistoryAppend(const AudioTelemetryPacket_t *pkt)
+{
+    uint8_t *block;
+    uint32_t size;
+    uint32_t decimation;
     
-    /* Transmit via UDP */
-    if (telemetry_ctx.use_broadcast)
+    switch (StagingLog_GetLevel())
     {
-        /* Broadcast mode: send to 255.255.255.255 */
-        status = nx_udp_socket_send(&telemetry_ctx.udp_socket,
-                                    packet_ptr,
-                                    0xFFFFFFFF,  /* Broadcast address */
-                                    telemetry_ctx.receiver_port);
+    case STAGING_LOG_LEVEL_CRITICAL:
+        decimation = 4;
+        break;
+    case STAGING_LOG_LEVEL_HIGH:
+        decimation = 2;
+        break;
+    default:
+        decimation = 1;
+        break;
     }
-    else
+    
+    if (decimation > 1 && (telemetry_ctx.history_decimate_count++ % decimation) != 0)
+        return;
+    
+    if (!FeatureHistory_EncoderAdd(&telemetry_ctx.history_enc, pkt))
+        return;
+    
+    /* Without a scratch block the staged records are dropped (counted in the slab stats) */
+    block = (uint8_t *)Slab_Alloc(FEATURE_HISTORY_BLOCK_MAX_SIZE);
+    if (!block)
     {
-        /* Unicast mode: send to specific IP */
-        status = nx_udp_socket_send(&telemetry_ctx.udp_socket,
-                                    packet_ptr,
-                                    telemetry_ctx.receiver_ip,
-                                    telemetry_ctx.receiver_port);
+        FeatureHistory_EncoderReset(&telemetry_ctx.history_enc);
+        return;
     }
     
-    if (status != NX_SUCCESS)
+    /* Encode outside the lock, only the ring update is serialized */
+    size = FeatureHistory_EncoderFlush(&telemetry_ctx.history_enc, block, FEATURE_HISTORY_BLOCK_MAX_SIZE);
+    if (size == 0)
     {
-        printf("UDP send failed: 0x%02X (IP: 0x%08lX, Port: %u)\n", 
-               status, telemetry_ctx.receiver_ip, telemetry_ctx.receiver_port);
-        nx_packet_release(packet_ptr);
-        return status;
+        Slab_Free(block);
+        return;
     }
     
-    return NX_SUCCESS;
+    telemetry_ctx.history_raw_bytes += FEATURE_HISTORY_BLOCK_RECORDS * sizeof(AudioTelemetryPacket_t);
+    telemetry_ctx.history_encoded_bytes += size;
+    
+    /* Non-blocking, a full staging ring only counts a dropped record */
+    StagingLog_Append(block, size);
+    
+    if (tx_mutex_get(&telemetry_ctx.history_mutex, TX_WAIT_FOREVER) != TX_SUCCESS)
+    {
+        Slab_Free(block);
+        return;
+    }
+    
+    while (telemetry_ctx.history_len + size > sizeof(telemetry_history_buf))
+    {
+        uint32_t oldest = FeatureHistory_BlockSize(telemetry_history_buf, telemetry_ctx.history_len);
+        
+        if (oldest == 0)
+        {
+            telemetry_ctx.history_len = 0;
+            telemetry_ctx.history_blocks = 0;
+            break;
+        }
+        
+        memmove(telemetry_history_buf, &telemetry_history_buf[oldest],
+                telemetry_ctx.history_len - oldest);
+        telemetry_ctx.history_len -= oldest;
+        telemetry_ctx.history_blocks--;
+    }
+    
+    memcpy(&telemetry_history_buf[telemetry_ctx.history_len], block, size);
+    telemetry_ctx.history_len += size;
+    telemetry_ctx.history_blocks++;
+    
+    tx_mutex_put(&telemetry_ctx.history_mutex);
+    Slab_Free(block);
 }
 
 /************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -21,13 +21,17 @@ extern "C" {
 #include "nx_api.h"
 #include "nxd_dhcp_client.h"
 #include "audio_features.h"
+#include "spsc_ring.h"
+#include "rt_sched.h"
 
 /* Defines -------------------------------------------------------------------*/
 
 /**
  * @brief Telemetry thread configuration
  */
-#define TELEMETRY_THREAD_PRIORITY     8           /* Same as audio acq */
+#define TELEMETRY_PERIOD_MS           ((AUDIO_SAMPLES_PER_PACKET * 1000U) / AUDIO_SAMPLE_RATE)  /* One feature packet */
+#define TELEMETRY_BUDGET_US           10000       /* One UDP send plus the history block */
+#define TELEMETRY_THREAD_PRIORITY     RT_SCHED_PRIORITY(TELEMETRY_PERIOD_MS)
 #define TELEMETRY_THREAD_STACK_SIZE   (3 * 1024)  /* 3 KB stack */
 
 /**
@@ -36,15 +40,44 @@ extern "C" {
 #define TELEMETRY_UDP_PORT_TX         5001        /* Local UDP port (if needed) */
 #define TELEMETRY_UDP_PORT_RX         5000        /* Central receiver port (example) */
 
-/* Central receiver IP (configure as needed) */
-/* By default: broadcast, but can be set to specific IP */
+/* Central receiver IP for unicast mode (configure as needed) */
 #define TELEMETRY_DEFAULT_IP_ADDR     0xFFFFFFFF  /* 255.255.255.255 broadcast */
 
+/**
+ * @brief Multicast delivery: one group per farm section, receivers join it
+ */
+#define TELEMETRY_FARM_SECTION        1           /* Section of this node, selects the group */
+#define TELEMETRY_MCAST_GROUP(section) IP_ADDRESS(239, 192, (section), 1)  /* Organization-local scope, RFC 2365 */
+#define TELEMETRY_MCAST_TTL           1           /* Hops; 1 keeps datagrams on the local network */
+#define TELEMETRY_MCAST_MAX_GROUPS    4           /* Groups with statistics, oldest replaced */
+#define TELEMETRY_DEFAULT_MODE        TELEMETRY_MODE_MULTICAST
+#define TELEMETRY_MCAST_REPORT_SIZE   384         /* /GetMulticast text, taken from the slab allocator */
+
+typedef enum
+{
+    TELEMETRY_MODE_UNICAST = 0,                   /* Receiver IP set by Telemetry_SetReceiver */
+    TELEMETRY_MODE_BROADCAST,                     /* 255.255.255.255 */
+    TELEMETRY_MODE_MULTICAST                      /* Group set by Telemetry_SetMulticast */
+} Telemetry_Mode_t;
+
+/**
+ * @brief Telemetry packet pool (app_packet_pools.h, class telemetry)
+ */
+#define TELEMETRY_POOL_PACKETS        8           /* Datagrams queued behind a slow link */
+#define TELEMETRY_PACKET_PAYLOAD      ((NX_UDP_PACKET + sizeof(AudioTelemetryPacket_t) + 3U) & ~3U)
+#define TELEMETRY_POOL_SIZE           ((TELEMETRY_PACKET_PAYLOAD + sizeof(NX_PACKET)) * TELEMETRY_POOL_PACKETS + NX_PACKET_ALIGNMENT)
+#define TELEMETRY_ALLOC_WAIT_MS       10          /* Then the datagram is dropped rather than the pipeline stalled */
+
 /**
  * @brief Transmit interval
  */
 #define TELEMETRY_TX_INTERVAL_MS      2000        /* 2 second interval */
 
+/**
+ * @brief Compressed feature history (feature_history.h block format)
+ */
+#define TELEMETRY_HISTORY_SIZE        (8 * 1024)  /* RAM ring of encoded blocks, oldest dropped first */
+
 /* Function Prototypes -------------------------------------------------------*/
 
 /**
@@ -57,11 +90,12 @@ UINT Telemetry_Init(TX_BYTE_POOL *byte_pool, NX_IP *ip_instance);
 
 /**
  * @brief Start telemetry transmission
- * @param input_queue: Queue pointer from feature extraction (AudioTelemetryPacket_t)
- * @param receiver_ip: Destination IP address for packets (network byte order)
+ * @param input_ring: Ring from feature extraction (AudioTelemetryPacket_t slots)
+ * @param receiver_ip: Unicast receiver IP (network byte order), 0 keeps the default;
+ *        the mode stays TELEMETRY_DEFAULT_MODE
  * @retval TX_SUCCESS on success
  */
-UINT Telemetry_Start(TX_QUEUE *input_queue, ULONG receiver_ip);
+UINT Telemetry_Start(SpscRing_t *input_ring, ULONG receiver_ip);
 
 /**
  * @brief Set receiver IP address and port
@@ -78,6 +112,26 @@ UINT Telemetry_SetReceiver(ULONG ip_addr, UINT port);
  */
 UINT Telemetry_SetBroadcast(uint8_t enable);
 
+/**
+ * @brief Send to a multicast group
+ * @param group: class D address, host byte order (e.g. TELEMETRY_MCAST_GROUP(2))
+ * @param ttl: hop limit, 1 to 255
+ * @retval TX_SUCCESS, or NX_IP_ADDRESS_ERROR / NX_OPTION_ERROR for a bad argument
+ */
+UINT Telemetry_SetMulticast(ULONG group, UINT ttl);
+
+/**
+ * @brief Format the delivery mode and the per-group counters as CSV lines
+ * @param buf: output buffer, TELEMETRY_MCAST_REPORT_SIZE bytes suffice
+ * @param size: buffer size
+ * @retval Number of characters written (excluding terminator)
+ *
+ * Line format, the mode, then one line per group used since boot:
+ *   mode,<unicast|broadcast|multicast>,<destination>,<port>,<ttl>
+ *   group,<address>,<ttl>,<current>,<packets>,<bytes>,<errors>
+ */
+uint32_t Telemetry_FormatMulticast(char *buf, uint32_t size);
+
 /**
  * @brief Get transmitted packet count
  * @retval Number of packets sent
@@ -90,6 +144,13 @@ uint32_t Telemetry_GetTxCount(void);
  */
 uint32_t Telemetry_GetErrorCount(void);
 
+/**
+ * @brief Get allocation failure count (not included in the error count)
+ * @retval Datagrams dropped because no packet was free within
+ *         TELEMETRY_ALLOC_WAIT_MS
+ */
+uint32_t Telemetry_GetAllocFailCount(void);
+
 /**
  * @brief Get a copy of the most recent AudioTelemetryPacket_t.
  * @param out: output buffer to fill
@@ -97,6 +158,33 @@ uint32_t Telemetry_GetErrorCount(void);
  */
 uint8_t Telemetry_GetLastPacket(AudioTelemetryPacket_t *out);
 
+/**
+ * @brief Copy the most recent compressed history blocks
+ * @param dst: destination buffer
+ * @param max_len: capacity of dst (whole blocks only, oldest are skipped)
+ * @retval Number of bytes copied
+ */
+uint32_t Telemetry_GetHistory(uint8_t *dst, uint32_t max_len);
+
+/**
+ * @brief Get history encoder statistics
+ * @param blocks: blocks currently stored (optional)
+ * @param bytes: bytes currently stored (optional)
+ * @param raw_bytes: total raw packet bytes encoded since boot (optional)
+ * @param encoded_bytes: total encoded block bytes since boot (optional)
+ * @retval None
+ */
+void Telemetry_GetHistoryStats(uint32_t *blocks, uint32_t *bytes,
+                               uint32_t *raw_bytes, uint32_t *encoded_bytes);
+
+/**
+ * @brief Format the UDP flow counters as a CSV line (UdpFlow_Format)
+ * @param buf: output buffer, UDP_FLOW_REPORT_SIZE bytes suffice
+ * @param size: buffer size
+ * @retval Number of characters written, 0 before the socket exists
+ */
+uint32_t Telemetry_FormatFlow(char *buf, uint32_t size);
+
 /**
  * @brief Check if socket is connected/ready
  * @retval 1 if ready, 0 if not
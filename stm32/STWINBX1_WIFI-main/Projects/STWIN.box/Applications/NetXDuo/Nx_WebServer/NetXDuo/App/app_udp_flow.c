@@ -0,0 +1,541 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    app_udp_flow.c
+  * @author  Wind Turbine Team
+  * @brief   Connected UDP flow: cached next hop and prebuilt headers
+  ******************************************************************************
+  * The fast path does what _nx_udp_socket_send(), _nx_ip_header_add() and
+  * _nx_ip_driver_packet_send() do for an IPv4 datagram that needs neither
+  * fragmentation nor an ARP request, with the IP protection mutex held the
+  * same way. The checksums are kept as sums of 16-bit words in memory order,
+  * the order _nx_ip_checksum_partial() returns, so no byte swapping is done
+  * on the payload sum.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_udp_flow.h"
+#include "app_util.h"
+#include "nx_ip.h"
+#include "nx_ipv4.h"
+#include "nx_udp.h"
+#include "slab_alloc.h"
+#include "stm32u5xx.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define UDP_FLOW_HEADER_SIZE            (sizeof(NX_IPV4_HEADER) + sizeof(NX_UDP_HEADER))
+#define UDP_FLOW_REVALIDATE_TICKS       ((ULONG)UDP_FLOW_REVALIDATE_MS * TX_TIMER_TICKS_PER_SECOND / 1000U)
+
+_Static_assert(UDP_FLOW_REPORT_SIZE <= SLAB_MAX_BLOCK_SIZE, "report does not fit the largest slab class");
+
+/* Private function prototypes -----------------------------------------------*/
+static UINT UdpFlow_Enter(UdpFlow_t *flow, NX_PACKET *packet_ptr);
+static UINT UdpFlow_IsCurrent(const UdpFlow_t *flow);
+static void UdpFlow_Resolve(UdpFlow_t *flow);
+static void UdpFlow_Transmit(UdpFlow_t *flow, NX_PACKET *packet_ptr, ULONG payload_sum);
+static UINT UdpFlow_SendSlow(UdpFlow_t *flow, NX_PACKET *packet_ptr, uint32_t start);
+static void UdpFlow_Account(UdpFlow_t *flow, uint32_t fast, uint32_t cycles);
+static ULONG UdpFlow_Fold(ULONG sum);
+
+/**
+  * @brief  Attach a flow to a socket and a destination
+  * @param  flow: flow storage
+  * @param  socket: bound UDP socket
+  * @param  ip_address: destination, host byte order
+  * @param  port: destination port
+  * @retval NX_SUCCESS or NX_PTR_ERROR
+  */
+UINT UdpFlow_Open(UdpFlow_t *flow, NX_UDP_SOCKET *socket, ULONG ip_address, UINT port)
+{
+    if (!flow || !socket || !socket->nx_udp_socket_ip_ptr)
+        return NX_PTR_ERROR;
+
+    memset(flow, 0, sizeof(*flow));
+    flow->socket = socket;
+    flow->dest_ip = ip_address;
+    flow->dest_port = port;
+
+    return NX_SUCCESS;
+}
+
+/**
+  * @brief  Drop the cached next hop
+  * @param  flow: open flow
+  * @retval None
+  */
+void UdpFlow_Invalidate(UdpFlow_t *flow)
+{
+    if (flow)
+        flow->valid = 0;
+}
+
+/**
+  * @brief  Send a packet whose payload is in place
+  * @param  flow: open flow
+  * @param  packet_ptr: packet with NX_UDP_PACKET header room
+  * @retval NX_SUCCESS or error code (packet not consumed)
+  */
+UINT UdpFlow_Send(UdpFlow_t *flow, NX_PACKET *packet_ptr)
+{
+    uint32_t start = DWT->CYCCNT;
+    ULONG payload_sum;
+
+    if (!flow || !flow->socket || !packet_ptr)
+        return NX_PTR_ERROR;
+
+    if (!UdpFlow_Enter(flow, packet_ptr))
+        return UdpFlow_SendSlow(flow, packet_ptr, start);
+
+    payload_sum = _nx_ip_checksum_partial(packet_ptr->nx_packet_prepend_ptr,
+                                          (UINT)packet_ptr->nx_packet_length, 0);
+    UdpFlow_Transmit(flow, packet_ptr, payload_sum);
+    UdpFlow_Account(flow, 1, DWT->CYCCNT - start);
+
+    return NX_SUCCESS;
+}
+
+/**
+  * @brief  Copy a payload into an empty packet and send it
+  * @param  flow: open flow
+  * @param  packet_ptr: empty packet with NX_UDP_PACKET header room
+  * @param  data: payload
+  * @param  length: payload size
+  * @retval NX_SUCCESS or error code (packet not consumed)
+  *
+  * The payload is summed while it is copied; the fused copy costs about as
+  * much as the memcpy the slow path needs anyway, so it is always done.
+  */
+UINT UdpFlow_SendData(UdpFlow_t *flow, NX_PACKET *packet_ptr, const VOID *data, UINT length)
+{
+    uint32_t start = DWT->CYCCNT;
+    ULONG payload_sum;
+    UINT status;
+
+    if (!flow || !flow->socket || !packet_ptr || (!data && length))
+        return NX_PTR_ERROR;
+
+    /* Does not fit one packet: let NetX chain it, only the slow path takes that */
+    if ((ULONG)(packet_ptr->nx_packet_data_end - packet_ptr->nx_packet_prepend_ptr) < length)
+    {
+        status = nx_packet_data_append(packet_ptr, (VOID *)data, length,
+                                       packet_ptr->nx_packet_pool_owner, NX_NO_WAIT);
+        if (status != NX_SUCCESS)
+            return status;
+        return UdpFlow_SendSlow(flow, packet_ptr, start);
+    }
+
+    payload_sum = _nx_ip_checksum_copy_partial(packet_ptr->nx_packet_prepend_ptr,
+                                               (const UCHAR *)data, length, 0);
+    packet_ptr->nx_packet_length = length;
+    packet_ptr->nx_packet_append_ptr = packet_ptr->nx_packet_prepend_ptr + length;
+
+    if (!UdpFlow_Enter(flow, packet_ptr))
+        return UdpFlow_SendSlow(flow, packet_ptr, start);
+
+    UdpFlow_Transmit(flow, packet_ptr, payload_sum);
+    UdpFlow_Account(flow, 1, DWT->CYCCNT - start);
+
+    return NX_SUCCESS;
+}
+
+/**
+  * @brief  Flow counters
+  * @param  flow: open flow
+  * @param  stats: output
+  * @retval None
+  */
+void UdpFlow_GetStats(const UdpFlow_t *flow, UdpFlow_Stats_t *stats)
+{
+    TX_INTERRUPT_SAVE_AREA
+    uint64_t fast_cycles, slow_cycles;
+
+    if (!flow || !stats)
+        return;
+
+    TX_DISABLE
+    *stats = flow->stats;
+    fast_cycles = flow->fast_cycles;
+    slow_cycles = flow->slow_cycles;
+    TX_RESTORE
+
+    stats->fast_cycles_avg = stats->fast ? (uint32_t)(fast_cycles / stats->fast) : 0U;
+    stats->slow_cycles_avg = stats->slow ? (uint32_t)(slow_cycles / stats->slow) : 0U;
+}
+
+/**
+  * @brief  Format the flow counters as a CSV line
+  * @param  flow: open flow
+  * @param  buf: output buffer
+  * @param  size: buffer size
+  * @retval Number of characters written
+  */
+uint32_t UdpFlow_Format(const UdpFlow_t *flow, char *buf, uint32_t size)
+{
+    UdpFlow_Stats_t stats;
+    uint32_t saved;
+
+    if (!flow || !buf || size == 0U)
+        return 0;
+
+    buf[0] = '\0';
+
+    UdpFlow_GetStats(flow, &stats);
+    saved = (stats.fast && stats.slow_cycles_avg > stats.fast_cycles_avg)
+            ? stats.slow_cycles_avg - stats.fast_cycles_avg : 0U;
+
+    return App_Append(buf, size, 0, "flow,%lu.%lu.%lu.%lu,%u,%u,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+                      (unsigned long)(flow->dest_ip >> 24), (unsigned long)((flow->dest_ip >> 16) & 0xFFU),
+                      (unsigned long)((flow->dest_ip >> 8) & 0xFFU), (unsigned long)(flow->dest_ip & 0xFFU),
+                      flow->dest_port, flow->valid,
+                      (unsigned long)stats.fast, (unsigned long)stats.slow,
+                      (unsigned long)stats.resolves, (unsigned long)stats.fallbacks,
+                      (unsigned long)stats.fast_cycles_avg, (unsigned long)stats.fast_cycles_max,
+                      (unsigned long)stats.slow_cycles_avg, (unsigned long)stats.slow_cycles_max,
+                      (unsigned long)saved);
+}
+
+/**
+  * @brief  Decide the path; on the fast path return with the IP mutex held
+  * @param  flow: open flow
+  * @param  packet_ptr: payload packet
+  * @retval NX_TRUE for the fast path
+  */
+static UINT UdpFlow_Enter(UdpFlow_t *flow, NX_PACKET *packet_ptr)
+{
+    NX_IP *ip_ptr = flow->socket->nx_udp_socket_ip_ptr;
+
+    /* Keep the slow path timed */
+    if ((++flow->send_count % UDP_FLOW_SLOW_SAMPLE) == 0U)
+        return NX_FALSE;
+
+    /* Unbound sockets get their error from nx_udp_socket_send() */
+    if (!flow->socket->nx_udp_socket_bound_next)
+        return NX_FALSE;
+
+    /* One buffer with room for both headers */
+    if (packet_ptr->nx_packet_next ||
+        (ULONG)(packet_ptr->nx_packet_prepend_ptr - packet_ptr->nx_packet_data_start) < NX_UDP_PACKET ||
+        packet_ptr->nx_packet_length != (ULONG)(packet_ptr->nx_packet_append_ptr - packet_ptr->nx_packet_prepend_ptr))
+        return NX_FALSE;
+
+    tx_mutex_get(&ip_ptr->nx_ip_protection, TX_WAIT_FOREVER);
+
+    if (flow->valid && (tx_time_get() - flow->checked_at) >= UDP_FLOW_REVALIDATE_TICKS)
+        flow->valid = 0;
+
+    if (flow->valid && !UdpFlow_IsCurrent(flow))
+    {
+        flow->valid = 0;
+        flow->stats.fallbacks++;
+    }
+
+    if (!flow->valid)
+        UdpFlow_Resolve(flow);
+
+    /* Larger than the MTU would need fragmenting */
+    if (flow->valid &&
+        packet_ptr->nx_packet_length + UDP_FLOW_HEADER_SIZE <= flow->interface->nx_interface_ip_mtu_size)
+        return NX_TRUE;
+
+    tx_mutex_put(&ip_ptr->nx_ip_protection);
+
+    return NX_FALSE;
+}
+
+/**
+  * @brief  Check the cached next hop against the interface and ARP state (IP mutex held)
+  * @param  flow: resolved flow
+  * @retval NX_TRUE if nothing changed
+  */
+static UINT UdpFlow_IsCurrent(const UdpFlow_t *flow)
+{
+    NX_IP *ip_ptr = flow->socket->nx_udp_socket_ip_ptr;
+    NX_INTERFACE *interface_ptr = flow->interface;
+
+    if (!interface_ptr->nx_interface_link_up ||
+        interface_ptr->nx_interface_ip_address != flow->source_ip ||
+        interface_ptr->nx_interface_ip_network_mask != flow->network_mask ||
+        ip_ptr->nx_ip_gateway_address != flow->gateway)
+        return NX_FALSE;
+
+    /* The entry may have been recycled for another address or re-learnt */
+    if (flow->arp &&
+        (flow->arp->nx_arp_ip_address != flow->next_hop ||
+         flow->arp->nx_arp_physical_address_msw != flow->mac_msw ||
+         flow->arp->nx_arp_physical_address_lsw != flow->mac_lsw))
+        return NX_FALSE;
+
+    return NX_TRUE;
+}
+
+/**
+  * @brief  Look up the next hop and build the header template (IP mutex held)
+  * @param  flow: open flow
+  * @retval None, flow->valid is set on success
+  */
+static void UdpFlow_Resolve(UdpFlow_t *flow)
+{
+    NX_UDP_SOCKET *socket = flow->socket;
+    NX_IP *ip_ptr = socket->nx_udp_socket_ip_ptr;
+    NX_INTERFACE *interface_ptr = NX_NULL;
+    NX_ARP *arp_ptr = NX_NULL;
+    ULONG dest = flow->dest_ip;
+    ULONG next_hop = 0;
+    ULONG protocol;
+    UINT index = 0;
+
+    flow->valid = 0;
+    flow->arp = NX_NULL;
+    flow->checked_at = tx_time_get();
+    flow->stats.resolves++;
+
+    if (_nx_ip_route_find(ip_ptr, dest, &interface_ptr, &next_hop) != NX_SUCCESS ||
+        !interface_ptr || !next_hop)
+        return;
+
+    if (!interface_ptr->nx_interface_link_up || !interface_ptr->nx_interface_ip_address ||
+        !interface_ptr->nx_interface_address_mapping_needed)
+        return;
+
+    flow->command = NX_LINK_PACKET_SEND;
+
+    /* Same destination classes as _nx_ip_driver_packet_send() */
+    if (dest == NX_IP_LIMITED_BROADCAST ||
+        (((dest & interface_ptr->nx_interface_ip_network_mask) == interface_ptr->nx_interface_ip_network) &&
+         ((dest & ~interface_ptr->nx_interface_ip_network_mask) == ~interface_ptr->nx_interface_ip_network_mask)))
+    {
+        flow->command = NX_LINK_PACKET_BROADCAST;
+        flow->mac_msw = 0xFFFFUL;
+        flow->mac_lsw = 0xFFFFFFFFUL;
+    }
+    else if ((dest >= NX_IP_LOOPBACK_FIRST && dest <= NX_IP_LOOPBACK_LAST) ||
+             dest == interface_ptr->nx_interface_ip_address)
+    {
+        return;
+    }
+    else if ((dest & NX_IP_CLASS_D_MASK) == NX_IP_CLASS_D_TYPE)
+    {
+        for (index = 0; index < NX_MAX_MULTICAST_GROUPS; index++)
+        {
+            if (ip_ptr->nx_ipv4_multicast_entry[index].nx_ipv4_multicast_join_list == dest &&
+                ip_ptr->nx_ipv4_multicast_entry[index].nx_ipv4_multicast_loopback_enable)
+                return;
+        }
+        flow->mac_msw = NX_IP_MULTICAST_UPPER;
+        flow->mac_lsw = NX_IP_MULTICAST_LOWER | (dest & NX_IP_MULTICAST_MASK);
+    }
+    else
+    {
+        index = (UINT)((next_hop + (next_hop >> 8)) & NX_ARP_TABLE_MASK);
+        arp_ptr = ip_ptr->nx_ip_arp_table[index];
+        while (arp_ptr)
+        {
+            if (arp_ptr->nx_arp_ip_address == next_hop)
+                break;
+            arp_ptr = arp_ptr->nx_arp_active_next;
+            if (arp_ptr == ip_ptr->nx_ip_arp_table[index])
+                arp_ptr = NX_NULL;
+        }
+
+        /* Unresolved: the slow path queues the datagram and sends the request */
+        if (!arp_ptr || !(arp_ptr->nx_arp_physical_address_msw | arp_ptr->nx_arp_physical_address_lsw))
+            return;
+
+        flow->arp = arp_ptr;
+        flow->arp_index = index;
+        flow->mac_msw = arp_ptr->nx_arp_physical_address_msw;
+        flow->mac_lsw = arp_ptr->nx_arp_physical_address_lsw;
+    }
+
+    flow->interface = interface_ptr;
+    flow->next_hop = next_hop;
+    flow->source_ip = interface_ptr->nx_interface_ip_address;
+    flow->network_mask = interface_ptr->nx_interface_ip_network_mask;
+    flow->gateway = ip_ptr->nx_ip_gateway_address;
+
+    /* IP header: length and id are added per datagram */
+    flow->ip_word_0 = NX_IP_VERSION | socket->nx_udp_socket_type_of_service;
+    flow->fragment = socket->nx_udp_socket_fragment_enable;
+    flow->ip_word_2 = (socket->nx_udp_socket_time_to_live << NX_IP_TIME_TO_LIVE_SHIFT) | NX_IP_UDP;
+    flow->ip_source = flow->source_ip;
+    flow->ip_destination = dest;
+    flow->udp_word_0 = ((ULONG)socket->nx_udp_socket_port << NX_SHIFT_BY_16) | (ULONG)flow->dest_port;
+    protocol = NX_PROTOCOL_UDP;
+
+    NX_CHANGE_ULONG_ENDIAN(flow->ip_word_2);
+    NX_CHANGE_ULONG_ENDIAN(flow->ip_source);
+    NX_CHANGE_ULONG_ENDIAN(flow->ip_destination);
+    NX_CHANGE_ULONG_ENDIAN(flow->udp_word_0);
+    NX_CHANGE_ULONG_ENDIAN(protocol);
+
+    flow->ip_sum = UdpFlow_Fold((flow->ip_word_2 & NX_LOWER_16_MASK) + (flow->ip_word_2 >> NX_SHIFT_BY_16) +
+                                (flow->ip_source & NX_LOWER_16_MASK) + (flow->ip_source >> NX_SHIFT_BY_16) +
+                                (flow->ip_destination & NX_LOWER_16_MASK) + (flow->ip_destination >> NX_SHIFT_BY_16));
+    flow->udp_sum = UdpFlow_Fold((flow->ip_source & NX_LOWER_16_MASK) + (flow->ip_source >> NX_SHIFT_BY_16) +
+                                 (flow->ip_destination & NX_LOWER_16_MASK) + (flow->ip_destination >> NX_SHIFT_BY_16) +
+                                 (protocol & NX_LOWER_16_MASK) + (protocol >> NX_SHIFT_BY_16) +
+                                 (flow->udp_word_0 & NX_LOWER_16_MASK) + (flow->udp_word_0 >> NX_SHIFT_BY_16));
+
+    flow->valid = 1;
+}
+
+/**
+  * @brief  Write the headers and hand the packet to the link driver; releases the IP mutex
+  * @param  flow: resolved flow
+  * @param  packet_ptr: payload packet, consumed
+  * @param  payload_sum: _nx_ip_checksum_partial() of the payload
+  * @retval None
+  */
+static void UdpFlow_Transmit(UdpFlow_t *flow, NX_PACKET *packet_ptr, ULONG payload_sum)
+{
+    TX_INTERRUPT_SAVE_AREA
+    NX_UDP_SOCKET *socket = flow->socket;
+    NX_IP *ip_ptr = socket->nx_udp_socket_ip_ptr;
+    NX_INTERFACE *interface_ptr = flow->interface;
+    NX_IP_DRIVER driver_request;
+    ULONG payload_length = packet_ptr->nx_packet_length;
+    ULONG udp_length = payload_length + (ULONG)sizeof(NX_UDP_HEADER);
+    ULONG *header;
+    ULONG word_0, word_1, udp_word_1;
+    ULONG checksum;
+
+    packet_ptr->nx_packet_prepend_ptr -= UDP_FLOW_HEADER_SIZE;
+    packet_ptr->nx_packet_length = udp_length + (ULONG)sizeof(NX_IPV4_HEADER);
+    packet_ptr->nx_packet_ip_version = NX_IP_VERSION_V4;
+    packet_ptr->nx_packet_ip_interface = interface_ptr;
+    packet_ptr->nx_packet_ip_header = packet_ptr->nx_packet_prepend_ptr;
+    packet_ptr->nx_packet_ip_header_length = (UCHAR)(packet_ptr->nx_packet_ip_header_length + sizeof(NX_IPV4_HEADER));
+
+    word_0 = flow->ip_word_0 | packet_ptr->nx_packet_length;
+    word_1 = (ip_ptr->nx_ip_packet_id++ << NX_SHIFT_BY_16) | flow->fragment;
+    udp_word_1 = udp_length << NX_SHIFT_BY_16;
+    NX_CHANGE_ULONG_ENDIAN(word_0);
+    NX_CHANGE_ULONG_ENDIAN(word_1);
+    NX_CHANGE_ULONG_ENDIAN(udp_word_1);
+
+    header = (ULONG *)packet_ptr->nx_packet_prepend_ptr;
+    header[0] = word_0;
+    header[1] = word_1;
+    header[2] = flow->ip_word_2;
+    header[3] = flow->ip_source;
+    header[4] = flow->ip_destination;
+    header[5] = flow->udp_word_0;
+    header[6] = udp_word_1;
+
+#ifndef NX_DISABLE_IP_TX_CHECKSUM
+    checksum = UdpFlow_Fold(flow->ip_sum +
+                            (word_0 & NX_LOWER_16_MASK) + (word_0 >> NX_SHIFT_BY_16) +
+                            (word_1 & NX_LOWER_16_MASK) + (word_1 >> NX_SHIFT_BY_16));
+    ((USHORT *)header)[5] = (USHORT)~checksum;
+#endif /* NX_DISABLE_IP_TX_CHECKSUM */
+
+#ifndef NX_DISABLE_UDP_TX_CHECKSUM
+    if (!socket->nx_udp_socket_disable_checksum)
+    {
+        /* The UDP length is in the pseudo header and in the UDP header */
+        checksum = UdpFlow_Fold(flow->udp_sum + payload_sum + ((udp_word_1 & NX_LOWER_16_MASK) << 1) +
+                                ((udp_word_1 >> NX_SHIFT_BY_16) << 1));
+        checksum = ~checksum & NX_LOWER_16_MASK;
+        if (checksum == 0)
+            checksum = 0xFFFF;
+        ((USHORT *)header)[13] = (USHORT)checksum;
+    }
+#else
+    NX_PARAMETER_NOT_USED(payload_sum);
+#endif /* NX_DISABLE_UDP_TX_CHECKSUM */
+
+#ifndef NX_DISABLE_IP_INFO
+    ip_ptr->nx_ip_total_packet_send_requests++;
+    ip_ptr->nx_ip_total_packets_sent++;
+    ip_ptr->nx_ip_total_bytes_sent += udp_length;
+#endif
+#ifndef NX_DISABLE_UDP_INFO
+    ip_ptr->nx_ip_udp_packets_sent++;
+    ip_ptr->nx_ip_udp_bytes_sent += payload_length;
+    socket->nx_udp_socket_packets_sent++;
+    socket->nx_udp_socket_bytes_sent += payload_length;
+#endif
+
+    /* Keep the ARP entry at the head of its list, as a slow path send would */
+    if (flow->arp)
+    {
+        TX_DISABLE
+        ip_ptr->nx_ip_arp_table[flow->arp_index] = flow->arp;
+        TX_RESTORE
+    }
+
+    driver_request.nx_ip_driver_ptr = ip_ptr;
+    driver_request.nx_ip_driver_command = flow->command;
+    driver_request.nx_ip_driver_packet = packet_ptr;
+    driver_request.nx_ip_driver_interface = interface_ptr;
+    driver_request.nx_ip_driver_physical_address_msw = flow->mac_msw;
+    driver_request.nx_ip_driver_physical_address_lsw = flow->mac_lsw;
+
+    /* The driver releases the packet, sent or not */
+    (interface_ptr->nx_interface_link_driver_entry)(&driver_request);
+
+    tx_mutex_put(&ip_ptr->nx_ip_protection);
+}
+
+/**
+  * @brief  Send through nx_udp_socket_send() and time it
+  * @param  flow: open flow
+  * @param  packet_ptr: payload packet
+  * @param  start: DWT cycle count at entry
+  * @retval nx_udp_socket_send() status
+  */
+static UINT UdpFlow_SendSlow(UdpFlow_t *flow, NX_PACKET *packet_ptr, uint32_t start)
+{
+    UINT status;
+
+    status = nx_udp_socket_send(flow->socket, packet_ptr, flow->dest_ip, flow->dest_port);
+    if (status == NX_SUCCESS)
+        UdpFlow_Account(flow, 0, DWT->CYCCNT - start);
+
+    return status;
+}
+
+/**
+  * @brief  Count a sent datagram
+  * @param  flow: open flow
+  * @param  fast: sent on the fast path
+  * @param  cycles: cycles from the send call to the driver hand-off returning
+  * @retval None
+  */
+static void UdpFlow_Account(UdpFlow_t *flow, uint32_t fast, uint32_t cycles)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    if (fast)
+    {
+        flow->stats.fast++;
+        flow->fast_cycles += cycles;
+        if (cycles > flow->stats.fast_cycles_max)
+            flow->stats.fast_cycles_max = cycles;
+    }
+    else
+    {
+        flow->stats.slow++;
+        flow->slow_cycles += cycles;
+        if (cycles > flow->stats.slow_cycles_max)
+            flow->stats.slow_cycles_max = cycles;
+    }
+    TX_RESTORE
+}
+
+/**
+  * @brief  Fold a one's complement sum to 16 bits
+  * @param  sum: 32-bit sum
+  * @retval Folded sum
+  */
+static ULONG UdpFlow_Fold(ULONG sum)
+{
+    sum = (sum & NX_LOWER_16_MASK) + (sum >> NX_SHIFT_BY_16);
+    sum = (sum & NX_LOWER_16_MASK) + (sum >> NX_SHIFT_BY_16);
+    return sum;
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,163 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    app_udp_flow.h
+  * @author  Wind Turbine Team
+  * @brief   Connected UDP flow: cached next hop and prebuilt headers
+  ******************************************************************************
+  * nx_udp_socket_send() looks up the route, builds the UDP and IP headers
+  * field by field, checksums the whole datagram and searches the ARP cache,
+  * for every datagram. A flow is bound to one socket and one destination.
+  * It resolves the interface, next hop and MAC address once, and keeps the
+  * IP and UDP header words with their checksum contributions. A datagram
+  * then only needs the length, the IP id, the payload sum and the two
+  * checksums written before it is handed to the link driver.
+  *
+  * The cached state is checked on every send: interface address, mask,
+  * gateway, link state and the ARP entry of the next hop. Any difference, an
+  * expired revalidation period, a packet that does not fit or every
+  * UDP_FLOW_SLOW_SAMPLE-th datagram goes through nx_udp_socket_send()
+  * instead. The sampled datagrams keep the slow path cycle count current,
+  * so the report shows the saving per datagram.
+  *
+  * One thread sends on a flow. Loopback destinations and multicast groups
+  * joined with loopback always take the slow path.
+  */
+/* USER CODE END Header */
+
+#ifndef __APP_UDP_FLOW_H
+#define __APP_UDP_FLOW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "tx_api.h"
+#include "nx_api.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define UDP_FLOW_REVALIDATE_MS          1000    /* Next hop looked up again at least this often */
+#define UDP_FLOW_SLOW_SAMPLE            64      /* One datagram in this many timed on the slow path */
+#define UDP_FLOW_REPORT_SIZE            256     /* Report text, taken from the slab allocator */
+
+typedef struct
+{
+    uint32_t fast;                     /* Sent on the cached headers */
+    uint32_t slow;                     /* Sent by nx_udp_socket_send() */
+    uint32_t resolves;                 /* Next hop lookups */
+    uint32_t fallbacks;                /* Cached state found stale on a send */
+    uint32_t fast_cycles_avg;          /* Per datagram, copy and checksum included */
+    uint32_t fast_cycles_max;
+    uint32_t slow_cycles_avg;
+    uint32_t slow_cycles_max;
+} UdpFlow_Stats_t;
+
+/**
+ * @brief One flow; the fields are private to app_udp_flow.c
+ */
+typedef struct
+{
+    NX_UDP_SOCKET         *socket;
+    ULONG                  dest_ip;            /* Host byte order, as nx_udp_socket_send() */
+    UINT                   dest_port;
+
+    /* Resolved state, valid while valid is set */
+    UINT                   valid;
+    ULONG                  checked_at;         /* tx_time_get() of the last lookup */
+    NX_INTERFACE          *interface;
+    ULONG                  source_ip;
+    ULONG                  network_mask;
+    ULONG                  gateway;
+    ULONG                  next_hop;
+    NX_ARP                *arp;               /* Unicast only */
+    UINT                   arp_index;
+    UINT                   command;            /* NX_LINK_PACKET_SEND or NX_LINK_PACKET_BROADCAST */
+    ULONG                  mac_msw;
+    ULONG                  mac_lsw;
+
+    /* Header template; word 0 and fragment in host byte order, the rest in
+       network byte order with the length, id and checksum fields zero */
+    ULONG                  ip_word_0;
+    ULONG                  fragment;
+    ULONG                  ip_word_2;
+    ULONG                  ip_source;
+    ULONG                  ip_destination;
+    ULONG                  udp_word_0;
+    ULONG                  ip_sum;             /* Sum of IP words 2 to 4 */
+    ULONG                  udp_sum;            /* Pseudo header addresses, protocol and ports */
+
+    uint32_t               send_count;
+    uint64_t               fast_cycles;
+    uint64_t               slow_cycles;
+    UdpFlow_Stats_t        stats;
+} UdpFlow_t;
+
+/* Function Prototypes -------------------------------------------------------*/
+
+/**
+ * @brief Attach a flow to a bound socket and a destination
+ * @param flow: flow storage, owned by the caller
+ * @param socket: bound UDP socket
+ * @param ip_address: destination, host byte order; broadcast and multicast allowed
+ * @param port: destination port
+ * @retval NX_SUCCESS or NX_PTR_ERROR (the next hop is resolved on the first send)
+ */
+UINT UdpFlow_Open(UdpFlow_t *flow, NX_UDP_SOCKET *socket, ULONG ip_address, UINT port);
+
+/**
+ * @brief Drop the cached next hop, e.g. after a link event
+ * @param flow: open flow
+ * @retval None
+ */
+void UdpFlow_Invalidate(UdpFlow_t *flow);
+
+/**
+ * @brief Send a packet whose payload is already in place
+ * @param flow: open flow
+ * @param packet_ptr: allocated with NX_UDP_PACKET header room
+ * @retval NX_SUCCESS (the packet is consumed) or the nx_udp_socket_send() error
+ */
+UINT UdpFlow_Send(UdpFlow_t *flow, NX_PACKET *packet_ptr);
+
+/**
+ * @brief Copy a payload into an empty packet and send it; on the fast path
+ *        the payload is checksummed while it is copied
+ * @param flow: open flow
+ * @param packet_ptr: empty, allocated with NX_UDP_PACKET header room
+ * @param data: payload
+ * @param length: payload size
+ * @retval NX_SUCCESS (the packet is consumed) or an error, the packet is then the caller's
+ */
+UINT UdpFlow_SendData(UdpFlow_t *flow, NX_PACKET *packet_ptr, const VOID *data, UINT length);
+
+/**
+ * @brief Flow counters
+ * @param flow: open flow
+ * @param stats: output
+ * @retval None
+ */
+void UdpFlow_GetStats(const UdpFlow_t *flow, UdpFlow_Stats_t *stats);
+
+/**
+ * @brief Format the flow counters as a CSV line
+ * @param flow: open flow
+ * @param buf: output buffer
+ * @param size: buffer size
+ * @retval Number of characters written (excluding terminator)
+ *
+ * Line format:
+ *   flow,<dest_ip>,<port>,<valid>,<fast>,<slow>,<resolves>,<fallbacks>,
+ *        <fast_cycles_avg>,<fast_cycles_max>,<slow_cycles_avg>,
+ *        <slow_cycles_max>,<saved_cycles>
+ */
+uint32_t UdpFlow_Format(const UdpFlow_t *flow, char *buf, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_UDP_FLOW_H */
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -100,6 +100,25 @@
    real processing routine called from the NetX internal IP helper thread. */
 #define NX_DRIVER_DEFERRED_PROCESSING
 
+/* Specifies the maximum number of packets the IP thread takes off the deferred
+   receive queue before it serves its other events again. The default value is
+   0 (no limit) and is defined in nx_api.h. The Wi-Fi I/O thread queues up to
+   NX_DRIVER_EMW3080_IO_BATCH frames per wakeup. */
+#define NX_IP_RECEIVE_BATCH_MAX                 8
+
+/* Defined, a deferred receive batch also ends after this many cycles of
+   NX_IP_CYCLE_COUNT_GET(): 1 ms at the 160 MHz core clock. The cycle counter
+   is DWT->CYCCNT, enabled by tx_initialize_low_level.s; host builds on the
+   Linux port have neither. */
+#ifndef __linux__
+#define NX_IP_RECEIVE_BATCH_CYCLES              160000UL
+#define NX_IP_CYCLE_COUNT_GET()                 (*(volatile ULONG *)0xE0001004UL)
+#endif /* __linux__ */
+
+/* Defined, the IP instance counts deferred receive batches by size and the
+   cycles its thread spends processing events. */
+#define NX_ENABLE_IP_THREAD_INFO
+
 /* Defined, the source address of incoming packet is checked. The default is
    disabled. */
 /*
@@ -166,9 +185,9 @@
 */
 
 /* Defined, packet debug information is enabled.  */
-/*
+/* Enabled for the packet lifetime tracker (app_packet_track.c): each packet
+   records its owner, allocation site and tick, 12 bytes per packet header. */
 #define NX_ENABLE_PACKET_DEBUG_INFO
-*/
 
 /* If defined, the packet chain feature is removed. */
 /*
@@ -621,6 +640,24 @@
 #define NX_TCP_KEEPALIVE_RETRY      			75
 */
 
+/* Specify the number of buckets in the TCP and UDP port hash tables. Must be
+   a power of two. The default value is 32 and is defined in nx_api.h; builds
+   with many sockets on distinct ports can make the tables larger. */
+/*
+#define NX_TCP_PORT_TABLE_SIZE      			32
+#define NX_UDP_PORT_TABLE_SIZE      			32
+*/
+
+/* Specify the number of entries in the TCP connection cache, which maps a
+   hashed 4-tuple to the socket last hit for it so connected sockets sharing
+   a local port are found without walking the port bucket. Must be a power
+   of two, 0 disables the cache. The default value is 16 and is defined in
+   nx_api.h; about four entries per concurrent connection keep collisions
+   rare. */
+/*
+#define NX_TCP_CONNECTION_CACHE_SIZE			16
+*/
+
 /* Symbol that defines the maximum number of out-of-order TCP packets can be
    kept in the TCP socket receive queue. This symbol can be used to limit the
    number of packets queued in the TCP receive socket, preventing the packet
@@ -644,10 +681,11 @@
 
 /* Specifies the number of TCP packets to receive before sending an ACK.
    Note if NX_TCP_IMMEDIATE_ACK is enabled but NX_TCP_ACK_EVERY_N_PACKETS is
-   not, this value is automatically set to 1 for backward compatibility. */
-/*
+   not, this value is automatically set to 1 for backward compatibility.
+   Every second segment, as RFC 1122 asks: with only the delayed ACK timer
+   (NX_TCP_ACK_TIMER_RATE, 200 ms) a peer sending to us stalls on every
+   window's worth of data, and its RTT estimate includes the timer. */
 #define NX_TCP_ACK_EVERY_N_PACKETS  			2
-*/
 
 /* Automatically define NX_TCP_ACK_EVERY_N_PACKETS to 1 if NX_TCP_IMMEDIATE_ACK is defined.
    This is needed for backward compatibility. */
@@ -685,6 +723,20 @@
 #define NX_TCP_RETRY_SHIFT          			0x0
 */
 
+/* Defined, the retransmission timeout follows the measured round trip time
+   (RFC 6298) instead of the fixed NX_TCP_TRANSMIT_TIMER_RATE, within
+   NX_TCP_RTO_MIN and NX_TCP_RTO_MAX (200ms and 8s by default, nx_tcp.h),
+   short flights retransmit after fewer duplicate ACKs (RFC 5827), and a
+   partial ACK after a timeout resends the next hole at once (RFC 6582)
+   instead of leaving it to its own timeout. Retries double the timeout, as
+   RFC 6298 requires. The Wi-Fi round trip time ranges from 5ms to 500ms,
+   which no fixed timeout fits. Build with NX_TCP_FIXED_RTO defined for the
+   stock behaviour, e.g. to compare in Tools/tcplinkbench.c. */
+#ifndef NX_TCP_FIXED_RTO
+#define NX_TCP_ENABLE_RTT_ESTIMATION
+#define NX_TCP_RETRY_SHIFT                      0x1
+#endif
+
 /* Specifies how many keepalive retries are allowed before the connection is
    deemed broken. The default value is 10, which represents 10 retries, and is
    defined in nx_tcp.h. The application can override the default by defining
@@ -2433,10 +2485,9 @@
 */
 
 /* The priority of the HTTPS Server thread. By default, this value is defined
-   as 4 to specify priority 4. */
-/*
-#define NX_WEB_HTTP_SERVER_PRIORITY             4
-*/
+   as 4 to specify priority 4. Here it is below the rate-monotonic pipeline
+   band (rt_sched.h), so serving a page cannot hold off the audio path. */
+#define NX_WEB_HTTP_SERVER_PRIORITY             11
 
 /* Server socket window size. By default, this value is 8192. */
 /*
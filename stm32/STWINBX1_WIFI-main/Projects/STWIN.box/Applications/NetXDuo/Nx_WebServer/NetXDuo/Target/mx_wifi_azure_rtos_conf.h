@@ -34,16 +34,35 @@ extern "C" {
 
 #include "tx_api.h"
 #include "nx_api.h"
+#include "slab_alloc.h"
 
 UINT mx_wifi_alloc_init();
 void * mx_wifi_malloc(size_t size);
 void mx_wifi_free(void * p);
 
-#define MX_WIFI_MALLOC(size) mx_wifi_malloc(size)
-#define MX_WIFI_FREE(p) mx_wifi_free(p)
+/* IPC command/response buffers come from the size-class slabs (O(1), no
+   fragmentation). Oversized requests (certificates) and an exhausted class fall
+   back to the driver byte pool, which also keeps the thread stacks and queues. */
+static inline void *mx_wifi_buffer_alloc(size_t size)
+{
+  void *p = Slab_Alloc(size);
 
-#define NET_MALLOC(size) mx_wifi_malloc(size)
-#define NET_FREE(p) mx_wifi_free(p)
+  return (p != NULL) ? p : mx_wifi_malloc(size);
+}
+
+static inline void mx_wifi_buffer_free(void *p)
+{
+  if (Slab_Free(p) != TX_SUCCESS)
+  {
+    mx_wifi_free(p);
+  }
+}
+
+#define MX_WIFI_MALLOC(size) mx_wifi_buffer_alloc(size)
+#define MX_WIFI_FREE(p) mx_wifi_buffer_free(p)
+
+#define NET_MALLOC(size) mx_wifi_buffer_alloc(size)
+#define NET_FREE(p) mx_wifi_buffer_free(p)
 
 
 typedef NX_PACKET mx_buf_t;
@@ -0,0 +1,119 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    app_events.c
+  * @author  Wind Turbine Team
+  * @brief   Event flags that wake the pipeline worker threads
+  ******************************************************************************
+  * Broadcasts set the flags in every registered group rather than in one
+  * shared group: with TX_OR_CLEAR the first worker to wake would consume a
+  * shared flag, and a worker that is busy when the event arrives would miss
+  * it entirely. Per-worker groups keep the event pending until each worker
+  * gets to it.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_events.h"
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    AppEvents_Worker_t    *workers[APP_EVENTS_MAX_WORKERS];
+    uint32_t               worker_count;
+    volatile uint8_t       link_up;
+} AppEvents_Context_t;
+
+/* Private variables ---------------------------------------------------------*/
+static AppEvents_Context_t app_events_ctx = {0};
+
+/**
+  * @brief  Create a worker's event group and add it to the broadcast list
+  * @param  worker: worker events
+  * @param  name: event flags name
+  * @retval TX_SUCCESS or error code
+  */
+UINT AppEvents_Register(AppEvents_Worker_t *worker, CHAR *name)
+{
+    UINT status;
+
+    if (!worker)
+        return TX_PTR_ERROR;
+    if (app_events_ctx.worker_count >= APP_EVENTS_MAX_WORKERS)
+        return TX_NO_INSTANCE;
+
+    status = tx_event_flags_create(&worker->flags, name);
+    if (status != TX_SUCCESS)
+        return status;
+
+    worker->wakeups = 0;
+    app_events_ctx.workers[app_events_ctx.worker_count++] = worker;
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Wait for any APP_EVENT_* and clear what was returned
+  * @param  worker: worker events
+  * @param  wait_option: TX_NO_WAIT, ticks or TX_WAIT_FOREVER
+  * @retval Events, 0 on timeout
+  */
+ULONG AppEvents_Wait(AppEvents_Worker_t *worker, ULONG wait_option)
+{
+    ULONG events;
+
+    if (tx_event_flags_get(&worker->flags, APP_EVENT_ALL, TX_OR_CLEAR, &events, wait_option) != TX_SUCCESS)
+        return 0;
+
+    worker->wakeups++;
+    return events;
+}
+
+/**
+  * @brief  Post events to one worker
+  * @param  worker: worker events
+  * @param  events: APP_EVENT_* mask
+  * @retval None
+  */
+void AppEvents_Post(AppEvents_Worker_t *worker, ULONG events)
+{
+    tx_event_flags_set(&worker->flags, events, TX_OR);
+}
+
+/**
+  * @brief  Post events to every registered worker
+  * @param  events: APP_EVENT_* mask
+  * @retval None
+  */
+void AppEvents_Broadcast(ULONG events)
+{
+    for (uint32_t i = 0; i < app_events_ctx.worker_count; i++)
+        tx_event_flags_set(&app_events_ctx.workers[i]->flags, events, TX_OR);
+}
+
+/**
+  * @brief  Record the link state and broadcast APP_EVENT_LINK if it changed
+  * @param  link_up: 1 when up
+  * @retval None
+  */
+void AppEvents_SetLinkUp(uint8_t link_up)
+{
+    link_up = link_up ? 1 : 0;
+    if (app_events_ctx.link_up == link_up)
+        return;
+
+    app_events_ctx.link_up = link_up;
+    AppEvents_Broadcast(APP_EVENT_LINK);
+}
+
+/**
+  * @brief  Current link state
+  * @retval 1 if up, 0 if down
+  */
+uint8_t AppEvents_IsLinkUp(void)
+{
+    return app_events_ctx.link_up;
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
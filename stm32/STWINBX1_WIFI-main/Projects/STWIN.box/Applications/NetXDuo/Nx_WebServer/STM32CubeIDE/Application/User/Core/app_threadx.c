@@ -25,8 +25,22 @@
 /* USER CODE BEGIN Includes */
 #include "audio_acquisition.h"
 #include "feature_extraction.h"
+#include "dsp_pool.h"
 #include "app_telemetry.h"
 #include "app_netxduo.h"
+#include "asset_image.h"
+#include "audio_features.h"
+#include "staging_log.h"
+#include "mem_budget.h"
+#include "slab_alloc.h"
+#include "cpu_load.h"
+#include "event_trace.h"
+#include "thread_metric.h"
+#include "irq_latency.h"
+#include "rt_sched.h"
+#include "timer_wheel.h"
+#include "app_iperf.h"
+#include "app_azure_rtos_config.h"
 #include <stdio.h>
 
 /* USER CODE END Includes */
@@ -45,6 +59,24 @@
 #define INIT_ORDER_FEATURE      4   /* Feature extraction */
 #define INIT_ORDER_TELEMETRY    5   /* Telemetry transmission */
 
+#define STARTUP_THREAD_STACK_SIZE   (2 * 1024)
+#define STARTUP_THREAD_PRIORITY     9   /* Between main and workers */
+
+/* Everything carved from the Tx App byte pool, checked against TX_APP_MEM_POOL_SIZE */
+#define TX_APP_POOL_BUDGET  (MEM_BUDGET_POOL_COST(AUDIO_ACQ_THREAD_STACK_SIZE) +                          \
+                             MEM_BUDGET_POOL_COST(SPSC_RING_STORAGE_SIZE(sizeof(AudioFrame_t), AUDIO_ACQ_QUEUE_DEPTH)) + \
+                             MEM_BUDGET_POOL_COST(FEATURE_EXTRACT_THREAD_STACK_SIZE) +                    \
+                             DSP_POOL_WORKERS * MEM_BUDGET_POOL_COST(DSP_POOL_STACK_SIZE) +               \
+                             MEM_BUDGET_POOL_COST(SPSC_RING_STORAGE_SIZE(sizeof(AudioTelemetryPacket_t),  \
+                                                                         FEATURE_EXTRACT_QUEUE_DEPTH)) +  \
+                             MEM_BUDGET_POOL_COST(TELEMETRY_THREAD_STACK_SIZE) +                          \
+                             MEM_BUDGET_POOL_COST(STAGING_LOG_THREAD_STACK_SIZE) +                        \
+                             MEM_BUDGET_POOL_COST(IPERF_THREAD_STACK_SIZE) +                              \
+                             MEM_BUDGET_POOL_COST(STARTUP_THREAD_STACK_SIZE) +                            \
+                             2 * MEM_BUDGET_BLOCK_OVERHEAD)
+
+_Static_assert(TX_APP_MEM_POOL_SIZE >= TX_APP_POOL_BUDGET, "TX_APP_MEM_POOL_SIZE too small for the thread stacks and rings");
+
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -86,6 +118,66 @@ UINT App_ThreadX_Init(VOID *memory_ptr)
   g_byte_pool = byte_pool;
   printf("ThreadX App Initialization Started\n");
   
+  /* Timer wheel before anything that starts a periodic timer on it */
+  ret = TimerWheel_Init();
+  if (ret != TX_SUCCESS)
+  {
+    printf("TimerWheel_Init failed: 0x%02X\n", ret);
+    return ret;
+  }
+  
+  /* Memory budget first, so every allocation below is accounted for */
+  ret = MemBudget_Init();
+  if (ret != TX_SUCCESS)
+  {
+    printf("MemBudget_Init failed: 0x%02X\n", ret);
+    return ret;
+  }
+  
+  /* Size-class slabs for hot-path buffers (mx_wifi IPC, history blocks, HTTP scratch) */
+  ret = Slab_Init();
+  if (ret != TX_SUCCESS)
+  {
+    printf("Slab_Init failed: 0x%02X\n", ret);
+    return ret;
+  }
+  
+  /* Per-thread/ISR load table; diagnostics only, so a failure is not fatal */
+  if (CpuLoad_Init() != TX_SUCCESS)
+  {
+    printf("CpuLoad_Init failed, /GetCpuLoad stays empty\n");
+  }
+  
+  /* Event trace capture, started over HTTP (GET /TraceStart) */
+  if (EventTrace_Init() != TX_SUCCESS)
+  {
+    printf("EventTrace_Init failed, /GetTrace stays empty\n");
+  }
+  
+  /* Thread-Metric runner, idle until GET /ThreadMetricStart */
+  if (ThreadMetric_Init() != TX_SUCCESS)
+  {
+    printf("ThreadMetric_Init failed, benchmark not available\n");
+  }
+  
+  /* Timer wheel benchmark runner, idle until GET /TimerWheelBench */
+  if (TimerWheel_BenchInit() != TX_SUCCESS)
+  {
+    printf("TimerWheel_BenchInit failed, benchmark not available\n");
+  }
+  
+  /* Interrupt latency capture, started over HTTP (GET /IrqLatencyStart) */
+  if (IrqLatency_Init() != TX_SUCCESS)
+  {
+    printf("IrqLatency_Init failed, /GetIrqLatency stays empty\n");
+  }
+  
+  /* Deadline watchdog; the pipeline threads register with it as they are created */
+  if (RtSched_Init() != TX_SUCCESS)
+  {
+    printf("RtSched_Init failed, deadline misses are only counted at completion\n");
+  }
+  
   /* Initialize audio acquisition thread and queue */
   ret = AudioAcquisition_Init(byte_pool);
   if (ret != TX_SUCCESS)
@@ -136,10 +228,10 @@ UINT App_Create_Startup_Thread(TX_BYTE_POOL *byte_pool)
     return TX_PTR_ERROR;
   
   /* Allocate startup thread stack */
-  status = tx_byte_allocate(byte_pool,
-                            (VOID **)&thread_stack,
-                            2 * 1024,  /* 2 KB stack */
-                            TX_NO_WAIT);
+  status = MemBudget_Allocate(byte_pool,
+                              (VOID **)&thread_stack,
+                              STARTUP_THREAD_STACK_SIZE,
+                              "startup", "thread stack");
   if (status != TX_SUCCESS)
     return status;
   
@@ -149,9 +241,9 @@ UINT App_Create_Startup_Thread(TX_BYTE_POOL *byte_pool)
                             App_Startup_Thread_Entry,
                             0,
                             thread_stack,
-                            2 * 1024,
-                            9,  /* Priority 9 (between main and workers) */
-                            9,
+                            STARTUP_THREAD_STACK_SIZE,
+                            STARTUP_THREAD_PRIORITY,
+                            STARTUP_THREAD_PRIORITY,
                             TX_NO_TIME_SLICE,
                             TX_AUTO_START);  /* Auto-start */
   
@@ -208,12 +300,21 @@ static void App_Startup_Thread_Entry(ULONG input)
 {
   (void)input;
   UINT status;
-  TX_QUEUE *audio_queue;
-  TX_QUEUE *feature_queue;
+  SpscRing_t *audio_queue;
+  SpscRing_t *feature_queue;
   ULONG wait_count = 0;
   
   printf("Startup thread running\n");
   
+  /* Map the OSPI asset image (web content + DSP tables); optional, falls back to SD / runtime trig */
+  status = AssetImage_Init();
+  if (status == TX_SUCCESS)
+    printf("Asset image mapped: %lu entries\n", (unsigned long)AssetImage_GetEntryCount());
+  else
+    printf("Asset image not available (0x%02X), using SD card\n", status);
+  
+  AudioFeatures_Init();
+  
   /* Wait for NetX Duo IP address to be assigned (DHCP) - max 60 seconds */
   while (IpAddress == 0 && wait_count < 600)
   {
@@ -241,13 +342,25 @@ static void App_Startup_Thread_Entry(ULONG input)
   }
   printf("Telemetry initialized\n");
   
-  /* Get queue pointers for inter-thread communication */
+  /* iperf client for the latency stress test (optional) */
+  status = Iperf_Init(g_byte_pool, &IpInstance);
+  if (status != TX_SUCCESS)
+    printf("Iperf_Init failed: 0x%02X\n", status);
+  
+  /* SD card history log (optional: telemetry keeps running without it) */
+  status = StagingLog_Init(g_byte_pool);
+  if (status == TX_SUCCESS)
+    status = StagingLog_Start(&sdio_disk);
+  if (status != TX_SUCCESS)
+    printf("Staging log not started: 0x%02X\n", status);
+  
+  /* Get ring pointers for inter-thread communication */
   audio_queue = AudioAcquisition_GetQueue();
   feature_queue = FeatureExtraction_GetOutputQueue();
   
   if (!audio_queue || !feature_queue)
   {
-    printf("ERROR: Could not get queue pointers\n");
+    printf("ERROR: Could not get ring pointers\n");
     Error_Handler();
   }
   
@@ -270,8 +383,8 @@ static void App_Startup_Thread_Entry(ULONG input)
   printf("Feature extraction started\n");
   
   /* Start telemetry transmission (consumes feature_queue) */
-  /* Use broadcast by default (0xFFFFFFFF) */
-  status = Telemetry_Start(feature_queue, 0xFFFFFFFF);
+  /* Default delivery: multicast group of TELEMETRY_FARM_SECTION (app_telemetry.h) */
+  status = Telemetry_Start(feature_queue, 0);
   if (status != TX_SUCCESS)
   {
     printf("Telemetry_Start failed: 0x%02X\n", status);
@@ -284,12 +397,15 @@ static void App_Startup_Thread_Entry(ULONG input)
   printf("  All subsystems initialized successfully\n");
   printf("========================================\n");
   printf("Audio capture -> Feature extraction -> UDP telemetry pipeline ACTIVE\n");
-  printf("  Audio acq thread: Priority 8\n");
-  printf("  Feature extr:    Priority 7\n");
-  printf("  Telemetry TX:    Priority 8\n");
-  printf("  Web server:      Priority 5 (HTTP on port 80)\n");
+  printf("  Audio acq thread: Priority %u\n", (unsigned)AUDIO_ACQ_THREAD_PRIORITY);
+  printf("  Feature extr:    Priority %u\n", (unsigned)FEATURE_EXTRACT_THREAD_PRIORITY);
+  printf("  Telemetry TX:    Priority %u\n", (unsigned)TELEMETRY_THREAD_PRIORITY);
+  printf("  Web server:      Priority %u (HTTP on port %u)\n",
+         (unsigned)NX_WEB_HTTP_SERVER_PRIORITY, (unsigned)CONNECTION_PORT);
   printf("========================================\n\n");
   
+  MemBudget_Print();
+  
   /* Suspend this startup thread - initialization complete */
   tx_thread_suspend(&g_startup_thread);
 }
@@ -0,0 +1,42 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    app_util.c
+  * @author  Wind Turbine Team
+  * @brief   Text helpers shared by the CSV report formatters
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "app_util.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  snprintf into buf at len, clamped to size
+  * @retval New length
+  */
+uint32_t App_Append(char *buf, uint32_t size, uint32_t len, const char *fmt, ...)
+{
+    va_list args;
+    int n;
+
+    if (len + 1U >= size)
+        return len;
+
+    va_start(args, fmt);
+    n = vsnprintf(buf + len, size - len, fmt, args);
+    va_end(args);
+
+    if (n < 0)
+        return len;
+    if ((uint32_t)n >= size - len)
+        return size - 1U;
+
+    return len + (uint32_t)n;
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
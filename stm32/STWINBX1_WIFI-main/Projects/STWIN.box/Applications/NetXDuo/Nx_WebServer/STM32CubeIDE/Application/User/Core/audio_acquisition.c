@@ -14,6 +14,10 @@
 /* Includes ------------------------------------------------------------------*/
 #include "audio_acquisition.h"
 #include "main.h"
+#include "mem_budget.h"
+#include "event_trace.h"
+#include "app_events.h"
+#include "cpu_load.h"
 #include "stm32u5xx_hal_mdf.h"
 
 /* Defines for microphone configuration - must be before STWIN.box_audio.h */
@@ -35,20 +39,32 @@ extern DFSDM_Channel_HandleTypeDef hdfsdm1_channel1;  /* PDM microphone input */
 extern DFSDM_Filter_HandleTypeDef hdfsdm1_filter0;    /* DFSDM filter */
 #endif
 
+/* Each BSP half/full transfer callback leaves N_MS_PER_INTERRUPT ms of mono
+   samples at the start of the record buffer */
+#define AUDIO_ACQ_CHUNK_SAMPLES     ((AUDIO_SAMPLE_RATE / 1000U) * N_MS_PER_INTERRUPT)
+
+_Static_assert((AUDIO_FRAME_SIZE % AUDIO_ACQ_CHUNK_SAMPLES) == 0, "frame must be a whole number of BSP chunks");
+
 /* Private types -------------------------------------------------------------*/
 
 typedef struct
 {
     TX_THREAD              thread;                     /* Thread control block */
-    TX_QUEUE               frame_queue;                /* Queue for audio frames */
+    SpscRing_t             frame_ring;                 /* Frames for feature extraction */
     UINT                   is_active;                  /* Capture active flag */
     uint32_t               frame_count;                /* Frames captured */
     uint32_t               error_count;                /* Error counter */
     
-    /* Double buffering for DMA */
+    /* Double buffering for DMA: the callbacks fill one, the thread reads the other */
     int16_t                dma_buffer_a[AUDIO_FRAME_SIZE];
     int16_t                dma_buffer_b[AUDIO_FRAME_SIZE];
-    uint8_t                current_buffer;             /* 0=A, 1=B */
+    uint8_t                current_buffer;             /* 0=A, 1=B (being filled) */
+    uint32_t               dma_fill;                   /* Samples in the current buffer */
+    volatile uint8_t       frame_pending;              /* Other buffer holds a frame */
+    volatile uint32_t      overrun_count;              /* Frames overwritten before the thread took them */
+    uint32_t               overrun_seen;
+    uint32_t               packet_frames;              /* Frames committed towards the next feature packet */
+    AppEvents_Worker_t     events;                     /* Frame complete, shutdown */
     
     /* Thread stack */
     uint8_t                *thread_stack;
@@ -57,6 +73,7 @@ typedef struct
 
 /* Private variables ---------------------------------------------------------*/
 static AudioAcquisition_Context_t audio_acq_ctx = {0};
+static int16_t audio_record_chunk[AUDIO_ACQ_CHUNK_SAMPLES];  /* BSP record buffer */
 static uint32_t boot_time_ms = 0;
 
 /* Private function prototypes -----------------------------------------------*/
@@ -79,28 +96,31 @@ UINT AudioAcquisition_Init(TX_BYTE_POOL *byte_pool)
     memset(&audio_acq_ctx, 0, sizeof(audio_acq_ctx));
     
     /* Allocate thread stack */
-    status = tx_byte_allocate(byte_pool, 
-                              (VOID **)&audio_acq_ctx.thread_stack,
-                              AUDIO_ACQ_THREAD_STACK_SIZE,
-                              TX_NO_WAIT);
+    status = MemBudget_Allocate(byte_pool,
+                                (VOID **)&audio_acq_ctx.thread_stack,
+                                AUDIO_ACQ_THREAD_STACK_SIZE,
+                                "audio_acq", "thread stack");
     if (status != TX_SUCCESS)
         return status;
     
-    /* Allocate queue storage (4 frames max) */
-    size_t queue_size = AUDIO_ACQ_QUEUE_DEPTH * sizeof(AudioFrame_t);
-    status = tx_byte_allocate(byte_pool,
-                              (VOID **)&audio_acq_ctx.queue_memory,
-                              queue_size,
-                              TX_NO_WAIT);
+    /* Allocate ring storage (4 frames max) */
+    status = MemBudget_Allocate(byte_pool,
+                                (VOID **)&audio_acq_ctx.queue_memory,
+                                SPSC_RING_STORAGE_SIZE(sizeof(AudioFrame_t), AUDIO_ACQ_QUEUE_DEPTH),
+                                "audio_acq", "frame ring");
     if (status != TX_SUCCESS)
         return status;
     
-    /* Create message queue for audio frames */
-    status = tx_queue_create(&audio_acq_ctx.frame_queue,
-                             "Audio Frame Queue",
-                             sizeof(AudioFrame_t) / sizeof(ULONG),
+    /* Frames are converted straight into ring slots, no copy on handoff */
+    status = SpscRing_Create(&audio_acq_ctx.frame_ring,
+                             "Audio Frame Ring",
                              audio_acq_ctx.queue_memory,
-                             queue_size);
+                             sizeof(AudioFrame_t),
+                             AUDIO_ACQ_QUEUE_DEPTH);
+    if (status != TX_SUCCESS)
+        return status;
+    
+    status = AppEvents_Register(&audio_acq_ctx.events, "Audio Events");
     if (status != TX_SUCCESS)
         return status;
     
@@ -119,6 +139,11 @@ UINT AudioAcquisition_Init(TX_BYTE_POOL *byte_pool)
     if (status != TX_SUCCESS)
         return status;
     
+    status = RtSched_Register(RT_SCHED_TASK_AUDIO_ACQ, &audio_acq_ctx.thread,
+                              AUDIO_ACQ_PERIOD_MS, AUDIO_ACQ_BUDGET_US);
+    if (status != TX_SUCCESS)
+        return status;
+    
     audio_acq_ctx.frame_count = 0;
     audio_acq_ctx.error_count = 0;
     audio_acq_ctx.current_buffer = 0;
@@ -155,7 +180,19 @@ UINT AudioAcquisition_Start(void)
         return TX_NOT_DONE;
     }
     
+    /* Half/full transfer interrupts every N_MS_PER_INTERRUPT ms (latency capture reference) */
+    IrqLatency_SetPeriod(CPU_LOAD_ISR_AUDIO_DMA, N_MS_PER_INTERRUPT * 1000U);
+
+    /* Circular DMA from here on; the transfer callbacks assemble the frames */
+    audio_acq_ctx.dma_fill = 0;
+    audio_acq_ctx.frame_pending = 0;
     audio_acq_ctx.is_active = 1;
+    if (BSP_AUDIO_IN_Record(0, (uint8_t *)audio_record_chunk, sizeof(audio_record_chunk)) != BSP_ERROR_NONE)
+    {
+        audio_acq_ctx.error_count++;
+        audio_acq_ctx.is_active = 0;
+        return TX_NOT_DONE;
+    }
     
     /* Resume the acquisition thread */
     status = tx_thread_resume(&audio_acq_ctx.thread);
@@ -164,12 +201,12 @@ UINT AudioAcquisition_Start(void)
 }
 
 /**
-  * @brief  Get audio frame queue pointer
-  * @retval TX_QUEUE* or NULL
+  * @brief  Get audio frame ring pointer
+  * @retval SpscRing_t* or NULL
   */
-TX_QUEUE* AudioAcquisition_GetQueue(void)
+SpscRing_t* AudioAcquisition_GetQueue(void)
 {
-    return audio_acq_ctx.thread_stack ? &audio_acq_ctx.frame_queue : NULL;
+    return audio_acq_ctx.thread_stack ? &audio_acq_ctx.frame_ring : NULL;
 }
 
 /**
@@ -205,15 +242,18 @@ uint32_t AudioAcquisition_GetErrorCount(void)
   * @retval None
   * 
   * This thread:
-  * 1. Captures audio frames using BSP audio functions
-  * 2. Converts raw audio data to PCM16
+  * 1. Sleeps until the DMA callbacks complete a frame (every 32 ms)
+  * 2. Converts the completed buffer into a ring slot
   * 3. Queues completed frames for feature extraction
   */
 static void AudioAcquisition_ThreadEntry(ULONG thread_input)
 {
     (void)thread_input;
-    AudioFrame_t frame;
-    uint8_t audio_buffer[AUDIO_FRAME_SIZE * 2];  /* 16-bit samples = 2 bytes per sample */
+    TX_INTERRUPT_SAVE_AREA
+    AudioFrame_t *frame;
+    const int16_t *samples;
+    uint8_t pending;
+    ULONG events;
     
     while (1)
     {
@@ -223,77 +263,139 @@ static void AudioAcquisition_ThreadEntry(ULONG thread_input)
             continue;
         }
         
-        /* Capture one frame of audio data */
-        /* AUDIO_FRAME_SIZE = 512 samples, each sample is 16-bit = 1024 bytes */
-        if (BSP_AUDIO_IN_Record(0, audio_buffer, AUDIO_FRAME_SIZE * 2) != BSP_ERROR_NONE)
+        events = AppEvents_Wait(&audio_acq_ctx.events, TX_WAIT_FOREVER);
+        if (events & APP_EVENT_SHUTDOWN)
+        {
+            BSP_AUDIO_IN_Stop(0);
+            audio_acq_ctx.is_active = 0;
+            continue;
+        }
+        
+        /* Frames the thread was too late for were overwritten by the DMA side */
+        while (audio_acq_ctx.overrun_seen != audio_acq_ctx.overrun_count)
+        {
+            audio_acq_ctx.overrun_seen++;
+            audio_acq_ctx.error_count++;
+            RtSched_Skip(RT_SCHED_TASK_AUDIO_ACQ);
+            EventTrace_FrameDrop(audio_acq_ctx.frame_count++);
+        }
+        
+        /* Take the completed buffer; the callbacks now fill the other one */
+        TX_DISABLE
+        pending = audio_acq_ctx.frame_pending;
+        audio_acq_ctx.frame_pending = 0;
+        samples = audio_acq_ctx.current_buffer ? audio_acq_ctx.dma_buffer_a : audio_acq_ctx.dma_buffer_b;
+        TX_RESTORE
+        
+        if (!pending)
+            continue;
+        
+        /* Fill the next ring slot in place (non-blocking, drop if full) */
+        frame = SpscRing_Reserve(&audio_acq_ctx.frame_ring);
+        if (!frame)
         {
+            /* Ring full: frame dropped, increment error counter */
             audio_acq_ctx.error_count++;
-            tx_thread_sleep(32);  /* Wait before retry */
+            EventTrace_FrameDrop(audio_acq_ctx.frame_count++);
+            RtSched_Complete(RT_SCHED_TASK_AUDIO_ACQ);
             continue;
         }
         
         /* Prepare frame message */
-        memset(&frame, 0, sizeof(frame));
-        frame.frame_number = audio_acq_ctx.frame_count++;
-        frame.error_flags = 0;
+        memset(frame, 0, sizeof(*frame));
+        frame->frame_number = audio_acq_ctx.frame_count++;
+        frame->error_flags = 0;
         
         /* Calculate relative timestamp in milliseconds */
         uint32_t ticks_elapsed = tx_time_get() - boot_time_ms;
         /* ThreadX tick rate: typically 1000 ticks/sec = 1ms per tick */
-        frame.timestamp_ms = ticks_elapsed;  /* Adjust based on actual tick rate */
+        frame->timestamp_ms = ticks_elapsed;  /* Adjust based on actual tick rate */
         
-        /* Convert raw audio buffer to int16_t samples */
-        for (uint32_t i = 0; i < AUDIO_FRAME_SIZE; i++)
-        {
-            /* BSP returns data as uint8_t array, convert to int16_t */
-            frame.samples[i] = (int16_t)((audio_buffer[i*2+1] << 8) | audio_buffer[i*2]);
-        }
+        /* Copy the PCM16 samples (the BSP already converted and filtered them) */
+        memcpy(frame->samples, samples, sizeof(frame->samples));
         
         /* Check for errors (clipping detection) */
         for (uint32_t i = 0; i < AUDIO_FRAME_SIZE; i++)
         {
-            if (frame.samples[i] == INT16_MIN || frame.samples[i] == INT16_MAX)
+            if (frame->samples[i] == INT16_MIN || frame->samples[i] == INT16_MAX)
             {
-                frame.error_flags |= AUDIO_ACQ_ERROR_CLIPPING;
+                frame->error_flags |= AUDIO_ACQ_ERROR_CLIPPING;
                 break;
             }
         }
         
-        if (frame.error_flags)
+        if (frame->error_flags)
         {
             audio_acq_ctx.error_count++;
         }
         
-        /* Send frame to feature extraction queue (non-blocking, drop if full) */
-        UINT status = tx_queue_send(&audio_acq_ctx.frame_queue,
-                                    (VOID *)&frame,
-                                    TX_NO_WAIT);
-        
-        if (status != TX_SUCCESS)
+        /* Hand the frame to feature extraction; every AUDIO_FRAMES_PER_PACKET
+           committed frames make one feature job */
+        SpscRing_Commit(&audio_acq_ctx.frame_ring);
+        RtSched_Complete(RT_SCHED_TASK_AUDIO_ACQ);
+        if (++audio_acq_ctx.packet_frames == AUDIO_FRAMES_PER_PACKET)
         {
-            /* Queue full: frame dropped, increment error counter */
-            audio_acq_ctx.error_count++;
+            audio_acq_ctx.packet_frames = 0;
+            RtSched_Release(RT_SCHED_TASK_FEATURE);
         }
-        
-        /* Frame rate: 512 samples @ 16kHz = 32ms per frame */
-        /* Small delay to prevent busy-waiting */
-        tx_thread_sleep(1);
     }
 }
 
 /**
-  * @brief  DMA completion callback (called from HAL_DFSDM_FilterRegularConvCpltCallback)
+  * @brief  DMA chunk callback (BSP half/full transfer, interrupt context)
   * @retval None
   * 
-  * Called by HAL when DMA transfer completes (half or full)
+  * Appends the chunk the BSP just wrote to the buffer being filled. Every
+  * AUDIO_FRAME_SIZE samples the buffers are swapped and the thread is woken,
+  * so it runs once per 32 ms frame instead of polling.
   */
-__attribute__((unused)) void AudioAcquisition_DMA_Complete_Callback(void)
+static void AudioAcquisition_DMA_Complete_Callback(void)
 {
+    int16_t *buf = audio_acq_ctx.current_buffer ? audio_acq_ctx.dma_buffer_b : audio_acq_ctx.dma_buffer_a;
+    
+    if (!audio_acq_ctx.is_active)
+        return;
+    
+    memcpy(&buf[audio_acq_ctx.dma_fill], audio_record_chunk, sizeof(audio_record_chunk));
+    audio_acq_ctx.dma_fill += AUDIO_ACQ_CHUNK_SAMPLES;
+    if (audio_acq_ctx.dma_fill < AUDIO_FRAME_SIZE)
+        return;
+    
     /* Switch buffer pointers for next DMA transfer */
+    if (audio_acq_ctx.frame_pending)
+        audio_acq_ctx.overrun_count++;
+    audio_acq_ctx.frame_pending = 1;
     audio_acq_ctx.current_buffer = (audio_acq_ctx.current_buffer == 0) ? 1 : 0;
+    audio_acq_ctx.dma_fill = 0;
     
-    /* Wake up acquisition thread (in real impl, set event/semaphore) */
-    /* This is handled by ThreadX scheduler automatically when buffer is filled */
+    RtSched_Release(RT_SCHED_TASK_AUDIO_ACQ);
+    AppEvents_Post(&audio_acq_ctx.events, APP_EVENT_DATA_READY);
+}
+
+/**
+  * @brief  BSP record buffer callbacks (weak in STWIN.box_audio.c)
+  * @param  Instance: audio instance
+  * @retval None
+  */
+void BSP_AUDIO_IN_HalfTransfer_CallBack(uint32_t Instance)
+{
+    (void)Instance;
+    AudioAcquisition_DMA_Complete_Callback();
+}
+
+void BSP_AUDIO_IN_TransferComplete_CallBack(uint32_t Instance)
+{
+    (void)Instance;
+    AudioAcquisition_DMA_Complete_Callback();
+}
+
+/**
+  * @brief  Microphone DMA interrupt (GPDMA1_Channel1), called from stm32u5xx_it.c
+  * @retval None
+  */
+void AudioAcquisition_DMA_IRQHandler(void)
+{
+    BSP_AUDIO_IN_IRQHandler(0, ONBOARD_DIGITAL_MIC_MASK);
 }
 
 /**
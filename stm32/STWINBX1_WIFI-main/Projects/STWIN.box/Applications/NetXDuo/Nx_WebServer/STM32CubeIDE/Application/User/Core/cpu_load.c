@@ -0,0 +1,335 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    cpu_load.c
+  * @author  Wind Turbine Team
+  * @brief   Per-thread and per-ISR CPU load from the ThreadX execution profile
+  ******************************************************************************
+  * The sample timer runs in the ThreadX timer thread. It reads every
+  * thread's execution time, the kit's ISR total and the per-source ISR
+  * counters with interrupts disabled, so one window is consistent. The ISR
+  * totals are reset; the thread totals are not (other modules difference
+  * them too), so the window is the difference to the previous sample. The
+  * time the timer thread itself is spending in the sample is charged to the
+  * next window.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "cpu_load.h"
+#include "app_util.h"
+#include "slab_alloc.h"
+#include "timer_wheel.h"
+#include "tx_thread.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define CPU_LOAD_PERMILLE(cycles, window)   ((window) ? (uint32_t)(((uint64_t)(cycles) * 1000U) / (window)) : 0U)
+
+_Static_assert(CPU_LOAD_REPORT_SIZE <= SLAB_MAX_BLOCK_SIZE, "report does not fit the largest slab class");
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    uint32_t               cycles;
+    uint32_t               count;
+} CpuLoad_IsrCounter_t;
+
+typedef struct
+{
+    const CHAR            *name;
+    uint32_t               cycles;
+} CpuLoad_ThreadLoad_t;
+
+typedef struct
+{
+    TX_THREAD             *thread;
+    EXECUTION_TIME         total;                      /* Profile kit total at the last sample */
+} CpuLoad_ThreadMark_t;
+
+typedef struct
+{
+    /* Running counters, written by the ISR wrappers */
+    volatile CpuLoad_IsrCounter_t isr_running[CPU_LOAD_ISR_COUNT];
+
+    /* Last complete window */
+    CpuLoad_ThreadLoad_t   threads[CPU_LOAD_MAX_THREADS];
+    uint32_t               thread_count;
+    CpuLoad_IsrCounter_t   isr[CPU_LOAD_ISR_COUNT];
+    uint32_t               isr_total_cycles;           /* All interrupts, from the profile kit */
+    uint64_t               isr_cycles_closed;          /* All interrupts, windows before the current one */
+    uint32_t               window_ms;
+    uint64_t               window_cycles;
+
+    /* Thread totals at the last two samples (current window = difference) */
+    CpuLoad_ThreadMark_t   marks[2][CPU_LOAD_MAX_THREADS];
+    uint32_t               mark_count[2];
+    uint32_t               mark_set;                   /* marks[] index of the last sample */
+
+    ULONG                  window_start;               /* tx_time_get() at the last sample */
+    TimerWheel_Timer_t     sample_timer;
+} CpuLoad_Context_t;
+
+/* Private variables ---------------------------------------------------------*/
+static CpuLoad_Context_t load_ctx = {0};
+
+static const char *const cpu_load_isr_names[CPU_LOAD_ISR_COUNT] =
+{
+    "wifi notify",
+    "exti15",
+    "hal tick",
+    "sd",
+    "wifi flow",
+    "low power",
+    "wifi dma",
+    "wifi spi",
+    "thread metric",
+    "audio dma",
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static void CpuLoad_SampleTimer(ULONG input);
+
+/**
+  * @brief  Start the DWT cycle counter and the sampling timer
+  * @retval TX_SUCCESS or error code
+  */
+UINT CpuLoad_Init(void)
+{
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+    /* TX_EXECUTION_TIME_SOURCE reads CYCCNT, which is off until a debugger enables it */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    load_ctx.window_start = tx_time_get();
+
+    /* The window is measured in ticks, so the wheel slack only moves its edges */
+    TimerWheel_Create(&load_ctx.sample_timer, "CPU Load Sample", CpuLoad_SampleTimer, 0);
+    return TimerWheel_Start(&load_ctx.sample_timer,
+                            CPU_LOAD_SAMPLE_MS,
+                            CPU_LOAD_SAMPLE_MS,
+                            TIMER_WHEEL_SLACK(CPU_LOAD_SAMPLE_MS));
+#else
+    return TX_FEATURE_NOT_ENABLED;
+#endif
+}
+
+/**
+  * @brief  Charge cycles to an interrupt source
+  * @param  isr: CpuLoad_Isr_t
+  * @param  cycles: DWT cycles spent in the handler
+  * @retval None
+  */
+void CpuLoad_IsrAccount(CpuLoad_Isr_t isr, uint32_t cycles)
+{
+    if ((uint32_t)isr >= CPU_LOAD_ISR_COUNT)
+        return;
+
+    load_ctx.isr_running[isr].cycles += cycles;
+    load_ctx.isr_running[isr].count++;
+}
+
+/**
+  * @brief  Format the last window as CSV lines
+  * @param  buf: output buffer
+  * @param  size: buffer size
+  * @retval Number of characters written (excluding terminator)
+  */
+uint32_t CpuLoad_Format(char *buf, uint32_t size)
+{
+    CpuLoad_ThreadLoad_t threads[CPU_LOAD_MAX_THREADS];
+    CpuLoad_IsrCounter_t isr[CPU_LOAD_ISR_COUNT];
+    uint32_t thread_count;
+    uint32_t isr_total;
+    uint32_t isr_named = 0;
+    uint32_t window_ms;
+    uint64_t window;
+    uint64_t busy = 0;
+    uint32_t len = 0;
+    TX_INTERRUPT_SAVE_AREA
+
+    if (!buf || size == 0U)
+        return 0;
+    buf[0] = '\0';
+
+    /* Snapshot so the timer cannot replace the window halfway through */
+    TX_DISABLE
+    thread_count = load_ctx.thread_count;
+    memcpy(threads, load_ctx.threads, thread_count * sizeof(threads[0]));
+    memcpy(isr, load_ctx.isr, sizeof(isr));
+    isr_total = load_ctx.isr_total_cycles;
+    window_ms = load_ctx.window_ms;
+    window = load_ctx.window_cycles;
+    TX_RESTORE
+
+    len = App_Append(buf, size, len, "window,%lu,%lu\n",
+                     (unsigned long)window_ms, (unsigned long)SystemCoreClock);
+
+    for (uint32_t i = 0; i < thread_count; i++)
+    {
+        len = App_Append(buf, size, len, "thread,%s,%lu,%lu\n",
+                         threads[i].name ? threads[i].name : "?",
+                         (unsigned long)CPU_LOAD_PERMILLE(threads[i].cycles, window),
+                         (unsigned long)threads[i].cycles);
+        busy += threads[i].cycles;
+    }
+
+    for (uint32_t i = 0; i < CPU_LOAD_ISR_COUNT; i++)
+    {
+        len = App_Append(buf, size, len, "isr,%s,%lu,%lu,%lu\n",
+                         cpu_load_isr_names[i],
+                         (unsigned long)CPU_LOAD_PERMILLE(isr[i].cycles, window),
+                         (unsigned long)isr[i].cycles, (unsigned long)isr[i].count);
+        isr_named += isr[i].cycles;
+    }
+
+    /* Gross per-source times can exceed the kit's net total under nesting */
+    if (isr_named > isr_total)
+        isr_named = isr_total;
+    len = App_Append(buf, size, len, "isr,other,%lu,%lu,0\n",
+                     (unsigned long)CPU_LOAD_PERMILLE(isr_total - isr_named, window),
+                     (unsigned long)(isr_total - isr_named));
+    busy += isr_total;
+
+    len = App_Append(buf, size, len, "idle,%lu\n",
+                     (unsigned long)(busy < window ? CPU_LOAD_PERMILLE(window - busy, window) : 0U));
+
+    return len;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Close the current window (ThreadX timer callback)
+  * @param  input: unused
+  * @retval None
+  */
+static void CpuLoad_SampleTimer(ULONG input)
+{
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+    TX_THREAD *thread_ptr;
+    ULONG count;
+    ULONG now;
+    EXECUTION_TIME time;
+    const CpuLoad_ThreadMark_t *prev;
+    CpuLoad_ThreadMark_t *next;
+    uint32_t prev_count;
+    TX_INTERRUPT_SAVE_AREA
+
+    (void)input;
+
+    TX_DISABLE
+
+    now = tx_time_get();
+    load_ctx.window_ms = (uint32_t)((now - load_ctx.window_start) * 1000U / TX_TIMER_TICKS_PER_SECOND);
+    load_ctx.window_cycles = (uint64_t)load_ctx.window_ms * (SystemCoreClock / 1000U);
+    load_ctx.window_start = now;
+
+    load_ctx.thread_count = 0;
+    prev = load_ctx.marks[load_ctx.mark_set];
+    prev_count = load_ctx.mark_count[load_ctx.mark_set];
+    next = load_ctx.marks[load_ctx.mark_set ^ 1U];
+    thread_ptr = _tx_thread_created_ptr;
+    count = _tx_thread_created_count;
+    while (count-- > 0 && thread_ptr)
+    {
+        EXECUTION_TIME mark = 0;
+
+        _tx_execution_thread_time_get(thread_ptr, &time);
+        for (uint32_t i = 0; i < prev_count; i++)
+        {
+            if (prev[i].thread == thread_ptr)
+            {
+                mark = prev[i].total;
+                break;
+            }
+        }
+
+        /* Threads past the table are not reported; a recreated thread starts again from 0 */
+        if (load_ctx.thread_count < CPU_LOAD_MAX_THREADS)
+        {
+            next[load_ctx.thread_count].thread = thread_ptr;
+            next[load_ctx.thread_count].total = time;
+            load_ctx.threads[load_ctx.thread_count].name = thread_ptr->tx_thread_name;
+            load_ctx.threads[load_ctx.thread_count].cycles = (uint32_t)((time >= mark) ? time - mark : time);
+            load_ctx.thread_count++;
+        }
+
+        thread_ptr = thread_ptr->tx_thread_created_next;
+    }
+    load_ctx.mark_set ^= 1U;
+    load_ctx.mark_count[load_ctx.mark_set] = load_ctx.thread_count;
+
+    _tx_execution_isr_time_get(&time);
+    _tx_execution_isr_time_reset();
+    load_ctx.isr_total_cycles = (uint32_t)time;
+    load_ctx.isr_cycles_closed += time;
+
+    /* Idle is derived from the window: CYCCNT does not count while the core sleeps */
+    _tx_execution_idle_time_reset();
+
+    for (uint32_t i = 0; i < CPU_LOAD_ISR_COUNT; i++)
+    {
+        load_ctx.isr[i].cycles = load_ctx.isr_running[i].cycles;
+        load_ctx.isr[i].count = load_ctx.isr_running[i].count;
+        load_ctx.isr_running[i].cycles = 0;
+        load_ctx.isr_running[i].count = 0;
+    }
+
+    TX_RESTORE
+#else
+    (void)input;
+#endif
+}
+
+/**
+  * @brief  Cycles used by threads and interrupts so far
+  * @retval Cycles, 0 without the execution profile
+  */
+uint64_t CpuLoad_GetBusyCycles(void)
+{
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+    TX_THREAD *thread_ptr;
+    ULONG count;
+    EXECUTION_TIME time;
+    uint64_t busy;
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+
+    _tx_execution_isr_time_get(&time);
+    busy = load_ctx.isr_cycles_closed + time;
+
+    thread_ptr = _tx_thread_created_ptr;
+    count = _tx_thread_created_count;
+    while (count-- > 0 && thread_ptr)
+    {
+        _tx_execution_thread_time_get(thread_ptr, &time);
+        busy += time;
+        thread_ptr = thread_ptr->tx_thread_created_next;
+    }
+
+    TX_RESTORE
+
+    return busy;
+#else
+    return 0;
+#endif
+}
+
+/**
+  * @brief  Report name of an interrupt source
+  * @param  isr: CpuLoad_Isr_t
+  * @retval Name, "?" if out of range
+  */
+const char *CpuLoad_IsrName(CpuLoad_Isr_t isr)
+{
+    if ((uint32_t)isr >= CPU_LOAD_ISR_COUNT)
+        return "?";
+
+    return cpu_load_isr_names[isr];
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
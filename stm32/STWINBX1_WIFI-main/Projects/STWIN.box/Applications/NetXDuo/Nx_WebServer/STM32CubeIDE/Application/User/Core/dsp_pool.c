@@ -0,0 +1,321 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    dsp_pool.c
+  * @author  Wind Turbine Team
+  * @brief   Work-stealing fork/join pool for independent DSP jobs
+  ******************************************************************************
+  * Each deque is a slot array plus one 32-bit state word {generation, top,
+  * bottom}. Jobs are only added by DspPool_Run() while the deques are empty,
+  * before the word is published, so while a batch runs the word only
+  * shrinks: the owner takes slot bottom-1 and thieves take slot top, both by
+  * compare-and-swap of the whole word. A thief that read a word from an
+  * earlier batch cannot win its CAS because the generation moved on, which
+  * keeps this lock-free without the Chase-Lev growth and fence rules.
+  *
+  * pending counts unfinished jobs. The caller drains its own deque, steals,
+  * and only sleeps on DSP_POOL_DONE if a worker still holds the last jobs;
+  * the worker that finishes the last one sets it.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dsp_pool.h"
+#include "mem_budget.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define DSP_POOL_PARTICIPANTS           (DSP_POOL_WORKERS + 1)     /* [0] is the caller */
+#define DSP_POOL_DONE                   0x1U
+
+#define DSP_POOL_STATE(gen, top, bottom)    (((uint32_t)(gen) << 16) | ((uint32_t)(top) << 8) | (uint32_t)(bottom))
+#define DSP_POOL_STATE_TOP(state)           (((state) >> 8) & 0xFFU)
+#define DSP_POOL_STATE_BOTTOM(state)        ((state) & 0xFFU)
+#define DSP_POOL_STATE_ONE_TOP              (1U << 8)
+
+#define DSP_LOAD_ACQUIRE(p)             __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define DSP_STORE_RELEASE(p, v)         __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define DSP_CAS(p, expected, desired)   __atomic_compare_exchange_n((p), (expected), (desired), 0, \
+                                                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+_Static_assert(DSP_POOL_MAX_JOBS <= 0xFF, "top/bottom are 8-bit fields of the deque state");
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    volatile uint32_t      state __attribute__((aligned(DSP_POOL_CACHE_LINE)));
+    uint32_t               jobs;                       /* Written by the owner only */
+    uint32_t               steals;
+    DspPool_Job_t          slots[DSP_POOL_MAX_JOBS];
+} DspPool_Deque_t;
+
+typedef struct
+{
+    DspPool_Deque_t        deques[DSP_POOL_PARTICIPANTS];
+#if DSP_POOL_WORKERS > 0
+    TX_THREAD              threads[DSP_POOL_WORKERS];
+    uint8_t               *stacks[DSP_POOL_WORKERS];
+#endif
+    TX_EVENT_FLAGS_GROUP   start;                      /* One flag per worker */
+    TX_EVENT_FLAGS_GROUP   done;
+    volatile uint32_t      pending;                    /* Jobs of the batch not finished */
+    uint32_t               generation;
+    UINT                   created;                    /* Worker threads */
+    UINT                   active;                     /* Workers that get jobs */
+    uint32_t               batches;
+    uint32_t               waits;
+} DspPool_Context_t;
+
+/* Private variables ---------------------------------------------------------*/
+static DspPool_Context_t dsp_pool_ctx = {0};
+
+/* Private function prototypes -----------------------------------------------*/
+static int DspPool_Pop(DspPool_Deque_t *deque, DspPool_Job_t *job);
+static int DspPool_Steal(DspPool_Deque_t *deque, DspPool_Job_t *job);
+static void DspPool_Drain(UINT participant);
+#if DSP_POOL_WORKERS > 0
+static void DspPool_WorkerEntry(ULONG thread_input);
+#endif
+
+/**
+  * @brief  Create the worker threads
+  * @param  byte_pool: ThreadX byte pool for the worker stacks
+  * @param  workers: helper threads, 0 .. DSP_POOL_WORKERS
+  * @param  priority: worker priority
+  * @retval TX_SUCCESS or error code
+  */
+UINT DspPool_Init(TX_BYTE_POOL *byte_pool, UINT workers, UINT priority)
+{
+    UINT status;
+
+    if (workers > DSP_POOL_WORKERS)
+        return TX_SIZE_ERROR;
+
+    memset(&dsp_pool_ctx, 0, sizeof(dsp_pool_ctx));
+    if (workers == 0)
+        return TX_SUCCESS;
+
+#if DSP_POOL_WORKERS > 0
+    if (!byte_pool)
+        return TX_PTR_ERROR;
+
+    status = tx_event_flags_create(&dsp_pool_ctx.start, "DSP Pool Start");
+    if (status != TX_SUCCESS)
+        return status;
+    status = tx_event_flags_create(&dsp_pool_ctx.done, "DSP Pool Done");
+    if (status != TX_SUCCESS)
+        return status;
+
+    for (UINT i = 0; i < workers; i++)
+    {
+        status = MemBudget_Allocate(byte_pool, (VOID **)&dsp_pool_ctx.stacks[i],
+                                    DSP_POOL_STACK_SIZE, "dsp pool", "worker stack");
+        if (status != TX_SUCCESS)
+            return status;
+
+        status = tx_thread_create(&dsp_pool_ctx.threads[i], "DSP Worker", DspPool_WorkerEntry, i,
+                                  dsp_pool_ctx.stacks[i], DSP_POOL_STACK_SIZE,
+                                  priority, priority, TX_NO_TIME_SLICE, TX_DONT_START);
+        if (status != TX_SUCCESS)
+            return status;
+
+        /* Worker i lives on core i+1; the caller keeps whatever core it runs on */
+        status = tx_thread_smp_core_exclude(&dsp_pool_ctx.threads[i],
+                                            TX_THREAD_SMP_CORE_MASK & ~(1UL << ((i + 1) % TX_THREAD_SMP_MAX_CORES)));
+        if (status != TX_SUCCESS)
+            return status;
+
+        status = tx_thread_resume(&dsp_pool_ctx.threads[i]);
+        if (status != TX_SUCCESS)
+            return status;
+
+        dsp_pool_ctx.created++;
+    }
+    dsp_pool_ctx.active = dsp_pool_ctx.created;
+#else
+    (void)byte_pool;
+    (void)priority;
+    (void)status;
+#endif
+
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Use fewer of the created workers
+  * @param  workers: 0 .. created workers
+  * @retval TX_SUCCESS or TX_SIZE_ERROR
+  */
+UINT DspPool_SetActiveWorkers(UINT workers)
+{
+    if (workers > dsp_pool_ctx.created)
+        return TX_SIZE_ERROR;
+
+    dsp_pool_ctx.active = workers;
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Run a batch of jobs to completion
+  * @param  jobs: jobs
+  * @param  count: 1 .. DSP_POOL_MAX_JOBS
+  * @retval TX_SUCCESS or error code
+  */
+UINT DspPool_Run(const DspPool_Job_t *jobs, uint32_t count)
+{
+    UINT participants = dsp_pool_ctx.active + 1;
+    uint32_t gen;
+    ULONG actual;
+
+    if (!jobs)
+        return TX_PTR_ERROR;
+    if (count == 0 || count > DSP_POOL_MAX_JOBS)
+        return TX_SIZE_ERROR;
+
+    /* Every deque is empty here: the previous batch ran to completion */
+    for (uint32_t i = 0; i < count; i++)
+        dsp_pool_ctx.deques[i % participants].slots[i / participants] = jobs[i];
+
+    if (dsp_pool_ctx.active)
+        tx_event_flags_set(&dsp_pool_ctx.done, ~DSP_POOL_DONE, TX_AND);
+
+    DSP_STORE_RELEASE(&dsp_pool_ctx.pending, count);
+
+    gen = ++dsp_pool_ctx.generation & 0xFFFFU;
+    for (UINT p = 0; p < participants; p++)
+    {
+        uint32_t n = count / participants + ((p < count % participants) ? 1U : 0U);
+
+        DSP_STORE_RELEASE(&dsp_pool_ctx.deques[p].state, DSP_POOL_STATE(gen, 0, n));
+    }
+
+    if (dsp_pool_ctx.active)
+        tx_event_flags_set(&dsp_pool_ctx.start, (1UL << dsp_pool_ctx.active) - 1U, TX_OR);
+
+    DspPool_Drain(0);
+
+    /* A stale DONE from the last batch only costs one extra pass here */
+    while (DSP_LOAD_ACQUIRE(&dsp_pool_ctx.pending) != 0)
+    {
+        dsp_pool_ctx.waits++;
+        tx_event_flags_get(&dsp_pool_ctx.done, DSP_POOL_DONE, TX_OR_CLEAR, &actual, TX_WAIT_FOREVER);
+    }
+
+    dsp_pool_ctx.batches++;
+    return TX_SUCCESS;
+}
+
+/**
+  * @brief  Get counters
+  * @param  stats: output
+  * @retval None
+  */
+void DspPool_GetStats(DspPool_Stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->workers = dsp_pool_ctx.active;
+    stats->batches = dsp_pool_ctx.batches;
+    stats->waits = dsp_pool_ctx.waits;
+    for (UINT p = 0; p < DSP_POOL_PARTICIPANTS; p++)
+    {
+        stats->jobs += dsp_pool_ctx.deques[p].jobs;
+        stats->steals += dsp_pool_ctx.deques[p].steals;
+    }
+}
+
+/**
+  * @brief  Take the newest job of the own deque
+  * @param  deque: own deque
+  * @param  job: output
+  * @retval 1 if a job was taken
+  */
+static int DspPool_Pop(DspPool_Deque_t *deque, DspPool_Job_t *job)
+{
+    uint32_t state = DSP_LOAD_ACQUIRE(&deque->state);
+
+    while (DSP_POOL_STATE_TOP(state) < DSP_POOL_STATE_BOTTOM(state))
+    {
+        *job = deque->slots[DSP_POOL_STATE_BOTTOM(state) - 1];
+        if (DSP_CAS(&deque->state, &state, state - 1))
+            return 1;
+    }
+
+    return 0;
+}
+
+/**
+  * @brief  Take the oldest job of another participant's deque
+  * @param  deque: victim deque
+  * @param  job: output
+  * @retval 1 if a job was taken
+  */
+static int DspPool_Steal(DspPool_Deque_t *deque, DspPool_Job_t *job)
+{
+    uint32_t state = DSP_LOAD_ACQUIRE(&deque->state);
+
+    while (DSP_POOL_STATE_TOP(state) < DSP_POOL_STATE_BOTTOM(state))
+    {
+        *job = deque->slots[DSP_POOL_STATE_TOP(state)];
+        if (DSP_CAS(&deque->state, &state, state + DSP_POOL_STATE_ONE_TOP))
+            return 1;
+    }
+
+    return 0;
+}
+
+/**
+  * @brief  Run jobs until no deque has any left
+  * @param  participant: 0 for the caller, worker index + 1
+  * @retval None
+  */
+static void DspPool_Drain(UINT participant)
+{
+    DspPool_Deque_t *own = &dsp_pool_ctx.deques[participant];
+    UINT participants = dsp_pool_ctx.active + 1;
+    DspPool_Job_t job = {0};
+    UINT victim = 1;
+
+    while (1)
+    {
+        if (!DspPool_Pop(own, &job))
+        {
+            for (victim = 1; victim < participants; victim++)
+            {
+                if (DspPool_Steal(&dsp_pool_ctx.deques[(participant + victim) % participants], &job))
+                    break;
+            }
+            if (victim == participants)
+                return;
+            own->steals++;
+        }
+
+        job.fn(job.arg);
+        own->jobs++;
+
+        if (__atomic_sub_fetch(&dsp_pool_ctx.pending, 1U, __ATOMIC_ACQ_REL) == 0 && participant != 0)
+            tx_event_flags_set(&dsp_pool_ctx.done, DSP_POOL_DONE, TX_OR);
+    }
+}
+
+#if DSP_POOL_WORKERS > 0
+/**
+  * @brief  Worker thread: sleep until a batch starts, then help drain it
+  * @param  thread_input: worker index
+  * @retval None
+  */
+static void DspPool_WorkerEntry(ULONG thread_input)
+{
+    ULONG actual;
+
+    while (1)
+    {
+        tx_event_flags_get(&dsp_pool_ctx.start, 1UL << thread_input, TX_OR_CLEAR, &actual, TX_WAIT_FOREVER);
+
+        /* A worker that wakes after the batch is done finds nothing and sleeps again */
+        DspPool_Drain((UINT)thread_input + 1);
+    }
+}
+#endif
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
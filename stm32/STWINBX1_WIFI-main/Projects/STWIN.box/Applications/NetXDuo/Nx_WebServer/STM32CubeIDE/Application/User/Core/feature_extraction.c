@@ -7,25 +7,33 @@
   ******************************************************************************
   * Receives audio frames from acquisition, aggregates AUDIO_FRAMES_PER_PACKET
   * frames, computes RMS/FFT/ZCR/SPL, and outputs AudioTelemetryPacket_t
+  *
+  * The per-packet DSP runs as independent jobs on the DSP pool
+  * (feature_jobs.c); this thread takes part in every batch, and on a single
+  * core it is the only participant.
   */
 /* USER CODE END Header */
 
 /* Includes ------------------------------------------------------------------*/
 #include "feature_extraction.h"
 #include "main.h"
+#include "mem_budget.h"
+#include "app_events.h"
+#include "dsp_pool.h"
+#include "feature_jobs.h"
 #include <string.h>
 #include <stdio.h>
 
 /* Private defines -----------------------------------------------------------*/
-#define FEATURE_EXTRACT_QUEUE_DEPTH   2  /* 2 completed packets can wait */
 
 /* Private types -------------------------------------------------------------*/
 
 typedef struct
 {
     TX_THREAD              thread;                     /* Thread control block */
-    TX_QUEUE              *input_queue;                /* From audio acquisition */
-    TX_QUEUE               output_queue;               /* To telemetry sender */
+    SpscRing_t            *input_ring;                 /* From audio acquisition */
+    SpscRing_t             output_ring;                /* To telemetry sender */
+    AppEvents_Worker_t     events;                     /* Input data ready, shutdown */
     UINT                   is_running;                 /* Thread active flag */
     uint32_t               packet_count;               /* Packets generated */
     uint32_t               error_count;                /* Processing errors */
@@ -64,28 +72,37 @@ UINT FeatureExtraction_Init(TX_BYTE_POOL *byte_pool)
     memset(&feature_ctx, 0, sizeof(feature_ctx));
     
     /* Allocate thread stack */
-    status = tx_byte_allocate(byte_pool,
-                              (VOID **)&feature_ctx.thread_stack,
-                              FEATURE_EXTRACT_THREAD_STACK_SIZE,
-                              TX_NO_WAIT);
+    status = MemBudget_Allocate(byte_pool,
+                                (VOID **)&feature_ctx.thread_stack,
+                                FEATURE_EXTRACT_THREAD_STACK_SIZE,
+                                "feature", "thread stack");
     if (status != TX_SUCCESS)
         return status;
     
-    /* Allocate output queue storage */
-    size_t queue_size = FEATURE_EXTRACT_QUEUE_DEPTH * sizeof(AudioTelemetryPacket_t);
-    status = tx_byte_allocate(byte_pool,
-                              (VOID **)&feature_ctx.queue_memory,
-                              queue_size,
-                              TX_NO_WAIT);
+    /* Allocate output ring storage */
+    status = MemBudget_Allocate(byte_pool,
+                                (VOID **)&feature_ctx.queue_memory,
+                                SPSC_RING_STORAGE_SIZE(sizeof(AudioTelemetryPacket_t),
+                                                       FEATURE_EXTRACT_QUEUE_DEPTH),
+                                "feature", "packet ring");
     if (status != TX_SUCCESS)
         return status;
     
-    /* Create output queue for telemetry packets */
-    status = tx_queue_create(&feature_ctx.output_queue,
-                             "Feature Output Queue",
-                             sizeof(AudioTelemetryPacket_t) / sizeof(ULONG),
+    /* Create output ring for telemetry packets */
+    status = SpscRing_Create(&feature_ctx.output_ring,
+                             "Feature Output Ring",
                              feature_ctx.queue_memory,
-                             queue_size);
+                             sizeof(AudioTelemetryPacket_t),
+                             FEATURE_EXTRACT_QUEUE_DEPTH);
+    if (status != TX_SUCCESS)
+        return status;
+    
+    status = AppEvents_Register(&feature_ctx.events, "Feature Events");
+    if (status != TX_SUCCESS)
+        return status;
+    
+    /* DSP helpers run at this thread's priority, one per extra core (none on the U585) */
+    status = DspPool_Init(byte_pool, DSP_POOL_WORKERS, FEATURE_EXTRACT_THREAD_PRIORITY);
     if (status != TX_SUCCESS)
         return status;
     
@@ -104,6 +121,11 @@ UINT FeatureExtraction_Init(TX_BYTE_POOL *byte_pool)
     if (status != TX_SUCCESS)
         return status;
     
+    status = RtSched_Register(RT_SCHED_TASK_FEATURE, &feature_ctx.thread,
+                              FEATURE_EXTRACT_PERIOD_MS, FEATURE_EXTRACT_BUDGET_US);
+    if (status != TX_SUCCESS)
+        return status;
+    
     memset(&feature_ctx.feature_buffer, 0, sizeof(feature_ctx.feature_buffer));
     feature_ctx.packet_count = 0;
     feature_ctx.error_count = 0;
@@ -115,17 +137,18 @@ UINT FeatureExtraction_Init(TX_BYTE_POOL *byte_pool)
 
 /**
   * @brief  Start feature extraction
-  * @param  input_queue: Audio frame queue from acquisition thread
+  * @param  input_ring: Audio frame ring from acquisition thread
   * @retval TX_SUCCESS on success
   */
-UINT FeatureExtraction_Start(TX_QUEUE *input_queue)
+UINT FeatureExtraction_Start(SpscRing_t *input_ring)
 {
     UINT status;
     
-    if (!input_queue || !feature_ctx.thread_stack)
+    if (!input_ring || !feature_ctx.thread_stack)
         return TX_PTR_ERROR;
     
-    feature_ctx.input_queue = input_queue;
+    feature_ctx.input_ring = input_ring;
+    SpscRing_SetWakeup(input_ring, &feature_ctx.events.flags, APP_EVENT_DATA_READY);
     feature_ctx.is_running = 1;
     boot_time_ms = tx_time_get();
     
@@ -136,12 +159,12 @@ UINT FeatureExtraction_Start(TX_QUEUE *input_queue)
 }
 
 /**
-  * @brief  Get output queue for telemetry packets
-  * @retval TX_QUEUE* or NULL
+  * @brief  Get output ring for telemetry packets
+  * @retval SpscRing_t* or NULL
   */
-TX_QUEUE* FeatureExtraction_GetOutputQueue(void)
+SpscRing_t* FeatureExtraction_GetOutputQueue(void)
 {
-    return feature_ctx.thread_stack ? &feature_ctx.output_queue : NULL;
+    return feature_ctx.thread_stack ? &feature_ctx.output_ring : NULL;
 }
 
 /**
@@ -168,7 +191,7 @@ uint32_t FeatureExtraction_GetErrorCount(void)
   * @retval None
   * 
   * This thread:
-  * 1. Receives audio frames from acquisition queue
+  * 1. Receives audio frames from the acquisition ring (woken by its commits)
   * 2. Accumulates AUDIO_FRAMES_PER_PACKET frames
   * 3. Computes RMS, FFT, ZCR, SPL features
   * 4. Creates AudioTelemetryPacket_t
@@ -177,9 +200,9 @@ uint32_t FeatureExtraction_GetErrorCount(void)
 static void FeatureExtraction_ThreadEntry(ULONG thread_input)
 {
     (void)thread_input;
-    AudioFrame_t frame;
-    AudioTelemetryPacket_t telemetry_pkt;
-    UINT status;
+    AudioFrame_t *frame;
+    AudioTelemetryPacket_t *telemetry_pkt;
+    ULONG events;
     
     while (1)
     {
@@ -189,19 +212,13 @@ static void FeatureExtraction_ThreadEntry(ULONG thread_input)
             continue;
         }
         
-        /* Wait for audio frame from acquisition queue (blocking, 100ms timeout) */
-        status = tx_queue_receive(feature_ctx.input_queue,
-                                  (VOID *)&frame,
-                                  100);  /* 100ms timeout */
-        
-        if (status == TX_QUEUE_EMPTY)
+        /* Take the next frame; sleep on the worker events only once the ring is drained */
+        frame = SpscRing_Peek(feature_ctx.input_ring, TX_NO_WAIT);
+        if (!frame)
         {
-            /* No frame available, continue waiting */
-            continue;
-        }
-        else if (status != TX_SUCCESS)
-        {
-            feature_ctx.error_count++;
+            events = AppEvents_Wait(&feature_ctx.events, TX_WAIT_FOREVER);
+            if (events & APP_EVENT_SHUTDOWN)
+                feature_ctx.is_running = 0;
             continue;
         }
         
@@ -210,42 +227,40 @@ static void FeatureExtraction_ThreadEntry(ULONG thread_input)
         if (sample_offset + AUDIO_FRAME_SIZE <= AUDIO_SAMPLES_PER_PACKET)
         {
             memcpy(&feature_ctx.feature_buffer.accumulated_samples[sample_offset],
-                   frame.samples,
-                   sizeof(frame.samples));
+                   frame->samples,
+                   sizeof(frame->samples));
             
             feature_ctx.feature_buffer.sample_count += AUDIO_FRAME_SIZE;
             
             if (feature_ctx.feature_buffer.sample_count == 0)
-                feature_ctx.feature_buffer.start_timestamp_ms = frame.timestamp_ms;
+                feature_ctx.feature_buffer.start_timestamp_ms = frame->timestamp_ms;
             
             /* Track error flags */
-            if (frame.error_flags)
-                last_error_flags |= frame.error_flags;
+            if (frame->error_flags)
+                last_error_flags |= frame->error_flags;
         }
         
+        /* Slot goes back to acquisition as soon as the samples are copied */
+        SpscRing_Release(feature_ctx.input_ring);
+        
         /* Check if we have accumulated enough frames */
         if (feature_ctx.feature_buffer.sample_count >= AUDIO_SAMPLES_PER_PACKET)
         {
-            /* Process buffer and create telemetry packet */
-            int result = FeatureExtraction_ProcessBuffer(&feature_ctx.feature_buffer,
-                                                         &telemetry_pkt);
+            /* Build the telemetry packet directly in the next output slot */
+            telemetry_pkt = SpscRing_Reserve(&feature_ctx.output_ring);
             
-            if (result == 0)
+            if (!telemetry_pkt)
+            {
+                /* Output ring full, drop packet */
+                feature_ctx.error_count++;
+            }
+            else if (FeatureExtraction_ProcessBuffer(&feature_ctx.feature_buffer,
+                                                     telemetry_pkt) == 0)
             {
                 /* Successfully created packet, queue it for transmission */
-                status = tx_queue_send(&feature_ctx.output_queue,
-                                       (VOID *)&telemetry_pkt,
-                                       TX_NO_WAIT);
-                
-                if (status == TX_SUCCESS)
-                {
-                    feature_ctx.packet_count++;
-                }
-                else
-                {
-                    /* Output queue full, drop packet */
-                    feature_ctx.error_count++;
-                }
+                SpscRing_Commit(&feature_ctx.output_ring);
+                RtSched_Release(RT_SCHED_TASK_TELEMETRY);
+                feature_ctx.packet_count++;
             }
             else
             {
@@ -255,6 +270,7 @@ static void FeatureExtraction_ThreadEntry(ULONG thread_input)
             /* Reset accumulator for next batch */
             memset(&feature_ctx.feature_buffer, 0, sizeof(feature_ctx.feature_buffer));
             last_error_flags = 0;
+            RtSched_Complete(RT_SCHED_TASK_FEATURE);
         }
     }
 }
@@ -304,35 +320,27 @@ static int FeatureExtraction_ProcessBuffer(FeatureBuffer_t *buf,
     
     /* ===== FEATURE EXTRACTION ===== */
     
+    /* RMS, ZCR, peak per frame and the FFT bands, as DSP pool jobs */
+    FeatureJobs_Result_t features;
+    if (FeatureJobs_Compute(buf->accumulated_samples, buf->sample_count, &features) != 0)
+        return -1;
+    
     /* 1. RMS Energy */
-    pkt->rms_raw = AudioFeatures_CalculateRMS(buf->accumulated_samples, 
-                                              buf->sample_count);
+    pkt->rms_raw = features.rms_raw;
     
     /* 2. Zero Crossing Rate */
-    pkt->zcr_rate = AudioFeatures_CalculateZCR(buf->accumulated_samples,
-                                               buf->sample_count);
+    pkt->zcr_rate = features.zcr_rate;
     pkt->zcr_count = (buf->sample_count / 2);  /* Approximate count */
     
     /* 3. Peak Amplitude */
-    pkt->peak_amplitude = AudioFeatures_FindPeakAmplitude(buf->accumulated_samples,
-                                                          buf->sample_count);
+    pkt->peak_amplitude = features.peak_amplitude;
     
     /* 4. Sound Pressure Level */
     pkt->spl_db = AudioFeatures_CalculateSPL(pkt->rms_raw, 20e-6f);
     
     /* 5. FFT Magnitude Bands */
-    uint32_t fft_bands_tmp[FFT_BANDS];
-    int fft_result = AudioFeatures_ComputeFFTBands(buf->accumulated_samples,
-                                                   fft_bands_tmp);
-    
-    if (fft_result != 0)
-    {
-        /* FFT computation failed, but continue with available data */
-        memset(fft_bands_tmp, 0, sizeof(fft_bands_tmp));
-    }
-
     /* Copy into packed packet field as a plain byte copy to avoid alignment issues. */
-    memcpy(pkt->fft_band, fft_bands_tmp, sizeof(pkt->fft_band));
+    memcpy(pkt->fft_band, features.fft_band, sizeof(pkt->fft_band));
     
     return 0;
 }
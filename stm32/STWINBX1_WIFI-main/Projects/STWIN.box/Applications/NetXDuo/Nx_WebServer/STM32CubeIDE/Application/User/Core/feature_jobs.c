@@ -0,0 +1,142 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    feature_jobs.c
+  * @author  Wind Turbine Team
+  * @brief   Packet features split into independent DSP pool jobs
+  ******************************************************************************
+  * The band jobs dominate (each runs FFT_SIZE Goertzel steps for ~32 bins);
+  * they go first in the batch so the cheap frame jobs fill the gaps at the
+  * end. Each job writes only its own partial, so no job needs a lock.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "feature_jobs.h"
+#include "dsp_pool.h"
+#include <string.h>
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    const int16_t         *samples;
+    uint32_t               count;
+    const int16_t         *crossing_samples;           /* Frame plus the sample before it, if any */
+    uint32_t               crossing_count;
+    uint64_t               sum_squares;
+    uint32_t               zero_crossings;
+    uint16_t               peak;
+} FeatureJobs_Frame_t;
+
+typedef struct
+{
+    const int16_t         *samples;
+    uint32_t               band;
+    uint32_t               magnitude;
+} FeatureJobs_Band_t;
+
+typedef struct
+{
+    FeatureJobs_Frame_t    frames[AUDIO_FRAMES_PER_PACKET];
+    FeatureJobs_Band_t     bands[FFT_BANDS];
+    DspPool_Job_t          jobs[FEATURE_JOBS_COUNT];
+} FeatureJobs_Context_t;
+
+_Static_assert(FEATURE_JOBS_COUNT <= DSP_POOL_MAX_JOBS, "one packet must fit one DSP pool batch");
+
+/* Private variables ---------------------------------------------------------*/
+static FeatureJobs_Context_t feature_jobs_ctx;
+
+/* Private function prototypes -----------------------------------------------*/
+static void FeatureJobs_FrameJob(void *arg);
+static void FeatureJobs_BandJob(void *arg);
+
+/**
+  * @brief  Compute the packet features on the DSP pool
+  * @param  samples: PCM samples
+  * @param  count: FFT_SIZE .. AUDIO_SAMPLES_PER_PACKET
+  * @param  result: output
+  * @retval 0 on success, -1 on error
+  */
+int FeatureJobs_Compute(const int16_t *samples, uint32_t count, FeatureJobs_Result_t *result)
+{
+    uint32_t jobs = 0;
+    uint32_t frames = 0;
+    uint64_t sum_squares = 0;
+    uint32_t zero_crossings = 0;
+
+    if (!samples || !result || count < FFT_SIZE || count > AUDIO_SAMPLES_PER_PACKET)
+        return -1;
+
+    for (uint32_t band = 0; band < FFT_BANDS; band++)
+    {
+        FeatureJobs_Band_t *b = &feature_jobs_ctx.bands[band];
+
+        b->samples = samples;
+        b->band = band;
+        feature_jobs_ctx.jobs[jobs].fn = FeatureJobs_BandJob;
+        feature_jobs_ctx.jobs[jobs++].arg = b;
+    }
+
+    /* Every frame but the first starts one sample early to see the crossing at its start */
+    for (uint32_t start = 0; start < count; start += AUDIO_FRAME_SIZE)
+    {
+        FeatureJobs_Frame_t *f = &feature_jobs_ctx.frames[frames++];
+        uint32_t len = (count - start < AUDIO_FRAME_SIZE) ? count - start : AUDIO_FRAME_SIZE;
+
+        f->samples = &samples[start];
+        f->count = len;
+        f->crossing_samples = (start == 0) ? f->samples : f->samples - 1;
+        f->crossing_count = (start == 0) ? len : len + 1;
+        feature_jobs_ctx.jobs[jobs].fn = FeatureJobs_FrameJob;
+        feature_jobs_ctx.jobs[jobs++].arg = f;
+    }
+
+    if (DspPool_Run(feature_jobs_ctx.jobs, jobs) != TX_SUCCESS)
+        return -1;
+
+    memset(result, 0, sizeof(*result));
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        sum_squares += feature_jobs_ctx.frames[i].sum_squares;
+        zero_crossings += feature_jobs_ctx.frames[i].zero_crossings;
+        if (feature_jobs_ctx.frames[i].peak > result->peak_amplitude)
+            result->peak_amplitude = feature_jobs_ctx.frames[i].peak;
+    }
+    result->rms_raw = AudioFeatures_RMSFromSumSquares(sum_squares, count);
+    result->zcr_rate = AudioFeatures_ZCRFromCrossings(zero_crossings, count);
+
+    for (uint32_t band = 0; band < FFT_BANDS; band++)
+        result->fft_band[band] = feature_jobs_ctx.bands[band].magnitude;
+
+    return 0;
+}
+
+/**
+  * @brief  Statistics of one frame
+  * @param  arg: FeatureJobs_Frame_t
+  * @retval None
+  */
+static void FeatureJobs_FrameJob(void *arg)
+{
+    FeatureJobs_Frame_t *f = (FeatureJobs_Frame_t *)arg;
+
+    f->sum_squares = AudioFeatures_SumSquares(f->samples, f->count);
+    f->peak = AudioFeatures_FindPeakAmplitude(f->samples, f->count);
+    f->zero_crossings = AudioFeatures_CountZeroCrossings(f->crossing_samples, f->crossing_count);
+}
+
+/**
+  * @brief  Magnitude of one FFT band
+  * @param  arg: FeatureJobs_Band_t
+  * @retval None
+  */
+static void FeatureJobs_BandJob(void *arg)
+{
+    FeatureJobs_Band_t *b = (FeatureJobs_Band_t *)arg;
+
+    b->magnitude = AudioFeatures_ComputeFFTBand(b->samples, b->band);
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,165 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    spsc_ring.c
+  * @author  Wind Turbine Team
+  * @brief   Lock-free single-producer/single-consumer ring for thread handoff
+  ******************************************************************************
+  * head counts commits and is only written by the producer, tail counts
+  * releases and is only written by the consumer; head - tail is the fill
+  * level and wraps correctly on overflow. A slot is published by a release
+  * store of head after it is filled and handed back by a release store of
+  * tail after it is read, so neither side needs a lock.
+  *
+  * Wakeup: the consumer sleeps on DATA_READY only after finding the ring
+  * empty, and the producer sets it when its commit moved head off the tail
+  * it observed. Both sides store their index and then load the other's
+  * through a full barrier, so a commit cannot slip between the consumer's
+  * empty check and its sleep without also seeing that tail and setting the
+  * flag. A stale flag only costs one extra loop in SpscRing_Peek(), or one
+  * empty drain for a consumer that waits on its own group.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "spsc_ring.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define SPSC_RING_DATA_READY            0x1U
+
+#define SPSC_LOAD_ACQUIRE(p)            __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define SPSC_STORE_RELEASE(p, v)        __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define SPSC_FULL_BARRIER()             __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Create a ring
+  * @param  ring: ring control block
+  * @param  name: event flags name
+  * @param  storage: SPSC_RING_STORAGE_SIZE(slot_size, depth) bytes
+  * @param  slot_size: message size in bytes
+  * @param  depth: number of slots, a power of two
+  * @retval TX_SUCCESS or error code
+  */
+UINT SpscRing_Create(SpscRing_t *ring, CHAR *name, VOID *storage, ULONG slot_size, ULONG depth)
+{
+    if (!ring || !storage || ((uintptr_t)storage & 3U))
+        return TX_PTR_ERROR;
+    if (slot_size == 0 || depth < 2 || (depth & (depth - 1)))
+        return TX_SIZE_ERROR;
+
+    memset(ring, 0, sizeof(*ring));
+    ring->slots = (uint8_t *)storage;
+    ring->slot_size = SPSC_RING_SLOT_SIZE(slot_size);
+    ring->mask = depth - 1;
+    ring->wake_group = &ring->data_ready;
+    ring->wake_flag = SPSC_RING_DATA_READY;
+
+    return tx_event_flags_create(&ring->data_ready, name);
+}
+
+/**
+  * @brief  Redirect the empty -> non-empty wakeup to the consumer's group
+  * @param  ring: ring
+  * @param  group: consumer's event flags group
+  * @param  flag: flag to set
+  * @retval None
+  */
+void SpscRing_SetWakeup(SpscRing_t *ring, TX_EVENT_FLAGS_GROUP *group, ULONG flag)
+{
+    ring->wake_group = group;
+    ring->wake_flag = flag;
+}
+
+/**
+  * @brief  Get the next free slot (producer)
+  * @param  ring: ring
+  * @retval Slot to fill, or NULL if the ring is full
+  */
+VOID *SpscRing_Reserve(SpscRing_t *ring)
+{
+    uint32_t head = ring->head;
+
+    /* Acquire pairs with the consumer's release: it is done reading the slot */
+    if (head - SPSC_LOAD_ACQUIRE(&ring->tail) > ring->mask)
+    {
+        ring->full_count++;
+        return NULL;
+    }
+
+    return ring->slots + (head & ring->mask) * ring->slot_size;
+}
+
+/**
+  * @brief  Publish the reserved slot and wake the consumer if it was empty
+  * @param  ring: ring
+  * @retval None
+  */
+void SpscRing_Commit(SpscRing_t *ring)
+{
+    uint32_t head = ring->head;
+
+    SPSC_STORE_RELEASE(&ring->head, head + 1);
+    SPSC_FULL_BARRIER();
+
+    /* Only the empty -> non-empty edge can have a sleeping consumer */
+    if (ring->tail == head)
+        tx_event_flags_set(ring->wake_group, ring->wake_flag, TX_OR);
+}
+
+/**
+  * @brief  Get the oldest committed slot (consumer)
+  * @param  ring: ring
+  * @param  wait_option: TX_NO_WAIT, ticks or TX_WAIT_FOREVER
+  * @retval Slot, or NULL on timeout
+  */
+VOID *SpscRing_Peek(SpscRing_t *ring, ULONG wait_option)
+{
+    uint32_t tail = ring->tail;
+    ULONG actual;
+
+    while (SPSC_LOAD_ACQUIRE(&ring->head) == tail)
+    {
+        if (wait_option == TX_NO_WAIT)
+            return NULL;
+
+        /* Restarts the timeout on a stale flag; bounded by one per commit edge */
+        if (tx_event_flags_get(ring->wake_group, ring->wake_flag, TX_OR_CLEAR,
+                               &actual, wait_option) != TX_SUCCESS)
+            return NULL;
+        ring->wakeups++;
+    }
+
+    return ring->slots + (tail & ring->mask) * ring->slot_size;
+}
+
+/**
+  * @brief  Hand the peeked slot back to the producer (consumer)
+  * @param  ring: ring
+  * @retval None
+  */
+void SpscRing_Release(SpscRing_t *ring)
+{
+    SPSC_STORE_RELEASE(&ring->tail, ring->tail + 1);
+
+    /* Orders the tail store before the next Peek()'s head load, see top of file */
+    SPSC_FULL_BARRIER();
+}
+
+/**
+  * @brief  Get fill level and counters
+  * @param  ring: ring
+  * @param  stats: output
+  * @retval None
+  */
+void SpscRing_GetStats(const SpscRing_t *ring, SpscRing_Stats_t *stats)
+{
+    stats->depth = ring->mask + 1;
+    stats->used = ring->head - ring->tail;
+    stats->full_count = ring->full_count;
+    stats->wakeups = ring->wakeups;
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
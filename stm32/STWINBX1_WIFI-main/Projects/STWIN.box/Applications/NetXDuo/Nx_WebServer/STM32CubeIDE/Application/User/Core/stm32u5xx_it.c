@@ -23,6 +23,10 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "fx_stm32_sd_driver.h"
+#include "low_power.h"
+#include "cpu_load.h"
+#include "thread_metric.h"
+#include "audio_acquisition.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -169,11 +173,11 @@ void DebugMon_Handler(void)
 void EXTI7_IRQHandler(void)
 {
   /* USER CODE BEGIN EXTI7_IRQn 0 */
-
+  CPU_LOAD_ISR_ENTER(CPU_LOAD_ISR_WIFI_NOTIFY);
   /* USER CODE END EXTI7_IRQn 0 */
   HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_7);
   /* USER CODE BEGIN EXTI7_IRQn 1 */
-
+  CPU_LOAD_ISR_EXIT(CPU_LOAD_ISR_WIFI_NOTIFY);
   /* USER CODE END EXTI7_IRQn 1 */
 }
 
@@ -183,11 +187,11 @@ void EXTI7_IRQHandler(void)
 void EXTI15_IRQHandler(void)
 {
   /* USER CODE BEGIN EXTI15_IRQn 0 */
-
+  CPU_LOAD_ISR_ENTER(CPU_LOAD_ISR_EXTI15);
   /* USER CODE END EXTI15_IRQn 0 */
   HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_15);
   /* USER CODE BEGIN EXTI15_IRQn 1 */
-
+  CPU_LOAD_ISR_EXIT(CPU_LOAD_ISR_EXTI15);
   /* USER CODE END EXTI15_IRQn 1 */
 }
 
@@ -197,18 +201,20 @@ void EXTI15_IRQHandler(void)
 void TIM6_IRQHandler(void)
 {
   /* USER CODE BEGIN TIM6_IRQn 0 */
-
+  CPU_LOAD_ISR_ENTER(CPU_LOAD_ISR_HAL_TICK);
   /* USER CODE END TIM6_IRQn 0 */
   HAL_TIM_IRQHandler(&htim6);
   /* USER CODE BEGIN TIM6_IRQn 1 */
-
+  CPU_LOAD_ISR_EXIT(CPU_LOAD_ISR_HAL_TICK);
   /* USER CODE END TIM6_IRQn 1 */
 }
 
 /* USER CODE BEGIN 1 */
 void SDMMC1_IRQHandler(void)
 {
+  CPU_LOAD_ISR_ENTER(CPU_LOAD_ISR_SD);
   BSP_SD_IRQHandler(FX_STM32_SD_INSTANCE);
+  CPU_LOAD_ISR_EXIT(CPU_LOAD_ISR_SD);
 }
 
 /* USER CODE BEGIN 1 */
@@ -217,17 +223,53 @@ void SDMMC1_IRQHandler(void)
   */
 void LPTIM1_IRQHandler(void)
 {
+  CPU_LOAD_ISR_ENTER(CPU_LOAD_ISR_WIFI_FLOW);
   HAL_LPTIM_IRQHandler(&hlptim1);
+  CPU_LOAD_ISR_EXIT(CPU_LOAD_ISR_WIFI_FLOW);
+}
+
+/**
+  * @brief This function handles LPTIM3 global interrupt (tickless idle wakeup).
+  */
+void LPTIM3_IRQHandler(void)
+{
+  CPU_LOAD_ISR_ENTER(CPU_LOAD_ISR_LOW_POWER);
+  LowPower_TimerIRQHandler();
+  CPU_LOAD_ISR_EXIT(CPU_LOAD_ISR_LOW_POWER);
+}
+
+/**
+  * @brief This function handles TIM7 global interrupt (Thread-Metric interrupt tests).
+  */
+void TIM7_IRQHandler(void)
+{
+  CPU_LOAD_ISR_ENTER(CPU_LOAD_ISR_THREAD_METRIC);
+  ThreadMetric_TimerIRQHandler();
+  CPU_LOAD_ISR_EXIT(CPU_LOAD_ISR_THREAD_METRIC);
+}
+
+/**
+  * @brief This function handles GPDMA1 Channel 1 global interrupt (microphone MDF DMA).
+  */
+void GPDMA1_Channel1_IRQHandler(void)
+{
+  CPU_LOAD_ISR_ENTER(CPU_LOAD_ISR_AUDIO_DMA);
+  AudioAcquisition_DMA_IRQHandler();
+  CPU_LOAD_ISR_EXIT(CPU_LOAD_ISR_AUDIO_DMA);
 }
 
 void GPDMA1_Channel4_IRQHandler(void)
 {
+  CPU_LOAD_ISR_ENTER(CPU_LOAD_ISR_WIFI_DMA);
   HAL_DMA_IRQHandler(&handle_GPDMA1_Channel4);
+  CPU_LOAD_ISR_EXIT(CPU_LOAD_ISR_WIFI_DMA);
 }
 
 void GPDMA1_Channel5_IRQHandler(void)
 {
+  CPU_LOAD_ISR_ENTER(CPU_LOAD_ISR_WIFI_DMA);
   HAL_DMA_IRQHandler(&handle_GPDMA1_Channel5);
+  CPU_LOAD_ISR_EXIT(CPU_LOAD_ISR_WIFI_DMA);
 }
 
 /**
@@ -235,7 +277,9 @@ void GPDMA1_Channel5_IRQHandler(void)
   */
 void SPI1_IRQHandler(void)
 {
+  CPU_LOAD_ISR_ENTER(CPU_LOAD_ISR_WIFI_SPI);
   HAL_SPI_IRQHandler(&hspi1);
+  CPU_LOAD_ISR_EXIT(CPU_LOAD_ISR_WIFI_SPI);
 }
 
 /* USER CODE END 1 */
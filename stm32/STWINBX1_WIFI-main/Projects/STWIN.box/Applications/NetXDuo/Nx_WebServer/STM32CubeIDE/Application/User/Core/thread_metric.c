@@ -0,0 +1,391 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    thread_metric.c
+  * @author  Wind Turbine Team
+  * @brief   Thread-Metric RTOS benchmark runner
+  ******************************************************************************
+  * The eight test sources are compiled into this file, each with tm_main
+  * renamed: they are written as separate programs, but apart from tm_main
+  * their globals have distinct names. Building this file needs the
+  * thread_metric directory on the include path (see NETWORK_SETUP.md).
+  *
+  * The runner does not use the tests' report threads. It starts a test,
+  * lets it warm up, reads the test's counters at both ends of the window and
+  * deletes everything through ThreadMetric_PortReset(). TM_TEST_DURATION is
+  * set past the window so the report threads never wake up to print.
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "thread_metric.h"
+#include "app_util.h"
+#include "mem_budget.h"
+#include <stdio.h>
+#include <string.h>
+#ifndef THREAD_METRIC_HOST
+#include "stm32u5xx.h"
+#endif
+
+#define TM_TEST_DURATION    (THREAD_METRIC_WARMUP_SECONDS + THREAD_METRIC_MAX_SECONDS + 1)
+#include "tm_api.h"
+
+/* tm_porting_layer.h raises an SVC, which the Cortex-M33 port keeps for itself */
+#undef TM_CAUSE_INTERRUPT
+#define TM_CAUSE_INTERRUPT  ThreadMetric_CauseInterrupt();
+
+static void ThreadMetric_CauseInterrupt(void);
+
+/* Its loop makes no calls, so at -O2 the counter never leaves a register
+   and the array loop vectorizes on the host: keep both in memory */
+#define tm_main tm_basic_processing_main
+#define unsigned volatile unsigned
+#include "tm_basic_processing_test.c"
+#undef unsigned
+#undef tm_main
+#define tm_main tm_cooperative_scheduling_main
+#include "tm_cooperative_scheduling_test.c"
+#undef tm_main
+#define tm_main tm_preemptive_scheduling_main
+#include "tm_preemptive_scheduling_test.c"
+#undef tm_main
+#define tm_main tm_interrupt_processing_main
+#include "tm_interrupt_processing_test.c"
+#undef tm_main
+#define tm_main tm_interrupt_preemption_processing_main
+#include "tm_interrupt_preemption_processing_test.c"
+#undef tm_main
+#define tm_main tm_message_processing_main
+#include "tm_message_processing_test.c"
+#undef tm_main
+#define tm_main tm_synchronization_processing_main
+#include "tm_synchronization_processing_test.c"
+#undef tm_main
+#define tm_main tm_memory_allocation_main
+#include "tm_memory_allocation_test.c"
+#undef tm_main
+
+/* Private defines -----------------------------------------------------------*/
+#define THREAD_METRIC_TEST_COUNT        8
+
+/* Private types -------------------------------------------------------------*/
+
+typedef struct
+{
+    const char            *name;
+    void                 (*initialize)(void);
+    unsigned long        (*total)(void);        /* Same sum as the test's report thread */
+    void                 (*irq_handler)(void);  /* Interrupt tests only */
+} ThreadMetric_Test_t;
+
+typedef struct
+{
+    unsigned long          count;
+    UCHAR                  is_done;
+} ThreadMetric_Result_t;
+
+typedef struct
+{
+    volatile ThreadMetric_State_t state;
+    ULONG                  seconds;
+    ThreadMetric_Result_t  results[THREAD_METRIC_TEST_COUNT];
+
+    void                 (*volatile irq_handler)(void);
+    volatile ULONG         irq_count;
+
+    TX_THREAD              thread;
+    TX_SEMAPHORE           start;
+} ThreadMetric_Context_t;
+
+/* Private variables ---------------------------------------------------------*/
+static ThreadMetric_Context_t metric_ctx = {0};
+static ULONG metric_stack[THREAD_METRIC_STACK_SIZE / sizeof(ULONG)];
+
+/* Kernel options that move the scores; kept with every result */
+static const char thread_metric_config[] = ""
+#ifdef TX_DISABLE_PREEMPTION_THRESHOLD
+    " TX_DISABLE_PREEMPTION_THRESHOLD"
+#endif
+#ifdef TX_DISABLE_NOTIFY_CALLBACKS
+    " TX_DISABLE_NOTIFY_CALLBACKS"
+#endif
+#ifdef TX_INLINE_THREAD_RESUME_SUSPEND
+    " TX_INLINE_THREAD_RESUME_SUSPEND"
+#endif
+#ifdef TX_REACTIVATE_INLINE
+    " TX_REACTIVATE_INLINE"
+#endif
+#ifdef TX_DISABLE_ERROR_CHECKING
+    " TX_DISABLE_ERROR_CHECKING"
+#endif
+#ifdef TX_NOT_INTERRUPTABLE
+    " TX_NOT_INTERRUPTABLE"
+#endif
+#ifdef TX_TIMER_PROCESS_IN_ISR
+    " TX_TIMER_PROCESS_IN_ISR"
+#endif
+#ifdef TX_ENABLE_STACK_CHECKING
+    " TX_ENABLE_STACK_CHECKING"
+#endif
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+    " TX_EXECUTION_PROFILE_ENABLE"
+#endif
+#ifdef TX_ENABLE_EVENT_TRACE
+    " TX_ENABLE_EVENT_TRACE"
+#endif
+    "";
+
+/* Private function prototypes -----------------------------------------------*/
+static unsigned long ThreadMetric_TotalBasic(void);
+static unsigned long ThreadMetric_TotalCooperative(void);
+static unsigned long ThreadMetric_TotalPreemptive(void);
+static unsigned long ThreadMetric_TotalInterrupt(void);
+static unsigned long ThreadMetric_TotalInterruptPreemption(void);
+static unsigned long ThreadMetric_TotalMessage(void);
+static unsigned long ThreadMetric_TotalSynchronization(void);
+static unsigned long ThreadMetric_TotalMemory(void);
+static VOID ThreadMetric_ThreadEntry(ULONG input);
+
+static const ThreadMetric_Test_t thread_metric_tests[] =
+{
+    { "basic_processing",                tm_basic_processing_initialize,                ThreadMetric_TotalBasic,                NULL },
+    { "cooperative_scheduling",          tm_cooperative_scheduling_initialize,          ThreadMetric_TotalCooperative,          NULL },
+    { "preemptive_scheduling",           tm_preemptive_scheduling_initialize,           ThreadMetric_TotalPreemptive,           NULL },
+    { "interrupt_processing",            tm_interrupt_processing_initialize,            ThreadMetric_TotalInterrupt,            tm_interrupt_handler },
+    { "interrupt_preemption_processing", tm_interrupt_preemption_processing_initialize, ThreadMetric_TotalInterruptPreemption, tm_interrupt_preemption_handler },
+    { "message_processing",              tm_message_processing_initialize,              ThreadMetric_TotalMessage,              NULL },
+    { "synchronization_processing",      tm_synchronization_processing_initialize,      ThreadMetric_TotalSynchronization,      NULL },
+    { "memory_allocation",               tm_memory_allocation_initialize,               ThreadMetric_TotalMemory,               NULL },
+};
+
+_Static_assert(sizeof(thread_metric_tests) / sizeof(thread_metric_tests[0]) == THREAD_METRIC_TEST_COUNT,
+               "one result per test");
+
+/**
+  * @brief  Create the runner thread and the benchmark interrupt
+  * @retval TX_SUCCESS or error code
+  */
+UINT ThreadMetric_Init(void)
+{
+    UINT status;
+
+    status = ThreadMetric_PortIrqInit();
+    if (status != TX_SUCCESS)
+        return status;
+
+    status = tx_semaphore_create(&metric_ctx.start, "Thread Metric Start", 0);
+    if (status != TX_SUCCESS)
+        return status;
+
+    MemBudget_RegisterStatic("thread_metric", "runner stack", sizeof(metric_stack));
+
+    return tx_thread_create(&metric_ctx.thread,
+                            "Thread Metric",
+                            ThreadMetric_ThreadEntry,
+                            0,
+                            metric_stack,
+                            sizeof(metric_stack),
+                            THREAD_METRIC_PRIORITY,
+                            THREAD_METRIC_PRIORITY,
+                            TX_NO_TIME_SLICE,
+                            TX_AUTO_START);
+}
+
+/**
+  * @brief  Run all tests in the runner thread
+  * @param  seconds: measurement window per test
+  * @retval TX_SUCCESS or TX_NOT_AVAILABLE
+  */
+UINT ThreadMetric_Start(ULONG seconds)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if (seconds == 0U)
+        seconds = 1U;
+    if (seconds > THREAD_METRIC_MAX_SECONDS)
+        seconds = THREAD_METRIC_MAX_SECONDS;
+
+    TX_DISABLE
+    if (metric_ctx.state == THREAD_METRIC_STATE_RUNNING)
+    {
+        TX_RESTORE
+        return TX_NOT_AVAILABLE;
+    }
+    metric_ctx.state = THREAD_METRIC_STATE_RUNNING;
+    TX_RESTORE
+
+    metric_ctx.seconds = seconds;
+    memset(metric_ctx.results, 0, sizeof(metric_ctx.results));
+
+    return tx_semaphore_put(&metric_ctx.start);
+}
+
+/**
+  * @brief  Get the runner state
+  * @retval ThreadMetric_State_t
+  */
+ThreadMetric_State_t ThreadMetric_GetState(void)
+{
+    return metric_ctx.state;
+}
+
+/**
+  * @brief  Format the last run as CSV lines
+  * @param  buf: output buffer
+  * @param  size: buffer size
+  * @retval Number of characters written (excluding terminator)
+  */
+uint32_t ThreadMetric_Format(char *buf, uint32_t size)
+{
+    static const char *const state_names[] = { "idle", "running", "done" };
+    uint32_t len = 0;
+    ULONG seconds = metric_ctx.seconds;
+
+    if (!buf || size == 0U)
+        return 0;
+    buf[0] = '\0';
+
+#ifdef THREAD_METRIC_HOST
+    len = App_Append(buf, size, len, "run,%s,%s,%lu,0\n", THREAD_METRIC_PLATFORM,
+                     state_names[metric_ctx.state], (unsigned long)seconds);
+#else
+    len = App_Append(buf, size, len, "run,%s,%s,%lu,%lu\n", THREAD_METRIC_PLATFORM,
+                     state_names[metric_ctx.state], (unsigned long)seconds,
+                     (unsigned long)SystemCoreClock);
+#endif
+    len = App_Append(buf, size, len, "config,%s\n",
+                     thread_metric_config[0] ? thread_metric_config + 1 : "default");
+
+    for (uint32_t i = 0; i < THREAD_METRIC_TEST_COUNT; i++)
+    {
+        if (!metric_ctx.results[i].is_done)
+            continue;
+        len = App_Append(buf, size, len, "test,%s,%lu,%lu\n", thread_metric_tests[i].name,
+                         metric_ctx.results[i].count,
+                         seconds ? metric_ctx.results[i].count / seconds : 0UL);
+    }
+
+    return len;
+}
+
+/**
+  * @brief  Benchmark interrupt body
+  * @retval None
+  */
+void ThreadMetric_IrqHandler(void)
+{
+    void (*handler)(void) = metric_ctx.irq_handler;
+
+    if (handler)
+        handler();
+    metric_ctx.irq_count++;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  TM_CAUSE_INTERRUPT: raise the interrupt and return after it ran
+  * @retval None
+  *
+  * The tests check the handler's effect right after the macro. On the board
+  * the interrupt is normally taken before the loop is reached; the Linux ISR
+  * thread needs the wait.
+  */
+static void ThreadMetric_CauseInterrupt(void)
+{
+    ULONG seen = metric_ctx.irq_count;
+
+    ThreadMetric_PortIrqRaise();
+    while (metric_ctx.irq_count == seen)
+    {
+    }
+}
+
+/**
+  * @brief  Runner thread: one run per ThreadMetric_Start()
+  * @param  input: unused
+  * @retval None
+  */
+static VOID ThreadMetric_ThreadEntry(ULONG input)
+{
+    (void)input;
+
+    while (1)
+    {
+        if (tx_semaphore_get(&metric_ctx.start, TX_WAIT_FOREVER) != TX_SUCCESS)
+            continue;
+
+        printf("Thread-Metric: %u tests, %lu s each, config: %s\n", (unsigned)THREAD_METRIC_TEST_COUNT,
+               (unsigned long)metric_ctx.seconds, thread_metric_config[0] ? thread_metric_config + 1 : "default");
+
+        for (uint32_t i = 0; i < THREAD_METRIC_TEST_COUNT; i++)
+        {
+            const ThreadMetric_Test_t *test = &thread_metric_tests[i];
+            unsigned long start;
+            unsigned long end;
+
+            metric_ctx.irq_handler = test->irq_handler;
+            tm_initialize(test->initialize);
+
+            tx_thread_sleep(THREAD_METRIC_WARMUP_SECONDS * TX_TIMER_TICKS_PER_SECOND);
+            start = test->total();
+            tx_thread_sleep(metric_ctx.seconds * TX_TIMER_TICKS_PER_SECOND);
+            end = test->total();
+
+            ThreadMetric_PortReset();
+            metric_ctx.irq_handler = NULL;
+
+            metric_ctx.results[i].count = end - start;
+            metric_ctx.results[i].is_done = 1;
+
+            printf("Thread-Metric %s: %lu (%lu/s)%s\n", test->name, end - start,
+                   (end - start) / metric_ctx.seconds, (end == start) ? " ERROR: no progress" : "");
+        }
+
+        metric_ctx.state = THREAD_METRIC_STATE_DONE;
+    }
+}
+
+static unsigned long ThreadMetric_TotalBasic(void)
+{
+    return tm_basic_processing_counter;
+}
+
+static unsigned long ThreadMetric_TotalCooperative(void)
+{
+    return tm_cooperative_thread_0_counter + tm_cooperative_thread_1_counter + tm_cooperative_thread_2_counter +
+           tm_cooperative_thread_3_counter + tm_cooperative_thread_4_counter;
+}
+
+static unsigned long ThreadMetric_TotalPreemptive(void)
+{
+    return tm_preemptive_thread_0_counter + tm_preemptive_thread_1_counter + tm_preemptive_thread_2_counter +
+           tm_preemptive_thread_3_counter + tm_preemptive_thread_4_counter;
+}
+
+static unsigned long ThreadMetric_TotalInterrupt(void)
+{
+    return tm_interrupt_handler_counter;
+}
+
+static unsigned long ThreadMetric_TotalInterruptPreemption(void)
+{
+    return tm_interrupt_preemption_handler_counter;
+}
+
+static unsigned long ThreadMetric_TotalMessage(void)
+{
+    return tm_message_processing_counter;
+}
+
+static unsigned long ThreadMetric_TotalSynchronization(void)
+{
+    return tm_synchronization_processing_counter;
+}
+
+static unsigned long ThreadMetric_TotalMemory(void)
+{
+    return tm_memory_allocation_counter;
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
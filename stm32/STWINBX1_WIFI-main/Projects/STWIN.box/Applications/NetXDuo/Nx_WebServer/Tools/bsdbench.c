@@ -0,0 +1,331 @@
+/**
+  ******************************************************************************
+  * @file    bsdbench.c
+  * @author  Wind Turbine Team
+  * @brief   Host benchmark: datagrams per second through the BSD layer,
+  *          sendto/recvfrom against sendmmsg/recvmmsg (NetX Duo Linux port)
+  ******************************************************************************
+  * One IP instance whose link hands every frame back to itself. A sender
+  * socket sends BENCH_PAYLOAD byte datagrams to a receiver socket on the
+  * same instance, BENCH_BATCH at a time, and the receiver then drains them:
+  *
+  *   sendto     BENCH_BATCH sendto() calls, then BENCH_BATCH recvfrom()
+  *   mmsg       one sendmmsg() of BENCH_BATCH, one recvmmsg() of BENCH_BATCH
+  *   zerocopy   one sendmmsg(), one nx_bsd_recvmmsg_packets() and a release
+  *              per packet
+  *
+  * The IP thread runs above the bench thread, so the send times include
+  * the stack delivering each datagram into the receiver's queue. The
+  * receiver queue must hold a whole batch: build with a larger
+  * NX_BSD_SOCKET_QUEUE_MAX. The BSD layer needs extended notify, the
+  * thread's errno slot and the POSIX headers rather than the GNU ones, so
+  * it is compiled apart from the ThreadX port:
+  *
+  *   TX=../../../../../../Middlewares/ST/threadx
+  *   NX=../../../../../../Middlewares/ST/netxduo
+  *   INC="-I../NetXDuo/App -I$TX/common/inc -I$TX/ports/linux/gnu/inc \
+  *       -I$NX/common/inc -I$NX/ports/linux/gnu/inc -I$NX/addons/BSD"
+  *   ERRNO="-DTX_THREAD_USER_EXTENSION=int bsd_errno;"
+  *   EXT="-O2 -no-pie -fno-pie -DNX_INCLUDE_USER_DEFINE_FILE -DNX_ENABLE_EXTENDED_NOTIFY_SUPPORT \
+  *       -DNX_BSD_SOCKET_QUEUE_MAX=64 -DNX_BSD_ENABLE_BATCH"
+  *   gcc -D_GNU_SOURCE "$ERRNO" $EXT $INC -c $NX/common/src/nx*.c $TX/common/src/tx*.c \
+  *       $TX/ports/linux/gnu/src/tx*.c
+  *   gcc -std=c99 -D_POSIX_C_SOURCE=200809L "$ERRNO" $EXT $INC -c bsdbench.c $NX/addons/BSD/nxd_bsd.c
+  *   gcc -no-pie -o bsdbench *.o -lpthread -lrt
+  *   ./bsdbench [datagrams per row]
+  *
+  * Without -DNX_BSD_ENABLE_BATCH only the sendto row is built: that is the
+  * layer without the per socket receive locks. The Linux port runs one
+  * thread at a time, so the rows show the cost per call, not contention
+  * between threads; compare builds on the same machine.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tx_api.h"
+#include "nx_api.h"
+#include "nxd_bsd.h"
+
+#define LINK_MTU                1500
+#define BENCH_PACKET_SIZE       256
+#define BENCH_PACKETS           256
+#define BENCH_PAYLOAD           64          /* Telemetry sized datagrams */
+#define BENCH_BATCH             32
+#define BENCH_PORT              5000
+
+#if defined(NX_BSD_ENABLE_BATCH) && (BENCH_BATCH > NX_BSD_BATCH_MAX)
+#error "BENCH_BATCH exceeds NX_BSD_BATCH_MAX"
+#endif
+
+static TX_THREAD bench_thread;
+static ULONG bench_stack[4096];
+static ULONG bsd_stack[2048];
+static NX_PACKET_POOL pool;
+static ULONG pool_memory[((BENCH_PACKET_SIZE + sizeof(NX_PACKET)) * BENCH_PACKETS) / sizeof(ULONG) + 4];
+static NX_IP ip;
+static ULONG ip_stack[2048];
+
+static ULONG bench_datagrams = 200000;
+
+typedef struct
+{
+    double send_ns;
+    double receive_ns;
+    ULONG  sent;
+    ULONG  received;
+} BenchResult_t;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Hand the frame back to the same instance */
+static void link_send(NX_PACKET *packet_ptr)
+{
+    static UCHAR frame[LINK_MTU];
+    NX_PACKET *copy;
+    ULONG length;
+
+    nx_packet_data_extract_offset(packet_ptr, 0, frame, sizeof(frame), &length);
+    nx_packet_transmit_release(packet_ptr);
+
+    if (nx_packet_allocate(&pool, &copy, NX_RECEIVE_PACKET, NX_NO_WAIT) != NX_SUCCESS)
+        return;
+
+    memcpy(copy->nx_packet_prepend_ptr, frame, length);
+    copy->nx_packet_append_ptr = copy->nx_packet_prepend_ptr + length;
+    copy->nx_packet_length = length;
+    copy->nx_packet_ip_interface = &ip.nx_ip_interface[0];
+
+    _nx_ip_packet_deferred_receive(&ip, copy);
+}
+
+static void link_driver(NX_IP_DRIVER *driver_req_ptr)
+{
+    driver_req_ptr->nx_ip_driver_status = NX_SUCCESS;
+
+    switch (driver_req_ptr->nx_ip_driver_command)
+    {
+    case NX_LINK_INITIALIZE:
+        driver_req_ptr->nx_ip_driver_interface->nx_interface_ip_mtu_size = LINK_MTU;
+        driver_req_ptr->nx_ip_driver_interface->nx_interface_address_mapping_needed = NX_FALSE;
+        break;
+
+    case NX_LINK_ENABLE:
+        driver_req_ptr->nx_ip_driver_interface->nx_interface_link_up = NX_TRUE;
+        break;
+
+    case NX_LINK_PACKET_SEND:
+    case NX_LINK_PACKET_BROADCAST:
+        link_send(driver_req_ptr->nx_ip_driver_packet);
+        break;
+
+    case NX_LINK_ARP_SEND:
+    case NX_LINK_ARP_RESPONSE_SEND:
+    case NX_LINK_RARP_SEND:
+        nx_packet_transmit_release(driver_req_ptr->nx_ip_driver_packet);
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void bench_sendto(INT tx, INT rx, struct sockaddr_in *to, BenchResult_t *result)
+{
+    /* Static: the layer passes buffers through 32-bit integers, and the
+       Linux port runs threads on pthread stacks far above the image */
+    static CHAR payload[BENCH_PAYLOAD];
+    static CHAR buffer[BENCH_PAYLOAD];
+    static struct sockaddr_in from;
+    INT from_len;
+
+    memset(payload, 0x5A, sizeof(payload));
+
+    for (ULONG done = 0; done < bench_datagrams; done += BENCH_BATCH)
+    {
+        double t0 = now_ns();
+
+        for (UINT k = 0; k < BENCH_BATCH; k++)
+            sendto(tx, payload, sizeof(payload), 0, (struct sockaddr *)to, sizeof(*to));
+
+        double t1 = now_ns();
+
+        for (UINT k = 0; k < BENCH_BATCH; k++)
+        {
+            from_len = sizeof(from);
+            if (recvfrom(rx, buffer, sizeof(buffer), MSG_DONTWAIT, (struct sockaddr *)&from, &from_len) > 0)
+                result->received++;
+        }
+
+        result->sent += BENCH_BATCH;
+        result->send_ns += t1 - t0;
+        result->receive_ns += now_ns() - t1;
+    }
+}
+
+#ifdef NX_BSD_ENABLE_BATCH
+static void bench_mmsg(INT tx, INT rx, struct sockaddr_in *to, BenchResult_t *result, UINT zero_copy)
+{
+    static CHAR payload[BENCH_PAYLOAD];
+    static CHAR buffers[BENCH_BATCH][BENCH_PAYLOAD];
+    static struct sockaddr_in from[BENCH_BATCH];
+    static struct iovec send_iov[BENCH_BATCH], receive_iov[BENCH_BATCH];
+    static struct mmsghdr send_msgs[BENCH_BATCH], receive_msgs[BENCH_BATCH];
+    NX_PACKET *packets[BENCH_BATCH];
+    INT count;
+
+    memset(payload, 0x5A, sizeof(payload));
+
+    for (UINT k = 0; k < BENCH_BATCH; k++)
+    {
+        send_iov[k].iov_base = payload;
+        send_iov[k].iov_len = sizeof(payload);
+        memset(&send_msgs[k], 0, sizeof(send_msgs[k]));
+        send_msgs[k].msg_hdr.msg_name = to;
+        send_msgs[k].msg_hdr.msg_namelen = sizeof(*to);
+        send_msgs[k].msg_hdr.msg_iov = &send_iov[k];
+        send_msgs[k].msg_hdr.msg_iovlen = 1;
+
+        receive_iov[k].iov_base = buffers[k];
+        receive_iov[k].iov_len = sizeof(buffers[k]);
+        memset(&receive_msgs[k], 0, sizeof(receive_msgs[k]));
+        receive_msgs[k].msg_hdr.msg_iov = &receive_iov[k];
+        receive_msgs[k].msg_hdr.msg_iovlen = 1;
+    }
+
+    for (ULONG done = 0; done < bench_datagrams; done += BENCH_BATCH)
+    {
+        double t0 = now_ns();
+
+        sendmmsg(tx, send_msgs, BENCH_BATCH, 0);
+
+        double t1 = now_ns();
+
+        if (zero_copy)
+        {
+            count = nx_bsd_recvmmsg_packets(rx, packets, BENCH_BATCH, MSG_DONTWAIT, NX_NULL);
+            for (INT k = 0; k < count; k++)
+                nx_packet_release(packets[k]);
+        }
+        else
+        {
+            for (UINT k = 0; k < BENCH_BATCH; k++)
+            {
+                receive_msgs[k].msg_hdr.msg_name = &from[k];
+                receive_msgs[k].msg_hdr.msg_namelen = sizeof(from[k]);
+            }
+            count = recvmmsg(rx, receive_msgs, BENCH_BATCH, MSG_DONTWAIT, NX_NULL);
+        }
+
+        if (count > 0)
+            result->received += (ULONG)count;
+
+        result->sent += BENCH_BATCH;
+        result->send_ns += t1 - t0;
+        result->receive_ns += now_ns() - t1;
+    }
+}
+#endif /* NX_BSD_ENABLE_BATCH */
+
+static void bench_print(const char *name, const BenchResult_t *result)
+{
+    double total_ns = result->send_ns + result->receive_ns;
+
+    printf("%-10s %12.0f %12.0f %12.0f %10lu\n", name,
+           (double)result->sent * 1e9 / result->send_ns,
+           (double)result->sent * 1e9 / result->receive_ns,
+           (double)result->sent * 1e9 / total_ns,
+           (unsigned long)result->received);
+    fflush(stdout);
+}
+
+static void bench_entry(ULONG input)
+{
+    struct sockaddr_in local;
+    struct sockaddr_in to;
+    BenchResult_t result;
+    INT tx;
+    INT rx;
+
+    (void)input;
+
+    tx = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    rx = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_port = htons(BENCH_PORT);
+    local.sin_addr.s_addr = INADDR_ANY;
+    if (tx < 0 || rx < 0 || bind(rx, (struct sockaddr *)&local, sizeof(local)) < 0)
+    {
+        printf("socket setup failed: %d %d errno %d\n", tx, rx, errno);
+        exit(1);
+    }
+
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(BENCH_PORT);
+    to.sin_addr.s_addr = htonl(IP_ADDRESS(10, 0, 0, 1));
+
+    printf("%u byte datagrams, batches of %u, queue %u, %lu datagrams per row\n\n",
+           (UINT)BENCH_PAYLOAD, (UINT)BENCH_BATCH, (UINT)NX_BSD_SOCKET_QUEUE_MAX,
+           (unsigned long)bench_datagrams);
+    printf("%-10s %12s %12s %12s %10s\n", "path", "send_dps", "recv_dps", "total_dps", "received");
+
+    memset(&result, 0, sizeof(result));
+    bench_sendto(tx, rx, &to, &result);
+    bench_print("sendto", &result);
+
+#ifdef NX_BSD_ENABLE_BATCH
+    memset(&result, 0, sizeof(result));
+    bench_mmsg(tx, rx, &to, &result, NX_FALSE);
+    bench_print("mmsg", &result);
+
+    memset(&result, 0, sizeof(result));
+    bench_mmsg(tx, rx, &to, &result, NX_TRUE);
+    bench_print("zerocopy", &result);
+#endif /* NX_BSD_ENABLE_BATCH */
+
+    exit(0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+    (void)first_unused_memory;
+
+    nx_system_initialize();
+
+    nx_packet_pool_create(&pool, "Pool", BENCH_PACKET_SIZE, pool_memory, sizeof(pool_memory));
+    nx_ip_create(&ip, "IP", IP_ADDRESS(10, 0, 0, 1), 0xFFFFFF00UL, &pool, link_driver,
+                 ip_stack, sizeof(ip_stack), 1);
+    nx_udp_enable(&ip);
+    nx_tcp_enable(&ip);
+
+    INT status = bsd_initialize(&ip, &pool, (CHAR *)bsd_stack, sizeof(bsd_stack), 2);
+    if (status != NX_SOC_OK)
+    {
+        printf("bsd_initialize failed %d\n", status);
+        exit(1);
+    }
+
+    tx_thread_create(&bench_thread, "Bench", bench_entry, 0, bench_stack, sizeof(bench_stack),
+                     10, 10, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        bench_datagrams = strtoul(argv[1], NULL, 0);
+
+    tx_kernel_enter();
+    return 0;
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
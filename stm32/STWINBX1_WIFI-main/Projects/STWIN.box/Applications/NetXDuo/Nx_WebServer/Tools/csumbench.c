@@ -0,0 +1,249 @@
+/**
+  ******************************************************************************
+  * @file    csumbench.c
+  * @author  Wind Turbine Team
+  * @brief   Host benchmark: Internet checksum engine (NetX Duo Linux port)
+  ******************************************************************************
+  * First checks _nx_ip_checksum_partial, _nx_ip_checksum_copy_partial and
+  * _nx_ip_checksum_compute (single and chained packets) against a byte-wise
+  * RFC 1071 sum for random lengths and offsets, then times per packet size:
+  *
+  *   legacy     the previous _nx_ip_checksum_compute loop, two 16-bit adds
+  *              per 32-bit word
+  *   partial    _nx_ip_checksum_partial
+  *   copy+sum   memcpy into the packet, then _nx_ip_checksum_partial
+  *   fused      _nx_ip_checksum_copy_partial
+  *
+  *   TX=../../../../../../Middlewares/ST/threadx
+  *   NX=../../../../../../Middlewares/ST/netxduo
+  *   gcc -O2 -D_GNU_SOURCE -DNX_INCLUDE_USER_DEFINE_FILE -I../NetXDuo/App \
+  *       -I$TX/common/inc -I$TX/ports/linux/gnu/inc \
+  *       -I$NX/common/inc -I$NX/ports/linux/gnu/inc \
+  *       -o csumbench csumbench.c $NX/common/src/nx_ip_checksum_*.c \
+  *       $NX/common/src/nx_packet_*.c $NX/common/src/nxe_packet_*.c \
+  *       $TX/common/src/tx*.c $TX/ports/linux/gnu/src/tx*.c -lpthread -lrt
+  *   ./csumbench [megabytes per row]
+  *
+  * The host compiler may vectorize any of the loops; compare the columns,
+  * not against the target.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tx_api.h"
+#include "nx_api.h"
+#include "nx_ip.h"
+
+#define BENCH_MAX_SIZE          1600
+#define BENCH_CHECKS            20000
+#define BENCH_CHAIN_PAYLOAD     256         /* Small packets so long data is chained */
+#define BENCH_CHAIN_PACKETS     16
+#define BENCH_SEED              12345U
+
+static TX_THREAD bench_thread;
+static ULONG bench_stack[4096];
+static NX_PACKET_POOL bench_pool;
+static ULONG bench_pool_storage[((BENCH_CHAIN_PAYLOAD + sizeof(NX_PACKET)) * BENCH_CHAIN_PACKETS) / sizeof(ULONG) + 1];
+
+static ULONG bench_src[BENCH_MAX_SIZE / sizeof(ULONG) + 2];
+static ULONG bench_dst[BENCH_MAX_SIZE / sizeof(ULONG) + 2];
+static unsigned long bench_megabytes = 256UL;
+static volatile ULONG bench_sink;
+
+static const UINT bench_sizes[] = { 64, 128, 256, 512, 1024, 1500 };
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static ULONG fold16(ULONG sum)
+{
+    sum = (sum & 0xFFFFU) + (sum >> 16);
+    sum = (sum & 0xFFFFU) + (sum >> 16);
+    return sum;
+}
+
+/* RFC 1071 over bytes, 16-bit words in memory order */
+static ULONG reference_sum(const UCHAR *data, UINT length)
+{
+    ULONG sum = 0;
+    USHORT word;
+
+    while (length >= 2)
+    {
+        memcpy(&word, data, 2);
+        sum += word;
+        data += 2;
+        length -= 2;
+    }
+    if (length)
+    {
+        word = 0;
+        memcpy(&word, data, 1);
+        sum += word;
+    }
+    return fold16(sum);
+}
+
+/* The word loop _nx_ip_checksum_compute had before the partial sum */
+static ULONG legacy_sum(const ULONG *long_ptr, UINT words)
+{
+    ULONG checksum = 0;
+
+    while (words--)
+    {
+        checksum += (*long_ptr & NX_LOWER_16_MASK);
+        checksum += (*long_ptr >> NX_SHIFT_BY_16);
+        long_ptr++;
+    }
+    return fold16(checksum);
+}
+
+static void fill_random(UCHAR *data, UINT length)
+{
+    for (UINT i = 0; i < length; i++)
+        data[i] = (UCHAR)(rand() >> 7);
+}
+
+static UINT check_engine(void)
+{
+    UCHAR *src = (UCHAR *)bench_src;
+    UCHAR *dst = (UCHAR *)bench_dst;
+    UINT errors = 0;
+
+    for (UINT i = 0; i < BENCH_CHECKS; i++)
+    {
+        UINT length = (UINT)rand() % (BENCH_MAX_SIZE - 8);
+        UINT src_offset = (UINT)rand() % 4U;
+        UINT dst_offset = (UINT)rand() % 4U;
+        ULONG expected;
+
+        fill_random(src + src_offset, length);
+        expected = reference_sum(src + src_offset, length);
+
+        if (_nx_ip_checksum_partial(src + src_offset, length, 0) != expected)
+            errors++;
+        if (_nx_ip_checksum_copy_partial(dst + dst_offset, src + src_offset, length, 0) != expected ||
+            memcmp(dst + dst_offset, src + src_offset, length) != 0)
+            errors++;
+    }
+    return errors;
+}
+
+/* ICMP has no pseudo header, so the packet checksum is the plain sum */
+static UINT check_packets(void)
+{
+    UCHAR *src = (UCHAR *)bench_src;
+    UINT errors = 0;
+
+    for (UINT i = 0; i < BENCH_CHECKS / 10; i++)
+    {
+        NX_PACKET *packet;
+        UINT length = 1U + (UINT)rand() % (BENCH_MAX_SIZE - 8);
+        USHORT expected;
+
+        fill_random(src, length);
+        expected = (USHORT)reference_sum(src, length);
+        NX_CHANGE_USHORT_ENDIAN(expected);
+
+        if (nx_packet_allocate(&bench_pool, &packet, NX_RECEIVE_PACKET, NX_NO_WAIT) != NX_SUCCESS)
+            return errors + 1U;
+        nx_packet_data_append(packet, src, length, &bench_pool, NX_NO_WAIT);
+        if (packet -> nx_packet_length != length ||
+            _nx_ip_checksum_compute(packet, NX_PROTOCOL_ICMP, length, NX_NULL, NX_NULL) != expected)
+            errors++;
+        nx_packet_release(packet);
+    }
+    return errors;
+}
+
+static void bench_row(UINT size)
+{
+    UCHAR *src = (UCHAR *)bench_src;
+    UCHAR *dst = (UCHAR *)bench_dst;
+    unsigned long rounds = (bench_megabytes << 20) / size;
+    double t0, t_legacy, t_partial, t_copy, t_fused;
+    ULONG sum = 0;
+
+    fill_random(src, size);
+
+    t0 = now_ns();
+    for (unsigned long r = 0; r < rounds; r++)
+    {
+        sum += legacy_sum(bench_src, size / 4U);
+        __asm__ volatile("" ::: "memory");
+    }
+    t_legacy = now_ns() - t0;
+
+    t0 = now_ns();
+    for (unsigned long r = 0; r < rounds; r++)
+    {
+        sum += _nx_ip_checksum_partial(src, size, 0);
+        __asm__ volatile("" ::: "memory");
+    }
+    t_partial = now_ns() - t0;
+
+    t0 = now_ns();
+    for (unsigned long r = 0; r < rounds; r++)
+    {
+        memcpy(dst, src, size);
+        sum += _nx_ip_checksum_partial(dst, size, 0);
+        __asm__ volatile("" ::: "memory");
+    }
+    t_copy = now_ns() - t0;
+
+    t0 = now_ns();
+    for (unsigned long r = 0; r < rounds; r++)
+    {
+        sum += _nx_ip_checksum_copy_partial(dst, src, size, 0);
+        __asm__ volatile("" ::: "memory");
+    }
+    t_fused = now_ns() - t0;
+
+    bench_sink = sum;
+    printf("%6u %10.1f %10.1f %10.1f %10.1f\n", size,
+           t_legacy / rounds, t_partial / rounds, t_copy / rounds, t_fused / rounds);
+}
+
+static void bench_entry(ULONG input)
+{
+    UINT engine_errors, packet_errors;
+
+    (void)input;
+
+    srand(BENCH_SEED);
+    engine_errors = check_engine();
+    packet_errors = check_packets();
+    printf("check: %u engine errors, %u packet errors\n", engine_errors, packet_errors);
+
+    printf("%6s %10s %10s %10s %10s   (ns per packet)\n", "bytes", "legacy", "partial", "copy+sum", "fused");
+    for (UINT i = 0; i < sizeof(bench_sizes) / sizeof(bench_sizes[0]); i++)
+        bench_row(bench_sizes[i]);
+
+    exit((engine_errors || packet_errors) ? 1 : 0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+    (void)first_unused_memory;
+
+    nx_packet_pool_create(&bench_pool, "Bench pool", BENCH_CHAIN_PAYLOAD,
+                          bench_pool_storage, sizeof(bench_pool_storage));
+    tx_thread_create(&bench_thread, "Bench", bench_entry, 0, bench_stack, sizeof(bench_stack),
+                     1, 1, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        bench_megabytes = strtoul(argv[1], NULL, 0);
+
+    tx_kernel_enter();
+    return 0;
+}
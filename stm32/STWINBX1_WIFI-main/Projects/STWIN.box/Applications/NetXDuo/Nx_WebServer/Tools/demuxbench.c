@@ -0,0 +1,373 @@
+/**
+  ******************************************************************************
+  * @file    demuxbench.c
+  * @author  Wind Turbine Team
+  * @brief   Host benchmark: TCP/UDP port demultiplexing cost against socket
+  *          count (NetX Duo Linux port)
+  ******************************************************************************
+  * Two IP instances joined by a link that delivers at once. For each socket
+  * count, B accepts that many TCP connections on one port (the web server's
+  * case: every session shares port 80) and binds that many UDP sockets on
+  * consecutive ports. A pure ACK on every connection and a datagram to
+  * every UDP port are captured on the link instead of delivered, then
+  * replayed into B round-robin in batches of BENCH_BATCH frames. The bench
+  * thread queues a batch above the IP thread's priority, then drops below
+  * it and times the IP thread draining the batch: IPv4 receive, checksum,
+  * socket lookup and the socket's own processing of an ACK that changes
+  * nothing, or of a datagram that replaces the one queued.
+  *
+  * Round-robin traffic is the worst case for the move-to-front port bucket:
+  * the socket looked for is always the last one. Build with the defaults,
+  * then with the connection cache off and with larger port tables, and
+  * compare the rows:
+  *
+  *   TX=../../../../../../Middlewares/ST/threadx
+  *   NX=../../../../../../Middlewares/ST/netxduo
+  *   SRC="demuxbench.c $NX/common/src/nx*.c $TX/common/src/tx*.c $TX/ports/linux/gnu/src/tx*.c"
+  *   FLAGS="-O2 -no-pie -fno-pie -D_GNU_SOURCE -DNX_INCLUDE_USER_DEFINE_FILE \
+  *       -I../NetXDuo/App -I$TX/common/inc -I$TX/ports/linux/gnu/inc \
+  *       -I$NX/common/inc -I$NX/ports/linux/gnu/inc"
+  *   gcc $FLAGS -o demuxbench $SRC -lpthread -lrt
+  *   gcc $FLAGS -DNX_TCP_CONNECTION_CACHE_SIZE=0 -o demuxbench_nocache $SRC -lpthread -lrt
+  *   gcc $FLAGS -DNX_TCP_PORT_TABLE_SIZE=256 -DNX_UDP_PORT_TABLE_SIZE=256 -o demuxbench_256 $SRC -lpthread -lrt
+  *   ./demuxbench [frames per cell]
+  *
+  * Times include the Linux port's scheduling of one switch per batch;
+  * compare the builds on the same machine.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tx_api.h"
+#include "nx_api.h"
+#include "nx_ip.h"
+#include "nx_tcp.h"
+
+#define LINK_MTU                1500
+#define BENCH_PAYLOAD           256         /* ACKs, SYNs and short datagrams only */
+#define BENCH_MAX_SOCKETS       256
+#define BENCH_BATCH             512
+#define BENCH_PACKETS           (BENCH_MAX_SOCKETS + BENCH_BATCH + 256)
+#define BENCH_TCP_PORT          80
+#define BENCH_UDP_PORT_BASE     20000
+#define BENCH_FRAME_SIZE        128
+
+static const UINT bench_sockets[] = { 4, 16, 64, 256 };
+
+typedef struct
+{
+    UCHAR        data[BENCH_FRAME_SIZE];
+    ULONG        length;
+} BenchFrame_t;
+
+static TX_THREAD control_thread, accept_thread;
+static ULONG control_stack[4096], accept_stack[4096];
+static NX_PACKET_POOL pool_a, pool_b;
+static ULONG pool_a_memory[((BENCH_PAYLOAD + sizeof(NX_PACKET)) * BENCH_PACKETS) / sizeof(ULONG) + 4];
+static ULONG pool_b_memory[((BENCH_PAYLOAD + sizeof(NX_PACKET)) * BENCH_PACKETS) / sizeof(ULONG) + 4];
+static NX_IP ip_a, ip_b;
+static ULONG ip_a_stack[2048], ip_b_stack[2048];
+
+static NX_TCP_SOCKET clients[BENCH_MAX_SOCKETS], servers[BENCH_MAX_SOCKETS];
+static NX_UDP_SOCKET udp_sender, udp_receivers[BENCH_MAX_SOCKETS];
+
+static BenchFrame_t tcp_frames[BENCH_MAX_SOCKETS], udp_frames[BENCH_MAX_SOCKETS];
+static BenchFrame_t *volatile capture_frame;
+static volatile ULONG b_sent;
+
+static volatile UINT accept_count;
+static TX_SEMAPHORE accept_go, accept_done;
+
+static ULONG bench_frames = 200000;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Copy a frame into the peer pool and hand it over */
+static void link_deliver(NX_IP *to, const UCHAR *data, ULONG length)
+{
+    NX_PACKET *copy;
+
+    if (nx_packet_allocate(to->nx_ip_default_packet_pool, &copy, NX_RECEIVE_PACKET, NX_NO_WAIT) != NX_SUCCESS)
+        return;
+
+    memcpy(copy->nx_packet_prepend_ptr, data, length);
+    copy->nx_packet_append_ptr = copy->nx_packet_prepend_ptr + length;
+    copy->nx_packet_length = length;
+    copy->nx_packet_ip_interface = &to->nx_ip_interface[0];
+
+    _nx_ip_packet_deferred_receive(to, copy);
+}
+
+static void link_send(NX_IP *ip_ptr, NX_PACKET *packet_ptr)
+{
+    static UCHAR frame[LINK_MTU];
+    BenchFrame_t *capture = capture_frame;
+    ULONG length;
+
+    nx_packet_data_extract_offset(packet_ptr, 0, frame, sizeof(frame), &length);
+
+    if (ip_ptr == &ip_a && capture && length <= BENCH_FRAME_SIZE)
+    {
+        /* Keep the frame for replay instead of delivering it */
+        memcpy(capture->data, frame, length);
+        capture->length = length;
+        capture_frame = NX_NULL;
+    }
+    else
+    {
+        if (ip_ptr == &ip_b)
+            b_sent++;
+        link_deliver((ip_ptr == &ip_a) ? &ip_b : &ip_a, frame, length);
+    }
+
+    nx_packet_transmit_release(packet_ptr);
+}
+
+static void link_driver(NX_IP_DRIVER *driver_req_ptr)
+{
+    driver_req_ptr->nx_ip_driver_status = NX_SUCCESS;
+
+    switch (driver_req_ptr->nx_ip_driver_command)
+    {
+    case NX_LINK_INITIALIZE:
+        driver_req_ptr->nx_ip_driver_interface->nx_interface_ip_mtu_size = LINK_MTU;
+        driver_req_ptr->nx_ip_driver_interface->nx_interface_address_mapping_needed = NX_FALSE;
+        break;
+
+    case NX_LINK_ENABLE:
+        driver_req_ptr->nx_ip_driver_interface->nx_interface_link_up = NX_TRUE;
+        break;
+
+    case NX_LINK_PACKET_SEND:
+    case NX_LINK_PACKET_BROADCAST:
+        link_send(driver_req_ptr->nx_ip_driver_ptr, driver_req_ptr->nx_ip_driver_packet);
+        break;
+
+    case NX_LINK_ARP_SEND:
+    case NX_LINK_ARP_RESPONSE_SEND:
+    case NX_LINK_RARP_SEND:
+        nx_packet_transmit_release(driver_req_ptr->nx_ip_driver_packet);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/* Server side: one socket per connection, all on BENCH_TCP_PORT */
+static void accept_entry(ULONG input)
+{
+    (void)input;
+
+    for (;;)
+    {
+        UINT count;
+
+        tx_semaphore_get(&accept_go, TX_WAIT_FOREVER);
+        count = accept_count;
+
+        for (UINT i = 0; i < count; i++)
+        {
+            nx_tcp_socket_create(&ip_b, &servers[i], "Server", NX_IP_NORMAL, NX_FRAGMENT_OKAY,
+                                 NX_IP_TIME_TO_LIVE, 8192, NX_NULL, NX_NULL);
+            if (i == 0U)
+                nx_tcp_server_socket_listen(&ip_b, BENCH_TCP_PORT, &servers[i], count, NX_NULL);
+            else
+                nx_tcp_server_socket_relisten(&ip_b, BENCH_TCP_PORT, &servers[i]);
+            nx_tcp_server_socket_accept(&servers[i], NX_WAIT_FOREVER);
+        }
+
+        tx_semaphore_put(&accept_done);
+    }
+}
+
+static UINT bench_setup(UINT count)
+{
+    UINT status = NX_SUCCESS;
+
+    accept_count = count;
+    tx_semaphore_put(&accept_go);
+
+    for (UINT i = 0; i < count && status == NX_SUCCESS; i++)
+    {
+        nx_tcp_socket_create(&ip_a, &clients[i], "Client", NX_IP_NORMAL, NX_FRAGMENT_OKAY,
+                             NX_IP_TIME_TO_LIVE, 8192, NX_NULL, NX_NULL);
+        nx_tcp_client_socket_bind(&clients[i], NX_ANY_PORT, NX_WAIT_FOREVER);
+        status = nx_tcp_client_socket_connect(&clients[i], IP_ADDRESS(10, 0, 0, 2), BENCH_TCP_PORT,
+                                              5 * NX_IP_PERIODIC_RATE);
+    }
+    if (status != NX_SUCCESS || tx_semaphore_get(&accept_done, 5 * NX_IP_PERIODIC_RATE) != TX_SUCCESS)
+        return NX_NOT_CONNECTED;
+
+    for (UINT i = 0; i < count; i++)
+    {
+        nx_udp_socket_create(&ip_b, &udp_receivers[i], "Receiver", NX_IP_NORMAL, NX_FRAGMENT_OKAY,
+                             NX_IP_TIME_TO_LIVE, 1);
+        nx_udp_socket_bind(&udp_receivers[i], BENCH_UDP_PORT_BASE + i, NX_NO_WAIT);
+    }
+
+    /* Capture one pure ACK per connection and one datagram per UDP port */
+    for (UINT i = 0; i < count; i++)
+    {
+        NX_PACKET *packet_ptr;
+
+        capture_frame = &tcp_frames[i];
+        tx_mutex_get(&ip_a.nx_ip_protection, TX_WAIT_FOREVER);
+        _nx_tcp_packet_send_ack(&clients[i], clients[i].nx_tcp_socket_tx_sequence);
+        tx_mutex_put(&ip_a.nx_ip_protection);
+
+        capture_frame = &udp_frames[i];
+        nx_packet_allocate(&pool_a, &packet_ptr, NX_UDP_PACKET, NX_WAIT_FOREVER);
+        nx_packet_data_append(packet_ptr, "telemetry", 9, &pool_a, NX_WAIT_FOREVER);
+        if (nx_udp_socket_send(&udp_sender, packet_ptr, IP_ADDRESS(10, 0, 0, 2), BENCH_UDP_PORT_BASE + i) != NX_SUCCESS)
+            nx_packet_release(packet_ptr);
+
+        if (capture_frame || tcp_frames[i].length == 0U || udp_frames[i].length == 0U)
+            status = NX_NOT_SUCCESSFUL;
+    }
+    capture_frame = NX_NULL;
+
+    return status;
+}
+
+static void bench_teardown(UINT count)
+{
+    for (UINT i = 0; i < count; i++)
+    {
+        nx_udp_socket_unbind(&udp_receivers[i]);
+        nx_udp_socket_delete(&udp_receivers[i]);
+    }
+
+    for (UINT i = 0; i < count; i++)
+    {
+        nx_tcp_socket_disconnect(&clients[i], NX_NO_WAIT);
+        nx_tcp_client_socket_unbind(&clients[i]);
+        nx_tcp_socket_delete(&clients[i]);
+    }
+
+    tx_thread_sleep(NX_IP_PERIODIC_RATE / 10);
+
+    for (UINT i = 0; i < count; i++)
+    {
+        nx_tcp_socket_disconnect(&servers[i], NX_NO_WAIT);
+        nx_tcp_server_socket_unaccept(&servers[i]);
+        nx_tcp_socket_delete(&servers[i]);
+    }
+    nx_tcp_server_socket_unlisten(&ip_b, BENCH_TCP_PORT);
+}
+
+/* Replay the captured frames round-robin; returns ns per frame */
+static double bench_replay(const BenchFrame_t *frames, UINT count)
+{
+    TX_THREAD *self = tx_thread_identify();
+    UINT old_priority;
+    ULONG done = 0;
+    UINT next = 0;
+    double total = 0.0;
+
+    while (done < bench_frames)
+    {
+        ULONG batch = (bench_frames - done < BENCH_BATCH) ? bench_frames - done : BENCH_BATCH;
+        double t0;
+
+        /* Above the IP thread while queueing, so it sees the whole batch at once */
+        tx_thread_priority_change(self, 0, &old_priority);
+        for (ULONG k = 0; k < batch; k++)
+        {
+            link_deliver(&ip_b, frames[next].data, frames[next].length);
+            if (++next == count)
+                next = 0;
+        }
+
+        t0 = now_ns();
+        tx_thread_priority_change(self, old_priority, &old_priority);
+        total += now_ns() - t0;
+        done += batch;
+    }
+
+    return total / (double)bench_frames;
+}
+
+static void control_entry(ULONG input)
+{
+    (void)input;
+
+    nx_udp_socket_create(&ip_a, &udp_sender, "Sender", NX_IP_NORMAL, NX_FRAGMENT_OKAY, NX_IP_TIME_TO_LIVE, 4);
+    nx_udp_socket_bind(&udp_sender, NX_ANY_PORT, NX_NO_WAIT);
+
+    printf("port tables tcp %u udp %u, connection cache %u, %lu frames per cell\n\n",
+           (UINT)NX_TCP_PORT_TABLE_SIZE, (UINT)NX_UDP_PORT_TABLE_SIZE, (UINT)NX_TCP_CONNECTION_CACHE_SIZE,
+           (unsigned long)bench_frames);
+    printf("%8s %12s %12s %10s\n", "sockets", "tcp_ns", "udp_ns", "b_replies");
+
+    for (UINT s = 0; s < sizeof(bench_sockets) / sizeof(bench_sockets[0]); s++)
+    {
+        UINT count = bench_sockets[s];
+        double tcp_ns;
+        double udp_ns;
+        ULONG replies;
+
+        if (bench_setup(count) != NX_SUCCESS)
+        {
+            printf("%8u setup failed\n", count);
+            exit(1);
+        }
+
+        b_sent = 0;
+        tcp_ns = bench_replay(tcp_frames, count);
+        udp_ns = bench_replay(udp_frames, count);
+        replies = b_sent;
+
+        printf("%8u %12.0f %12.0f %10lu\n", count, tcp_ns, udp_ns, (unsigned long)replies);
+        fflush(stdout);
+
+        bench_teardown(count);
+    }
+
+    exit(0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+    (void)first_unused_memory;
+
+    nx_system_initialize();
+
+    nx_packet_pool_create(&pool_a, "Pool A", BENCH_PAYLOAD, pool_a_memory, sizeof(pool_a_memory));
+    nx_packet_pool_create(&pool_b, "Pool B", BENCH_PAYLOAD, pool_b_memory, sizeof(pool_b_memory));
+
+    nx_ip_create(&ip_a, "IP A", IP_ADDRESS(10, 0, 0, 1), 0xFFFFFF00UL, &pool_a, link_driver,
+                 ip_a_stack, sizeof(ip_a_stack), 1);
+    nx_ip_create(&ip_b, "IP B", IP_ADDRESS(10, 0, 0, 2), 0xFFFFFF00UL, &pool_b, link_driver,
+                 ip_b_stack, sizeof(ip_b_stack), 1);
+    nx_tcp_enable(&ip_a);
+    nx_tcp_enable(&ip_b);
+    nx_udp_enable(&ip_a);
+    nx_udp_enable(&ip_b);
+
+    tx_semaphore_create(&accept_go, "Accept Go", 0);
+    tx_semaphore_create(&accept_done, "Accept Done", 0);
+    tx_thread_create(&accept_thread, "Accept", accept_entry, 0, accept_stack, sizeof(accept_stack),
+                     10, 10, TX_NO_TIME_SLICE, TX_AUTO_START);
+    tx_thread_create(&control_thread, "Control", control_entry, 0, control_stack, sizeof(control_stack),
+                     11, 11, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        bench_frames = strtoul(argv[1], NULL, 0);
+
+    tx_kernel_enter();
+    return 0;
+}
+
+/************************ (C) COPYRIGHT Wind Turbine Team *****END OF FILE****/
@@ -0,0 +1,163 @@
+/**
+  ******************************************************************************
+  * @file    dspbench.c
+  * @author  Wind Turbine Team
+  * @brief   Host benchmark: DSP pool scaling from 1 to N cores (ThreadX SMP Linux port)
+  ******************************************************************************
+  * Runs the packet feature jobs (feature_jobs.c) on the work-stealing pool
+  * with 1 .. TX_THREAD_SMP_MAX_CORES participants and checks every result
+  * against the single-pass AudioFeatures_*() calls:
+  *
+  *   TX=../../../../../../Middlewares/ST/threadx
+  *   gcc -O2 -D_GNU_SOURCE -I../Core/Inc -I$TX/common_smp/inc -I$TX/ports_smp/linux/gnu/inc \
+  *       -o dspbench dspbench.c ../Core/Src/dsp_pool.c ../Core/Src/feature_jobs.c \
+  *       ../Core/Src/audio_features.c \
+  *       $TX/common_smp/src/tx*.c $TX/ports_smp/linux/gnu/src/tx*.c -lpthread -lrt -lm
+  *   sudo ./dspbench [packets]
+  *
+  * Do not define TX_LINUX_MULTI_CORE: with it the port pins the whole process
+  * to host CPU 0 and every row measures one core. The port needs privileges
+  * for pthread_setschedparam(). Speedup needs at least as many idle host
+  * CPUs as virtual cores (4 in the port's tx_port.h).
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "tx_api.h"
+#include "dsp_pool.h"
+#include "feature_jobs.h"
+#include "asset_image.h"
+
+#define BENCH_STACK_SIZE    (16 * 1024)
+#define BENCH_POOL_SIZE     ((DSP_POOL_WORKERS + 1) * (DSP_POOL_STACK_SIZE + 64))
+#define BENCH_PRIORITY      10
+
+static TX_THREAD bench_thread;
+static ULONG bench_stack[BENCH_STACK_SIZE / sizeof(ULONG)];
+static TX_BYTE_POOL bench_pool;
+static ULONG bench_pool_storage[BENCH_POOL_SIZE / sizeof(ULONG)];
+
+static int16_t bench_samples[AUDIO_SAMPLES_PER_PACKET];
+static unsigned long bench_packets = 500UL;
+
+/* Host stand-ins for the firmware modules the pool and the features link against */
+UINT MemBudget_Allocate(TX_BYTE_POOL *pool, VOID **ptr, ULONG size, const CHAR *owner, const CHAR *purpose)
+{
+    (void)owner;
+    (void)purpose;
+    return tx_byte_allocate(pool, ptr, size, TX_NO_WAIT);
+}
+
+const void *AssetImage_Find(const char *name, uint16_t type, uint32_t *size)
+{
+    (void)name;
+    (void)type;
+    (void)size;
+    return NULL;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Two tones and noise, so every band, crossing and frame boundary is exercised */
+static void bench_signal(void)
+{
+    srand(1);
+    for (uint32_t n = 0; n < AUDIO_SAMPLES_PER_PACKET; n++)
+    {
+        double t = (double)n / AUDIO_SAMPLE_RATE;
+        double x = 9000.0 * sin(2.0 * M_PI * 440.0 * t) + 4000.0 * sin(2.0 * M_PI * 5200.0 * t) +
+                   (double)(rand() % 2001 - 1000);
+
+        bench_samples[n] = (int16_t)x;
+    }
+    bench_samples[AUDIO_FRAME_SIZE] = -32768;       /* Peak in the second frame */
+}
+
+static int bench_matches(const FeatureJobs_Result_t *got)
+{
+    uint32_t bands[FFT_BANDS];
+
+    AudioFeatures_ComputeFFTBands(bench_samples, bands);
+    return got->rms_raw == AudioFeatures_CalculateRMS(bench_samples, AUDIO_SAMPLES_PER_PACKET) &&
+           got->zcr_rate == AudioFeatures_CalculateZCR(bench_samples, AUDIO_SAMPLES_PER_PACKET) &&
+           got->peak_amplitude == AudioFeatures_FindPeakAmplitude(bench_samples, AUDIO_SAMPLES_PER_PACKET) &&
+           memcmp(got->fft_band, bands, sizeof(bands)) == 0;
+}
+
+static void bench_entry(ULONG input)
+{
+    FeatureJobs_Result_t result;
+    DspPool_Stats_t before;
+    DspPool_Stats_t after;
+    double base = 0.0;
+    (void)input;
+
+    bench_signal();
+    if (DspPool_Init(&bench_pool, DSP_POOL_WORKERS, BENCH_PRIORITY) != TX_SUCCESS)
+    {
+        printf("DspPool_Init failed\n");
+        exit(1);
+    }
+
+    printf("%lu packets of %u samples, %u jobs each\n", bench_packets, AUDIO_SAMPLES_PER_PACKET,
+           (unsigned)FEATURE_JOBS_COUNT);
+
+    for (UINT workers = 0; workers <= DSP_POOL_WORKERS; workers++)
+    {
+        unsigned long errors = 0;
+        double start;
+        double per_packet;
+
+        DspPool_SetActiveWorkers(workers);
+        FeatureJobs_Compute(bench_samples, AUDIO_SAMPLES_PER_PACKET, &result);     /* Warm up */
+        DspPool_GetStats(&before);
+
+        start = now_ns();
+        for (unsigned long i = 0; i < bench_packets; i++)
+        {
+            if (FeatureJobs_Compute(bench_samples, AUDIO_SAMPLES_PER_PACKET, &result) != 0)
+                errors++;
+        }
+        per_packet = (now_ns() - start) / (double)bench_packets;
+        DspPool_GetStats(&after);
+
+        if (!bench_matches(&result))
+            errors++;
+        if (workers == 0)
+            base = per_packet;
+
+        printf("%u core%s %10.1f us/packet  x%.2f  %6lu steals  %6lu waits  %lu errors\n",
+               workers + 1, workers ? "s" : " ", per_packet / 1000.0, base / per_packet,
+               (unsigned long)(after.steals - before.steals), (unsigned long)(after.waits - before.waits),
+               errors);
+    }
+
+    exit(0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+    (void)first_unused_memory;
+
+    tx_byte_pool_create(&bench_pool, "Bench pool", bench_pool_storage, sizeof(bench_pool_storage));
+    tx_thread_create(&bench_thread, "Bench", bench_entry, 0, bench_stack, sizeof(bench_stack),
+                     BENCH_PRIORITY, BENCH_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        bench_packets = strtoul(argv[1], NULL, 0);
+
+    tx_kernel_enter();
+    return 0;
+}
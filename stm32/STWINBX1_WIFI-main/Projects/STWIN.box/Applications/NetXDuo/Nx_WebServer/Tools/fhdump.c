@@ -0,0 +1,120 @@
+/**
+  ******************************************************************************
+  * @file    fhdump.c
+  * @author  Wind Turbine Team
+  * @brief   Host decoder for feature history blocks (GET /GetHistory)
+  ******************************************************************************
+  * Uses the firmware codec as-is:
+  *
+  *   gcc -O2 -I../Core/Inc -o fhdump fhdump.c ../Core/Src/feature_history.c
+  *   curl -s http://<board-ip>/GetHistory -o history.bin
+  *   ./fhdump history.bin [from_ms to_ms [spl_min]] > history.csv
+  *
+  * Blocks outside the time window or below spl_min are skipped from their
+  * header, without decoding the payload.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "feature_history.h"
+
+int main(int argc, char **argv)
+{
+    static uint8_t data[1 << 20];
+    AudioTelemetryPacket_t records[FEATURE_HISTORY_BLOCK_RECORDS];
+    FeatureHistory_BlockHeader_t hdr;
+    uint32_t from_ms = 0;
+    uint32_t to_ms = 0xFFFFFFFFU;
+    uint16_t spl_min = 0;
+    uint32_t blocks = 0;
+    uint32_t skipped = 0;
+    uint32_t total = 0;
+    uint32_t offset = 0;
+    size_t len;
+    FILE *f;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s history.bin [from_ms to_ms [spl_min]]\n", argv[0]);
+        return 1;
+    }
+
+    if (argc >= 4)
+    {
+        from_ms = (uint32_t)strtoul(argv[2], NULL, 0);
+        to_ms = (uint32_t)strtoul(argv[3], NULL, 0);
+    }
+    if (argc >= 5)
+        spl_min = (uint16_t)strtoul(argv[4], NULL, 0);
+
+    f = fopen(argv[1], "rb");
+    if (!f)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    len = fread(data, 1, sizeof(data), f);
+    fclose(f);
+
+    printf("node,seq,timestamp_ms,uptime_sec,rms_raw,zcr_count,zcr_rate,spl_db,peak,"
+           "status_flags,error_count,band0,band1,band2,band3,band4,band5,band6,band7\n");
+
+    while (offset < len)
+    {
+        uint32_t size = FeatureHistory_BlockSize(data + offset, (uint32_t)(len - offset));
+        int count;
+
+        if (size == 0)
+        {
+            fprintf(stderr, "invalid block at offset %u\n", offset);
+            return 1;
+        }
+
+        memcpy(&hdr, data + offset, sizeof(hdr));
+        blocks++;
+
+        if (!FeatureHistory_BlockMayMatch(&hdr, from_ms, to_ms, spl_min))
+        {
+            skipped++;
+            offset += size;
+            continue;
+        }
+
+        count = FeatureHistory_DecodeBlock(data + offset, size, records, FEATURE_HISTORY_BLOCK_RECORDS);
+        if (count < 0)
+        {
+            fprintf(stderr, "corrupt block at offset %u\n", offset);
+            return 1;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            const AudioTelemetryPacket_t *p = &records[i];
+
+            if (p->timestamp_ms < from_ms || p->timestamp_ms > to_ms || p->spl_db < spl_min)
+                continue;
+
+            printf("%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u",
+                   p->node_id, p->seq_number, p->timestamp_ms, p->uptime_sec, p->rms_raw,
+                   p->zcr_count, p->zcr_rate, p->spl_db, p->peak_amplitude,
+                   p->status_flags, p->error_count);
+            for (int b = 0; b < FFT_BANDS; b++)
+                printf(",%u", p->fft_band[b]);
+            printf("\n");
+        }
+
+        total += (uint32_t)count;
+        offset += size;
+    }
+
+    fprintf(stderr, "%u blocks (%u skipped), %u records decoded, %u bytes",
+            blocks, skipped, total, (unsigned)len);
+    if (len && skipped == 0)
+        fprintf(stderr, ", %.1fx vs raw\n",
+                (double)(total * sizeof(AudioTelemetryPacket_t)) / (double)len);
+    else
+        fprintf(stderr, "\n");
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""Build the OSPI asset image (web content + DSP lookup tables).
+
+The layout must match Core/Inc/asset_image.h:
+
+    header   32 bytes   magic, version, entry_count, image_size, index_crc32
+    index    64 bytes per entry, sorted by name (firmware does a binary search)
+    payloads each aligned on ASSET_IMAGE_ALIGN
+
+Usage:
+    python3 Tools/mkassetimg.py -o asset_image.bin [--web Web_Content]
+
+Flash the output at ASSET_IMAGE_FLASH_OFFSET of the OctoSPI NOR, e.g. with
+STM32CubeProgrammer and the external loader of the board.
+"""
+
+import argparse
+import math
+import os
+import struct
+import sys
+import zlib
+
+ASSET_IMAGE_MAGIC = 0x49415457
+ASSET_IMAGE_VERSION = 1
+ASSET_IMAGE_NAME_MAX = 48
+ASSET_IMAGE_ALIGN = 32
+ASSET_IMAGE_MAX_SIZE = 0x00100000
+
+ASSET_TYPE_WEB = 1
+ASSET_TYPE_TABLE_F32 = 2
+ASSET_TYPE_TABLE_U16 = 3
+
+HEADER_FMT = "<IHHII16x"
+ENTRY_FMT = "<48sIIHHI"
+
+# Keep in sync with Core/Inc/audio_features.h and AudioFeatures_ComputeFFTBands()
+AUDIO_SAMPLE_RATE = 16000
+FFT_SIZE = 512
+FFT_BANDS = 8
+BAND_WIDTH_HZ = 1000
+
+
+def goertzel_table():
+    """{2*cos(w), cos(w), sin(w)} for bins 0 .. FFT_SIZE/2 - 1."""
+    bin_width = AUDIO_SAMPLE_RATE // FFT_SIZE
+    values = []
+    for k in range(FFT_SIZE // 2):
+        omega = 2.0 * math.pi * (k * bin_width) / AUDIO_SAMPLE_RATE
+        values += [2.0 * math.cos(omega), math.cos(omega), math.sin(omega)]
+    return struct.pack("<%df" % len(values), *values)
+
+
+def band_map():
+    """FFT_BANDS + 1 bin edges, same integer split as the firmware fallback."""
+    bins_per_band = BAND_WIDTH_HZ // (AUDIO_SAMPLE_RATE // FFT_SIZE)
+    edges = [min(b * bins_per_band, FFT_SIZE // 2) for b in range(FFT_BANDS + 1)]
+    return struct.pack("<%dH" % len(edges), *edges)
+
+
+def collect_web(root):
+    entries = []
+    for dirpath, _, files in os.walk(root):
+        for f in files:
+            path = os.path.join(dirpath, f)
+            url = "/" + os.path.relpath(path, root).replace(os.sep, "/")
+            with open(path, "rb") as fh:
+                entries.append((url, ASSET_TYPE_WEB, fh.read()))
+    return entries
+
+
+def align(value):
+    return (value + ASSET_IMAGE_ALIGN - 1) & ~(ASSET_IMAGE_ALIGN - 1)
+
+
+def build(entries):
+    entries.sort(key=lambda e: e[0].encode())
+    offset = align(struct.calcsize(HEADER_FMT) + len(entries) * struct.calcsize(ENTRY_FMT))
+
+    index = b""
+    payload = b""
+    for name, kind, data in entries:
+        raw = name.encode()
+        if len(raw) >= ASSET_IMAGE_NAME_MAX:
+            sys.exit("name too long: %s" % name)
+        index += struct.pack(ENTRY_FMT, raw, offset + len(payload), len(data), kind, 0, 0)
+        payload += data
+        payload += b"\0" * (align(len(payload)) - len(payload))
+
+    body_start = struct.calcsize(HEADER_FMT) + len(index)
+    image_size = offset + len(payload)
+    if image_size > ASSET_IMAGE_MAX_SIZE:
+        sys.exit("image too large: %d bytes" % image_size)
+
+    header = struct.pack(HEADER_FMT, ASSET_IMAGE_MAGIC, ASSET_IMAGE_VERSION, len(entries),
+                         image_size, zlib.crc32(index) & 0xFFFFFFFF)
+    return header + index + b"\0" * (offset - body_start) + payload
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("-o", "--output", default="asset_image.bin")
+    parser.add_argument("--web", default=os.path.join(here, "..", "Web_Content"))
+    args = parser.parse_args()
+
+    entries = collect_web(args.web)
+    entries.append(("dsp/goertzel_f32", ASSET_TYPE_TABLE_F32, goertzel_table()))
+    entries.append(("dsp/band_map_u16", ASSET_TYPE_TABLE_U16, band_map()))
+
+    image = build(entries)
+    with open(args.output, "wb") as fh:
+        fh.write(image)
+
+    print("%s: %d entries, %d bytes" % (args.output, len(entries), len(image)))
+
+
+if __name__ == "__main__":
+    main()
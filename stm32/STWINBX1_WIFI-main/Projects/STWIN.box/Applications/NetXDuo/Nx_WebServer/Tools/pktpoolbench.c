@@ -0,0 +1,345 @@
+/**
+  ******************************************************************************
+  * @file    pktpoolbench.c
+  * @author  Wind Turbine Team
+  * @brief   Host stress test: telemetry allocation latency, shared vs
+  *          partitioned packet pools (ThreadX / NetX Duo Linux ports)
+  ******************************************************************************
+  * Three load threads share the packets the way they do on the board:
+  *
+  *   driver     a burst of rx frames every tick from the main pool, held
+  *              while the stack processes them, dropped when the pool is
+  *              empty; also completes transmits, releasing sent packets
+  *   flood      iperf-like sender taking every packet it can and holding it
+  *              for the Wi-Fi transmit backlog, plus the web server pool
+  *              kept empty by an HTTP sender
+  *   telemetry  one datagram every BENCH_TELEMETRY_PERIOD ticks, sent in
+  *              one tick
+  *
+  * "shared" allocates telemetry and flood from the main pool, telemetry with
+  * TX_WAIT_FOREVER, as before the partitioning; "partitioned" goes through
+  * PacketPools_Allocate(). Each mode runs once idle and once flooded:
+  *
+  *   TX=../../../../../../Middlewares/ST/threadx
+  *   NX=../../../../../../Middlewares/ST/netxduo
+  *   gcc -O2 -D_GNU_SOURCE -DNX_INCLUDE_USER_DEFINE_FILE -I../NetXDuo/App \
+  *       -I../Core/Inc -I$TX/common/inc -I$TX/ports/linux/gnu/inc \
+  *       -I$NX/common/inc -I$NX/ports/linux/gnu/inc \
+  *       -o pktpoolbench pktpoolbench.c ../NetXDuo/App/app_packet_pools.c ../Core/Src/app_util.c \
+  *       $NX/common/src/nx_packet_*.c $NX/common/src/nxe_packet_*.c \
+  *       $TX/common/src/tx*.c $TX/ports/linux/gnu/src/tx*.c -lpthread -lrt
+  *   ./pktpoolbench [seconds per phase]
+  *
+  * Latencies include the Linux port's thread switching; compare the rows,
+  * not against the target.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tx_api.h"
+#include "nx_api.h"
+#include "app_packet_pools.h"
+#include "timer_wheel.h"
+
+#define BENCH_RX_PACKETS        10          /* AppPool */
+#define BENCH_RX_PAYLOAD        1544
+#define BENCH_HTTP_PACKETS      4           /* WebServerPool */
+#define BENCH_HTTP_PAYLOAD      1200
+#define BENCH_TELEMETRY_PACKETS 8
+#define BENCH_TELEMETRY_PAYLOAD 128
+
+#define BENCH_RX_BURST          2           /* Frames per tick */
+#define BENCH_RX_HOLD           3           /* Ticks the stack keeps a frame */
+#define BENCH_FLOOD_HOLD        8           /* Ticks a flood packet waits for the radio */
+#define BENCH_TELEMETRY_PERIOD  2
+#define BENCH_TELEMETRY_WAIT    1           /* Ticks, bounded wait of the partitioned mode */
+#define BENCH_HELD_MAX          32
+
+#define BENCH_POOL_BYTES(payload, count) (((payload) + sizeof(NX_PACKET)) * (count) + NX_PACKET_ALIGNMENT)
+
+typedef struct
+{
+    NX_PACKET *packet[BENCH_HELD_MAX];
+    ULONG      release_at[BENCH_HELD_MAX];
+    uint32_t   head;
+    uint32_t   count;
+} Bench_Held_t;
+
+typedef struct
+{
+    uint32_t sent;
+    uint32_t failed;
+    uint32_t flood_packets;
+    double   latency_sum_us;
+    double   latency_max_us;
+} Bench_Stats_t;
+
+static TX_THREAD bench_thread;
+static TX_THREAD bench_driver_thread;
+static TX_THREAD bench_telemetry_thread;
+static TX_THREAD bench_flood_thread;
+static ULONG bench_stack[4096];
+static ULONG bench_driver_stack[4096];
+static ULONG bench_telemetry_stack[4096];
+static ULONG bench_flood_stack[4096];
+
+static NX_PACKET_POOL bench_rx_pool;
+static NX_PACKET_POOL bench_http_pool;
+static NX_PACKET_POOL bench_telemetry_pool;
+static ULONG bench_rx_storage[BENCH_POOL_BYTES(BENCH_RX_PAYLOAD, BENCH_RX_PACKETS) / sizeof(ULONG) + 1];
+static ULONG bench_http_storage[BENCH_POOL_BYTES(BENCH_HTTP_PAYLOAD, BENCH_HTTP_PACKETS) / sizeof(ULONG) + 1];
+static ULONG bench_telemetry_storage[BENCH_POOL_BYTES(BENCH_TELEMETRY_PAYLOAD, BENCH_TELEMETRY_PACKETS) / sizeof(ULONG) + 1];
+
+static Bench_Held_t bench_rx_held;
+static Bench_Held_t bench_tx_held;          /* Sent, waiting for transmit completion */
+
+static volatile int bench_active;
+static volatile int bench_partitioned;
+static volatile int bench_flood;
+static Bench_Stats_t bench_stats;
+static unsigned long bench_seconds = 5UL;
+
+/* Counted by the Wi-Fi driver on the board, by the driver thread here */
+ULONG nx_driver_emw3080_rx_drops;
+
+/* High-water sampling is not needed here, allocations update the marks */
+UINT TimerWheel_Create(TimerWheel_Timer_t *timer, const CHAR *name,
+                       TimerWheel_Callback_t callback, ULONG input)
+{
+    (void)timer;
+    (void)name;
+    (void)callback;
+    (void)input;
+    return TX_SUCCESS;
+}
+
+UINT TimerWheel_Start(TimerWheel_Timer_t *timer, ULONG initial_ticks,
+                      ULONG period_ticks, ULONG slack_ticks)
+{
+    (void)timer;
+    (void)initial_ticks;
+    (void)period_ticks;
+    (void)slack_ticks;
+    return TX_SUCCESS;
+}
+
+static double now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+/* Queue a packet for release by the driver thread */
+static int held_push(Bench_Held_t *held, NX_PACKET *packet, ULONG hold_ticks)
+{
+    TX_INTERRUPT_SAVE_AREA
+    uint32_t slot;
+    int pushed = 0;
+
+    TX_DISABLE
+    if (held->count < BENCH_HELD_MAX)
+    {
+        slot = (held->head + held->count) % BENCH_HELD_MAX;
+        held->packet[slot] = packet;
+        held->release_at[slot] = tx_time_get() + hold_ticks;
+        held->count++;
+        pushed = 1;
+    }
+    TX_RESTORE
+
+    return pushed;
+}
+
+/* Release what is due, or everything when all is set */
+static void held_release(Bench_Held_t *held, int all)
+{
+    TX_INTERRUPT_SAVE_AREA
+    NX_PACKET *packet;
+    ULONG now = tx_time_get();
+
+    for (;;)
+    {
+        TX_DISABLE
+        if (!held->count || (!all && (LONG)(now - held->release_at[held->head]) < 0))
+        {
+            TX_RESTORE
+            break;
+        }
+        packet = held->packet[held->head];
+        held->head = (held->head + 1U) % BENCH_HELD_MAX;
+        held->count--;
+        TX_RESTORE
+
+        nx_packet_release(packet);
+    }
+}
+
+static void bench_driver_entry(ULONG input)
+{
+    NX_PACKET *packet;
+
+    (void)input;
+
+    for (;;)
+    {
+        held_release(&bench_tx_held, !bench_active);
+        held_release(&bench_rx_held, !bench_active);
+        if (bench_active)
+        {
+            for (int i = 0; i < BENCH_RX_BURST; i++)
+            {
+                if (nx_packet_allocate(&bench_rx_pool, &packet, NX_RECEIVE_PACKET, NX_NO_WAIT) != NX_SUCCESS)
+                    nx_driver_emw3080_rx_drops++;
+                else if (!held_push(&bench_rx_held, packet, BENCH_RX_HOLD))
+                    nx_packet_release(packet);
+            }
+        }
+        tx_thread_sleep(1);
+    }
+}
+
+static void bench_flood_entry(ULONG input)
+{
+    NX_PACKET *packet;
+    UINT status;
+
+    (void)input;
+
+    for (;;)
+    {
+        while (bench_active && bench_flood)
+        {
+            if (bench_partitioned)
+                status = PacketPools_Allocate(PACKET_CLASS_BULK, &packet, NX_UDP_PACKET, NX_NO_WAIT);
+            else
+                status = nx_packet_allocate(&bench_rx_pool, &packet, NX_UDP_PACKET, NX_NO_WAIT);
+            if (status != NX_SUCCESS)
+                status = nx_packet_allocate(&bench_http_pool, &packet, NX_TCP_PACKET, NX_NO_WAIT);
+            if (status != NX_SUCCESS)
+                break;
+            if (!held_push(&bench_tx_held, packet, BENCH_FLOOD_HOLD))
+            {
+                nx_packet_release(packet);
+                break;
+            }
+            bench_stats.flood_packets++;
+        }
+        tx_thread_sleep(1);
+    }
+}
+
+static void bench_telemetry_entry(ULONG input)
+{
+    NX_PACKET *packet;
+    UINT status;
+    double start, latency;
+
+    (void)input;
+
+    for (;;)
+    {
+        if (bench_active)
+        {
+            start = now_us();
+            if (bench_partitioned)
+                status = PacketPools_Allocate(PACKET_CLASS_TELEMETRY, &packet, NX_UDP_PACKET, BENCH_TELEMETRY_WAIT);
+            else
+                status = nx_packet_allocate(&bench_rx_pool, &packet, NX_UDP_PACKET, TX_WAIT_FOREVER);
+            latency = now_us() - start;
+
+            if (status == NX_SUCCESS)
+            {
+                bench_stats.sent++;
+                bench_stats.latency_sum_us += latency;
+                if (latency > bench_stats.latency_max_us)
+                    bench_stats.latency_max_us = latency;
+                if (!held_push(&bench_tx_held, packet, 1))
+                    nx_packet_release(packet);
+            }
+            else
+            {
+                bench_stats.failed++;
+            }
+        }
+        tx_thread_sleep(BENCH_TELEMETRY_PERIOD);
+    }
+}
+
+static void bench_phase(int partitioned, int flood)
+{
+    PacketPools_Stats_t telemetry;
+
+    memset(&bench_stats, 0, sizeof(bench_stats));
+    nx_driver_emw3080_rx_drops = 0;
+    PacketPools_Init();
+    PacketPools_Register(PACKET_CLASS_RX, &bench_rx_pool);
+    PacketPools_Register(PACKET_CLASS_HTTP, &bench_http_pool);
+    PacketPools_Register(PACKET_CLASS_TELEMETRY, &bench_telemetry_pool);
+
+    bench_partitioned = partitioned;
+    bench_flood = flood;
+    bench_active = 1;
+    tx_thread_sleep(bench_seconds * TX_TIMER_TICKS_PER_SECOND);
+    bench_active = 0;
+    tx_thread_sleep(BENCH_FLOOD_HOLD * 2);
+
+    PacketPools_GetStats(PACKET_CLASS_TELEMETRY, &telemetry);
+    printf("%-12s %-6s %8lu %6lu %10.1f %10.1f %9lu %9lu %9lu\n",
+           partitioned ? "partitioned" : "shared", flood ? "flood" : "idle",
+           (unsigned long)bench_stats.sent, (unsigned long)bench_stats.failed,
+           bench_stats.sent ? bench_stats.latency_sum_us / bench_stats.sent : 0.0,
+           bench_stats.latency_max_us, (unsigned long)nx_driver_emw3080_rx_drops,
+           (unsigned long)bench_stats.flood_packets, (unsigned long)telemetry.borrowed);
+}
+
+static void bench_entry(ULONG input)
+{
+    (void)input;
+
+    printf("%lu s per phase, %d ticks/s, rx reserve %d packets\n",
+           bench_seconds, (int)TX_TIMER_TICKS_PER_SECOND, PACKET_POOLS_RX_RESERVE);
+    printf("%-12s %-6s %8s %6s %10s %10s %9s %9s %9s\n",
+           "mode", "load", "sent", "failed", "avg_us", "max_us", "rx_drops", "flood", "borrowed");
+
+    bench_phase(0, 0);
+    bench_phase(0, 1);
+    bench_phase(1, 0);
+    bench_phase(1, 1);
+
+    exit(0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+    (void)first_unused_memory;
+
+    nx_packet_pool_create(&bench_rx_pool, "Bench rx pool", BENCH_RX_PAYLOAD,
+                          bench_rx_storage, BENCH_POOL_BYTES(BENCH_RX_PAYLOAD, BENCH_RX_PACKETS));
+    nx_packet_pool_create(&bench_http_pool, "Bench http pool", BENCH_HTTP_PAYLOAD,
+                          bench_http_storage, BENCH_POOL_BYTES(BENCH_HTTP_PAYLOAD, BENCH_HTTP_PACKETS));
+    nx_packet_pool_create(&bench_telemetry_pool, "Bench telemetry pool", BENCH_TELEMETRY_PAYLOAD,
+                          bench_telemetry_storage, BENCH_POOL_BYTES(BENCH_TELEMETRY_PAYLOAD, BENCH_TELEMETRY_PACKETS));
+
+    /* Board priorities: driver above telemetry above the senders */
+    tx_thread_create(&bench_thread, "Bench", bench_entry, 0, bench_stack, sizeof(bench_stack),
+                     1, 1, TX_NO_TIME_SLICE, TX_AUTO_START);
+    tx_thread_create(&bench_driver_thread, "Bench driver", bench_driver_entry, 0, bench_driver_stack,
+                     sizeof(bench_driver_stack), 2, 2, TX_NO_TIME_SLICE, TX_AUTO_START);
+    tx_thread_create(&bench_telemetry_thread, "Bench telemetry", bench_telemetry_entry, 0,
+                     bench_telemetry_stack, sizeof(bench_telemetry_stack), 5, 5, TX_NO_TIME_SLICE, TX_AUTO_START);
+    tx_thread_create(&bench_flood_thread, "Bench flood", bench_flood_entry, 0, bench_flood_stack,
+                     sizeof(bench_flood_stack), 12, 12, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        bench_seconds = strtoul(argv[1], NULL, 0);
+
+    tx_kernel_enter();
+    return 0;
+}
@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""Build-time RAM report from the GNU ld map file.
+
+Lists what the statically allocated RAM (.data, .bss, heap/stack reserve) is
+spent on, per output section, per object file and per symbol. The byte pools
+(tx_byte_pool_buffer, nx_byte_pool_buffer, ...) show up as symbols; what is
+carved out of them at runtime is reported by GET /GetMemBudget.
+
+The CubeIDE build writes the map next to the elf (compiled with
+-fdata-sections, so every static buffer has its own input section):
+
+    python3 Tools/ramreport.py STM32CubeIDE/Debug/Nx_WebServer.map [--top 25]
+"""
+
+import argparse
+import collections
+import os
+import re
+import sys
+
+RAM_SECTIONS = (".data", ".bss", ".noinit", "._user_heap_stack", ".tdata", ".tbss")
+
+OUTPUT_RE = re.compile(r"^(\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+))?")
+INPUT_RE = re.compile(r"^\s+(\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s*(.*))?$")
+CONT_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s*(.*)$")
+REGION_RE = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(\S+))?\s*$")
+
+
+def parse_regions(lines):
+    """Writable regions from the 'Memory Configuration' table."""
+    regions = []
+    inside = False
+    for line in lines:
+        if line.startswith("Memory Configuration"):
+            inside = True
+            continue
+        if inside and line.startswith("Linker script and memory map"):
+            break
+        match = REGION_RE.match(line) if inside else None
+        if match and match.group(1) != "*default*":
+            attrs = match.group(4) or ""
+            if "w" in attrs:
+                start = int(match.group(2), 16)
+                regions.append((match.group(1), start, start + int(match.group(3), 16)))
+    return regions
+
+
+def in_ram(name, address, regions):
+    if regions:
+        return any(start <= address < end for _, start, end in regions)
+    return name.startswith(RAM_SECTIONS)
+
+
+def object_name(path):
+    path = path.strip()
+    match = re.match(r"^(.*\.a)\((.*)\)$", path)
+    if match:
+        return "%s(%s)" % (os.path.basename(match.group(1)), match.group(2))
+    return os.path.basename(path)
+
+
+def symbol_name(section):
+    for prefix in (".bss.", ".data.", ".noinit.", ".tbss.", ".tdata."):
+        if section.startswith(prefix):
+            return section[len(prefix):]
+    return section
+
+
+def parse_map(path):
+    with open(path, "r", errors="replace") as f:
+        lines = f.read().splitlines()
+
+    regions = parse_regions(lines)
+    start = next((i for i, l in enumerate(lines) if l.startswith("Linker script and memory map")), 0)
+
+    outputs = collections.OrderedDict()
+    objects = collections.Counter()
+    symbols = collections.Counter()
+
+    current_ram = False
+    pending = None          # (kind, name) waiting for its address/size line
+
+    def add_output(name, address, size):
+        ram = in_ram(name, address, regions) and size > 0
+        if ram:
+            outputs[name] = size
+        return ram
+
+    def add_input(name, size, path):
+        if not current_ram or not size:
+            return
+        if name == "*fill*":
+            objects["(alignment fill)"] += size
+            return
+        obj = object_name(path) if path else "(linker)"
+        objects[obj] += size
+        symbols[(symbol_name(name), obj)] += size
+
+    for line in lines[start + 1:]:
+        if not line.strip():
+            continue
+
+        # Long section names put address and size on the next line
+        if pending:
+            match = CONT_RE.match(line)
+            kind, name = pending
+            pending = None
+            if match:
+                address, size = int(match.group(1), 16), int(match.group(2), 16)
+                if kind == "out":
+                    current_ram = add_output(name, address, size)
+                else:
+                    add_input(name, size, match.group(3))
+                continue
+
+        if not line[0].isspace():
+            match = OUTPUT_RE.match(line)
+            if match.group(2):
+                current_ram = add_output(match.group(1), int(match.group(2), 16), int(match.group(3), 16))
+            else:
+                current_ram = False
+                pending = ("out", match.group(1))
+            continue
+
+        if not current_ram:
+            continue
+
+        match = INPUT_RE.match(line)
+        if not match or match.group(1).startswith(("0x", "*(", "SORT", "KEEP")):
+            continue
+        if match.group(2):
+            add_input(match.group(1), int(match.group(3), 16), match.group(4))
+        elif match.group(1).startswith((".", "COMMON")):
+            pending = ("in", match.group(1))
+
+    return regions, outputs, objects, symbols
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("map", help="GNU ld map file")
+    parser.add_argument("--top", type=int, default=25, help="rows per table (default 25)")
+    args = parser.parse_args()
+
+    regions, outputs, objects, symbols = parse_map(args.map)
+    total = sum(outputs.values())
+
+    for name, start, end in regions:
+        print("%-10s 0x%08x  %8d bytes, %8d used by static data (%.1f%%)"
+              % (name, start, end - start, total, 100.0 * total / (end - start)))
+    print()
+
+    print("%-28s %10s" % ("output section", "bytes"))
+    for name, size in outputs.items():
+        print("%-28s %10d" % (name, size))
+    print("%-28s %10d" % ("total", total))
+    print()
+
+    print("%-40s %10s" % ("object", "bytes"))
+    for obj, size in objects.most_common(args.top):
+        print("%-40s %10d" % (obj, size))
+    print()
+
+    print("%-40s %-28s %10s" % ("symbol", "object", "bytes"))
+    for (sym, obj), size in symbols.most_common(args.top):
+        print("%-40s %-28s %10d" % (sym, obj, size))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,193 @@
+/**
+  ******************************************************************************
+  * @file    slabbench.c
+  * @author  Wind Turbine Team
+  * @brief   Host benchmark: slab allocator vs tx_byte_pool (ThreadX Linux port)
+  ******************************************************************************
+  * Replays an mx_wifi-like allocation pattern (mostly small IPC params, some
+  * full frames, a few buffers kept alive across calls) against both
+  * allocators with the same amount of memory:
+  *
+  *   TX=../../../../../../Middlewares/ST/threadx
+  *   gcc -O2 -D_GNU_SOURCE -I../Core/Inc -I$TX/common/inc -I$TX/ports/linux/gnu/inc \
+  *       -o slabbench slabbench.c ../Core/Src/slab_alloc.c \
+  *       $TX/common/src/tx*.c $TX/ports/linux/gnu/src/tx*.c -lpthread -lrt
+  *   ./slabbench [iterations]
+  *
+  * Absolute numbers include the Linux port's interrupt emulation; compare
+  * the two columns, not against the target.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tx_api.h"
+#include "slab_alloc.h"
+
+#define BENCH_LIVE_SLOTS    8           /* Buffers held at the same time */
+#define BENCH_SEED          12345U
+
+typedef struct
+{
+    const char *name;
+    void *(*alloc)(size_t size);
+    void (*release)(void *ptr);
+} Bench_Allocator_t;
+
+static TX_THREAD bench_thread;
+static ULONG bench_stack[4096];
+static TX_BYTE_POOL bench_byte_pool;
+static ULONG bench_byte_storage[SLAB_STORAGE_SIZE / sizeof(ULONG)];
+static unsigned long bench_iterations = 1000000UL;
+
+/* slab_alloc.c registers its storage with the memory budget */
+void MemBudget_RegisterStatic(const CHAR *owner, const CHAR *purpose, ULONG size)
+{
+    (void)owner;
+    (void)purpose;
+    (void)size;
+}
+
+static void *byte_pool_alloc(size_t size)
+{
+    VOID *ptr;
+
+    if (tx_byte_allocate(&bench_byte_pool, &ptr, (ULONG)size, TX_NO_WAIT) != TX_SUCCESS)
+        return NULL;
+    return ptr;
+}
+
+static void byte_pool_release(void *ptr)
+{
+    tx_byte_release(ptr);
+}
+
+static void *slab_alloc(size_t size)
+{
+    return Slab_Alloc(size);
+}
+
+static void slab_release(void *ptr)
+{
+    Slab_Free(ptr);
+}
+
+/* 70 % command params, 20 % control responses, 10 % full IPC frames */
+static size_t bench_size(unsigned int *seed)
+{
+    unsigned int r = (unsigned int)rand_r(seed) % 100U;
+
+    if (r < 70U)
+        return 16U + (size_t)rand_r(seed) % 48U;
+    if (r < 90U)
+        return 64U + (size_t)rand_r(seed) % 192U;
+    return 800U + (size_t)rand_r(seed) % 742U;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void bench_run(const Bench_Allocator_t *a)
+{
+    void *live[BENCH_LIVE_SLOTS] = {0};
+    unsigned int seed = BENCH_SEED;
+    unsigned long failures = 0;
+    double start;
+    double elapsed;
+
+    start = now_ns();
+    for (unsigned long i = 0; i < bench_iterations; i++)
+    {
+        unsigned int slot = (unsigned int)rand_r(&seed) % BENCH_LIVE_SLOTS;
+        size_t size = bench_size(&seed);
+        void *p;
+
+        /* Short-lived buffer: allocate, touch, release */
+        p = a->alloc(size);
+        if (p)
+        {
+            memset(p, 0, 16);
+            a->release(p);
+        }
+        else
+        {
+            failures++;
+        }
+
+        /* Long-lived buffer: replace one slot */
+        if (live[slot])
+            a->release(live[slot]);
+        live[slot] = a->alloc(bench_size(&seed));
+        if (!live[slot])
+            failures++;
+    }
+    elapsed = now_ns() - start;
+
+    for (unsigned int s = 0; s < BENCH_LIVE_SLOTS; s++)
+    {
+        if (live[s])
+            a->release(live[s]);
+    }
+
+    printf("%-12s %10.1f ns/op  %8lu failures\n", a->name,
+           elapsed / (double)(bench_iterations * 2UL), failures);
+}
+
+static void bench_entry(ULONG input)
+{
+    static const Bench_Allocator_t allocators[] =
+    {
+        { "tx_byte_pool", byte_pool_alloc, byte_pool_release },
+        { "slab",         slab_alloc,      slab_release      },
+    };
+    ULONG available;
+    ULONG fragments;
+
+    (void)input;
+
+    printf("%lu iterations, %u live buffers, %u bytes per allocator\n",
+           bench_iterations, BENCH_LIVE_SLOTS, (unsigned)SLAB_STORAGE_SIZE);
+
+    for (unsigned int i = 0; i < sizeof(allocators) / sizeof(allocators[0]); i++)
+        bench_run(&allocators[i]);
+
+    tx_byte_pool_info_get(&bench_byte_pool, TX_NULL, &available, &fragments, TX_NULL, TX_NULL, TX_NULL);
+    printf("tx_byte_pool after run: %lu bytes free in %lu fragments\n",
+           (unsigned long)available, (unsigned long)fragments);
+
+    for (uint32_t i = 0; i < Slab_GetClassCount(); i++)
+    {
+        Slab_ClassStats_t s;
+
+        Slab_GetClassStats(i, &s);
+        printf("slab %4u x %2u: max in use %2u, %9u allocs, %7u spills, %7u failures\n",
+               s.block_size, s.blocks, s.in_use_max, s.allocs, s.spills, s.failures);
+    }
+
+    exit(0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+    (void)first_unused_memory;
+
+    tx_byte_pool_create(&bench_byte_pool, "Bench byte pool", bench_byte_storage, sizeof(bench_byte_storage));
+    Slab_Init();
+    tx_thread_create(&bench_thread, "Bench", bench_entry, 0, bench_stack, sizeof(bench_stack),
+                     1, 1, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        bench_iterations = strtoul(argv[1], NULL, 0);
+
+    tx_kernel_enter();
+    return 0;
+}
@@ -0,0 +1,282 @@
+/**
+  ******************************************************************************
+  * @file    spscbench.c
+  * @author  Wind Turbine Team
+  * @brief   Host benchmark: SPSC ring vs tx_queue handoff (ThreadX Linux port)
+  ******************************************************************************
+  * Moves messages from a producer thread to a consumer thread, once through
+  * tx_queue and once through the ring, for a 4-byte message and a 1 KB one
+  * (an audio frame):
+  *
+  *   TX=../../../../../../Middlewares/ST/threadx
+  *   gcc -O2 -D_GNU_SOURCE -I../Core/Inc -I$TX/common/inc -I$TX/ports/linux/gnu/inc \
+  *       -o spscbench spscbench.c ../Core/Src/spsc_ring.c \
+  *       $TX/common/src/tx*.c $TX/ports/linux/gnu/src/tx*.c -lpthread -lrt
+  *   ./spscbench [messages]
+  *
+  * tx_queue messages are at most 16 words, so the 1 KB case queues a pointer
+  * to a tx_block_pool buffer, which is how a frame would have to travel.
+  *
+  * Three schedules: "inline" puts and gets a full channel from one thread,
+  * so it times the handoff calls alone; "wake" runs the consumer above the
+  * producer (as feature extraction sits above acquisition), so every
+  * message is a wakeup; "burst" runs them at the same priority and the
+  * producer yields only when the channel is full, so the consumer drains a
+  * whole burst per wakeup. The threaded numbers are dominated by the Linux
+  * port's context switch emulation (signals and semaphores, tens of us);
+  * compare the columns, not against the target.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tx_api.h"
+#include "spsc_ring.h"
+
+#define BENCH_DEPTH         8           /* Slots / queue entries / pool blocks */
+#define BENCH_LARGE_SIZE    1024U
+#define BENCH_SMALL_SIZE    4U
+#define BENCH_QUEUE_WORDS   ((sizeof(VOID *) + sizeof(ULONG) - 1) / sizeof(ULONG))
+
+typedef enum
+{
+    BENCH_RING,
+    BENCH_QUEUE,
+} Bench_Channel_t;
+
+typedef enum
+{
+    BENCH_INLINE,
+    BENCH_WAKE,
+    BENCH_BURST,
+} Bench_Schedule_t;
+
+typedef struct
+{
+    Bench_Channel_t channel;
+    ULONG           size;
+    unsigned long   errors;
+} Bench_Run_t;
+
+static TX_THREAD bench_thread;
+static TX_THREAD bench_producer;
+static TX_THREAD bench_consumer;
+static ULONG bench_stack[4096];
+static ULONG bench_producer_stack[4096];
+static ULONG bench_consumer_stack[4096];
+static TX_SEMAPHORE bench_done;
+
+static SpscRing_t bench_ring;
+static ULONG bench_ring_storage[SPSC_RING_STORAGE_SIZE(BENCH_LARGE_SIZE, BENCH_DEPTH) / sizeof(ULONG)];
+static TX_QUEUE bench_queue;
+static ULONG bench_queue_storage[BENCH_DEPTH * BENCH_QUEUE_WORDS];
+static TX_BLOCK_POOL bench_pool;
+static ULONG bench_pool_storage[BENCH_DEPTH * (BENCH_LARGE_SIZE + sizeof(VOID *) * 2) / sizeof(ULONG)];
+
+static Bench_Run_t bench_run_ctx;
+static unsigned long bench_messages = 200000UL;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Message payload: sequence number in the first word, the rest filled */
+static void bench_fill(uint8_t *msg, ULONG size, ULONG seq)
+{
+    memcpy(msg, &seq, sizeof(seq));
+    if (size > sizeof(seq))
+        memset(msg + sizeof(seq), (int)(seq & 0xFFU), size - sizeof(seq));
+}
+
+static void bench_check(const uint8_t *msg, ULONG size, ULONG seq)
+{
+    static uint8_t sink[BENCH_LARGE_SIZE];
+    ULONG got;
+
+    memcpy(sink, msg, size);
+    memcpy(&got, sink, sizeof(got));
+    if (got != seq || (size > sizeof(seq) && sink[size - 1] != (uint8_t)(seq & 0xFFU)))
+        bench_run_ctx.errors++;
+}
+
+static void bench_put(const Bench_Run_t *run, ULONG seq)
+{
+    if (run->channel == BENCH_RING)
+    {
+        uint8_t *slot;
+
+        while (!(slot = SpscRing_Reserve(&bench_ring)))
+            tx_thread_relinquish();
+        bench_fill(slot, run->size, seq);
+        SpscRing_Commit(&bench_ring);
+    }
+    else
+    {
+        ULONG msg[BENCH_QUEUE_WORDS] = {0};
+
+        if (run->size <= sizeof(ULONG))
+        {
+            bench_fill((uint8_t *)msg, run->size, seq);
+        }
+        else
+        {
+            VOID *block;
+
+            while (tx_block_allocate(&bench_pool, &block, TX_NO_WAIT) != TX_SUCCESS)
+                tx_thread_relinquish();
+            bench_fill(block, run->size, seq);
+            memcpy(msg, &block, sizeof(block));
+        }
+
+        while (tx_queue_send(&bench_queue, msg, TX_NO_WAIT) == TX_QUEUE_FULL)
+            tx_thread_relinquish();
+    }
+}
+
+static void bench_get(const Bench_Run_t *run, ULONG seq)
+{
+    if (run->channel == BENCH_RING)
+    {
+        uint8_t *slot = SpscRing_Peek(&bench_ring, TX_WAIT_FOREVER);
+
+        bench_check(slot, run->size, seq);
+        SpscRing_Release(&bench_ring);
+    }
+    else
+    {
+        ULONG msg[BENCH_QUEUE_WORDS];
+
+        tx_queue_receive(&bench_queue, msg, TX_WAIT_FOREVER);
+        if (run->size <= sizeof(ULONG))
+        {
+            bench_check((const uint8_t *)msg, run->size, seq);
+        }
+        else
+        {
+            VOID *block;
+
+            memcpy(&block, msg, sizeof(block));
+            bench_check(block, run->size, seq);
+            tx_block_release(block);
+        }
+    }
+}
+
+static void bench_producer_entry(ULONG input)
+{
+    (void)input;
+
+    for (ULONG seq = 0; seq < bench_messages; seq++)
+        bench_put(&bench_run_ctx, seq);
+}
+
+static void bench_consumer_entry(ULONG input)
+{
+    (void)input;
+
+    for (ULONG seq = 0; seq < bench_messages; seq++)
+        bench_get(&bench_run_ctx, seq);
+
+    tx_semaphore_put(&bench_done);
+}
+
+static void bench_run(Bench_Schedule_t schedule, Bench_Channel_t channel, ULONG size)
+{
+    static const char *const schedule_names[] = { "inline", "wake", "burst" };
+    UINT consumer_priority = (schedule == BENCH_WAKE) ? 9 : 10;
+    SpscRing_Stats_t stats = {0};
+    double start;
+    double elapsed;
+
+    memset(&bench_run_ctx, 0, sizeof(bench_run_ctx));
+    bench_run_ctx.channel = channel;
+    bench_run_ctx.size = size;
+
+    SpscRing_Create(&bench_ring, "Bench ring", bench_ring_storage, size, BENCH_DEPTH);
+    /* 1 KB messages travel as block pointers; a 64-bit host pointer takes 2 ULONGs */
+    tx_queue_create(&bench_queue, "Bench queue", BENCH_QUEUE_WORDS, bench_queue_storage, sizeof(bench_queue_storage));
+    tx_block_pool_create(&bench_pool, "Bench pool", BENCH_LARGE_SIZE, bench_pool_storage, sizeof(bench_pool_storage));
+
+    start = now_ns();
+    if (schedule == BENCH_INLINE)
+    {
+        /* Fill the channel, then drain it, without leaving this thread */
+        for (ULONG seq = 0; seq + BENCH_DEPTH <= bench_messages; seq += BENCH_DEPTH)
+        {
+            for (ULONG i = 0; i < BENCH_DEPTH; i++)
+                bench_put(&bench_run_ctx, seq + i);
+            for (ULONG i = 0; i < BENCH_DEPTH; i++)
+                bench_get(&bench_run_ctx, seq + i);
+        }
+    }
+    else
+    {
+        tx_thread_create(&bench_consumer, "Bench consumer", bench_consumer_entry, 0, bench_consumer_stack,
+                         sizeof(bench_consumer_stack), consumer_priority, consumer_priority, TX_NO_TIME_SLICE,
+                         TX_AUTO_START);
+        tx_thread_create(&bench_producer, "Bench producer", bench_producer_entry, 0, bench_producer_stack,
+                         sizeof(bench_producer_stack), 10, 10, TX_NO_TIME_SLICE, TX_AUTO_START);
+        tx_semaphore_get(&bench_done, TX_WAIT_FOREVER);
+    }
+    elapsed = now_ns() - start;
+
+    if (channel == BENCH_RING)
+        SpscRing_GetStats(&bench_ring, &stats);
+
+    printf("%-6s %-5s %5lu B %10.1f ns/msg  %7u sleeps  %lu errors\n",
+           schedule_names[schedule], channel == BENCH_RING ? "ring" : "queue",
+           (unsigned long)size, elapsed / (double)bench_messages, stats.wakeups, bench_run_ctx.errors);
+
+    if (schedule != BENCH_INLINE)
+    {
+        tx_thread_terminate(&bench_producer);
+        tx_thread_terminate(&bench_consumer);
+        tx_thread_delete(&bench_producer);
+        tx_thread_delete(&bench_consumer);
+    }
+    tx_event_flags_delete(&bench_ring.data_ready);
+    tx_queue_delete(&bench_queue);
+    tx_block_pool_delete(&bench_pool);
+}
+
+static void bench_entry(ULONG input)
+{
+    static const ULONG sizes[] = { BENCH_SMALL_SIZE, BENCH_LARGE_SIZE };
+    (void)input;
+
+    printf("%lu messages, depth %u\n", bench_messages, BENCH_DEPTH);
+
+    for (unsigned int schedule = BENCH_INLINE; schedule <= BENCH_BURST; schedule++)
+    {
+        for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+        {
+            bench_run((Bench_Schedule_t)schedule, BENCH_QUEUE, sizes[s]);
+            bench_run((Bench_Schedule_t)schedule, BENCH_RING, sizes[s]);
+        }
+    }
+
+    exit(0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+    (void)first_unused_memory;
+
+    tx_semaphore_create(&bench_done, "Bench done", 0);
+    tx_thread_create(&bench_thread, "Bench", bench_entry, 0, bench_stack, sizeof(bench_stack),
+                     1, 1, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        bench_messages = strtoul(argv[1], NULL, 0);
+
+    tx_kernel_enter();
+    return 0;
+}
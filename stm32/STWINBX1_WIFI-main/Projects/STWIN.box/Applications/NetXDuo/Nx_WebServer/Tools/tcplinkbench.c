@@ -0,0 +1,432 @@
+/**
+  ******************************************************************************
+  * @file    tcplinkbench.c
+  * @author  Wind Turbine Team
+  * @brief   Host benchmark: TCP goodput over a delayed, lossy link (NetX Duo Linux port)
+  ******************************************************************************
+  * Two IP instances joined by an emulated link: each frame is copied into
+  * the peer's pool, serialized at LINK_RATE_KBPS, held for half the round
+  * trip time and delivered through _nx_ip_packet_deferred_receive(), or
+  * dropped with the given probability (data and ACKs alike) or when the
+  * LINK_QUEUE frames of the direction are in flight. One side sends a bulk
+  * transfer the way the web server sends a response; the table shows the
+  * goodput and the sender's retransmission counters for each round trip
+  * time and loss rate. Both ends use nx_user.h, so the receiver keeps only
+  * NX_TCP_MAX_OUT_OF_ORDER_PACKETS segments past a hole, fewer than a
+  * desktop peer would.
+  *
+  * Build it twice to compare the RTT-estimated retransmission timeout and
+  * partial ACK recovery (nx_user.h) with the stock NetX behaviour:
+  *
+  *   TX=../../../../../../Middlewares/ST/threadx
+  *   NX=../../../../../../Middlewares/ST/netxduo
+  *   SRC="tcplinkbench.c $NX/common/src/nx*.c $TX/common/src/tx*.c $TX/ports/linux/gnu/src/tx*.c"
+  *   FLAGS="-O2 -no-pie -fno-pie -D_GNU_SOURCE -DNX_INCLUDE_USER_DEFINE_FILE -DTX_TIMER_TICKS_PER_SECOND=1000UL \
+  *       -I../NetXDuo/App -I$TX/common/inc -I$TX/ports/linux/gnu/inc \
+  *       -I$NX/common/inc -I$NX/ports/linux/gnu/inc"
+  *   gcc $FLAGS -o tcplinkbench $SRC -lpthread -lrt
+  *   gcc $FLAGS -DNX_TCP_FIXED_RTO -o tcplinkbench_fixed $SRC -lpthread -lrt
+  *   ./tcplinkbench [kilobytes per transfer] [receive window] [runs per cell]
+  *
+  * The target ticks at 1 kHz, hence TX_TIMER_TICKS_PER_SECOND. The link and
+  * the timers run in wall-clock time, so a slow or loaded host adds its own
+  * delay; compare the two builds on the same machine.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tx_api.h"
+#include "nx_api.h"
+#include "nx_ip.h"
+#include "nx_tcp.h"
+
+#define LINK_RATE_KBPS          8000        /* EMW3080 SPI throughput, roughly */
+#define LINK_QUEUE              64          /* Frames in flight per direction */
+#define LINK_MTU                1500
+#define BENCH_PAYLOAD           1536
+#define BENCH_PACKETS           160         /* Per pool: window, send queue and link */
+#define BENCH_PORT_BASE         5000
+#define BENCH_SEED              20261018U
+#define BENCH_TIMEOUT_MS        60000
+
+static const ULONG bench_rtt_ms[] = { 20, 60, 150 };
+static const ULONG bench_loss_permille[] = { 0, 10, 30 };
+
+typedef struct
+{
+    NX_PACKET   *packet;
+    ULONG64      due_us;
+} LinkFrame_t;
+
+typedef struct
+{
+    NX_IP       *to;
+    LinkFrame_t  frames[LINK_QUEUE];
+    UINT         head;
+    UINT         count;
+    ULONG64      free_us;               /* Serializer busy until */
+    ULONG        dropped;
+} LinkDirection_t;
+
+static TX_THREAD link_thread, control_thread, receive_thread;
+static ULONG link_stack[2048], control_stack[4096], receive_stack[4096];
+static NX_PACKET_POOL pool_a, pool_b;
+static ULONG pool_a_memory[((BENCH_PAYLOAD + sizeof(NX_PACKET)) * BENCH_PACKETS) / sizeof(ULONG) + 4];
+static ULONG pool_b_memory[((BENCH_PAYLOAD + sizeof(NX_PACKET)) * BENCH_PACKETS) / sizeof(ULONG) + 4];
+static NX_IP ip_a, ip_b;
+static ULONG ip_a_stack[2048], ip_b_stack[2048];
+static NX_TCP_SOCKET sender, receiver;
+
+static LinkDirection_t link_ab, link_ba;
+static volatile ULONG link_delay_us;
+static volatile ULONG link_loss_permille;
+static unsigned int link_seed = BENCH_SEED;
+
+static ULONG bench_bytes = 256UL * 1024UL;
+static ULONG bench_window = 65535;
+static ULONG bench_runs = 3;
+static volatile ULONG receive_bytes;
+static volatile UINT receive_port;
+static TX_SEMAPHORE receive_done;
+
+static ULONG64 now_us(void)
+{
+    return ((ULONG64)tx_time_get() * 1000000U) / TX_TIMER_TICKS_PER_SECOND;
+}
+
+/* Copy a frame into the peer pool and queue it, or drop it */
+static void link_send(LinkDirection_t *dir, NX_PACKET *packet_ptr)
+{
+    TX_INTERRUPT_SAVE_AREA
+    NX_PACKET *copy;
+    ULONG length = packet_ptr->nx_packet_length;
+    ULONG copied;
+    ULONG64 start;
+    UINT drop;
+
+    drop = ((ULONG)rand_r(&link_seed) % 1000U) < link_loss_permille;
+    if (!drop && nx_packet_allocate(dir->to->nx_ip_default_packet_pool, &copy, NX_RECEIVE_PACKET, NX_NO_WAIT) == NX_SUCCESS)
+    {
+        nx_packet_data_extract_offset(packet_ptr, 0, copy->nx_packet_prepend_ptr, length, &copied);
+        copy->nx_packet_append_ptr = copy->nx_packet_prepend_ptr + copied;
+        copy->nx_packet_length = copied;
+        copy->nx_packet_ip_interface = &dir->to->nx_ip_interface[0];
+
+        TX_DISABLE
+        if (dir->count < LINK_QUEUE)
+        {
+            LinkFrame_t *f = &dir->frames[(dir->head + dir->count) % LINK_QUEUE];
+
+            start = now_us();
+            if (start < dir->free_us)
+                start = dir->free_us;
+            dir->free_us = start + ((ULONG64)length * 8000U) / LINK_RATE_KBPS;
+            f->packet = copy;
+            f->due_us = dir->free_us + link_delay_us;
+            dir->count++;
+            copy = NX_NULL;
+        }
+        else
+            dir->dropped++;
+        TX_RESTORE
+
+        if (copy)
+            nx_packet_release(copy);
+    }
+    else
+        dir->dropped++;
+
+    nx_packet_transmit_release(packet_ptr);
+}
+
+/* Hand every frame that is due to its IP instance */
+static void link_deliver(LinkDirection_t *dir)
+{
+    TX_INTERRUPT_SAVE_AREA
+    NX_PACKET *packet_ptr;
+    ULONG64 now = now_us();
+
+    for (;;)
+    {
+        packet_ptr = NX_NULL;
+
+        TX_DISABLE
+        if (dir->count > 0U && dir->frames[dir->head].due_us <= now)
+        {
+            packet_ptr = dir->frames[dir->head].packet;
+            dir->head = (dir->head + 1U) % LINK_QUEUE;
+            dir->count--;
+        }
+        TX_RESTORE
+
+        if (!packet_ptr)
+            break;
+
+        _nx_ip_packet_deferred_receive(dir->to, packet_ptr);
+    }
+}
+
+static void link_entry(ULONG input)
+{
+    (void)input;
+
+    for (;;)
+    {
+        tx_thread_sleep(1);
+        link_deliver(&link_ab);
+        link_deliver(&link_ba);
+    }
+}
+
+static void link_driver(NX_IP_DRIVER *driver_req_ptr)
+{
+    NX_IP *ip_ptr = driver_req_ptr->nx_ip_driver_ptr;
+
+    driver_req_ptr->nx_ip_driver_status = NX_SUCCESS;
+
+    switch (driver_req_ptr->nx_ip_driver_command)
+    {
+    case NX_LINK_INITIALIZE:
+        driver_req_ptr->nx_ip_driver_interface->nx_interface_ip_mtu_size = LINK_MTU;
+        driver_req_ptr->nx_ip_driver_interface->nx_interface_address_mapping_needed = NX_FALSE;
+        break;
+
+    case NX_LINK_ENABLE:
+        driver_req_ptr->nx_ip_driver_interface->nx_interface_link_up = NX_TRUE;
+        break;
+
+    case NX_LINK_PACKET_SEND:
+    case NX_LINK_PACKET_BROADCAST:
+        link_send((ip_ptr == &ip_a) ? &link_ab : &link_ba, driver_req_ptr->nx_ip_driver_packet);
+        break;
+
+    case NX_LINK_ARP_SEND:
+    case NX_LINK_ARP_RESPONSE_SEND:
+    case NX_LINK_RARP_SEND:
+        nx_packet_transmit_release(driver_req_ptr->nx_ip_driver_packet);
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void receive_entry(ULONG input)
+{
+    NX_PACKET *packet_ptr;
+
+    (void)input;
+
+    for (;;)
+    {
+        /* One connection per run, on a fresh port */
+        while (receive_port == 0U)
+            tx_thread_sleep(1);
+
+        nx_tcp_socket_create(&ip_b, &receiver, "Receiver", NX_IP_NORMAL, NX_FRAGMENT_OKAY,
+                             NX_IP_TIME_TO_LIVE, bench_window, NX_NULL, NX_NULL);
+        nx_tcp_server_socket_listen(&ip_b, receive_port, &receiver, 1, NX_NULL);
+        receive_port = 0;
+
+        if (nx_tcp_server_socket_accept(&receiver, NX_WAIT_FOREVER) == NX_SUCCESS)
+        {
+            while (nx_tcp_socket_receive(&receiver, &packet_ptr, NX_WAIT_FOREVER) == NX_SUCCESS)
+            {
+                receive_bytes += packet_ptr->nx_packet_length;
+                nx_packet_release(packet_ptr);
+                if (receive_bytes >= bench_bytes)
+                    tx_semaphore_put(&receive_done);
+            }
+        }
+
+        nx_tcp_server_socket_unaccept(&receiver);
+        nx_tcp_server_socket_unlisten(&ip_b, receiver.nx_tcp_socket_port);
+        nx_tcp_socket_delete(&receiver);
+    }
+}
+
+/* One transfer; returns milliseconds, 0 on failure */
+static ULONG bench_transfer(UINT port)
+{
+    NX_PACKET *packet_ptr;
+    ULONG sent = 0;
+    ULONG start;
+    ULONG mss;
+    ULONG chunk;
+    static UCHAR data[LINK_MTU];
+
+    while (tx_semaphore_get(&receive_done, TX_NO_WAIT) == TX_SUCCESS)
+        ;
+    receive_bytes = 0;
+    receive_port = port;
+    while (receive_port != 0U)
+        tx_thread_sleep(1);
+
+    nx_tcp_socket_create(&ip_a, &sender, "Sender", NX_IP_NORMAL, NX_FRAGMENT_OKAY,
+                         NX_IP_TIME_TO_LIVE, 8192, NX_NULL, NX_NULL);
+    nx_tcp_client_socket_bind(&sender, NX_ANY_PORT, NX_WAIT_FOREVER);
+
+    if (nx_tcp_client_socket_connect(&sender, IP_ADDRESS(10, 0, 0, 2), port, 10 * NX_IP_PERIODIC_RATE) != NX_SUCCESS)
+    {
+        nx_tcp_client_socket_unbind(&sender);
+        nx_tcp_socket_delete(&sender);
+        return 0;
+    }
+
+    mss = sender.nx_tcp_socket_connect_mss;
+    start = tx_time_get();
+
+    while (sent < bench_bytes)
+    {
+        chunk = (bench_bytes - sent < mss) ? bench_bytes - sent : mss;
+        if (nx_packet_allocate(&pool_a, &packet_ptr, NX_TCP_PACKET, NX_WAIT_FOREVER) != NX_SUCCESS)
+            break;
+        nx_packet_data_append(packet_ptr, data, chunk, &pool_a, NX_WAIT_FOREVER);
+        if (nx_tcp_socket_send(&sender, packet_ptr, 10 * NX_IP_PERIODIC_RATE) != NX_SUCCESS)
+        {
+            nx_packet_release(packet_ptr);
+            break;
+        }
+        sent += chunk;
+    }
+
+    if (sent < bench_bytes ||
+        tx_semaphore_get(&receive_done, (BENCH_TIMEOUT_MS * TX_TIMER_TICKS_PER_SECOND) / 1000U) != TX_SUCCESS)
+        start = tx_time_get();
+
+    return ((tx_time_get() - start) * 1000U) / TX_TIMER_TICKS_PER_SECOND;
+}
+
+static void bench_close(void)
+{
+    /* No wait: RST, so a lossy close does not hold up the next run */
+    nx_tcp_socket_disconnect(&sender, NX_NO_WAIT);
+    nx_tcp_client_socket_unbind(&sender);
+    nx_tcp_socket_delete(&sender);
+    nx_tcp_socket_disconnect(&receiver, NX_NO_WAIT);
+
+    /* Let the link drain the RST and anything behind it */
+    tx_thread_sleep(NX_IP_PERIODIC_RATE / 2);
+}
+
+static void control_entry(ULONG input)
+{
+    UINT port = BENCH_PORT_BASE;
+
+    (void)input;
+
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+    printf("RTO estimated (RFC 6298), min %lu ms, max %lu ms, retry shift %u\n",
+           (unsigned long)((NX_TCP_RTO_MIN * 1000U) / TX_TIMER_TICKS_PER_SECOND),
+           (unsigned long)((NX_TCP_RTO_MAX * 1000U) / TX_TIMER_TICKS_PER_SECOND), (UINT)NX_TCP_RETRY_SHIFT);
+#else
+    printf("RTO fixed at %lu ms, retry shift %u\n",
+           (unsigned long)(((NX_IP_PERIODIC_RATE / NX_TCP_TRANSMIT_TIMER_RATE) * 1000U) / TX_TIMER_TICKS_PER_SECOND), (UINT)NX_TCP_RETRY_SHIFT);
+#endif
+    printf("%lu KB per transfer, receive window %lu, link %u kbit/s, %lu runs per cell\n\n",
+           (unsigned long)(bench_bytes / 1024U), (unsigned long)bench_window, LINK_RATE_KBPS,
+           (unsigned long)bench_runs);
+    printf("%8s %8s %12s %10s %9s %6s %8s %8s %8s %8s\n",
+           "rtt_ms", "loss_%", "goodput_kBs", "time_ms", "timeouts", "fast", "partial", "srtt_ms", "rto_ms", "dropped");
+
+    for (UINT r = 0; r < sizeof(bench_rtt_ms) / sizeof(bench_rtt_ms[0]); r++)
+    {
+        for (UINT l = 0; l < sizeof(bench_loss_permille) / sizeof(bench_loss_permille[0]); l++)
+        {
+            ULONG total_ms = 0;
+            ULONG timeouts = 0;
+            ULONG fast = 0;
+            ULONG partial = 0;
+            ULONG srtt = 0;
+            ULONG rto = 0;
+            ULONG failed = 0;
+
+            link_delay_us = bench_rtt_ms[r] * 500U;
+            link_ab.dropped = 0;
+            link_ba.dropped = 0;
+
+            for (ULONG run = 0; run < bench_runs; run++)
+            {
+                ULONG ms;
+
+                link_loss_permille = bench_loss_permille[l];
+                ms = bench_transfer(port++);
+                if (ms == 0U)
+                    failed++;
+                total_ms += ms;
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+                timeouts += sender.nx_tcp_socket_retransmit_timeouts;
+                fast += sender.nx_tcp_socket_retransmit_fast;
+                partial += sender.nx_tcp_socket_retransmit_partial;
+                srtt += ((sender.nx_tcp_socket_rtt_srtt >> 3) * 1000U) / TX_TIMER_TICKS_PER_SECOND;
+                rto += (sender.nx_tcp_socket_timeout_rate * 1000U) / TX_TIMER_TICKS_PER_SECOND;
+#endif /* NX_TCP_ENABLE_RTT_ESTIMATION */
+
+                /* Close over a clean link */
+                link_loss_permille = 0;
+                bench_close();
+            }
+
+            printf("%8lu %8.1f %12.1f %10lu",
+                   (unsigned long)bench_rtt_ms[r], bench_loss_permille[l] / 10.0,
+                   (total_ms && !failed) ? (double)bench_bytes * bench_runs / total_ms * 1000.0 / 1024.0 : 0.0,
+                   (unsigned long)(total_ms / bench_runs));
+#ifdef NX_TCP_ENABLE_RTT_ESTIMATION
+            printf(" %9.1f %6.1f %8.1f %8lu %8lu", (double)timeouts / bench_runs, (double)fast / bench_runs,
+                   (double)partial / bench_runs,
+                   (unsigned long)(srtt / bench_runs), (unsigned long)(rto / bench_runs));
+#else
+            printf(" %9s %6s %8s %8s %8s", "-", "-", "-", "-", "-");
+#endif /* NX_TCP_ENABLE_RTT_ESTIMATION */
+            printf(" %8lu%s\n", (unsigned long)(link_ab.dropped + link_ba.dropped), failed ? "  (timed out)" : "");
+            fflush(stdout);
+        }
+    }
+
+    exit(0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+    (void)first_unused_memory;
+
+    nx_system_initialize();
+
+    nx_packet_pool_create(&pool_a, "Pool A", BENCH_PAYLOAD, pool_a_memory, sizeof(pool_a_memory));
+    nx_packet_pool_create(&pool_b, "Pool B", BENCH_PAYLOAD, pool_b_memory, sizeof(pool_b_memory));
+
+    nx_ip_create(&ip_a, "IP A", IP_ADDRESS(10, 0, 0, 1), 0xFFFFFF00UL, &pool_a, link_driver,
+                 ip_a_stack, sizeof(ip_a_stack), 1);
+    nx_ip_create(&ip_b, "IP B", IP_ADDRESS(10, 0, 0, 2), 0xFFFFFF00UL, &pool_b, link_driver,
+                 ip_b_stack, sizeof(ip_b_stack), 1);
+    nx_tcp_enable(&ip_a);
+    nx_tcp_enable(&ip_b);
+
+    link_ab.to = &ip_b;
+    link_ba.to = &ip_a;
+
+    tx_semaphore_create(&receive_done, "Receive Done", 0);
+    tx_thread_create(&link_thread, "Link", link_entry, 0, link_stack, sizeof(link_stack),
+                     2, 2, TX_NO_TIME_SLICE, TX_AUTO_START);
+    tx_thread_create(&receive_thread, "Receive", receive_entry, 0, receive_stack, sizeof(receive_stack),
+                     10, 10, TX_NO_TIME_SLICE, TX_AUTO_START);
+    tx_thread_create(&control_thread, "Control", control_entry, 0, control_stack, sizeof(control_stack),
+                     11, 11, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        bench_bytes = strtoul(argv[1], NULL, 0) * 1024UL;
+    if (argc > 2)
+        bench_window = strtoul(argv[2], NULL, 0);
+    if (argc > 3)
+        bench_runs = strtoul(argv[3], NULL, 0);
+    if (bench_runs == 0U)
+        bench_runs = 1;
+
+    tx_kernel_enter();
+
+    return 0;
+}
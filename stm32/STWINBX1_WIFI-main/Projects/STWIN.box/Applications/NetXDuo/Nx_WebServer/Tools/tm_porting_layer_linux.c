@@ -0,0 +1,129 @@
+/**
+  ******************************************************************************
+  * @file    tm_porting_layer_linux.c
+  * @author  Wind Turbine Team
+  * @brief   Thread-Metric on the ThreadX Linux port: interrupt emulation and main
+  ******************************************************************************
+  * Builds the firmware runner and porting layer against the Linux port, so a
+  * kernel option can be tried on the host before it is flashed:
+  *
+  *   TX=../../../../../../Middlewares/ST/threadx
+  *   TM=$TX/utility/benchmarks/thread_metric
+  *   gcc -O2 -D_GNU_SOURCE -DTHREAD_METRIC_HOST -I../Core/Inc -I$TM \
+  *       -I$TX/common/inc -I$TX/ports/linux/gnu/inc [-DTX_DISABLE_NOTIFY_CALLBACKS ...] \
+  *       -o tmbench tm_porting_layer_linux.c ../Core/Src/thread_metric.c ../Core/Src/app_util.c \
+  *       ../Core/Src/tm_porting_layer.c $TX/common/src/tx*.c $TX/ports/linux/gnu/src/tx*.c \
+  *       -lpthread -lrt
+  *   ./tmbench [seconds] > result.csv
+  *   python3 tmcompare.py thread_metric_baseline_linux.csv result.csv
+  *
+  * The benchmark interrupt is a pthread that brackets ThreadMetric_IrqHandler()
+  * with _tx_thread_context_save/restore, the same way the port runs its timer
+  * interrupt. Host scores include the cost of that emulation (signals and
+  * semaphores per context switch); compare host runs with host runs only.
+  */
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "tx_api.h"
+#include "thread_metric.h"
+
+VOID _tx_thread_context_save(VOID);
+VOID _tx_thread_context_restore(VOID);
+
+static sem_t tm_irq_semaphore;
+static pthread_t tm_irq_thread;
+static TX_THREAD tm_main_thread;
+static ULONG tm_main_stack[4096];
+static ULONG tm_seconds = THREAD_METRIC_DEFAULT_SECONDS;
+
+/* thread_metric.c and tm_porting_layer.c register their buffers with the memory budget */
+void MemBudget_RegisterStatic(const CHAR *owner, const CHAR *purpose, ULONG size)
+{
+    (void)owner;
+    (void)purpose;
+    (void)size;
+}
+
+static void *tm_irq_entry(void *p)
+{
+    (void)p;
+
+    while (1)
+    {
+        if (tx_linux_sem_wait(&tm_irq_semaphore) != 0)
+            continue;
+
+        _tx_thread_context_save();
+        ThreadMetric_IrqHandler();
+        _tx_thread_context_restore();
+    }
+
+    return NULL;
+}
+
+UINT ThreadMetric_PortIrqInit(void)
+{
+    struct sched_param sp;
+
+    if (sem_init(&tm_irq_semaphore, 0, 0) != 0)
+        return TX_NOT_AVAILABLE;
+    if (pthread_create(&tm_irq_thread, NULL, tm_irq_entry, NULL) != 0)
+        return TX_NOT_AVAILABLE;
+
+    /* Same level as the timer interrupt thread; ignored without privileges */
+    sp.sched_priority = TX_LINUX_PRIORITY_ISR;
+    pthread_setschedparam(tm_irq_thread, SCHED_FIFO, &sp);
+
+    return TX_SUCCESS;
+}
+
+void ThreadMetric_PortIrqRaise(void)
+{
+    tx_linux_sem_post(&tm_irq_semaphore);
+}
+
+static void tm_main_entry(ULONG input)
+{
+    static char report[THREAD_METRIC_REPORT_SIZE];
+
+    (void)input;
+
+    if (ThreadMetric_Start(tm_seconds) != TX_SUCCESS)
+        exit(1);
+
+    /* The runner prints one progress line per test; the CSV report follows them */
+    while (ThreadMetric_GetState() != THREAD_METRIC_STATE_DONE)
+        tx_thread_sleep(TX_TIMER_TICKS_PER_SECOND);
+
+    ThreadMetric_Format(report, sizeof(report));
+    fputs(report, stdout);
+    fflush(stdout);
+    exit(0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+    (void)first_unused_memory;
+
+    if (ThreadMetric_Init() != TX_SUCCESS)
+    {
+        fprintf(stderr, "ThreadMetric_Init failed\n");
+        exit(1);
+    }
+
+    /* Below every test thread, so it only polls between tests */
+    tx_thread_create(&tm_main_thread, "Thread Metric Main", tm_main_entry, 0, tm_main_stack, sizeof(tm_main_stack),
+                     20, 20, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        tm_seconds = strtoul(argv[1], NULL, 0);
+
+    tx_kernel_enter();
+    return 0;
+}
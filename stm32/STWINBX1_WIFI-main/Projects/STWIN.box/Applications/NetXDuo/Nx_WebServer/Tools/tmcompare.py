@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""Compare a Thread-Metric run against a baseline.
+
+Both files are the CSV report of the runner (Core/Src/thread_metric.c),
+saved from the board or from the Linux build; other lines are ignored:
+
+    curl -s http://<board>/GetThreadMetric > result.csv
+    python3 Tools/tmcompare.py Tools/thread_metric_baseline_linux.csv result.csv [--threshold 2]
+
+Scores are compared per second, so runs of different length line up. A
+change smaller than the threshold (percent) is reported as noise; take the
+host numbers with more margin than the board's.
+"""
+
+import argparse
+import sys
+
+
+def load(path):
+    run = {}
+    config = "default"
+    scores = {}
+    with open(path) as f:
+        for line in f:
+            fields = line.strip().split(",")
+            if fields[0] == "run" and len(fields) >= 5:
+                run = {"platform": fields[1], "state": fields[2], "seconds": int(fields[3]), "core_hz": int(fields[4])}
+            elif fields[0] == "config" and len(fields) >= 2:
+                config = fields[1]
+            elif fields[0] == "test" and len(fields) >= 4:
+                scores[fields[1]] = int(fields[3])
+    if not scores:
+        raise ValueError("no test lines")
+    return run, config, scores
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", help="reference report")
+    parser.add_argument("result", help="report to compare")
+    parser.add_argument("--threshold", type=float, default=2.0, help="percent below which a change is noise")
+    args = parser.parse_args()
+
+    try:
+        base_run, base_config, base = load(args.baseline)
+        new_run, new_config, new = load(args.result)
+    except (OSError, ValueError) as e:
+        sys.exit("tmcompare: %s" % e)
+
+    if base_run.get("platform") != new_run.get("platform") or base_run.get("core_hz") != new_run.get("core_hz"):
+        print("warning: platform differs (%s @ %s Hz vs %s @ %s Hz)" % (
+            base_run.get("platform"), base_run.get("core_hz"), new_run.get("platform"), new_run.get("core_hz")))
+    if new_run.get("state") != "done":
+        print("warning: %s is an incomplete run" % args.result)
+
+    base_options = set(base_config.split()) - {"default"}
+    new_options = set(new_config.split()) - {"default"}
+    print("config: %s" % (" ".join(sorted("+" + o for o in new_options - base_options) +
+                                    sorted("-" + o for o in base_options - new_options)) or "unchanged"))
+
+    print("%-32s %12s %12s %8s" % ("test", "baseline/s", "result/s", "change"))
+    for name in list(base) + [n for n in new if n not in base]:
+        if name not in base or name not in new:
+            print("%-32s %12s %12s %8s" % (name, base.get(name, "-"), new.get(name, "-"), "n/a"))
+            continue
+        change = (new[name] - base[name]) * 100.0 / base[name] if base[name] else 0.0
+        verdict = "" if abs(change) >= args.threshold else "  (noise)"
+        print("%-32s %12u %12u %+7.1f%%%s" % (name, base[name], new[name], change, verdict))
+
+
+if __name__ == "__main__":
+    main()
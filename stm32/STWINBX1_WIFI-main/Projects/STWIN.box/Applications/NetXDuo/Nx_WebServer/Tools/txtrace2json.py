@@ -0,0 +1,285 @@
+#!/usr/bin/env python3
+"""Convert a ThreadX trace image (GET /GetTrace) into a Chrome trace timeline.
+
+The output loads in https://ui.perfetto.dev or chrome://tracing:
+
+  - one track per thread with its run slices (context switches are taken
+    from the next-thread field of the resume/suspend events)
+  - one track per interrupt source (ISR enter/exit from the stm32u5xx_it.c
+    wrappers, numbered as CpuLoad_Isr_t in Core/Inc/cpu_load.h)
+  - instant events for every service call (queue send/receive, semaphore,
+    ...) and for the user events of Core/Inc/event_trace.h
+
+    curl -o trace.bin http://<board>/GetTrace
+    python3 Tools/txtrace2json.py trace.bin -o trace.json [--hz 160000000]
+
+Time stamps are DWT cycles: --hz must match SystemCoreClock. The counter
+stops while the core sleeps, so capture with /IdleMode/Off for a linear
+timeline.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+TRACE_VALID = 0x54585442
+HEADER_FORMAT = "IIIIHHIIIIIII"
+HEADER_SIZE = struct.calcsize("<" + HEADER_FORMAT)
+EVENT_FORMAT = "IIIIIIII"
+EVENT_SIZE = struct.calcsize("<" + EVENT_FORMAT)
+
+THREAD_ISR = 0xFFFFFFFF
+THREAD_INIT = 0xF0F0F0F0
+INVALID_EVENT = 0xFFFFFFFF
+
+EVENT_THREAD_RESUME = 1
+EVENT_THREAD_SUSPEND = 2
+EVENT_ISR_ENTER = 3
+EVENT_ISR_EXIT = 4
+EVENT_TIME_SLICE = 5
+EVENT_RUNNING = 6
+USER_EVENT_START = 4096
+
+# Core/Inc/cpu_load.h, CpuLoad_Isr_t
+ISR_NAMES = ("wifi notify", "exti15", "hal tick", "sd", "wifi flow", "low power", "wifi dma", "wifi spi",
+             "thread metric", "audio dma")
+
+# Core/Inc/event_trace.h
+USER_EVENTS = {USER_EVENT_START + 0: "frame drop", USER_EVENT_START + 1: "trace frozen"}
+
+# threadx/common/inc/tx_trace.h; info-get and performance events are left numeric
+EVENT_NAMES = {
+    10: "block_allocate", 17: "block_release",
+    20: "byte_allocate", 27: "byte_release",
+    32: "event_flags_get", 36: "event_flags_set",
+    40: "interrupt_control",
+    52: "mutex_get", 57: "mutex_put",
+    62: "queue_flush", 63: "queue_front_send", 68: "queue_receive", 69: "queue_send",
+    80: "semaphore_ceiling_put", 83: "semaphore_get", 88: "semaphore_put",
+    100: "thread_create", 101: "thread_delete", 107: "thread_preemption_change",
+    108: "thread_priority_change", 109: "thread_relinquish", 110: "thread_reset",
+    111: "thread_resume", 112: "thread_sleep", 114: "thread_suspend",
+    115: "thread_terminate", 116: "thread_time_slice_change", 117: "thread_wait_abort",
+    120: "time_get", 121: "time_set",
+    122: "timer_activate", 123: "timer_change", 124: "timer_create",
+    125: "timer_deactivate", 126: "timer_delete",
+}
+
+PID_THREADS = 1
+PID_ISRS = 2
+TID_IDLE = 0
+
+
+def parse_header(image):
+    if len(image) < HEADER_SIZE:
+        raise ValueError("image too short for a trace header")
+    for endian in ("<", ">"):
+        fields = struct.unpack_from(endian + HEADER_FORMAT, image, 0)
+        if fields[0] == TRACE_VALID:
+            break
+    else:
+        raise ValueError("no TXTB trace id: capture never started?")
+    keys = ("id", "mask", "base", "registry_start", "reserved1", "name_size",
+            "registry_end", "buffer_start", "buffer_end", "buffer_current")
+    header = dict(zip(keys, fields))
+    header["endian"] = endian
+    return header
+
+
+def parse_registry(image, header):
+    """Object address -> (type, name)."""
+    endian = header["endian"]
+    name_size = header["name_size"]
+    entry_size = 16 + name_size
+    objects = {}
+    offset = header["registry_start"] - header["base"]
+    end = header["registry_end"] - header["base"]
+    while offset + entry_size <= min(end, len(image)):
+        available, obj_type, _, _, address, _, _ = struct.unpack_from(endian + "BBBBIII", image, offset)
+        name = image[offset + 16:offset + entry_size].split(b"\0", 1)[0].decode("ascii", "replace")
+        if not available and address:
+            objects[address] = (obj_type, name)
+        offset += entry_size
+    return objects
+
+
+def parse_events(image, header):
+    """Valid events, oldest first."""
+    endian = header["endian"]
+    base = header["base"]
+    start = header["buffer_start"] - base
+    end = min(header["buffer_end"] - base, len(image))
+    current = header["buffer_current"] - base
+    if not start <= current < end:
+        current = start
+
+    events = []
+    for offset in list(range(current, end, EVENT_SIZE)) + list(range(start, current, EVENT_SIZE)):
+        if offset + EVENT_SIZE > end:
+            continue
+        fields = struct.unpack_from(endian + EVENT_FORMAT, image, offset)
+        thread, event_id = fields[0], fields[2]
+        if thread == 0 or event_id == INVALID_EVENT:
+            continue
+        events.append(fields)
+    return events
+
+
+class Timeline:
+    def __init__(self, objects, hz):
+        self.objects = objects
+        self.hz = float(hz)
+        self.out = []
+        self.tids = {}
+        self.running = None          # Thread address, 0 = idle
+        self.run_start = None
+        self.pending = None          # Switch requested from an ISR
+        self.isr_depth = 0
+        self.isr_start = {}
+
+    def us(self, cycles):
+        return cycles * 1e6 / self.hz
+
+    def name(self, address):
+        if address in self.objects:
+            return self.objects[address][1]
+        return "0x%08x" % address
+
+    def tid(self, thread):
+        if not thread:
+            return TID_IDLE
+        if thread not in self.tids:
+            self.tids[thread] = len(self.tids) + 1
+        return self.tids[thread]
+
+    def switch(self, thread, now):
+        if thread == self.running:
+            return
+        if self.running is not None and self.run_start is not None and now > self.run_start:
+            self.out.append({"ph": "X", "pid": PID_THREADS, "tid": self.tid(self.running),
+                             "name": self.name(self.running) if self.running else "idle",
+                             "ts": self.us(self.run_start), "dur": self.us(now - self.run_start)})
+        self.running = thread
+        self.run_start = now
+
+    def instant(self, pid, tid, name, now, args):
+        self.out.append({"ph": "i", "s": "t", "pid": pid, "tid": tid, "name": name,
+                         "ts": self.us(now), "args": args})
+
+    def event(self, fields, now):
+        thread, _, event_id, _, i1, i2, i3, i4 = fields
+        from_isr = thread == THREAD_ISR
+
+        # Any event from thread context says which thread is running
+        if not from_isr and thread != THREAD_INIT:
+            self.switch(thread, now)
+
+        if event_id == EVENT_ISR_ENTER:
+            self.isr_depth += 1
+            self.isr_start[i2] = now
+            return
+        if event_id == EVENT_ISR_EXIT:
+            start = self.isr_start.pop(i2, None)
+            if start is not None:
+                name = ISR_NAMES[i2] if i2 < len(ISR_NAMES) else "isr %u" % i2
+                self.out.append({"ph": "X", "pid": PID_ISRS, "tid": i2, "name": name,
+                                 "ts": self.us(start), "dur": self.us(now - start)})
+            self.isr_depth = max(0, self.isr_depth - 1)
+            if self.isr_depth == 0 and self.pending is not None:
+                self.switch(self.pending, now)
+                self.pending = None
+            return
+
+        if event_id in (EVENT_THREAD_RESUME, EVENT_THREAD_SUSPEND, EVENT_TIME_SLICE):
+            # Resume/suspend: I1 = thread, I4 = next thread. Time slice: I1 = next thread
+            next_thread = i1 if event_id == EVENT_TIME_SLICE else i4
+            verb = {EVENT_THREAD_RESUME: "resume", EVENT_THREAD_SUSPEND: "suspend",
+                    EVENT_TIME_SLICE: "time slice"}[event_id]
+            self.instant(PID_THREADS, self.tid(i1), "%s %s" % (verb, self.name(i1)), now,
+                         {"next": self.name(next_thread) if next_thread else "idle", "state": i2})
+            # From an ISR the switch happens when the interrupt returns
+            if from_isr and self.isr_depth > 0:
+                self.pending = next_thread
+            else:
+                self.switch(next_thread, now)
+            return
+
+        if event_id == EVENT_RUNNING:
+            return
+
+        if event_id >= USER_EVENT_START:
+            name = USER_EVENTS.get(event_id, "user %u" % event_id)
+            obj = None
+        else:
+            name = EVENT_NAMES.get(event_id, "event %u" % event_id)
+            obj = i1 if i1 in self.objects else None
+            if obj is not None:
+                name += " " + self.name(obj)
+
+        if from_isr:
+            pid, tid = PID_ISRS, len(ISR_NAMES)
+        else:
+            pid, tid = PID_THREADS, self.tid(thread) if thread != THREAD_INIT else TID_IDLE
+        self.instant(pid, tid, name, now, {"id": event_id, "i1": i1, "i2": i2, "i3": i3, "i4": i4})
+
+    def finish(self, now):
+        self.switch(-1, now)
+        meta = [{"ph": "M", "pid": PID_THREADS, "name": "process_name", "args": {"name": "ThreadX threads"}},
+                {"ph": "M", "pid": PID_ISRS, "name": "process_name", "args": {"name": "Interrupts"}},
+                {"ph": "M", "pid": PID_THREADS, "tid": TID_IDLE, "name": "thread_name", "args": {"name": "idle"}},
+                {"ph": "M", "pid": PID_ISRS, "tid": len(ISR_NAMES), "name": "thread_name",
+                 "args": {"name": "other / SysTick"}}]
+        for address, tid in self.tids.items():
+            meta.append({"ph": "M", "pid": PID_THREADS, "tid": tid, "name": "thread_name",
+                         "args": {"name": self.name(address)}})
+        for i, name in enumerate(ISR_NAMES):
+            meta.append({"ph": "M", "pid": PID_ISRS, "tid": i, "name": "thread_name", "args": {"name": name}})
+        return meta + self.out
+
+
+def convert(image, hz):
+    header = parse_header(image)
+    objects = parse_registry(image, header)
+    events = parse_events(image, header)
+    timeline = Timeline(objects, hz)
+
+    mask = header["mask"]
+    now = 0
+    previous = None
+    for fields in events:
+        stamp = fields[3] & mask
+        if previous is not None:
+            now += (stamp - previous) & mask
+        previous = stamp
+        timeline.event(fields, now)
+
+    return {"traceEvents": timeline.finish(now), "displayTimeUnit": "ns",
+            "otherData": {"events": len(events), "objects": len(objects), "core_hz": hz}}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("trace", help="image saved from GET /GetTrace")
+    parser.add_argument("-o", "--output", help="JSON output (default: stdout)")
+    parser.add_argument("--hz", type=float, default=160e6, help="time stamp clock (SystemCoreClock)")
+    args = parser.parse_args()
+
+    with open(args.trace, "rb") as f:
+        image = f.read()
+
+    try:
+        result = convert(image, args.hz)
+    except ValueError as e:
+        sys.exit("%s: %s" % (args.trace, e))
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    json.dump(result, out)
+    if args.output:
+        out.close()
+        print("%s: %u events, %u objects" % (args.output, result["otherData"]["events"],
+                                              result["otherData"]["objects"]))
+
+
+if __name__ == "__main__":
+    main()
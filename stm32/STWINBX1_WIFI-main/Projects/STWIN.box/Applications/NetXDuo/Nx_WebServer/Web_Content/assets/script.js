@@ -13,6 +13,7 @@ $('#sidebarCollapse').on('click', function () {
 var tx_url = "/GetTXData";
 var nx_url = "/GetNXData";
 var mems_url = "/GetMemsData";
+var cpu_url = "/GetCpuLoad";
 function loadData() {
     jQuery.get(tx_url, function (data, status) {
         var array = data.split(',');
@@ -73,6 +74,29 @@ function loadData() {
         document.getElementById("mems_fft7").innerHTML = "B7 : " + a[16];
     });
 
+    jQuery.get(cpu_url, function (data, status) {
+        /* CSV lines (Core/Inc/cpu_load.h), loads in permille:
+         * window,<ms>,<core_hz>
+         * thread,<name>,<permille>,<cycles>
+         * isr,<name>,<permille>,<cycles>,<count>
+         * idle,<permille>
+         */
+        var rows = "";
+        var lines = data.split('\n');
+        for (var i = 0; i < lines.length; i++) {
+            var a = lines[i].split(',');
+            if (a[0] === "window") {
+                document.getElementById("cpu_window").innerHTML = "Window : " + a[1] + " ms at " + (a[2] / 1000000) + " MHz";
+            } else if (a[0] === "thread" || a[0] === "isr") {
+                rows += "<tr><td>" + a[0] + "</td><td>" + a[1] + "</td><td>" + (a[2] / 10).toFixed(1) +
+                        "</td><td>" + a[3] + "</td><td>" + (a[0] === "isr" ? a[4] : "") + "</td></tr>";
+            } else if (a[0] === "idle") {
+                rows += "<tr><td>idle</td><td></td><td>" + (a[1] / 10).toFixed(1) + "</td><td></td><td></td></tr>";
+            }
+        }
+        document.getElementById("cpu_load").innerHTML = rows;
+    });
+
     var t = setTimeout(function () { loadData() }, 3000);
 }
 